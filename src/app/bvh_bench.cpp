@@ -0,0 +1,217 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+/* BVH builder benchmark.
+ *
+ * Builds a BVH over procedurally generated meshes with the different builder
+ * configurations (SAH binning, spatial splits, Morton fast build) across an
+ * increasing number of threads, and reports build time, SAH cost and packed
+ * node memory. Used to track builder throughput and catch regressions in the
+ * binning and split code. */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "bvh/build.h"
+#include "bvh/bvh2.h"
+#include "bvh/node.h"
+#include "bvh/params.h"
+
+#include "scene/mesh.h"
+#include "scene/object.h"
+
+#include "util/array.h"
+#include "util/progress.h"
+#include "util/task.h"
+#include "util/time.h"
+#include "util/unique_ptr.h"
+#include "util/vector.h"
+
+namespace ccl {
+
+/* Generate a grid mesh with sinusoidal displacement, so references are not
+ * uniformly distributed and the binner has actual work to do. */
+static unique_ptr<Mesh> bvh_bench_create_mesh(const int resolution, const float3 offset)
+{
+  unique_ptr<Mesh> mesh = make_unique<Mesh>();
+
+  const int num_verts = resolution * resolution;
+  const int num_triangles = 2 * (resolution - 1) * (resolution - 1);
+  mesh->reserve_mesh(num_verts, num_triangles);
+
+  for (int y = 0; y < resolution; y++) {
+    for (int x = 0; x < resolution; x++) {
+      const float u = (float)x / (float)(resolution - 1);
+      const float v = (float)y / (float)(resolution - 1);
+      const float h = 0.05f * (sinf(u * 37.0f) + cosf(v * 29.0f) + sinf((u + v) * 53.0f));
+      mesh->add_vertex(make_float3(u, v, h) + offset);
+    }
+  }
+
+  for (int y = 0; y < resolution - 1; y++) {
+    for (int x = 0; x < resolution - 1; x++) {
+      const int v0 = y * resolution + x;
+      const int v1 = v0 + 1;
+      const int v2 = v0 + resolution;
+      const int v3 = v2 + 1;
+      mesh->add_triangle(v0, v1, v3, 0, false);
+      mesh->add_triangle(v0, v3, v2, 0, false);
+    }
+  }
+
+  return mesh;
+}
+
+struct BVHBenchResult {
+  double build_time;
+  float sah_cost;
+  size_t num_nodes;
+  size_t node_memory;
+};
+
+static bool bvh_bench_build(const vector<Object *> &objects,
+                            const BVHParams &params,
+                            BVHBenchResult &result)
+{
+  array<int> prim_type;
+  array<int> prim_index;
+  array<int> prim_object;
+  array<float2> prim_time;
+  Progress progress;
+
+  const double start_time = time_dt();
+
+  BVHBuild build(objects, prim_type, prim_index, prim_object, prim_time, params, progress);
+  const unique_ptr<BVHNode> root = build.run();
+
+  result.build_time = time_dt() - start_time;
+
+  if (!root) {
+    return false;
+  }
+
+  result.sah_cost = root->computeSubtreeSAHCost(params);
+  result.num_nodes = root->getSubtreeSize(BVH_STAT_NODE_COUNT);
+
+  /* Memory of the node arrays as BVH2 would pack them. */
+  const size_t num_leaf_nodes = root->getSubtreeSize(BVH_STAT_LEAF_COUNT);
+  const size_t num_inner_nodes = result.num_nodes - num_leaf_nodes;
+  const size_t num_unaligned_nodes = root->getSubtreeSize(BVH_STAT_UNALIGNED_INNER_COUNT);
+  const size_t node_slots = (num_unaligned_nodes * BVH_UNALIGNED_NODE_SIZE) +
+                            (num_inner_nodes - num_unaligned_nodes) *
+                                (params.use_compact_structure ? BVH_NODE_COMPACT_SIZE :
+                                                                BVH_NODE_SIZE);
+  result.node_memory = (node_slots + num_leaf_nodes * BVH_NODE_LEAF_SIZE) * sizeof(int4);
+
+  return true;
+}
+
+static bool bvh_bench(const int resolution, const int num_objects)
+{
+  /* Builder configurations to scan. All of them produce the binary tree that
+   * the BVH2 layout packs; wider device layouts (Embree, OptiX, Metal) go
+   * through vendor builders and cannot be benchmarked standalone. */
+  struct Config {
+    const char *name;
+    bool use_spatial_split;
+    bool use_fast_build;
+  };
+  static const Config configs[] = {
+      {"sah", false, false},
+      {"sah-spatial", true, false},
+      {"fast-morton", false, true},
+  };
+
+  vector<unique_ptr<Mesh>> meshes;
+  vector<unique_ptr<Object>> objects;
+  vector<Object *> object_ptrs;
+
+  for (int i = 0; i < num_objects; i++) {
+    const float3 offset = make_float3(1.1f * (float)(i % 8), 1.1f * (float)(i / 8), 0.0f);
+    meshes.push_back(bvh_bench_create_mesh(resolution, offset));
+
+    unique_ptr<Object> object = make_unique<Object>();
+    object->set_geometry(meshes.back().get());
+    object->set_visibility(~0);
+    objects.push_back(std::move(object));
+    object_ptrs.push_back(objects.back().get());
+  }
+
+  size_t num_triangles = 0;
+  for (const unique_ptr<Mesh> &mesh : meshes) {
+    num_triangles += mesh->num_triangles();
+  }
+  printf("bvh_bench: %d objects, %zu triangles\n", num_objects, num_triangles);
+  printf("%-14s %8s %12s %12s %12s %12s\n",
+         "config",
+         "threads",
+         "time (s)",
+         "Mprims/s",
+         "SAH cost",
+         "nodes (MB)");
+
+  const int max_threads = TaskScheduler::max_concurrency();
+
+  for (const Config &config : configs) {
+    BVHParams params;
+    params.use_spatial_split = config.use_spatial_split;
+    params.use_fast_build = config.use_fast_build;
+    params.bvh_layout = BVH_LAYOUT_BVH2;
+    params.bvh_type = config.use_fast_build ? BVH_TYPE_DYNAMIC : BVH_TYPE_STATIC;
+
+    double single_thread_time = 0.0;
+
+    for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+      TaskScheduler::init(num_threads);
+
+      BVHBenchResult result;
+      const bool ok = bvh_bench_build(object_ptrs, params, result);
+
+      TaskScheduler::exit();
+
+      if (!ok) {
+        fprintf(stderr, "bvh_bench: build failed for config %s\n", config.name);
+        return false;
+      }
+
+      if (num_threads == 1) {
+        single_thread_time = result.build_time;
+      }
+
+      printf("%-14s %8d %12.3f %12.2f %12.1f %12.2f  (%.2fx)\n",
+             config.name,
+             num_threads,
+             result.build_time,
+             (double)num_triangles / result.build_time * 1e-6,
+             (double)result.sah_cost,
+             (double)result.node_memory / (1024.0 * 1024.0),
+             single_thread_time / result.build_time);
+
+      /* Make sure the highest thread count is always measured, even when the
+       * concurrency is not a power of two. */
+      if (num_threads < max_threads && num_threads * 2 > max_threads) {
+        num_threads = max_threads / 2;
+      }
+    }
+  }
+
+  return true;
+}
+
+}
+
+int main(const int argc, const char **argv)
+{
+  /* Grid resolution per mesh and number of mesh instances; defaults give a
+   * scene of roughly two million triangles. */
+  const int resolution = (argc > 1) ? atoi(argv[1]) : 256;
+  const int num_objects = (argc > 2) ? atoi(argv[2]) : 16;
+
+  if (resolution < 2 || num_objects < 1) {
+    fprintf(stderr, "usage: %s [grid resolution] [number of meshes]\n", argv[0]);
+    return 1;
+  }
+
+  return ccl::bvh_bench(resolution, num_objects) ? 0 : 1;
+}
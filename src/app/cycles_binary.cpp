@@ -0,0 +1,393 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <cstdio>
+
+#include "app/cycles_binary.h"
+
+#include "graph/node_binary.h"
+#include "graph/node_type.h"
+
+#include "scene/background.h"
+#include "scene/camera.h"
+#include "scene/film.h"
+#include "scene/hair.h"
+#include "scene/integrator.h"
+#include "scene/light.h"
+#include "scene/mesh.h"
+#include "scene/object.h"
+#include "scene/pass.h"
+#include "scene/pointcloud.h"
+#include "scene/scene.h"
+#include "scene/shader.h"
+#include "scene/shader_graph.h"
+#include "scene/shader_nodes.h"
+#include "scene/volume.h"
+
+#include "util/string.h"
+#include "util/unique_ptr.h"
+
+namespace ccl {
+
+/* File layout: magic, version, then the shader, geometry, object and pass
+ * sections, followed by the camera/film/integrator/background singletons.
+ * Node* sockets are stored as indices into the order in which the nodes
+ * appear in the file, so both sides register nodes in the same order. */
+
+static const uint32_t BINARY_SCENE_MAGIC = 0x4e424343; /* "CCBN" */
+static const uint32_t BINARY_SCENE_VERSION = 1;
+
+/* Shader graphs */
+
+static bool binary_write_shader_graph(BinaryWriter &writer, ShaderGraph *graph)
+{
+  /* Local node map, shader nodes can't link to nodes outside the graph. */
+  BinaryNodeMap graph_refs;
+  for (ShaderNode *node : graph->nodes) {
+    if (node->special_type == SHADER_SPECIAL_TYPE_OSL) {
+      fprintf(stderr, "OSL shader nodes can not be saved to a binary scene.\n");
+      return false;
+    }
+    graph_refs.add(node);
+  }
+
+  writer.write_u32((uint32_t)graph->nodes.size());
+
+  for (ShaderNode *node : graph->nodes) {
+    writer.write_string(node->type->name);
+    binary_write_node(writer, graph_refs, node);
+  }
+
+  /* Links, as (from node, from socket, to node, to socket). */
+  uint32_t num_links = 0;
+  for (ShaderNode *node : graph->nodes) {
+    for (ShaderInput *input : node->inputs) {
+      if (input->link) {
+        num_links++;
+      }
+    }
+  }
+  writer.write_u32(num_links);
+
+  for (ShaderNode *node : graph->nodes) {
+    for (ShaderInput *input : node->inputs) {
+      if (!input->link) {
+        continue;
+      }
+
+      writer.write_u32((uint32_t)graph_refs.index(input->link->parent));
+      writer.write_string(input->link->socket_type.name);
+      writer.write_u32((uint32_t)graph_refs.index(node));
+      writer.write_string(input->socket_type.name);
+    }
+  }
+
+  return writer.good();
+}
+
+static bool binary_read_shader_graph(BinaryReader &reader, Scene *scene, Shader *shader)
+{
+  unique_ptr<ShaderGraph> graph = make_unique<ShaderGraph>();
+
+  BinaryNodeMap graph_refs;
+
+  const uint32_t num_nodes = reader.read_u32();
+  for (uint32_t i = 0; i < num_nodes && reader.good(); i++) {
+    const string type_name = reader.read_string();
+
+    ShaderNode *snode = nullptr;
+    if (type_name == "output") {
+      /* The graph pre-creates its output node. */
+      snode = graph->output();
+    }
+    else {
+      const NodeType *node_type = NodeType::find(type_name);
+      if (!node_type || node_type->type != NodeType::SHADER || node_type->create == nullptr) {
+        fprintf(stderr, "Unknown shader node \"%s\" in binary scene.\n", type_name.c_str());
+        return false;
+      }
+
+      snode = graph->create_node(node_type);
+    }
+
+    graph_refs.add(snode);
+    binary_read_node(reader, graph_refs, snode);
+  }
+
+  const uint32_t num_links = reader.read_u32();
+  for (uint32_t i = 0; i < num_links && reader.good(); i++) {
+    ShaderNode *from_node = (ShaderNode *)graph_refs.resolve(reader.read_u32());
+    const string from_socket_name = reader.read_string();
+    ShaderNode *to_node = (ShaderNode *)graph_refs.resolve(reader.read_u32());
+    const string to_socket_name = reader.read_string();
+
+    if (!from_node || !to_node) {
+      fprintf(stderr, "Invalid shader link in binary scene.\n");
+      return false;
+    }
+
+    ShaderOutput *output = nullptr;
+    for (ShaderOutput *out : from_node->outputs) {
+      if (string_iequals(out->socket_type.name, from_socket_name)) {
+        output = out;
+      }
+    }
+
+    ShaderInput *input = nullptr;
+    for (ShaderInput *in : to_node->inputs) {
+      if (string_iequals(in->socket_type.name, to_socket_name)) {
+        input = in;
+      }
+    }
+
+    if (!output || !input) {
+      fprintf(stderr,
+              "Unknown shader link sockets \"%s\" -> \"%s\" in binary scene.\n",
+              from_socket_name.c_str(),
+              to_socket_name.c_str());
+      return false;
+    }
+
+    graph->connect(output, input);
+  }
+
+  shader->set_graph(std::move(graph));
+  shader->tag_update(scene);
+
+  return reader.good();
+}
+
+/* Attributes
+ *
+ * Attribute layers are not node sockets, so they are written as raw
+ * name/type/buffer records alongside the owning geometry. */
+
+static void binary_write_attribute_set(BinaryWriter &writer, AttributeSet &attributes)
+{
+  writer.write_u32((uint32_t)attributes.attributes.size());
+
+  for (const Attribute &attr : attributes.attributes) {
+    writer.write_string(attr.name);
+    writer.write_u32((uint32_t)attr.std);
+    writer.write(&attr.type, sizeof(attr.type));
+    writer.write_u32((uint32_t)attr.element);
+    writer.write_u32(attr.flags);
+    writer.write_u64(attr.buffer.size());
+    writer.write(attr.buffer.data(), attr.buffer.size());
+  }
+}
+
+static void binary_read_attribute_set(BinaryReader &reader, AttributeSet &attributes)
+{
+  const uint32_t num_attributes = reader.read_u32();
+
+  for (uint32_t i = 0; i < num_attributes && reader.good(); i++) {
+    const string name = reader.read_string();
+    const AttributeStandard std = (AttributeStandard)reader.read_u32();
+    TypeDesc type;
+    reader.read(&type, sizeof(type));
+    const AttributeElement element = (AttributeElement)reader.read_u32();
+    const uint flags = reader.read_u32();
+    const uint64_t buffer_size = reader.read_u64();
+
+    Attribute *attr = attributes.add(name, type, element);
+    attr->std = std;
+    attr->flags = flags;
+    attr->buffer.resize(buffer_size);
+    reader.read(attr->buffer.data(), buffer_size);
+  }
+}
+
+/* Scene */
+
+bool binary_write_scene(Scene *scene, const string &filepath)
+{
+  FILE *file = fopen(filepath.c_str(), "wb");
+  if (file == nullptr) {
+    fprintf(stderr, "Failed to open \"%s\" for writing.\n", filepath.c_str());
+    return false;
+  }
+
+  BinaryWriter writer(file);
+
+  writer.write_u32(BINARY_SCENE_MAGIC);
+  writer.write_u32(BINARY_SCENE_VERSION);
+
+  /* Register nodes that sockets may reference, in file order. */
+  BinaryNodeMap refs;
+  for (Shader *shader : scene->shaders) {
+    refs.add(shader);
+  }
+  for (Geometry *geom : scene->geometry) {
+    refs.add(geom);
+  }
+  for (Object *object : scene->objects) {
+    refs.add(object);
+  }
+
+  bool ok = true;
+
+  /* Shaders. */
+  writer.write_u32((uint32_t)scene->shaders.size());
+  for (Shader *shader : scene->shaders) {
+    binary_write_node(writer, refs, shader);
+    if (!binary_write_shader_graph(writer, shader->graph.get())) {
+      ok = false;
+      break;
+    }
+  }
+
+  /* Geometry. */
+  if (ok) {
+    writer.write_u32((uint32_t)scene->geometry.size());
+    for (Geometry *geom : scene->geometry) {
+      writer.write_string(geom->type->name);
+      binary_write_node(writer, refs, geom);
+
+      binary_write_attribute_set(writer, geom->attributes);
+      if (geom->is_mesh() || geom->is_volume()) {
+        binary_write_attribute_set(writer, static_cast<Mesh *>(geom)->subd_attributes);
+      }
+    }
+
+    /* Objects. */
+    writer.write_u32((uint32_t)scene->objects.size());
+    for (Object *object : scene->objects) {
+      binary_write_node(writer, refs, object);
+    }
+
+    /* Passes. */
+    writer.write_u32((uint32_t)scene->passes.size());
+    for (Pass *pass : scene->passes) {
+      binary_write_node(writer, refs, pass);
+    }
+
+    /* Singletons. */
+    binary_write_node(writer, refs, scene->camera);
+    binary_write_node(writer, refs, scene->film);
+    binary_write_node(writer, refs, scene->integrator);
+    binary_write_node(writer, refs, scene->background);
+  }
+
+  ok = ok && writer.good();
+  fclose(file);
+
+  if (!ok) {
+    fprintf(stderr, "Failed to write binary scene \"%s\".\n", filepath.c_str());
+  }
+
+  return ok;
+}
+
+bool binary_read_scene(Scene *scene, const string &filepath)
+{
+  FILE *file = fopen(filepath.c_str(), "rb");
+  if (file == nullptr) {
+    fprintf(stderr, "Failed to open \"%s\" for reading.\n", filepath.c_str());
+    return false;
+  }
+
+  BinaryReader reader(file);
+
+  if (reader.read_u32() != BINARY_SCENE_MAGIC) {
+    fprintf(stderr, "\"%s\" is not a binary scene file.\n", filepath.c_str());
+    fclose(file);
+    return false;
+  }
+
+  const uint32_t version = reader.read_u32();
+  if (version != BINARY_SCENE_VERSION) {
+    fprintf(stderr,
+            "Binary scene \"%s\" has unsupported version %u.\n",
+            filepath.c_str(),
+            (unsigned)version);
+    fclose(file);
+    return false;
+  }
+
+  BinaryNodeMap refs;
+  bool ok = true;
+
+  /* Shaders. The scene pre-creates the default shaders, reuse those at
+   * matching indices so pointers like default_surface stay valid. */
+  const uint32_t num_shaders = reader.read_u32();
+  for (uint32_t i = 0; i < num_shaders && ok && reader.good(); i++) {
+    Shader *shader = (i < scene->shaders.size()) ? scene->shaders[i] :
+                                                   scene->create_node<Shader>();
+    refs.add(shader);
+
+    binary_read_node(reader, refs, shader);
+    ok = binary_read_shader_graph(reader, scene, shader);
+  }
+
+  /* Geometry. */
+  const uint32_t num_geometry = ok ? reader.read_u32() : 0;
+  for (uint32_t i = 0; i < num_geometry && ok && reader.good(); i++) {
+    const string type_name = reader.read_string();
+
+    Geometry *geom = nullptr;
+    if (type_name == "mesh") {
+      geom = scene->create_node<Mesh>();
+    }
+    else if (type_name == "hair") {
+      geom = scene->create_node<Hair>();
+    }
+    else if (type_name == "pointcloud") {
+      geom = scene->create_node<PointCloud>();
+    }
+    else if (type_name == "volume") {
+      geom = scene->create_node<Volume>();
+    }
+    else if (type_name == "light") {
+      geom = scene->create_node<Light>();
+    }
+    else {
+      fprintf(stderr, "Unknown geometry type \"%s\" in binary scene.\n", type_name.c_str());
+      ok = false;
+      break;
+    }
+
+    refs.add(geom);
+    binary_read_node(reader, refs, geom);
+
+    binary_read_attribute_set(reader, geom->attributes);
+    if (geom->is_mesh() || geom->is_volume()) {
+      binary_read_attribute_set(reader, static_cast<Mesh *>(geom)->subd_attributes);
+    }
+  }
+
+  /* Objects. */
+  const uint32_t num_objects = ok ? reader.read_u32() : 0;
+  for (uint32_t i = 0; i < num_objects && ok && reader.good(); i++) {
+    Object *object = scene->create_node<Object>();
+    refs.add(object);
+    binary_read_node(reader, refs, object);
+  }
+
+  /* Passes. */
+  const uint32_t num_passes = ok ? reader.read_u32() : 0;
+  for (uint32_t i = 0; i < num_passes && ok && reader.good(); i++) {
+    Pass *pass = scene->create_node<Pass>();
+    binary_read_node(reader, refs, pass);
+  }
+
+  /* Singletons. */
+  if (ok) {
+    binary_read_node(reader, refs, scene->camera);
+    binary_read_node(reader, refs, scene->film);
+    binary_read_node(reader, refs, scene->integrator);
+    binary_read_node(reader, refs, scene->background);
+  }
+
+  ok = ok && reader.good();
+  fclose(file);
+
+  if (!ok) {
+    fprintf(stderr, "Failed to read binary scene \"%s\".\n", filepath.c_str());
+  }
+
+  return ok;
+}
+
+}
@@ -0,0 +1,21 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "util/string.h"
+
+namespace ccl {
+
+class Scene;
+
+/* Versioned binary snapshot of a scene, for fast loading of scenes that were
+ * already parsed once from XML. Node socket state is serialized through the
+ * NodeType reflection, so large mesh arrays are written and read as single
+ * raw blocks instead of being parsed from text. */
+
+bool binary_write_scene(Scene *scene, const string &filepath);
+bool binary_read_scene(Scene *scene, const string &filepath);
+
+}
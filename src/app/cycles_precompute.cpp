@@ -7,13 +7,17 @@
 #include "util/string.h"
 
 #include "util/array.h"
+#include "util/fasthash.h"
 #include "util/hash.h"
+#include "util/path.h"
 #include "util/tbb.h"
+#include "util/vector.h"
 
 #include "kernel/closure/bsdf_microfacet.h"
 #include "kernel/sample/sobol_burley.h"
 
 #include <iostream>
+#include <sstream>
 
 namespace ccl {
 
@@ -145,7 +149,42 @@ struct PrecomputeTerm {
   std::function<float(float, float, float, float3)> evaluation;
 };
 
-static bool cycles_precompute(std::string name)
+/* Content-addressed table cache, enabled by setting
+ * CYCLES_PRECOMPUTE_CACHE_DIR. The integrands are compiled into this binary,
+ * so hashing the executable together with the table parameters covers any
+ * generator or kernel change without tracking individual source files. */
+
+static const char *precompute_cache_dir()
+{
+  return getenv("CYCLES_PRECOMPUTE_CACHE_DIR");
+}
+
+static string precompute_cache_path(const char *binary_path,
+                                    const string &name,
+                                    const PrecomputeTerm &term)
+{
+  const char *dir = precompute_cache_dir();
+  if (dir == nullptr || dir[0] == '\0') {
+    return string();
+  }
+
+  vector<uint8_t> binary;
+  if (!path_read_binary(binary_path, binary)) {
+    return string();
+  }
+
+  FastHash hash;
+  hash.append(binary.data(), binary.size());
+  hash.append(name);
+  hash.append((const uint8_t *)&term.samples, sizeof(term.samples));
+  hash.append((const uint8_t *)&term.nx, sizeof(term.nx));
+  hash.append((const uint8_t *)&term.ny, sizeof(term.ny));
+  hash.append((const uint8_t *)&term.nz, sizeof(term.nz));
+
+  return path_join(dir, name + "_" + hash.get_hex() + ".inc");
+}
+
+static bool cycles_precompute(std::string name, const char *binary_path)
 {
   std::map<string, PrecomputeTerm> precompute_terms;
   /* Overall albedo of the GGX microfacet BRDF, depending on cosI and roughness. */
@@ -231,56 +270,98 @@ static bool cycles_precompute(std::string name)
   const int ny = term.ny;
   const int nx = term.nx;
 
-  std::cout << "static const float table_" << name << "[" << nz * ny * nx << "] = {" << std::endl;
-  for (int z = 0; z < nz; z++) {
-    array<float> data(nx * ny);
-    parallel_for(0, nx * ny, [&](int64_t i) {
-      const int y = i / nx;
-      const int x = i % nx;
-      const uint seed = hash_uint2(x, y);
-      double sum = 0.0;
-      for (int sample = 0; sample < samples; sample++) {
-        const float4 rand = sobol_burley_sample_4D(sample, 0, seed, 0xffffffff);
-
-        const float rough = (nx == 1) ? 0.0f : clamp(float(x) / float(nx - 1), 1e-4f, 1.0f);
-        const float mu = (ny == 1) ? rand.w : clamp(float(y) / float(ny - 1), 1e-4f, 1.0f);
-        const float ior = (nz == 1) ? 0.0f : clamp(float(z) / float(nz - 1), 1e-4f, 0.99f);
-
-        float value = term.evaluation(rough, mu, ior, make_float3(rand));
-        if (isnan(value)) {
-          value = 0.0f;
-        }
-        sum += (double)value;
+  /* Reuse a cached table if neither the generator code nor the table
+   * parameters changed. */
+  const string cache_path = precompute_cache_path(binary_path, name, term);
+  if (!cache_path.empty() && path_exists(cache_path)) {
+    string text;
+    if (path_read_text(cache_path, text)) {
+      std::cout << text;
+      return true;
+    }
+  }
+
+  /* Partition the sample range of every cell into chunks, so that narrow
+   * tables like the 32-entry averaged albedo still fill the task pool. Each
+   * chunk integrates a disjoint range of the per-cell Sobol sequence, so the
+   * result does not depend on the thread count. */
+  const int num_cells = nx * ny * nz;
+  const int samples_per_chunk = min(samples, 1 << 16);
+  const int chunks_per_cell = samples / samples_per_chunk;
+
+  vector<double> partial_sums((size_t)num_cells * chunks_per_cell);
+
+  parallel_for((int64_t)0, (int64_t)num_cells * chunks_per_cell, [&](int64_t task) {
+    const int cell = int(task / chunks_per_cell);
+    const int x = cell % nx;
+    const int y = (cell / nx) % ny;
+    const int z = cell / (nx * ny);
+    const uint seed = hash_uint2(x, y);
+
+    const int sample_start = int(task % chunks_per_cell) * samples_per_chunk;
+    double sum = 0.0;
+    for (int sample = sample_start; sample < sample_start + samples_per_chunk; sample++) {
+      const float4 rand = sobol_burley_sample_4D(sample, 0, seed, 0xffffffff);
+
+      const float rough = (nx == 1) ? 0.0f : clamp(float(x) / float(nx - 1), 1e-4f, 1.0f);
+      const float mu = (ny == 1) ? rand.w : clamp(float(y) / float(ny - 1), 1e-4f, 1.0f);
+      const float ior = (nz == 1) ? 0.0f : clamp(float(z) / float(nz - 1), 1e-4f, 0.99f);
+
+      float value = term.evaluation(rough, mu, ior, make_float3(rand));
+      if (isnan(value)) {
+        value = 0.0f;
       }
-      data[y * nx + x] = saturatef(float(sum / double(samples)));
-    });
+      sum += (double)value;
+    }
+    partial_sums[task] = sum;
+  });
+
+  array<float> data(num_cells);
+  for (int cell = 0; cell < num_cells; cell++) {
+    double sum = 0.0;
+    for (int chunk = 0; chunk < chunks_per_cell; chunk++) {
+      sum += partial_sums[(size_t)cell * chunks_per_cell + chunk];
+    }
+    data[cell] = saturatef(float(sum / double(samples)));
+  }
+
+  std::ostringstream out;
 
+  out << "static const float table_" << name << "[" << nz * ny * nx << "] = {" << std::endl;
+  for (int z = 0; z < nz; z++) {
     /* Print data formatted as C++ array */
     for (int y = 0; y < ny; y++) {
-      std::cout << "  ";
+      out << "  ";
       for (int x = 0; x < nx; x++) {
-        std::cout << std::to_string(data[y * nx + x]);
+        out << std::to_string(data[(z * ny + y) * nx + x]);
         if (x + 1 < nx) {
           /* Next number will follow in same line */
-          std::cout << "f, ";
+          out << "f, ";
         }
         else if (y + 1 < ny || z + 1 < nz) {
           /* Next number will follow in next line */
-          std::cout << "f,";
+          out << "f,";
         }
         else {
           /* No next number */
-          std::cout << "f";
+          out << "f";
         }
       }
-      std::cout << std::endl;
+      out << std::endl;
     }
     /* If the array is three-dimensional, put an empty line between each slice. */
     if (ny > 1 && z + 1 < nz) {
-      std::cout << std::endl;
+      out << std::endl;
     }
   }
-  std::cout << "};" << std::endl;
+  out << "};" << std::endl;
+
+  string text = out.str();
+  std::cout << text;
+
+  if (!cache_path.empty()) {
+    path_write_text(cache_path, text);
+  }
 
   return true;
 }
@@ -292,5 +373,5 @@ int main(const int argc, const char **argv)
   if (argc < 2) {
     return 1;
   }
-  return ccl::cycles_precompute(argv[1]) ? 0 : 1;
+  return ccl::cycles_precompute(argv[1], argv[0]) ? 0 : 1;
 }
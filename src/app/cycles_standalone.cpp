@@ -2,24 +2,30 @@
  *
  * SPDX-License-Identifier: Apache-2.0 */
 
+#include <cctype>
 #include <cstdio>
+#include <cstring>
 
 #include "device/device.h"
 #include "scene/camera.h"
 #include "scene/integrator.h"
+#include "scene/object.h"
+#include "scene/procedural.h"
 #include "scene/scene.h"
+#include "scene/shader.h"
+#include "scene/stats.h"
 #include "session/buffers.h"
+#include "session/merge.h"
 #include "session/session.h"
 
 #include "util/args.h"
 #include "util/log.h"
+#include "util/map.h"
 #include "util/path.h"
 #include "util/progress.h"
 #include "util/string.h"
-#ifdef WITH_CYCLES_STANDALONE_GUI
-#  include "util/time.h"
-#  include "util/transform.h"
-#endif
+#include "util/time.h"
+#include "util/transform.h"
 #include "util/unique_ptr.h"
 #include "util/version.h"
 
@@ -27,6 +33,7 @@
 #  include "hydra/file_reader.h"
 #endif
 
+#include "app/cycles_binary.h"
 #include "app/cycles_xml.h"
 #include "app/oiio_output_driver.h"
 
@@ -47,10 +54,56 @@ struct Options {
   bool debug;
   bool quiet;
   bool show_help, interactive, pause;
+  bool sync_bench;
+  int sync_bench_iterations;
+  bool benchmark;
+  int benchmark_reps;
+  /* Animation frame range, rendered with a single session by driving the
+   * frame socket of the scene's procedurals. */
+  bool animation;
+  int start_frame;
+  int end_frame;
   string output_filepath;
   string output_pass;
+  /* Live render statistics written as a JSON file for external monitoring. */
+  string stats_filepath;
+  int stats_interval;
+  string save_binary_filepath;
+  /* Deterministic sample-range sharding for splitting one frame across
+   * multiple processes, and the merge pass combining the shard files. */
+  int shard_index;
+  int shard_count;
+  bool merge_shards;
+  vector<string> merge_input;
 } options;
 
+/* Startup phase timestamps, for the time-to-first-sample report. */
+static struct StartupTimes {
+  double start = 0.0;
+  double devices = 0.0;
+  double session_create = 0.0;
+  double scene_parse = 0.0;
+  double render_start = 0.0;
+} startup_times;
+
+static void startup_report()
+{
+  /* Report once the first sample finished. */
+  static bool reported = false;
+  if (reported || options.session->progress.get_current_sample() < 1) {
+    return;
+  }
+  reported = true;
+
+  const double first_sample = time_dt();
+  VLOG_INFO << "Time to first sample " << first_sample - startup_times.start << "s: "
+            << "device enumeration " << startup_times.devices - startup_times.start << "s, "
+            << "session create " << startup_times.session_create - startup_times.devices << "s, "
+            << "scene parse " << startup_times.scene_parse - startup_times.session_create << "s, "
+            << "render start " << startup_times.render_start - startup_times.scene_parse << "s, "
+            << "sync and first sample " << first_sample - startup_times.render_start << "s";
+}
+
 static void session_print(const string &str)
 {
   // Print the string on a new line, rather than overwriting the previous
@@ -82,6 +135,8 @@ static void session_print_status()
   string status;
   string substatus;
 
+  startup_report();
+
   /* get status */
   const double progress = options.session->progress.get_progress();
   options.session->progress.get_status(status, substatus);
@@ -95,6 +150,33 @@ static void session_print_status()
   session_print(status);
 }
 
+static void session_write_stats()
+{
+  if (options.stats_filepath.empty()) {
+    return;
+  }
+
+  static double last_stats_time = 0.0;
+  const double time = time_dt();
+  if (time - last_stats_time < options.stats_interval) {
+    return;
+  }
+  last_stats_time = time;
+
+  const string json = options.session->get_stats_json();
+
+  /* Write to a temporary file and rename, so a poller never reads a partial
+   * snapshot. */
+  const string tmp_filepath = options.stats_filepath + ".tmp";
+  FILE *f = fopen(tmp_filepath.c_str(), "w");
+  if (f == nullptr) {
+    return;
+  }
+  fprintf(f, "%s\n", json.c_str());
+  fclose(f);
+  rename(tmp_filepath.c_str(), options.stats_filepath.c_str());
+}
+
 static BufferParams &session_buffer_params()
 {
   static BufferParams buffer_params;
@@ -110,14 +192,18 @@ static void scene_init()
 {
   options.scene = options.session->scene.get();
 
-  /* Read XML or USD */
+  /* Read binary snapshot, XML or USD */
+  if (string_endswith(string_to_lower(options.filepath), ".cbin")) {
+    if (!binary_read_scene(options.scene, options.filepath)) {
+      exit(EXIT_FAILURE);
+    }
+  }
 #ifdef WITH_USD
-  if (!string_endswith(string_to_lower(options.filepath), ".xml")) {
+  else if (!string_endswith(string_to_lower(options.filepath), ".xml")) {
     HD_CYCLES_NS::HdCyclesFileReader::read(options.session.get(), options.filepath.c_str());
   }
-  else
 #endif
-  {
+  else {
     xml_read_file(options.scene, options.filepath.c_str());
   }
 
@@ -139,6 +225,7 @@ static void session_init()
 {
   options.output_pass = "combined";
   options.session = make_unique<Session>(options.session_params, options.scene_params);
+  startup_times.session_create = time_dt();
 
 #ifdef WITH_CYCLES_STANDALONE_GUI
   if (!options.session_params.background) {
@@ -148,12 +235,21 @@ static void session_init()
 #endif
 
   if (!options.output_filepath.empty()) {
+    const int num_samples = options.session_params.use_sample_subset ?
+                                options.session_params.sample_subset_length :
+                                options.session_params.samples;
     options.session->set_output_driver(make_unique<OIIOOutputDriver>(
-        options.output_filepath, options.output_pass, session_print));
+        options.output_filepath, options.output_pass, session_print, num_samples));
   }
 
   if (options.session_params.background && !options.quiet) {
-    options.session->progress.set_update_callback([] { session_print_status(); });
+    options.session->progress.set_update_callback([] {
+      session_print_status();
+      session_write_stats();
+    });
+  }
+  else if (options.session_params.background && !options.stats_filepath.empty()) {
+    options.session->progress.set_update_callback([] { session_write_stats(); });
   }
 #ifdef WITH_CYCLES_STANDALONE_GUI
   else {
@@ -163,6 +259,17 @@ static void session_init()
 
   /* load scene */
   scene_init();
+  startup_times.scene_parse = time_dt();
+
+  /* save binary snapshot instead of rendering? */
+  if (!options.save_binary_filepath.empty()) {
+    if (!binary_write_scene(options.scene, options.save_binary_filepath)) {
+      exit(EXIT_FAILURE);
+    }
+
+    printf("Saved binary scene to %s\n", options.save_binary_filepath.c_str());
+    exit(EXIT_SUCCESS);
+  }
 
   /* add pass for output. */
   Pass *pass = options.scene->create_node<Pass>();
@@ -171,6 +278,7 @@ static void session_init()
 
   options.session->reset(options.session_params, session_buffer_params());
   options.session->start();
+  startup_times.render_start = time_dt();
 }
 
 static void session_exit()
@@ -185,6 +293,398 @@ static void session_exit()
   }
 }
 
+/* Scene sync benchmark.
+ *
+ * Loads a scene and runs Scene::device_update repeatedly with controlled dirty
+ * states (all-dirty, transforms-only, shaders-only), without rendering. Emits
+ * per-manager timings from SceneUpdateStats as JSON on stdout, to track scene
+ * sync performance and catch regressions. */
+
+static void sync_bench_run(const char *state,
+                           const int iteration,
+                           Progress &progress,
+                           string &results)
+{
+  Scene *scene = options.scene;
+  scene->update_stats->clear();
+
+  const double start_time = time_dt();
+  scene->update(progress);
+  const double total_time = time_dt() - start_time;
+
+  if (progress.get_error()) {
+    fprintf(stderr, "sync_bench: %s\n", progress.get_error_message().c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  SceneUpdateStats *stats = scene->update_stats.get();
+  const struct {
+    const char *name;
+    UpdateTimeStats *stats;
+  } managers[] = {
+      {"geometry", &stats->geometry},
+      {"image", &stats->image},
+      {"light", &stats->light},
+      {"object", &stats->object},
+      {"background", &stats->background},
+      {"bake", &stats->bake},
+      {"camera", &stats->camera},
+      {"film", &stats->film},
+      {"integrator", &stats->integrator},
+      {"osl", &stats->osl},
+      {"particles", &stats->particles},
+      {"scene", &stats->scene},
+      {"svm", &stats->svm},
+      {"tables", &stats->tables},
+      {"procedurals", &stats->procedurals},
+  };
+
+  string managers_json;
+  for (const auto &manager : managers) {
+    /* Aggregate entries by name, a manager can add several with the same name. */
+    map<string, double> entries;
+    for (const NamedTimeEntry &entry : manager.stats->times.entries) {
+      entries[entry.name] += entry.time;
+    }
+
+    string entries_json;
+    for (const auto &entry : entries) {
+      if (!entries_json.empty()) {
+        entries_json += ", ";
+      }
+      entries_json += string_printf("\"%s\": %.6f", entry.first.c_str(), entry.second);
+    }
+
+    if (!managers_json.empty()) {
+      managers_json += ", ";
+    }
+    managers_json += string_printf("\"%s\": {\"total\": %.6f, \"entries\": {%s}}",
+                                   manager.name,
+                                   manager.stats->times.total_time,
+                                   entries_json.c_str());
+  }
+
+  if (!results.empty()) {
+    results += ", ";
+  }
+  results += string_printf("{\"state\": \"%s\", \"iteration\": %d, \"time\": %.6f, \"managers\": {%s}}",
+                           state,
+                           iteration,
+                           total_time,
+                           managers_json.c_str());
+}
+
+static void session_sync_bench()
+{
+  options.session_params.background = true;
+  options.output_pass = "combined";
+  options.session = make_unique<Session>(options.session_params, options.scene_params);
+
+  /* load scene */
+  scene_init();
+
+  Scene *scene = options.scene;
+
+  /* add pass for output. */
+  Pass *pass = scene->create_node<Pass>();
+  pass->set_name(string(options.output_pass.c_str()));
+  pass->set_type(PASS_COMBINED);
+
+  scene->enable_update_stats();
+
+  Progress progress;
+
+  scene->load_kernels_async(progress);
+  if (!scene->wait_load_kernels(progress)) {
+    fprintf(stderr, "sync_bench: failed to load kernels\n");
+    exit(EXIT_FAILURE);
+  }
+
+  const int iterations = options.sync_bench_iterations;
+  string results;
+
+  /* Full sync. The first iteration is already all-dirty from the file load,
+   * later ones re-tag everything like a full reset would. */
+  for (int i = 0; i < iterations; i++) {
+    if (i > 0) {
+      scene->reset();
+    }
+    sync_bench_run("all-dirty", i, progress, results);
+  }
+
+  /* Interactive transform tweak: nudge every object, nothing else. */
+  for (int i = 0; i < iterations; i++) {
+    for (Object *object : scene->objects) {
+      Transform tfm = object->get_tfm();
+      tfm.x.w += 0.001f;
+      object->set_tfm(tfm);
+      object->tag_update(scene);
+    }
+    sync_bench_run("transforms-only", i, progress, results);
+  }
+
+  /* Shader edit: re-tag every shader for compilation and upload. */
+  for (int i = 0; i < iterations; i++) {
+    for (Shader *shader : scene->shaders) {
+      shader->tag_update(scene);
+    }
+    sync_bench_run("shaders-only", i, progress, results);
+  }
+
+  printf("{\"scene\": \"%s\", \"device\": \"%s\", \"iterations\": %d, \"results\": [%s]}\n",
+         path_filename(options.filepath).c_str(),
+         Device::string_from_type(options.session_params.device.type).c_str(),
+         iterations,
+         results.c_str());
+
+  options.session.reset();
+}
+
+/* Multi-scene render benchmark.
+ *
+ * Takes a manifest file with one scene file path per line (blank lines and
+ * lines starting with # are skipped), renders each scene with one warmup plus
+ * N measured repetitions reusing the same Session, and emits per-phase
+ * timings as JSON on stdout: scene sync, time to first sample, total wall
+ * time and steady-state samples per second. */
+
+static void benchmark_scene(const string &filepath, const int reps, string &results)
+{
+  options.filepath = filepath;
+  options.session = make_unique<Session>(options.session_params, options.scene_params);
+
+  scene_init();
+
+  /* add pass for output. */
+  Pass *pass = options.scene->create_node<Pass>();
+  pass->set_name(string(options.output_pass.c_str()));
+  pass->set_type(PASS_COMBINED);
+
+  string reps_json;
+
+  for (int rep = 0; rep < reps + 1; rep++) {
+    const bool warmup = (rep == 0);
+
+    Session *session = options.session.get();
+
+    double first_sample_time = 0.0;
+    const double begin_time = time_dt();
+
+    session->progress.set_update_callback([session, begin_time, &first_sample_time] {
+      if (first_sample_time == 0.0 && session->progress.get_current_sample() >= 1) {
+        first_sample_time = time_dt() - begin_time;
+      }
+    });
+
+    if (rep > 0) {
+      /* Re-tag everything so each repetition measures a full sync. */
+      options.scene->reset();
+    }
+
+    session->reset(options.session_params, session_buffer_params());
+    session->start();
+    session->wait();
+
+    const double total_time = time_dt() - begin_time;
+
+    if (session->progress.get_error()) {
+      fprintf(stderr, "benchmark: %s\n", session->progress.get_error_message().c_str());
+      exit(EXIT_FAILURE);
+    }
+
+    /* Progress excludes scene update and kernel load from the render time, so
+     * the difference to the wall time is the sync phase. */
+    double progress_total_time;
+    double render_time;
+    session->progress.get_time(progress_total_time, render_time);
+    const double sync_time = max(total_time - render_time, 0.0);
+
+    /* Steady-state rate, excluding the first sample which pays for sync,
+     * upload and kernel warmup. */
+    const int samples = options.session_params.samples;
+    double samples_per_second = 0.0;
+    if (samples > 1 && first_sample_time > 0.0 && total_time > first_sample_time) {
+      samples_per_second = (samples - 1) / (total_time - first_sample_time);
+    }
+
+    if (!reps_json.empty()) {
+      reps_json += ", ";
+    }
+    reps_json += string_printf(
+        "{\"repetition\": %d, \"warmup\": %s, \"sync\": %.6f, \"first_sample\": %.6f, "
+        "\"total\": %.6f, \"samples_per_second\": %.2f}",
+        rep,
+        warmup ? "true" : "false",
+        sync_time,
+        first_sample_time,
+        total_time,
+        samples_per_second);
+  }
+
+  if (!results.empty()) {
+    results += ", ";
+  }
+  results += string_printf("{\"scene\": \"%s\", \"repetitions\": [%s]}",
+                           path_filename(filepath).c_str(),
+                           reps_json.c_str());
+
+  options.session.reset();
+}
+
+static void session_benchmark()
+{
+  options.session_params.background = true;
+  options.output_pass = "combined";
+
+  string manifest;
+  if (!path_read_text(options.filepath, manifest)) {
+    fprintf(stderr, "benchmark: failed to read manifest \"%s\"\n", options.filepath.c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  const string base = path_dirname(options.filepath);
+
+  vector<string> lines;
+  string_split(lines, manifest, "\n", true);
+
+  vector<string> scene_paths;
+  for (const string &line : lines) {
+    const string path = string_strip(line);
+    if (path.empty() || path[0] == '#') {
+      continue;
+    }
+
+    scene_paths.push_back(path_is_relative(path) ? path_join(base, path) : path);
+  }
+
+  if (scene_paths.empty()) {
+    fprintf(stderr, "benchmark: no scenes in manifest \"%s\"\n", options.filepath.c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  /* Camera overrides from the command line, re-applied per scene since
+   * scene_init fills in zero width/height from the camera. */
+  const int requested_width = options.width;
+  const int requested_height = options.height;
+
+  string results;
+  for (const string &scene_path : scene_paths) {
+    options.width = requested_width;
+    options.height = requested_height;
+    benchmark_scene(scene_path, options.benchmark_reps, results);
+  }
+
+  printf("{\"device\": \"%s\", \"samples\": %d, \"measured_repetitions\": %d, \"scenes\": [%s]}\n",
+         Device::string_from_type(options.session_params.device.type).c_str(),
+         options.session_params.samples,
+         options.benchmark_reps,
+         results.c_str());
+}
+
+/* Animation rendering.
+ *
+ * Renders a frame range with a single session, so process startup, device
+ * initialization and kernel loading are paid once per job rather than once
+ * per frame. Each frame advances the frame socket of every procedural and
+ * re-tags the procedural manager; the Alembic procedural then copies the
+ * frame's data from its in-memory animation cache (filled on the first
+ * frame) into the scene nodes and tags only the affected managers, so later
+ * frames sync incrementally. Image writes run on a background thread in the
+ * output driver, overlapping the next frame's sync and trace. */
+
+static string animation_frame_filepath(const int frame)
+{
+  const string &filepath = options.output_filepath;
+
+  /* Honor a printf-style integer conversion in the output path, if any. */
+  const size_t percent = filepath.find('%');
+  if (percent != string::npos) {
+    size_t i = percent + 1;
+    while (i < filepath.size() && isdigit(filepath[i])) {
+      i++;
+    }
+    if (i < filepath.size() && filepath[i] == 'd') {
+      return string_printf(filepath.c_str(), frame);
+    }
+  }
+
+  /* Otherwise insert the frame number before the extension. */
+  const string frame_string = string_printf("%04d", frame);
+  const size_t dot = filepath.rfind('.');
+  if (dot == string::npos) {
+    return filepath + "_" + frame_string;
+  }
+  return filepath.substr(0, dot) + "_" + frame_string + filepath.substr(dot);
+}
+
+static void session_animation()
+{
+  options.session_params.background = true;
+  options.output_pass = "combined";
+  options.session = make_unique<Session>(options.session_params, options.scene_params);
+
+  scene_init();
+
+  Scene *scene = options.scene;
+
+  /* add pass for output. */
+  Pass *pass = scene->create_node<Pass>();
+  pass->set_name(string(options.output_pass.c_str()));
+  pass->set_type(PASS_COMBINED);
+
+  OIIOOutputDriver *output_driver = nullptr;
+  if (!options.output_filepath.empty()) {
+    unique_ptr<OIIOOutputDriver> driver = make_unique<OIIOOutputDriver>(
+        options.output_filepath, options.output_pass, session_print);
+    driver->set_async_write(true);
+    output_driver = driver.get();
+    options.session->set_output_driver(std::move(driver));
+  }
+
+  if (!options.quiet) {
+    options.session->progress.set_update_callback([] { session_print_status(); });
+  }
+
+  /* Procedurals exposing a frame socket drive the animation. */
+  vector<pair<Procedural *, const SocketType *>> animated;
+  for (Procedural *procedural : scene->procedurals) {
+    const SocketType *socket = procedural->type->find_input(string("frame"));
+    if (socket && socket->type == SocketType::FLOAT) {
+      animated.emplace_back(procedural, socket);
+    }
+  }
+  if (animated.empty()) {
+    fprintf(stderr, "animation: scene has no procedural with a frame socket\n");
+  }
+
+  for (int frame = options.start_frame; frame <= options.end_frame; frame++) {
+    for (const auto &entry : animated) {
+      entry.first->set(*entry.second, (float)frame);
+    }
+    if (!animated.empty()) {
+      scene->procedural_manager->tag_update();
+    }
+
+    if (output_driver) {
+      output_driver->set_filepath(animation_frame_filepath(frame));
+    }
+
+    options.session->reset(options.session_params, session_buffer_params());
+    options.session->start();
+    options.session->wait();
+
+    if (options.session->progress.get_error()) {
+      fprintf(stderr,
+              "animation: %s\n",
+              options.session->progress.get_error_message().c_str());
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  /* Destroying the session waits for in-flight image writes. */
+  session_exit();
+}
+
 #ifdef WITH_CYCLES_STANDALONE_GUI
 static void display_info(Progress &progress)
 {
@@ -392,6 +892,9 @@ static void options_parse(const int argc, const char **argv)
   options.session = nullptr;
   options.debug = false;
   options.quiet = false;
+  options.benchmark = false;
+  options.benchmark_reps = 3;
+  options.stats_interval = 1;
   options.session_params.use_auto_tile = false;
   options.session_params.tile_size = 0;
 
@@ -420,6 +923,8 @@ static void options_parse(const int argc, const char **argv)
   bool version = false;
   int verbosity = 1;
 
+  int checkpoint_interval = 0;
+
   ap.usage("cycles [options] file.xml");
   ap.arg("filename").hidden().action([&](auto argv) { options.filepath = argv[0]; });
   ap.arg("--device %s:DEVICE").help("Devices to use: " + device_names).action([&](auto argv) {
@@ -439,6 +944,9 @@ static void options_parse(const int argc, const char **argv)
   ap.arg("--output %s:OUTPUT").help("File path to write output image").action([&](auto argv) {
     parse_string(argv, &options.output_filepath);
   });
+  ap.arg("--save-binary %s:FILE")
+      .help("Write the loaded scene as a binary scene file and exit, without rendering")
+      .action([&](auto argv) { parse_string(argv, &options.save_binary_filepath); });
   ap.arg("--threads %d:THREADS").help("CPU Rendering Threads").action([&](auto argv) {
     parse_int(argv, &options.session_params.threads);
   });
@@ -451,6 +959,26 @@ static void options_parse(const int argc, const char **argv)
   ap.arg("--tile-size %d:TILE_SIZE").help("Tile size in pixels").action([&](auto argv) {
     parse_int(argv, &options.session_params.tile_size);
   });
+  ap.arg("--checkpoint %s:CHECKPOINT")
+      .help("File path to periodically write render state checkpoints to")
+      .action([&](auto argv) { parse_string(argv, &options.session_params.checkpoint_path); });
+  ap.arg("--checkpoint-interval %d:SECONDS")
+      .help("Minimum time between two checkpoint writes, in seconds")
+      .action([&](auto argv) { parse_int(argv, &checkpoint_interval); });
+  ap.arg("--resume", &options.session_params.resume_from_checkpoint)
+      .help("Resume from the checkpoint file instead of starting at sample zero");
+  ap.arg("--stats-file %s:FILE")
+      .help("Write live render statistics as a JSON file for external monitoring")
+      .action([&](auto argv) { parse_string(argv, &options.stats_filepath); });
+  ap.arg("--stats-interval %d:SECONDS")
+      .help("Minimum time between two live statistics writes, in seconds")
+      .action([&](auto argv) { parse_int(argv, &options.stats_interval); });
+  ap.arg("--benchmark", &options.benchmark)
+      .help("Treat the input file as a benchmark manifest with one scene per line, "
+            "render each with warmup and measured repetitions and report JSON timings");
+  ap.arg("--benchmark-reps %d:REPS")
+      .help("Number of measured benchmark repetitions per scene")
+      .action([&](auto argv) { parse_int(argv, &options.benchmark_reps); });
   ap.arg("--list-devices", &list).help("List information about all available devices");
   ap.arg("--profile", &profile).help("Enable profile logging");
 #ifdef WITH_CYCLES_LOGGING
@@ -512,9 +1040,14 @@ static void options_parse(const int argc, const char **argv)
     options.session_params.use_auto_tile = true;
   }
 
+  if (checkpoint_interval > 0) {
+    options.session_params.checkpoint_interval = checkpoint_interval;
+  }
+
   /* find matching device */
   const DeviceType device_type = Device::type_from_string(devicename.c_str());
   vector<DeviceInfo> devices = Device::available_devices(DEVICE_MASK(device_type));
+  startup_times.devices = time_dt();
 
   bool device_available = false;
   if (!devices.empty()) {
@@ -557,8 +1090,19 @@ static void options_parse(const int argc, const char **argv)
   options.height = 512;
   options.filepath = "";
   options.output_filepath = "";
+  options.save_binary_filepath = "";
   options.session = nullptr;
   options.debug = true;
+  options.sync_bench = false;
+  options.sync_bench_iterations = 10;
+  options.benchmark = false;
+  options.benchmark_reps = 3;
+  options.animation = false;
+  options.start_frame = 0;
+  options.end_frame = 0;
+  options.shard_index = 0;
+  options.shard_count = 0;
+  options.merge_shards = false;
   options.session_params.use_auto_tile = false;
   options.session_params.tile_size = 0;
 
@@ -580,12 +1124,89 @@ static void options_parse(const int argc, const char **argv)
   constexpr bool profile = false;
   constexpr int verbosity = 1;
 
-  if (argc > 1) {
-    options.filepath = argv[1];
+  vector<const char *> args;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--sync-bench") == 0) {
+      options.sync_bench = true;
+      if (i + 1 < argc && atoi(argv[i + 1]) > 0) {
+        options.sync_bench_iterations = atoi(argv[++i]);
+      }
+    }
+    else if (strcmp(argv[i], "--save-binary") == 0 && i + 1 < argc) {
+      options.save_binary_filepath = argv[++i];
+    }
+    else if (strcmp(argv[i], "--benchmark") == 0) {
+      options.benchmark = true;
+      if (i + 1 < argc && atoi(argv[i + 1]) > 0) {
+        options.benchmark_reps = atoi(argv[++i]);
+      }
+    }
+    else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      ++i;
+      if (sscanf(argv[i], "%d:%d", &options.start_frame, &options.end_frame) != 2 ||
+          options.end_frame < options.start_frame)
+      {
+        fprintf(stderr,
+                "Invalid frame range: %s (expected start:end with start <= end)\n",
+                argv[i]);
+        exit(EXIT_FAILURE);
+      }
+      options.animation = true;
+    }
+    else if (strcmp(argv[i], "--shard") == 0 && i + 1 < argc) {
+      ++i;
+      if (sscanf(argv[i], "%d/%d", &options.shard_index, &options.shard_count) != 2 ||
+          options.shard_count < 1 || options.shard_index < 0 ||
+          options.shard_index >= options.shard_count)
+      {
+        fprintf(stderr, "Invalid shard specification: %s (expected i/N with 0 <= i < N)\n", argv[i]);
+        exit(EXIT_FAILURE);
+      }
+    }
+    else if (strcmp(argv[i], "--merge-shards") == 0 && i + 1 < argc) {
+      options.merge_shards = true;
+      options.output_filepath = argv[++i];
+    }
+    else if (strcmp(argv[i], "--tile-order") == 0 && i + 1 < argc) {
+      ++i;
+      if (strcmp(argv[i], "scanline") == 0) {
+        options.session_params.tile_order = TileOrder::SCANLINE;
+      }
+      else if (strcmp(argv[i], "hilbert") == 0) {
+        options.session_params.tile_order = TileOrder::HILBERT;
+      }
+      else if (strcmp(argv[i], "spiral") == 0) {
+        options.session_params.tile_order = TileOrder::SPIRAL;
+      }
+      else {
+        fprintf(stderr, "Unknown tile order: %s (expected scanline, hilbert or spiral)\n", argv[i]);
+        exit(EXIT_FAILURE);
+      }
+    }
+    else {
+      args.push_back(argv[i]);
+    }
+  }
+
+  /* Merging needs no scene or device, the positional arguments are the shard
+   * files to combine. */
+  if (options.merge_shards) {
+    if (args.empty()) {
+      fprintf(stderr, "No shard files specified to merge\n");
+      exit(EXIT_FAILURE);
+    }
+    for (const char *arg : args) {
+      options.merge_input.push_back(arg);
+    }
+    return;
   }
 
-  if (argc > 2) {
-    options.output_filepath = argv[2];
+  if (args.size() > 0) {
+    options.filepath = args[0];
+  }
+
+  if (args.size() > 1) {
+    options.output_filepath = args[1];
   }
 
   if (options.debug) {
@@ -607,6 +1228,7 @@ static void options_parse(const int argc, const char **argv)
   /* find matching device */
   const DeviceType device_type = Device::type_from_string(devicename.c_str());
   vector<DeviceInfo> devices = Device::available_devices(DEVICE_MASK(device_type));
+  startup_times.devices = time_dt();
 
   bool device_available = false;
   if (!devices.empty()) {
@@ -626,6 +1248,23 @@ static void options_parse(const int argc, const char **argv)
     fprintf(stderr, "No file path specified\n");
     exit(EXIT_FAILURE);
   }
+
+  /* Map the shard onto a deterministic sample subset. The subset offsets index
+   * into the same global sample sequence on every worker, so the union of all
+   * shards matches an unsharded render. */
+  if (options.shard_count > 0) {
+    const int samples = options.session_params.samples;
+    if (samples < options.shard_count) {
+      fprintf(stderr, "Shard count %d exceeds sample count %d\n", options.shard_count, samples);
+      exit(EXIT_FAILURE);
+    }
+    const int base = samples / options.shard_count;
+    const int remainder = samples % options.shard_count;
+    options.session_params.use_sample_subset = true;
+    options.session_params.sample_subset_offset = options.shard_index * base +
+                                                  min(options.shard_index, remainder);
+    options.session_params.sample_subset_length = base + (options.shard_index < remainder ? 1 : 0);
+  }
 }
 
 }
@@ -634,10 +1273,40 @@ using namespace ccl;
 
 int main(const int argc, const char **argv)
 {
+  startup_times.start = time_dt();
+
   util_logging_init(argv[0]);
   path_init();
   options_parse(argc, argv);
 
+  if (options.merge_shards) {
+    ImageMerger merger;
+    merger.input = options.merge_input;
+    merger.output = options.output_filepath;
+
+    printf("Merging %d shards to %s\n", (int)merger.input.size(), merger.output.c_str());
+    if (!merger.run()) {
+      fprintf(stderr, "Failed to merge shards: %s\n", merger.error.c_str());
+      return EXIT_FAILURE;
+    }
+    return 0;
+  }
+
+  if (options.sync_bench) {
+    session_sync_bench();
+    return 0;
+  }
+
+  if (options.benchmark) {
+    session_benchmark();
+    return 0;
+  }
+
+  if (options.animation) {
+    session_animation();
+    return 0;
+  }
+
 #ifdef WITH_CYCLES_STANDALONE_GUI
   if (options.session_params.background) {
 #endif
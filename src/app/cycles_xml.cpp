@@ -26,6 +26,7 @@
 
 #include "util/path.h"
 #include "util/projection.h"
+#include "util/tbb.h"
 #include "util/transform.h"
 #include "util/xml.h"
 
@@ -64,17 +65,72 @@ static bool xml_read_int(int *value, const xml_node node, const char *name)
   return false;
 }
 
+/* Large vertex and index arrays dominate XML load time, so they are parsed
+ * in parallel chunks. Chunk boundaries are moved to whitespace so no number
+ * straddles two chunks, and per-chunk results are concatenated in order. */
+
+template<typename T, typename ParseFunc>
+static void xml_parse_array(vector<T> &value, const char *data, ParseFunc parse)
+{
+  const size_t length = strlen(data);
+
+  const size_t chunk_size = 256 * 1024;
+  const size_t num_chunks = max((size_t)1, length / chunk_size);
+
+  /* Chunk boundaries, moved forward to the next whitespace. */
+  vector<size_t> bounds(num_chunks + 1);
+  bounds[0] = 0;
+  bounds[num_chunks] = length;
+  for (size_t i = 1; i < num_chunks; i++) {
+    size_t offset = i * (length / num_chunks);
+    while (offset < length && !isspace(data[offset])) {
+      offset++;
+    }
+    bounds[i] = offset;
+  }
+
+  vector<vector<T>> chunks(num_chunks);
+
+  parallel_for(blocked_range<size_t>(0, num_chunks, 1), [&](const blocked_range<size_t> &range) {
+    for (size_t i = range.begin(); i != range.end(); i++) {
+      vector<T> &chunk = chunks[i];
+      const char *end = data + bounds[i + 1];
+
+      const char *p = data + bounds[i];
+      while (p < end) {
+        while (p < end && isspace(*p)) {
+          p++;
+        }
+        if (p == end) {
+          break;
+        }
+
+        char *token_end = nullptr;
+        chunk.push_back(parse(p, &token_end));
+        p = token_end;
+      }
+    }
+  });
+
+  size_t total = value.size();
+  for (const vector<T> &chunk : chunks) {
+    total += chunk.size();
+  }
+  value.reserve(total);
+
+  for (const vector<T> &chunk : chunks) {
+    value.insert(value.end(), chunk.begin(), chunk.end());
+  }
+}
+
 static bool xml_read_int_array(vector<int> &value, const xml_node node, const char *name)
 {
   const xml_attribute attr = node.attribute(name);
 
   if (attr) {
-    vector<string> tokens;
-    string_split(tokens, attr.value());
-
-    for (const string &token : tokens) {
-      value.push_back(atoi(token.c_str()));
-    }
+    xml_parse_array(value, attr.value(), [](const char *token, char **token_end) {
+      return (int)strtol(token, token_end, 10);
+    });
 
     return true;
   }
@@ -99,12 +155,10 @@ static bool xml_read_float_array(vector<float> &value, const xml_node node, cons
   const xml_attribute attr = node.attribute(name);
 
   if (attr) {
-    vector<string> tokens;
-    string_split(tokens, attr.value());
-
-    for (const string &token : tokens) {
-      value.push_back((float)atof(token.c_str()));
-    }
+    xml_parse_array(
+        value, attr.value(), [](const char *token, char **token_end) {
+          return strtof(token, token_end);
+        });
 
     return true;
   }
@@ -15,12 +15,26 @@ namespace ccl {
 
 OIIOOutputDriver::OIIOOutputDriver(const string_view filepath,
                                    const string_view pass,
-                                   LogFunction log)
-    : filepath_(filepath), pass_(pass), log_(log)
+                                   LogFunction log,
+                                   const int num_samples)
+    : filepath_(filepath), pass_(pass), log_(log), num_samples_(num_samples)
 {
 }
 
-OIIOOutputDriver::~OIIOOutputDriver() = default;
+OIIOOutputDriver::~OIIOOutputDriver() noexcept
+{
+  write_pool_.wait_work();
+}
+
+void OIIOOutputDriver::set_filepath(const string_view filepath)
+{
+  filepath_ = filepath;
+}
+
+void OIIOOutputDriver::set_async_write(const bool async_write)
+{
+  async_write_ = async_write;
+}
 
 void OIIOOutputDriver::write_render_tile(const Tile &tile)
 {
@@ -29,26 +43,56 @@ void OIIOOutputDriver::write_render_tile(const Tile &tile)
     return;
   }
 
-  log_(string_printf("Writing image %s", filepath_.c_str()));
+  const int width = tile.size.x;
+  const int height = tile.size.y;
 
-  unique_ptr<ImageOutput> image_output(ImageOutput::create(filepath_));
-  if (image_output == nullptr) {
-    log_("Failed to create image file");
+  /* Reading the pass pixels references the render buffers, so it has to
+   * happen before returning; the encode and file write only need the copy and
+   * may be deferred to the write pool. */
+  vector<float> pixels(width * height * 4);
+  if (!tile.get_pass_pixels(pass_, 4, pixels.data())) {
+    log_("Failed to read render pass pixels");
     return;
   }
 
-  const int width = tile.size.x;
-  const int height = tile.size.y;
+  if (async_write_) {
+    write_pool_.push([this,
+                      filepath = filepath_,
+                      layer = tile.layer,
+                      width,
+                      height,
+                      pixels = std::move(pixels)]() mutable {
+      write_pixels(filepath, layer, width, height, std::move(pixels));
+    });
+  }
+  else {
+    write_pixels(filepath_, tile.layer, width, height, std::move(pixels));
+  }
+}
+
+void OIIOOutputDriver::write_pixels(const string filepath,
+                                    const string layer,
+                                    const int width,
+                                    const int height,
+                                    vector<float> pixels)
+{
+  log_(string_printf("Writing image %s", filepath.c_str()));
 
-  const ImageSpec spec(width, height, 4, TypeDesc::FLOAT);
-  if (!image_output->open(filepath_, spec)) {
+  unique_ptr<ImageOutput> image_output(ImageOutput::create(filepath));
+  if (image_output == nullptr) {
     log_("Failed to create image file");
     return;
   }
 
-  vector<float> pixels(width * height * 4);
-  if (!tile.get_pass_pixels(pass_, 4, pixels.data())) {
-    log_("Failed to read render pass pixels");
+  ImageSpec spec(width, height, 4, TypeDesc::FLOAT);
+  if (num_samples_ > 0) {
+    /* Sample count metadata, used to weight partial accumulation files when
+     * merging shards of a single frame. */
+    spec.attribute("cycles." + (layer.empty() ? "RenderLayer" : layer) + ".samples",
+                   to_string(num_samples_));
+  }
+  if (!image_output->open(filepath, spec)) {
+    log_("Failed to create image file");
     return;
   }
 
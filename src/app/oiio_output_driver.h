@@ -7,6 +7,8 @@
 #include "session/output_driver.h"
 
 #include "util/string.h"
+#include "util/task.h"
+#include "util/vector.h"
 
 namespace ccl {
 
@@ -14,15 +16,40 @@ class OIIOOutputDriver : public OutputDriver {
  public:
   using LogFunction = std::function<void(const string &)>;
 
-  OIIOOutputDriver(const string_view filepath, const string_view pass, LogFunction log);
-  ~OIIOOutputDriver() override;
+  OIIOOutputDriver(const string_view filepath,
+                   const string_view pass,
+                   LogFunction log,
+                   const int num_samples = 0);
+  ~OIIOOutputDriver() noexcept override;
 
   void write_render_tile(const Tile &tile) override;
 
+  /* Redirect the next write to a different file. Animation rendering sets the
+   * per-frame path with this; only call between frames, once the previous
+   * frame finished rendering. */
+  void set_filepath(const string_view filepath);
+
+  /* Run the image encode and file write on a background thread, so an
+   * animation render can sync and trace the next frame while the previous
+   * frame's image is written. The destructor waits for pending writes. */
+  void set_async_write(const bool async_write);
+
  protected:
+  void write_pixels(const string filepath,
+                    const string layer,
+                    const int width,
+                    const int height,
+                    vector<float> pixels);
+
   string filepath_;
   string pass_;
   LogFunction log_;
+  /* When non-zero, written as cycles.<layer>.samples metadata so partial
+   * accumulation files can be merged with sample-count weighting. */
+  int num_samples_;
+
+  bool async_write_ = false;
+  TaskPool write_pool_;
 };
 
 }
@@ -82,7 +82,7 @@ bool OpenGLDisplayDriver::update_begin(const Params &params,
 
   /* Update PBO dimensions if needed.
    *
-   * NOTE: Allocate the PBO for the size which will fit the final render resolution (as in,
+   * NOTE: Allocate the PBOs for the size which will fit the final render resolution (as in,
    * at a resolution divider 1. This was we don't need to recreate graphics interoperability
    * objects which are costly and which are tied to the specific underlying buffer size.
    * The downside of this approach is that when graphics interoperability is not used we are
@@ -91,8 +91,31 @@ bool OpenGLDisplayDriver::update_begin(const Params &params,
   const int buffer_height = params.full_size.y;
   if (texture_.buffer_width != buffer_width || texture_.buffer_height != buffer_height) {
     const size_t size_in_bytes = sizeof(half4) * buffer_width * buffer_height;
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, texture_.gl_pbo_id);
-    glBufferData(GL_PIXEL_UNPACK_BUFFER, size_in_bytes, nullptr, GL_DYNAMIC_DRAW);
+    for (PixelBuffer &pbo : texture_.pbos) {
+      if (pbo.upload_sync) {
+        glDeleteSync((GLsync)pbo.upload_sync);
+        pbo.upload_sync = nullptr;
+      }
+      if (texture_.persistent_pbos) {
+        /* Immutable storage can not be re-sized, create a new buffer object. */
+        glDeleteBuffers(1, &pbo.gl_id);
+        glGenBuffers(1, &pbo.gl_id);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo.gl_id);
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER,
+                        size_in_bytes,
+                        nullptr,
+                        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+        pbo.mapped = reinterpret_cast<half4 *>(glMapBufferRange(
+            GL_PIXEL_UNPACK_BUFFER,
+            0,
+            size_in_bytes,
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
+      }
+      else {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo.gl_id);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size_in_bytes, nullptr, GL_DYNAMIC_DRAW);
+      }
+    }
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
     texture_.buffer_width = buffer_width;
@@ -120,12 +143,30 @@ void OpenGLDisplayDriver::update_end()
 
 half4 *OpenGLDisplayDriver::map_texture_buffer()
 {
-  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, texture_.gl_pbo_id);
+  /* Rotate to the next ring slot, leaving the one the next texture upload reads from alone. */
+  texture_.write_pbo = (texture_.write_pbo + 1) % num_pbos_;
+  PixelBuffer &pbo = texture_.pbos[texture_.write_pbo];
+
+  /* With three buffers in flight the fence has practically always signaled by now, so this
+   * does not stall unless drawing is several refreshes behind. */
+  if (pbo.upload_sync) {
+    while (glClientWaitSync((GLsync)pbo.upload_sync, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000) ==
+           GL_TIMEOUT_EXPIRED)
+    {
+    }
+    glDeleteSync((GLsync)pbo.upload_sync);
+    pbo.upload_sync = nullptr;
+  }
 
-  half4 *mapped_rgba_pixels = reinterpret_cast<half4 *>(
-      glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+  half4 *mapped_rgba_pixels = pbo.mapped;
+  if (!texture_.persistent_pbos) {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo.gl_id);
+    mapped_rgba_pixels = reinterpret_cast<half4 *>(
+        glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+  }
   if (!mapped_rgba_pixels) {
     LOG(ERROR) << "Error mapping OpenGLDisplayDriver pixel buffer object.";
+    return nullptr;
   }
 
   if (texture_.need_clear) {
@@ -142,9 +183,13 @@ half4 *OpenGLDisplayDriver::map_texture_buffer()
 
 void OpenGLDisplayDriver::unmap_texture_buffer()
 {
-  glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+  if (!texture_.persistent_pbos) {
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
 
-  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  /* The slot now holds the newest complete pixels, texture upload switches over to it. */
+  texture_.upload_pbo = texture_.write_pbo;
 }
 
 /* --------------------------------------------------------------------
@@ -155,9 +200,14 @@ OpenGLDisplayDriver::GraphicsInterop OpenGLDisplayDriver::graphics_interop_get()
 {
   GraphicsInterop interop_dst;
 
+  /* Graphics interoperability handles are costly to create and are tied to the underlying
+   * buffer object, so the interop path is pinned to a single ring slot instead of rotating. */
+  texture_.write_pbo = 0;
+  texture_.upload_pbo = 0;
+
   interop_dst.buffer_width = texture_.buffer_width;
   interop_dst.buffer_height = texture_.buffer_height;
-  interop_dst.opengl_pbo_id = texture_.gl_pbo_id;
+  interop_dst.opengl_pbo_id = texture_.pbos[0].gl_id;
 
   interop_dst.need_clear = texture_.need_clear;
   texture_.need_clear = false;
@@ -291,9 +341,17 @@ void OpenGLDisplayDriver::gl_resources_destroy()
     glDeleteBuffers(1, &vertex_buffer_);
   }
 
-  if (texture_.gl_pbo_id) {
-    glDeleteBuffers(1, &texture_.gl_pbo_id);
-    texture_.gl_pbo_id = 0;
+  for (PixelBuffer &pbo : texture_.pbos) {
+    if (pbo.upload_sync) {
+      glDeleteSync((GLsync)pbo.upload_sync);
+      pbo.upload_sync = nullptr;
+    }
+    if (pbo.gl_id) {
+      /* Deleting the buffer implicitly releases any persistent mapping. */
+      glDeleteBuffers(1, &pbo.gl_id);
+      pbo.gl_id = 0;
+      pbo.mapped = nullptr;
+    }
   }
 
   if (texture_.gl_id) {
@@ -312,7 +370,7 @@ bool OpenGLDisplayDriver::gl_texture_resources_ensure()
   texture_.creation_attempted = true;
 
   DCHECK(!texture_.gl_id);
-  DCHECK(!texture_.gl_pbo_id);
+  DCHECK(!texture_.pbos[0].gl_id);
 
   /* Create texture. */
   glGenTextures(1, &texture_.gl_id);
@@ -328,13 +386,18 @@ bool OpenGLDisplayDriver::gl_texture_resources_ensure()
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
   glBindTexture(GL_TEXTURE_2D, 0);
 
-  /* Create PBO for the texture. */
-  glGenBuffers(1, &texture_.gl_pbo_id);
-  if (!texture_.gl_pbo_id) {
-    LOG(ERROR) << "Error creating texture pixel buffer object.";
-    return false;
+  /* Create the PBO ring for the texture. */
+  for (PixelBuffer &pbo : texture_.pbos) {
+    glGenBuffers(1, &pbo.gl_id);
+    if (!pbo.gl_id) {
+      LOG(ERROR) << "Error creating texture pixel buffer object.";
+      return false;
+    }
   }
 
+  /* Persistent mapping avoids the map call stalling on the GPU still reading the buffer. */
+  texture_.persistent_pbos = epoxy_has_gl_extension("GL_ARB_buffer_storage");
+
   /* Creation finished with a success. */
   texture_.is_created = true;
 
@@ -347,11 +410,19 @@ void OpenGLDisplayDriver::texture_update_if_needed()
     return;
   }
 
-  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, texture_.gl_pbo_id);
+  PixelBuffer &pbo = texture_.pbos[texture_.upload_pbo];
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo.gl_id);
   glTexSubImage2D(
       GL_TEXTURE_2D, 0, 0, 0, texture_.width, texture_.height, GL_RGBA, GL_HALF_FLOAT, nullptr);
   glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
+  /* Fence the upload, so the render thread only re-uses the buffer once the read finished. */
+  if (pbo.upload_sync) {
+    glDeleteSync((GLsync)pbo.upload_sync);
+  }
+  pbo.upload_sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
   texture_.need_update = false;
 }
 
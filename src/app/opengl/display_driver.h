@@ -64,6 +64,25 @@ class OpenGLDisplayDriver : public DisplayDriver {
    * NOTE: The buffer needs to be bound. */
   void vertex_buffer_update(const Params &params);
 
+  /* Number of Pixel Buffer Objects (PBO) in the upload ring. With three buffers the slot
+   * being re-mapped was uploaded two display refreshes ago, so its fence has practically
+   * always signaled and mapping never stalls on the GPU. */
+  static constexpr int num_pbos_ = 3;
+
+  /* One entry of the PBO upload ring. */
+  struct PixelBuffer {
+    /* OpenGL resource ID. NOTE: Allocated on the engine's context. */
+    uint gl_id = 0;
+
+    /* Persistent mapping of the buffer when ARB_buffer_storage is available, null otherwise
+     * (in which case the buffer is mapped and unmapped around every update). */
+    half4 *mapped = nullptr;
+
+    /* Fence inserted after the texture upload which read from this buffer. The buffer is only
+     * re-used for writing once the fence signaled. */
+    void *upload_sync = nullptr;
+  };
+
   /* Texture which contains pixels of the render result. */
   struct {
     /* Indicates whether texture creation was attempted and succeeded.
@@ -72,12 +91,19 @@ class OpenGLDisplayDriver : public DisplayDriver {
     bool creation_attempted = false;
     bool is_created = false;
 
-    /* OpenGL resource IDs of the texture itself and Pixel Buffer Object (PBO) used to write
-     * pixels to it.
+    /* OpenGL resource ID of the texture itself.
      *
      * NOTE: Allocated on the engine's context. */
     uint gl_id = 0;
-    uint gl_pbo_id = 0;
+
+    /* Ring of PBOs used to write pixels to the texture, with the slot render updates are
+     * writing into and the slot holding the newest complete pixels for texture upload. */
+    PixelBuffer pbos[num_pbos_];
+    int write_pbo = 0;
+    int upload_pbo = 0;
+
+    /* Whether the PBOs use persistent mapping (requires ARB_buffer_storage). */
+    bool persistent_pbos = false;
 
     /* Is true when new data was written to the PBO, meaning, the texture might need to be resized
      * and new data is to be uploaded to the GPU. */
@@ -10,6 +10,7 @@
 #include "bvh/binning.h"
 #include "bvh/node.h"
 #include "bvh/params.h"
+#include "bvh/sort.h"
 #include "bvh/split.h"
 
 #include "scene/curves.h"
@@ -542,10 +543,23 @@ unique_ptr<BVHNode> BVHBuild::run()
     rootnode = build_node(root, references, 0, local_storage);
     task_pool.wait_work();
   }
+  else if (params.use_fast_build && !params.top_level && !params.use_unaligned_nodes) {
+    /* Perform multithreaded Morton-order build. */
+    bvh_reference_sort_morton(0, references.size(), references.data(), root.cent_bounds());
+    rootnode = build_node_fast(root, 0);
+    task_pool.wait_work();
+  }
   else {
     /* Perform multithreaded binning build. */
-    const BVHObjectBinning rootbin(root, (!references.empty()) ? references.data() : nullptr);
-    rootnode = build_node(rootbin, 0);
+    if (params.top_level) {
+      /* Group references by shadow visibility first, so that camera-only
+       * geometry is culled with a single visibility test for shadow rays. */
+      rootnode = build_root_visibility_split(root);
+    }
+    if (!rootnode) {
+      const BVHObjectBinning rootbin(root, (!references.empty()) ? references.data() : nullptr);
+      rootnode = build_node(rootbin, 0);
+    }
     task_pool.wait_work();
   }
 
@@ -653,6 +667,30 @@ void BVHBuild::thread_build_spatial_split_node(InnerNode *inner,
   inner->children[child] = std::move(node);
 }
 
+void BVHBuild::thread_build_fast_node(InnerNode *inner,
+                                      const int child,
+                                      const BVHRange &range,
+                                      const int level)
+{
+  if (progress.get_cancel()) {
+    return;
+  }
+
+  /* build nodes */
+  unique_ptr<BVHNode> node = build_node_fast(range, level);
+
+  /* set child in inner node */
+  inner->children[child] = std::move(node);
+
+  /* update progress */
+  if (range.size() < THREAD_TASK_SIZE) {
+    const thread_scoped_lock lock(build_mutex);
+
+    progress_count += range.size();
+    progress_update();
+  }
+}
+
 bool BVHBuild::range_within_max_leaf_size(const BVHRange &range,
                                           const vector<BVHReference> &references) const
 {
@@ -708,6 +746,72 @@ bool BVHBuild::range_within_max_leaf_size(const BVHRange &range,
          (num_motion_points <= params.max_motion_point_leaf_size);
 }
 
+/* Partition top level references by shadow visibility.
+ *
+ * Geometry that is hidden to shadow rays tends to be spread across the whole
+ * scene, so shadow rays otherwise keep testing and rejecting its nodes one at
+ * a time all the way down the tree. Grouping such references into a dedicated
+ * subtree lets the per-node visibility masks cull all of them with a single
+ * test at the root. Returns null when the split is trivial and the regular
+ * binning build should be used instead. */
+unique_ptr<BVHNode> BVHBuild::build_root_visibility_split(const BVHRange &root)
+{
+  assert(params.top_level);
+
+  /* Precompute the predicate per object, references at the top level are
+   * per-primitive for non-instanced geometry. */
+  vector<bool> casts_shadow(objects.size());
+  for (size_t i = 0; i < objects.size(); i++) {
+    casts_shadow[i] = (objects[i]->visibility_for_tracing() & PATH_RAY_SHADOW) != 0;
+  }
+
+  /* Gather bounds of both groups and check whether the split is non-trivial. */
+  BoundBox bounds[2] = {BoundBox::empty, BoundBox::empty};
+  BoundBox cent_bounds[2] = {BoundBox::empty, BoundBox::empty};
+  size_t num_shadow = 0;
+
+  for (const BVHReference &ref : references) {
+    const int group = casts_shadow[ref.prim_object()] ? 0 : 1;
+    bounds[group].grow(ref.bounds());
+    cent_bounds[group].grow(ref.bounds().center2());
+    num_shadow += (group == 0) ? 1 : 0;
+  }
+
+  const size_t num_camera_only = references.size() - num_shadow;
+  if (num_shadow == 0 || num_camera_only == 0) {
+    return nullptr;
+  }
+
+  /* Reorder references so that each group is contiguous. */
+  vector<BVHReference> sorted_references;
+  sorted_references.reserve(references.size());
+  for (const BVHReference &ref : references) {
+    if (casts_shadow[ref.prim_object()]) {
+      sorted_references.push_back(ref);
+    }
+  }
+  for (const BVHReference &ref : references) {
+    if (!casts_shadow[ref.prim_object()]) {
+      sorted_references.push_back(ref);
+    }
+  }
+  references = std::move(sorted_references);
+
+  /* Build each group as its own subtree under a shared root. Level 1 keeps the
+   * regular leaf creation rules; the inner node created here already provides
+   * the visibility test that the top level otherwise forces with an extra
+   * split. */
+  const BVHRange shadow_range(bounds[0], cent_bounds[0], 0, (int)num_shadow);
+  const BVHObjectBinning shadow_bin(shadow_range, references.data());
+  unique_ptr<BVHNode> shadow_node = build_node(shadow_bin, 1);
+
+  const BVHRange camera_range(bounds[1], cent_bounds[1], (int)num_shadow, (int)num_camera_only);
+  const BVHObjectBinning camera_bin(camera_range, references.data());
+  unique_ptr<BVHNode> camera_node = build_node(camera_bin, 1);
+
+  return make_unique<InnerNode>(root.bounds(), std::move(shadow_node), std::move(camera_node));
+}
+
 /* multithreaded binning builder */
 unique_ptr<BVHNode> BVHBuild::build_node(const BVHObjectBinning &range, const int level)
 {
@@ -798,6 +902,64 @@ unique_ptr<BVHNode> BVHBuild::build_node(const BVHObjectBinning &range, const in
   return inner;
 }
 
+/* multithreaded Morton-order (fast) builder */
+unique_ptr<BVHNode> BVHBuild::build_node_fast(const BVHRange &range, const int level)
+{
+  if (progress.get_cancel()) {
+    return nullptr;
+  }
+
+  /* Make leaf once the range fits. There is no SAH termination test for the
+   * Morton-order build, the leaf size limits bound the quality. */
+  if (params.small_enough_for_leaf(range.size(), level) ||
+      range_within_max_leaf_size(range, references))
+  {
+    return create_leaf_node(range, references);
+  }
+
+  /* Split at the median of the Morton-sorted references. */
+  const int mid = range.size() / 2;
+
+  BoundBox left_bounds = BoundBox::empty;
+  BoundBox right_bounds = BoundBox::empty;
+  for (int i = 0; i < range.size(); i++) {
+    const BoundBox &prim_bounds = references[range.start() + i].bounds();
+    if (i < mid) {
+      left_bounds.grow(prim_bounds);
+    }
+    else {
+      right_bounds.grow(prim_bounds);
+    }
+  }
+
+  const BVHRange left(left_bounds, range.start(), mid);
+  const BVHRange right(right_bounds, range.start() + mid, range.size() - mid);
+
+  /* Create inner node. */
+  unique_ptr<InnerNode> inner;
+  if (range.size() < THREAD_TASK_SIZE) {
+    /* Local build. */
+    unique_ptr<BVHNode> leftnode = build_node_fast(left, level + 1);
+    unique_ptr<BVHNode> rightnode = build_node_fast(right, level + 1);
+
+    inner = make_unique<InnerNode>(range.bounds(), std::move(leftnode), std::move(rightnode));
+  }
+  else {
+    /* Threaded build. */
+    inner = make_unique<InnerNode>(range.bounds());
+    InnerNode *inner_ptr = inner.get();
+
+    task_pool.push([this, inner_ptr, left, level] {
+      thread_build_fast_node(inner_ptr, 0, left, level + 1);
+    });
+    task_pool.push([this, inner_ptr, right, level] {
+      thread_build_fast_node(inner_ptr, 1, right, level + 1);
+    });
+  }
+
+  return inner;
+}
+
 /* multithreaded spatial split builder */
 unique_ptr<BVHNode> BVHBuild::build_node(const BVHRange &range,
                                          vector<BVHReference> &references,
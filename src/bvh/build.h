@@ -76,6 +76,8 @@ class BVHBuild {
                                  const int level,
                                  BVHSpatialStorage *storage);
   unique_ptr<BVHNode> build_node(const BVHObjectBinning &range, const int level);
+  unique_ptr<BVHNode> build_node_fast(const BVHRange &range, const int level);
+  unique_ptr<BVHNode> build_root_visibility_split(const BVHRange &root);
   unique_ptr<BVHNode> create_leaf_node(const BVHRange &range,
                                        const vector<BVHReference> &references);
   unique_ptr<BVHNode> create_object_leaf_nodes(const BVHReference *ref,
@@ -96,6 +98,10 @@ class BVHBuild {
                                        const BVHRange &range,
                                        vector<BVHReference> &references,
                                        int level);
+  void thread_build_fast_node(InnerNode *inner,
+                              const int child,
+                              const BVHRange &range,
+                              const int level);
   thread_mutex build_mutex;
 
   /* Progress. */
@@ -83,6 +83,11 @@ class BVH {
     this->objects = objects;
   }
 
+  /* Refit bounds of the existing tree to updated primitive data, without
+   * re-partitioning. Only meaningful for layouts built on the host; layouts
+   * built by the device refit through Device::build_bvh. */
+  virtual void refit(Progress & /*progress*/) {}
+
  protected:
   BVH(const BVHParams &params,
       const vector<Geometry *> &geometry,
@@ -139,6 +139,64 @@ void BVH2::pack_aligned_inner(const BVHStackEntry &e,
                     e1.node->visibility);
 }
 
+/* Convert to half bits rounding toward -inf (round_up false) or +inf
+ * (round_up true), so the value decoded by half_bits_to_float() is guaranteed
+ * to bound f conservatively. Magnitudes above the half range saturate to the
+ * infinity bit pattern, which decodes to +/-FLT_MAX. */
+static uint bvh_compact_half(const float f, const bool round_up)
+{
+  const bool negative = std::signbit(f);
+  const float m = fabsf(f);
+  const uint u = __float_as_uint(m);
+  const uint e = u >> 23;
+  uint h;
+  bool inexact;
+  if (e >= 143) {
+    /* Above the largest finite half. */
+    h = 0x7bff;
+    inexact = true;
+  }
+  else if (e >= 113) {
+    /* Normal range. */
+    h = ((e - 112) << 10) | ((u >> 13) & 0x3ff);
+    inexact = (u & 0x1fff) != 0;
+  }
+  else {
+    /* Subnormal: scale by 2^24 is exact, the conversion truncates. */
+    h = (uint)(m * 16777216.0f);
+    inexact = ((float)h * (1.0f / 16777216.0f) != m);
+  }
+  /* Truncation rounds toward zero; bump the magnitude when the conservative
+   * direction is away from zero. Half bit patterns are contiguous, so this
+   * also handles the subnormal/normal and finite/infinity boundaries. */
+  if (inexact && (round_up != negative)) {
+    h += 1;
+  }
+  return h | (negative ? 0x8000 : 0);
+}
+
+void BVH2::pack_compact_node(const int idx, const BoundBox &b0, const BoundBox &b1, int c0, int c1)
+{
+  assert(idx + BVH_NODE_COMPACT_SIZE <= pack.nodes.size());
+  assert(c0 < 0 || c0 < pack.nodes.size());
+  assert(c1 < 0 || c1 < pack.nodes.size());
+
+  /* Per component the lower 16 bits hold the minimum, the upper 16 bits the
+   * maximum. Children stay in data[0].z/w where traversal expects them. */
+  const int4 data[BVH_NODE_COMPACT_SIZE] = {
+      make_int4((int)(bvh_compact_half(b0.min.x, false) | (bvh_compact_half(b0.max.x, true) << 16)),
+                (int)(bvh_compact_half(b0.min.y, false) | (bvh_compact_half(b0.max.y, true) << 16)),
+                c0,
+                c1),
+      make_int4((int)(bvh_compact_half(b0.min.z, false) | (bvh_compact_half(b0.max.z, true) << 16)),
+                (int)(bvh_compact_half(b1.min.x, false) | (bvh_compact_half(b1.max.x, true) << 16)),
+                (int)(bvh_compact_half(b1.min.y, false) | (bvh_compact_half(b1.max.y, true) << 16)),
+                (int)(bvh_compact_half(b1.min.z, false) | (bvh_compact_half(b1.max.z, true) << 16))),
+  };
+
+  std::copy_n(data, BVH_NODE_COMPACT_SIZE, &pack.nodes[idx]);
+}
+
 void BVH2::pack_aligned_node(const int idx,
                              const BoundBox &b0,
                              const BoundBox &b1,
@@ -147,6 +205,11 @@ void BVH2::pack_aligned_node(const int idx,
                              uint visibility0,
                              uint visibility1)
 {
+  if (use_compact_nodes()) {
+    pack_compact_node(idx, b0, b1, c0, c1);
+    return;
+  }
+
   assert(idx + BVH_NODE_SIZE <= pack.nodes.size());
   assert(c0 < 0 || c0 < pack.nodes.size());
   assert(c1 < 0 || c1 < pack.nodes.size());
@@ -222,6 +285,7 @@ void BVH2::pack_nodes(const BVHNode *root)
   const size_t num_leaf_nodes = root->getSubtreeSize(BVH_STAT_LEAF_COUNT);
   assert(num_leaf_nodes <= num_nodes);
   const size_t num_inner_nodes = num_nodes - num_leaf_nodes;
+  const int aligned_node_size = use_compact_nodes() ? BVH_NODE_COMPACT_SIZE : BVH_NODE_SIZE;
   size_t node_size;
   if (params.use_unaligned_nodes) {
     const size_t num_unaligned_nodes = root->getSubtreeSize(BVH_STAT_UNALIGNED_INNER_COUNT);
@@ -229,7 +293,7 @@ void BVH2::pack_nodes(const BVHNode *root)
                 (num_inner_nodes - num_unaligned_nodes) * BVH_NODE_SIZE;
   }
   else {
-    node_size = num_inner_nodes * BVH_NODE_SIZE;
+    node_size = num_inner_nodes * aligned_node_size;
   }
   /* Resize arrays */
   pack.nodes.clear();
@@ -253,7 +317,7 @@ void BVH2::pack_nodes(const BVHNode *root)
   }
   else {
     stack.push_back(BVHStackEntry(root, nextNodeIdx));
-    nextNodeIdx += root->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE : BVH_NODE_SIZE;
+    nextNodeIdx += root->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE : aligned_node_size;
   }
 
   while (!stack.empty()) {
@@ -275,7 +339,7 @@ void BVH2::pack_nodes(const BVHNode *root)
         else {
           idx[i] = nextNodeIdx;
           nextNodeIdx += e.node->get_child(i)->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE :
-                                                                 BVH_NODE_SIZE;
+                                                                 aligned_node_size;
         }
       }
 
@@ -319,10 +383,14 @@ void BVH2::refit_node(const int idx, bool leaf, BoundBox &bbox, uint &visibility
     std::copy_n(leaf_data, BVH_NODE_LEAF_SIZE, &pack.leaf_nodes[idx]);
   }
   else {
-    assert(idx + BVH_NODE_SIZE <= pack.nodes.size());
+    assert(idx + (use_compact_nodes() ? BVH_NODE_COMPACT_SIZE : BVH_NODE_SIZE) <=
+           pack.nodes.size());
 
     const int4 *data = &pack.nodes[idx];
-    const bool is_unaligned = (data[0].x & PATH_RAY_NODE_UNALIGNED) != 0;
+    /* Compact nodes store half floats in data[0].x, which could spuriously
+     * have the unaligned flag bit set. They are always axis aligned. */
+    const bool is_unaligned = !use_compact_nodes() &&
+                              (data[0].x & PATH_RAY_NODE_UNALIGNED) != 0;
     const int c0 = data[0].z;
     const int c1 = data[0].w;
     /* refit inner node, set bbox from children */
@@ -610,7 +678,14 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
       for (size_t i = 0; i < bvh_nodes_size;) {
         size_t nsize;
         size_t nsize_bbox;
-        if (bvh_nodes[i].x & PATH_RAY_NODE_UNALIGNED) {
+        if (use_compact_nodes()) {
+          /* Compact nodes keep half floats in data[0].x, so the unaligned
+           * flag bit cannot be sniffed from it. The whole scene uses the
+           * same node format, and compact excludes unaligned nodes. */
+          nsize = BVH_NODE_COMPACT_SIZE;
+          nsize_bbox = 0;
+        }
+        else if (bvh_nodes[i].x & PATH_RAY_NODE_UNALIGNED) {
           nsize = BVH_UNALIGNED_NODE_SIZE;
           nsize_bbox = 0;
         }
@@ -20,6 +20,7 @@ namespace ccl {
 #define BVH_NODE_SIZE 4
 #define BVH_NODE_LEAF_SIZE 1
 #define BVH_UNALIGNED_NODE_SIZE 7
+#define BVH_NODE_COMPACT_SIZE 2
 // NOLINTEND
 
 /* Pack Utility */
@@ -42,7 +43,7 @@ class BVH2 : public BVH {
        const vector<Object *> &objects);
 
   void build(Progress &progress, Stats *stats);
-  void refit(Progress &progress);
+  void refit(Progress &progress) override;
 
   PackedBVH pack;
 
@@ -67,6 +68,8 @@ class BVH2 : public BVH {
                          uint visibility0,
                          uint visibility1);
 
+  void pack_compact_node(const int idx, const BoundBox &b0, const BoundBox &b1, int c0, int c1);
+
   void pack_unaligned_inner(const BVHStackEntry &e,
                             const BVHStackEntry &e0,
                             const BVHStackEntry &e1);
@@ -93,6 +96,13 @@ class BVH2 : public BVH {
 
   /* merge instance BVH's */
   void pack_instances(const size_t nodes_size, const size_t leaf_nodes_size);
+
+  /* Compact nodes store quantized child bounds and no per-child visibility
+   * masks, halving inner node memory. Incompatible with unaligned nodes. */
+  bool use_compact_nodes() const
+  {
+    return params.use_compact_structure && !params.use_unaligned_nodes;
+  }
 };
 
 }
@@ -0,0 +1,281 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "bvh/cache.h"
+
+#include "bvh/bvh.h"
+#include "bvh/params.h"
+
+#include "scene/attribute.h"
+#include "scene/hair.h"
+#include "scene/mesh.h"
+#include "scene/pointcloud.h"
+
+#include "util/log.h"
+#include "util/fasthash.h"
+#include "util/path.h"
+#include "util/system.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace ccl {
+
+/* Bump whenever the PackedBVH layout or the key computation changes. */
+static const uint32_t BVH_CACHE_VERSION = 1;
+static const uint32_t BVH_CACHE_MAGIC = 0x48564243; /* 'CBVH' */
+
+static const char *bvh_cache_dir()
+{
+  return getenv("CYCLES_BVH_CACHE_DIR");
+}
+
+bool bvh_cache_enabled()
+{
+  const char *dir = bvh_cache_dir();
+  return dir != nullptr && dir[0] != '\0';
+}
+
+/* Key Computation */
+
+template<typename T> static void bvh_cache_key_append(FastHash &hash, const array<T> &data)
+{
+  const size_t size = data.size();
+  hash.append((const uint8_t *)&size, sizeof(size));
+  if (size != 0) {
+    hash.append((const uint8_t *)data.data(), size * sizeof(T));
+  }
+}
+
+static void bvh_cache_key_append_motion(FastHash &hash, Geometry *geom, AttributeStandard std)
+{
+  const Attribute *attr = geom->attributes.find(std);
+  const size_t size = (attr != nullptr) ? attr->buffer.size() : 0;
+  hash.append((const uint8_t *)&size, sizeof(size));
+  if (size != 0) {
+    hash.append((const uint8_t *)attr->buffer.data(), size);
+  }
+}
+
+string bvh_cache_key(const BVHParams &params, const vector<Geometry *> &geometry)
+{
+  /* Only geometry level BVH2 trees are cached. The top level tree depends on
+   * object transforms and visibility which change far more often than the
+   * geometry itself. */
+  if (params.top_level || params.bvh_layout != BVH_LAYOUT_BVH2 || geometry.size() != 1) {
+    return "";
+  }
+
+  FastHash hash;
+
+  /* Build parameters which influence the packed tree. */
+  hash.append((const uint8_t *)&BVH_CACHE_VERSION, sizeof(BVH_CACHE_VERSION));
+  hash.append((const uint8_t *)&params.use_spatial_split, sizeof(params.use_spatial_split));
+  hash.append((const uint8_t *)&params.spatial_split_alpha, sizeof(params.spatial_split_alpha));
+  hash.append((const uint8_t *)&params.use_unaligned_nodes, sizeof(params.use_unaligned_nodes));
+  hash.append((const uint8_t *)&params.use_compact_structure, sizeof(params.use_compact_structure));
+  hash.append((const uint8_t *)&params.unaligned_split_threshold,
+             sizeof(params.unaligned_split_threshold));
+  hash.append((const uint8_t *)&params.num_motion_triangle_steps,
+             sizeof(params.num_motion_triangle_steps));
+  hash.append((const uint8_t *)&params.num_motion_curve_steps,
+             sizeof(params.num_motion_curve_steps));
+  hash.append((const uint8_t *)&params.num_motion_point_steps,
+             sizeof(params.num_motion_point_steps));
+  hash.append((const uint8_t *)&params.bvh_type, sizeof(params.bvh_type));
+  hash.append((const uint8_t *)&params.curve_subdivisions, sizeof(params.curve_subdivisions));
+
+  /* Geometry topology and vertex data. */
+  Geometry *geom = geometry[0];
+  const int geometry_type = geom->geometry_type;
+  hash.append((const uint8_t *)&geometry_type, sizeof(geometry_type));
+
+  switch (geom->geometry_type) {
+    case Geometry::MESH:
+    case Geometry::VOLUME: {
+      Mesh *mesh = static_cast<Mesh *>(geom);
+      bvh_cache_key_append(hash, mesh->get_verts());
+      bvh_cache_key_append(hash, mesh->get_triangles());
+      bvh_cache_key_append_motion(hash, geom, ATTR_STD_MOTION_VERTEX_POSITION);
+      break;
+    }
+    case Geometry::HAIR: {
+      Hair *hair = static_cast<Hair *>(geom);
+      bvh_cache_key_append(hash, hair->get_curve_keys());
+      bvh_cache_key_append(hash, hair->get_curve_radius());
+      bvh_cache_key_append(hash, hair->get_curve_first_key());
+      bvh_cache_key_append_motion(hash, geom, ATTR_STD_MOTION_VERTEX_POSITION);
+      break;
+    }
+    case Geometry::POINTCLOUD: {
+      PointCloud *pointcloud = static_cast<PointCloud *>(geom);
+      bvh_cache_key_append(hash, pointcloud->get_points());
+      bvh_cache_key_append(hash, pointcloud->get_radius());
+      bvh_cache_key_append_motion(hash, geom, ATTR_STD_MOTION_VERTEX_POSITION);
+      break;
+    }
+    default:
+      return "";
+  }
+
+  return hash.get_hex();
+}
+
+/* Serialization */
+
+static string bvh_cache_path(const string &key)
+{
+  return path_join(bvh_cache_dir(), key + ".bvh");
+}
+
+template<typename T> static void bvh_cache_write_array(FILE *f, const array<T> &data)
+{
+  const uint64_t size = data.size();
+  fwrite(&size, sizeof(size), 1, f);
+  if (size != 0) {
+    fwrite(data.data(), sizeof(T), size, f);
+  }
+}
+
+template<typename T>
+static bool bvh_cache_read_array(const uint8_t *&p, const uint8_t *end, array<T> &data)
+{
+  if (p + sizeof(uint64_t) > end) {
+    return false;
+  }
+  uint64_t size;
+  memcpy(&size, p, sizeof(size));
+  p += sizeof(size);
+
+  if (p + size * sizeof(T) > end) {
+    return false;
+  }
+  data.resize(size);
+  if (size != 0) {
+    memcpy(data.data(), p, size * sizeof(T));
+    p += size * sizeof(T);
+  }
+  return true;
+}
+
+static bool bvh_cache_unpack(const uint8_t *buffer, const size_t size, PackedBVH &pack)
+{
+  const uint8_t *p = buffer;
+  const uint8_t *end = buffer + size;
+
+  uint32_t magic;
+  uint32_t version;
+  if (p + sizeof(magic) + sizeof(version) + sizeof(pack.root_index) > end) {
+    return false;
+  }
+  memcpy(&magic, p, sizeof(magic));
+  p += sizeof(magic);
+  memcpy(&version, p, sizeof(version));
+  p += sizeof(version);
+  if (magic != BVH_CACHE_MAGIC || version != BVH_CACHE_VERSION) {
+    return false;
+  }
+  memcpy(&pack.root_index, p, sizeof(pack.root_index));
+  p += sizeof(pack.root_index);
+
+  return bvh_cache_read_array(p, end, pack.nodes) &&
+         bvh_cache_read_array(p, end, pack.leaf_nodes) &&
+         bvh_cache_read_array(p, end, pack.object_node) &&
+         bvh_cache_read_array(p, end, pack.prim_type) &&
+         bvh_cache_read_array(p, end, pack.prim_visibility) &&
+         bvh_cache_read_array(p, end, pack.prim_index) &&
+         bvh_cache_read_array(p, end, pack.prim_object) &&
+         bvh_cache_read_array(p, end, pack.prim_time);
+}
+
+bool bvh_cache_load(const string &key, PackedBVH &pack)
+{
+  const string filepath = bvh_cache_path(key);
+
+#ifndef _WIN32
+  /* Memory-map the file so the node arrays are copied straight from the page
+   * cache, without an intermediate read buffer. */
+  const int fd = open(filepath.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+
+  void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  const bool result = bvh_cache_unpack((const uint8_t *)mapping, st.st_size, pack);
+  munmap(mapping, st.st_size);
+#else
+  vector<uint8_t> buffer;
+  if (!path_read_binary(filepath, buffer)) {
+    return false;
+  }
+  const bool result = bvh_cache_unpack(buffer.data(), buffer.size(), pack);
+#endif
+
+  if (result) {
+    VLOG_WORK << "Loaded BVH from cache: " << filepath;
+  }
+  else {
+    VLOG_WORK << "Discarding unusable BVH cache file: " << filepath;
+  }
+  return result;
+}
+
+void bvh_cache_save(const string &key, const PackedBVH &pack)
+{
+  const string filepath = bvh_cache_path(key);
+
+  /* Write to a temporary file and rename so concurrent renders never observe
+   * a partially written cache entry. */
+  const string filepath_temp = filepath + ".part" + to_string(system_self_process_id());
+
+  FILE *f = fopen(filepath_temp.c_str(), "wb");
+  if (f == nullptr) {
+    VLOG_WORK << "Failed to open BVH cache file for writing: " << filepath_temp;
+    return;
+  }
+
+  fwrite(&BVH_CACHE_MAGIC, sizeof(BVH_CACHE_MAGIC), 1, f);
+  fwrite(&BVH_CACHE_VERSION, sizeof(BVH_CACHE_VERSION), 1, f);
+  fwrite(&pack.root_index, sizeof(pack.root_index), 1, f);
+
+  bvh_cache_write_array(f, pack.nodes);
+  bvh_cache_write_array(f, pack.leaf_nodes);
+  bvh_cache_write_array(f, pack.object_node);
+  bvh_cache_write_array(f, pack.prim_type);
+  bvh_cache_write_array(f, pack.prim_visibility);
+  bvh_cache_write_array(f, pack.prim_index);
+  bvh_cache_write_array(f, pack.prim_object);
+  bvh_cache_write_array(f, pack.prim_time);
+
+  const bool ok = (ferror(f) == 0);
+  fclose(f);
+
+  if (!ok || rename(filepath_temp.c_str(), filepath.c_str()) != 0) {
+    path_remove(filepath_temp);
+    VLOG_WORK << "Failed to write BVH cache file: " << filepath;
+    return;
+  }
+
+  VLOG_WORK << "Saved BVH to cache: " << filepath;
+}
+
+}
@@ -0,0 +1,41 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "util/string.h"
+#include "util/vector.h"
+
+namespace ccl {
+
+class BVHParams;
+class Geometry;
+struct PackedBVH;
+
+/* On-disk cache for packed BVH2 trees.
+ *
+ * Render farms often re-render the same scene many times, and rebuilding
+ * every geometry BVH from scratch on each run is pure overhead. When enabled,
+ * the packed node arrays of a geometry level BVH2 are serialized to disk,
+ * keyed by a digest of the geometry topology, vertex data and the build
+ * parameters, so warm-start renders can skip the build entirely.
+ *
+ * The cache is opt-in through the CYCLES_BVH_CACHE_DIR environment variable,
+ * which points at the directory to store cache files in. */
+
+bool bvh_cache_enabled();
+
+/* Compute cache key for a geometry level BVH build. Returns an empty string
+ * when the BVH is not cacheable (top level tree, or multiple geometries). */
+string bvh_cache_key(const BVHParams &params, const vector<Geometry *> &geometry);
+
+/* Load packed BVH from the cache. Returns false on cache miss or when the
+ * file on disk is not usable. */
+bool bvh_cache_load(const string &key, PackedBVH &pack);
+
+/* Store packed BVH in the cache. Failure to write is not an error, the
+ * next render will simply build again. */
+void bvh_cache_save(const string &key, const PackedBVH &pack);
+
+}
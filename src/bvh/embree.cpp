@@ -254,20 +254,12 @@ void BVHEmbree::add_object(Object *ob, const int i)
   }
 }
 
-void BVHEmbree::add_instance(Object *ob, const int i)
+void BVHEmbree::set_instance_transform(RTCGeometry geom_id, const Object *ob)
 {
-  BVHEmbree *instance_bvh = static_cast<BVHEmbree *>(ob->get_geometry()->bvh.get());
-  assert(instance_bvh != nullptr);
-
-  const size_t num_object_motion_steps = ob->use_motion() ? ob->get_motion().size() : 1;
-  const size_t num_motion_steps = min(num_object_motion_steps, (size_t)RTC_MAX_TIME_STEP_COUNT);
-  assert(num_object_motion_steps <= RTC_MAX_TIME_STEP_COUNT);
-
-  RTCGeometry geom_id = rtcNewGeometry(rtc_device, RTC_GEOMETRY_TYPE_INSTANCE);
-  rtcSetGeometryInstancedScene(geom_id, instance_bvh->scene);
-  rtcSetGeometryTimeStepCount(geom_id, num_motion_steps);
-
   if (ob->use_motion()) {
+    const size_t num_object_motion_steps = ob->get_motion().size();
+    const size_t num_motion_steps = min(num_object_motion_steps, (size_t)RTC_MAX_TIME_STEP_COUNT);
+
     array<DecomposedTransform> decomp(ob->get_motion().size());
     transform_motion_decompose(decomp.data(), ob->get_motion().data(), ob->get_motion().size());
     for (size_t step = 0; step < num_motion_steps; ++step) {
@@ -288,6 +280,22 @@ void BVHEmbree::add_instance(Object *ob, const int i)
     rtcSetGeometryTransform(
         geom_id, 0, RTC_FORMAT_FLOAT3X4_ROW_MAJOR, (const float *)&ob->get_tfm());
   }
+}
+
+void BVHEmbree::add_instance(Object *ob, const int i)
+{
+  BVHEmbree *instance_bvh = static_cast<BVHEmbree *>(ob->get_geometry()->bvh.get());
+  assert(instance_bvh != nullptr);
+
+  const size_t num_object_motion_steps = ob->use_motion() ? ob->get_motion().size() : 1;
+  const size_t num_motion_steps = min(num_object_motion_steps, (size_t)RTC_MAX_TIME_STEP_COUNT);
+  assert(num_object_motion_steps <= RTC_MAX_TIME_STEP_COUNT);
+
+  RTCGeometry geom_id = rtcNewGeometry(rtc_device, RTC_GEOMETRY_TYPE_INSTANCE);
+  rtcSetGeometryInstancedScene(geom_id, instance_bvh->scene);
+  rtcSetGeometryTimeStepCount(geom_id, num_motion_steps);
+
+  set_instance_transform(geom_id, ob);
 
   rtcSetGeometryUserData(geom_id, (void *)instance_bvh->scene);
   rtcSetGeometryMask(geom_id, ob->visibility_for_tracing());
@@ -689,10 +697,20 @@ void BVHEmbree::refit(Progress &progress)
 {
   progress.set_substatus("Refitting BVH nodes");
 
-  /* Update all vertex buffers, then tell Embree to rebuild/-fit the BVHs. */
+  /* Update all vertex buffers and instance transforms, then tell Embree to
+   * rebuild/-fit the BVHs. */
   unsigned geom_id = 0;
   for (Object *ob : objects) {
-    if (!params.top_level || (ob->is_traceable() && !ob->get_geometry()->is_instanced())) {
+    if (params.top_level && ob->is_traceable() && ob->get_geometry()->is_instanced()) {
+      /* Refresh the instance transform in place so the committed child
+       * rtcScene is reused when only objects moved. */
+      RTCGeometry inst = rtcGetGeometry(scene, geom_id);
+      if (inst != nullptr) {
+        set_instance_transform(inst, ob);
+        rtcCommitGeometry(inst);
+      }
+    }
+    else if (!params.top_level || (ob->is_traceable() && !ob->get_geometry()->is_instanced())) {
       Geometry *geom = ob->get_geometry();
 
       if (geom->is_mesh() || geom->is_volume()) {
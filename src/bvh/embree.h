@@ -31,7 +31,7 @@ class BVHEmbree : public BVH {
              Stats *stats,
              RTCDevice rtc_device,
              const bool rtc_device_is_sycl_ = false);
-  void refit(Progress &progress);
+  void refit(Progress &progress) override;
 
 #  if defined(WITH_EMBREE_GPU) && RTC_VERSION >= 40302
   RTCError offload_scenes_to_gpu(const vector<RTCScene> &scenes);
@@ -54,6 +54,7 @@ class BVHEmbree : public BVH {
   void add_triangles(const Object *ob, const Mesh *mesh, const int i);
 
  private:
+  void set_instance_transform(RTCGeometry geom_id, const Object *ob);
   void set_tri_vertex_buffer(RTCGeometry geom_id, const Mesh *mesh, const bool update);
   void set_curve_vertex_buffer(RTCGeometry geom_id, const Hair *hair, const bool update);
   void set_point_vertex_buffer(RTCGeometry geom_id,
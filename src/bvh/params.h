@@ -90,6 +90,12 @@ class BVHParams {
   /* Use compact acceleration structure (Embree)*/
   bool use_compact_structure;
 
+  /* Trade tree quality for build speed: order references along the Morton
+   * curve and split at the median instead of running the SAH binner. Used
+   * for dynamic BVHs where scene update latency matters more than trace
+   * performance. */
+  bool use_fast_build;
+
   /* Split time range to this number of steps and create leaf node for each
    * of this time steps.
    *
@@ -133,6 +139,7 @@ class BVHParams {
     top_level = false;
     bvh_layout = BVH_LAYOUT_BVH2;
     use_compact_structure = false;
+    use_fast_build = false;
     use_unaligned_nodes = false;
 
     num_motion_curve_steps = 0;
@@ -300,6 +307,48 @@ struct BVHSpatialBin {
   int exit;
 
   __forceinline BVHSpatialBin() = default;
+
+  __forceinline void clear()
+  {
+    bounds = BoundBox::empty;
+    enter = 0;
+    exit = 0;
+  }
+
+  __forceinline void merge(const BVHSpatialBin &other)
+  {
+    bounds.grow(other.bounds);
+    enter += other.enter;
+    exit += other.exit;
+  }
+};
+
+/* BVH Spatial Bin Table
+ *
+ * Histogram of spatial bins for all three split dimensions. Keeping the full
+ * table in a single struct allows the binning step to fill one table per
+ * thread and merge them afterwards. */
+
+struct BVHSpatialBinTable {
+  BVHSpatialBin bins[3][BVHParams::NUM_SPATIAL_BINS];
+
+  void clear()
+  {
+    for (int dim = 0; dim < 3; dim++) {
+      for (int i = 0; i < BVHParams::NUM_SPATIAL_BINS; i++) {
+        bins[dim][i].clear();
+      }
+    }
+  }
+
+  void merge(const BVHSpatialBinTable &other)
+  {
+    for (int dim = 0; dim < 3; dim++) {
+      for (int i = 0; i < BVHParams::NUM_SPATIAL_BINS; i++) {
+        bins[dim][i].merge(other.bins[dim][i]);
+      }
+    }
+  }
 };
 
 /* BVH Spatial Storage
@@ -314,7 +363,7 @@ struct BVHSpatialStorage {
   vector<BoundBox> right_bounds;
 
   /* Bins used for histogram when selecting best split plane. */
-  BVHSpatialBin bins[3][BVHParams::NUM_SPATIAL_BINS];
+  BVHSpatialBinTable bins;
 
   /* Temporary storage for the new references. Used by spatial split to store
    * new references in before they're getting inserted into actual array,
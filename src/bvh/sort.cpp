@@ -11,7 +11,8 @@
 #include "bvh/unaligned.h"
 
 #include "util/algorithm.h"
-#include "util/task.h"
+#include "util/radix_sort.h"
+#include "util/tbb.h"
 
 namespace ccl {
 
@@ -82,86 +83,117 @@ struct BVHReferenceCompare {
   }
 };
 
-static void bvh_reference_sort_threaded(TaskPool *task_pool,
-                                        BVHReference *data,
-                                        const int job_start,
-                                        const int job_end,
-                                        const BVHReferenceCompare &compare);
-
-/* Multi-threaded reference sort. */
-static void bvh_reference_sort_threaded(TaskPool *task_pool,
-                                        BVHReference *data,
-                                        const int job_start,
-                                        const int job_end,
-                                        const BVHReferenceCompare &compare)
-{
-  int start = job_start;
-  int end = job_end;
-  bool have_work = (start < end);
-  while (have_work) {
-    const int count = job_end - job_start;
-    if (count < BVH_SORT_THRESHOLD) {
-      /* Number of reference low enough, faster to finish the job
-       * in one thread rather than to spawn more threads.
-       */
-      sort(data + job_start, data + job_end + 1, compare);
-      break;
-    }
-    /* Single QSort step.
-     * Use median-of-three method for the pivot point.
-     */
-    int left = start;
-    int right = end;
-    const int center = (left + right) >> 1;
-    if (compare.compare(data[left], data[center]) > 0) {
-      swap(data[left], data[center]);
-    }
-    if (compare.compare(data[left], data[right]) > 0) {
-      swap(data[left], data[right]);
-    }
-    if (compare.compare(data[center], data[right]) > 0) {
-      swap(data[center], data[right]);
-    }
-    swap(data[center], data[right - 1]);
-    const BVHReference median = data[right - 1];
-    do {
-      while (compare.compare(data[left], median) < 0) {
-        ++left;
-      }
-      while (compare.compare(data[right], median) > 0) {
-        --right;
-      }
-      if (left <= right) {
-        swap(data[left], data[right]);
-        ++left;
-        --right;
-      }
-    } while (left <= right);
-    /* We only create one new task here to reduce downside effects of
-     * latency in TaskScheduler.
-     * So generally current thread keeps working on the left part of the
-     * array, and we create new task for the right side.
-     * However, if there's nothing to be done in the left side of the array
-     * we don't create any tasks and make it so current thread works on the
-     * right side.
-     */
-    have_work = false;
-    if (left < end) {
-      if (start < right) {
-        task_pool->push([task_pool, data, left, end, compare] {
-          bvh_reference_sort_threaded(task_pool, data, left, end, compare);
-        });
-      }
-      else {
-        start = left;
-        have_work = true;
-      }
-    }
-    if (start < right) {
-      end = right;
-      have_work = true;
+/* Comparator which orders references along the Morton curve over the
+ * centroid bounds. The comparison path recomputes codes on the fly, while
+ * the radix path materializes them once through code(). */
+struct BVHMortonCompare {
+ public:
+  float3 base;
+  float3 scale;
+
+  explicit BVHMortonCompare(const BoundBox &cent_bounds)
+  {
+    base = cent_bounds.min;
+    /* 10 bits per axis. */
+    scale = safe_divide(make_float3(1023.0f), cent_bounds.max - cent_bounds.min);
+  }
+
+  /* Spread the lower 10 bits out to every third bit. */
+  static __forceinline uint32_t expand_bits(uint32_t v)
+  {
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+  }
+
+  __forceinline uint32_t code(const BVHReference &ref) const
+  {
+    const float3 p = (ref.bounds().center2() - base) * scale;
+    const uint32_t x = (uint32_t)clamp((int)p.x, 0, 1023);
+    const uint32_t y = (uint32_t)clamp((int)p.y, 0, 1023);
+    const uint32_t z = (uint32_t)clamp((int)p.z, 0, 1023);
+    return (expand_bits(x) << 2) | (expand_bits(y) << 1) | expand_bits(z);
+  }
+
+  __forceinline int compare(const BVHReference &ra, const BVHReference &rb) const
+  {
+    const uint32_t ca = code(ra);
+    const uint32_t cb = code(rb);
+
+    if (ca < cb) {
+      return -1;
+    }
+    if (ca > cb) {
+      return 1;
+    }
+    if (ra.prim_object() < rb.prim_object()) {
+      return -1;
+    }
+    if (ra.prim_object() > rb.prim_object()) {
+      return 1;
+    }
+    if (ra.prim_index() < rb.prim_index()) {
+      return -1;
+    }
+    if (ra.prim_index() > rb.prim_index()) {
+      return 1;
     }
+
+    return 0;
+  }
+
+  bool operator()(const BVHReference &ra, const BVHReference &rb) const
+  {
+    return (compare(ra, rb) < 0);
+  }
+};
+
+/* Parallel radix sort of the references, used above BVH_SORT_THRESHOLD where
+ * the comparison sort dominates the build profile. Keys are materialized once
+ * per reference and sorted together with an index, which is then applied as a
+ * permutation so that the heavy references are only moved a single time. The
+ * radix sort is stable, so references with equal keys keep their input order
+ * and the result stays deterministic. */
+template<typename Compare, typename KeyFunc>
+static void bvh_reference_sort_impl(const int start,
+                                    const int end,
+                                    BVHReference *data,
+                                    const Compare &compare,
+                                    const KeyFunc &key)
+{
+  const int count = end - start;
+  if (count < BVH_SORT_THRESHOLD) {
+    /* Small enough arrays are faster to sort in a single thread than to pay
+     * for key materialization and task scheduling. */
+    sort(data + start, data + end, compare);
+    return;
   }
+
+  vector<uint32_t> keys(count), temp_keys(count);
+  vector<int> indices(count), temp_indices(count);
+
+  parallel_for(blocked_range<int>(0, count, 4096), [&](const blocked_range<int> &r) {
+    for (int i = r.begin(); i != r.end(); i++) {
+      keys[i] = key(data[start + i]);
+      indices[i] = i;
+    }
+  });
+
+  radix_sort_pairs(keys.data(), indices.data(), temp_keys.data(), temp_indices.data(), count);
+
+  vector<BVHReference> sorted(count);
+  parallel_for(blocked_range<int>(0, count, 4096), [&](const blocked_range<int> &r) {
+    for (int i = r.begin(); i != r.end(); i++) {
+      sorted[i] = data[start + indices[i]];
+    }
+  });
+  parallel_for(blocked_range<int>(0, count, 4096), [&](const blocked_range<int> &r) {
+    for (int i = r.begin(); i != r.end(); i++) {
+      data[start + i] = sorted[i];
+    }
+  });
 }
 
 void bvh_reference_sort(const int start,
@@ -171,20 +203,23 @@ void bvh_reference_sort(const int start,
                         const BVHUnaligned *unaligned_heuristic,
                         const Transform *aligned_space)
 {
-  const int count = end - start;
   const BVHReferenceCompare compare(dim, unaligned_heuristic, aligned_space);
-  if (count < BVH_SORT_THRESHOLD) {
-    /* It is important to not use any mutex if array is small enough,
-     * otherwise we end up in situation when we're going to sleep far
-     * too often.
-     */
-    sort(data + start, data + end, compare);
-  }
-  else {
-    TaskPool task_pool;
-    bvh_reference_sort_threaded(&task_pool, data, start, end - 1, compare);
-    task_pool.wait_work();
-  }
+  /* Mapping the centroid to a sortable integer preserves the exact float
+   * ordering, so the radix path picks the same split positions. */
+  bvh_reference_sort_impl(start, end, data, compare, [&compare](const BVHReference &ref) {
+    const BoundBox bounds = compare.get_prim_bounds(ref);
+    return radix_sort_float_key(bounds.min[compare.dim] + bounds.max[compare.dim]);
+  });
+}
+
+void bvh_reference_sort_morton(const int start,
+                               const int end,
+                               BVHReference *data,
+                               const BoundBox &cent_bounds)
+{
+  const BVHMortonCompare compare(cent_bounds);
+  bvh_reference_sort_impl(
+      start, end, data, compare, [&compare](const BVHReference &ref) { return compare.code(ref); });
 }
 
 }
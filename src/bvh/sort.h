@@ -11,6 +11,7 @@ namespace ccl {
 
 class BVHReference;
 class BVHUnaligned;
+class BoundBox;
 struct Transform;
 
 void bvh_reference_sort(const int start,
@@ -20,4 +21,11 @@ void bvh_reference_sort(const int start,
                         const BVHUnaligned *unaligned_heuristic = nullptr,
                         const Transform *aligned_space = nullptr);
 
+/* Sort references along the Morton curve over the given centroid bounds,
+ * used by the fast linear builder. */
+void bvh_reference_sort_morton(const int start,
+                               const int end,
+                               BVHReference *data,
+                               const BoundBox &cent_bounds);
+
 }
@@ -16,6 +16,7 @@
 #include "scene/pointcloud.h"
 
 #include "util/algorithm.h"
+#include "util/tbb.h"
 
 namespace ccl {
 
@@ -155,46 +156,67 @@ BVHSpatialSplit::BVHSpatialSplit(const BVHBuild &builder,
   float3 binSize = (range_bounds.max - origin) * (1.0f / (float)BVHParams::NUM_SPATIAL_BINS);
   const float3 invBinSize = safe_divide(make_float3(1.0f), binSize);
 
-  for (int dim = 0; dim < 3; dim++) {
-    for (int i = 0; i < BVHParams::NUM_SPATIAL_BINS; i++) {
-      BVHSpatialBin &bin = storage_->bins[dim][i];
-
-      bin.bounds = BoundBox::empty;
-      bin.enter = 0;
-      bin.exit = 0;
-    }
-  }
-
-  /* chop references into bins. */
-  for (unsigned int refIdx = range.start(); refIdx < range.end(); refIdx++) {
-    const BVHReference &ref = references_->at(refIdx);
-    const BoundBox prim_bounds = get_prim_bounds(ref);
-    const float3 firstBinf = (prim_bounds.min - origin) * invBinSize;
-    const float3 lastBinf = (prim_bounds.max - origin) * invBinSize;
-    int3 firstBin = make_int3((int)firstBinf.x, (int)firstBinf.y, (int)firstBinf.z);
-    int3 lastBin = make_int3((int)lastBinf.x, (int)lastBinf.y, (int)lastBinf.z);
-
-    firstBin = clamp(firstBin, 0, BVHParams::NUM_SPATIAL_BINS - 1);
-    lastBin = clamp(lastBin, firstBin, BVHParams::NUM_SPATIAL_BINS - 1);
-
-    for (int dim = 0; dim < 3; dim++) {
-      BVHReference currRef(
-          get_prim_bounds(ref), ref.prim_index(), ref.prim_object(), ref.prim_type());
-
-      for (int i = firstBin[dim]; i < lastBin[dim]; i++) {
-        BVHReference leftRef;
-        BVHReference rightRef;
-
-        split_reference(
-            builder, leftRef, rightRef, currRef, dim, origin[dim] + binSize[dim] * (float)(i + 1));
-        storage_->bins[dim][i].bounds.grow(leftRef.bounds());
-        currRef = rightRef;
+  /* Chop references from the given sub-range into the given bin table. */
+  auto bin_references = [&](const int first_ref, const int last_ref, BVHSpatialBinTable &table) {
+    for (int refIdx = first_ref; refIdx < last_ref; refIdx++) {
+      const BVHReference &ref = references_->at(refIdx);
+      const BoundBox prim_bounds = get_prim_bounds(ref);
+      const float3 firstBinf = (prim_bounds.min - origin) * invBinSize;
+      const float3 lastBinf = (prim_bounds.max - origin) * invBinSize;
+      int3 firstBin = make_int3((int)firstBinf.x, (int)firstBinf.y, (int)firstBinf.z);
+      int3 lastBin = make_int3((int)lastBinf.x, (int)lastBinf.y, (int)lastBinf.z);
+
+      firstBin = clamp(firstBin, 0, BVHParams::NUM_SPATIAL_BINS - 1);
+      lastBin = clamp(lastBin, firstBin, BVHParams::NUM_SPATIAL_BINS - 1);
+
+      for (int dim = 0; dim < 3; dim++) {
+        BVHReference currRef(
+            get_prim_bounds(ref), ref.prim_index(), ref.prim_object(), ref.prim_type());
+
+        for (int i = firstBin[dim]; i < lastBin[dim]; i++) {
+          BVHReference leftRef;
+          BVHReference rightRef;
+
+          split_reference(builder,
+                          leftRef,
+                          rightRef,
+                          currRef,
+                          dim,
+                          origin[dim] + binSize[dim] * (float)(i + 1));
+          table.bins[dim][i].bounds.grow(leftRef.bounds());
+          currRef = rightRef;
+        }
+
+        table.bins[dim][lastBin[dim]].bounds.grow(currRef.bounds());
+        table.bins[dim][firstBin[dim]].enter++;
+        table.bins[dim][lastBin[dim]].exit++;
       }
-
-      storage_->bins[dim][lastBin[dim]].bounds.grow(currRef.bounds());
-      storage_->bins[dim][firstBin[dim]].enter++;
-      storage_->bins[dim][lastBin[dim]].exit++;
     }
+  };
+
+  storage_->bins.clear();
+
+  /* Bin with a table per thread for large ranges, so the top levels of the
+   * tree where a single range covers most of the references scale across
+   * cores the same way the object-split binning does. */
+  static const int PARALLEL_BIN_MIN_SIZE = 4096;
+  if (range.size() >= PARALLEL_BIN_MIN_SIZE) {
+    enumerable_thread_specific<BVHSpatialBinTable> local_tables(
+        []() -> BVHSpatialBinTable {
+          BVHSpatialBinTable table;
+          table.clear();
+          return table;
+        });
+    parallel_for(blocked_range<int>(range.start(), range.end(), PARALLEL_BIN_MIN_SIZE / 4),
+                 [&](const blocked_range<int> &r) {
+                   bin_references(r.begin(), r.end(), local_tables.local());
+                 });
+    for (const BVHSpatialBinTable &table : local_tables) {
+      storage_->bins.merge(table);
+    }
+  }
+  else {
+    bin_references(range.start(), range.end(), storage_->bins);
   }
 
   /* select best split plane. */
@@ -203,7 +225,7 @@ BVHSpatialSplit::BVHSpatialSplit(const BVHBuild &builder,
     /* sweep right to left and determine bounds. */
     BoundBox right_bounds = BoundBox::empty;
     for (int i = BVHParams::NUM_SPATIAL_BINS - 1; i > 0; i--) {
-      right_bounds.grow(storage_->bins[dim][i].bounds);
+      right_bounds.grow(storage_->bins.bins[dim][i].bounds);
       storage_->right_bounds[i - 1] = right_bounds;
     }
 
@@ -213,9 +235,9 @@ BVHSpatialSplit::BVHSpatialSplit(const BVHBuild &builder,
     int rightNum = range.size();
 
     for (int i = 1; i < BVHParams::NUM_SPATIAL_BINS; i++) {
-      left_bounds.grow(storage_->bins[dim][i - 1].bounds);
-      leftNum += storage_->bins[dim][i - 1].enter;
-      rightNum -= storage_->bins[dim][i - 1].exit;
+      left_bounds.grow(storage_->bins.bins[dim][i - 1].bounds);
+      leftNum += storage_->bins.bins[dim][i - 1].enter;
+      rightNum -= storage_->bins.bins[dim][i - 1].exit;
 
       const float sah = nodeSAH +
                         left_bounds.safe_area() * builder.params.primitive_cost(leftNum) +
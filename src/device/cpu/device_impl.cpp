@@ -7,6 +7,12 @@
 #include <cstdlib>
 #include <cstring>
 
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
 /* So ImathMath is included before our kernel_cpu_compat. */
 #ifdef WITH_OSL
 /* So no context pollution happens from indirectly included windows.h */
@@ -40,6 +46,7 @@
 #include "util/log.h"
 #include "util/progress.h"
 #include "util/task.h"
+#include "util/tbb.h"
 
 namespace ccl {
 
@@ -59,6 +66,75 @@ CPUDevice::CPUDevice(const DeviceInfo &info_, Stats &stats_, Profiler &profiler_
   embree_device = rtcNewDevice("verbose=0");
 #endif
   need_texture_info = false;
+
+#ifndef _WIN32
+  streaming_dir_ = getenv("CYCLES_STREAMING_DIR");
+  if (streaming_dir_ != nullptr) {
+    VLOG_INFO << "Streaming large host arrays through memory-mapped files in " << streaming_dir_;
+  }
+#endif
+}
+
+#ifndef _WIN32
+/* Arrays below this size stay resident, streaming them buys nothing and the file and page
+ * table overhead would dominate. */
+static const size_t STREAMING_MIN_SIZE = 8 * 1024 * 1024;
+#endif
+
+void *CPUDevice::host_alloc(const MemoryType type, const size_t size)
+{
+#ifndef _WIN32
+  /* Only stream data the render reads but does not write per sample: render buffers and
+   * working memory must stay anonymous, writing those back through a file would thrash. */
+  if (streaming_dir_ != nullptr && size >= STREAMING_MIN_SIZE &&
+      (type == MEM_READ_ONLY || type == MEM_GLOBAL))
+  {
+    string filepath = string(streaming_dir_) + "/cycles-stream-XXXXXX";
+    const int fd = mkstemp(filepath.data());
+    if (fd != -1) {
+      /* Unlink immediately, the mapping keeps the file alive and it is cleaned up even if the
+       * process dies. */
+      unlink(filepath.c_str());
+
+      void *mem = nullptr;
+      if (ftruncate(fd, size) == 0) {
+        mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      }
+      close(fd);
+
+      if (mem != nullptr && mem != MAP_FAILED) {
+        /* BVH-ordered traversal touches these arrays with high locality but no sequential
+         * pattern, so disable readahead and keep the pages out of core dumps. */
+        madvise(mem, size, MADV_RANDOM);
+        madvise(mem, size, MADV_DONTDUMP);
+
+        const thread_scoped_lock lock(streamed_allocations_mutex_);
+        streamed_allocations_.insert(mem);
+        return mem;
+      }
+
+      LOG(WARNING) << "Failed to create streaming backing file in " << streaming_dir_
+                   << ", falling back to anonymous memory.";
+    }
+  }
+#endif
+
+  return Device::host_alloc(type, size);
+}
+
+void CPUDevice::host_free(const MemoryType type, void *host_pointer, const size_t size)
+{
+#ifndef _WIN32
+  {
+    const thread_scoped_lock lock(streamed_allocations_mutex_);
+    if (streamed_allocations_.erase(host_pointer)) {
+      munmap(host_pointer, size);
+      return;
+    }
+  }
+#endif
+
+  Device::host_free(type, host_pointer, size);
 }
 
 CPUDevice::~CPUDevice()
@@ -157,8 +233,27 @@ void CPUDevice::mem_zero(device_memory &mem)
     mem_alloc(mem);
   }
 
-  if (mem.device_pointer) {
-    memset((void *)mem.device_pointer, 0, mem.memory_size());
+  if (!mem.device_pointer) {
+    return;
+  }
+
+  /* Zero large buffers like render buffers in parallel. Besides being faster, this faults the
+   * pages in from the worker threads that will later render into the buffer, so that first-touch
+   * NUMA placement spreads the pages across the nodes instead of leaving them all on the node
+   * that happened to call mem_zero. */
+  const size_t size = mem.memory_size();
+  char *data = (char *)mem.device_pointer;
+
+  const size_t chunk_size = 1024 * 1024;
+  if (size >= chunk_size * 2) {
+    const size_t num_chunks = divide_up(size, chunk_size);
+    parallel_for(size_t(0), num_chunks, [&](const size_t chunk) {
+      const size_t offset = chunk * chunk_size;
+      memset(data + offset, 0, min(chunk_size, size - offset));
+    });
+  }
+  else {
+    memset(data, 0, size);
   }
 }
 
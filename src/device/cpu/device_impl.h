@@ -33,6 +33,8 @@
 // clang-format on
 
 #include "util/guiding.h"  // IWYU pragma: keep
+#include "util/set.h"
+#include "util/thread.h"
 #include "util/unique_ptr.h"
 
 namespace ccl {
@@ -64,6 +66,9 @@ class CPUDevice : public Device {
    * re-initialization might be needed). */
   bool load_texture_info();
 
+  void *host_alloc(const MemoryType type, const size_t size) override;
+  void host_free(const MemoryType type, void *host_pointer, const size_t size) override;
+
   void mem_alloc(device_memory &mem) override;
   void mem_copy_to(device_memory &mem) override;
   void mem_move_to_host(device_memory &mem) override;
@@ -91,6 +96,16 @@ class CPUDevice : public Device {
 
  protected:
   bool load_kernels(uint /*kernel_features*/) override;
+
+  /* Streaming geometry mode: when CYCLES_STREAMING_DIR points to a directory, large read-only
+   * host arrays are backed by memory-mapped temporary files there, so the OS can write cold
+   * pages back and evict them instead of growing the RSS with the scene. Giant scenes then
+   * render within whatever resident budget the OS enforces, paging data back in on demand. */
+  const char *streaming_dir_ = nullptr;
+
+  /* Streamed allocations, to tell them apart from regular ones on free. */
+  unordered_set<void *> streamed_allocations_;
+  thread_mutex streamed_allocations_mutex_;
 };
 
 }
@@ -8,7 +8,9 @@
 
 namespace ccl {
 
-#define KERNEL_FUNCTIONS(name) KERNEL_NAME_EVAL(cpu, name), KERNEL_NAME_EVAL(cpu_avx2, name)
+#define KERNEL_FUNCTIONS(name) \
+  KERNEL_NAME_EVAL(cpu, name), KERNEL_NAME_EVAL(cpu_avx2, name), \
+      KERNEL_NAME_EVAL(cpu_avx512, name)
 
 #define REGISTER_KERNEL(name) name(KERNEL_FUNCTIONS(name))
 #define REGISTER_KERNEL_FILM_CONVERT(name) \
@@ -20,14 +22,16 @@ CPUKernels::CPUKernels()
       REGISTER_KERNEL(integrator_init_from_camera),
       REGISTER_KERNEL(integrator_init_from_bake),
       REGISTER_KERNEL(integrator_megakernel),
+      REGISTER_KERNEL(integrator_megakernel_step),
+      REGISTER_KERNEL(integrator_intersect_shadow_batch),
+      REGISTER_KERNEL(integrator_init_from_camera_batch),
       /* Shader evaluation. */
       REGISTER_KERNEL(shader_eval_displace),
       REGISTER_KERNEL(shader_eval_background),
       REGISTER_KERNEL(shader_eval_curve_shadow_transparency),
       /* Adaptive sampling. */
       REGISTER_KERNEL(adaptive_sampling_convergence_check),
-      REGISTER_KERNEL(adaptive_sampling_filter_x),
-      REGISTER_KERNEL(adaptive_sampling_filter_y),
+      REGISTER_KERNEL(adaptive_sampling_filter),
       /* Cryptomatte. */
       REGISTER_KERNEL(cryptomatte_postprocess),
       /* Film Convert. */
@@ -27,10 +27,28 @@ class CPUKernels {
                                                             IntegratorStateCPU *state,
                                                             KernelWorkTile *tile,
                                                             ccl_global float *render_buffer)>;
+  using IntegratorStepFunction = CPUKernelFunction<uint32_t (*)(const ThreadKernelGlobalsCPU *kg,
+                                                                IntegratorStateCPU *state,
+                                                                ccl_global float *render_buffer)>;
+  using IntegratorBatchFunction =
+      CPUKernelFunction<void (*)(const ThreadKernelGlobalsCPU *kg,
+                                 IntegratorStateCPU *const *states,
+                                 uint32_t *queued_kernels,
+                                 const int num_states)>;
+  using IntegratorInitBatchFunction =
+      CPUKernelFunction<void (*)(const ThreadKernelGlobalsCPU *kg,
+                                 IntegratorStateCPU *const *states,
+                                 const KernelWorkTile *tiles,
+                                 ccl_global float *render_buffer,
+                                 uint32_t *queued_kernels,
+                                 const int num_states)>;
 
   IntegratorInitFunction integrator_init_from_camera;
   IntegratorInitFunction integrator_init_from_bake;
   IntegratorShadeFunction integrator_megakernel;
+  IntegratorStepFunction integrator_megakernel_step;
+  IntegratorBatchFunction integrator_intersect_shadow_batch;
+  IntegratorInitBatchFunction integrator_init_from_camera_batch;
 
   /* Shader evaluation. */
 
@@ -53,28 +71,21 @@ class CPUKernels {
                                  const int offset,
                                  int stride)>;
 
-  using AdaptiveSamplingFilterXFunction =
+  using AdaptiveSamplingFilterFunction =
       CPUKernelFunction<void (*)(const ThreadKernelGlobalsCPU *kg,
                                  ccl_global float *render_buffer,
+                                 const int x,
                                  const int y,
                                  const int start_x,
-                                 const int width,
-                                 const int offset,
-                                 int stride)>;
-
-  using AdaptiveSamplingFilterYFunction =
-      CPUKernelFunction<void (*)(const ThreadKernelGlobalsCPU *kg,
-                                 ccl_global float *render_buffer,
-                                 const int x,
                                  const int start_y,
+                                 const int width,
                                  const int height,
                                  const int offset,
                                  int stride)>;
 
   AdaptiveSamplingConvergenceCheckFunction adaptive_sampling_convergence_check;
 
-  AdaptiveSamplingFilterXFunction adaptive_sampling_filter_x;
-  AdaptiveSamplingFilterYFunction adaptive_sampling_filter_y;
+  AdaptiveSamplingFilterFunction adaptive_sampling_filter;
 
   /* Cryptomatte. */
 
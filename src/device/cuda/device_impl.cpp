@@ -13,7 +13,7 @@
 
 #  include "util/debug.h"
 #  include "util/log.h"
-#  include "util/md5.h"
+#  include "util/fasthash.h"
 #  include "util/path.h"
 #  include "util/string.h"
 #  include "util/system.h"
@@ -209,7 +209,7 @@ bool CUDADevice::use_adaptive_compilation()
 }
 
 /* Common NVCC flags which stays the same regardless of shading model,
- * kernel sources md5 and only depends on compiler or compilation settings.
+ * kernel sources hash and only depends on compiler or compilation settings.
  */
 string CUDADevice::compile_kernel_get_common_cflags(const uint kernel_features)
 {
@@ -226,6 +226,9 @@ string CUDADevice::compile_kernel_get_common_cflags(const uint kernel_features)
       include_path.c_str());
   if (use_adaptive_compilation()) {
     cflags += " -D__KERNEL_FEATURES__=" + to_string(kernel_features);
+    if (kernel_closure_set != ~0U) {
+      cflags += " -D__KERNEL_CLOSURE_SET__=" + to_string(kernel_closure_set);
+    }
   }
   const char *extra_cflags = getenv("CYCLES_CUDA_EXTRA_CFLAGS");
   if (extra_cflags) {
@@ -243,6 +246,44 @@ string CUDADevice::compile_kernel_get_common_cflags(const uint kernel_features)
   return cflags;
 }
 
+string CUDADevice::precompiled_kernel(const char *name, bool force_ptx)
+{
+  int major, minor;
+  cuDeviceGetAttribute(&major, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR, cuDevId);
+  cuDeviceGetAttribute(&minor, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR, cuDevId);
+
+  if (!force_ptx) {
+    const string cubin = path_get(string_printf("lib/%s_sm_%d%d.cubin.zst", name, major, minor));
+    VLOG_INFO << "Testing for pre-compiled kernel " << cubin << ".";
+    if (path_exists(cubin)) {
+      VLOG_INFO << "Using precompiled kernel.";
+      return cubin;
+    }
+  }
+
+  /* The driver can JIT-compile PTX generated for older generations, so find the closest one. */
+  int ptx_major = major, ptx_minor = minor;
+  while (ptx_major >= 3) {
+    const string ptx = path_get(
+        string_printf("lib/%s_compute_%d%d.ptx.zst", name, ptx_major, ptx_minor));
+    VLOG_INFO << "Testing for pre-compiled kernel " << ptx << ".";
+    if (path_exists(ptx)) {
+      VLOG_INFO << "Using precompiled kernel.";
+      return ptx;
+    }
+
+    if (ptx_minor > 0) {
+      ptx_minor--;
+    }
+    else {
+      ptx_major--;
+      ptx_minor = 9;
+    }
+  }
+
+  return string();
+}
+
 string CUDADevice::compile_kernel(const string &common_cflags,
                                   const char *name,
                                   const char *base,
@@ -255,52 +296,28 @@ string CUDADevice::compile_kernel(const string &common_cflags,
 
   /* Attempt to use kernel provided with Blender. */
   if (!use_adaptive_compilation()) {
-    if (!force_ptx) {
-      const string cubin = path_get(string_printf("lib/%s_sm_%d%d.cubin.zst", name, major, minor));
-      VLOG_INFO << "Testing for pre-compiled kernel " << cubin << ".";
-      if (path_exists(cubin)) {
-        VLOG_INFO << "Using precompiled kernel.";
-        return cubin;
-      }
-    }
-
-    /* The driver can JIT-compile PTX generated for older generations, so find the closest one. */
-    int ptx_major = major, ptx_minor = minor;
-    while (ptx_major >= 3) {
-      const string ptx = path_get(
-          string_printf("lib/%s_compute_%d%d.ptx.zst", name, ptx_major, ptx_minor));
-      VLOG_INFO << "Testing for pre-compiled kernel " << ptx << ".";
-      if (path_exists(ptx)) {
-        VLOG_INFO << "Using precompiled kernel.";
-        return ptx;
-      }
-
-      if (ptx_minor > 0) {
-        ptx_minor--;
-      }
-      else {
-        ptx_major--;
-        ptx_minor = 9;
-      }
+    const string precompiled = precompiled_kernel(name, force_ptx);
+    if (!precompiled.empty()) {
+      return precompiled;
     }
   }
 
   /* Try to use locally compiled kernel. */
   string source_path = path_get("source");
-  const string source_md5 = path_files_md5_hash(source_path);
+  const string source_hash = path_files_content_hash(source_path);
 
-  /* We include cflags into md5 so changing cuda toolkit or changing other
+  /* We include cflags into the hash so changing cuda toolkit or changing other
    * compiler command line arguments makes sure cubin gets re-built.
    */
-  const string kernel_md5 = util_md5_string(source_md5 + common_cflags);
+  const string kernel_hash = util_fast_hash_string(source_hash + common_cflags);
 
   const char *const kernel_ext = force_ptx ? "ptx" : "cubin";
   const char *const kernel_arch = force_ptx ? "compute" : "sm";
   const string cubin_file = string_printf(
-      "cycles_%s_%s_%d%d_%s.%s", name, kernel_arch, major, minor, kernel_md5.c_str(), kernel_ext);
+      "cycles_%s_%s_%d%d_%s.%s", name, kernel_arch, major, minor, kernel_hash.c_str(), kernel_ext);
   const string cubin = path_cache_get(path_join("kernels", cubin_file));
   VLOG_INFO << "Testing for locally compiled kernel " << cubin << ".";
-  if (path_exists(cubin)) {
+  if (path_cache_kernel_exists_and_mark_used(cubin)) {
     VLOG_INFO << "Using locally compiled kernel.";
     return cubin;
   }
@@ -398,6 +415,8 @@ string CUDADevice::compile_kernel(const string &common_cflags,
 
   printf("Kernel compilation finished in %.2lfs.\n", time_dt() - starttime);
 
+  path_cache_kernel_mark_added_and_clear_old(cubin);
+
   return cubin;
 }
 
@@ -428,6 +447,16 @@ bool CUDADevice::load_kernels(const uint kernel_features)
 
   /* get kernel */
   const char *kernel_name = "kernel";
+
+  /* Prefer the precompiled lite kernel when the scene uses none of the features
+   * it was built without. Adaptive compilation already specializes further. */
+  if (!use_adaptive_compilation() && (kernel_features & KERNEL_FEATURES_LITE_EXCLUDED) == 0 &&
+      !precompiled_kernel("kernel_lite", false).empty())
+  {
+    VLOG_INFO << "Using lite kernel for reduced scene feature set.";
+    kernel_name = "kernel_lite";
+  }
+
   string cflags = compile_kernel_get_common_cflags(kernel_features);
   string cubin = compile_kernel(cflags, kernel_name);
   if (cubin.empty()) {
@@ -527,7 +556,38 @@ bool CUDADevice::alloc_device(void *&device_pointer, const size_t size)
   CUDAContextScope scope(this);
 
   CUresult mem_alloc_result = cuMemAlloc((CUdeviceptr *)&device_pointer, size);
-  return mem_alloc_result == CUDA_SUCCESS;
+  if (mem_alloc_result == CUDA_SUCCESS) {
+    return true;
+  }
+
+  /* Out-of-core fallback: when device memory is exhausted, allocate managed memory instead so
+   * that oversized scenes render slowly rather than fail. Unlike the host-mapped fallback this
+   * also covers MEM_DEVICE_ONLY allocations like the BVH and path state, and the driver migrates
+   * pages to the device on demand instead of serving every access over the bus. */
+  if (mem_alloc_result == CUDA_ERROR_OUT_OF_MEMORY) {
+    int can_use_managed = 0;
+    cuDeviceGetAttribute(&can_use_managed, CU_DEVICE_ATTRIBUTE_MANAGED_MEMORY, cuDevice);
+    if (can_use_managed) {
+      mem_alloc_result = cuMemAllocManaged(
+          (CUdeviceptr *)&device_pointer, size, CU_MEM_ATTACH_GLOBAL);
+      if (mem_alloc_result == CUDA_SUCCESS) {
+        VLOG_WORK << "Device memory exhausted, falling back to managed allocation of "
+                  << string_human_readable_size(size) << ".";
+        /* Prefer to keep the pages on the device; the driver will evict them under memory
+         * pressure and this device will be the one accessing them the most. */
+        cuMemAdvise(
+            (CUdeviceptr)device_pointer, size, CU_MEM_ADVISE_SET_PREFERRED_LOCATION, cuDevice);
+        cuMemAdvise((CUdeviceptr)device_pointer, size, CU_MEM_ADVISE_SET_ACCESSED_BY, cuDevice);
+        /* Populate as many pages as fit on the device up front. The BVH and path state arrays
+         * are touched by thousands of threads on the first launch, and demand-paging them in
+         * one fault at a time is much slower than a bulk prefetch. */
+        cuMemPrefetchAsync((CUdeviceptr)device_pointer, size, cuDevice, nullptr);
+        return true;
+      }
+    }
+  }
+
+  return false;
 }
 
 void CUDADevice::free_device(void *device_pointer)
@@ -53,6 +53,10 @@ class CUDADevice : public GPUDevice {
 
   string compile_kernel_get_common_cflags(const uint kernel_features);
 
+  /* Returns the path of the precompiled kernel binary for this device, or an
+   * empty string when none was shipped. */
+  string precompiled_kernel(const char *name, bool force_ptx = false);
+
   string compile_kernel(const string &cflags,
                         const char *name,
                         const char *base = "cuda",
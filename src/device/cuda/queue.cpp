@@ -15,15 +15,33 @@ namespace ccl {
 /* CUDADeviceQueue */
 
 CUDADeviceQueue::CUDADeviceQueue(CUDADevice *device)
-    : DeviceQueue(device), cuda_device_(device), cuda_stream_(nullptr)
+    : DeviceQueue(device),
+      cuda_device_(device),
+      cuda_stream_(nullptr),
+      cuda_transfer_stream_(nullptr),
+      cuda_transfer_event_(nullptr)
 {
   const CUDAContextScope scope(cuda_device_);
   cuda_device_assert(cuda_device_, cuStreamCreate(&cuda_stream_, CU_STREAM_NON_BLOCKING));
+  cuda_device_assert(cuda_device_,
+                     cuStreamCreate(&cuda_transfer_stream_, CU_STREAM_NON_BLOCKING));
+  cuda_device_assert(cuda_device_,
+                     cuEventCreate(&cuda_transfer_event_, CU_EVENT_DISABLE_TIMING));
 }
 
 CUDADeviceQueue::~CUDADeviceQueue()
 {
   const CUDAContextScope scope(cuda_device_);
+  for (const KernelTimingInterval &interval : timing_intervals_) {
+    cuEventDestroy(interval.begin);
+    cuEventDestroy(interval.end);
+  }
+  for (const pair<CUevent, CUevent> &events : timing_event_pool_) {
+    cuEventDestroy(events.first);
+    cuEventDestroy(events.second);
+  }
+  cuEventDestroy(cuda_transfer_event_);
+  cuStreamDestroy(cuda_transfer_stream_);
   cuStreamDestroy(cuda_stream_);
 }
 
@@ -33,6 +51,28 @@ int CUDADeviceQueue::num_concurrent_states(const size_t state_size) const
                               cuda_device_->get_max_num_threads_per_multiprocessor();
   int num_states = max(max_num_threads, 65536) * 16;
 
+  /* Scale the state count to the memory actually available on the card. Cards with lots of free
+   * memory can keep more paths in flight to hide latency, while on small cards the default
+   * sizing would push the state into the host-mapped fallback, which is far more costly than
+   * rendering with fewer concurrent paths. */
+  size_t total_mem = 0;
+  size_t free_mem = 0;
+  cuda_device_->get_device_memory_info(total_mem, free_mem);
+  if (total_mem != 0) {
+    const size_t min_headroom = max(total_mem / 8, size_t(1024 * 1024 * 1024));
+    size_t state_mem = (size_t)num_states * state_size;
+    if (free_mem >= state_mem * 2 + min_headroom) {
+      num_states *= 2;
+      VLOG_DEVICE_STATS << "Doubling GPU queue concurrent states to exploit available memory";
+    }
+    else {
+      while (num_states > 65536 && free_mem < state_mem + min_headroom) {
+        num_states /= 2;
+        state_mem /= 2;
+      }
+    }
+  }
+
   const char *factor_str = getenv("CYCLES_CONCURRENT_STATES_FACTOR");
   if (factor_str) {
     const float factor = (float)atof(factor_str);
@@ -117,6 +157,7 @@ bool CUDADeviceQueue::enqueue(DeviceKernel kernel,
   }
 
   /* Launch kernel. */
+  kernel_timing_begin(kernel);
   assert_success(cuLaunchKernel(cuda_kernel.function,
                                 num_blocks,
                                 1,
@@ -129,12 +170,60 @@ bool CUDADeviceQueue::enqueue(DeviceKernel kernel,
                                 const_cast<void **>(args.values),
                                 nullptr),
                  "enqueue");
+  kernel_timing_end();
 
   debug_enqueue_end();
 
   return !(cuda_device_->have_error());
 }
 
+void CUDADeviceQueue::kernel_timing_begin(DeviceKernel kernel)
+{
+  if (!kernel_timing_enabled_) {
+    return;
+  }
+
+  KernelTimingInterval interval;
+  interval.kernel = kernel;
+
+  if (timing_event_pool_.empty()) {
+    cuda_device_assert(cuda_device_, cuEventCreate(&interval.begin, CU_EVENT_DEFAULT));
+    cuda_device_assert(cuda_device_, cuEventCreate(&interval.end, CU_EVENT_DEFAULT));
+  }
+  else {
+    interval.begin = timing_event_pool_.back().first;
+    interval.end = timing_event_pool_.back().second;
+    timing_event_pool_.pop_back();
+  }
+
+  cuda_device_assert(cuda_device_, cuEventRecord(interval.begin, cuda_stream_));
+
+  timing_intervals_.push_back(interval);
+}
+
+void CUDADeviceQueue::kernel_timing_end()
+{
+  if (!kernel_timing_enabled_ || timing_intervals_.empty()) {
+    return;
+  }
+
+  cuda_device_assert(cuda_device_, cuEventRecord(timing_intervals_.back().end, cuda_stream_));
+}
+
+void CUDADeviceQueue::kernel_timing_resolve()
+{
+  for (const KernelTimingInterval &interval : timing_intervals_) {
+    float milliseconds = 0.0f;
+    cuda_device_assert(cuda_device_,
+                       cuEventElapsedTime(&milliseconds, interval.begin, interval.end));
+    kernel_timing_add(interval.kernel, milliseconds / 1000.0);
+
+    timing_event_pool_.emplace_back(interval.begin, interval.end);
+  }
+
+  timing_intervals_.clear();
+}
+
 bool CUDADeviceQueue::synchronize()
 {
   if (cuda_device_->have_error()) {
@@ -144,6 +233,9 @@ bool CUDADeviceQueue::synchronize()
   const CUDAContextScope scope(cuda_device_);
   assert_success(cuStreamSynchronize(cuda_stream_), "synchronize");
 
+  /* Events recorded around the enqueued kernels are known to be complete now. */
+  kernel_timing_resolve();
+
   debug_synchronize();
 
   return !(cuda_device_->have_error());
@@ -214,6 +306,44 @@ void CUDADeviceQueue::copy_from_device(device_memory &mem)
       "copy_from_device");
 }
 
+void CUDADeviceQueue::copy_from_device_async(device_memory &mem)
+{
+  assert(mem.type != MEM_GLOBAL && mem.type != MEM_TEXTURE);
+
+  if (mem.memory_size() == 0) {
+    return;
+  }
+
+  assert(mem.device_pointer != 0);
+  assert(mem.host_pointer != nullptr);
+
+  const CUDAContextScope scope(cuda_device_);
+
+  /* Order the transfer after all work enqueued on the compute stream so far, without blocking
+   * kernels enqueued afterwards. */
+  assert_success(cuEventRecord(cuda_transfer_event_, cuda_stream_), "copy_from_device_async");
+  assert_success(cuStreamWaitEvent(cuda_transfer_stream_, cuda_transfer_event_, 0),
+                 "copy_from_device_async");
+
+  assert_success(cuMemcpyDtoHAsync(mem.host_pointer,
+                                   (CUdeviceptr)mem.device_pointer,
+                                   mem.memory_size(),
+                                   cuda_transfer_stream_),
+                 "copy_from_device_async");
+}
+
+bool CUDADeviceQueue::synchronize_transfer()
+{
+  if (cuda_device_->have_error()) {
+    return false;
+  }
+
+  const CUDAContextScope scope(cuda_device_);
+  assert_success(cuStreamSynchronize(cuda_transfer_stream_), "synchronize_transfer");
+
+  return !(cuda_device_->have_error());
+}
+
 void CUDADeviceQueue::assert_success(CUresult result, const char *operation)
 {
   if (result != CUDA_SUCCESS) {
@@ -11,6 +11,8 @@
 
 #  include "device/cuda/util.h"
 
+#  include "util/vector.h"
+
 namespace ccl {
 
 class CUDADevice;
@@ -33,10 +35,18 @@ class CUDADeviceQueue : public DeviceQueue {
 
   bool synchronize() override;
 
+  bool supports_kernel_timing() const override
+  {
+    return true;
+  }
+
   void zero_to_device(device_memory &mem) override;
   void copy_to_device(device_memory &mem) override;
   void copy_from_device(device_memory &mem) override;
 
+  void copy_from_device_async(device_memory &mem) override;
+  bool synchronize_transfer() override;
+
   virtual CUstream stream()
   {
     return cuda_stream_;
@@ -47,6 +57,22 @@ class CUDADeviceQueue : public DeviceQueue {
  protected:
   CUDADevice *cuda_device_;
   CUstream cuda_stream_;
+  CUstream cuda_transfer_stream_;
+  CUevent cuda_transfer_event_;
+
+  /* Record timestamp events around a kernel launch, when per-kernel timing is enabled.
+   * The events are resolved and recycled on synchronize(). */
+  void kernel_timing_begin(DeviceKernel kernel);
+  void kernel_timing_end();
+  void kernel_timing_resolve();
+
+  struct KernelTimingInterval {
+    DeviceKernel kernel;
+    CUevent begin;
+    CUevent end;
+  };
+  vector<KernelTimingInterval> timing_intervals_;
+  vector<pair<CUevent, CUevent>> timing_event_pool_;
 
   void assert_success(CUresult result, const char *operation);
 };
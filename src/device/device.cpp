@@ -227,33 +227,88 @@ vector<DeviceInfo> Device::available_devices(const uint mask)
    * be broken and cause crashes when only trying to get device info, so
    * we don't want to do any initialization until the user chooses to. */
   const thread_scoped_lock lock(device_mutex);
-  vector<DeviceInfo> devices;
+
+  /* Probe backends that have not been initialized yet in parallel, driver
+   * initialization can take hundreds of milliseconds per backend. OptiX is
+   * probed after the pool since it derives from the CUDA device list. */
+  TaskPool probe_pool;
 
 #if defined(WITH_CUDA) || defined(WITH_OPTIX)
   if (mask & (DEVICE_MASK_CUDA | DEVICE_MASK_OPTIX)) {
     if (!(devices_initialized_mask & DEVICE_MASK_CUDA)) {
-      if (device_cuda_init()) {
-        device_cuda_info(cuda_devices);
-      }
+      probe_pool.push([] {
+        if (device_cuda_init()) {
+          device_cuda_info(cuda_devices);
+        }
+      });
       devices_initialized_mask |= DEVICE_MASK_CUDA;
     }
-    if (mask & DEVICE_MASK_CUDA) {
-      for (DeviceInfo &info : cuda_devices) {
-        devices.push_back(info);
+  }
+#endif
+
+#ifdef WITH_HIP
+  if ((mask & DEVICE_MASK_HIP) && !(devices_initialized_mask & DEVICE_MASK_HIP)) {
+    probe_pool.push([] {
+      if (device_hip_init()) {
+        device_hip_info(hip_devices);
       }
+    });
+    devices_initialized_mask |= DEVICE_MASK_HIP;
+  }
+#endif
+
+#ifdef WITH_ONEAPI
+  if ((mask & DEVICE_MASK_ONEAPI) && !(devices_initialized_mask & DEVICE_MASK_ONEAPI)) {
+    probe_pool.push([] {
+      if (device_oneapi_init()) {
+        device_oneapi_info(oneapi_devices);
+      }
+    });
+    devices_initialized_mask |= DEVICE_MASK_ONEAPI;
+  }
+#endif
+
+#ifdef WITH_METAL
+  if ((mask & DEVICE_MASK_METAL) && !(devices_initialized_mask & DEVICE_MASK_METAL)) {
+    probe_pool.push([] {
+      if (device_metal_init()) {
+        device_metal_info(metal_devices);
+      }
+    });
+    devices_initialized_mask |= DEVICE_MASK_METAL;
+  }
+#endif
+
+  if ((mask & DEVICE_MASK_CPU) && !(devices_initialized_mask & DEVICE_MASK_CPU)) {
+    probe_pool.push([] { device_cpu_info(cpu_devices); });
+    devices_initialized_mask |= DEVICE_MASK_CPU;
+  }
+
+  probe_pool.wait_work();
+
+#ifdef WITH_OPTIX
+  if ((mask & DEVICE_MASK_OPTIX) && !(devices_initialized_mask & DEVICE_MASK_OPTIX)) {
+    if (device_optix_init()) {
+      device_optix_info(cuda_devices, optix_devices);
+    }
+    devices_initialized_mask |= DEVICE_MASK_OPTIX;
+  }
+#endif
+
+  /* Collect the requested devices. */
+  vector<DeviceInfo> devices;
+
+#if defined(WITH_CUDA) || defined(WITH_OPTIX)
+  if (mask & DEVICE_MASK_CUDA) {
+    for (const DeviceInfo &info : cuda_devices) {
+      devices.push_back(info);
     }
   }
 #endif
 
 #ifdef WITH_OPTIX
   if (mask & DEVICE_MASK_OPTIX) {
-    if (!(devices_initialized_mask & DEVICE_MASK_OPTIX)) {
-      if (device_optix_init()) {
-        device_optix_info(cuda_devices, optix_devices);
-      }
-      devices_initialized_mask |= DEVICE_MASK_OPTIX;
-    }
-    for (DeviceInfo &info : optix_devices) {
+    for (const DeviceInfo &info : optix_devices) {
       devices.push_back(info);
     }
   }
@@ -261,13 +316,7 @@ vector<DeviceInfo> Device::available_devices(const uint mask)
 
 #ifdef WITH_HIP
   if (mask & DEVICE_MASK_HIP) {
-    if (!(devices_initialized_mask & DEVICE_MASK_HIP)) {
-      if (device_hip_init()) {
-        device_hip_info(hip_devices);
-      }
-      devices_initialized_mask |= DEVICE_MASK_HIP;
-    }
-    for (DeviceInfo &info : hip_devices) {
+    for (const DeviceInfo &info : hip_devices) {
       devices.push_back(info);
     }
   }
@@ -275,23 +324,13 @@ vector<DeviceInfo> Device::available_devices(const uint mask)
 
 #ifdef WITH_ONEAPI
   if (mask & DEVICE_MASK_ONEAPI) {
-    if (!(devices_initialized_mask & DEVICE_MASK_ONEAPI)) {
-      if (device_oneapi_init()) {
-        device_oneapi_info(oneapi_devices);
-      }
-      devices_initialized_mask |= DEVICE_MASK_ONEAPI;
-    }
-    for (DeviceInfo &info : oneapi_devices) {
+    for (const DeviceInfo &info : oneapi_devices) {
       devices.push_back(info);
     }
   }
 #endif
 
   if (mask & DEVICE_MASK_CPU) {
-    if (!(devices_initialized_mask & DEVICE_MASK_CPU)) {
-      device_cpu_info(cpu_devices);
-      devices_initialized_mask |= DEVICE_MASK_CPU;
-    }
     for (const DeviceInfo &info : cpu_devices) {
       devices.push_back(info);
     }
@@ -299,12 +338,6 @@ vector<DeviceInfo> Device::available_devices(const uint mask)
 
 #ifdef WITH_METAL
   if (mask & DEVICE_MASK_METAL) {
-    if (!(devices_initialized_mask & DEVICE_MASK_METAL)) {
-      if (device_metal_init()) {
-        device_metal_info(metal_devices);
-      }
-      devices_initialized_mask |= DEVICE_MASK_METAL;
-    }
     for (const DeviceInfo &info : metal_devices) {
       devices.push_back(info);
     }
@@ -512,6 +545,34 @@ void Device::host_free(const MemoryType /*type*/, void *host_pointer, const size
   util_aligned_free(host_pointer, size);
 }
 
+DeviceUploadBatch::~DeviceUploadBatch()
+{
+  wait();
+}
+
+void DeviceUploadBatch::copy_to_device(device_memory &mem)
+{
+  if (mem.host_pointer == nullptr || mem.data_size == 0) {
+    return;
+  }
+
+  upload_pool.push([&mem] { mem.device_copy_to(); });
+}
+
+void DeviceUploadBatch::copy_to_device_if_modified(device_memory &mem)
+{
+  if (!mem.modified) {
+    return;
+  }
+
+  copy_to_device(mem);
+}
+
+void DeviceUploadBatch::wait()
+{
+  upload_pool.wait();
+}
+
 GPUDevice::~GPUDevice() noexcept(false) = default;
 
 bool GPUDevice::load_texture_info()
@@ -642,6 +703,100 @@ void GPUDevice::move_textures_to_host(size_t size, const size_t headroom, const
   }
 }
 
+bool GPUDevice::pool_alloc_device(void *&device_pointer, const size_t size)
+{
+  const size_t block_size = align_up(size, MEMORY_POOL_ALIGNMENT);
+
+  const thread_scoped_lock lock(memory_pool_mutex);
+
+  /* Best fit search over the free lists of all slabs. */
+  MemoryPoolSlab *best_slab = nullptr;
+  size_t best_offset = 0;
+  size_t best_size = 0;
+  for (const unique_ptr<MemoryPoolSlab> &slab : memory_pool_slabs) {
+    for (const std::pair<const size_t, size_t> &block : slab->free_blocks) {
+      if (block.second >= block_size &&
+          (best_slab == nullptr || block.second < best_size)) {
+        best_slab = slab.get();
+        best_offset = block.first;
+        best_size = block.second;
+      }
+    }
+  }
+
+  if (best_slab == nullptr) {
+    /* No room in the existing slabs, carve from a new one. */
+    void *base = nullptr;
+    if (!alloc_device(base, MEMORY_POOL_SLAB_SIZE)) {
+      return false;
+    }
+    memory_pool_slabs.push_back(make_unique<MemoryPoolSlab>());
+    best_slab = memory_pool_slabs.back().get();
+    best_slab->base = base;
+    best_slab->free_blocks[0] = MEMORY_POOL_SLAB_SIZE;
+    best_offset = 0;
+    best_size = MEMORY_POOL_SLAB_SIZE;
+  }
+
+  best_slab->free_blocks.erase(best_offset);
+  if (best_size > block_size) {
+    best_slab->free_blocks[best_offset + block_size] = best_size - block_size;
+  }
+  best_slab->used += block_size;
+
+  device_pointer = (char *)best_slab->base + best_offset;
+  memory_pool_blocks[device_pointer] = std::make_pair(best_slab, block_size);
+
+  return true;
+}
+
+bool GPUDevice::pool_free_device(void *device_pointer)
+{
+  const thread_scoped_lock lock(memory_pool_mutex);
+
+  const auto it = memory_pool_blocks.find(device_pointer);
+  if (it == memory_pool_blocks.end()) {
+    return false;
+  }
+
+  MemoryPoolSlab *slab = it->second.first;
+  const size_t alloc_size = it->second.second;
+  size_t offset = (size_t)((char *)device_pointer - (char *)slab->base);
+  size_t block_size = alloc_size;
+  memory_pool_blocks.erase(it);
+
+  /* Coalesce with free neighbors to keep the slab from fragmenting. */
+  const map<size_t, size_t>::iterator next = slab->free_blocks.lower_bound(offset);
+  if (next != slab->free_blocks.begin()) {
+    const map<size_t, size_t>::iterator prev = std::prev(next);
+    if (prev->first + prev->second == offset) {
+      offset = prev->first;
+      block_size += prev->second;
+      slab->free_blocks.erase(prev);
+    }
+  }
+  if (next != slab->free_blocks.end() && offset + block_size == next->first) {
+    block_size += next->second;
+    slab->free_blocks.erase(next);
+  }
+  slab->free_blocks[offset] = block_size;
+  slab->used -= alloc_size;
+
+  /* Return empty slabs to the driver so long-running sessions do not pin
+   * device memory the scene no longer needs. */
+  if (slab->used == 0) {
+    free_device(slab->base);
+    for (size_t i = 0; i < memory_pool_slabs.size(); i++) {
+      if (memory_pool_slabs[i].get() == slab) {
+        memory_pool_slabs.erase(memory_pool_slabs.begin() + i);
+        break;
+      }
+    }
+  }
+
+  return true;
+}
+
 GPUDevice::Mem *GPUDevice::generic_alloc(device_memory &mem, const size_t pitch_padding)
 {
   void *device_pointer = nullptr;
@@ -674,7 +829,14 @@ GPUDevice::Mem *GPUDevice::generic_alloc(device_memory &mem, const size_t pitch_
 
   /* Allocate in device memory. */
   if ((!mem.move_to_host && (size + headroom) < free) || (mem.type == MEM_DEVICE_ONLY)) {
-    mem_alloc_result = alloc_device(device_pointer, size);
+    /* Small linear allocations come from the pool; images need dedicated
+     * array allocations and bypass it. */
+    if (size <= MEMORY_POOL_MAX_ALLOC && !is_image) {
+      mem_alloc_result = pool_alloc_device(device_pointer, size);
+    }
+    if (!mem_alloc_result) {
+      mem_alloc_result = alloc_device(device_pointer, size);
+    }
     if (mem_alloc_result) {
       device_mem_in_use += size;
       status = " in device memory";
@@ -786,8 +948,10 @@ void GPUDevice::generic_free(device_memory &mem)
     map_host_used -= mem.device_size;
   }
   else {
-    /* Free device memory. */
-    free_device((void *)mem.device_pointer);
+    /* Free device memory, returning pooled blocks to their slab. */
+    if (!pool_free_device((void *)mem.device_pointer)) {
+      free_device((void *)mem.device_pointer);
+    }
     device_mem_in_use -= mem.device_size;
   }
 
@@ -812,6 +976,21 @@ void GPUDevice::generic_copy_to(device_memory &mem)
   }
 }
 
+void GPUDevice::mem_copy_to(device_memory &mem, const size_t offset, const size_t size)
+{
+  /* Partial copies are only possible into an existing plain device allocation,
+   * otherwise do a regular full copy which takes care of (re)allocation. */
+  if (!mem.device_pointer || mem.type == MEM_TEXTURE || !mem.is_resident(this)) {
+    mem_copy_to(mem);
+    return;
+  }
+
+  if (!(mem.is_shared(this) && mem.host_pointer == mem.shared_pointer)) {
+    copy_host_to_device(
+        (void *)(mem.device_pointer + offset), (char *)mem.host_pointer + offset, size);
+  }
+}
+
 bool GPUDevice::is_shared(const void *shared_pointer,
                           const device_ptr device_pointer,
                           Device * /*sub_device*/)
@@ -16,6 +16,7 @@
 #include "util/profiling.h"
 #include "util/stats.h"
 #include "util/string.h"
+#include "util/task.h"
 #include "util/texture.h"
 #include "util/thread.h"
 #include "util/types.h"
@@ -132,6 +133,9 @@ class Device {
 
   string error_msg;
 
+  /* Closure set mask for adaptive kernel compilation, all closures by default. */
+  uint kernel_closure_set = ~0U;
+
   virtual device_ptr mem_alloc_sub_ptr(device_memory & /*mem*/, size_t /*offset*/, size_t /*size*/)
   {
     /* Only required for devices that implement denoising. */
@@ -178,6 +182,14 @@ class Device {
     return true;
   }
 
+  /* Restrict the BSDF closure set compiled into adaptively compiled kernels, a mask of
+   * KERNEL_CLOSURE_SET_* flags. Must be set before load_kernels(). Backends without
+   * adaptive compilation ignore the mask and keep the full closure set. */
+  virtual void set_kernel_closure_set(const uint closure_set)
+  {
+    kernel_closure_set = closure_set;
+  }
+
   virtual bool load_osl_kernels()
   {
     return true;
@@ -308,6 +320,13 @@ class Device {
 
   virtual void mem_alloc(device_memory &mem) = 0;
   virtual void mem_copy_to(device_memory &mem) = 0;
+  /* Copy a sub-range of already allocated memory from host to device. Offset and
+   * size are in bytes. The default implementation falls back to copying the whole
+   * buffer, for devices without partial copy support. */
+  virtual void mem_copy_to(device_memory &mem, const size_t /*offset*/, const size_t /*size*/)
+  {
+    mem_copy_to(mem);
+  }
   virtual void mem_move_to_host(device_memory &mem) = 0;
   virtual void mem_copy_from(
       device_memory &mem, const size_t y, size_t w, const size_t h, size_t elem) = 0;
@@ -327,6 +346,27 @@ class Device {
   static uint devices_initialized_mask;
 };
 
+/* Batches scene buffer uploads onto a dedicated thread, so that packing the
+ * next arrays on the calling thread overlaps with earlier transfers instead of
+ * waiting on one synchronous copy at a time.
+ *
+ * Host data queued here must stay valid and unmodified until wait() returns or
+ * the batch goes out of scope, whichever comes first. */
+class DeviceUploadBatch {
+ public:
+  DeviceUploadBatch() = default;
+  ~DeviceUploadBatch();
+
+  void copy_to_device(device_memory &mem);
+  void copy_to_device_if_modified(device_memory &mem);
+
+  /* Wait until all queued uploads finished. */
+  void wait();
+
+ private:
+  DedicatedTaskPool upload_pool;
+};
+
 /* Device, which is GPU, with some common functionality for GPU back-ends. */
 class GPUDevice : public Device {
  protected:
@@ -369,6 +409,31 @@ class GPUDevice : public Device {
   /* Simple counter which will try to track amount of used device memory */
   size_t device_mem_in_use = 0;
 
+  /* Sub-allocator for small device allocations.
+   *
+   * Scenes easily contain thousands of small attribute arrays, and a driver
+   * allocation per array is slow and fragments device memory. Allocations up
+   * to MEMORY_POOL_MAX_ALLOC are carved out of larger slabs instead. Freed
+   * blocks coalesce with free neighbors, and a slab is returned to the
+   * driver once it is empty again. */
+  static const size_t MEMORY_POOL_SLAB_SIZE = 16 * 1024 * 1024;
+  static const size_t MEMORY_POOL_MAX_ALLOC = 1024 * 1024;
+  static const size_t MEMORY_POOL_ALIGNMENT = 256;
+
+  struct MemoryPoolSlab {
+    void *base = nullptr;
+    size_t used = 0;
+    /* Offset -> size of free blocks, kept coalesced. */
+    map<size_t, size_t> free_blocks;
+  };
+  vector<unique_ptr<MemoryPoolSlab>> memory_pool_slabs;
+  /* Pooled pointer -> owning slab and block size. */
+  map<void *, std::pair<MemoryPoolSlab *, size_t>> memory_pool_blocks;
+  thread_mutex memory_pool_mutex;
+
+  bool pool_alloc_device(void *&device_pointer, const size_t size);
+  bool pool_free_device(void *device_pointer);
+
   virtual void init_host_memory(const size_t preferred_texture_headroom = 0,
                                 const size_t preferred_working_headroom = 0);
   virtual void move_textures_to_host(const size_t size,
@@ -381,6 +446,9 @@ class GPUDevice : public Device {
   virtual void generic_free(device_memory &mem);
   virtual void generic_copy_to(device_memory &mem);
 
+  using Device::mem_copy_to;
+  void mem_copy_to(device_memory &mem, const size_t offset, const size_t size) override;
+
   /* total - amount of device memory, free - amount of available device memory */
   virtual void get_device_memory_info(size_t &total, size_t &free) = 0;
 
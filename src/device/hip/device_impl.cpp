@@ -12,7 +12,7 @@
 
 #  include "util/debug.h"
 #  include "util/log.h"
-#  include "util/md5.h"
+#  include "util/fasthash.h"
 #  include "util/path.h"
 #  include "util/string.h"
 #  include "util/system.h"
@@ -198,7 +198,7 @@ bool HIPDevice::use_adaptive_compilation()
 }
 
 /* Common HIPCC flags which stays the same regardless of shading model,
- * kernel sources md5 and only depends on compiler or compilation settings.
+ * kernel sources hash and only depends on compiler or compilation settings.
  */
 string HIPDevice::compile_kernel_get_common_cflags(const uint kernel_features)
 {
@@ -213,6 +213,9 @@ string HIPDevice::compile_kernel_get_common_cflags(const uint kernel_features)
       include_path.c_str());
   if (use_adaptive_compilation()) {
     cflags += " -D__KERNEL_FEATURES__=" + to_string(kernel_features);
+    if (kernel_closure_set != ~0U) {
+      cflags += " -D__KERNEL_CLOSURE_SET__=" + to_string(kernel_closure_set);
+    }
   }
 
   const char *extra_cflags = getenv("CYCLES_HIP_EXTRA_CFLAGS");
@@ -231,6 +234,20 @@ string HIPDevice::compile_kernel_get_common_cflags(const uint kernel_features)
   return cflags;
 }
 
+string HIPDevice::precompiled_kernel(const char *name)
+{
+  const std::string arch = hipDeviceArch(hipDevId);
+
+  const string fatbin = path_get(string_printf("lib/%s_%s.fatbin.zst", name, arch.c_str()));
+  VLOG_INFO << "Testing for pre-compiled kernel " << fatbin << ".";
+  if (path_exists(fatbin)) {
+    VLOG_INFO << "Using precompiled kernel.";
+    return fatbin;
+  }
+
+  return string();
+}
+
 string HIPDevice::compile_kernel(const uint kernel_features, const char *name, const char *base)
 {
   /* Compute kernel name. */
@@ -241,23 +258,21 @@ string HIPDevice::compile_kernel(const uint kernel_features, const char *name, c
 
   /* Attempt to use kernel provided with Blender. */
   if (!use_adaptive_compilation()) {
-    const string fatbin = path_get(string_printf("lib/%s_%s.fatbin.zst", name, arch.c_str()));
-    VLOG_INFO << "Testing for pre-compiled kernel " << fatbin << ".";
-    if (path_exists(fatbin)) {
-      VLOG_INFO << "Using precompiled kernel.";
-      return fatbin;
+    const string precompiled = precompiled_kernel(name);
+    if (!precompiled.empty()) {
+      return precompiled;
     }
   }
 
   /* Try to use locally compiled kernel. */
   string source_path = path_get("source");
-  const string source_md5 = path_files_md5_hash(source_path);
+  const string source_hash = path_files_content_hash(source_path);
 
-  /* We include cflags into md5 so changing hip toolkit or changing other
+  /* We include cflags into the hash so changing hip toolkit or changing other
    * compiler command line arguments makes sure fatbin gets re-built.
    */
   string common_cflags = compile_kernel_get_common_cflags(kernel_features);
-  const string kernel_md5 = util_md5_string(source_md5 + common_cflags);
+  const string kernel_hash = util_fast_hash_string(source_hash + common_cflags);
 
   const char *const kernel_ext = "genco";
   std::string options = "-Wno-parentheses-equality -Wno-unused-value -ffast-math";
@@ -278,10 +293,10 @@ string HIPDevice::compile_kernel(const uint kernel_features, const char *name, c
 
   const string include_path = source_path;
   const string fatbin_file = string_printf(
-      "cycles_%s_%s_%s", name, arch.c_str(), kernel_md5.c_str());
+      "cycles_%s_%s_%s", name, arch.c_str(), kernel_hash.c_str());
   const string fatbin = path_cache_get(path_join("kernels", fatbin_file));
   VLOG_INFO << "Testing for locally compiled kernel " << fatbin << ".";
-  if (path_exists(fatbin)) {
+  if (path_cache_kernel_exists_and_mark_used(fatbin)) {
     VLOG_INFO << "Using locally compiled kernel.";
     return fatbin;
   }
@@ -367,6 +382,8 @@ string HIPDevice::compile_kernel(const uint kernel_features, const char *name, c
 
   printf("Kernel compilation finished in %.2lfs.\n", time_dt() - starttime);
 
+  path_cache_kernel_mark_added_and_clear_old(fatbin);
+
   return fatbin;
 }
 
@@ -395,6 +412,16 @@ bool HIPDevice::load_kernels(const uint kernel_features)
 
   /* get kernel */
   const char *kernel_name = "kernel";
+
+  /* Prefer the precompiled lite kernel when the scene uses none of the features
+   * it was built without. Adaptive compilation already specializes further. */
+  if (!use_adaptive_compilation() && (kernel_features & KERNEL_FEATURES_LITE_EXCLUDED) == 0 &&
+      !precompiled_kernel("kernel_lite").empty())
+  {
+    VLOG_INFO << "Using lite kernel for reduced scene feature set.";
+    kernel_name = "kernel_lite";
+  }
+
   string fatbin = compile_kernel(kernel_features, kernel_name);
   if (fatbin.empty()) {
     return false;
@@ -493,7 +520,42 @@ bool HIPDevice::alloc_device(void *&device_pointer, const size_t size)
   HIPContextScope scope(this);
 
   hipError_t mem_alloc_result = hipMalloc((hipDeviceptr_t *)&device_pointer, size);
-  return mem_alloc_result == hipSuccess;
+  if (mem_alloc_result == hipSuccess) {
+    return true;
+  }
+
+  /* Out-of-core fallback: when device memory is exhausted, allocate managed memory instead so
+   * that oversized scenes render slowly rather than fail. Unlike the host-mapped fallback this
+   * also covers MEM_DEVICE_ONLY allocations like the BVH and path state, and the driver migrates
+   * pages to the device on demand instead of serving every access over the bus. */
+  if (mem_alloc_result == hipErrorOutOfMemory) {
+    int can_use_managed = 0;
+    hipDeviceGetAttribute(&can_use_managed, hipDeviceAttributeManagedMemory, hipDevice);
+    if (can_use_managed) {
+      mem_alloc_result = hipMallocManaged(
+          (hipDeviceptr_t *)&device_pointer, size, hipMemAttachGlobal);
+      if (mem_alloc_result == hipSuccess) {
+        VLOG_WORK << "Device memory exhausted, falling back to managed allocation of "
+                  << string_human_readable_size(size) << ".";
+        /* Prefer to keep the pages on the device and populate as many of them as fit up front,
+         * so the first kernel launch does not fault them in one page at a time. The hint entry
+         * points are optional in hipew since older runtimes lack them. */
+        if (hipMemAdvise) {
+          hipMemAdvise((hipDeviceptr_t)device_pointer,
+                       size,
+                       hipMemAdviseSetPreferredLocation,
+                       hipDevice);
+          hipMemAdvise((hipDeviceptr_t)device_pointer, size, hipMemAdviseSetAccessedBy, hipDevice);
+        }
+        if (hipMemPrefetchAsync) {
+          hipMemPrefetchAsync((hipDeviceptr_t)device_pointer, size, hipDevice, 0);
+        }
+        return true;
+      }
+    }
+  }
+
+  return false;
 }
 
 void HIPDevice::free_device(void *device_pointer)
@@ -53,6 +53,10 @@ class HIPDevice : public GPUDevice {
 
   virtual string compile_kernel_get_common_cflags(const uint kernel_features);
 
+  /* Returns the path of the precompiled kernel binary for this device, or an
+   * empty string when none was shipped. */
+  string precompiled_kernel(const char *name);
+
   virtual string compile_kernel(const uint kernel_features,
                                 const char *name,
                                 const char *base = "hip");
@@ -15,15 +15,33 @@ namespace ccl {
 /* HIPDeviceQueue */
 
 HIPDeviceQueue::HIPDeviceQueue(HIPDevice *device)
-    : DeviceQueue(device), hip_device_(device), hip_stream_(nullptr)
+    : DeviceQueue(device),
+      hip_device_(device),
+      hip_stream_(nullptr),
+      hip_transfer_stream_(nullptr),
+      hip_transfer_event_(nullptr)
 {
   const HIPContextScope scope(hip_device_);
   hip_device_assert(hip_device_, hipStreamCreateWithFlags(&hip_stream_, hipStreamNonBlocking));
+  hip_device_assert(hip_device_,
+                    hipStreamCreateWithFlags(&hip_transfer_stream_, hipStreamNonBlocking));
+  hip_device_assert(hip_device_,
+                    hipEventCreateWithFlags(&hip_transfer_event_, hipEventDisableTiming));
 }
 
 HIPDeviceQueue::~HIPDeviceQueue()
 {
   const HIPContextScope scope(hip_device_);
+  for (const KernelTimingInterval &interval : timing_intervals_) {
+    hipEventDestroy(interval.begin);
+    hipEventDestroy(interval.end);
+  }
+  for (const pair<hipEvent_t, hipEvent_t> &events : timing_event_pool_) {
+    hipEventDestroy(events.first);
+    hipEventDestroy(events.second);
+  }
+  hipEventDestroy(hip_transfer_event_);
+  hipStreamDestroy(hip_transfer_stream_);
   hipStreamDestroy(hip_stream_);
 }
 
@@ -33,6 +51,28 @@ int HIPDeviceQueue::num_concurrent_states(const size_t state_size) const
                               hip_device_->get_max_num_threads_per_multiprocessor();
   int num_states = ((max_num_threads == 0) ? 65536 : max_num_threads) * 16;
 
+  /* Scale the state count to the memory actually available on the card. Cards with lots of free
+   * memory can keep more paths in flight to hide latency, while on small cards the default
+   * sizing would push the state into the host-mapped fallback, which is far more costly than
+   * rendering with fewer concurrent paths. */
+  size_t total_mem = 0;
+  size_t free_mem = 0;
+  hip_device_->get_device_memory_info(total_mem, free_mem);
+  if (total_mem != 0) {
+    const size_t min_headroom = max(total_mem / 8, size_t(1024 * 1024 * 1024));
+    size_t state_mem = (size_t)num_states * state_size;
+    if (free_mem >= state_mem * 2 + min_headroom) {
+      num_states *= 2;
+      VLOG_DEVICE_STATS << "Doubling GPU queue concurrent states to exploit available memory";
+    }
+    else {
+      while (num_states > 65536 && free_mem < state_mem + min_headroom) {
+        num_states /= 2;
+        state_mem /= 2;
+      }
+    }
+  }
+
   const char *factor_str = getenv("CYCLES_CONCURRENT_STATES_FACTOR");
   if (factor_str) {
     const float factor = (float)atof(factor_str);
@@ -116,6 +156,7 @@ bool HIPDeviceQueue::enqueue(DeviceKernel kernel,
   }
 
   /* Launch kernel. */
+  kernel_timing_begin(kernel);
   assert_success(hipModuleLaunchKernel(hip_kernel.function,
                                        num_blocks,
                                        1,
@@ -128,12 +169,60 @@ bool HIPDeviceQueue::enqueue(DeviceKernel kernel,
                                        const_cast<void **>(args.values),
                                        nullptr),
                  "enqueue");
+  kernel_timing_end();
 
   debug_enqueue_end();
 
   return !(hip_device_->have_error());
 }
 
+void HIPDeviceQueue::kernel_timing_begin(DeviceKernel kernel)
+{
+  if (!kernel_timing_enabled_) {
+    return;
+  }
+
+  KernelTimingInterval interval;
+  interval.kernel = kernel;
+
+  if (timing_event_pool_.empty()) {
+    hip_device_assert(hip_device_, hipEventCreateWithFlags(&interval.begin, hipEventDefault));
+    hip_device_assert(hip_device_, hipEventCreateWithFlags(&interval.end, hipEventDefault));
+  }
+  else {
+    interval.begin = timing_event_pool_.back().first;
+    interval.end = timing_event_pool_.back().second;
+    timing_event_pool_.pop_back();
+  }
+
+  hip_device_assert(hip_device_, hipEventRecord(interval.begin, hip_stream_));
+
+  timing_intervals_.push_back(interval);
+}
+
+void HIPDeviceQueue::kernel_timing_end()
+{
+  if (!kernel_timing_enabled_ || timing_intervals_.empty()) {
+    return;
+  }
+
+  hip_device_assert(hip_device_, hipEventRecord(timing_intervals_.back().end, hip_stream_));
+}
+
+void HIPDeviceQueue::kernel_timing_resolve()
+{
+  for (const KernelTimingInterval &interval : timing_intervals_) {
+    float milliseconds = 0.0f;
+    hip_device_assert(hip_device_,
+                      hipEventElapsedTime(&milliseconds, interval.begin, interval.end));
+    kernel_timing_add(interval.kernel, milliseconds / 1000.0);
+
+    timing_event_pool_.emplace_back(interval.begin, interval.end);
+  }
+
+  timing_intervals_.clear();
+}
+
 bool HIPDeviceQueue::synchronize()
 {
   if (hip_device_->have_error()) {
@@ -142,6 +231,10 @@ bool HIPDeviceQueue::synchronize()
 
   const HIPContextScope scope(hip_device_);
   assert_success(hipStreamSynchronize(hip_stream_), "synchronize");
+
+  /* Events recorded around the enqueued kernels are known to be complete now. */
+  kernel_timing_resolve();
+
   debug_synchronize();
 
   return !(hip_device_->have_error());
@@ -212,6 +305,44 @@ void HIPDeviceQueue::copy_from_device(device_memory &mem)
       "copy_from_device");
 }
 
+void HIPDeviceQueue::copy_from_device_async(device_memory &mem)
+{
+  assert(mem.type != MEM_GLOBAL && mem.type != MEM_TEXTURE);
+
+  if (mem.memory_size() == 0) {
+    return;
+  }
+
+  assert(mem.device_pointer != 0);
+  assert(mem.host_pointer != nullptr);
+
+  const HIPContextScope scope(hip_device_);
+
+  /* Order the transfer after all work enqueued on the compute stream so far, without blocking
+   * kernels enqueued afterwards. */
+  assert_success(hipEventRecord(hip_transfer_event_, hip_stream_), "copy_from_device_async");
+  assert_success(hipStreamWaitEvent(hip_transfer_stream_, hip_transfer_event_, 0),
+                 "copy_from_device_async");
+
+  assert_success(hipMemcpyDtoHAsync(mem.host_pointer,
+                                    (hipDeviceptr_t)mem.device_pointer,
+                                    mem.memory_size(),
+                                    hip_transfer_stream_),
+                 "copy_from_device_async");
+}
+
+bool HIPDeviceQueue::synchronize_transfer()
+{
+  if (hip_device_->have_error()) {
+    return false;
+  }
+
+  const HIPContextScope scope(hip_device_);
+  assert_success(hipStreamSynchronize(hip_transfer_stream_), "synchronize_transfer");
+
+  return !(hip_device_->have_error());
+}
+
 void HIPDeviceQueue::assert_success(hipError_t result, const char *operation)
 {
   if (result != hipSuccess) {
@@ -11,6 +11,8 @@
 
 #  include "device/hip/util.h"
 
+#  include "util/vector.h"
+
 namespace ccl {
 
 class HIPDevice;
@@ -33,10 +35,18 @@ class HIPDeviceQueue : public DeviceQueue {
 
   bool synchronize() override;
 
+  bool supports_kernel_timing() const override
+  {
+    return true;
+  }
+
   void zero_to_device(device_memory &mem) override;
   void copy_to_device(device_memory &mem) override;
   void copy_from_device(device_memory &mem) override;
 
+  void copy_from_device_async(device_memory &mem) override;
+  bool synchronize_transfer() override;
+
   virtual hipStream_t stream()
   {
     return hip_stream_;
@@ -47,6 +57,22 @@ class HIPDeviceQueue : public DeviceQueue {
  protected:
   HIPDevice *hip_device_;
   hipStream_t hip_stream_;
+  hipStream_t hip_transfer_stream_;
+  hipEvent_t hip_transfer_event_;
+
+  /* Record timestamp events around a kernel launch, when per-kernel timing is enabled.
+   * The events are resolved and recycled on synchronize(). */
+  void kernel_timing_begin(DeviceKernel kernel);
+  void kernel_timing_end();
+  void kernel_timing_resolve();
+
+  struct KernelTimingInterval {
+    DeviceKernel kernel;
+    hipEvent_t begin;
+    hipEvent_t end;
+  };
+  vector<KernelTimingInterval> timing_intervals_;
+  vector<pair<hipEvent_t, hipEvent_t>> timing_event_pool_;
 
   void assert_success(hipError_t result, const char *operation);
 };
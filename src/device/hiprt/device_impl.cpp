@@ -9,7 +9,7 @@
 #  include "kernel/device/hiprt/globals.h"
 
 #  include "util/log.h"
-#  include "util/md5.h"
+#  include "util/fasthash.h"
 #  include "util/path.h"
 #  include "util/progress.h"
 #  include "util/string.h"
@@ -160,19 +160,19 @@ string HIPRTDevice::compile_kernel(const uint kernel_features, const char *name,
   }
 
   string source_path = path_get("source");
-  const string source_md5 = path_files_md5_hash(source_path);
+  const string source_hash = path_files_content_hash(source_path);
 
   string common_cflags = compile_kernel_get_common_cflags(kernel_features);
-  const string kernel_md5 = util_md5_string(source_md5 + common_cflags);
+  const string kernel_hash = util_fast_hash_string(source_hash + common_cflags);
 
   const string include_path = source_path;
   const string fatbin_file = string_printf(
-      "cycles_%s_%s_%s.hipfb", name, arch.c_str(), kernel_md5.c_str());
+      "cycles_%s_%s_%s.hipfb", name, arch.c_str(), kernel_hash.c_str());
   const string fatbin = path_cache_get(path_join("kernels", fatbin_file));
   const string hiprt_include_path = path_join(source_path, "kernel/device/hiprt");
 
   VLOG(1) << "Testing for locally compiled kernel " << fatbin << ".";
-  if (path_exists(fatbin)) {
+  if (path_cache_kernel_exists_and_mark_used(fatbin)) {
     VLOG(1) << "Using locally compiled kernel.";
     return fatbin;
   }
@@ -260,6 +260,8 @@ string HIPRTDevice::compile_kernel(const uint kernel_features, const char *name,
 
   printf("Kernel compilation finished in %.2lfs.\n", time_dt() - starttime);
 
+  path_cache_kernel_mark_added_and_clear_old(fatbin);
+
   return fatbin;
 }
 
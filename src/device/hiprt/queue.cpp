@@ -61,6 +61,7 @@ bool HIPRTDeviceQueue::enqueue(DeviceKernel kernel,
   const int num_blocks = divide_up(work_size, num_threads_per_block);
   int shared_mem_bytes = 0;
 
+  kernel_timing_begin(kernel);
   assert_success(hipModuleLaunchKernel(hip_kernel.function,
                                        num_blocks,
                                        1,
@@ -73,6 +74,7 @@ bool HIPRTDeviceQueue::enqueue(DeviceKernel kernel,
                                        const_cast<void **>(args_copy.values),
                                        nullptr),
                  "enqueue");
+  kernel_timing_end();
 
   debug_enqueue_end();
 
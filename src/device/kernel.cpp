@@ -138,18 +138,16 @@ const char *device_kernel_as_string(DeviceKernel kernel)
     /* Adaptive sampling. */
     case DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_CHECK:
       return "adaptive_sampling_convergence_check";
-    case DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER_X:
-      return "adaptive_sampling_filter_x";
-    case DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER_Y:
-      return "adaptive_sampling_filter_y";
+    case DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER:
+      return "adaptive_sampling_filter";
+    case DEVICE_KERNEL_ADAPTIVE_SAMPLING_COUNT_ACTIVE_BLOCKS:
+      return "adaptive_sampling_count_active_blocks";
 
     /* Denoising. */
     case DEVICE_KERNEL_FILTER_GUIDING_PREPROCESS:
       return "filter_guiding_preprocess";
     case DEVICE_KERNEL_FILTER_GUIDING_SET_FAKE_ALBEDO:
       return "filter_guiding_set_fake_albedo";
-    case DEVICE_KERNEL_FILTER_COLOR_PREPROCESS:
-      return "filter_color_preprocess";
     case DEVICE_KERNEL_FILTER_COLOR_POSTPROCESS:
       return "filter_color_postprocess";
 
@@ -65,6 +65,7 @@ void device_memory::host_and_device_free()
 
   if (device_pointer) {
     device->mem_free(*this);
+    device->stats.mem_untrack(this);
   }
 
   data_size = 0;
@@ -77,12 +78,24 @@ void device_memory::device_alloc()
 {
   assert(!device_pointer && type != MEM_TEXTURE && type != MEM_GLOBAL);
   device->mem_alloc(*this);
+  device->stats.mem_track(this, name, device_size);
 }
 
 void device_memory::device_copy_to()
 {
   if (host_pointer) {
     device->mem_copy_to(*this);
+    /* Copying may have (re)allocated the device side, refresh the tracked size. */
+    if (device_pointer) {
+      device->stats.mem_track(this, name, device_size);
+    }
+  }
+}
+
+void device_memory::device_copy_to(const size_t offset, const size_t size)
+{
+  if (host_pointer) {
+    device->mem_copy_to(*this, offset, size);
   }
 }
 
@@ -90,6 +103,7 @@ void device_memory::device_move_to_host()
 {
   if (host_pointer) {
     device->mem_move_to_host(*this);
+    device->stats.mem_track(this, name, device_size);
   }
 }
 
@@ -103,6 +117,9 @@ void device_memory::device_zero()
 {
   if (data_size) {
     device->mem_zero(*this);
+    if (device_pointer) {
+      device->stats.mem_track(this, name, device_size);
+    }
   }
 }
 
@@ -217,9 +234,18 @@ device_texture::~device_texture()
 }
 
 /* Host memory allocation. */
-void *device_texture::alloc(const size_t width, const size_t height, const size_t depth)
+void *device_texture::alloc(const size_t width,
+                            const size_t height,
+                            const size_t depth,
+                            const uint num_mip_levels)
 {
-  const size_t new_size = size(width, height, depth);
+  size_t new_size = size(width, height, depth);
+
+  /* Mip levels are stored contiguously after the base level. Only the CPU device samples
+   * them, so they are only requested when the texture lives in host memory. */
+  for (uint level = 1; level <= num_mip_levels; level++) {
+    new_size += size(max(width >> level, (size_t)1), max(height >> level, (size_t)1), depth);
+  }
 
   if (new_size != data_size) {
     host_and_device_free();
@@ -235,6 +261,7 @@ void *device_texture::alloc(const size_t width, const size_t height, const size_
   info.width = width;
   info.height = height;
   info.depth = depth;
+  info.num_mip_levels = num_mip_levels;
 
   return host_pointer;
 }
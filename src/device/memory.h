@@ -269,6 +269,7 @@ class device_memory {
 
  protected:
   friend class Device;
+  friend class DeviceUploadBatch;
   friend class GPUDevice;
   friend class CUDADevice;
   friend class OptiXDevice;
@@ -288,6 +289,7 @@ class device_memory {
   /* Device memory allocation and copying. */
   void device_alloc();
   void device_copy_to();
+  void device_copy_to(const size_t offset, const size_t size);
   void device_move_to_host();
   void device_copy_from(const size_t y, const size_t w, size_t h, const size_t elem);
   void device_zero();
@@ -393,7 +395,7 @@ template<typename T> class device_vector : public device_memory {
     if (new_size != data_size) {
       host_and_device_free();
       host_pointer = host_alloc(sizeof(T) * new_size);
-      modified = true;
+      tag_modified();
       assert(device_pointer == 0);
     }
 
@@ -461,8 +463,7 @@ template<typename T> class device_vector : public device_memory {
     data_height = 0;
     data_depth = 0;
     host_pointer = 0;
-    modified = true;
-    need_realloc_ = true;
+    tag_realloc();
     assert(device_pointer == 0);
   }
 
@@ -486,6 +487,23 @@ template<typename T> class device_vector : public device_memory {
   void tag_modified()
   {
     modified = true;
+    modified_begin = 0;
+    modified_end = ~size_t(0);
+  }
+
+  /* Tag a range of elements as modified, so that copy_to_device_if_modified()
+   * only uploads the dirty range instead of the whole array. */
+  void tag_modified_range(const size_t begin, const size_t end)
+  {
+    if (!modified) {
+      modified = true;
+      modified_begin = begin;
+      modified_end = end;
+    }
+    else {
+      modified_begin = min(modified_begin, begin);
+      modified_end = max(modified_end, end);
+    }
   }
 
   void tag_realloc()
@@ -522,19 +540,39 @@ template<typename T> class device_vector : public device_memory {
     }
   }
 
+  /* Copy a sub-range of elements to the device, into an existing allocation. */
+  void copy_to_device(const size_t offset, const size_t size)
+  {
+    assert(offset + size <= data_size);
+
+    if (size != 0) {
+      device_copy_to(offset * sizeof(T), size * sizeof(T));
+    }
+  }
+
   void copy_to_device_if_modified()
   {
     if (!modified) {
       return;
     }
 
-    copy_to_device();
+    const size_t begin = min(modified_begin, data_size);
+    const size_t end = min(modified_end, data_size);
+
+    if (need_realloc_ || (begin == 0 && end == data_size)) {
+      copy_to_device();
+    }
+    else {
+      copy_to_device(begin, end - begin);
+    }
   }
 
   void clear_modified()
   {
     modified = false;
     need_realloc_ = false;
+    modified_begin = 0;
+    modified_end = 0;
   }
 
   void copy_from_device()
@@ -553,6 +591,11 @@ template<typename T> class device_vector : public device_memory {
   }
 
  protected:
+  /* Dirty element range for partial uploads. Covers the whole array after
+   * tag_modified(), and is empty once cleared. */
+  size_t modified_begin = 0;
+  size_t modified_end = ~size_t(0);
+
   size_t size(const size_t width, const size_t height, const size_t depth)
   {
     return width * ((height == 0) ? 1 : height) * ((depth == 0) ? 1 : depth);
@@ -600,7 +643,10 @@ class device_texture : public device_memory {
                  ExtensionType extension);
   ~device_texture() override;
 
-  void *alloc(const size_t width, const size_t height, const size_t depth = 0);
+  void *alloc(const size_t width,
+              const size_t height,
+              const size_t depth = 0,
+              const uint num_mip_levels = 0);
   void copy_to_device();
 
   uint slot = 0;
@@ -14,6 +14,8 @@
 #  include "device/metal/queue.h"
 #  include "device/metal/util.h"
 
+#  include "util/set.h"
+
 #  include <Metal/Metal.h>
 
 namespace ccl {
@@ -76,6 +78,12 @@ class MetalDevice : public Device {
   std::vector<id<MTLResource>> delayed_free_list;
   std::recursive_mutex metal_mem_map_mutex;
 
+  /* Page-allocated host memory from host_alloc, which generic_alloc can wrap in a zero-copy
+   * MTLBuffer. Pointers that entered through other paths (e.g. steal_data) are not here and
+   * must not be wrapped or freed as pages. */
+  unordered_set<void *> host_allocations;
+  thread_mutex host_allocations_mutex;
+
   /* Bindless Textures */
   bool is_texture(const TextureInfo &tex);
   device_vector<TextureInfo> texture_info;
@@ -150,6 +158,10 @@ class MetalDevice : public Device {
 
   bool max_working_set_exceeded(const size_t safety_margin = 8 * 1024 * 1024) const;
 
+  void *host_alloc(const MemoryType type, const size_t size) override;
+
+  void host_free(const MemoryType type, void *host_pointer, const size_t size) override;
+
   MetalMem *generic_alloc(device_memory &mem);
 
   void generic_copy_to(device_memory &mem);
@@ -19,6 +19,7 @@
 
 #  include <TargetConditionals.h>
 #  include <crt_externs.h>
+#  include <mach/mach.h>
 
 namespace ccl {
 
@@ -688,6 +689,43 @@ bool MetalDevice::max_working_set_exceeded(const size_t safety_margin) const
   return (stats.mem_used > available);
 }
 
+void *MetalDevice::host_alloc(const MemoryType /*type*/, const size_t size)
+{
+  if (size == 0) {
+    return nullptr;
+  }
+
+  /* Allocate whole pages, so that generic_alloc can wrap the host allocation in a zero-copy
+   * MTLBuffer through newBufferWithBytesNoCopy, which requires page-allocated memory. */
+  vm_address_t address = 0;
+  const kern_return_t result = vm_allocate(
+      mach_task_self(), &address, round_up(size, vm_page_size), VM_FLAGS_ANYWHERE);
+  if (result != KERN_SUCCESS) {
+    return nullptr;
+  }
+
+  {
+    const thread_scoped_lock lock(host_allocations_mutex);
+    host_allocations.insert((void *)address);
+  }
+
+  return (void *)address;
+}
+
+void MetalDevice::host_free(const MemoryType type, void *host_pointer, const size_t size)
+{
+  {
+    const thread_scoped_lock lock(host_allocations_mutex);
+    if (host_allocations.erase(host_pointer) == 0) {
+      /* Not allocated by us, e.g. taken over from an array through steal_data. */
+      Device::host_free(type, host_pointer, size);
+      return;
+    }
+  }
+
+  vm_deallocate(mach_task_self(), (vm_address_t)host_pointer, round_up(size, vm_page_size));
+}
+
 MetalDevice::MetalMem *MetalDevice::generic_alloc(device_memory &mem)
 {
   @autoreleasepool {
@@ -702,8 +740,34 @@ MetalDevice::MetalMem *MetalDevice::generic_alloc(device_memory &mem)
       if (mem.type == MEM_DEVICE_ONLY && !capture_enabled) {
         options = MTLResourceStorageModePrivate;
       }
+      else if (mem.host_pointer) {
+        /* Memory is physically unified, so wrap page-allocated host memory directly instead of
+         * copying it into a separate buffer. The deallocator takes over ownership of the pages
+         * from host_alloc. */
+        bool page_allocated = false;
+        {
+          const thread_scoped_lock lock(host_allocations_mutex);
+          page_allocated = (host_allocations.count(mem.host_pointer) != 0);
+        }
+
+        if (page_allocated) {
+          metal_buffer = [mtlDevice
+              newBufferWithBytesNoCopy:mem.host_pointer
+                                length:round_up(size, vm_page_size)
+                               options:options
+                           deallocator:^(void *pointer, NSUInteger length) {
+                             vm_deallocate(mach_task_self(), (vm_address_t)pointer, length);
+                           }];
+          if (metal_buffer) {
+            const thread_scoped_lock lock(host_allocations_mutex);
+            host_allocations.erase(mem.host_pointer);
+          }
+        }
+      }
 
-      metal_buffer = [mtlDevice newBufferWithLength:size options:options];
+      if (!metal_buffer) {
+        metal_buffer = [mtlDevice newBufferWithLength:size options:options];
+      }
 
       if (!metal_buffer) {
         set_error("System is out of GPU memory");
@@ -420,17 +420,10 @@ bool MetalKernelPipeline::should_use_binary_archive() const
       return true;
     }
 
-    if ((device_kernel >= DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND &&
-         device_kernel <= DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW) ||
-        (device_kernel >= DEVICE_KERNEL_SHADER_EVAL_DISPLACE &&
-         device_kernel <= DEVICE_KERNEL_SHADER_EVAL_CURVE_SHADOW_TRANSPARENCY))
-    {
-      /* Archive all shade kernels - they take a long time to compile. */
-      return true;
-    }
-
-    /* The remaining kernels are all fast to compile. They may get cached by the system shader
-     * cache, but will be quick to regenerate if not. */
+    /* Archive the remaining kernels as well. The shade kernels take a long time to compile, and
+     * while the others are individually fast, in aggregate they still cost seconds of setup per
+     * session for app-embedded renders that create the device repeatedly. */
+    return true;
   }
   return false;
 }
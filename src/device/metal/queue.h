@@ -38,6 +38,13 @@ class MetalDeviceQueue : public DeviceQueue {
 
   bool synchronize() override;
 
+  /* Per-kernel timing rides on the existing counter sampling machinery, which is only set up
+   * when the CYCLES_METAL_PROFILING environment variable is set at device creation. */
+  bool supports_kernel_timing() const override
+  {
+    return profiling_enabled_;
+  }
+
   void zero_to_device(device_memory &mem) override;
   void copy_to_device(device_memory &mem) override;
   void copy_from_device(device_memory &mem) override;
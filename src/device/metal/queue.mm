@@ -628,6 +628,10 @@ void MetalDeviceQueue::flush_timing_stats()
     stat.total_time += completion_time_gpu;
     stat.total_work_size += label.work_size;
     last_completion_time_ = completion_time_gpu;
+
+    if (kernel_timing_enabled_) {
+      kernel_timing_add(label.kernel, completion_time_gpu);
+    }
   }
   command_encoder_labels_.clear();
 }
@@ -182,6 +182,13 @@ class MultiDevice : public Device {
     return true;
   }
 
+  void set_kernel_closure_set(const uint closure_set) override
+  {
+    for (SubDevice &sub : devices) {
+      sub.device->set_kernel_closure_set(closure_set);
+    }
+  }
+
   bool load_osl_kernels() override
   {
     for (SubDevice &sub : devices) {
@@ -395,18 +402,24 @@ class MultiDevice : public Device {
 
     for (const vector<SubDevice *> &island : peer_islands) {
       SubDevice *owner_sub = find_suitable_mem_device(existing_key, island);
+      const device_ptr existing_ptr = (existing_key) ? owner_sub->ptr_map[existing_key] : 0;
       mem.device = owner_sub->device.get();
-      mem.device_pointer = (existing_key) ? owner_sub->ptr_map[existing_key] : 0;
+      mem.device_pointer = existing_ptr;
       mem.device_size = existing_size;
 
       owner_sub->device->mem_copy_to(mem);
       owner_sub->ptr_map[key] = mem.device_pointer;
 
       if (mem.type == MEM_GLOBAL || mem.type == MEM_TEXTURE) {
-        /* Need to create texture objects and update pointer in kernel globals on all devices */
-        for (SubDevice *island_sub : island) {
-          if (island_sub != owner_sub) {
-            island_sub->device->mem_copy_to(mem);
+        /* Need to create texture objects and update pointer in kernel globals on all devices.
+         * Only needed when the allocation moved: for updates copied into an existing allocation
+         * the peer devices already reference it, and skipping the rebind avoids a round of
+         * context switches on every scene sync. */
+        if (mem.device_pointer != existing_ptr) {
+          for (SubDevice *island_sub : island) {
+            if (island_sub != owner_sub) {
+              island_sub->device->mem_copy_to(mem);
+            }
           }
         }
       }
@@ -417,6 +430,32 @@ class MultiDevice : public Device {
     stats.mem_alloc(mem.device_size - existing_size);
   }
 
+  void mem_copy_to(device_memory &mem, const size_t offset, const size_t size) override
+  {
+    const device_ptr existing_key = mem.device_pointer;
+    if (!existing_key) {
+      /* Not allocated on the devices yet, needs a regular full copy. */
+      mem_copy_to(mem);
+      return;
+    }
+
+    const size_t existing_size = mem.device_size;
+
+    for (const vector<SubDevice *> &island : peer_islands) {
+      SubDevice *owner_sub = find_suitable_mem_device(existing_key, island);
+      mem.device = owner_sub->device.get();
+      mem.device_pointer = owner_sub->ptr_map[existing_key];
+      mem.device_size = existing_size;
+
+      owner_sub->device->mem_copy_to(mem, offset, size);
+      owner_sub->ptr_map[existing_key] = mem.device_pointer;
+    }
+
+    mem.device = this;
+    mem.device_pointer = existing_key;
+    mem.device_size = existing_size;
+  }
+
   void mem_move_to_host(device_memory &mem) override
   {
     assert(mem.type == MEM_GLOBAL || mem.type == MEM_TEXTURE);
@@ -974,8 +974,18 @@ bool OneapiDevice::create_queue(SyclQueue *&external_queue,
     if (device_index < 0 || device_index >= devices.size()) {
       return false;
     }
-    sycl::queue *created_queue = new sycl::queue(devices[device_index],
-                                                 sycl::property::queue::in_order());
+    /* The wavefront loop reads queue counters on the host between dispatches, so kernels are
+     * submitted one by one and per-submission overhead adds up at low resolutions. The queue is
+     * in-order and events returned from submissions are never used, so ask the runtime to skip
+     * creating them where the extension is available. */
+    sycl::property_list queue_properties = {sycl::property::queue::in_order()};
+#  if defined(SYCL_EXT_ONEAPI_DISCARD_QUEUE_EVENTS) && !defined(WITH_CYCLES_DEBUG)
+    /* Debug builds wait on memory operation events for precise error reporting, so keep events
+     * there. */
+    queue_properties = {sycl::property::queue::in_order(),
+                        sycl::ext::oneapi::property::queue::discard_events()};
+#  endif
+    sycl::queue *created_queue = new sycl::queue(devices[device_index], queue_properties);
     external_queue = reinterpret_cast<SyclQueue *>(created_queue);
 #  ifdef WITH_EMBREE_GPU
     if (embree_device_pointer) {
@@ -1085,7 +1095,14 @@ bool OneapiDevice::usm_memcpy(SyclQueue *queue_, void *dest, void *src, const si
      * may not wait until the end of the transfer before using the memory.
      */
     if (from_device_to_host || host_or_device_memop_with_offset) {
+#    ifdef SYCL_EXT_ONEAPI_DISCARD_QUEUE_EVENTS
+      /* Events may be discarded on this queue and cannot be waited on. The queue is in-order,
+       * so waiting on the whole queue is equivalent. */
+      (void)mem_event;
+      queue->wait();
+#    else
       mem_event.wait();
+#    endif
     }
     return true;
 #  endif
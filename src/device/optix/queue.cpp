@@ -178,6 +178,7 @@ bool OptiXDeviceQueue::enqueue(DeviceKernel kernel,
 #  endif
 
   /* Launch the ray generation program. */
+  kernel_timing_begin(kernel);
   optix_device_assert(optix_device,
                       optixLaunch(pipeline,
                                   cuda_stream_,
@@ -187,6 +188,7 @@ bool OptiXDeviceQueue::enqueue(DeviceKernel kernel,
                                   work_size,
                                   1,
                                   1));
+  kernel_timing_end();
 
   debug_enqueue_end();
 
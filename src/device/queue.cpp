@@ -5,10 +5,14 @@
 #include "device/queue.h"
 #include "device/kernel.h"
 
+#include "device/device.h"
+
 #include "util/algorithm.h"
 #include "util/log.h"
+#include "util/profiling.h"
 #include "util/time.h"
 
+#include <atomic>
 #include <iomanip>
 
 namespace ccl {
@@ -17,6 +21,14 @@ DeviceQueue::DeviceQueue(Device *device) : device(device)
 {
   DCHECK_NE(device, nullptr);
   is_per_kernel_performance_ = getenv("CYCLES_DEBUG_PER_KERNEL_PERFORMANCE");
+
+  if (Trace::enabled()) {
+    /* Give every queue its own track, so that for example the render and denoiser queues of the
+     * same device do not get merged together. */
+    static std::atomic<int> queue_counter{0};
+    trace_track_ = string_printf(
+        "%s queue %d", device->info.description.c_str(), queue_counter.fetch_add(1) + 1);
+  }
 }
 
 DeviceQueue::~DeviceQueue()
@@ -95,6 +107,22 @@ void DeviceQueue::debug_synchronize()
   last_kernels_enqueued_.reset();
 }
 
+void DeviceQueue::kernel_timing_add(DeviceKernel kernel, const double time)
+{
+  stats_time_per_kernel_[kernel] += time;
+
+  if (!trace_track_.empty()) {
+    /* Chain the kernels back to back on the queue's track. The timestamp events only provide
+     * durations, so the placement within the frame is approximate: the batch resolved by one
+     * synchronize() ends around the synchronize time. */
+    const double now = time_dt();
+    trace_cursor_ = max(trace_cursor_, now - time);
+    Trace::add_track_event(
+        trace_track_, device_kernel_as_string(kernel), trace_cursor_, trace_cursor_ + time);
+    trace_cursor_ += time;
+  }
+}
+
 string DeviceQueue::debug_active_kernels()
 {
   return device_kernel_mask_as_string(last_kernels_enqueued_);
@@ -141,6 +141,25 @@ class DeviceQueue {
   virtual void copy_to_device(device_memory &mem) = 0;
   virtual void copy_from_device(device_memory &mem) = 0;
 
+  /* Copy memory from device on a dedicated transfer queue when the backend has one.
+   *
+   * The copy is ordered after all work enqueued on this queue so far, but kernels enqueued
+   * afterwards are free to overlap with the transfer. Wait for the copy with
+   * synchronize_transfer(); synchronize() does not cover it.
+   *
+   * Falls back to an in-order copy on the main queue for backends without a transfer queue. */
+  virtual void copy_from_device_async(device_memory &mem)
+  {
+    copy_from_device(mem);
+  }
+
+  /* Wait until all copies enqueued with copy_from_device_async() have finished execution.
+   * Return false if there was an error executing any of them. */
+  virtual bool synchronize_transfer()
+  {
+    return synchronize();
+  }
+
   /* Graphics resources interoperability.
    *
    * The interoperability comes here by the meaning that the device is capable of computing result
@@ -154,6 +173,30 @@ class DeviceQueue {
     return nullptr;
   }
 
+  /* Per-kernel execution timing.
+   *
+   * When enabled, the backend records timestamp events around each kernel launch and
+   * accumulates the execution time per kernel. The events are resolved as part of
+   * synchronize(), so enabling the timing does not serialize the queue. */
+
+  /* Whether the backend can time individual kernels with timestamp events. */
+  virtual bool supports_kernel_timing() const
+  {
+    return false;
+  }
+
+  virtual void set_kernel_timing_enabled(const bool enabled)
+  {
+    kernel_timing_enabled_ = enabled && supports_kernel_timing();
+  }
+
+  /* Accumulated execution time in seconds for every kernel enqueued since the queue was
+   * created, for the time the timing was enabled. */
+  const map<DeviceKernel, double> &kernel_times() const
+  {
+    return stats_time_per_kernel_;
+  }
+
   /* Device this queue has been created for. */
   Device *device = nullptr;
 
@@ -173,12 +216,25 @@ class DeviceQueue {
   void debug_synchronize();
   string debug_active_kernels();
 
+  /* Implementations call this when resolving their timestamp events.
+   * Also records the kernel onto the queue's trace track when tracing is enabled. */
+  void kernel_timing_add(DeviceKernel kernel, const double time);
+
   /* Combination of kernels enqueued together sync last synchronize. */
   DeviceKernelMask last_kernels_enqueued_ = {false};
   /* Time of synchronize call. */
   double last_sync_time_ = 0.0;
   /* Accumulated execution time for combinations of kernels launched together. */
   map<DeviceKernelMask, double> stats_kernel_time_;
+  /* Accumulated execution time per kernel, from timestamp events. */
+  map<DeviceKernel, double> stats_time_per_kernel_;
+  /* Whether timestamp events are recorded around kernel launches. */
+  bool kernel_timing_enabled_ = false;
+  /* Name of the queue's track in the trace file, and the end time of the latest event placed on
+   * it. Timestamp events only provide durations, so kernels are chained back to back on the
+   * track, ending no later than the time their timings were resolved. */
+  string trace_track_;
+  double trace_cursor_ = 0.0;
   /* If it is true, then a performance statistics in the debugging logs will have focus on kernels
    * and an explicit queue synchronization will be added after each kernel execution. */
   bool is_per_kernel_performance_ = false;
@@ -5,7 +5,7 @@
 #include "graph/node.h"
 #include "graph/node_type.h"
 
-#include "util/md5.h"
+#include "util/fasthash.h"
 #include "util/param.h"
 #include "util/transform.h"
 
@@ -575,121 +575,121 @@ bool Node::equals(const Node &other) const
 
 namespace {
 
-template<typename T> void value_hash(const Node *node, const SocketType &socket, MD5Hash &md5)
+template<typename T> void value_hash(const Node *node, const SocketType &socket, FastHash &hash)
 {
-  md5.append(((uint8_t *)node) + socket.struct_offset, socket.size());
+  hash.append(((uint8_t *)node) + socket.struct_offset, socket.size());
 }
 
-void float3_hash(const Node *node, const SocketType &socket, MD5Hash &md5)
+void float3_hash(const Node *node, const SocketType &socket, FastHash &hash)
 {
   /* Don't compare 4th element used for padding. */
-  md5.append(((uint8_t *)node) + socket.struct_offset, sizeof(float) * 3);
+  hash.append(((uint8_t *)node) + socket.struct_offset, sizeof(float) * 3);
 }
 
-template<typename T> void array_hash(const Node *node, const SocketType &socket, MD5Hash &md5)
+template<typename T> void array_hash(const Node *node, const SocketType &socket, FastHash &hash)
 {
   const array<T> &a = *(const array<T> *)(((char *)node) + socket.struct_offset);
   for (size_t i = 0; i < a.size(); i++) {
-    md5.append((uint8_t *)&a[i], sizeof(T));
+    hash.append((uint8_t *)&a[i], sizeof(T));
   }
 }
 
-void float3_array_hash(const Node *node, const SocketType &socket, MD5Hash &md5)
+void float3_array_hash(const Node *node, const SocketType &socket, FastHash &hash)
 {
   /* Don't compare 4th element used for padding. */
   const array<float3> &a = *(const array<float3> *)(((char *)node) + socket.struct_offset);
   for (size_t i = 0; i < a.size(); i++) {
-    md5.append((uint8_t *)&a[i], sizeof(float) * 3);
+    hash.append((uint8_t *)&a[i], sizeof(float) * 3);
   }
 }
 
 }  // namespace
 
-void Node::hash(MD5Hash &md5)
+void Node::hash(FastHash &hash)
 {
-  md5.append(type->name);
+  hash.append(type->name);
 
   for (const SocketType &socket : type->inputs) {
-    md5.append(socket.name);
+    hash.append(socket.name);
 
     switch (socket.type) {
       case SocketType::BOOLEAN:
-        value_hash<bool>(this, socket, md5);
+        value_hash<bool>(this, socket, hash);
         break;
       case SocketType::FLOAT:
-        value_hash<float>(this, socket, md5);
+        value_hash<float>(this, socket, hash);
         break;
       case SocketType::INT:
-        value_hash<int>(this, socket, md5);
+        value_hash<int>(this, socket, hash);
         break;
       case SocketType::UINT:
-        value_hash<uint>(this, socket, md5);
+        value_hash<uint>(this, socket, hash);
         break;
       case SocketType::UINT64:
-        value_hash<uint64_t>(this, socket, md5);
+        value_hash<uint64_t>(this, socket, hash);
         break;
       case SocketType::COLOR:
-        float3_hash(this, socket, md5);
+        float3_hash(this, socket, hash);
         break;
       case SocketType::VECTOR:
-        float3_hash(this, socket, md5);
+        float3_hash(this, socket, hash);
         break;
       case SocketType::POINT:
-        float3_hash(this, socket, md5);
+        float3_hash(this, socket, hash);
         break;
       case SocketType::NORMAL:
-        float3_hash(this, socket, md5);
+        float3_hash(this, socket, hash);
         break;
       case SocketType::POINT2:
-        value_hash<float2>(this, socket, md5);
+        value_hash<float2>(this, socket, hash);
         break;
       case SocketType::CLOSURE:
         break;
       case SocketType::STRING:
-        value_hash<string>(this, socket, md5);
+        value_hash<string>(this, socket, hash);
         break;
       case SocketType::ENUM:
-        value_hash<int>(this, socket, md5);
+        value_hash<int>(this, socket, hash);
         break;
       case SocketType::TRANSFORM:
-        value_hash<Transform>(this, socket, md5);
+        value_hash<Transform>(this, socket, hash);
         break;
       case SocketType::NODE:
-        value_hash<void *>(this, socket, md5);
+        value_hash<void *>(this, socket, hash);
         break;
 
       case SocketType::BOOLEAN_ARRAY:
-        array_hash<bool>(this, socket, md5);
+        array_hash<bool>(this, socket, hash);
         break;
       case SocketType::FLOAT_ARRAY:
-        array_hash<float>(this, socket, md5);
+        array_hash<float>(this, socket, hash);
         break;
       case SocketType::INT_ARRAY:
-        array_hash<int>(this, socket, md5);
+        array_hash<int>(this, socket, hash);
         break;
       case SocketType::COLOR_ARRAY:
-        float3_array_hash(this, socket, md5);
+        float3_array_hash(this, socket, hash);
         break;
       case SocketType::VECTOR_ARRAY:
-        float3_array_hash(this, socket, md5);
+        float3_array_hash(this, socket, hash);
         break;
       case SocketType::POINT_ARRAY:
-        float3_array_hash(this, socket, md5);
+        float3_array_hash(this, socket, hash);
         break;
       case SocketType::NORMAL_ARRAY:
-        float3_array_hash(this, socket, md5);
+        float3_array_hash(this, socket, hash);
         break;
       case SocketType::POINT2_ARRAY:
-        array_hash<float2>(this, socket, md5);
+        array_hash<float2>(this, socket, hash);
         break;
       case SocketType::STRING_ARRAY:
-        array_hash<string>(this, socket, md5);
+        array_hash<string>(this, socket, hash);
         break;
       case SocketType::TRANSFORM_ARRAY:
-        array_hash<Transform>(this, socket, md5);
+        array_hash<Transform>(this, socket, hash);
         break;
       case SocketType::NODE_ARRAY:
-        array_hash<void *>(this, socket, md5);
+        array_hash<void *>(this, socket, hash);
         break;
 
       case SocketType::UNDEFINED:
@@ -14,7 +14,7 @@
 
 namespace ccl {
 
-class MD5Hash;
+class FastHash;
 struct Node;
 struct NodeType;
 struct Transform;
@@ -158,7 +158,7 @@ struct Node {
   bool equals(const Node &other) const;
 
   /* compute hash of node and its socket values */
-  void hash(MD5Hash &md5);
+  void hash(FastHash &hash);
 
   /* Get total size of this node. */
   size_t get_total_size_in_bytes() const;
@@ -0,0 +1,398 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "graph/node_binary.h"
+#include "graph/node.h"
+
+#include "util/array.h"
+#include "util/transform.h"
+
+namespace ccl {
+
+/* Writer */
+
+void BinaryWriter::write(const void *data, const size_t size)
+{
+  if (size != 0 && fwrite(data, 1, size, file) != size) {
+    failed = true;
+  }
+}
+
+void BinaryWriter::write_u32(const uint32_t value)
+{
+  write(&value, sizeof(value));
+}
+
+void BinaryWriter::write_u64(const uint64_t value)
+{
+  write(&value, sizeof(value));
+}
+
+void BinaryWriter::write_s32(const int32_t value)
+{
+  write(&value, sizeof(value));
+}
+
+void BinaryWriter::write_string(const string &str)
+{
+  write_u32((uint32_t)str.size());
+  write(str.data(), str.size());
+}
+
+/* Reader */
+
+void BinaryReader::read(void *data, const size_t size)
+{
+  if (size != 0 && fread(data, 1, size, file) != size) {
+    failed = true;
+    memset(data, 0, size);
+  }
+}
+
+void BinaryReader::skip(const size_t size)
+{
+  if (size != 0 && fseek(file, (long)size, SEEK_CUR) != 0) {
+    failed = true;
+  }
+}
+
+uint32_t BinaryReader::read_u32()
+{
+  uint32_t value = 0;
+  read(&value, sizeof(value));
+  return value;
+}
+
+uint64_t BinaryReader::read_u64()
+{
+  uint64_t value = 0;
+  read(&value, sizeof(value));
+  return value;
+}
+
+int32_t BinaryReader::read_s32()
+{
+  int32_t value = 0;
+  read(&value, sizeof(value));
+  return value;
+}
+
+string BinaryReader::read_string()
+{
+  const uint32_t size = read_u32();
+  if (!good()) {
+    return string();
+  }
+
+  string str(size, '\0');
+  read(str.data(), size);
+  return str;
+}
+
+/* Node socket state */
+
+static bool socket_serializable(const SocketType &socket)
+{
+  if (socket.type == SocketType::CLOSURE || socket.type == SocketType::UNDEFINED) {
+    return false;
+  }
+  if (socket.flags & SocketType::INTERNAL) {
+    return false;
+  }
+  return true;
+}
+
+static const void *socket_value_ptr(const Node *node, const SocketType &socket)
+{
+  return ((const char *)node) + socket.struct_offset;
+}
+
+template<typename T>
+static void write_array_socket(BinaryWriter &writer, const Node *node, const SocketType &socket)
+{
+  const array<T> &value = *(const array<T> *)socket_value_ptr(node, socket);
+  writer.write_u64(value.size());
+  writer.write(value.data(), value.size() * sizeof(T));
+}
+
+template<typename T>
+static void read_array_socket(BinaryReader &reader, Node *node, const SocketType &socket)
+{
+  const uint64_t size = reader.read_u64();
+  array<T> value(size);
+  reader.read(value.data(), size * sizeof(T));
+  node->set(socket, value);
+}
+
+void binary_write_node(BinaryWriter &writer, const BinaryNodeMap &refs, Node *node)
+{
+  writer.write_string(node->name);
+
+  uint32_t num_sockets = 0;
+  for (const SocketType &socket : node->type->inputs) {
+    if (socket_serializable(socket)) {
+      num_sockets++;
+    }
+  }
+  writer.write_u32(num_sockets);
+
+  for (const SocketType &socket : node->type->inputs) {
+    if (!socket_serializable(socket)) {
+      continue;
+    }
+
+    writer.write_string(socket.name);
+
+    const void *value = socket_value_ptr(node, socket);
+
+    switch (socket.type) {
+      case SocketType::BOOLEAN:
+      case SocketType::FLOAT:
+      case SocketType::INT:
+      case SocketType::UINT:
+      case SocketType::UINT64:
+      case SocketType::COLOR:
+      case SocketType::VECTOR:
+      case SocketType::POINT:
+      case SocketType::NORMAL:
+      case SocketType::POINT2:
+      case SocketType::ENUM:
+      case SocketType::TRANSFORM:
+        writer.write_u64(socket.size());
+        writer.write(value, socket.size());
+        break;
+      case SocketType::STRING: {
+        const string &str = *(const string *)value;
+        writer.write_u64(sizeof(uint32_t) + str.size());
+        writer.write_string(str);
+        break;
+      }
+      case SocketType::NODE: {
+        writer.write_u64(sizeof(int32_t));
+        writer.write_s32(refs.index(*(const Node *const *)value));
+        break;
+      }
+      case SocketType::BOOLEAN_ARRAY:
+      case SocketType::FLOAT_ARRAY:
+      case SocketType::INT_ARRAY:
+      case SocketType::COLOR_ARRAY:
+      case SocketType::VECTOR_ARRAY:
+      case SocketType::POINT_ARRAY:
+      case SocketType::NORMAL_ARRAY:
+      case SocketType::POINT2_ARRAY:
+      case SocketType::TRANSFORM_ARRAY: {
+        switch (socket.type) {
+          case SocketType::BOOLEAN_ARRAY:
+            writer.write_u64(sizeof(uint64_t) +
+                             (*(const array<bool> *)value).size() * sizeof(bool));
+            write_array_socket<bool>(writer, node, socket);
+            break;
+          case SocketType::FLOAT_ARRAY:
+            writer.write_u64(sizeof(uint64_t) +
+                             (*(const array<float> *)value).size() * sizeof(float));
+            write_array_socket<float>(writer, node, socket);
+            break;
+          case SocketType::INT_ARRAY:
+            writer.write_u64(sizeof(uint64_t) + (*(const array<int> *)value).size() * sizeof(int));
+            write_array_socket<int>(writer, node, socket);
+            break;
+          case SocketType::COLOR_ARRAY:
+          case SocketType::VECTOR_ARRAY:
+          case SocketType::POINT_ARRAY:
+          case SocketType::NORMAL_ARRAY:
+            writer.write_u64(sizeof(uint64_t) +
+                             (*(const array<float3> *)value).size() * sizeof(float3));
+            write_array_socket<float3>(writer, node, socket);
+            break;
+          case SocketType::POINT2_ARRAY:
+            writer.write_u64(sizeof(uint64_t) +
+                             (*(const array<float2> *)value).size() * sizeof(float2));
+            write_array_socket<float2>(writer, node, socket);
+            break;
+          case SocketType::TRANSFORM_ARRAY:
+            writer.write_u64(sizeof(uint64_t) +
+                             (*(const array<Transform> *)value).size() * sizeof(Transform));
+            write_array_socket<Transform>(writer, node, socket);
+            break;
+          default:
+            break;
+        }
+        break;
+      }
+      case SocketType::STRING_ARRAY: {
+        const array<string> &value_array = *(const array<string> *)value;
+        uint64_t payload_size = sizeof(uint64_t);
+        for (const string &str : value_array) {
+          payload_size += sizeof(uint32_t) + str.size();
+        }
+        writer.write_u64(payload_size);
+        writer.write_u64(value_array.size());
+        for (const string &str : value_array) {
+          writer.write_string(str);
+        }
+        break;
+      }
+      case SocketType::NODE_ARRAY: {
+        const array<Node *> &value_array = *(const array<Node *> *)value;
+        writer.write_u64(sizeof(uint64_t) + value_array.size() * sizeof(int32_t));
+        writer.write_u64(value_array.size());
+        for (const Node *ref : value_array) {
+          writer.write_s32(refs.index(ref));
+        }
+        break;
+      }
+      case SocketType::CLOSURE:
+      case SocketType::UNDEFINED:
+      case SocketType::NUM_TYPES:
+        break;
+    }
+  }
+}
+
+void binary_read_node(BinaryReader &reader, const BinaryNodeMap &refs, Node *node)
+{
+  node->name = reader.read_string();
+
+  const uint32_t num_sockets = reader.read_u32();
+
+  for (uint32_t i = 0; i < num_sockets && reader.good(); i++) {
+    const string socket_name = reader.read_string();
+    const uint64_t payload_size = reader.read_u64();
+
+    const SocketType *socket = node->type->find_input(socket_name);
+    if (socket == nullptr || !socket_serializable(*socket)) {
+      reader.skip(payload_size);
+      continue;
+    }
+
+    switch (socket->type) {
+      case SocketType::BOOLEAN:
+      case SocketType::FLOAT:
+      case SocketType::INT:
+      case SocketType::UINT:
+      case SocketType::UINT64:
+      case SocketType::COLOR:
+      case SocketType::VECTOR:
+      case SocketType::POINT:
+      case SocketType::NORMAL:
+      case SocketType::POINT2:
+      case SocketType::ENUM:
+      case SocketType::TRANSFORM: {
+        if (payload_size != socket->size()) {
+          reader.skip(payload_size);
+          break;
+        }
+        switch (socket->type) {
+          case SocketType::BOOLEAN: {
+            bool value;
+            reader.read(&value, sizeof(value));
+            node->set(*socket, value);
+            break;
+          }
+          case SocketType::FLOAT: {
+            float value;
+            reader.read(&value, sizeof(value));
+            node->set(*socket, value);
+            break;
+          }
+          case SocketType::INT:
+          case SocketType::ENUM: {
+            int value;
+            reader.read(&value, sizeof(value));
+            node->set(*socket, value);
+            break;
+          }
+          case SocketType::UINT: {
+            uint value;
+            reader.read(&value, sizeof(value));
+            node->set(*socket, value);
+            break;
+          }
+          case SocketType::UINT64: {
+            uint64_t value;
+            reader.read(&value, sizeof(value));
+            node->set(*socket, value);
+            break;
+          }
+          case SocketType::COLOR:
+          case SocketType::VECTOR:
+          case SocketType::POINT:
+          case SocketType::NORMAL: {
+            float3 value;
+            reader.read(&value, sizeof(value));
+            node->set(*socket, value);
+            break;
+          }
+          case SocketType::POINT2: {
+            float2 value;
+            reader.read(&value, sizeof(value));
+            node->set(*socket, value);
+            break;
+          }
+          case SocketType::TRANSFORM: {
+            Transform value;
+            reader.read(&value, sizeof(value));
+            node->set(*socket, value);
+            break;
+          }
+          default:
+            break;
+        }
+        break;
+      }
+      case SocketType::STRING:
+        node->set(*socket, reader.read_string());
+        break;
+      case SocketType::NODE:
+        node->set(*socket, refs.resolve(reader.read_s32()));
+        break;
+      case SocketType::BOOLEAN_ARRAY:
+        read_array_socket<bool>(reader, node, *socket);
+        break;
+      case SocketType::FLOAT_ARRAY:
+        read_array_socket<float>(reader, node, *socket);
+        break;
+      case SocketType::INT_ARRAY:
+        read_array_socket<int>(reader, node, *socket);
+        break;
+      case SocketType::COLOR_ARRAY:
+      case SocketType::VECTOR_ARRAY:
+      case SocketType::POINT_ARRAY:
+      case SocketType::NORMAL_ARRAY:
+        read_array_socket<float3>(reader, node, *socket);
+        break;
+      case SocketType::POINT2_ARRAY:
+        read_array_socket<float2>(reader, node, *socket);
+        break;
+      case SocketType::TRANSFORM_ARRAY:
+        read_array_socket<Transform>(reader, node, *socket);
+        break;
+      case SocketType::STRING_ARRAY: {
+        const uint64_t size = reader.read_u64();
+        array<string> value(size);
+        for (uint64_t j = 0; j < size; j++) {
+          value[j] = reader.read_string();
+        }
+        node->set(*socket, value);
+        break;
+      }
+      case SocketType::NODE_ARRAY: {
+        const uint64_t size = reader.read_u64();
+        array<Node *> value(size);
+        for (uint64_t j = 0; j < size; j++) {
+          value[j] = refs.resolve(reader.read_s32());
+        }
+        node->set(*socket, value);
+        break;
+      }
+      case SocketType::CLOSURE:
+      case SocketType::UNDEFINED:
+      case SocketType::NUM_TYPES:
+        reader.skip(payload_size);
+        break;
+    }
+  }
+}
+
+}
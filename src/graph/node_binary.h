@@ -0,0 +1,90 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstdio>
+
+#include "util/map.h"
+#include "util/string.h"
+#include "util/vector.h"
+
+namespace ccl {
+
+struct Node;
+
+/* Binary serialization of node socket state, the counterpart of node_xml for
+ * the binary scene snapshot format. Values are written raw in the in-memory
+ * layout, prefixed with the socket name and payload size so readers can skip
+ * sockets they do not know. */
+
+/* Maps nodes to indices in the stream and back, for Node* socket references.
+ * The writer and reader must register nodes in the same order. */
+struct BinaryNodeMap {
+  map<const Node *, int> indices;
+  vector<Node *> nodes;
+
+  void add(Node *node)
+  {
+    indices[node] = (int)nodes.size();
+    nodes.push_back(node);
+  }
+
+  int index(const Node *node) const
+  {
+    const auto it = indices.find(node);
+    return (it == indices.end()) ? -1 : it->second;
+  }
+
+  Node *resolve(const int index) const
+  {
+    return (index >= 0 && index < (int)nodes.size()) ? nodes[index] : nullptr;
+  }
+};
+
+class BinaryWriter {
+ public:
+  explicit BinaryWriter(FILE *file) : file(file) {}
+
+  void write(const void *data, const size_t size);
+  void write_u32(const uint32_t value);
+  void write_u64(const uint64_t value);
+  void write_s32(const int32_t value);
+  void write_string(const string &str);
+
+  bool good() const
+  {
+    return !failed;
+  }
+
+ protected:
+  FILE *file;
+  bool failed = false;
+};
+
+class BinaryReader {
+ public:
+  explicit BinaryReader(FILE *file) : file(file) {}
+
+  void read(void *data, const size_t size);
+  void skip(const size_t size);
+  uint32_t read_u32();
+  uint64_t read_u64();
+  int32_t read_s32();
+  string read_string();
+
+  bool good() const
+  {
+    return !failed;
+  }
+
+ protected:
+  FILE *file;
+  bool failed = false;
+};
+
+void binary_write_node(BinaryWriter &writer, const BinaryNodeMap &refs, Node *node);
+void binary_read_node(BinaryReader &reader, const BinaryNodeMap &refs, Node *node);
+
+}
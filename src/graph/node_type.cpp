@@ -136,6 +136,8 @@ NodeType::NodeType(Type type, const NodeType *base) : type(type), base(base)
     /* Inherit sockets. */
     inputs = base->inputs;
     outputs = base->outputs;
+    input_index = base->input_index;
+    output_index = base->output_index;
   }
 }
 
@@ -162,6 +164,8 @@ void NodeType::register_input(string name,
   socket.flags = flags | extra_flags;
   assert(inputs.size() < std::numeric_limits<SocketModifiedFlags>::digits);
   socket.modified_flag_bit = (1ull << inputs.size());
+  /* emplace keeps the first entry on duplicate names, matching the linear scan. */
+  input_index.emplace(socket.name, (int)inputs.size());
   inputs.push_back(socket);
 }
 
@@ -176,29 +180,20 @@ void NodeType::register_output(string name, string ui_name, SocketType::Type typ
   socket.enum_values = nullptr;
   socket.node_type = nullptr;
   socket.flags = SocketType::LINKABLE;
+  output_index.emplace(socket.name, (int)outputs.size());
   outputs.push_back(socket);
 }
 
 const SocketType *NodeType::find_input(string name) const
 {
-  for (const SocketType &socket : inputs) {
-    if (socket.name == name) {
-      return &socket;
-    }
-  }
-
-  return nullptr;
+  const unordered_map<string, int>::const_iterator it = input_index.find(name);
+  return (it == input_index.end()) ? nullptr : &inputs[it->second];
 }
 
 const SocketType *NodeType::find_output(string name) const
 {
-  for (const SocketType &socket : outputs) {
-    if (socket.name == name) {
-      return &socket;
-    }
-  }
-
-  return nullptr;
+  const unordered_map<string, int>::const_iterator it = output_index.find(name);
+  return (it == output_index.end()) ? nullptr : &outputs[it->second];
 }
 
 /* Node Type Registry */
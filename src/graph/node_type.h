@@ -126,6 +126,11 @@ struct NodeType {
   vector<SocketType, std::allocator<SocketType>> outputs;
   CreateFunc create;
 
+  /* Indices into the socket arrays keyed by socket name, built at registration
+   * so per-socket lookups during scene load do not scan the arrays linearly. */
+  unordered_map<string, int> input_index;
+  unordered_map<string, int> output_index;
+
   static NodeType *add(const char *name,
                        CreateFunc create,
                        Type type = NONE,
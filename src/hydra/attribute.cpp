@@ -5,6 +5,7 @@
 
 #include "hydra/attribute.h"
 #include "scene/attribute.h"
+#include "util/tbb.h"
 
 #include <pxr/base/gf/vec2f.h>
 #include <pxr/base/gf/vec3f.h>
@@ -41,12 +42,16 @@ void ApplyPrimvars(AttributeSet &attributes,
       size *= sizeof(float3);
       // The Cycles "float3" data type is padded to "float4", so need to convert the array
       const auto &valueData = value.Get<VtVec3fArray>();
-      VtArray<float3> valueConverted;
-      valueConverted.reserve(valueData.size());
-      for (const GfVec3f &vec : valueData) {
-        valueConverted.push_back(make_float3(vec[0], vec[1], vec[2]));
-      }
-      data = valueConverted.data();
+      VtArray<float3> valueConverted(valueData.size());
+      float3 *const convertedData = valueConverted.data();
+      parallel_for(blocked_range<size_t>(0, valueData.size(), 64 * 1024),
+                   [&valueData, convertedData](const blocked_range<size_t> &range) {
+                     for (size_t i = range.begin(); i != range.end(); ++i) {
+                       const GfVec3f &vec = valueData[i];
+                       convertedData[i] = make_float3(vec[0], vec[1], vec[2]);
+                     }
+                   });
+      data = convertedData;
       value = std::move(valueConverted);
       break;
     }
@@ -60,11 +65,22 @@ void ApplyPrimvars(AttributeSet &attributes,
       return;
   }
 
-  Attribute *const attr = attributes.add(name, attrType, elem);
+  // Reuse the existing attribute storage when the layout is unchanged, so
+  // primvar-only edits ride the narrow per-attribute data update instead of
+  // reallocating the device attribute arrays
+  Attribute *attr = attributes.add(name, attrType, elem);
+  if (attr->buffer.size() != size) {
+    // Element count changed without a topology rebuild
+    attributes.remove(attr);
+    attr = attributes.add(name, attrType, elem);
+  }
   attr->std = std;
 
   assert(size == attr->buffer.size());
   std::memcpy(attr->data(), data, size);
+  // Tag explicitly, since writing into an existing attribute does not toggle
+  // any geometry socket and would otherwise never be uploaded
+  attr->modified = true;
 }
 
 HDCYCLES_NAMESPACE_CLOSE_SCOPE
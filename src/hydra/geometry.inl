@@ -8,9 +8,11 @@
 #include "hydra/material.h"
 #include "hydra/session.h"
 #include "scene/geometry.h"
+#include "scene/mesh.h"
 #include "scene/object.h"
 #include "scene/scene.h"
 #include "util/hash.h"
+#include "util/tbb.h"
 
 #include <pxr/imaging/hd/sceneDelegate.h>
 
@@ -18,6 +20,22 @@ HDCYCLES_NAMESPACE_OPEN_SCOPE
 
 extern Transform convert_transform(const GfMatrix4d &matrix);
 
+namespace {
+
+// Check whether any attribute data was written in place, which does not
+// toggle a geometry socket and so is not covered by Node::is_modified
+inline bool AttributesModified(const Geometry &geom)
+{
+  return geom.attributes.modified();
+}
+
+inline bool AttributesModified(const Mesh &mesh)
+{
+  return mesh.attributes.modified() || mesh.subd_attributes.modified();
+}
+
+}  // namespace
+
 template<typename Base, typename CyclesBase>
 HdCyclesGeometry<Base, CyclesBase>::HdCyclesGeometry(const SdfPath &rprimId
 #if PXR_VERSION < 2102
@@ -78,108 +96,121 @@ void HdCyclesGeometry<Base, CyclesBase>::Sync(HdSceneDelegate *sceneDelegate,
 #endif
   Base::_UpdateVisibility(sceneDelegate, dirtyBits);
 
-  const SceneLock lock(renderParam);
+  {
+    const SceneLock lock(renderParam);
 
-  if (*dirtyBits & HdChangeTracker::DirtyMaterialId) {
+    if (*dirtyBits & HdChangeTracker::DirtyMaterialId) {
 #if HD_API_VERSION >= 37 && PXR_VERSION >= 2105
-    Base::SetMaterialId(sceneDelegate->GetMaterialId(Base::GetId()));
+      Base::SetMaterialId(sceneDelegate->GetMaterialId(Base::GetId()));
 #else
-    Base::_SetMaterialId(sceneDelegate->GetRenderIndex().GetChangeTracker(),
-                         sceneDelegate->GetMaterialId(Base::GetId()));
+      Base::_SetMaterialId(sceneDelegate->GetRenderIndex().GetChangeTracker(),
+                           sceneDelegate->GetMaterialId(Base::GetId()));
 #endif
 
-    const auto *const material = static_cast<const HdCyclesMaterial *>(
-        sceneDelegate->GetRenderIndex().GetSprim(HdPrimTypeTokens->material,
-                                                 Base::GetMaterialId()));
+      const auto *const material = static_cast<const HdCyclesMaterial *>(
+          sceneDelegate->GetRenderIndex().GetSprim(HdPrimTypeTokens->material,
+                                                   Base::GetMaterialId()));
 
-    array<Node *> usedShaders(1);
-    if (material && material->GetCyclesShader()) {
-      usedShaders[0] = material->GetCyclesShader();
-    }
-    else {
-      usedShaders[0] = lock.scene->default_surface;
-    }
+      array<Node *> usedShaders(1);
+      if (material && material->GetCyclesShader()) {
+        usedShaders[0] = material->GetCyclesShader();
+      }
+      else {
+        usedShaders[0] = lock.scene->default_surface;
+      }
 
-    for (Node *shader : usedShaders) {
-      static_cast<Shader *>(shader)->tag_used(lock.scene);
-    }
+      for (Node *shader : usedShaders) {
+        static_cast<Shader *>(shader)->tag_used(lock.scene);
+      }
 
-    _geom->set_used_shaders(usedShaders);
-  }
+      _geom->set_used_shaders(usedShaders);
+    }
 
-  const SdfPath &id = Base::GetId();
+    const SdfPath &id = Base::GetId();
 
-  if (HdChangeTracker::IsPrimIdDirty(*dirtyBits, id)) {
-    // This needs to be corrected in the AOV
-    _instances[0]->set_pass_id(Base::GetPrimId() + 1);
-  }
+    if (HdChangeTracker::IsPrimIdDirty(*dirtyBits, id)) {
+      // This needs to be corrected in the AOV
+      _instances[0]->set_pass_id(Base::GetPrimId() + 1);
+    }
 
-  if (HdChangeTracker::IsTransformDirty(*dirtyBits, id)) {
-    _geomTransform = sceneDelegate->GetTransform(id);
-  }
+    if (HdChangeTracker::IsTransformDirty(*dirtyBits, id)) {
+      _geomTransform = sceneDelegate->GetTransform(id);
+    }
 
-  if (HdChangeTracker::IsTransformDirty(*dirtyBits, id) ||
-      HdChangeTracker::IsInstancerDirty(*dirtyBits, id))
-  {
-    auto *const instancer = static_cast<HdCyclesInstancer *>(
-        sceneDelegate->GetRenderIndex().GetInstancer(Base::GetInstancerId()));
+    if (HdChangeTracker::IsTransformDirty(*dirtyBits, id) ||
+        HdChangeTracker::IsInstancerDirty(*dirtyBits, id))
+    {
+      auto *const instancer = static_cast<HdCyclesInstancer *>(
+          sceneDelegate->GetRenderIndex().GetInstancer(Base::GetInstancerId()));
 
-    // Make sure the first object attribute is the instanceId
-    assert(_instances[0]->attributes.size() >= 1 &&
-           _instances[0]->attributes.front().name() == HdAovTokens->instanceId.GetString());
+      // Make sure the first object attribute is the instanceId
+      assert(_instances[0]->attributes.size() >= 1 &&
+             _instances[0]->attributes.front().name() == HdAovTokens->instanceId.GetString());
 
-    VtMatrix4dArray transforms;
-    if (instancer) {
-      transforms = instancer->ComputeInstanceTransforms(id);
-      _instances[0]->attributes.front() = ParamValue(HdAovTokens->instanceId.GetString(), +0.0f);
-    }
-    else {
-      // Default to a single instance with an identity transform
-      transforms.push_back(GfMatrix4d(1.0));
-      _instances[0]->attributes.front() = ParamValue(HdAovTokens->instanceId.GetString(), -1.0f);
-    }
+      VtMatrix4dArray transforms;
+      if (instancer) {
+        transforms = instancer->ComputeInstanceTransforms(id);
+        _instances[0]->attributes.front() = ParamValue(HdAovTokens->instanceId.GetString(), +0.0f);
+      }
+      else {
+        // Default to a single instance with an identity transform
+        transforms.push_back(GfMatrix4d(1.0));
+        _instances[0]->attributes.front() = ParamValue(HdAovTokens->instanceId.GetString(), -1.0f);
+      }
 
-    const size_t oldSize = _instances.size();
-    const size_t newSize = transforms.size();
+      const size_t oldSize = _instances.size();
+      const size_t newSize = transforms.size();
 
-    // Resize instance list
-    for (size_t i = newSize; i < oldSize; ++i) {
-      lock.scene->delete_node(_instances[i]);
-    }
-    _instances.resize(newSize);
-    for (size_t i = oldSize; i < newSize; ++i) {
-      _instances[i] = lock.scene->create_node<Object>();
-      InitializeInstance(static_cast<int>(i));
-    }
+      // Resize instance list
+      for (size_t i = newSize; i < oldSize; ++i) {
+        lock.scene->delete_node(_instances[i]);
+      }
+      _instances.resize(newSize);
+      for (size_t i = oldSize; i < newSize; ++i) {
+        _instances[i] = lock.scene->create_node<Object>();
+        InitializeInstance(static_cast<int>(i));
+      }
 
-    // Update transforms of all instances
-    for (size_t i = 0; i < transforms.size(); ++i) {
+      // Update transforms of all instances. Each instance is a distinct
+      // object node, so this can run chunked over the task pool.
       const float metersPerUnit =
           static_cast<HdCyclesSession *>(renderParam)->GetStageMetersPerUnit();
-
-      const Transform tfm = transform_scale(make_float3(metersPerUnit)) *
-                            convert_transform(_geomTransform * transforms[i]);
-      _instances[i]->set_tfm(tfm);
+      const Transform unitTransform = transform_scale(make_float3(metersPerUnit));
+
+      parallel_for(blocked_range<size_t>(0, transforms.size(), 1024),
+                   [&](const blocked_range<size_t> &range) {
+                     for (size_t i = range.begin(); i != range.end(); ++i) {
+                       const Transform tfm = unitTransform *
+                                             convert_transform(_geomTransform * transforms[i]);
+                       _instances[i]->set_tfm(tfm);
+                     }
+                   });
     }
-  }
 
-  if (HdChangeTracker::IsVisibilityDirty(*dirtyBits, id)) {
-    for (Object *instance : _instances) {
-      instance->set_visibility(Base::IsVisible() ? ~0 : 0);
+    if (HdChangeTracker::IsVisibilityDirty(*dirtyBits, id)) {
+      for (Object *instance : _instances) {
+        instance->set_visibility(Base::IsVisible() ? ~0 : 0);
+      }
     }
   }
 
   // Must happen after material ID update, so that attribute decisions can be made
-  // based on it (e.g. check whether an attribute is actually needed)
+  // based on it (e.g. check whether an attribute is actually needed).
+  // Runs outside the scene lock: the conversion only touches this prim's
+  // geometry, and Hydra delivers prims from multiple threads.
   bool rebuild = false;
   Populate(sceneDelegate, *dirtyBits, rebuild);
 
-  if (_geom->is_modified() || rebuild) {
-    _geom->tag_update(lock.scene, rebuild);
-  }
+  {
+    const SceneLock lock(renderParam);
+
+    if (_geom->is_modified() || rebuild || AttributesModified(*_geom)) {
+      _geom->tag_update(lock.scene, rebuild);
+    }
 
-  for (Object *instance : _instances) {
-    instance->tag_update(lock.scene);
+    for (Object *instance : _instances) {
+      instance->tag_update(lock.scene);
+    }
   }
 
   *dirtyBits = HdChangeTracker::Clean;
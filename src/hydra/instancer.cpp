@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0 */
 
 #include "hydra/instancer.h"
+#include "util/tbb.h"
 
 #include <pxr/base/gf/quatd.h>
 #include <pxr/imaging/hd/sceneDelegate.h>
@@ -101,48 +102,64 @@ VtMatrix4dArray HdCyclesInstancer::ComputeInstanceTransforms(const SdfPath &prot
   const VtIntArray instanceIndices = GetDelegate()->GetInstanceIndices(GetId(), prototypeId);
   const GfMatrix4d instanceTransform = GetDelegate()->GetInstancerTransform(GetId());
 
-  VtMatrix4dArray transforms;
-  transforms.reserve(instanceIndices.size());
-
-  for (const int index : instanceIndices) {
-    GfMatrix4d transform = instanceTransform;
-
-    if (index < _translate.size()) {
-      GfMatrix4d translateMat(1);
-      translateMat.SetTranslate(_translate[index]);
-      transform *= translateMat;
-    }
-
-    if (index < _rotate.size()) {
-      GfMatrix4d rotateMat(1);
-      const GfVec4f &quat = _rotate[index];
-      rotateMat.SetRotate(GfQuatd(quat[0], quat[1], quat[2], quat[3]));
-      transform *= rotateMat;
-    }
-
-    if (index < _scale.size()) {
-      GfMatrix4d scaleMat(1);
-      scaleMat.SetScale(_scale[index]);
-      transform *= scaleMat;
-    }
-
-    if (index < _instanceTransform.size()) {
-      transform *= _instanceTransform[index];
-    }
-
-    transforms.push_back(transform);
-  }
+  // Composing millions of point instance transforms dominates sync time for
+  // large stages, so it runs chunked over the task pool into a preallocated
+  // array instead of appending serially.
+  VtMatrix4dArray transforms(instanceIndices.size());
+  GfMatrix4d *const transformsData = transforms.data();
+
+  parallel_for(blocked_range<size_t>(0, instanceIndices.size(), 1024),
+               [&](const blocked_range<size_t> &range) {
+                 for (size_t i = range.begin(); i != range.end(); ++i) {
+                   const int index = instanceIndices[i];
+                   GfMatrix4d transform = instanceTransform;
+
+                   if (index < _translate.size()) {
+                     GfMatrix4d translateMat(1);
+                     translateMat.SetTranslate(_translate[index]);
+                     transform *= translateMat;
+                   }
+
+                   if (index < _rotate.size()) {
+                     GfMatrix4d rotateMat(1);
+                     const GfVec4f &quat = _rotate[index];
+                     rotateMat.SetRotate(GfQuatd(quat[0], quat[1], quat[2], quat[3]));
+                     transform *= rotateMat;
+                   }
+
+                   if (index < _scale.size()) {
+                     GfMatrix4d scaleMat(1);
+                     scaleMat.SetScale(_scale[index]);
+                     transform *= scaleMat;
+                   }
+
+                   if (index < _instanceTransform.size()) {
+                     transform *= _instanceTransform[index];
+                   }
+
+                   transformsData[i] = transform;
+                 }
+               });
 
   VtMatrix4dArray resultTransforms;
 
   if (auto *const instancer = static_cast<HdCyclesInstancer *>(
           GetDelegate()->GetRenderIndex().GetInstancer(GetParentId())))
   {
-    for (const GfMatrix4d &parentTransform : instancer->ComputeInstanceTransforms(GetId())) {
-      for (const GfMatrix4d &localTransform : transforms) {
-        resultTransforms.push_back(parentTransform * localTransform);
-      }
-    }
+    const VtMatrix4dArray parentTransforms = instancer->ComputeInstanceTransforms(GetId());
+
+    resultTransforms.resize(parentTransforms.size() * transforms.size());
+    GfMatrix4d *const resultData = resultTransforms.data();
+
+    parallel_for(blocked_range<size_t>(0, parentTransforms.size(), 1),
+                 [&](const blocked_range<size_t> &range) {
+                   for (size_t i = range.begin(); i != range.end(); ++i) {
+                     for (size_t j = 0; j < transforms.size(); ++j) {
+                       resultData[i * transforms.size() + j] = parentTransforms[i] *
+                                                               transformsData[j];
+                     }
+                   }
+                 });
   }
   else {
     resultTransforms = std::move(transforms);
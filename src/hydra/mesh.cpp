@@ -111,8 +111,12 @@ HdDirtyBits HdCyclesMesh::GetInitialDirtyBitsMask() const
 HdDirtyBits HdCyclesMesh::_PropagateDirtyBits(HdDirtyBits bits) const
 {
   if (bits & (HdChangeTracker::DirtyMaterialId)) {
-    // Update used shaders from geometry subsets if any exist in the topology
-    bits |= HdChangeTracker::DirtyTopology;
+    // Geometry subsets bake per-face shader indices into the topology arrays, so
+    // material changes only require a topology update when subsets are present.
+    // Otherwise the material is rebound through the used shaders array alone.
+    if (!_topology.GetGeomSubsets().empty()) {
+      bits |= HdChangeTracker::DirtyTopology;
+    }
   }
 
   if (bits & (HdChangeTracker::DirtyTopology | HdChangeTracker::DirtyDisplayStyle |
@@ -199,10 +203,9 @@ void HdCyclesMesh::PopulatePoints(HdSceneDelegate *sceneDelegate)
 
 void HdCyclesMesh::PopulateNormals(HdSceneDelegate *sceneDelegate)
 {
-  _geom->attributes.remove(ATTR_STD_VERTEX_NORMAL);
-
   // Authored normals should only exist on triangle meshes
   if (_geom->get_subdivision_type() != Mesh::SUBDIVISION_NONE) {
+    _geom->attributes.remove(ATTR_STD_VERTEX_NORMAL);
     return;
   }
 
@@ -229,6 +232,7 @@ void HdCyclesMesh::PopulateNormals(HdSceneDelegate *sceneDelegate)
   if (value.IsEmpty()) {
     interpolation = GetPrimvarInterpolation(sceneDelegate, HdTokens->normals);
     if (interpolation == HdInterpolationCount) {
+      _geom->attributes.remove(ATTR_STD_VERTEX_NORMAL);
       return;  // Ignore missing normals
     }
 
@@ -237,17 +241,35 @@ void HdCyclesMesh::PopulateNormals(HdSceneDelegate *sceneDelegate)
 
   if (!value.IsHolding<VtVec3fArray>()) {
     TF_WARN("Invalid normals data for %s", GetId().GetText());
+    _geom->attributes.remove(ATTR_STD_VERTEX_NORMAL);
     return;
   }
 
   const auto &normals = value.UncheckedGet<VtVec3fArray>();
 
+  // Reuse the existing attribute storage when the vertex count is unchanged,
+  // so normal-only edits are uploaded in place instead of reallocating
+  const auto addVertexNormalAttribute = [this]() -> Attribute * {
+    Attribute *attr = _geom->attributes.find(ATTR_STD_VERTEX_NORMAL);
+    if (attr &&
+        attr->buffer.size() != attr->data_sizeof() * _geom->get_verts().size())
+    {
+      _geom->attributes.remove(ATTR_STD_VERTEX_NORMAL);
+      attr = nullptr;
+    }
+    if (!attr) {
+      attr = _geom->attributes.add(ATTR_STD_VERTEX_NORMAL);
+    }
+    attr->modified = true;
+    return attr;
+  };
+
   if (interpolation == HdInterpolationConstant) {
     TF_VERIFY(normals.size() == 1);
 
     const GfVec3f constantNormal = normals[0];
 
-    float3 *const N = _geom->attributes.add(ATTR_STD_VERTEX_NORMAL)->data_float3();
+    float3 *const N = addVertexNormalAttribute()->data_float3();
     for (size_t i = 0; i < _geom->get_verts().size(); ++i) {
       N[i] = make_float3(constantNormal[0], constantNormal[1], constantNormal[2]);
     }
@@ -255,18 +277,20 @@ void HdCyclesMesh::PopulateNormals(HdSceneDelegate *sceneDelegate)
   else if (interpolation == HdInterpolationUniform) {
     TF_VERIFY(normals.size() == static_cast<size_t>(_topology.GetNumFaces()));
     /* Nothing to do, face normals are computed on demand in the kernel. */
+    _geom->attributes.remove(ATTR_STD_VERTEX_NORMAL);
   }
   else if (interpolation == HdInterpolationVertex || interpolation == HdInterpolationVarying) {
     TF_VERIFY(normals.size() == static_cast<size_t>(_topology.GetNumPoints()) &&
               static_cast<size_t>(_topology.GetNumPoints()) == _geom->get_verts().size());
 
-    float3 *const N = _geom->attributes.add(ATTR_STD_VERTEX_NORMAL)->data_float3();
+    float3 *const N = addVertexNormalAttribute()->data_float3();
     for (size_t i = 0; i < _geom->get_verts().size(); ++i) {
       N[i] = make_float3(normals[i][0], normals[i][1], normals[i][2]);
     }
   }
   else if (interpolation == HdInterpolationFaceVarying) {
     TF_VERIFY(normals.size() == static_cast<size_t>(_topology.GetNumFaceVaryings()));
+    _geom->attributes.remove(ATTR_STD_VERTEX_NORMAL);
 
     // TODO: Cycles has no per-corner normals, so ignore until supported.
 #if 0
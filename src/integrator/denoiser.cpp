@@ -41,12 +41,22 @@ static bool is_single_device(const Device *device)
 }
 
 /* Find best suitable device to perform denoiser on. Will iterate over possible sub-devices of
- * multi-device. */
+ * multi-device.
+ *
+ * On multi-GPU configurations the first GPU is treated as the primary render device, and
+ * denoising is steered to a secondary GPU when one supports the denoiser: the denoiser input is
+ * a buffer copy that is denoised asynchronously, so a secondary device overlaps denoising with
+ * path tracing on the primary instead of interrupting it. */
 static Device *find_best_device(Device *device, const DenoiserType type)
 {
   Device *best_device = nullptr;
+  Device *first_gpu = nullptr;
 
   device->foreach_device([&](Device *sub_device) {
+    if (sub_device->info.type != DEVICE_CPU && !first_gpu) {
+      first_gpu = sub_device;
+    }
+
     if ((sub_device->info.denoisers & type) == 0) {
       return;
     }
@@ -60,8 +70,15 @@ static Device *find_best_device(Device *device, const DenoiserType type)
         best_device = sub_device;
       }
 
-      /* Prefer a device that can use graphics interop for faster display update. */
-      if (sub_device->should_use_graphics_interop() && !best_device->should_use_graphics_interop())
+      /* Prefer a secondary GPU over the primary render GPU. */
+      if (sub_device->info.type != DEVICE_CPU && best_device == first_gpu) {
+        best_device = sub_device;
+      }
+
+      /* Prefer a device that can use graphics interop for faster display update, unless that
+       * means pulling denoising back onto the primary. */
+      if (sub_device != first_gpu && sub_device->should_use_graphics_interop() &&
+          !best_device->should_use_graphics_interop())
       {
         best_device = sub_device;
       }
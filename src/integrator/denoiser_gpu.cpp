@@ -256,26 +256,6 @@ bool DenoiserGPU::denoise_filter_color_postprocess(const DenoiseContext &context
   return denoiser_queue_->enqueue(DEVICE_KERNEL_FILTER_COLOR_POSTPROCESS, work_size, args);
 }
 
-bool DenoiserGPU::denoise_filter_color_preprocess(const DenoiseContext &context,
-                                                  const DenoisePass &pass)
-{
-  const BufferParams &buffer_params = context.buffer_params;
-
-  const int work_size = buffer_params.width * buffer_params.height;
-
-  const DeviceKernelArguments args(&context.render_buffers->buffer.device_pointer,
-                                   &buffer_params.full_x,
-                                   &buffer_params.full_y,
-                                   &buffer_params.width,
-                                   &buffer_params.height,
-                                   &buffer_params.offset,
-                                   &buffer_params.stride,
-                                   &buffer_params.pass_stride,
-                                   &pass.denoised_offset);
-
-  return denoiser_queue_->enqueue(DEVICE_KERNEL_FILTER_COLOR_PREPROCESS, work_size, args);
-}
-
 bool DenoiserGPU::denoise_filter_guiding_set_fake_albedo(const DenoiseContext &context)
 {
   const BufferParams &buffer_params = context.buffer_params;
@@ -305,6 +285,11 @@ void DenoiserGPU::denoise_color_read(const DenoiseContext &context, const Denois
   pass_access_info.use_approximate_shadow_catcher_background = false;
   pass_access_info.show_active_pixels = false;
 
+  /* Denoisers do not cope well with infinities and extremely large values which fireflies can
+   * produce, so clamp the color input as part of the conversion instead of running a separate
+   * full-buffer kernel over the freshly written pixels. */
+  pass_access_info.clamp_max = 10000.0f;
+
   /* TODO(sergey): Consider adding support of actual exposure, to avoid clamping in extreme cases.
    */
   const PassAccessorGPU pass_accessor(
@@ -323,6 +308,10 @@ void DenoiserGPU::denoise_color_read(const DenoiseContext &context, const Denois
   buffer_params.window_height = buffer_params.height;
 
   pass_accessor.get_render_tile_pixels(context.render_buffers, buffer_params, destination);
+
+  /* The conversion kernels are asynchronous, make sure they finished before the denoiser runs on
+   * their output. */
+  denoiser_queue_->synchronize();
 }
 
 void DenoiserGPU::denoise_pass(DenoiseContext &context, PassType pass_type)
@@ -353,12 +342,9 @@ void DenoiserGPU::denoise_pass(DenoiseContext &context, PassType pass_type)
     }
   }
 
-  /* Read and preprocess noisy color input pass. */
+  /* Read noisy color input pass, clamped to the range the denoiser can deal with as part of the
+   * conversion. */
   denoise_color_read(context, pass);
-  if (!denoise_filter_color_preprocess(context, pass)) {
-    LOG(ERROR) << "Error converting denoising passes to RGB buffer.";
-    return;
-  }
 
   if (!denoise_run(context, pass)) {
     LOG(ERROR) << "Error running denoiser.";
@@ -59,13 +59,12 @@ class DenoiserGPU : public Denoiser {
   virtual bool denoise_configure_if_needed(DenoiseContext &context) = 0;
 
   /* Read input color pass from the render buffer into the memory which corresponds to the noisy
-   * input within the given context. Pixels are scaled to the number of samples, but are not
-   * preprocessed yet. */
+   * input within the given context. Pixels are scaled to the number of samples and clamped to the
+   * range the denoiser supports as part of the conversion. */
   void denoise_color_read(const DenoiseContext &context, const DenoisePass &pass);
 
   /* Run corresponding filter kernels, preparing data for the denoiser or copying data from the
    * denoiser result to the render buffer. */
-  bool denoise_filter_color_preprocess(const DenoiseContext &context, const DenoisePass &pass);
   bool denoise_filter_color_postprocess(const DenoiseContext &context, const DenoisePass &pass);
   bool denoise_filter_guiding_set_fake_albedo(const DenoiseContext &context);
 
@@ -14,6 +14,8 @@
 #include "util/log.h"
 #include "util/openimagedenoise.h"
 #include "util/path.h"
+#include "util/task.h"
+#include "util/tbb.h"
 
 namespace ccl {
 
@@ -164,9 +166,7 @@ class OIDNDenoiseContext {
 
     OIDNPass oidn_color_access_pass = read_input_pass(oidn_color_pass, oidn_output_pass);
 
-    oidn::DeviceRef oidn_device = oidn::newDevice(oidn::DeviceType::CPU);
-    oidn_device.set("setAffinity", false);
-    oidn_device.commit();
+    oidn::DeviceRef &oidn_device = get_oidn_device();
 
     /* Create a filter for denoising a beauty (color) image using prefiltered auxiliary images too.
      */
@@ -193,7 +193,7 @@ class OIDNDenoiseContext {
     filter_guiding_pass_if_needed(oidn_device, oidn_normal_pass_);
 
     /* Filter the beauty image. */
-    oidn_filter.execute();
+    execute_filter(oidn_filter);
 
     /* Check for errors. */
     const char *error_message;
@@ -206,6 +206,29 @@ class OIDNDenoiseContext {
   }
 
  protected:
+  /* Get the OIDN device, creating it on first use.
+   *
+   * The device is configured to use at most as many threads as the Cycles task scheduler, and to
+   * not pin them to specific cores. Without this OIDN spawns a full-size thread pool of its own,
+   * which oversubscribes the cores when path tracing and denoising interleave. */
+  oidn::DeviceRef &get_oidn_device()
+  {
+    if (!oidn_device_) {
+      oidn_device_ = oidn::newDevice(oidn::DeviceType::CPU);
+      oidn_device_.set("setAffinity", false);
+      oidn_device_.set("numThreads", TaskScheduler::max_concurrency());
+      oidn_device_.commit();
+    }
+    return oidn_device_;
+  }
+
+  /* Execute the filter in an isolated region, so that the calling thread does not pick up
+   * unrelated Cycles tasks from the shared scheduler while waiting for the filter to finish. */
+  void execute_filter(oidn::FilterRef &oidn_filter)
+  {
+    tbb::this_task_arena::isolate([&] { oidn_filter.execute(); });
+  }
+
   void filter_guiding_pass_if_needed(oidn::DeviceRef &oidn_device, OIDNPass &oidn_pass)
   {
     if (denoise_params_.prefilter != DENOISER_PREFILTER_ACCURATE || !oidn_pass ||
@@ -219,7 +242,7 @@ class OIDNDenoiseContext {
     set_output_pass(oidn_filter, oidn_pass);
     set_quality(oidn_filter);
     oidn_filter.commit();
-    oidn_filter.execute();
+    execute_filter(oidn_filter);
 
     oidn_pass.is_filtered = true;
   }
@@ -564,6 +587,9 @@ class OIDNDenoiseContext {
 
   vector<uint8_t> custom_weights;
 
+  /* Device shared by all filters of this context, created on first use. */
+  oidn::DeviceRef oidn_device_;
+
   /* Optional albedo and normal passes, reused by denoising of different pass types. */
   OIDNPass oidn_albedo_pass_;
   OIDNPass oidn_normal_pass_;
@@ -0,0 +1,146 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "integrator/guiding.h"
+
+#include "util/log.h"
+
+namespace ccl {
+
+#ifdef WITH_PATH_GUIDING
+
+GuidingFieldTrainer::GuidingFieldTrainer(unique_ptr<openpgl::cpp::Field> field_a,
+                                         unique_ptr<openpgl::cpp::Field> field_b)
+{
+  front_.field = std::move(field_a);
+  back_.field = std::move(field_b);
+
+  /* Fields loaded from a cache file come pre-trained. Count their stored iterations as consumed
+   * batches, so that warm-started renders continue training where the previous one stopped
+   * rather than starting the training budget over. */
+  const int num_batches = (int)front_.field->GetIteration();
+  front_.num_batches_consumed = num_batches;
+  back_.num_batches_consumed = num_batches;
+  num_batches_total_ = num_batches;
+  num_batches_discarded_ = num_batches;
+}
+
+GuidingFieldTrainer::~GuidingFieldTrainer()
+{
+  train_pool_.wait_work();
+}
+
+openpgl::cpp::Field *GuidingFieldTrainer::sampling_field()
+{
+  const thread_scoped_lock lock(mutex_);
+
+  /* Swap in the back field when background training made it ahead of the front field. The
+   * batches which only the new back field still has to consume stay queued, and are replayed
+   * before any freshly rendered batch. */
+  if (!train_in_flight_ && back_.num_batches_consumed > front_.num_batches_consumed) {
+    std::swap(front_, back_);
+  }
+
+  return front_.field.get();
+}
+
+void GuidingFieldTrainer::push_training_batch(unique_ptr<openpgl::cpp::SampleStorage> batch)
+{
+  const thread_scoped_lock lock(mutex_);
+
+  /* Free the batches which both fields have consumed. The batch the training task might be
+   * updating with is never freed here, since its index equals the consumed counter of the
+   * back field. */
+  while (num_batches_discarded_ < front_.num_batches_consumed &&
+         num_batches_discarded_ < back_.num_batches_consumed)
+  {
+    batches_.pop_front();
+    num_batches_discarded_++;
+  }
+
+  batches_.push_back(std::move(batch));
+  num_batches_total_++;
+
+  /* A running task picks the new batch up on its own, as it only finishes once the back field
+   * has consumed every queued batch. */
+  if (!train_in_flight_) {
+    train_in_flight_ = true;
+    train_pool_.push([this] { train_back_field(); });
+  }
+}
+
+void GuidingFieldTrainer::wait()
+{
+  train_pool_.wait_work();
+}
+
+void GuidingFieldTrainer::reset()
+{
+  train_pool_.wait_work();
+
+  const thread_scoped_lock lock(mutex_);
+
+  front_.field->Reset();
+  back_.field->Reset();
+  front_.num_batches_consumed = 0;
+  back_.num_batches_consumed = 0;
+
+  batches_.clear();
+  num_batches_total_ = 0;
+  num_batches_discarded_ = 0;
+}
+
+bool GuidingFieldTrainer::store(const string &path)
+{
+  /* Let the background training finish, so the most trained field is complete. */
+  train_pool_.wait_work();
+
+  const thread_scoped_lock lock(mutex_);
+
+  const Field &field = (front_.num_batches_consumed >= back_.num_batches_consumed) ? front_ :
+                                                                                     back_;
+  if (field.num_batches_consumed == 0) {
+    return false;
+  }
+
+  try {
+    field.field->Store(path);
+  }
+  catch (const std::exception &exception) {
+    VLOG_WARNING << "Failed to store guiding field to " << path << ": " << exception.what();
+    return false;
+  }
+
+  return true;
+}
+
+void GuidingFieldTrainer::train_back_field()
+{
+  while (true) {
+    openpgl::cpp::SampleStorage *batch = nullptr;
+
+    {
+      const thread_scoped_lock lock(mutex_);
+      if (back_.num_batches_consumed == num_batches_total_) {
+        train_in_flight_ = false;
+        return;
+      }
+      batch = batches_[back_.num_batches_consumed - num_batches_discarded_].get();
+    }
+
+    /* The long running update happens outside of the lock, so that rendering threads can push
+     * new batches and query the front field without blocking. The fields are never swapped
+     * while training is in flight, so the back field is exclusively ours here. */
+    back_.field->Update(*batch);
+
+    VLOG_DEBUG << "Path guiding field valid: " << back_.field->Validate();
+
+    const thread_scoped_lock lock(mutex_);
+    back_.num_batches_consumed++;
+  }
+}
+
+#endif
+
+}
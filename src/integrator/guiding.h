@@ -6,6 +6,16 @@
 
 #include "kernel/types.h"
 
+#include "util/string.h"
+
+#ifdef WITH_PATH_GUIDING
+#  include "util/deque.h"
+#  include "util/guiding.h"
+#  include "util/task.h"
+#  include "util/thread.h"
+#  include "util/unique_ptr.h"
+#endif
+
 namespace ccl {
 
 struct GuidingParams {
@@ -21,6 +31,10 @@ struct GuidingParams {
   int training_samples = 128;
   bool deterministic = false;
 
+  /* File to warm-start the guiding field from and store the trained field to.
+   * Empty disables the cache. */
+  string field_cache_path;
+
   GuidingParams() = default;
 
   bool modified(const GuidingParams &other) const
@@ -30,8 +44,81 @@ struct GuidingParams {
              (sampling_type == other.sampling_type) &&
              (training_samples == other.training_samples) &&
              (roughness_threshold == other.roughness_threshold) &&
-             (deterministic == other.deterministic));
+             (deterministic == other.deterministic) &&
+             (field_cache_path == other.field_cache_path));
+  }
+};
+
+#ifdef WITH_PATH_GUIDING
+
+/* Double buffered guiding fields, which allow the next field to train on a background thread
+ * while rendering keeps sampling from the previous one.
+ *
+ * Kernels sample from the front field, which stays immutable for the duration of a rendering
+ * iteration. Completed batches of training samples are queued and replayed into the back field
+ * by a background task. Once the back field has consumed more batches than the front field the
+ * two are swapped at the next batch boundary, and a batch is only freed after both fields have
+ * been trained with it. This way both fields consume the full sample stream in order, and are
+ * equivalent up to the number of batches they have consumed. */
+class GuidingFieldTrainer {
+ public:
+  GuidingFieldTrainer(unique_ptr<openpgl::cpp::Field> field_a,
+                      unique_ptr<openpgl::cpp::Field> field_b);
+  ~GuidingFieldTrainer();
+
+  /* Field to sample from during the next rendering iteration. Swaps in the freshly trained
+   * field when background training has finished. Is only to be called at batch boundaries,
+   * while no rendering is in progress. */
+  openpgl::cpp::Field *sampling_field();
+
+  /* Queue a batch of training samples and train the back field with it in the background. */
+  void push_training_batch(unique_ptr<openpgl::cpp::SampleStorage> batch);
+
+  /* Wait for the background training to catch up with all queued batches. */
+  void wait();
+
+  /* Reset both fields and discard the queued training batches. */
+  void reset();
+
+  /* Store the most trained of the two fields to a file, for warm-starting a later render.
+   * Returns false when neither field has consumed any training batch. */
+  bool store(const string &path);
+
+  /* Number of training batches queued so far, which equals the field iteration count once the
+   * background training has caught up. */
+  int num_batches() const
+  {
+    return num_batches_total_;
   }
+
+ private:
+  struct Field {
+    unique_ptr<openpgl::cpp::Field> field;
+
+    /* Number of training batches this field has been updated with. */
+    int num_batches_consumed = 0;
+  };
+
+  /* Train the back field with the queued batches it did not consume yet.
+   * Runs as a task in the train pool. */
+  void train_back_field();
+
+  Field front_;
+  Field back_;
+
+  /* Queue of batches which at least one of the fields still has to consume, with the total
+   * number of batches pushed and the number of batches already freed from the front of the
+   * queue. Protected by the mutex, which the training task only holds while fetching the next
+   * batch and updating the counters, not during the field update itself. */
+  deque<unique_ptr<openpgl::cpp::SampleStorage>> batches_;
+  int num_batches_total_ = 0;
+  int num_batches_discarded_ = 0;
+  bool train_in_flight_ = false;
+  thread_mutex mutex_;
+
+  TaskPool train_pool_;
 };
 
+#endif
+
 }
@@ -18,6 +18,7 @@ PassAccessor::PassAccessInfo::PassAccessInfo(const BufferPass &pass)
     : type(pass.type),
       mode(pass.mode),
       include_albedo(pass.include_albedo),
+      accumulate_half(pass.accumulate_half),
       is_lightgroup(!pass.lightgroup.empty()),
       offset(pass.offset)
 {
@@ -236,6 +237,8 @@ void PassAccessor::init_kernel_film_convert(KernelFilmConvert *kfilm_convert,
 
   kfilm_convert->pass_use_exposure = pass_info.use_exposure;
   kfilm_convert->pass_use_filter = pass_info.use_filter;
+  kfilm_convert->pass_half = pass_access_info_.accumulate_half &&
+                             pass_info.support_half_accumulation;
 
   /* TODO(sergey): Some of the passes needs to become denoised when denoised pass is accessed. */
   if (pass_info.direct_type != PASS_NONE) {
@@ -284,6 +287,8 @@ void PassAccessor::init_kernel_film_convert(KernelFilmConvert *kfilm_convert,
                                                            destination.num_components;
 
   kfilm_convert->is_denoised = (mode == PassMode::DENOISED);
+
+  kfilm_convert->clamp_max = pass_access_info_.clamp_max;
 }
 
 bool PassAccessor::set_render_tile_pixels(RenderBuffers *render_buffers, const Source &source)
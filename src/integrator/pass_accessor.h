@@ -27,6 +27,7 @@ class PassAccessor {
     PassType type = PASS_NONE;
     PassMode mode = PassMode::NOISY;
     bool include_albedo = false;
+    bool accumulate_half = false;
     bool is_lightgroup = false;
     int offset = -1;
 
@@ -39,6 +40,10 @@ class PassAccessor {
     bool use_approximate_shadow_catcher_background = false;
 
     bool show_active_pixels = false;
+
+    /* Clamp color channels of the accessed pixels to [0, clamp_max]. Disabled when zero.
+     * Only affects float destinations, the half RGBA display path ignores it. */
+    float clamp_max = 0.0f;
   };
 
   class Destination {
@@ -70,8 +70,6 @@ void PassAccessorGPU::run_film_convert_kernels(DeviceKernel kernel,
 
     queue_->enqueue(kernel_half_float, work_size, args);
   }
-
-  queue_->synchronize();
 }
 
 /* --------------------------------------------------------------------
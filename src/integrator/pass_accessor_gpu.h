@@ -12,7 +12,11 @@ namespace ccl {
 
 class DeviceQueue;
 
-/* Pass accessor implementation for GPU side. */
+/* Pass accessor implementation for GPU side.
+ *
+ * Kernels are enqueued asynchronously: work that depends on the result from outside of the queue
+ * (mapped graphics resources, host-side reads) must synchronize the queue explicitly. Work on the
+ * same queue is ordered after the conversion kernels without synchronization. */
 class PassAccessorGPU : public PassAccessor {
  public:
   PassAccessorGPU(DeviceQueue *queue,
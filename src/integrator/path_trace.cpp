@@ -18,6 +18,8 @@
 #include "session/tile.h"
 
 #include "util/log.h"
+#include "util/path.h"
+#include "util/profiling.h"
 #include "util/progress.h"
 #include "util/tbb.h"
 #include "util/time.h"
@@ -65,6 +67,18 @@ PathTrace::PathTrace(Device *device,
 
 PathTrace::~PathTrace()
 {
+  denoise_finish();
+  tile_buffer_write_finish();
+
+#ifdef WITH_PATH_GUIDING
+  /* Store the trained guiding field, so the next render of this scene starts warm. */
+  if (guiding_trainer_ && !guiding_params_.field_cache_path.empty()) {
+    if (guiding_trainer_->store(guiding_params_.field_cache_path)) {
+      VLOG_INFO << "Stored guiding field to " << guiding_params_.field_cache_path;
+    }
+  }
+#endif
+
   destroy_gpu_resources();
 }
 
@@ -134,6 +148,9 @@ void PathTrace::reset(const BufferParams &full_params,
     display_->reset(big_tile_params, reset_rendering);
   }
 
+  /* Make sure an in-flight denoise task does not modify state during the reset. */
+  denoise_finish();
+
   render_state_.has_denoised_result = false;
   render_state_.tile_written = false;
 
@@ -155,6 +172,10 @@ void PathTrace::device_free()
 void PathTrace::set_progress(Progress *progress)
 {
   progress_ = progress;
+
+  for (auto &&path_trace_work : path_trace_works_) {
+    path_trace_work->set_progress(progress);
+  }
 }
 
 void PathTrace::render(const RenderWork &render_work)
@@ -193,6 +214,13 @@ void PathTrace::render_pipeline(RenderWork render_work)
 
   init_render_buffers(render_work);
 
+  /* Upload checkpoint buffers now that the work buffers are allocated, replacing the usual
+   * zero-initialization which the scheduler skips when resuming mid-render. */
+  if (restore_buffers_) {
+    copy_from_render_buffers(restore_buffers_.get());
+    restore_buffers_.reset();
+  }
+
   rebalance(render_work);
 
   /* Prepare all per-thread guiding structures before we start with the next rendering
@@ -387,6 +415,8 @@ void PathTrace::path_trace(RenderWork &render_work)
   VLOG_WORK << "Will path trace " << render_work.path_trace.num_samples
             << " samples at the resolution divider " << render_work.resolution_divider;
 
+  const scoped_trace trace("path_trace");
+
   const double start_time = time_dt();
 
   const int num_works = path_trace_works_.size();
@@ -491,6 +521,9 @@ void PathTrace::adaptive_sample(RenderWork &render_work)
 
 void PathTrace::set_denoiser_params(const DenoiseParams &params)
 {
+  /* An in-flight denoise task uses the current denoiser, finish it before any re-configuration. */
+  denoise_finish();
+
   if (!params.use) {
     denoiser_.reset();
     return;
@@ -587,24 +620,50 @@ void PathTrace::denoise(const RenderWork &render_work)
     return;
   }
 
+  /* Make sure denoising of the previous batch is finished before scheduling a new one. */
+  denoise_finish();
+
   VLOG_WORK << "Perform denoising work.";
 
+  const scoped_trace trace("denoise");
+
   const double start_time = time_dt();
 
   RenderBuffers *buffer_to_denoise = nullptr;
   bool allow_inplace_modification = false;
 
   Device *denoiser_device = denoiser_->get_denoiser_device();
-  if (path_trace_works_.size() > 1 && denoiser_device && !big_tile_denoise_work_) {
+
+  /* Denoise a copy of the render buffers when a single buffer spanning multiple works is needed,
+   * or when the denoiser runs on another device: in the latter case the copy doubles as the
+   * denoiser input buffer, so that path tracing of the next batch can overlap with denoising. */
+  const bool use_buffer_copy = denoiser_device &&
+                               (path_trace_works_.size() > 1 || denoiser_device != device_);
+  if (use_buffer_copy && !big_tile_denoise_work_) {
     big_tile_denoise_work_ = PathTraceWork::create(denoiser_device, film_, device_scene_, nullptr);
   }
 
-  if (big_tile_denoise_work_) {
-    big_tile_denoise_work_->set_effective_buffer_params(render_state_.effective_big_tile_params,
-                                                        render_state_.effective_big_tile_params,
-                                                        render_state_.effective_big_tile_params);
+  /* Run asynchronously when the input is a copy, unless the result is needed for the tile write
+   * at the end of this very pipeline iteration. */
+  const bool run_async = use_buffer_copy && !render_work.tile.write;
+
+  PathTraceWork *denoise_work = nullptr;
+  if (use_buffer_copy) {
+    if (run_async) {
+      if (!denoise_async_.work) {
+        denoise_async_.work = PathTraceWork::create(denoiser_device, film_, device_scene_, nullptr);
+      }
+      denoise_work = denoise_async_.work.get();
+    }
+    else {
+      denoise_work = big_tile_denoise_work_.get();
+    }
+
+    denoise_work->set_effective_buffer_params(render_state_.effective_big_tile_params,
+                                              render_state_.effective_big_tile_params,
+                                              render_state_.effective_big_tile_params);
 
-    buffer_to_denoise = big_tile_denoise_work_->get_render_buffers();
+    buffer_to_denoise = denoise_work->get_render_buffers();
     buffer_to_denoise->reset(render_state_.effective_big_tile_params);
 
     copy_to_render_buffers(buffer_to_denoise);
@@ -617,6 +676,22 @@ void PathTrace::denoise(const RenderWork &render_work)
     buffer_to_denoise = path_trace_works_.front()->get_render_buffers();
   }
 
+  if (run_async) {
+    const BufferParams buffer_params = render_state_.effective_big_tile_params;
+    const int num_samples = get_num_samples_in_buffer();
+
+    denoise_async_.render_work = render_work;
+    denoise_async_.in_flight = true;
+    denoise_async_.task_pool.push([this, buffer_params, buffer_to_denoise, num_samples] {
+      const double task_start_time = time_dt();
+      denoise_async_.has_result = denoiser_->denoise_buffer(
+          buffer_params, buffer_to_denoise, num_samples, true);
+      denoise_async_.time = time_dt() - task_start_time;
+    });
+
+    return;
+  }
+
   if (denoiser_->denoise_buffer(render_state_.effective_big_tile_params,
                                 buffer_to_denoise,
                                 get_num_samples_in_buffer(),
@@ -628,8 +703,30 @@ void PathTrace::denoise(const RenderWork &render_work)
   render_scheduler_.report_denoise_time(render_work, time_dt() - start_time);
 }
 
+void PathTrace::denoise_finish()
+{
+  if (!denoise_async_.in_flight) {
+    return;
+  }
+
+  denoise_async_.task_pool.wait_work();
+  denoise_async_.in_flight = false;
+
+  if (denoise_async_.has_result) {
+    /* The finished buffer becomes the displayed result, while the previous result buffer gets
+     * re-used as the input of the next denoising task. */
+    std::swap(big_tile_denoise_work_, denoise_async_.work);
+    render_state_.has_denoised_result = true;
+  }
+
+  render_scheduler_.report_denoise_time(denoise_async_.render_work, denoise_async_.time);
+}
+
 void PathTrace::set_output_driver(unique_ptr<OutputDriver> driver)
 {
+  /* Finish an in-flight write to the old driver before it is destroyed. */
+  tile_buffer_write_finish();
+
   output_driver_ = std::move(driver);
 }
 
@@ -689,11 +786,16 @@ void PathTrace::update_display(const RenderWork &render_work)
     return;
   }
 
+  const scoped_trace trace("update_display");
+
   const double start_time = time_dt();
 
   if (output_driver_) {
     VLOG_WORK << "Invoke buffer update callback.";
 
+    /* Make sure a write of the previous frame is not running in the driver. */
+    tile_buffer_write_finish();
+
     const PathTraceTile tile(*this);
     output_driver_->update_render_tile(tile);
   }
@@ -876,8 +978,52 @@ void PathTrace::tile_buffer_write()
     return;
   }
 
-  const PathTraceTile tile(*this);
-  output_driver_->write_render_tile(tile);
+  /* Finish the previous write before re-using the snapshot buffers, and so that driver callbacks
+   * never run concurrently. */
+  tile_buffer_write_finish();
+
+  /* Full-frame processing happens outside of the render loop with buffers already on the CPU:
+   * there is nothing to overlap with, write synchronously. */
+  if (full_frame_state_.render_buffers) {
+    const PathTraceTile tile(*this);
+    output_driver_->write_render_tile(tile);
+    return;
+  }
+
+  /* Snapshot the render result into CPU-side buffers and hand it to a writer task, so that the
+   * output driver write overlaps with scene update and path tracing of the next frame. */
+  if (!write_async_.buffers) {
+    write_async_.buffers = make_unique<RenderBuffers>(cpu_device_.get());
+  }
+  write_async_.buffers->reset(render_state_.effective_big_tile_params);
+  copy_to_render_buffers(write_async_.buffers.get());
+
+  RenderBuffers *denoised_buffers = nullptr;
+  if (big_tile_denoise_work_ && render_state_.has_denoised_result) {
+    /* The denoised result lives in a separate buffer on the denoiser device: snapshot it too. */
+    if (!write_async_.denoised_buffers) {
+      write_async_.denoised_buffers = make_unique<RenderBuffers>(cpu_device_.get());
+    }
+    write_async_.denoised_buffers->reset(render_state_.effective_big_tile_params);
+    big_tile_denoise_work_->copy_to_render_buffers(write_async_.denoised_buffers.get());
+    denoised_buffers = write_async_.denoised_buffers.get();
+  }
+
+  write_async_.in_flight = true;
+  write_async_.task_pool.push(
+      [this, tile = SnapshotTile(*this, write_async_.buffers.get(), denoised_buffers)] {
+        output_driver_->write_render_tile(tile);
+      });
+}
+
+void PathTrace::tile_buffer_write_finish()
+{
+  if (!write_async_.in_flight) {
+    return;
+  }
+
+  write_async_.task_pool.wait_work();
+  write_async_.in_flight = false;
 }
 
 void PathTrace::tile_buffer_read()
@@ -890,6 +1036,9 @@ void PathTrace::tile_buffer_read()
     return;
   }
 
+  /* Make sure a write is not running in the driver. */
+  tile_buffer_write_finish();
+
   /* Read buffers back from device. */
   parallel_for_each(path_trace_works_, [&](unique_ptr<PathTraceWork> &path_trace_work) {
     path_trace_work->copy_render_buffers_from_device();
@@ -917,6 +1066,8 @@ void PathTrace::tile_buffer_write_to_disk()
     return;
   }
 
+  const scoped_trace trace("tile_buffer_write_to_disk");
+
   /* Get access to the CPU-side render buffers of the current big tile. */
   RenderBuffers *buffers;
   RenderBuffers big_tile_cpu_buffers(cpu_device_.get());
@@ -970,6 +1121,11 @@ void PathTrace::copy_to_render_buffers(RenderBuffers *render_buffers)
   render_buffers->copy_to_device();
 }
 
+void PathTrace::set_restore_buffers(unique_ptr<RenderBuffers> buffers)
+{
+  restore_buffers_ = std::move(buffers);
+}
+
 void PathTrace::copy_from_render_buffers(RenderBuffers *render_buffers)
 {
   render_buffers->copy_from_device();
@@ -1117,6 +1273,40 @@ bool PathTrace::get_render_tile_pixels(const PassAccessor &pass_accessor,
   return success;
 }
 
+bool PathTrace::get_render_tile_pixels_from_device(
+    const PassAccessor::PassAccessInfo &pass_access_info,
+    const float exposure,
+    const int num_samples,
+    const PassAccessor::Destination &destination)
+{
+  if (full_frame_state_.render_buffers) {
+    /* Full-frame buffer is always allocated on CPU, nothing to read back. */
+    return false;
+  }
+
+  if (big_tile_denoise_work_ && render_state_.has_denoised_result) {
+    if (pass_access_info.mode == PassMode::DENOISED) {
+      return big_tile_denoise_work_->get_render_tile_pixels_from_device(
+          pass_access_info, exposure, num_samples, destination);
+    }
+  }
+
+  bool success = true;
+
+  parallel_for_each(path_trace_works_, [&](unique_ptr<PathTraceWork> &path_trace_work) {
+    if (!success) {
+      return;
+    }
+    if (!path_trace_work->get_render_tile_pixels_from_device(
+            pass_access_info, exposure, num_samples, destination))
+    {
+      success = false;
+    }
+  });
+
+  return success;
+}
+
 bool PathTrace::set_render_tile_pixels(PassAccessor &pass_accessor,
                                        const PassAccessor::Source &source)
 {
@@ -1187,6 +1377,9 @@ void PathTrace::destroy_gpu_resources()
     if (big_tile_denoise_work_) {
       big_tile_denoise_work_->destroy_gpu_resources(display_.get());
     }
+    if (denoise_async_.work) {
+      denoise_async_.work->destroy_gpu_resources(display_.get());
+    }
   }
 }
 
@@ -1327,6 +1520,35 @@ string PathTrace::full_report() const
   return result;
 }
 
+void PathTrace::set_kernel_timing_enabled(const bool enabled)
+{
+  for (auto &&path_trace_work : path_trace_works_) {
+    path_trace_work->set_kernel_timing_enabled(enabled);
+  }
+}
+
+void PathTrace::set_tile_order(const TileOrder tile_order)
+{
+  for (auto &&path_trace_work : path_trace_works_) {
+    path_trace_work->set_tile_order(tile_order);
+  }
+}
+
+void PathTrace::collect_work_occupancy(vector<pair<string, float>> &occupancy) const
+{
+  for (size_t i = 0; i < path_trace_works_.size(); i++) {
+    occupancy.emplace_back(path_trace_works_[i]->get_device()->info.description,
+                           work_balance_infos_[i].occupancy);
+  }
+}
+
+void PathTrace::collect_kernel_times(map<DeviceKernel, double> &times)
+{
+  for (auto &&path_trace_work : path_trace_works_) {
+    path_trace_work->collect_kernel_times(times);
+  }
+}
+
 void PathTrace::set_guiding_params(const GuidingParams &guiding_params, const bool reset)
 {
 #ifdef WITH_PATH_GUIDING
@@ -1400,25 +1622,63 @@ void PathTrace::set_guiding_params(const GuidingParams &guiding_params, const bo
           device_->get_guiding_device());
       if (guiding_device) {
         guiding_sample_data_storage_ = make_unique<openpgl::cpp::SampleStorage>();
+
+        unique_ptr<openpgl::cpp::Field> field_a;
+        unique_ptr<openpgl::cpp::Field> field_b;
+
+        /* Warm start from a previously trained field when one is cached for this scene, so
+         * sampling is guided from the first batch instead of relearning the distributions. */
+        if (!guiding_params_.field_cache_path.empty() &&
+            path_exists(guiding_params_.field_cache_path))
+        {
+          try {
+            field_a = make_unique<openpgl::cpp::Field>(guiding_device,
+                                                       guiding_params_.field_cache_path);
+            field_b = make_unique<openpgl::cpp::Field>(guiding_device,
+                                                       guiding_params_.field_cache_path);
+            if (field_a->Validate() && field_b->Validate()) {
+              VLOG_INFO << "Warm starting guiding field from "
+                        << guiding_params_.field_cache_path;
+            }
+            else {
+              field_a = nullptr;
+              field_b = nullptr;
+            }
+          }
+          catch (const std::exception &exception) {
+            VLOG_WARNING << "Failed to load guiding field from "
+                         << guiding_params_.field_cache_path << ": " << exception.what();
+            field_a = nullptr;
+            field_b = nullptr;
+          }
+        }
+
+        if (!field_a) {
 #  ifdef OPENPGL_USE_FIELD_CONFIG
-        guiding_field_ = make_unique<openpgl::cpp::Field>(guiding_device, field_config);
+          field_a = make_unique<openpgl::cpp::Field>(guiding_device, field_config);
+          field_b = make_unique<openpgl::cpp::Field>(guiding_device, field_config);
 #  else
-        guiding_field_ = make_unique<openpgl::cpp::Field>(guiding_device, field_args);
+          field_a = make_unique<openpgl::cpp::Field>(guiding_device, field_args);
+          field_b = make_unique<openpgl::cpp::Field>(guiding_device, field_args);
 #  endif
+        }
+
+        guiding_trainer_ = make_unique<GuidingFieldTrainer>(std::move(field_a),
+                                                            std::move(field_b));
       }
       else {
         guiding_sample_data_storage_ = nullptr;
-        guiding_field_ = nullptr;
+        guiding_trainer_ = nullptr;
       }
     }
     else {
       guiding_sample_data_storage_ = nullptr;
-      guiding_field_ = nullptr;
+      guiding_trainer_ = nullptr;
     }
   }
   else if (reset) {
-    if (guiding_field_) {
-      guiding_field_->Reset();
+    if (guiding_trainer_) {
+      guiding_trainer_->reset();
     }
   }
 #else
@@ -1431,11 +1691,15 @@ void PathTrace::guiding_prepare_structures()
 {
 #ifdef WITH_PATH_GUIDING
   const bool train = (guiding_params_.training_samples == 0) ||
-                     (guiding_field_->GetIteration() < guiding_params_.training_samples);
+                     (guiding_trainer_->num_batches() < guiding_params_.training_samples);
+
+  /* Swaps in the field trained by the background task when it has finished, so that a training
+   * update never blocks the start of the next rendering iteration. */
+  openpgl::cpp::Field *guiding_field = guiding_trainer_->sampling_field();
 
   for (auto &&path_trace_work : path_trace_works_) {
     path_trace_work->guiding_init_kernel_globals(
-        guiding_field_.get(), guiding_sample_data_storage_.get(), train);
+        guiding_field, guiding_sample_data_storage_.get(), train);
   }
 
   if (train) {
@@ -1465,12 +1729,17 @@ void PathTrace::guiding_update_structures()
 
   /* we wait until we have at least 1024 samples */
   if (num_valid_samples >= 1024) {
-    guiding_field_->Update(*guiding_sample_data_storage_);
+    /* Hand the batch over to the background training task and collect the samples of the next
+     * iteration into a fresh storage, so that rendering continues on the previous field while
+     * the next one trains. */
+    guiding_trainer_->push_training_batch(std::move(guiding_sample_data_storage_));
+    guiding_sample_data_storage_ = make_unique<openpgl::cpp::SampleStorage>();
     guiding_update_count++;
 
-    VLOG_DEBUG << "Path guiding field valid: " << guiding_field_->Validate();
-
-    guiding_sample_data_storage_->Clear();
+    if (guiding_params_.deterministic) {
+      /* Keep the training synchronous for reproducible results. */
+      guiding_trainer_->wait();
+    }
   }
 #endif
 }
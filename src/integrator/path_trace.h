@@ -10,11 +10,14 @@
 #include "integrator/guiding.h"
 #include "integrator/pass_accessor.h"
 #include "integrator/path_trace_work.h"
+#include "integrator/render_scheduler.h"
 #include "integrator/work_balancer.h"
 
 #include "session/buffers.h"
 
 #include "util/guiding.h"  // IWYU pragma: keep
+#include "util/map.h"
+#include "util/task.h"
 #include "util/thread.h"
 #include "util/unique_ptr.h"
 #include "util/vector.h"
@@ -132,6 +135,12 @@ class PathTrace {
    * buffers and will be copied to all devices of the path trace. */
   void copy_from_render_buffers(RenderBuffers *render_buffers);
 
+  /* Schedule restoring the render buffers from the given buffers, which were
+   * read back from a checkpoint on disk. The copy is deferred until the work
+   * buffers are allocated for the next render work, and replaces the usual
+   * buffer initialization. */
+  void set_restore_buffers(unique_ptr<RenderBuffers> buffers);
+
   /* Copy render buffers of the big tile from the device to host.
    * Return true if all copies are successful. */
   bool copy_render_tile_from_device();
@@ -152,6 +161,17 @@ class PathTrace {
   bool get_render_tile_pixels(const PassAccessor &pass_accessor,
                               const PassAccessor::Destination &destination);
 
+  /* Get pass data of the entire big tile by running the film convert kernel on the devices and
+   * reading back only the converted pass pixels, without copying the full multi-pass render
+   * buffer to the host.
+   *
+   * Returns false when device-side access is not possible, in which case the caller is to use
+   * `copy_render_tile_from_device()` together with `get_render_tile_pixels()`. */
+  bool get_render_tile_pixels_from_device(const PassAccessor::PassAccessInfo &pass_access_info,
+                                          const float exposure,
+                                          const int num_samples,
+                                          const PassAccessor::Destination &destination);
+
   /* Set pass data for baking. */
   bool set_render_tile_pixels(PassAccessor &pass_accessor, const PassAccessor::Source &source);
 
@@ -177,6 +197,17 @@ class PathTrace {
    * times, and so on. */
   string full_report() const;
 
+  /* Per-kernel execution timing on the path tracing devices, for devices whose queue supports
+   * timestamp events. Enable before rendering starts, collect after it finished. */
+  void set_kernel_timing_enabled(const bool enabled);
+  void collect_kernel_times(map<DeviceKernel, double> &times);
+
+  /* Per-device occupancy of the most recently rendered work, for the session stats report. */
+  void collect_work_occupancy(vector<pair<string, float>> &occupancy) const;
+
+  /* Traversal order of work tiles on devices which slice their work into tiles. */
+  void set_tile_order(const TileOrder tile_order);
+
   /* Callback which is called to report current rendering progress.
    *
    * It is supposed to be cheaper than buffer update/write, hence can be called more often.
@@ -210,6 +241,8 @@ class PathTrace {
   void path_trace(RenderWork &render_work);
   void adaptive_sample(RenderWork &render_work);
   void denoise(const RenderWork &render_work);
+  /* Wait for a possibly in-flight asynchronous denoise task and publish its result. */
+  void denoise_finish();
   void cryptomatte_postprocess(const RenderWork &render_work);
   void update_display(const RenderWork &render_work);
   void rebalance(const RenderWork &render_work);
@@ -235,6 +268,10 @@ class PathTrace {
   /* Write the big tile render buffer via the write callback. */
   void tile_buffer_write();
 
+  /* Wait for an in-flight asynchronous tile write to finish. Called before any other interaction
+   * with the output driver, and before the snapshot buffers are re-used or freed. */
+  void tile_buffer_write_finish();
+
   /* Read the big tile render buffer via the read callback. */
   void tile_buffer_read();
 
@@ -289,13 +326,63 @@ class PathTrace {
   /* Denoiser device descriptor which holds the denoised big tile for multi-device workloads. */
   unique_ptr<PathTraceWork> big_tile_denoise_work_;
 
+  /* State of asynchronous denoising, which overlaps denoising of one batch of samples with path
+   * tracing of the next one. The input is double-buffered: the denoiser runs on `work` while
+   * `big_tile_denoise_work_` keeps the last finished result for display, and the two are swapped
+   * once the task finishes. */
+  struct {
+    /* Second big tile buffer, used as the input and output of the in-flight task. */
+    unique_ptr<PathTraceWork> work;
+
+    /* Render work the in-flight task was scheduled from, for the scheduler timing report. */
+    RenderWork render_work;
+
+    /* Whether a denoising task is currently in flight. */
+    bool in_flight = false;
+
+    /* Result and wall time of the task. Written by the task, only read after the pool finished
+     * all work. */
+    bool has_result = false;
+    double time = 0.0;
+
+    /* Task pool with at most a single denoising task in flight. Runs at high priority so that
+     * the dispatch is not queued behind bulk work like scene sync.
+     * Declared last, so that it is waited on before the buffers above are freed. */
+    TaskPool task_pool{TaskPriority::HIGH};
+  } denoise_async_;
+
+  /* State of asynchronous tile writing, which hands a CPU-side snapshot of the finished render
+   * result to the output driver on a writer thread. The render loop proceeds immediately, so that
+   * writing frame N overlaps with scene update and path tracing of frame N+1. */
+  struct {
+    /* CPU-side copy of the big tile render buffers consumed by the writer task. */
+    unique_ptr<RenderBuffers> buffers;
+
+    /* CPU-side copy of the denoised big tile, for when the denoised result lives in a separate
+     * buffer on the denoiser device. */
+    unique_ptr<RenderBuffers> denoised_buffers;
+
+    /* Whether a write task is currently in flight. */
+    bool in_flight = false;
+
+    /* Task pool with at most a single write task in flight. Runs at high priority so that the
+     * driver write is not queued behind bulk work like scene sync.
+     * Declared last, so that it is waited on before the buffers above are freed. */
+    TaskPool task_pool{TaskPriority::HIGH};
+  } write_async_;
+
+  /* Render buffers read back from a checkpoint, waiting to be uploaded to the work buffers once
+   * those are allocated for the next render work. */
+  unique_ptr<RenderBuffers> restore_buffers_;
+
 #ifdef WITH_PATH_GUIDING
   /* Guiding related attributes */
   GuidingParams guiding_params_;
 
-  /* The guiding field which holds the representation of the incident radiance field for the
-   * complete scene. */
-  unique_ptr<openpgl::cpp::Field> guiding_field_;
+  /* Double buffered guiding fields which hold the representation of the incident radiance
+   * field for the complete scene. While rendering samples from one field, the other one is
+   * trained on a background thread and the two are swapped at batch boundaries. */
+  unique_ptr<GuidingFieldTrainer> guiding_trainer_;
 
   /* The storage container which holds the training data/samples generated during the last
    * rendering iteration. */
@@ -29,12 +29,6 @@ bool PathTraceTile::get_pass_pixels(const string_view pass_name,
   /* NOTE: The code relies on a fact that session is fully update and no scene/buffer modification
    * is happening while this function runs. */
 
-  if (!copied_from_device_) {
-    /* Copy from device on demand. */
-    path_trace_.copy_render_tile_from_device();
-    copied_from_device_ = true;
-  }
-
   const BufferParams &buffer_params = path_trace_.get_render_tile_params();
 
   const BufferPass *pass = buffer_params.find_pass(pass_name);
@@ -66,9 +60,23 @@ bool PathTraceTile::get_pass_pixels(const string_view pass_name,
   pass_access_info.use_approximate_shadow_catcher_background =
       pass_access_info.use_approximate_shadow_catcher && !buffer_params.use_transparent_background;
 
-  const PassAccessorCPU pass_accessor(pass_access_info, exposure, num_samples);
   const PassAccessor::Destination destination(pixels, num_channels);
 
+  if (!copied_from_device_) {
+    /* Convert on the device and read back only this pass, avoiding the round-trip of the full
+     * multi-pass render buffer to the host which quickly adds up at high tile counts. */
+    if (path_trace_.get_render_tile_pixels_from_device(
+            pass_access_info, exposure, num_samples, destination))
+    {
+      return true;
+    }
+
+    /* Copy from device on demand. */
+    path_trace_.copy_render_tile_from_device();
+    copied_from_device_ = true;
+  }
+
+  const PassAccessorCPU pass_accessor(pass_access_info, exposure, num_samples);
   return path_trace_.get_render_tile_pixels(pass_accessor, destination);
 }
 
@@ -99,4 +107,69 @@ bool PathTraceTile::set_pass_pixels(const string_view pass_name,
   return path_trace_.set_render_tile_pixels(pass_accessor, source);
 }
 
+SnapshotTile::SnapshotTile(PathTrace &path_trace,
+                           const RenderBuffers *buffers,
+                           const RenderBuffers *denoised_buffers)
+    : OutputDriver::Tile(path_trace.get_render_tile_offset(),
+                         path_trace.get_render_tile_size(),
+                         path_trace.get_render_size(),
+                         path_trace.get_render_tile_params().layer,
+                         path_trace.get_render_tile_params().view),
+      buffers_(buffers),
+      denoised_buffers_(denoised_buffers),
+      buffer_params_(path_trace.get_render_tile_params()),
+      num_samples_(path_trace.get_num_render_tile_samples()),
+      has_denoised_result_(path_trace.has_denoised_result())
+{
+}
+
+bool SnapshotTile::get_pass_pixels(const string_view pass_name,
+                                   const int num_channels,
+                                   float *pixels) const
+{
+  const BufferPass *pass = buffer_params_.find_pass(pass_name);
+  if (pass == nullptr) {
+    return false;
+  }
+
+  if (pass->mode == PassMode::DENOISED && !has_denoised_result_) {
+    pass = buffer_params_.find_pass(pass->type);
+    if (pass == nullptr) {
+      /* Happens when denoised result pass is requested but is never written by the kernel. */
+      return false;
+    }
+  }
+
+  pass = buffer_params_.get_actual_display_pass(pass);
+  if (pass == nullptr) {
+    return false;
+  }
+
+  const float exposure = buffer_params_.exposure;
+
+  PassAccessor::PassAccessInfo pass_access_info(*pass);
+  pass_access_info.use_approximate_shadow_catcher = buffer_params_.use_approximate_shadow_catcher;
+  pass_access_info.use_approximate_shadow_catcher_background =
+      pass_access_info.use_approximate_shadow_catcher && !buffer_params_.use_transparent_background;
+
+  const PassAccessorCPU pass_accessor(pass_access_info, exposure, num_samples_);
+  const PassAccessor::Destination destination(pixels, num_channels);
+
+  /* Denoised passes live in the separate denoised buffer when the denoiser ran on a copy. */
+  const RenderBuffers *buffers = (denoised_buffers_ != nullptr &&
+                                  pass_access_info.mode == PassMode::DENOISED) ?
+                                     denoised_buffers_ :
+                                     buffers_;
+
+  return pass_accessor.get_render_tile_pixels(buffers, destination);
+}
+
+bool SnapshotTile::set_pass_pixels(const string_view /*pass_name*/,
+                                   const int /*num_channels*/,
+                                   const float * /*pixels*/) const
+{
+  /* The snapshot is only handed to write callbacks, which do not modify the tile. */
+  return false;
+}
+
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "session/buffers.h"
 #include "session/output_driver.h"
 
 namespace ccl {
@@ -13,6 +14,7 @@ namespace ccl {
  * Implementation of OutputDriver::Tile interface for path tracer. */
 
 class PathTrace;
+class RenderBuffers;
 
 class PathTraceTile : public OutputDriver::Tile {
  public:
@@ -30,4 +32,34 @@ class PathTraceTile : public OutputDriver::Tile {
   mutable bool copied_from_device_;
 };
 
+/* SnapshotTile
+ *
+ * Tile backed by a CPU-side copy of the render buffers, with all the state needed for pass access
+ * captured at construction time. Used to hand a finished render result to the output driver on a
+ * writer thread while the path tracer proceeds with the next frame. */
+
+class SnapshotTile : public OutputDriver::Tile {
+ public:
+  /* Captures tile parameters from the path tracer, which must not be accessed concurrently.
+   * Denoised passes are read from `denoised_buffers` when it is non-null, for the case where the
+   * denoised result lives in a separate buffer. */
+  SnapshotTile(PathTrace &path_trace,
+               const RenderBuffers *buffers,
+               const RenderBuffers *denoised_buffers);
+
+  bool get_pass_pixels(const string_view pass_name,
+                       const int num_channels,
+                       float *pixels) const override;
+  bool set_pass_pixels(const string_view pass_name,
+                       const int num_channels,
+                       const float *pixels) const override;
+
+ private:
+  const RenderBuffers *buffers_;
+  const RenderBuffers *denoised_buffers_;
+  BufferParams buffer_params_;
+  int num_samples_;
+  bool has_denoised_result_;
+};
+
 }
@@ -5,8 +5,12 @@
 #pragma once
 
 #include "integrator/pass_accessor.h"
+#include "integrator/tile.h"
 #include "scene/pass.h"
 #include "session/buffers.h"
+#include "util/map.h"
+#include "util/progress.h"
+#include "util/time.h"
 #include "util/unique_ptr.h"
 
 namespace ccl {
@@ -117,6 +121,22 @@ class PathTraceWork {
   bool get_render_tile_pixels(const PassAccessor &pass_accessor,
                               const PassAccessor::Destination &destination);
 
+  /* Device-side variant of `get_render_tile_pixels()`: run the film convert kernel on the device
+   * and read back only the converted pass pixels, so that the full multi-pass render buffer does
+   * not have to be copied to the host first.
+   *
+   * Returns false when device-side pass access is not possible (CPU rendering, or an unsupported
+   * destination configuration), in which case the caller is to copy the render buffer from the
+   * device and use the CPU pass accessor. */
+  virtual bool get_render_tile_pixels_from_device(
+      const PassAccessor::PassAccessInfo & /*pass_access_info*/,
+      const float /*exposure*/,
+      const int /*num_samples*/,
+      const PassAccessor::Destination & /*destination*/)
+  {
+    return false;
+  }
+
   /* Set pass data for baking. */
   bool set_render_tile_pixels(PassAccessor &pass_accessor, const PassAccessor::Source &source);
 
@@ -128,13 +148,44 @@ class PathTraceWork {
   /* Run cryptomatte pass post-processing kernels. */
   virtual void cryptomatte_postproces() = 0;
 
+  /* Per-kernel execution timing, for devices whose queue supports timestamp events.
+   * Times are merged into the given map, so that it can accumulate over multiple works. */
+  virtual void set_kernel_timing_enabled(const bool /*enabled*/) {}
+  virtual void collect_kernel_times(map<DeviceKernel, double> & /*times*/) {}
+
+  /* Traversal order of work tiles over the image. Only has an effect on devices which slice their
+   * work into tiles, so the CPU work ignores it. */
+  virtual void set_tile_order(const TileOrder /*tile_order*/) {}
+
   /* Cheap-ish request to see whether rendering is requested and is to be stopped as soon as
    * possible, without waiting for any samples to be finished. */
   bool is_cancel_requested() const
   {
     /* NOTE: Rely on the fact that on x86 CPU reading scalar can happen without atomic even in
      * threaded environment. */
-    return *cancel_requested_flag_;
+    if (*cancel_requested_flag_) {
+      return true;
+    }
+
+    /* Also observe the user-requested cancel, so that cancelling a long sample batch does not
+     * have to wait for the batch to finish. The progress is polled at a bounded rate since its
+     * cancel check may invoke a host application callback. */
+    if (progress_ != nullptr) {
+      const double time = time_dt();
+      if (time - last_progress_cancel_check_time_ >= 0.05) {
+        last_progress_cancel_check_time_ = time;
+        return progress_->get_cancel();
+      }
+    }
+
+    return false;
+  }
+
+  /* Set progress to observe user-requested cancellation from is_cancel_requested(), bounding the
+   * cancel latency to the polling interval plus a single path iteration. */
+  void set_progress(Progress *progress)
+  {
+    progress_ = progress;
   }
 
   /* Access to the device which is used to path trace this work on. */
@@ -189,6 +240,11 @@ class PathTraceWork {
   BufferParams effective_buffer_params_;
 
   const bool *cancel_requested_flag_ = nullptr;
+
+  /* Optional progress used to observe user-requested cancellation, polled at a bounded rate
+   * from is_cancel_requested(). */
+  Progress *progress_ = nullptr;
+  mutable double last_progress_cancel_check_time_ = 0.0;
 };
 
 }
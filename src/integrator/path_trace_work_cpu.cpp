@@ -19,6 +19,7 @@
 #include "scene/scene.h"
 #include "session/buffers.h"
 
+#include "util/algorithm.h"
 #include "util/tbb.h"
 
 namespace ccl {
@@ -59,11 +60,60 @@ void PathTraceWorkCPU::init_execution()
   device_->get_cpu_kernel_thread_globals(kernel_thread_globals_);
 }
 
+/* Number of pixels which the wavefront pipeline traces together. Large enough to amortize the
+ * per-wave sort and give surface shading coherent runs of the same shader, while keeping the
+ * integrator states of a batch resident in the per-core caches. */
+static const int WAVEFRONT_BATCH_SIZE = 64;
+
+static inline bool use_wavefront_pipeline(const DeviceScene *device_scene)
+{
+  static const bool wavefront_enabled = (getenv("CYCLES_CPU_WAVEFRONT") != nullptr);
+
+  if (!wavefront_enabled) {
+    return false;
+  }
+
+  /* Guiding training accumulates path segments in a per-thread storage which assumes a single
+   * path is traced at a time, so it can not interleave paths of a batch. */
+  if (device_scene->data.integrator.train_guiding) {
+    return false;
+  }
+
+  return true;
+}
+
+/* Whether paths started from the given run of pixels can hit a shadow catcher and need the
+ * split state. Outside of the conservative raster-space catcher bounds computed by the scene
+ * update the split can never happen, so the second state and megakernel pass are skipped. */
+static inline bool need_shadow_catcher_split(const DeviceScene *device_scene,
+                                             const KernelWorkTile &work_tile,
+                                             const int num_pixels)
+{
+  const KernelIntegrator &kintegrator = device_scene->data.integrator;
+
+  if (!kintegrator.has_shadow_catcher) {
+    return false;
+  }
+
+  /* Baking generates rays from the baked geometry rather than the camera, so the raster-space
+   * bounds do not apply. */
+  if (device_scene->data.bake.use) {
+    return true;
+  }
+
+  return int(work_tile.x) < kintegrator.shadow_catcher_rect_max_x &&
+         int(work_tile.x) + num_pixels > kintegrator.shadow_catcher_rect_min_x &&
+         int(work_tile.y) < kintegrator.shadow_catcher_rect_max_y &&
+         int(work_tile.y) + 1 > kintegrator.shadow_catcher_rect_min_y;
+}
+
 void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
                                       const int start_sample,
                                       const int samples_num,
                                       const int sample_offset)
 {
+  buffers_->tag_device_modified();
+
   const int64_t image_width = effective_buffer_params_.width;
   const int64_t image_height = effective_buffer_params_.height;
   const int64_t total_pixels_num = image_width * image_height;
@@ -74,31 +124,60 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
     }
   }
 
-  tbb::task_arena local_arena = local_tbb_arena_create(device_);
-  local_arena.execute([&]() {
-    parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
-      if (is_cancel_requested()) {
-        return;
-      }
-
-      const int y = work_index / image_width;
-      const int x = work_index - y * image_width;
+  const bool use_wavefront = use_wavefront_pipeline(device_scene_);
 
-      KernelWorkTile work_tile;
-      work_tile.x = effective_buffer_params_.full_x + x;
-      work_tile.y = effective_buffer_params_.full_y + y;
-      work_tile.w = 1;
-      work_tile.h = 1;
-      work_tile.start_sample = start_sample;
-      work_tile.sample_offset = sample_offset;
-      work_tile.num_samples = 1;
-      work_tile.offset = effective_buffer_params_.offset;
-      work_tile.stride = effective_buffer_params_.stride;
+  /* Wavefront batches are aligned to rows, so that pixels of a batch are neighbors. */
+  const int64_t batches_per_row = use_wavefront ?
+                                      divide_up(image_width, int64_t(WAVEFRONT_BATCH_SIZE)) :
+                                      0;
+  const int64_t work_num = use_wavefront ? image_height * batches_per_row : total_pixels_num;
 
-      ThreadKernelGlobalsCPU *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
-
-      render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
-    });
+  tbb::task_arena local_arena = local_tbb_arena_create(device_);
+  local_arena.execute([&]() {
+    /* The affinity partitioner replays the range-to-thread assignment of the previous
+     * invocation, so across sample batches a pixel keeps being traced by the same worker
+     * thread and its path state and film accumulation rows stay in the caches of one core. */
+    tbb::parallel_for(
+        tbb::blocked_range<int64_t>(0, work_num),
+        [&](const tbb::blocked_range<int64_t> &work_range) {
+          if (is_cancel_requested()) {
+            return;
+          }
+
+          ThreadKernelGlobalsCPU *kernel_globals = kernel_thread_globals_get(
+              kernel_thread_globals_);
+
+          for (int64_t work_index = work_range.begin(); work_index != work_range.end();
+               ++work_index)
+          {
+            const int64_t stride = use_wavefront ? batches_per_row : image_width;
+            const int64_t y = work_index / stride;
+            const int64_t x = (work_index - y * stride) * (use_wavefront ? WAVEFRONT_BATCH_SIZE :
+                                                                           1);
+
+            KernelWorkTile work_tile;
+            work_tile.x = effective_buffer_params_.full_x + x;
+            work_tile.y = effective_buffer_params_.full_y + y;
+            work_tile.w = 1;
+            work_tile.h = 1;
+            work_tile.start_sample = start_sample;
+            work_tile.sample_offset = sample_offset;
+            work_tile.num_samples = 1;
+            work_tile.offset = effective_buffer_params_.offset;
+            work_tile.stride = effective_buffer_params_.stride;
+
+            if (use_wavefront) {
+              const int num_pixels = (x + WAVEFRONT_BATCH_SIZE <= image_width) ?
+                                         WAVEFRONT_BATCH_SIZE :
+                                         int(image_width - x);
+              render_samples_wavefront(kernel_globals, work_tile, num_pixels, samples_num);
+            }
+            else {
+              render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+            }
+          }
+        },
+        render_partitioner_);
   });
   if (device_->profiler.active()) {
     for (ThreadKernelGlobalsCPU &kernel_globals : kernel_thread_globals_) {
@@ -120,7 +199,7 @@ void PathTraceWorkCPU::render_samples_full_pipeline(ThreadKernelGlobalsCPU *kern
   IntegratorStateCPU *state = &integrator_states[0];
   IntegratorStateCPU *shadow_catcher_state = nullptr;
 
-  if (device_scene_->data.integrator.has_shadow_catcher) {
+  if (need_shadow_catcher_split(device_scene_, work_tile, 1)) {
     shadow_catcher_state = &integrator_states[1];
     path_state_init_queues(shadow_catcher_state);
   }
@@ -165,6 +244,147 @@ void PathTraceWorkCPU::render_samples_full_pipeline(ThreadKernelGlobalsCPU *kern
   }
 }
 
+void PathTraceWorkCPU::render_samples_wavefront(ThreadKernelGlobalsCPU *kernel_globals,
+                                                const KernelWorkTile &work_tile,
+                                                const int num_pixels,
+                                                const int samples_num)
+{
+  const bool has_bake = device_scene_->data.bake.use;
+
+  /* The shadow catcher split writes to the state directly after the main one, so states are
+   * allocated in pairs when paths from this batch can reach a shadow catcher. */
+  const int states_per_pixel = need_shadow_catcher_split(device_scene_, work_tile, num_pixels) ?
+                                   2 :
+                                   1;
+
+  vector<IntegratorStateCPU> states(num_pixels * states_per_pixel);
+  vector<KernelWorkTile> work_tiles(num_pixels);
+  vector<uint32_t> queued_kernels(num_pixels);
+  vector<int> wave;
+  wave.reserve(num_pixels);
+
+  /* Scratch space for handing runs of shadow intersections over as one batch. */
+  vector<IntegratorStateCPU *> batch_states;
+  vector<uint32_t> batch_queued;
+  batch_states.reserve(num_pixels);
+  batch_queued.reserve(num_pixels);
+
+  /* Main states of the batch, handed to the batched camera ray generation as one array. */
+  vector<IntegratorStateCPU *> main_states(num_pixels);
+
+  for (int i = 0; i < num_pixels; ++i) {
+    work_tiles[i] = work_tile;
+    work_tiles[i].x += i;
+    main_states[i] = &states[i * states_per_pixel];
+
+    if (states_per_pixel == 2) {
+      path_state_init_queues(&states[i * states_per_pixel + 1]);
+    }
+  }
+
+  float *render_buffer = buffers_->buffer.data();
+
+  for (int sample = 0; sample < samples_num; ++sample) {
+    if (is_cancel_requested()) {
+      break;
+    }
+
+    /* Generate the camera (or bake) rays of all pixels of the batch. Camera rays are generated
+     * SIMD-wide for the common cameras. */
+    wave.clear();
+    if (has_bake) {
+      for (int i = 0; i < num_pixels; ++i) {
+        queued_kernels[i] = kernels_.integrator_init_from_bake(
+                                kernel_globals, main_states[i], &work_tiles[i], render_buffer) ?
+                                INTEGRATOR_STATE(main_states[i], path, queued_kernel) :
+                                0;
+      }
+    }
+    else {
+      kernels_.integrator_init_from_camera_batch(kernel_globals,
+                                                 main_states.data(),
+                                                 work_tiles.data(),
+                                                 render_buffer,
+                                                 queued_kernels.data(),
+                                                 num_pixels);
+    }
+
+    for (int i = 0; i < num_pixels; ++i) {
+      if (queued_kernels[i]) {
+        wave.push_back(i);
+      }
+      ++work_tiles[i].start_sample;
+    }
+
+    /* Advance all active paths one kernel at a time. Grouping the batch by queued kernel keeps
+     * the instruction cache hot within a wave, and sorting surface shading by shader shades
+     * paths which hit the same material back-to-back. */
+    while (!wave.empty()) {
+      stable_sort(wave.begin(), wave.end(), [&](const int a, const int b) {
+        if (queued_kernels[a] != queued_kernels[b]) {
+          return queued_kernels[a] < queued_kernels[b];
+        }
+        if (queued_kernels[a] == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE) {
+          return INTEGRATOR_STATE(&states[a * states_per_pixel], path, shader_sort_key) <
+                 INTEGRATOR_STATE(&states[b * states_per_pixel], path, shader_sort_key);
+        }
+        return false;
+      });
+
+      int num_active = 0;
+      for (int wave_index = 0; wave_index < wave.size();) {
+        const int i = wave[wave_index];
+
+        if (queued_kernels[i] == DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW) {
+          /* The wave is sorted by queued kernel, so all shadow intersections form one
+           * consecutive run. Hand it over as a single batch, which traces the coherent
+           * shadow rays as ray packets when the BVH supports it. */
+          batch_states.clear();
+          int batch_end = wave_index;
+          while (batch_end < wave.size() &&
+                 queued_kernels[wave[batch_end]] == DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW)
+          {
+            batch_states.push_back(&states[wave[batch_end] * states_per_pixel]);
+            ++batch_end;
+          }
+          batch_queued.resize(batch_states.size());
+
+          kernels_.integrator_intersect_shadow_batch(
+              kernel_globals, batch_states.data(), batch_queued.data(), batch_states.size());
+
+          for (int j = wave_index; j < batch_end; ++j) {
+            queued_kernels[wave[j]] = batch_queued[j - wave_index];
+            if (queued_kernels[wave[j]]) {
+              wave[num_active++] = wave[j];
+            }
+          }
+          wave_index = batch_end;
+          continue;
+        }
+
+        IntegratorStateCPU *state = &states[i * states_per_pixel];
+
+        queued_kernels[i] = kernels_.integrator_megakernel_step(
+            kernel_globals, state, render_buffer);
+
+        if (queued_kernels[i]) {
+          wave[num_active++] = i;
+        }
+        ++wave_index;
+      }
+      wave.resize(num_active);
+    }
+
+    /* Shadow catcher paths split off rarely, finish them with the regular pipeline. */
+    if (states_per_pixel == 2) {
+      for (int i = 0; i < num_pixels; ++i) {
+        kernels_.integrator_megakernel(
+            kernel_globals, &states[i * states_per_pixel + 1], render_buffer);
+      }
+    }
+  }
+}
+
 void PathTraceWorkCPU::copy_to_display(PathTraceDisplay *display,
                                        PassMode pass_mode,
                                        const int num_samples)
@@ -231,37 +451,42 @@ int PathTraceWorkCPU::adaptive_sampling_converge_filter_count_active(const float
 
   tbb::task_arena local_arena = local_tbb_arena_create(device_);
 
-  /* Check convergency and do x-filter in a single `parallel_for`, to reduce threading overhead. */
   local_arena.execute([&]() {
     parallel_for(full_y, full_y + height, [&](int y) {
       ThreadKernelGlobalsCPU *kernel_globals = kernel_thread_globals_.data();
 
-      bool row_converged = true;
       uint num_row_pixels_active = 0;
       for (int x = 0; x < width; ++x) {
         if (!kernels_.adaptive_sampling_convergence_check(
                 kernel_globals, render_buffer, full_x + x, y, threshold, reset, offset, stride))
         {
           ++num_row_pixels_active;
-          row_converged = false;
         }
       }
 
       atomic_fetch_and_add_uint32(&num_active_pixels, num_row_pixels_active);
-
-      if (!row_converged) {
-        kernels_.adaptive_sampling_filter_x(
-            kernel_globals, render_buffer, y, full_x, width, offset, stride);
-      }
     });
   });
 
   if (num_active_pixels) {
+    /* The fused filter of a row only reads from the row itself and its two neighbors, so
+     * traversing rows keeps the working set to three buffer rows, unlike a column-parallel
+     * y-filter which strides through the entire buffer per column. */
     local_arena.execute([&]() {
-      parallel_for(full_x, full_x + width, [&](int x) {
+      parallel_for(full_y, full_y + height, [&](int y) {
         ThreadKernelGlobalsCPU *kernel_globals = kernel_thread_globals_.data();
-        kernels_.adaptive_sampling_filter_y(
-            kernel_globals, render_buffer, x, full_y, height, offset, stride);
+        for (int x = 0; x < width; ++x) {
+          kernels_.adaptive_sampling_filter(kernel_globals,
+                                            render_buffer,
+                                            full_x + x,
+                                            y,
+                                            full_x,
+                                            full_y,
+                                            width,
+                                            height,
+                                            offset,
+                                            stride);
+        }
       });
     });
   }
@@ -11,6 +11,7 @@
 
 #include "integrator/path_trace_work.h"
 
+#include "util/tbb.h"
 #include "util/vector.h"
 
 namespace ccl {
@@ -74,6 +75,15 @@ class PathTraceWorkCPU : public PathTraceWork {
                                     const KernelWorkTile &work_tile,
                                     const int samples_num);
 
+  /* Wavefront variant of the core path tracing routine. Traces a batch of pixels together,
+   * advancing all paths one kernel at a time and sorting surface shading by shader, so that
+   * every wave runs a single kernel over coherent data instead of interleaving all kernels
+   * per path. */
+  void render_samples_wavefront(ThreadKernelGlobalsCPU *kernel_globals,
+                                const KernelWorkTile &work_tile,
+                                const int num_pixels,
+                                const int samples_num);
+
   /* CPU kernels. */
   const CPUKernels &kernels_;
 
@@ -83,6 +93,10 @@ class PathTraceWorkCPU : public PathTraceWork {
    * accessing it, but some "localization" is required to decouple from kernel globals stored
    * on the device level. */
   vector<ThreadKernelGlobalsCPU> kernel_thread_globals_;
+
+  /* Keeps the pixel range to worker thread assignment sticky across repeated
+   * `render_samples()` calls, so path state does not migrate between cores. */
+  tbb::affinity_partitioner render_partitioner_;
 };
 
 }
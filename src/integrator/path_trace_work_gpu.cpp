@@ -96,8 +96,13 @@ PathTraceWorkGPU::PathTraceWorkGPU(Device *device,
           device, "integrator_next_shadow_path_index", MEM_READ_WRITE),
       queued_paths_(device, "queued_paths", MEM_READ_WRITE),
       num_queued_paths_(device, "num_queued_paths", MEM_READ_WRITE),
+      integrator_queued_path_lists_(device, "integrator_queued_path_lists", MEM_READ_WRITE),
+      integrator_queued_path_list_cursor_(
+          device, "integrator_queued_path_list_cursor", MEM_READ_WRITE),
       work_tiles_(device, "work_tiles", MEM_READ_WRITE),
+      num_active_pixels_per_block_(device, "num_active_pixels_per_block", MEM_READ_WRITE),
       display_rgba_half_(device, "display buffer half", MEM_READ_WRITE),
+      pass_pixels_(device, "pass pixels", MEM_READ_WRITE),
       max_num_paths_(0),
       min_num_active_main_paths_(0),
       max_active_main_path_index_(0)
@@ -129,6 +134,23 @@ void PathTraceWorkGPU::alloc_integrator_soa()
     max_num_paths_ = queue_->num_concurrent_states(single_state_size);
     min_num_active_main_paths_ = queue_->num_concurrent_busy_states(single_state_size);
 
+    /* When a memory watermark is configured on the session, shrink the state count so the SoA
+     * allocation stays within the remaining budget instead of blowing through the threshold
+     * the moment path tracing starts. The count is baked into constant memory pointers once
+     * allocated, so this is the last point where it can safely be reduced. */
+    const size_t mem_watermark = device_->stats.mem_watermark();
+    if (mem_watermark != 0) {
+      const size_t mem_used = device_->stats.mem_used;
+      const size_t headroom = (mem_watermark > mem_used) ? mem_watermark - mem_used : 0;
+      const int budget_num_paths = (int)min((size_t)max_num_paths_,
+                                            headroom / single_state_size);
+      if (budget_num_paths < max_num_paths_) {
+        max_num_paths_ = max(budget_num_paths, 1024);
+        VLOG_WORK << "Limiting number of path states to " << max_num_paths_
+                 << " to fit the memory watermark.";
+      }
+    }
+
     /* Limit number of active paths to the half of the overall state. This is due to the logic in
      * the path compaction which relies on the fact that regeneration does not happen sooner than
      * half of the states are available again. */
@@ -237,6 +259,41 @@ void PathTraceWorkGPU::alloc_integrator_queue()
     /* TODO: this could be skip if we had a function to just allocate on device. */
     queued_paths_.zero_to_device();
   }
+
+  /* Allocate ring buffers of queued path indices for the kernels which are dispatched without
+   * shader sorting. The capacity is rounded up to a power of two, so that the monotonic append
+   * cursor keeps mapping to consecutive ring slots when it wraps around. */
+  if (integrator_queued_path_lists_.size() == 0) {
+    queued_path_list_capacity_ = next_power_of_two(max_num_paths_ - 1);
+
+    int num_lists = 0;
+    for (int i = 0; i < DEVICE_KERNEL_INTEGRATOR_NUM; i++) {
+      if (kernel_has_queued_path_list((DeviceKernel)i)) {
+        num_lists++;
+      }
+    }
+
+    integrator_queued_path_lists_.alloc((size_t)num_lists * queued_path_list_capacity_);
+    integrator_queued_path_lists_.zero_to_device();
+
+    integrator_queued_path_list_cursor_.alloc(DEVICE_KERNEL_INTEGRATOR_NUM);
+    integrator_queued_path_list_cursor_.zero_to_device();
+    integrator_queued_path_list_cursor_.copy_from_device();
+
+    integrator_state_gpu_.queued_path_list_cursor =
+        (uint *)integrator_queued_path_list_cursor_.device_pointer;
+    integrator_state_gpu_.queued_path_list_mask = queued_path_list_capacity_ - 1;
+
+    int list = 0;
+    for (int i = 0; i < DEVICE_KERNEL_INTEGRATOR_NUM; i++) {
+      if (kernel_has_queued_path_list((DeviceKernel)i)) {
+        integrator_state_gpu_.queued_path_list[i] =
+            (int *)integrator_queued_path_lists_.device_pointer +
+            (size_t)list * queued_path_list_capacity_;
+        list++;
+      }
+    }
+  }
 }
 
 void PathTraceWorkGPU::alloc_integrator_sorting()
@@ -341,6 +398,8 @@ void PathTraceWorkGPU::render_samples(RenderStatistics &statistics,
                                       const int samples_num,
                                       const int sample_offset)
 {
+  buffers_->tag_device_modified();
+
   /* Limit number of states for the tile and rely on a greedy scheduling of tiles. This allows to
    * add more work (because tiles are smaller, so there is higher chance that more paths will
    * become busy after adding new tiles). This is especially important for the shadow catcher which
@@ -450,10 +509,22 @@ void PathTraceWorkGPU::enqueue_reset()
   if (integrator_queue_counter_.host_pointer) {
     memset(integrator_queue_counter_.data(), 0, integrator_queue_counter_.memory_size());
   }
+
+  /* With all queues empty the queued path index lists are trivially in sync again. */
+  if (integrator_queued_path_list_cursor_.size() != 0) {
+    queue_->zero_to_device(integrator_queued_path_list_cursor_);
+  }
+  for (int i = 0; i < DEVICE_KERNEL_INTEGRATOR_NUM; i++) {
+    queued_path_list_consumed_[i] = 0;
+    queued_path_list_valid_[i] = true;
+  }
+  queued_path_list_revalidate_kernel_ = DEVICE_KERNEL_NUM;
 }
 
 bool PathTraceWorkGPU::enqueue_path_iteration()
 {
+  process_queued_path_list_revalidation();
+
   /* Find kernel to execute, with max number of queued paths. */
   const IntegratorQueueCounter *queue_counter = integrator_queue_counter_.data();
 
@@ -467,11 +538,37 @@ bool PathTraceWorkGPU::enqueue_path_iteration()
   }
 
   /* Find kernel to execute, with max number of queued paths. */
-  const DeviceKernel kernel = get_most_queued_kernel();
+  DeviceKernel kernel = get_most_queued_kernel();
   if (kernel == DEVICE_KERNEL_NUM) {
     return false;
   }
 
+  /* The dedicated light kernels typically see only a trickle of queued paths per iteration,
+   * fed by the few shaded hits that sample a dedicated light. Dispatching those near-empty
+   * launches every scheduling step costs more in launch overhead than the work they retire,
+   * so keep such paths queued and run other kernels until enough accumulate for a reasonably
+   * occupied launch. Deferred paths stay valid in their queue and cannot stall a sample: once
+   * no other work remains, the dedicated light queue is dispatched at whatever size it has. */
+  if (kernel_is_dedicated_light_path(kernel)) {
+    const int min_queued_paths_for_dedicated_light = 1024;
+    if (queue_counter->num_queued[kernel] < min_queued_paths_for_dedicated_light) {
+      int max_other_queued = 0;
+      DeviceKernel other_kernel = DEVICE_KERNEL_NUM;
+      for (int i = 0; i < DEVICE_KERNEL_INTEGRATOR_NUM; i++) {
+        if (kernel_is_dedicated_light_path((DeviceKernel)i)) {
+          continue;
+        }
+        if (queue_counter->num_queued[i] > max_other_queued) {
+          other_kernel = (DeviceKernel)i;
+          max_other_queued = queue_counter->num_queued[i];
+        }
+      }
+      if (other_kernel != DEVICE_KERNEL_NUM) {
+        kernel = other_kernel;
+      }
+    }
+  }
+
   /* For kernels that add shadow paths, check if there is enough space available.
    * If not, schedule shadow kernels first to clear out the shadow paths. */
   int num_paths_limit = INT_MAX;
@@ -511,6 +608,7 @@ bool PathTraceWorkGPU::enqueue_path_iteration()
 void PathTraceWorkGPU::enqueue_path_iteration(DeviceKernel kernel, const int num_paths_limit)
 {
   device_ptr d_path_index = 0;
+  bool used_queued_path_list = false;
 
   /* Create array of path indices for which this kernel is queued to be executed. */
   int work_size = kernel_max_active_main_path_index(kernel);
@@ -519,23 +617,79 @@ void PathTraceWorkGPU::enqueue_path_iteration(DeviceKernel kernel, const int num
   const int num_queued = queue_counter->num_queued[kernel];
 
   if (kernel_uses_sorting(kernel)) {
-    /* Compute array of active paths, sorted by shader. */
-    work_size = num_queued;
-    d_path_index = queued_paths_.device_pointer;
+    /* Compute array of active paths, sorted by shader.
+     *
+     * Sorting takes several extra kernel launches per scheduling step, which costs more than the
+     * coherency it buys once only a handful of paths remains queued: small GPUs and the tail end
+     * of a sample are better off dispatching in queue order. When the number of paths is limited
+     * stay on the sorted path, which knows how to leave truncated paths queued for a following
+     * iteration. */
+    const int min_queued_paths_for_sorting = 4096;
+    if (num_queued >= min_queued_paths_for_sorting || num_paths_limit < num_queued) {
+      work_size = num_queued;
+      d_path_index = queued_paths_.device_pointer;
+
+      compute_sorted_queued_paths(kernel, num_paths_limit);
+    }
+    else {
+      if (num_queued < work_size) {
+        work_size = num_queued;
+        d_path_index = queued_paths_.device_pointer;
 
-    compute_sorted_queued_paths(kernel, num_paths_limit);
-  }
-  else if (num_queued < work_size) {
-    work_size = num_queued;
-    d_path_index = queued_paths_.device_pointer;
+        compute_queued_paths(DEVICE_KERNEL_INTEGRATOR_QUEUED_PATHS_ARRAY, kernel);
+      }
 
-    if (kernel_is_shadow_path(kernel)) {
-      /* Compute array of active shadow paths for specific kernel. */
-      compute_queued_paths(DEVICE_KERNEL_INTEGRATOR_QUEUED_SHADOW_PATHS_ARRAY, kernel);
+      /* The sorted-index kernel is what consumes the sort key counters, so when it is skipped
+       * the counts for the paths dispatched here have to be dropped by hand. The local atomic
+       * sort recounts keys on every dispatch and has no persistent counters to clear. */
+      device_vector<int> *sort_counter = nullptr;
+      switch (kernel) {
+        case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE:
+          sort_counter = &integrator_shader_sort_counter_;
+          break;
+        case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE:
+          sort_counter = &integrator_shader_raytrace_sort_counter_;
+          break;
+        case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_MNEE:
+          sort_counter = &integrator_shader_mnee_sort_counter_;
+          break;
+        default:
+          break;
+      }
+      if (sort_counter && sort_counter->size() != 0) {
+        queue_->zero_to_device(*sort_counter);
+      }
     }
-    else {
-      /* Compute array of active paths for specific kernel. */
-      compute_queued_paths(DEVICE_KERNEL_INTEGRATOR_QUEUED_PATHS_ARRAY, kernel);
+  }
+  else {
+    /* Prefer the ring buffer of queued path indices that the kernels maintain themselves: its
+     * unconsumed range is exactly the set of queued paths, so the launch is dense without any
+     * scan kernels. Fall back to the scan when path states have been moved by compaction, or
+     * when the range would wrap around the end of the ring (rare; the next launch which
+     * dispatches all queued paths makes the list usable again). */
+    const uint ring_start = queued_path_list_consumed_[kernel] &
+                            integrator_state_gpu_.queued_path_list_mask;
+    if (integrator_state_gpu_.queued_path_list[kernel] != nullptr &&
+        queued_path_list_valid_[kernel] &&
+        ring_start + (uint)num_queued <= queued_path_list_capacity_)
+    {
+      work_size = min(num_queued, num_paths_limit);
+      d_path_index = (device_ptr)(integrator_state_gpu_.queued_path_list[kernel] + ring_start);
+      queued_path_list_consumed_[kernel] += (uint)work_size;
+      used_queued_path_list = true;
+    }
+    else if (num_queued < work_size) {
+      work_size = num_queued;
+      d_path_index = queued_paths_.device_pointer;
+
+      if (kernel_is_shadow_path(kernel)) {
+        /* Compute array of active shadow paths for specific kernel. */
+        compute_queued_paths(DEVICE_KERNEL_INTEGRATOR_QUEUED_SHADOW_PATHS_ARRAY, kernel);
+      }
+      else {
+        /* Compute array of active paths for specific kernel. */
+        compute_queued_paths(DEVICE_KERNEL_INTEGRATOR_QUEUED_PATHS_ARRAY, kernel);
+      }
     }
   }
 
@@ -584,6 +738,19 @@ void PathTraceWorkGPU::enqueue_path_iteration(DeviceKernel kernel, const int num
                  << " used for path iteration, should never happen.";
       break;
   }
+
+  if (integrator_state_gpu_.queued_path_list[kernel] != nullptr && !used_queued_path_list) {
+    /* The launch bypassed the ring buffer, so the consumed offset no longer matches the
+     * entries of the dispatched paths. If all queued paths were dispatched the queue becomes
+     * empty and every list entry is consumed: schedule a read-back of the append cursor, which
+     * is then picked up to make the list usable again. The kernel does not append to its own
+     * list, so the cursor read after the launch matches the state before it. */
+    queued_path_list_valid_[kernel] = false;
+    if (work_size >= num_queued) {
+      queue_->copy_from_device(integrator_queued_path_list_cursor_);
+      queued_path_list_revalidate_kernel_ = kernel;
+    }
+  }
 }
 
 void PathTraceWorkGPU::compute_sorted_queued_paths(DeviceKernel queued_kernel,
@@ -684,6 +851,9 @@ void PathTraceWorkGPU::compact_main_paths(const int num_active_paths)
                 DEVICE_KERNEL_INTEGRATOR_COMPACT_PATHS_ARRAY,
                 DEVICE_KERNEL_INTEGRATOR_COMPACT_STATES);
 
+  /* Moving path states leaves stale indices in the queued path lists. */
+  invalidate_queued_path_lists(false);
+
   /* Adjust max active path index now we know which part of the array is actually used. */
   max_active_main_path_index_ = num_active_paths;
 }
@@ -722,6 +892,9 @@ void PathTraceWorkGPU::compact_shadow_paths()
                 DEVICE_KERNEL_INTEGRATOR_COMPACT_SHADOW_PATHS_ARRAY,
                 DEVICE_KERNEL_INTEGRATOR_COMPACT_SHADOW_STATES);
 
+  /* Moving shadow path states leaves stale indices in the queued path lists. */
+  invalidate_queued_path_lists(true);
+
   /* Adjust max active path index now we know which part of the array is actually used. */
   integrator_next_shadow_path_index_.data()[0] = num_active_paths;
   queue_->copy_to_device(integrator_next_shadow_path_index_);
@@ -780,8 +953,40 @@ void PathTraceWorkGPU::compact_paths(const int num_active_paths,
   }
 }
 
+void PathTraceWorkGPU::process_queued_path_list_revalidation()
+{
+  /* Pick up the append cursor read-back scheduled by a launch which dispatched all paths
+   * queued for a kernel whose list had become unusable. With an empty queue every list entry
+   * is consumed, so aligning the consumed offset with the append cursor makes the list usable
+   * again. This is done lazily because the read-back has only finished once the scheduling
+   * loop synchronized the queue. */
+  if (queued_path_list_revalidate_kernel_ == DEVICE_KERNEL_NUM) {
+    return;
+  }
+
+  const DeviceKernel kernel = queued_path_list_revalidate_kernel_;
+  queued_path_list_consumed_[kernel] = integrator_queued_path_list_cursor_.data()[kernel];
+  queued_path_list_valid_[kernel] = true;
+  queued_path_list_revalidate_kernel_ = DEVICE_KERNEL_NUM;
+}
+
+void PathTraceWorkGPU::invalidate_queued_path_lists(const bool shadow)
+{
+  for (int i = 0; i < DEVICE_KERNEL_INTEGRATOR_NUM; i++) {
+    const DeviceKernel kernel = (DeviceKernel)i;
+    if (kernel_is_shadow_path(kernel) == shadow) {
+      queued_path_list_valid_[kernel] = false;
+      if (queued_path_list_revalidate_kernel_ == kernel) {
+        queued_path_list_revalidate_kernel_ = DEVICE_KERNEL_NUM;
+      }
+    }
+  }
+}
+
 bool PathTraceWorkGPU::enqueue_work_tiles(bool &finished)
 {
+  process_queued_path_list_revalidation();
+
   /* If there are existing paths wait them to go to intersect closest kernel, which will align the
    * wavefront of the existing and newly added paths. */
   /* TODO: Check whether counting new intersection kernels here will have positive affect on the
@@ -836,6 +1041,11 @@ bool PathTraceWorkGPU::enqueue_work_tiles(bool &finished)
     while (num_paths < max_num_camera_paths) {
       KernelWorkTile work_tile;
       if (work_tile_scheduler_.get_work(&work_tile, max_num_camera_paths - num_paths)) {
+        /* Do not spend path states on regions which have fully converged. */
+        if (is_work_tile_converged(work_tile)) {
+          continue;
+        }
+
         work_tiles.push_back(work_tile);
         num_paths += work_tile.w * work_tile.h * work_tile.num_samples;
       }
@@ -1026,8 +1236,30 @@ void PathTraceWorkGPU::copy_to_display_naive(PathTraceDisplay *display,
 
   get_render_tile_film_pixels(destination, pass_mode, num_samples);
 
-  queue_->copy_from_device(display_rgba_half_);
-  queue_->synchronize();
+  /* When the update covers the entire texture, copy from the device straight into the driver's
+   * mapped texture buffer. This skips the intermediate host-side buffer and one full-frame
+   * memcpy, which matters for interactive latency at high resolutions. Partial updates go
+   * through the host buffer since the mapped texture rows have a different pitch. */
+  if (texture_x == 0 && texture_y == 0 && width == final_width && height == final_height) {
+    const int2 texture_size = display->get_texture_size();
+    if (width == texture_size.x && height == texture_size.y) {
+      half4 *mapped_rgba_pixels = display->map_texture_buffer();
+      if (mapped_rgba_pixels) {
+        void *orig_host_pointer = display_rgba_half_.host_pointer;
+        display_rgba_half_.host_pointer = mapped_rgba_pixels;
+
+        queue_->copy_from_device_async(display_rgba_half_);
+        queue_->synchronize_transfer();
+
+        display_rgba_half_.host_pointer = orig_host_pointer;
+        display->unmap_texture_buffer();
+        return;
+      }
+    }
+  }
+
+  queue_->copy_from_device_async(display_rgba_half_);
+  queue_->synchronize_transfer();
 
   display->copy_pixels_to_texture(display_rgba_half_.data(), texture_x, texture_y, width, height);
 }
@@ -1053,6 +1285,10 @@ bool PathTraceWorkGPU::copy_to_display_interop(PathTraceDisplay *display,
 
   get_render_tile_film_pixels(destination, pass_mode, num_samples);
 
+  /* The conversion kernels write into the mapped graphics resource asynchronously, wait for them
+   * before unmapping. */
+  queue_->synchronize();
+
   device_graphics_interop_->unmap();
 
   return true;
@@ -1090,9 +1326,16 @@ int PathTraceWorkGPU::adaptive_sampling_converge_filter_count_active(const float
   const int num_active_pixels = adaptive_sampling_convergence_check_count_active(threshold, reset);
 
   if (num_active_pixels) {
-    enqueue_adaptive_sampling_filter_x();
-    enqueue_adaptive_sampling_filter_y();
+    enqueue_adaptive_sampling_filter();
+    enqueue_adaptive_sampling_count_active_blocks();
+    queue_->copy_from_device(num_active_pixels_per_block_);
     queue_->synchronize();
+
+    active_blocks_valid_ = true;
+    active_blocks_full_x_ = effective_buffer_params_.full_x;
+    active_blocks_full_y_ = effective_buffer_params_.full_y;
+    active_blocks_width_ = effective_buffer_params_.width;
+    active_blocks_height_ = effective_buffer_params_.height;
   }
 
   return num_active_pixels;
@@ -1132,25 +1375,73 @@ int PathTraceWorkGPU::adaptive_sampling_convergence_check_count_active(const flo
   return num_active_pixels.data()[0];
 }
 
-void PathTraceWorkGPU::enqueue_adaptive_sampling_filter_x()
+void PathTraceWorkGPU::enqueue_adaptive_sampling_count_active_blocks()
 {
-  const int work_size = effective_buffer_params_.height;
+  const int num_blocks_x = divide_up(effective_buffer_params_.width,
+                                     ADAPTIVE_SAMPLING_BLOCK_SIZE);
+  const int num_blocks_y = divide_up(effective_buffer_params_.height,
+                                     ADAPTIVE_SAMPLING_BLOCK_SIZE);
+  const int work_size = num_blocks_x * num_blocks_y;
   DCHECK_GT(work_size, 0);
 
+  if (num_active_pixels_per_block_.size() != work_size) {
+    num_active_pixels_per_block_.alloc(work_size);
+  }
+
   const DeviceKernelArguments args(&buffers_->buffer.device_pointer,
                                    &effective_buffer_params_.full_x,
                                    &effective_buffer_params_.full_y,
                                    &effective_buffer_params_.width,
                                    &effective_buffer_params_.height,
                                    &effective_buffer_params_.offset,
-                                   &effective_buffer_params_.stride);
+                                   &effective_buffer_params_.stride,
+                                   &num_active_pixels_per_block_.device_pointer);
+
+  queue_->enqueue(DEVICE_KERNEL_ADAPTIVE_SAMPLING_COUNT_ACTIVE_BLOCKS, work_size, args);
+}
+
+bool PathTraceWorkGPU::is_work_tile_converged(const KernelWorkTile &work_tile)
+{
+  if (!active_blocks_valid_) {
+    return false;
+  }
+
+  /* Counts from a different buffer geometry (for example after a resolution change) can not be
+   * mapped to this tile. */
+  if (active_blocks_full_x_ != effective_buffer_params_.full_x ||
+      active_blocks_full_y_ != effective_buffer_params_.full_y ||
+      active_blocks_width_ != effective_buffer_params_.width ||
+      active_blocks_height_ != effective_buffer_params_.height)
+  {
+    return false;
+  }
+
+  const int num_blocks_x = divide_up(active_blocks_width_, ADAPTIVE_SAMPLING_BLOCK_SIZE);
+
+  const int tile_x = work_tile.x - active_blocks_full_x_;
+  const int tile_y = work_tile.y - active_blocks_full_y_;
+
+  const int block_x_start = tile_x / ADAPTIVE_SAMPLING_BLOCK_SIZE;
+  const int block_y_start = tile_y / ADAPTIVE_SAMPLING_BLOCK_SIZE;
+  const int block_x_end = (tile_x + work_tile.w - 1) / ADAPTIVE_SAMPLING_BLOCK_SIZE;
+  const int block_y_end = (tile_y + work_tile.h - 1) / ADAPTIVE_SAMPLING_BLOCK_SIZE;
+
+  const uint *num_active_pixels_per_block = num_active_pixels_per_block_.data();
 
-  queue_->enqueue(DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER_X, work_size, args);
+  for (int block_y = block_y_start; block_y <= block_y_end; ++block_y) {
+    for (int block_x = block_x_start; block_x <= block_x_end; ++block_x) {
+      if (num_active_pixels_per_block[block_y * num_blocks_x + block_x] != 0) {
+        return false;
+      }
+    }
+  }
+
+  return true;
 }
 
-void PathTraceWorkGPU::enqueue_adaptive_sampling_filter_y()
+void PathTraceWorkGPU::enqueue_adaptive_sampling_filter()
 {
-  const int work_size = effective_buffer_params_.width;
+  const int work_size = effective_buffer_params_.width * effective_buffer_params_.height;
   DCHECK_GT(work_size, 0);
 
   const DeviceKernelArguments args(&buffers_->buffer.device_pointer,
@@ -1161,7 +1452,7 @@ void PathTraceWorkGPU::enqueue_adaptive_sampling_filter_y()
                                    &effective_buffer_params_.offset,
                                    &effective_buffer_params_.stride);
 
-  queue_->enqueue(DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER_Y, work_size, args);
+  queue_->enqueue(DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER, work_size, args);
 }
 
 void PathTraceWorkGPU::cryptomatte_postproces()
@@ -1179,6 +1470,23 @@ void PathTraceWorkGPU::cryptomatte_postproces()
   queue_->enqueue(DEVICE_KERNEL_CRYPTOMATTE_POSTPROCESS, work_size, args);
 }
 
+void PathTraceWorkGPU::set_kernel_timing_enabled(const bool enabled)
+{
+  queue_->set_kernel_timing_enabled(enabled);
+}
+
+void PathTraceWorkGPU::set_tile_order(const TileOrder tile_order)
+{
+  work_tile_scheduler_.set_tile_order(tile_order);
+}
+
+void PathTraceWorkGPU::collect_kernel_times(map<DeviceKernel, double> &times)
+{
+  for (const auto &[kernel, time] : queue_->kernel_times()) {
+    times[kernel] += time;
+  }
+}
+
 bool PathTraceWorkGPU::copy_render_buffers_from_device()
 {
   /* May not exist if cancelled before rendering started. */
@@ -1186,10 +1494,12 @@ bool PathTraceWorkGPU::copy_render_buffers_from_device()
     return false;
   }
 
-  queue_->copy_from_device(buffers_->buffer);
+  queue_->copy_from_device_async(buffers_->buffer);
 
-  /* Synchronize so that the CPU-side buffer is available at the exit of this function. */
-  return queue_->synchronize();
+  /* Synchronize so that the CPU-side buffer is available at the exit of this function. The copy
+   * runs on the transfer queue, so kernels enqueued on the main queue in the meantime (such as
+   * the next sample batch) overlap with it instead of being waited on. */
+  return queue_->synchronize_transfer();
 }
 
 bool PathTraceWorkGPU::copy_render_buffers_to_device()
@@ -1205,7 +1515,85 @@ bool PathTraceWorkGPU::copy_render_buffers_to_device()
 
 bool PathTraceWorkGPU::zero_render_buffers()
 {
-  queue_->zero_to_device(buffers_->buffer);
+  if (!buffers_->is_device_zeroed()) {
+    queue_->zero_to_device(buffers_->buffer);
+    buffers_->tag_device_zeroed();
+  }
+
+  /* All pixels require samples again. */
+  active_blocks_valid_ = false;
+
+  return true;
+}
+
+bool PathTraceWorkGPU::get_render_tile_pixels_from_device(
+    const PassAccessor::PassAccessInfo &pass_access_info,
+    const float exposure,
+    const int num_samples,
+    const PassAccessor::Destination &destination)
+{
+  /* May not exist if cancelled before rendering started. */
+  if (!buffers_->buffer.device_pointer) {
+    return false;
+  }
+
+  /* Only the simple dense float destination used by the tile output write is supported. Anything
+   * else falls back to the CPU pass accessor. */
+  if (destination.pixels == nullptr || destination.num_components == 0 ||
+      destination.pixels_half_rgba != nullptr || destination.stride != 0 ||
+      destination.pixel_stride != 0 || destination.pixel_offset != 0)
+  {
+    return false;
+  }
+
+  /* Padding of missing destination components is done on the host by the pass accessor
+   * (pad_pixels()), which the film convert kernel does not perform. */
+  const PassInfo pass_info = Pass::get_info(
+      pass_access_info.type, pass_access_info.include_albedo, pass_access_info.is_lightgroup);
+  if (destination.num_components > pass_info.num_components) {
+    return false;
+  }
+
+  const BufferParams &buffer_params = buffers_->params;
+  const int64_t work_size = int64_t(buffer_params.window_width) * buffer_params.window_height;
+  const int64_t num_floats = work_size * destination.num_components;
+  if (num_floats == 0) {
+    return true;
+  }
+
+  if (pass_pixels_.size() != size_t(num_floats)) {
+    pass_pixels_.alloc(num_floats);
+    /* TODO(sergey): There should be a way to make sure device-side memory is allocated without
+     * transferring zeroes to the device. */
+    queue_->zero_to_device(pass_pixels_);
+  }
+
+  const PassAccessorGPU pass_accessor(queue_.get(), pass_access_info, exposure, num_samples);
+
+  PassAccessor::Destination device_destination = destination;
+  device_destination.pixels = nullptr;
+  device_destination.d_pixels = pass_pixels_.device_pointer;
+  device_destination.offset = 0;
+
+  if (!pass_accessor.get_render_tile_pixels(buffers_.get(), buffer_params, device_destination)) {
+    return false;
+  }
+
+  queue_->copy_from_device(pass_pixels_);
+  if (!queue_->synchronize()) {
+    return false;
+  }
+
+  /* Store into the destination, applying the big tile slice offset of this work the same way
+   * `get_render_tile_pixels()` does. */
+  const int offset_y = (effective_buffer_params_.full_y + effective_buffer_params_.window_y) -
+                       (effective_big_tile_params_.full_y + effective_big_tile_params_.window_y);
+  const int64_t pixel_offset = int64_t(offset_y) * effective_buffer_params_.width +
+                               destination.offset;
+
+  memcpy(destination.pixels + pixel_offset * destination.num_components,
+         pass_pixels_.data(),
+         num_floats * sizeof(float));
 
   return true;
 }
@@ -1269,6 +1657,33 @@ bool PathTraceWorkGPU::kernel_is_shadow_path(DeviceKernel kernel)
           kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW);
 }
 
+bool PathTraceWorkGPU::kernel_is_dedicated_light_path(DeviceKernel kernel)
+{
+  return (kernel == DEVICE_KERNEL_INTEGRATOR_INTERSECT_DEDICATED_LIGHT ||
+          kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_DEDICATED_LIGHT);
+}
+
+bool PathTraceWorkGPU::kernel_has_queued_path_list(DeviceKernel kernel)
+{
+  /* Kernels which use sorting dispatch through the sort key machinery instead, and the
+   * subsurface intersection kernel may requeue paths for itself when a random walk runs out of
+   * its per-dispatch bounce budget, which would append to the list that is being consumed. */
+  switch (kernel) {
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST:
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW:
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_VOLUME_STACK:
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_DEDICATED_LIGHT:
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND:
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT:
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW:
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME:
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_DEDICATED_LIGHT:
+      return true;
+    default:
+      return false;
+  }
+}
+
 int PathTraceWorkGPU::kernel_max_active_main_path_index(DeviceKernel kernel)
 {
   return (kernel_is_shadow_path(kernel)) ? integrator_next_shadow_path_index_.data()[0] :
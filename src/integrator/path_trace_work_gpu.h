@@ -48,9 +48,19 @@ class PathTraceWorkGPU : public PathTraceWork {
   bool copy_render_buffers_to_device() override;
   bool zero_render_buffers() override;
 
+  bool get_render_tile_pixels_from_device(const PassAccessor::PassAccessInfo &pass_access_info,
+                                          const float exposure,
+                                          const int num_samples,
+                                          const PassAccessor::Destination &destination) override;
+
   int adaptive_sampling_converge_filter_count_active(const float threshold, bool reset) override;
   void cryptomatte_postproces() override;
 
+  void set_kernel_timing_enabled(const bool enabled) override;
+  void collect_kernel_times(map<DeviceKernel, double> &times) override;
+
+  void set_tile_order(const TileOrder tile_order) override;
+
  protected:
   void alloc_integrator_soa();
   void alloc_integrator_queue();
@@ -75,6 +85,15 @@ class PathTraceWorkGPU : public PathTraceWork {
   void compute_queued_paths(DeviceKernel kernel, DeviceKernel queued_kernel);
   void compute_sorted_queued_paths(DeviceKernel queued_kernel, const int num_paths_limit);
 
+  /* Whether the kernel has an incrementally maintained ring buffer of queued path indices. */
+  bool kernel_has_queued_path_list(DeviceKernel kernel);
+  /* Pick up the append cursor read-back scheduled by a launch which emptied the queue of a
+   * kernel whose list had become unusable, making the list usable again. */
+  void process_queued_path_list_revalidation();
+  /* Mark the lists of either main or shadow path kernels as unusable, after path states have
+   * been moved by compaction. */
+  void invalidate_queued_path_lists(const bool shadow);
+
   void compact_main_paths(const int num_active_paths);
   void compact_shadow_paths();
   void compact_paths(const int num_active_paths,
@@ -104,8 +123,12 @@ class PathTraceWorkGPU : public PathTraceWork {
                                    int num_samples);
 
   int adaptive_sampling_convergence_check_count_active(const float threshold, bool reset);
-  void enqueue_adaptive_sampling_filter_x();
-  void enqueue_adaptive_sampling_filter_y();
+  void enqueue_adaptive_sampling_count_active_blocks();
+
+  /* Check whether all pixels covered by the work tile have converged, based on the per-block
+   * counts from the latest adaptive sampling filter. */
+  bool is_work_tile_converged(const KernelWorkTile &work_tile);
+  void enqueue_adaptive_sampling_filter();
 
   bool has_shadow_catcher() const;
 
@@ -117,6 +140,7 @@ class PathTraceWorkGPU : public PathTraceWork {
   bool kernel_creates_shadow_paths(DeviceKernel kernel);
   bool kernel_creates_ao_paths(DeviceKernel kernel);
   bool kernel_is_shadow_path(DeviceKernel kernel);
+  bool kernel_is_dedicated_light_path(DeviceKernel kernel);
   int kernel_max_active_main_path_index(DeviceKernel kernel);
 
   /* Integrator queue. */
@@ -147,13 +171,43 @@ class PathTraceWorkGPU : public PathTraceWork {
   device_vector<int> queued_paths_;
   device_vector<int> num_queued_paths_;
 
+  /* Per-kernel ring buffers with the indices of queued paths, appended to by the kernels as
+   * they queue paths and consumed in append order by the launches, which keeps launches dense
+   * without scanning all path states. See enqueue_path_iteration(). */
+  device_vector<int> integrator_queued_path_lists_;
+  device_vector<uint> integrator_queued_path_list_cursor_;
+  uint queued_path_list_capacity_ = 0;
+  /* How many list entries have been dispatched, in the same monotonic units as the device
+   * side append cursors. */
+  uint queued_path_list_consumed_[DEVICE_KERNEL_INTEGRATOR_NUM] = {};
+  /* Whether the unconsumed part of the list exactly matches the paths queued for the kernel.
+   * Becomes false when compaction moves path states, making list entries stale. */
+  bool queued_path_list_valid_[DEVICE_KERNEL_INTEGRATOR_NUM] = {};
+  /* Kernel whose list becomes usable again once the append cursor read-back is picked up. */
+  DeviceKernel queued_path_list_revalidate_kernel_ = DEVICE_KERNEL_NUM;
+
   /* Temporary buffer for passing work tiles to kernel. */
   device_vector<KernelWorkTile> work_tiles_;
 
+  /* Number of pixels that still require samples for every ADAPTIVE_SAMPLING_BLOCK_SIZE sized
+   * block of the render buffer, updated by the adaptive sampling filter. Work tiles whose
+   * blocks all reached zero are not scheduled anymore. Only trusted while valid and computed
+   * for the current effective buffer parameters. */
+  device_vector<uint> num_active_pixels_per_block_;
+  bool active_blocks_valid_ = false;
+  int active_blocks_full_x_ = 0;
+  int active_blocks_full_y_ = 0;
+  int active_blocks_width_ = 0;
+  int active_blocks_height_ = 0;
+
   /* Temporary buffer used by the copy_to_display() whenever graphics interoperability is not
    * available. Is allocated on-demand. */
   device_vector<half4> display_rgba_half_;
 
+  /* Temporary buffer used by get_render_tile_pixels_from_device() to read back converted pass
+   * pixels. Is allocated on-demand. */
+  device_vector<float> pass_pixels_;
+
   unique_ptr<DeviceGraphicsInterop> device_graphics_interop_;
 
   /* Cached result of device->should_use_graphics_interop(). */
@@ -157,6 +157,8 @@ void RenderScheduler::reset(const BufferParams &buffer_params)
   state_.end_render_time = 0.0;
   state_.time_limit_reached = false;
 
+  state_.last_num_samples_per_update = 0;
+
   state_.occupancy_num_samples = 0;
   state_.occupancy = 1.0f;
 
@@ -171,6 +173,11 @@ void RenderScheduler::reset(const BufferParams &buffer_params)
   rebalance_time_.reset();
 }
 
+void RenderScheduler::set_num_rendered_samples(const int num_rendered_samples)
+{
+  state_.num_rendered_samples = num_rendered_samples;
+}
+
 void RenderScheduler::reset_for_next_tile()
 {
   reset(buffer_params_);
@@ -383,6 +390,10 @@ void RenderScheduler::update_state_for_render_work(const RenderWork &render_work
     state_.last_display_update_sample = state_.num_rendered_samples;
   }
 
+  if (render_work.resolution_divider == pixel_size_ && render_work.path_trace.num_samples > 0) {
+    state_.last_num_samples_per_update = render_work.path_trace.num_samples;
+  }
+
   state_.last_work_tile_was_denoised = render_work.tile.denoise;
   state_.tile_result_was_written |= render_work.tile.write;
   state_.full_frame_was_written |= render_work.full.write;
@@ -593,6 +604,17 @@ void RenderScheduler::report_rebalance_time(const RenderWork &render_work,
   VLOG_WORK << "Average rebalance time: " << rebalance_time_.get_average() << " seconds.";
 }
 
+void RenderScheduler::get_phase_times(double &path_trace_time,
+                                      double &denoise_time,
+                                      double &display_update_time,
+                                      double &rebalance_time) const
+{
+  path_trace_time = path_trace_time_.get_wall();
+  denoise_time = denoise_time_.get_wall();
+  display_update_time = display_update_time_.get_wall();
+  rebalance_time = rebalance_time_.get_wall();
+}
+
 string RenderScheduler::full_report() const
 {
   const double render_wall_time = state_.end_render_time - state_.start_render_time;
@@ -771,17 +793,41 @@ double RenderScheduler::guess_display_update_interval_in_seconds_for_num_samples
 
 int RenderScheduler::calculate_num_samples_per_update() const
 {
-  const double time_per_sample_average = path_trace_time_.get_average();
+  /* Predict from the smoothed per-sample time, which reacts quicker than the overall average to
+   * throughput changes (like adaptive sampling kicking in), but does not oscillate from a single
+   * render work which happened to be timed together with heavy display activity. */
+  double time_per_sample = path_trace_time_.get_ewma();
+  if (time_per_sample == 0.0) {
+    time_per_sample = path_trace_time_.get_average();
+  }
   /* Fall back to 1 sample if we have not recorded a time yet. */
-  if (time_per_sample_average == 0.0) {
+  if (time_per_sample == 0.0) {
     return 1;
   }
 
-  const double num_samples_in_second = pixel_size_ * pixel_size_ / time_per_sample_average;
-
   const double update_interval_in_seconds = guess_display_update_interval_in_seconds();
 
-  int num_samples_per_update = max(int(num_samples_in_second * update_interval_in_seconds), 1);
+  /* Solve for the number of samples which makes path tracing plus the predicted per-update
+   * overhead (denoising and display update) hit the update interval, rather than consuming the
+   * entire interval with path tracing and overshooting by the overhead. Leave at least half of
+   * the interval to path tracing, so that heavy denoising can not starve actual rendering. */
+  const double overhead_time = denoise_time_.get_ewma() + display_update_time_.get_ewma();
+  const double path_trace_interval = max(update_interval_in_seconds - overhead_time,
+                                         update_interval_in_seconds * 0.5);
+
+  const double num_samples_in_interval = pixel_size_ * pixel_size_ * path_trace_interval /
+                                         time_per_sample;
+
+  int num_samples_per_update = max(int(num_samples_in_interval), 1);
+
+  /* Hysteresis: when the prediction is within 25% of the previously scheduled batch size, keep
+   * the previous size. Without this the batch size flip-flops between neighboring values as the
+   * timings of works with and without denoising alternate. */
+  const int last_num_samples = state_.last_num_samples_per_update;
+  if (last_num_samples > 0 && abs(num_samples_per_update - last_num_samples) * 4 < last_num_samples)
+  {
+    num_samples_per_update = last_num_samples;
+  }
 
   if (limit_samples_per_update_) {
     num_samples_per_update = min(limit_samples_per_update_, num_samples_per_update);
@@ -164,6 +164,13 @@ class RenderScheduler {
    * Resets current rendered state, as well as scheduling information. */
   void reset(const BufferParams &buffer_params);
 
+  /* Resume an interrupted render from a checkpoint: consider the given number
+   * of samples as already rendered, so that scheduling continues from there
+   * and the render buffers are not re-initialized.
+   *
+   * Expected to be called right after reset(). */
+  void set_num_rendered_samples(const int num_rendered_samples);
+
   /* Reset scheduler upon switching to a next tile.
    * Will keep the same number of samples and full-frame render parameters, but will reset progress
    * and allow schedule renders works from the beginning of the new tile. */
@@ -212,6 +219,12 @@ class RenderScheduler {
    * times, and so on. */
   string full_report() const;
 
+  /* Wall time spent in the main render phases so far, for the session stats report. */
+  void get_phase_times(double &path_trace_time,
+                       double &denoise_time,
+                       double &display_update_time,
+                       double &rebalance_time) const;
+
   void set_limit_samples_per_update(const int limit_samples);
 
  protected:
@@ -309,7 +322,11 @@ class RenderScheduler {
    * took to complete all tasks of a type. Is always advanced when PathTracer reports time update.
    *
    * The average time is used for scheduling purposes. It is estimated to be a time of how long it
-   * takes to perform task on the final resolution. */
+   * takes to perform task on the final resolution.
+   *
+   * Additionally an exponentially-weighted moving average over the per-measurement times is
+   * maintained. It reacts to throughput changes quicker than the overall average, but unlike the
+   * last sample time it is not perturbed by a single noisy measurement. */
   class TimeWithAverage {
    public:
     void reset()
@@ -320,6 +337,7 @@ class RenderScheduler {
       num_average_times_ = 0;
 
       last_sample_time_ = 0.0;
+      ewma_time_ = 0.0;
     }
 
     void add_wall(const double time)
@@ -329,9 +347,18 @@ class RenderScheduler {
 
     void add_average(const double time, const int num_measurements = 1)
     {
+      const double time_per_measurement = time / num_measurements;
+
+      if (num_average_times_ == 0) {
+        ewma_time_ = time_per_measurement;
+      }
+      else {
+        ewma_time_ = ewma_time_ * (1.0 - EWMA_WEIGHT) + time_per_measurement * EWMA_WEIGHT;
+      }
+
       average_time_accumulator_ += time;
       num_average_times_ += num_measurements;
-      last_sample_time_ = time / num_measurements;
+      last_sample_time_ = time_per_measurement;
     }
 
     double get_wall() const
@@ -352,19 +379,31 @@ class RenderScheduler {
       return last_sample_time_;
     }
 
+    /* Smoothed per-measurement time estimate. Zero when no time was recorded yet. */
+    double get_ewma() const
+    {
+      return ewma_time_;
+    }
+
     void reset_average()
     {
       average_time_accumulator_ = 0.0;
       num_average_times_ = 0;
+
+      ewma_time_ = 0.0;
     }
 
    protected:
+    /* Weight of the newest measurement in the exponentially-weighted moving average. */
+    static constexpr double EWMA_WEIGHT = 0.25;
+
     double total_wall_time_ = 0.0;
 
     double average_time_accumulator_ = 0.0;
     int num_average_times_ = 0;
 
     double last_sample_time_ = 0.0;
+    double ewma_time_ = 0.0;
   };
 
   struct {
@@ -413,6 +452,12 @@ class RenderScheduler {
     double start_render_time = 0.0;
     double end_render_time = 0.0;
 
+    /* Number of samples of the latest scheduled path trace work at the final resolution.
+     * Used as a hysteresis reference: a new predicted batch size which is close to this value is
+     * snapped to it, so that the batch size does not oscillate when denoising or display updates
+     * perturb the timings. */
+    int last_num_samples_per_update = 0;
+
     /* Measured occupancy of the render devices measured normalized to the number of samples.
      *
      * In a way it is "trailing": when scheduling new work this occupancy is measured when the
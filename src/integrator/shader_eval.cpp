@@ -75,6 +75,141 @@ bool ShaderEval::eval(const ShaderEvalType type,
   return success;
 }
 
+void ShaderEval::eval_queue(
+    const ShaderEvalType type,
+    const int max_num_inputs,
+    const int num_channels,
+    const std::function<int(device_vector<KernelShaderEvalInput> &)> &fill_input,
+    const std::function<void(device_vector<float> &)> &read_output)
+{
+  queued_.push_back({type, max_num_inputs, num_channels, fill_input, read_output});
+}
+
+bool ShaderEval::eval_queued()
+{
+  bool success = true;
+
+  /* Requests of the same type share a kernel and channel count, so they can be
+   * concatenated into one dispatch. */
+  const ShaderEvalType types[] = {
+      SHADER_EVAL_DISPLACE, SHADER_EVAL_BACKGROUND, SHADER_EVAL_CURVE_SHADOW_TRANSPARENCY};
+
+  for (const ShaderEvalType type : types) {
+    vector<EvalRequest *> requests;
+    for (EvalRequest &request : queued_) {
+      if (request.type == type) {
+        requests.push_back(&request);
+      }
+    }
+
+    if (requests.empty()) {
+      continue;
+    }
+
+    if (requests.size() == 1) {
+      /* A single request of this type, no batching needed. */
+      const EvalRequest *request = requests[0];
+      success &= eval(request->type,
+                      request->max_num_inputs,
+                      request->num_channels,
+                      request->fill_input,
+                      request->read_output);
+    }
+    else {
+      success &= eval_batch(type, requests);
+    }
+
+    if (!success) {
+      break;
+    }
+  }
+
+  queued_.clear();
+
+  return success;
+}
+
+bool ShaderEval::eval_batch(const ShaderEvalType type, const vector<EvalRequest *> &requests)
+{
+  bool first_device = true;
+  bool success = true;
+
+  device_->foreach_device([&](Device *device) {
+    if (!first_device) {
+      VLOG_WORK << "Multi-devices are not yet fully implemented, will evaluate shader on a "
+                   "single device.";
+      return;
+    }
+    first_device = false;
+
+    const int num_channels = requests[0]->num_channels;
+
+    int max_total_inputs = 0;
+    for (const EvalRequest *request : requests) {
+      max_total_inputs += request->max_num_inputs;
+    }
+
+    device_vector<KernelShaderEvalInput> input(device, "ShaderEval input", MEM_READ_ONLY);
+    device_vector<float> output(device, "ShaderEval output", MEM_READ_WRITE);
+
+    input.alloc(max_total_inputs);
+
+    /* Fill each request into a host side staging buffer and concatenate into the
+     * shared input buffer. The batched path is meant for many small evaluations,
+     * so the extra host copy is noise next to the per-dispatch overhead it avoids. */
+    vector<int> num_points(requests.size());
+    int total_points = 0;
+    {
+      device_vector<KernelShaderEvalInput> staging(device, "ShaderEval input", MEM_READ_ONLY);
+      for (size_t i = 0; i < requests.size(); i++) {
+        staging.alloc(requests[i]->max_num_inputs);
+        num_points[i] = requests[i]->fill_input(staging);
+        memcpy(input.data() + total_points,
+               staging.data(),
+               num_points[i] * sizeof(KernelShaderEvalInput));
+        total_points += num_points[i];
+      }
+      staging.free();
+    }
+
+    if (total_points == 0) {
+      input.free();
+      return;
+    }
+
+    input.copy_to_device();
+    output.alloc(total_points * num_channels);
+    output.zero_to_device();
+
+    /* Evaluate all requests in one go, on CPU or GPU. */
+    success = (device->info.type == DEVICE_CPU) ?
+                  eval_cpu(device, type, input, output, total_points) :
+                  eval_gpu(device, type, input, output, total_points);
+
+    /* Copy data back from device and hand each request its slice of the output. */
+    if (success) {
+      output.copy_from_device(0, 1, output.size());
+
+      device_vector<float> slice(device, "ShaderEval output", MEM_READ_WRITE);
+      int output_offset = 0;
+      for (size_t i = 0; i < requests.size(); i++) {
+        if (num_points[i] > 0) {
+          slice.alloc(num_points[i] * num_channels);
+          memcpy(slice.data(), output.data() + output_offset, slice.size() * sizeof(float));
+          requests[i]->read_output(slice);
+          output_offset += num_points[i] * num_channels;
+        }
+      }
+      slice.free();
+    }
+
+    input.free();
+    output.free();
+  });
+
+  return success;
+}
+
 bool ShaderEval::eval_cpu(Device *device,
                           const ShaderEvalType type,
                           device_vector<KernelShaderEvalInput> &input,
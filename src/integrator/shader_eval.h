@@ -10,6 +10,8 @@
 
 #include "kernel/types.h"
 
+#include "util/vector.h"
+
 namespace ccl {
 
 class Device;
@@ -34,7 +36,31 @@ class ShaderEval {
             const std::function<int(device_vector<KernelShaderEvalInput> &)> &fill_input,
             const std::function<void(device_vector<float> &)> &read_output);
 
+  /* Queue an evaluation to be executed later by eval_queued(), together with other queued
+   * requests of the same type, as a single device dispatch. Scene sync issues one evaluation
+   * per modified geometry, and for many small geometries the per-dispatch launch and readback
+   * overhead dominates; batching pays it once. The read_output callback receives a buffer
+   * holding just this request's channels, in the same layout as the immediate eval(). */
+  void eval_queue(const ShaderEvalType type,
+                  const int max_num_inputs,
+                  const int num_channels,
+                  const std::function<int(device_vector<KernelShaderEvalInput> &)> &fill_input,
+                  const std::function<void(device_vector<float> &)> &read_output);
+
+  /* Execute all queued evaluations. Returns false when canceled. */
+  bool eval_queued();
+
  protected:
+  struct EvalRequest {
+    ShaderEvalType type;
+    int max_num_inputs;
+    int num_channels;
+    std::function<int(device_vector<KernelShaderEvalInput> &)> fill_input;
+    std::function<void(device_vector<float> &)> read_output;
+  };
+
+  bool eval_batch(const ShaderEvalType type, const vector<EvalRequest *> &requests);
+
   bool eval_cpu(Device *device,
                 const ShaderEvalType type,
                 device_vector<KernelShaderEvalInput> &input,
@@ -48,6 +74,8 @@ class ShaderEval {
 
   Device *device_;
   Progress &progress_;
+
+  vector<EvalRequest> queued_;
 };
 
 }
@@ -4,6 +4,7 @@
 
 #include "integrator/tile.h"
 
+#include "util/algorithm.h"
 #include "util/log.h"
 #include "util/math_base.h"
 
@@ -36,6 +37,84 @@ ccl_device_inline uint round_up_to_power_of_two(const uint x)
   return next_power_of_two(x);
 }
 
+void tile_order_compute(vector<int> &order,
+                        const TileOrder tile_order,
+                        const int num_tiles_x,
+                        const int num_tiles_y)
+{
+  const int num_tiles = num_tiles_x * num_tiles_y;
+  order.resize(num_tiles);
+
+  if (num_tiles == 0) {
+    return;
+  }
+
+  switch (tile_order) {
+    case TileOrder::SCANLINE: {
+      for (int i = 0; i < num_tiles; i++) {
+        order[i] = i;
+      }
+      break;
+    }
+    case TileOrder::HILBERT: {
+      /* Walk a Hilbert curve over the smallest power-of-two square covering
+       * the tile grid, skipping cells which fall outside of it. */
+      const uint64_t side = max(1u, round_up_to_power_of_two(max(num_tiles_x, num_tiles_y)));
+      int count = 0;
+      for (uint64_t d = 0; d < side * side; d++) {
+        uint64_t x = 0, y = 0;
+        uint64_t t = d;
+        for (uint64_t s = 1; s < side; s *= 2) {
+          const uint64_t rx = 1 & (t / 2);
+          const uint64_t ry = 1 & (t ^ rx);
+          if (ry == 0) {
+            if (rx == 1) {
+              x = s - 1 - x;
+              y = s - 1 - y;
+            }
+            swap(x, y);
+          }
+          x += s * rx;
+          y += s * ry;
+          t /= 4;
+        }
+        if (x < (uint64_t)num_tiles_x && y < (uint64_t)num_tiles_y) {
+          order[count++] = (int)(y * num_tiles_x + x);
+        }
+      }
+      break;
+    }
+    case TileOrder::SPIRAL: {
+      /* Clockwise spiral from the center tile outwards, skipping positions
+       * which spiral out of the grid on the shorter axis. */
+      int x = (num_tiles_x - 1) / 2;
+      int y = (num_tiles_y - 1) / 2;
+      int dx = 1, dy = 0;
+      int segment = 1, segment_passed = 0, turns = 0;
+      int count = 0;
+      while (count < num_tiles) {
+        if (x >= 0 && x < num_tiles_x && y >= 0 && y < num_tiles_y) {
+          order[count++] = y * num_tiles_x + x;
+        }
+        x += dx;
+        y += dy;
+        if (++segment_passed == segment) {
+          segment_passed = 0;
+          /* Rotate direction right. */
+          const int t = dx;
+          dx = -dy;
+          dy = t;
+          if (++turns == 2) {
+            turns = 0;
+            segment++;
+          }
+        }
+      }
+      break;
+    }
+  }
+}
+
 TileSize tile_calculate_best_size(const bool accel_rt,
                                   const int2 &image_size,
                                   const int num_samples,
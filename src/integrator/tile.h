@@ -7,9 +7,29 @@
 #include <iosfwd>
 
 #include "util/types_int2.h"
+#include "util/vector.h"
 
 namespace ccl {
 
+/* Traversal order of tiles over the image.
+ *
+ * Scanline is the historical row-by-row order. Hilbert keeps successive tiles
+ * spatially adjacent, which improves texture and BVH cache coherence between
+ * tiles. Spiral renders from the center outwards, giving earlier feedback on
+ * the subject of the image. */
+enum class TileOrder {
+  SCANLINE = 0,
+  HILBERT = 1,
+  SPIRAL = 2,
+};
+
+/* Compute the permutation from schedule position to scanline tile index for
+ * the given tile grid and traversal order. Identity for scanline order. */
+void tile_order_compute(vector<int> &order,
+                        const TileOrder tile_order,
+                        const int num_tiles_x,
+                        const int num_tiles_y);
+
 struct TileSize {
   TileSize() = default;
 
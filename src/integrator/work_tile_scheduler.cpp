@@ -18,6 +18,11 @@ void WorkTileScheduler::set_accelerated_rt(bool accelerated_rt)
   accelerated_rt_ = accelerated_rt;
 }
 
+void WorkTileScheduler::set_tile_order(const TileOrder tile_order)
+{
+  tile_order_ = tile_order;
+}
+
 void WorkTileScheduler::set_max_num_path_states(const int max_num_path_states)
 {
   max_num_path_states_ = max_num_path_states;
@@ -78,6 +83,13 @@ void WorkTileScheduler::reset_scheduler_state()
 
   total_tiles_num_ = num_tiles_x_ * num_tiles_y_;
 
+  if (tile_order_ != TileOrder::SCANLINE) {
+    tile_order_compute(tile_order_map_, tile_order_, num_tiles_x_, num_tiles_y_);
+  }
+  else {
+    tile_order_map_.clear();
+  }
+
   next_work_index_ = 0;
   total_work_size_ = total_tiles_num_ * num_tiles_per_sample_range_;
 }
@@ -99,7 +111,10 @@ bool WorkTileScheduler::get_work(KernelWorkTile *work_tile_, const int max_work_
 
   const int sample_range_index = work_index % num_tiles_per_sample_range_;
   const int start_sample = sample_range_index * tile_size_.num_samples;
-  const int tile_index = work_index / num_tiles_per_sample_range_;
+  int tile_index = work_index / num_tiles_per_sample_range_;
+  if (!tile_order_map_.empty()) {
+    tile_index = tile_order_map_[tile_index];
+  }
   const int tile_y = tile_index / num_tiles_x_;
   const int tile_x = tile_index - tile_y * num_tiles_x_;
 
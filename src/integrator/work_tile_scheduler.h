@@ -23,6 +23,9 @@ class WorkTileScheduler {
   /* To indicate if there is accelerated RT support. */
   void set_accelerated_rt(bool accelerated_rt);
 
+  /* Traversal order of the tiles over the image. */
+  void set_tile_order(const TileOrder tile_order);
+
   /* MAximum path states which are allowed to be used by a single scheduled work tile.
    *
    * Affects the scheduled work size: the work size will be as big as possible, but will not exceed
@@ -94,6 +97,11 @@ class WorkTileScheduler {
    * how many tiles are to be "stacked" to cover the entire requested range of samples. */
   int num_tiles_per_sample_range_ = 0;
 
+  /* Tile traversal order, with the permutation from schedule position to
+   * scanline tile index. Empty for the default scanline order. */
+  TileOrder tile_order_ = TileOrder::SCANLINE;
+  vector<int> tile_order_map_;
+
   int next_work_index_ = 0;
   int total_work_size_ = 0;
 };
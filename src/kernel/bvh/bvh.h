@@ -141,6 +141,17 @@ ccl_device_intersect bool scene_intersect_shadow(KernelGlobals kg,
                                                  const ccl_private Ray *ray,
                                                  const uint visibility)
 {
+#  if defined(__EMBREE__) && !defined(__KERNEL_ONEAPI__) && EMBREE_MAJOR_VERSION >= 4
+  /* Opaque shadow rays only need to know whether anything is hit at all, which the boolean
+   * occlusion query answers with any-hit traversal instead of searching for the closest hit. */
+  if (kernel_data.device_bvh) {
+    if (!intersection_ray_valid(ray)) {
+      return false;
+    }
+    return kernel_embree_intersect_shadow(kg, ray, visibility);
+  }
+#  endif
+
   Intersection isect;
   return scene_intersect(kg, ray, visibility, &isect);
 }
@@ -5,6 +5,8 @@
 #include "kernel/geom/object.h"
 #include "kernel/globals.h"
 
+#include "util/half.h"
+
 namespace ccl {
 
 // TODO(sergey): Look into avoid use of full Transform and use 3x3 matrix and
@@ -21,6 +23,56 @@ ccl_device_forceinline Transform bvh_unaligned_node_fetch_space(KernelGlobals kg
   return space;
 }
 
+/* Compact nodes take two slots instead of four: each 32 bit word in the pair
+ * of bounding boxes holds the quantized minimum in the lower and the maximum
+ * in the upper 16 bits. Quantization is conservative, so decoded bounds never
+ * shrink below the true ones. There are no per-child visibility masks; the
+ * leaf level visibility test still culls correctly, compact nodes just give
+ * up this early-out to halve node memory. */
+ccl_device_forceinline int bvh_compact_node_intersect(KernelGlobals kg,
+                                                      const float3 P,
+                                                      const float3 idir,
+                                                      const float tmin,
+                                                      const float tmax,
+                                                      const int node_addr,
+                                                      float dist[2])
+{
+  const float4 node0 = kernel_data_fetch(bvh_nodes, node_addr + 0);
+  const float4 node1 = kernel_data_fetch(bvh_nodes, node_addr + 1);
+
+  const uint b0x = __float_as_uint(node0.x);
+  const uint b0y = __float_as_uint(node0.y);
+  const uint b0z = __float_as_uint(node1.x);
+  const uint b1x = __float_as_uint(node1.y);
+  const uint b1y = __float_as_uint(node1.z);
+  const uint b1z = __float_as_uint(node1.w);
+
+  /* intersect ray against child nodes */
+  const float c0lox = (half_bits_to_float(b0x & 0xffff) - P.x) * idir.x;
+  const float c0hix = (half_bits_to_float(b0x >> 16) - P.x) * idir.x;
+  const float c0loy = (half_bits_to_float(b0y & 0xffff) - P.y) * idir.y;
+  const float c0hiy = (half_bits_to_float(b0y >> 16) - P.y) * idir.y;
+  const float c0loz = (half_bits_to_float(b0z & 0xffff) - P.z) * idir.z;
+  const float c0hiz = (half_bits_to_float(b0z >> 16) - P.z) * idir.z;
+  const float c0min = max4(tmin, min(c0lox, c0hix), min(c0loy, c0hiy), min(c0loz, c0hiz));
+  const float c0max = min4(tmax, max(c0lox, c0hix), max(c0loy, c0hiy), max(c0loz, c0hiz));
+
+  const float c1lox = (half_bits_to_float(b1x & 0xffff) - P.x) * idir.x;
+  const float c1hix = (half_bits_to_float(b1x >> 16) - P.x) * idir.x;
+  const float c1loy = (half_bits_to_float(b1y & 0xffff) - P.y) * idir.y;
+  const float c1hiy = (half_bits_to_float(b1y >> 16) - P.y) * idir.y;
+  const float c1loz = (half_bits_to_float(b1z & 0xffff) - P.z) * idir.z;
+  const float c1hiz = (half_bits_to_float(b1z >> 16) - P.z) * idir.z;
+  const float c1min = max4(tmin, min(c1lox, c1hix), min(c1loy, c1hiy), min(c1loz, c1hiz));
+  const float c1max = min4(tmax, max(c1lox, c1hix), max(c1loy, c1hiy), max(c1loz, c1hiz));
+
+  dist[0] = c0min;
+  dist[1] = c1min;
+
+  return ((c0max >= c0min) ? 1 : 0) | ((c1max >= c1min) ? 2 : 0);
+}
+
+#if defined(__KERNEL_SSE2__)
 ccl_device_forceinline int bvh_aligned_node_intersect(KernelGlobals kg,
                                                       const float3 P,
                                                       const float3 idir,
@@ -30,11 +82,68 @@ ccl_device_forceinline int bvh_aligned_node_intersect(KernelGlobals kg,
                                                       const uint visibility,
                                                       float dist[2])
 {
+  if (kernel_data.bvh.use_compact) {
+    return bvh_compact_node_intersect(kg, P, idir, tmin, tmax, node_addr, dist);
+  }
 
   /* fetch node data */
-#ifdef __VISIBILITY_FLAG__
+#  ifdef __VISIBILITY_FLAG__
+  const float4 cnodes = kernel_data_fetch(bvh_nodes, node_addr + 0);
+#  endif
+  const float4 node0 = kernel_data_fetch(bvh_nodes, node_addr + 1);
+  const float4 node1 = kernel_data_fetch(bvh_nodes, node_addr + 2);
+  const float4 node2 = kernel_data_fetch(bvh_nodes, node_addr + 3);
+
+  /* Intersect ray against both child nodes at once. Per axis the node stores
+   * (c0lo, c1lo, c0hi, c1hi), so a single set of float4 operations computes
+   * the slab test for both children instead of leaving SIMD lanes idle. */
+  const float4 tx = (node0 - make_float4(P.x)) * make_float4(idir.x);
+  const float4 ty = (node1 - make_float4(P.y)) * make_float4(idir.y);
+  const float4 tz = (node2 - make_float4(P.z)) * make_float4(idir.z);
+
+  /* Lanes 0,1 hold the per-child near/far distances; lo/hi still need to be
+   * ordered since the ray direction may be negative along an axis. */
+  const float4 tnear_x = min(shuffle<0, 1, 0, 1>(tx), shuffle<2, 3, 2, 3>(tx));
+  const float4 tfar_x = max(shuffle<0, 1, 0, 1>(tx), shuffle<2, 3, 2, 3>(tx));
+  const float4 tnear_y = min(shuffle<0, 1, 0, 1>(ty), shuffle<2, 3, 2, 3>(ty));
+  const float4 tfar_y = max(shuffle<0, 1, 0, 1>(ty), shuffle<2, 3, 2, 3>(ty));
+  const float4 tnear_z = min(shuffle<0, 1, 0, 1>(tz), shuffle<2, 3, 2, 3>(tz));
+  const float4 tfar_z = max(shuffle<0, 1, 0, 1>(tz), shuffle<2, 3, 2, 3>(tz));
+
+  const float4 tnear = max(max(tnear_x, tnear_y), max(tnear_z, make_float4(tmin)));
+  const float4 tfar = min(min(tfar_x, tfar_y), min(tfar_z, make_float4(tmax)));
+
+  dist[0] = extract<0>(tnear);
+  dist[1] = extract<1>(tnear);
+
+  int mask = _mm_movemask_ps(_mm_cmple_ps(tnear.m128, tfar.m128)) & 3;
+
+#  ifdef __VISIBILITY_FLAG__
+  /* this visibility test gives a 5% performance hit, how to solve? */
+  mask &= (((__float_as_uint(cnodes.x) & visibility) ? 1 : 0) |
+           ((__float_as_uint(cnodes.y) & visibility) ? 2 : 0));
+#  endif
+
+  return mask;
+}
+#else
+ccl_device_forceinline int bvh_aligned_node_intersect(KernelGlobals kg,
+                                                      const float3 P,
+                                                      const float3 idir,
+                                                      const float tmin,
+                                                      const float tmax,
+                                                      const int node_addr,
+                                                      const uint visibility,
+                                                      float dist[2])
+{
+  if (kernel_data.bvh.use_compact) {
+    return bvh_compact_node_intersect(kg, P, idir, tmin, tmax, node_addr, dist);
+  }
+
+  /* fetch node data */
+#  ifdef __VISIBILITY_FLAG__
   float4 cnodes = kernel_data_fetch(bvh_nodes, node_addr + 0);
-#endif
+#  endif
   float4 node0 = kernel_data_fetch(bvh_nodes, node_addr + 1);
   float4 node1 = kernel_data_fetch(bvh_nodes, node_addr + 2);
   float4 node2 = kernel_data_fetch(bvh_nodes, node_addr + 3);
@@ -61,14 +170,15 @@ ccl_device_forceinline int bvh_aligned_node_intersect(KernelGlobals kg,
   dist[0] = c0min;
   dist[1] = c1min;
 
-#ifdef __VISIBILITY_FLAG__
+#  ifdef __VISIBILITY_FLAG__
   /* this visibility test gives a 5% performance hit, how to solve? */
   return (((c0max >= c0min) && (__float_as_uint(cnodes.x) & visibility)) ? 1 : 0) |
          (((c1max >= c1min) && (__float_as_uint(cnodes.y) & visibility)) ? 2 : 0);
-#else
+#  else
   return ((c0max >= c0min) ? 1 : 0) | ((c1max >= c1min) ? 2 : 0);
-#endif
+#  endif
 }
+#endif /* __KERNEL_SSE2__ */
 
 ccl_device_forceinline bool bvh_unaligned_node_intersect_child(KernelGlobals kg,
                                                                const float3 P,
@@ -140,6 +250,13 @@ ccl_device_forceinline int bvh_node_intersect(KernelGlobals kg,
                                               const uint visibility,
                                               float dist[2])
 {
+  /* Compact nodes reuse data[0].x for quantized bounds, so the unaligned
+   * flag test below would read garbage. Compact trees never contain
+   * unaligned nodes. */
+  if (kernel_data.bvh.use_compact) {
+    return bvh_compact_node_intersect(kg, P, idir, tmin, tmax, node_addr, dist);
+  }
+
   float4 node = kernel_data_fetch(bvh_nodes, node_addr);
   if (__float_as_uint(node.x) & PATH_RAY_NODE_UNALIGNED) {
     return bvh_unaligned_node_intersect(kg, P, dir, idir, tmin, tmax, node_addr, visibility, dist);
@@ -64,6 +64,10 @@ ccl_device_inline
 
   uint isect_index = 0;
 
+  /* Cached shadow transparency attribute lookup for curve hits. */
+  int curve_shadow_object = OBJECT_NONE;
+  int curve_shadow_offset = ATTR_STD_NOT_FOUND;
+
   *r_num_recorded_hits = 0;
   *r_throughput = 1.0f;
 
@@ -250,8 +254,14 @@ ccl_device_inline
 
               /* Always use baked shadow transparency for curves. */
               if (isect.type & PRIMITIVE_CURVE) {
-                *r_throughput *= intersection_curve_shadow_transparency(
-                    kg, isect.object, isect.prim, isect.type, isect.u);
+                *r_throughput *= intersection_curve_shadow_transparency_cached(
+                    kg,
+                    isect.object,
+                    isect.prim,
+                    isect.type,
+                    isect.u,
+                    &curve_shadow_object,
+                    &curve_shadow_offset);
 
                 if (*r_throughput < CURVE_SHADOW_TRANSPARENCY_CUTOFF) {
                   return true;
@@ -189,25 +189,41 @@ ccl_device_inline int intersection_find_attribute(KernelGlobals kg,
                                                   const int object,
                                                   const uint id)
 {
+  /* Binary search the per-table entries sorted by id, starting from the table header which
+   * holds the entry count and the object to geometry table link. */
   uint attr_offset = kernel_data_fetch(objects, object).attribute_map_offset;
-  AttributeMap attr_map = kernel_data_fetch(attributes_map, attr_offset);
 
-  while (attr_map.id != id) {
-    if (UNLIKELY(attr_map.id == ATTR_STD_NONE)) {
-      if (UNLIKELY(attr_map.element == 0)) {
-        return (int)ATTR_STD_NOT_FOUND;
+  for (;;) {
+    const AttributeMap header = kernel_data_fetch(attributes_map, attr_offset);
+
+    uint lo = 0;
+    uint hi = header.element;
+    while (lo < hi) {
+      const uint mid = (lo + hi) >> 1;
+      if (kernel_data_fetch(attributes_map, attr_offset + 1 + mid).id < id) {
+        lo = mid + 1;
+      }
+      else {
+        hi = mid;
       }
-      /* Chain jump to a different part of the table. */
-      attr_offset = attr_map.offset;
     }
-    else {
-      attr_offset += ATTR_PRIM_TYPES;
+
+    if (lo < header.element) {
+      const AttributeMap attr_map = kernel_data_fetch(attributes_map, attr_offset + 1 + lo);
+      if (attr_map.id == id) {
+        /* return result */
+        return (attr_map.element == ATTR_ELEMENT_NONE) ? (int)ATTR_STD_NOT_FOUND :
+                                                         attr_map.offset;
+      }
+    }
+
+    if (header.type == 0) {
+      return (int)ATTR_STD_NOT_FOUND;
     }
-    attr_map = kernel_data_fetch(attributes_map, attr_offset);
-  }
 
-  /* return result */
-  return (attr_map.element == ATTR_ELEMENT_NONE) ? (int)ATTR_STD_NOT_FOUND : attr_map.offset;
+    /* Chain jump from the object table to the geometry table. */
+    attr_offset = header.offset;
+  }
 }
 
 /* Transparent Shadows */
@@ -215,11 +231,9 @@ ccl_device_inline int intersection_find_attribute(KernelGlobals kg,
 /* Cut-off value to stop transparent shadow tracing when practically opaque. */
 #define CURVE_SHADOW_TRANSPARENCY_CUTOFF 0.001f
 
-ccl_device_inline float intersection_curve_shadow_transparency(
-    KernelGlobals kg, const int object, const int prim, const int type, const float u)
+ccl_device_inline float intersection_curve_shadow_transparency_interpolate(
+    KernelGlobals kg, const int offset, const int prim, const int type, const float u)
 {
-  /* Find attribute. */
-  const int offset = intersection_find_attribute(kg, object, ATTR_STD_SHADOW_TRANSPARENCY);
   if (offset == ATTR_STD_NOT_FOUND) {
     /* If no shadow transparency attribute, assume opaque. */
     return 0.0f;
@@ -236,6 +250,34 @@ ccl_device_inline float intersection_curve_shadow_transparency(
   return (1.0f - u) * f0 + u * f1;
 }
 
+ccl_device_inline float intersection_curve_shadow_transparency(
+    KernelGlobals kg, const int object, const int prim, const int type, const float u)
+{
+  /* Find attribute. */
+  const int offset = intersection_find_attribute(kg, object, ATTR_STD_SHADOW_TRANSPARENCY);
+
+  return intersection_curve_shadow_transparency_interpolate(kg, offset, prim, type, u);
+}
+
+/* Variant that caches the attribute table walk per object, for traversal
+ * loops where a shadow ray tests many curve hits against the same object. */
+ccl_device_inline float intersection_curve_shadow_transparency_cached(
+    KernelGlobals kg,
+    const int object,
+    const int prim,
+    const int type,
+    const float u,
+    ccl_private int *cached_object,
+    ccl_private int *cached_offset)
+{
+  if (*cached_object != object) {
+    *cached_object = object;
+    *cached_offset = intersection_find_attribute(kg, object, ATTR_STD_SHADOW_TRANSPARENCY);
+  }
+
+  return intersection_curve_shadow_transparency_interpolate(kg, *cached_offset, prim, type, u);
+}
+
 ccl_device_inline bool intersection_skip_self(const ccl_ray_data RaySelfPrimitives &self,
                                               const int object,
                                               const int prim)
@@ -345,58 +345,74 @@ ccl_device_inline void camera_sample_panorama(ccl_constant KernelCamera *cam,
 
 /* Common */
 
-ccl_device_inline void camera_sample(KernelGlobals kg,
-                                     const int x,
-                                     const int y,
-                                     const float2 filter_uv,
-                                     const float time,
-                                     const float2 lens_uv,
-                                     ccl_private Ray *ray)
+/* Raster position of the ray, jittered within the pixel filter. */
+ccl_device_inline float2 camera_sample_raster(KernelGlobals kg,
+                                              const int x,
+                                              const int y,
+                                              const float2 filter_uv)
 {
-  /* pixel filter */
   const int filter_table_offset = kernel_data.tables.filter_table_offset;
-  const float2 raster = make_float2(
+  return make_float2(
       x + lookup_table_read(kg, filter_uv.x, filter_table_offset, FILTER_TABLE_SIZE),
       y + lookup_table_read(kg, filter_uv.y, filter_table_offset, FILTER_TABLE_SIZE));
+}
 
-  /* motion blur */
+/* Motion blur time of the ray, including the rolling shutter effect. */
+ccl_device_inline float camera_sample_time(KernelGlobals kg, const int y, const float rand_time)
+{
   if (kernel_data.cam.shuttertime == -1.0f) {
-    ray->time = 0.5f;
+    return 0.5f;
   }
-  else {
-    /* TODO(sergey): Such lookup is unneeded when there's rolling shutter
-     * effect in use but rolling shutter duration is set to 0.0.
-     */
-    const int shutter_table_offset = kernel_data.cam.shutter_table_offset;
-    ray->time = lookup_table_read(kg, time, shutter_table_offset, SHUTTER_TABLE_SIZE);
-    /* TODO(sergey): Currently single rolling shutter effect type only
-     * where scan-lines are acquired from top to bottom and whole scan-line
-     * is acquired at once (no delay in acquisition happens between pixels
-     * of single scan-line).
-     *
-     * Might want to support more models in the future.
+
+  /* TODO(sergey): Such lookup is unneeded when there's rolling shutter
+   * effect in use but rolling shutter duration is set to 0.0.
+   */
+  const int shutter_table_offset = kernel_data.cam.shutter_table_offset;
+  float ray_time = lookup_table_read(kg, rand_time, shutter_table_offset, SHUTTER_TABLE_SIZE);
+  /* TODO(sergey): Currently single rolling shutter effect type only
+   * where scan-lines are acquired from top to bottom and whole scan-line
+   * is acquired at once (no delay in acquisition happens between pixels
+   * of single scan-line).
+   *
+   * Might want to support more models in the future.
+   */
+  if (kernel_data.cam.rolling_shutter_type) {
+    /* Time corresponding to a fully rolling shutter only effect:
+     * top of the frame is time 0.0, bottom of the frame is time 1.0.
      */
-    if (kernel_data.cam.rolling_shutter_type) {
-      /* Time corresponding to a fully rolling shutter only effect:
-       * top of the frame is time 0.0, bottom of the frame is time 1.0.
+    const float time = 1.0f - (float)y / kernel_data.cam.height;
+    const float duration = kernel_data.cam.rolling_shutter_duration;
+    if (duration != 0.0f) {
+      /* This isn't fully physical correct, but lets us to have simple
+       * controls in the interface. The idea here is basically sort of
+       * linear interpolation between how much rolling shutter effect
+       * exist on the frame and how much of it is a motion blur effect.
        */
-      const float time = 1.0f - (float)y / kernel_data.cam.height;
-      const float duration = kernel_data.cam.rolling_shutter_duration;
-      if (duration != 0.0f) {
-        /* This isn't fully physical correct, but lets us to have simple
-         * controls in the interface. The idea here is basically sort of
-         * linear interpolation between how much rolling shutter effect
-         * exist on the frame and how much of it is a motion blur effect.
-         */
-        ray->time = (ray->time - 0.5f) * duration;
-        ray->time += (time - 0.5f) * (1.0f - duration) + 0.5f;
-      }
-      else {
-        ray->time = time;
-      }
+      ray_time = (ray_time - 0.5f) * duration;
+      ray_time += (time - 0.5f) * (1.0f - duration) + 0.5f;
+    }
+    else {
+      ray_time = time;
     }
   }
 
+  return ray_time;
+}
+
+ccl_device_inline void camera_sample(KernelGlobals kg,
+                                     const int x,
+                                     const int y,
+                                     const float2 filter_uv,
+                                     const float time,
+                                     const float2 lens_uv,
+                                     ccl_private Ray *ray)
+{
+  /* pixel filter */
+  const float2 raster = camera_sample_raster(kg, x, y, filter_uv);
+
+  /* motion blur */
+  ray->time = camera_sample_time(kg, y, time);
+
   /* sample */
   if (kernel_data.cam.type == CAMERA_PERSPECTIVE) {
     camera_sample_perspective(kg, raster, lens_uv, ray);
@@ -410,6 +426,272 @@ ccl_device_inline void camera_sample(KernelGlobals kg,
   }
 }
 
+#ifndef __KERNEL_GPU__
+
+/* Batched camera sampling for the CPU wavefront mode. Rays of a batch are generated together
+ * with SoA vfloat8 math, so that the projection, lens and normalization arithmetic runs 8 wide
+ * instead of once per ray. */
+
+/* Number of rays the batched camera samplers generate at once. */
+#  define CAMERA_SAMPLE_BATCH_SIZE 8
+
+/* Whether the camera can go through the batched samplers. Cameras whose per-ray work is
+ * dominated by divergent branches (panorama, stereo, motion) take the scalar path; the uniform
+ * perspective divide requirement holds for any raster-to-camera projection the host computes
+ * for perspective and orthographic cameras. */
+ccl_device_inline bool camera_sample_batch_supported(KernelGlobals kg)
+{
+  if (kernel_data.cam.type != CAMERA_PERSPECTIVE &&
+      kernel_data.cam.type != CAMERA_ORTHOGRAPHIC) {
+    return false;
+  }
+  if (kernel_data.cam.interocular_offset != 0.0f || kernel_data.cam.num_motion_steps) {
+    return false;
+  }
+  if (kernel_data.cam.type == CAMERA_PERSPECTIVE && kernel_data.cam.have_perspective_motion) {
+    return false;
+  }
+
+  const ProjectionTransform rastertocamera = kernel_data.cam.rastertocamera;
+  return rastertocamera.w.x == 0.0f && rastertocamera.w.y == 0.0f &&
+         rastertocamera.w.w != 0.0f;
+}
+
+/* transform_perspective of the raster positions (x, y, 0), with the w divide uniform across
+ * the batch as checked by camera_sample_batch_supported. */
+ccl_device_inline void camera_batch_raster_to_camera(const ProjectionTransform &rastertocamera,
+                                                     const vfloat8 raster_x,
+                                                     const vfloat8 raster_y,
+                                                     ccl_private vfloat8 *Pcamera_x,
+                                                     ccl_private vfloat8 *Pcamera_y,
+                                                     ccl_private vfloat8 *Pcamera_z)
+{
+  const float inv_w = 1.0f / rastertocamera.w.w;
+  *Pcamera_x = (rastertocamera.x.x * raster_x + rastertocamera.x.y * raster_y +
+                rastertocamera.x.w) *
+               inv_w;
+  *Pcamera_y = (rastertocamera.y.x * raster_x + rastertocamera.y.y * raster_y +
+                rastertocamera.y.w) *
+               inv_w;
+  *Pcamera_z = (rastertocamera.z.x * raster_x + rastertocamera.z.y * raster_y +
+                rastertocamera.z.w) *
+               inv_w;
+}
+
+/* Generate CAMERA_SAMPLE_BATCH_SIZE perspective camera rays at once. The lens coordinates are
+ * expected pre-scaled by the aperture size and are only read when depth of field is enabled.
+ * Matches camera_sample_perspective for the cameras camera_sample_batch_supported accepts;
+ * the time of the rays is left for the caller to fill in. */
+ccl_device void camera_sample_perspective_batch(KernelGlobals kg,
+                                                const float *ccl_restrict raster_x,
+                                                const float *ccl_restrict raster_y,
+                                                const float *ccl_restrict lens_u,
+                                                const float *ccl_restrict lens_v,
+                                                ccl_private Ray *ccl_restrict rays)
+{
+  const ProjectionTransform rastertocamera = kernel_data.cam.rastertocamera;
+  const Transform cameratoworld = kernel_data.cam.cameratoworld;
+
+  const vfloat8 rx = load_vfloat8(raster_x);
+  const vfloat8 ry = load_vfloat8(raster_y);
+
+  vfloat8 Pcamera_x, Pcamera_y, Pcamera_z;
+  camera_batch_raster_to_camera(rastertocamera, rx, ry, &Pcamera_x, &Pcamera_y, &Pcamera_z);
+
+  vfloat8 Px = zero_vfloat8();
+  vfloat8 Py = zero_vfloat8();
+  vfloat8 Pz = zero_vfloat8();
+  vfloat8 Dx = Pcamera_x;
+  vfloat8 Dy = Pcamera_y;
+  vfloat8 Dz = Pcamera_z;
+
+  /* modify ray for depth of field */
+  if (kernel_data.cam.aperturesize > 0.0f) {
+    const vfloat8 ft = kernel_data.cam.focaldistance / Dz;
+    const vfloat8 Pfocus_x = Dx * ft;
+    const vfloat8 Pfocus_y = Dy * ft;
+    const vfloat8 Pfocus_z = Dz * ft;
+
+    Px = load_vfloat8(lens_u);
+    Py = load_vfloat8(lens_v);
+
+    Dx = Pfocus_x - Px;
+    Dy = Pfocus_y - Py;
+    Dz = Pfocus_z;
+    const vfloat8 D_rlen = 1.0f / sqrt(Dx * Dx + Dy * Dy + Dz * Dz);
+    Dx *= D_rlen;
+    Dy *= D_rlen;
+    Dz *= D_rlen;
+  }
+
+  /* transform ray from camera to world */
+  const vfloat8 Pworld_x = cameratoworld.x.x * Px + cameratoworld.x.y * Py +
+                           cameratoworld.x.z * Pz + cameratoworld.x.w;
+  const vfloat8 Pworld_y = cameratoworld.y.x * Px + cameratoworld.y.y * Py +
+                           cameratoworld.y.z * Pz + cameratoworld.y.w;
+  const vfloat8 Pworld_z = cameratoworld.z.x * Px + cameratoworld.z.y * Py +
+                           cameratoworld.z.z * Pz + cameratoworld.z.w;
+
+  vfloat8 Dworld_x = cameratoworld.x.x * Dx + cameratoworld.x.y * Dy + cameratoworld.x.z * Dz;
+  vfloat8 Dworld_y = cameratoworld.y.x * Dx + cameratoworld.y.y * Dy + cameratoworld.y.z * Dz;
+  vfloat8 Dworld_z = cameratoworld.z.x * Dx + cameratoworld.z.y * Dy + cameratoworld.z.z * Dz;
+  const vfloat8 D_rlen = 1.0f / sqrt(Dworld_x * Dworld_x + Dworld_y * Dworld_y +
+                                     Dworld_z * Dworld_z);
+  Dworld_x *= D_rlen;
+  Dworld_y *= D_rlen;
+  Dworld_z *= D_rlen;
+
+#  ifdef __RAY_DIFFERENTIALS__
+  /* Ray differentials from the undisturbed center direction, as in
+   * camera_sample_perspective. */
+  const vfloat8 Dcenter_x = cameratoworld.x.x * Pcamera_x + cameratoworld.x.y * Pcamera_y +
+                            cameratoworld.x.z * Pcamera_z;
+  const vfloat8 Dcenter_y = cameratoworld.y.x * Pcamera_x + cameratoworld.y.y * Pcamera_y +
+                            cameratoworld.y.z * Pcamera_z;
+  const vfloat8 Dcenter_z = cameratoworld.z.x * Pcamera_x + cameratoworld.z.y * Pcamera_y +
+                            cameratoworld.z.z * Pcamera_z;
+  const vfloat8 Dcenter_rlen = 1.0f / sqrt(Dcenter_x * Dcenter_x + Dcenter_y * Dcenter_y +
+                                           Dcenter_z * Dcenter_z);
+
+  const float3 raster_dx = make_float3(kernel_data.cam.dx);
+  const float3 raster_dy = make_float3(kernel_data.cam.dy);
+
+  vfloat8 ddx_x = Dcenter_x + raster_dx.x;
+  vfloat8 ddx_y = Dcenter_y + raster_dx.y;
+  vfloat8 ddx_z = Dcenter_z + raster_dx.z;
+  const vfloat8 ddx_rlen = 1.0f / sqrt(ddx_x * ddx_x + ddx_y * ddx_y + ddx_z * ddx_z);
+  ddx_x = ddx_x * ddx_rlen - Dcenter_x * Dcenter_rlen;
+  ddx_y = ddx_y * ddx_rlen - Dcenter_y * Dcenter_rlen;
+  ddx_z = ddx_z * ddx_rlen - Dcenter_z * Dcenter_rlen;
+
+  vfloat8 ddy_x = Dcenter_x + raster_dy.x;
+  vfloat8 ddy_y = Dcenter_y + raster_dy.y;
+  vfloat8 ddy_z = Dcenter_z + raster_dy.z;
+  const vfloat8 ddy_rlen = 1.0f / sqrt(ddy_x * ddy_x + ddy_y * ddy_y + ddy_z * ddy_z);
+  ddy_x = ddy_x * ddy_rlen - Dcenter_x * Dcenter_rlen;
+  ddy_y = ddy_y * ddy_rlen - Dcenter_y * Dcenter_rlen;
+  ddy_z = ddy_z * ddy_rlen - Dcenter_z * Dcenter_rlen;
+
+  /* Compact differential, see differential_make_compact. */
+  const vfloat8 dD = 0.5f * (sqrt(ddx_x * ddx_x + ddx_y * ddx_y + ddx_z * ddx_z) +
+                             sqrt(ddy_x * ddy_x + ddy_y * ddy_y + ddy_z * ddy_z));
+#  endif
+
+  /* clipping */
+  const vfloat8 z_inv = sqrt(Pcamera_x * Pcamera_x + Pcamera_y * Pcamera_y +
+                             Pcamera_z * Pcamera_z) /
+                        Pcamera_z;
+  const vfloat8 t_nearclip = kernel_data.cam.nearclip * z_inv;
+  const vfloat8 tmax = kernel_data.cam.cliplength * z_inv;
+
+  for (int i = 0; i < CAMERA_SAMPLE_BATCH_SIZE; i++) {
+    ccl_private Ray *ray = &rays[i];
+    ray->P = make_float3(Pworld_x[i] + t_nearclip[i] * Dworld_x[i],
+                         Pworld_y[i] + t_nearclip[i] * Dworld_y[i],
+                         Pworld_z[i] + t_nearclip[i] * Dworld_z[i]);
+    ray->D = make_float3(Dworld_x[i], Dworld_y[i], Dworld_z[i]);
+#  ifdef __RAY_DIFFERENTIALS__
+    ray->dD = dD[i];
+    ray->dP = t_nearclip[i] * dD[i];
+#  endif
+    ray->tmin = 0.0f;
+    ray->tmax = tmax[i];
+  }
+}
+
+/* Generate CAMERA_SAMPLE_BATCH_SIZE orthographic camera rays at once, matching
+ * camera_sample_orthographic. */
+ccl_device void camera_sample_orthographic_batch(KernelGlobals kg,
+                                                 const float *ccl_restrict raster_x,
+                                                 const float *ccl_restrict raster_y,
+                                                 const float *ccl_restrict lens_u,
+                                                 const float *ccl_restrict lens_v,
+                                                 ccl_private Ray *ccl_restrict rays)
+{
+  const ProjectionTransform rastertocamera = kernel_data.cam.rastertocamera;
+  const Transform cameratoworld = kernel_data.cam.cameratoworld;
+
+  const vfloat8 rx = load_vfloat8(raster_x);
+  const vfloat8 ry = load_vfloat8(raster_y);
+
+  vfloat8 Pcamera_x, Pcamera_y, Pcamera_z;
+  camera_batch_raster_to_camera(rastertocamera, rx, ry, &Pcamera_x, &Pcamera_y, &Pcamera_z);
+
+  vfloat8 Px;
+  vfloat8 Py;
+  vfloat8 Pz;
+  vfloat8 Dx;
+  vfloat8 Dy;
+  vfloat8 Dz;
+
+  /* modify ray for depth of field */
+  if (kernel_data.cam.aperturesize > 0.0f) {
+    const vfloat8 lens_x = load_vfloat8(lens_u);
+    const vfloat8 lens_y = load_vfloat8(lens_v);
+
+    Dx = -lens_x;
+    Dy = -lens_y;
+    Dz = make_vfloat8(kernel_data.cam.focaldistance);
+    const vfloat8 D_rlen = 1.0f / sqrt(Dx * Dx + Dy * Dy + Dz * Dz);
+    Dx *= D_rlen;
+    Dy *= D_rlen;
+    Dz *= D_rlen;
+
+    const vfloat8 t_nearclip = kernel_data.cam.nearclip / Dz;
+    Px = Pcamera_x + lens_x + Dx * t_nearclip;
+    Py = Pcamera_y + lens_y + Dy * t_nearclip;
+    Pz = Pcamera_z + Dz * t_nearclip;
+  }
+  else {
+    Dx = zero_vfloat8();
+    Dy = zero_vfloat8();
+    Dz = one_vfloat8();
+    Px = Pcamera_x;
+    Py = Pcamera_y;
+    Pz = Pcamera_z + kernel_data.cam.nearclip;
+  }
+
+  /* transform ray from camera to world */
+  const vfloat8 Pworld_x = cameratoworld.x.x * Px + cameratoworld.x.y * Py +
+                           cameratoworld.x.z * Pz + cameratoworld.x.w;
+  const vfloat8 Pworld_y = cameratoworld.y.x * Px + cameratoworld.y.y * Py +
+                           cameratoworld.y.z * Pz + cameratoworld.y.w;
+  const vfloat8 Pworld_z = cameratoworld.z.x * Px + cameratoworld.z.y * Py +
+                           cameratoworld.z.z * Pz + cameratoworld.z.w;
+
+  vfloat8 Dworld_x = cameratoworld.x.x * Dx + cameratoworld.x.y * Dy + cameratoworld.x.z * Dz;
+  vfloat8 Dworld_y = cameratoworld.y.x * Dx + cameratoworld.y.y * Dy + cameratoworld.y.z * Dz;
+  vfloat8 Dworld_z = cameratoworld.z.x * Dx + cameratoworld.z.y * Dy + cameratoworld.z.z * Dz;
+  const vfloat8 D_rlen = 1.0f / sqrt(Dworld_x * Dworld_x + Dworld_y * Dworld_y +
+                                     Dworld_z * Dworld_z);
+  Dworld_x *= D_rlen;
+  Dworld_y *= D_rlen;
+  Dworld_z *= D_rlen;
+
+#  ifdef __RAY_DIFFERENTIALS__
+  /* The orthographic differentials are uniform across the batch, see
+   * camera_sample_orthographic. */
+  differential3 dP;
+  dP.dx = make_float3(kernel_data.cam.dx);
+  dP.dy = make_float3(kernel_data.cam.dx);
+  const float dP_compact = differential_make_compact(dP);
+#  endif
+
+  for (int i = 0; i < CAMERA_SAMPLE_BATCH_SIZE; i++) {
+    ccl_private Ray *ray = &rays[i];
+    ray->P = make_float3(Pworld_x[i], Pworld_y[i], Pworld_z[i]);
+    ray->D = make_float3(Dworld_x[i], Dworld_y[i], Dworld_z[i]);
+#  ifdef __RAY_DIFFERENTIALS__
+    ray->dP = dP_compact;
+    ray->dD = differential_zero_compact();
+#  endif
+    ray->tmin = 0.0f;
+    ray->tmax = kernel_data.cam.cliplength;
+  }
+}
+
+#endif /* !__KERNEL_GPU__ */
+
 /* Utilities */
 
 ccl_device_inline float3 camera_position(KernelGlobals kg)
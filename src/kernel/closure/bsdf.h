@@ -144,11 +144,13 @@ ccl_device_inline int bsdf_sample(KernelGlobals kg,
       *eta = 1.0f;
       break;
 #if defined(__SVM__) || defined(__OSL__)
+#  ifdef __CLOSURE_OREN_NAYAR__
     case CLOSURE_BSDF_OREN_NAYAR_ID:
       label = bsdf_oren_nayar_sample(sc, Ng, sd->wi, rand_xy, eval, wo, pdf);
       *sampled_roughness = one_float2();
       *eta = 1.0f;
       break;
+#  endif
 #  ifdef __OSL__
     case CLOSURE_BSDF_BURLEY_ID:
       label = bsdf_burley_sample(sc, Ng, sd->wi, rand_xy, eval, wo, pdf);
@@ -165,42 +167,57 @@ ccl_device_inline int bsdf_sample(KernelGlobals kg,
       *eta = 1.0f;
       break;
 #  endif
+#  ifdef __CLOSURE_TRANSLUCENT__
     case CLOSURE_BSDF_TRANSLUCENT_ID:
       label = bsdf_translucent_sample(sc, Ng, sd->wi, rand_xy, eval, wo, pdf);
       *sampled_roughness = one_float2();
       *eta = 1.0f;
       break;
+#  endif
+#  ifdef __CLOSURE_TRANSPARENT__
     case CLOSURE_BSDF_TRANSPARENT_ID:
       label = bsdf_transparent_sample(sc, Ng, sd->wi, eval, wo, pdf);
       *sampled_roughness = zero_float2();
       *eta = 1.0f;
       break;
+#  endif
+#  ifdef __CLOSURE_RAY_PORTAL__
     case CLOSURE_BSDF_RAY_PORTAL_ID:
       /* ray portals are not handled by the BSDF code, we should never get here */
       kernel_assert(false);
       break;
+#  endif
+#  ifdef __CLOSURE_MICROFACET_GGX__
     case CLOSURE_BSDF_MICROFACET_GGX_ID:
     case CLOSURE_BSDF_MICROFACET_GGX_REFRACTION_ID:
     case CLOSURE_BSDF_MICROFACET_GGX_GLASS_ID:
       label = bsdf_microfacet_ggx_sample(
           kg, sc, Ng, sd->wi, rand, eval, wo, pdf, sampled_roughness, eta);
       break;
+#  endif
+#  ifdef __CLOSURE_MICROFACET_BECKMANN__
     case CLOSURE_BSDF_MICROFACET_BECKMANN_ID:
     case CLOSURE_BSDF_MICROFACET_BECKMANN_REFRACTION_ID:
     case CLOSURE_BSDF_MICROFACET_BECKMANN_GLASS_ID:
       label = bsdf_microfacet_beckmann_sample(
           kg, sc, Ng, sd->wi, rand, eval, wo, pdf, sampled_roughness, eta);
       break;
+#  endif
+#  ifdef __CLOSURE_ASHIKHMIN_SHIRLEY__
     case CLOSURE_BSDF_ASHIKHMIN_SHIRLEY_ID:
       label = bsdf_ashikhmin_shirley_sample(
           sc, Ng, sd->wi, rand_xy, eval, wo, pdf, sampled_roughness);
       *eta = 1.0f;
       break;
+#  endif
+#  ifdef __CLOSURE_ASHIKHMIN_VELVET__
     case CLOSURE_BSDF_ASHIKHMIN_VELVET_ID:
       label = bsdf_ashikhmin_velvet_sample(sc, Ng, sd->wi, rand_xy, eval, wo, pdf);
       *sampled_roughness = one_float2();
       *eta = 1.0f;
       break;
+#  endif
+#  ifdef __CLOSURE_TOON__
     case CLOSURE_BSDF_DIFFUSE_TOON_ID:
       label = bsdf_diffuse_toon_sample(sc, Ng, sd->wi, rand_xy, eval, wo, pdf);
       *sampled_roughness = one_float2();
@@ -212,6 +229,8 @@ ccl_device_inline int bsdf_sample(KernelGlobals kg,
       *sampled_roughness = one_float2();
       *eta = 1.0f;
       break;
+#  endif
+#  ifdef __CLOSURE_HAIR__
     case CLOSURE_BSDF_HAIR_REFLECTION_ID:
       label = bsdf_hair_reflection_sample(
           sc, Ng, sd->wi, rand_xy, eval, wo, pdf, sampled_roughness);
@@ -222,6 +241,7 @@ ccl_device_inline int bsdf_sample(KernelGlobals kg,
           sc, Ng, sd->wi, rand_xy, eval, wo, pdf, sampled_roughness);
       *eta = 1.0f;
       break;
+#  endif
 #  ifdef __PRINCIPLED_HAIR__
     case CLOSURE_BSDF_HAIR_CHIANG_ID:
       label = bsdf_hair_chiang_sample(kg, sc, sd, rand, eval, wo, pdf, sampled_roughness);
@@ -232,11 +252,13 @@ ccl_device_inline int bsdf_sample(KernelGlobals kg,
       *eta = 1.0f;
       break;
 #  endif
+#  ifdef __CLOSURE_SHEEN__
     case CLOSURE_BSDF_SHEEN_ID:
       label = bsdf_sheen_sample(sc, Ng, sd->wi, rand_xy, eval, wo, pdf);
       *sampled_roughness = one_float2();
       *eta = 1.0f;
       break;
+#  endif
 #endif
     default:
       label = LABEL_NONE;
@@ -291,10 +313,12 @@ ccl_device_inline void bsdf_roughness_eta(const KernelGlobals kg,
       *eta = 1.0f;
       break;
 #ifdef __SVM__
+#  ifdef __CLOSURE_OREN_NAYAR__
     case CLOSURE_BSDF_OREN_NAYAR_ID:
       *roughness = one_float2();
       *eta = 1.0f;
       break;
+#  endif
 #  ifdef __OSL__
     case CLOSURE_BSDF_BURLEY_ID:
       *roughness = one_float2();
@@ -310,36 +334,56 @@ ccl_device_inline void bsdf_roughness_eta(const KernelGlobals kg,
       *eta = 1.0f;
       break;
 #  endif
+#  ifdef __CLOSURE_TRANSLUCENT__
     case CLOSURE_BSDF_TRANSLUCENT_ID:
       *roughness = one_float2();
       *eta = 1.0f;
       break;
+#  endif
+#  if defined(__CLOSURE_TRANSPARENT__) || defined(__CLOSURE_RAY_PORTAL__)
+#    ifdef __CLOSURE_TRANSPARENT__
     case CLOSURE_BSDF_TRANSPARENT_ID:
+#    endif
+#    ifdef __CLOSURE_RAY_PORTAL__
     case CLOSURE_BSDF_RAY_PORTAL_ID:
+#    endif
       *roughness = zero_float2();
       *eta = 1.0f;
       break;
+#  endif
+#  if defined(__CLOSURE_MICROFACET_GGX__) || defined(__CLOSURE_MICROFACET_BECKMANN__)
+#    ifdef __CLOSURE_MICROFACET_GGX__
     case CLOSURE_BSDF_MICROFACET_GGX_ID:
     case CLOSURE_BSDF_MICROFACET_GGX_REFRACTION_ID:
     case CLOSURE_BSDF_MICROFACET_GGX_GLASS_ID:
+#    endif
+#    ifdef __CLOSURE_MICROFACET_BECKMANN__
     case CLOSURE_BSDF_MICROFACET_BECKMANN_ID:
     case CLOSURE_BSDF_MICROFACET_BECKMANN_REFRACTION_ID:
-    case CLOSURE_BSDF_MICROFACET_BECKMANN_GLASS_ID: {
+    case CLOSURE_BSDF_MICROFACET_BECKMANN_GLASS_ID:
+#    endif
+    {
       const ccl_private MicrofacetBsdf *bsdf = (const ccl_private MicrofacetBsdf *)sc;
       *roughness = make_float2(bsdf->alpha_x, bsdf->alpha_y);
       *eta = (bsdf_is_transmission(sc, wo)) ? bsdf->ior : 1.0f;
       break;
     }
+#  endif
+#  ifdef __CLOSURE_ASHIKHMIN_SHIRLEY__
     case CLOSURE_BSDF_ASHIKHMIN_SHIRLEY_ID: {
       const ccl_private MicrofacetBsdf *bsdf = (const ccl_private MicrofacetBsdf *)sc;
       *roughness = make_float2(bsdf->alpha_x, bsdf->alpha_y);
       *eta = 1.0f;
       break;
     }
+#  endif
+#  ifdef __CLOSURE_ASHIKHMIN_VELVET__
     case CLOSURE_BSDF_ASHIKHMIN_VELVET_ID:
       *roughness = one_float2();
       *eta = 1.0f;
       break;
+#  endif
+#  ifdef __CLOSURE_TOON__
     case CLOSURE_BSDF_DIFFUSE_TOON_ID:
       *roughness = one_float2();
       *eta = 1.0f;
@@ -349,6 +393,8 @@ ccl_device_inline void bsdf_roughness_eta(const KernelGlobals kg,
       *roughness = one_float2();
       *eta = 1.0f;
       break;
+#  endif
+#  ifdef __CLOSURE_HAIR__
     case CLOSURE_BSDF_HAIR_REFLECTION_ID:
       *roughness = make_float2(((ccl_private HairBsdf *)sc)->roughness1,
                                ((ccl_private HairBsdf *)sc)->roughness2);
@@ -359,6 +405,7 @@ ccl_device_inline void bsdf_roughness_eta(const KernelGlobals kg,
                                ((ccl_private HairBsdf *)sc)->roughness2);
       *eta = 1.0f;
       break;
+#  endif
 #  ifdef __PRINCIPLED_HAIR__
     case CLOSURE_BSDF_HAIR_CHIANG_ID:
       alpha = ((ccl_private ChiangHairBSDF *)sc)->m0_roughness;
@@ -371,11 +418,13 @@ ccl_device_inline void bsdf_roughness_eta(const KernelGlobals kg,
       *eta = 1.0f;
       break;
 #  endif
+#  ifdef __CLOSURE_SHEEN__
     case CLOSURE_BSDF_SHEEN_ID:
       alpha = ((ccl_private SheenBsdf *)sc)->roughness;
       *roughness = make_float2(alpha, alpha);
       *eta = 1.0f;
       break;
+#  endif
 #endif
     default:
       *roughness = one_float2();
@@ -399,9 +448,11 @@ ccl_device_inline int bsdf_label(const KernelGlobals kg,
       label = LABEL_REFLECT | LABEL_DIFFUSE;
       break;
 #ifdef __SVM__
+#  ifdef __CLOSURE_OREN_NAYAR__
     case CLOSURE_BSDF_OREN_NAYAR_ID:
       label = LABEL_REFLECT | LABEL_DIFFUSE;
       break;
+#  endif
 #  ifdef __OSL__
     case CLOSURE_BSDF_BURLEY_ID:
       label = LABEL_REFLECT | LABEL_DIFFUSE;
@@ -413,44 +464,65 @@ ccl_device_inline int bsdf_label(const KernelGlobals kg,
       label = LABEL_REFLECT | LABEL_DIFFUSE;
       break;
 #  endif
+#  ifdef __CLOSURE_TRANSLUCENT__
     case CLOSURE_BSDF_TRANSLUCENT_ID:
       label = LABEL_TRANSMIT | LABEL_DIFFUSE;
       break;
+#  endif
+#  ifdef __CLOSURE_TRANSPARENT__
     case CLOSURE_BSDF_TRANSPARENT_ID:
       label = LABEL_TRANSMIT | LABEL_TRANSPARENT;
       break;
+#  endif
+#  ifdef __CLOSURE_RAY_PORTAL__
     case CLOSURE_BSDF_RAY_PORTAL_ID:
       label = LABEL_TRANSMIT | LABEL_RAY_PORTAL;
       break;
+#  endif
+#  if defined(__CLOSURE_MICROFACET_GGX__) || defined(__CLOSURE_MICROFACET_BECKMANN__)
+#    ifdef __CLOSURE_MICROFACET_GGX__
     case CLOSURE_BSDF_MICROFACET_GGX_ID:
-    case CLOSURE_BSDF_MICROFACET_BECKMANN_ID:
     case CLOSURE_BSDF_MICROFACET_GGX_REFRACTION_ID:
-    case CLOSURE_BSDF_MICROFACET_BECKMANN_REFRACTION_ID:
     case CLOSURE_BSDF_MICROFACET_GGX_GLASS_ID:
-    case CLOSURE_BSDF_MICROFACET_BECKMANN_GLASS_ID: {
+#    endif
+#    ifdef __CLOSURE_MICROFACET_BECKMANN__
+    case CLOSURE_BSDF_MICROFACET_BECKMANN_ID:
+    case CLOSURE_BSDF_MICROFACET_BECKMANN_REFRACTION_ID:
+    case CLOSURE_BSDF_MICROFACET_BECKMANN_GLASS_ID:
+#    endif
+    {
       const ccl_private MicrofacetBsdf *bsdf = (const ccl_private MicrofacetBsdf *)sc;
       label = ((bsdf_is_transmission(sc, wo)) ? LABEL_TRANSMIT : LABEL_REFLECT) |
               ((bsdf_microfacet_eval_flag(bsdf)) ? LABEL_GLOSSY : LABEL_SINGULAR);
       break;
     }
+#  endif
+#  ifdef __CLOSURE_ASHIKHMIN_SHIRLEY__
     case CLOSURE_BSDF_ASHIKHMIN_SHIRLEY_ID:
       label = LABEL_REFLECT | LABEL_GLOSSY;
       break;
+#  endif
+#  ifdef __CLOSURE_ASHIKHMIN_VELVET__
     case CLOSURE_BSDF_ASHIKHMIN_VELVET_ID:
       label = LABEL_REFLECT | LABEL_DIFFUSE;
       break;
+#  endif
+#  ifdef __CLOSURE_TOON__
     case CLOSURE_BSDF_DIFFUSE_TOON_ID:
       label = LABEL_REFLECT | LABEL_DIFFUSE;
       break;
     case CLOSURE_BSDF_GLOSSY_TOON_ID:
       label = LABEL_REFLECT | LABEL_GLOSSY;
       break;
+#  endif
+#  ifdef __CLOSURE_HAIR__
     case CLOSURE_BSDF_HAIR_REFLECTION_ID:
       label = LABEL_REFLECT | LABEL_GLOSSY;
       break;
     case CLOSURE_BSDF_HAIR_TRANSMISSION_ID:
       label = LABEL_TRANSMIT | LABEL_GLOSSY;
       break;
+#  endif
 #  ifdef __PRINCIPLED_HAIR__
     case CLOSURE_BSDF_HAIR_CHIANG_ID:
       if (bsdf_is_transmission(sc, wo)) {
@@ -464,9 +536,11 @@ ccl_device_inline int bsdf_label(const KernelGlobals kg,
       label = LABEL_REFLECT | LABEL_GLOSSY;
       break;
 #  endif
+#  ifdef __CLOSURE_SHEEN__
     case CLOSURE_BSDF_SHEEN_ID:
       label = LABEL_REFLECT | LABEL_DIFFUSE;
       break;
+#  endif
 #endif
     default:
       label = LABEL_NONE;
@@ -506,9 +580,11 @@ ccl_device_inline
       eval = bsdf_diffuse_eval(sc, sd->wi, wo, pdf);
       break;
 #if defined(__SVM__) || defined(__OSL__)
+#  ifdef __CLOSURE_OREN_NAYAR__
     case CLOSURE_BSDF_OREN_NAYAR_ID:
       eval = bsdf_oren_nayar_eval(sc, sd->wi, wo, pdf);
       break;
+#  endif
 #  ifdef __OSL__
     case CLOSURE_BSDF_BURLEY_ID:
       eval = bsdf_burley_eval(sc, sd->wi, wo, pdf);
@@ -520,15 +596,22 @@ ccl_device_inline
       eval = bsdf_diffuse_ramp_eval(sc, sd->wi, wo, pdf);
       break;
 #  endif
+#  ifdef __CLOSURE_TRANSLUCENT__
     case CLOSURE_BSDF_TRANSLUCENT_ID:
       eval = bsdf_translucent_eval(sc, sd->wi, wo, pdf);
       break;
+#  endif
+#  ifdef __CLOSURE_TRANSPARENT__
     case CLOSURE_BSDF_TRANSPARENT_ID:
       eval = bsdf_transparent_eval(sc, sd->wi, wo, pdf);
       break;
+#  endif
+#  ifdef __CLOSURE_RAY_PORTAL__
     case CLOSURE_BSDF_RAY_PORTAL_ID:
       eval = bsdf_ray_portal_eval(sc, sd->wi, wo, pdf);
       break;
+#  endif
+#  ifdef __CLOSURE_MICROFACET_GGX__
     case CLOSURE_BSDF_MICROFACET_GGX_ID:
     case CLOSURE_BSDF_MICROFACET_GGX_REFRACTION_ID:
     case CLOSURE_BSDF_MICROFACET_GGX_GLASS_ID:
@@ -537,23 +620,32 @@ ccl_device_inline
        * for how to solve this. */
       eval = bsdf_microfacet_ggx_eval(kg, sc, sd->N, sd->wi, wo, pdf);
       break;
+#  endif
+#  ifdef __CLOSURE_MICROFACET_BECKMANN__
     case CLOSURE_BSDF_MICROFACET_BECKMANN_ID:
     case CLOSURE_BSDF_MICROFACET_BECKMANN_REFRACTION_ID:
     case CLOSURE_BSDF_MICROFACET_BECKMANN_GLASS_ID:
       eval = bsdf_microfacet_beckmann_eval(kg, sc, sd->N, sd->wi, wo, pdf);
       break;
+#  endif
+#  ifdef __CLOSURE_ASHIKHMIN_SHIRLEY__
     case CLOSURE_BSDF_ASHIKHMIN_SHIRLEY_ID:
       eval = bsdf_ashikhmin_shirley_eval(sc, sd->N, sd->wi, wo, pdf);
       break;
+#  endif
+#  ifdef __CLOSURE_ASHIKHMIN_VELVET__
     case CLOSURE_BSDF_ASHIKHMIN_VELVET_ID:
       eval = bsdf_ashikhmin_velvet_eval(sc, sd->wi, wo, pdf);
       break;
+#  endif
+#  ifdef __CLOSURE_TOON__
     case CLOSURE_BSDF_DIFFUSE_TOON_ID:
       eval = bsdf_diffuse_toon_eval(sc, sd->wi, wo, pdf);
       break;
     case CLOSURE_BSDF_GLOSSY_TOON_ID:
       eval = bsdf_glossy_toon_eval(sc, sd->wi, wo, pdf);
       break;
+#  endif
 #  ifdef __PRINCIPLED_HAIR__
     case CLOSURE_BSDF_HAIR_CHIANG_ID:
       eval = bsdf_hair_chiang_eval(kg, sd, sc, wo, pdf);
@@ -562,15 +654,19 @@ ccl_device_inline
       eval = bsdf_hair_huang_eval(kg, sd, sc, wo, pdf);
       break;
 #  endif
+#  ifdef __CLOSURE_HAIR__
     case CLOSURE_BSDF_HAIR_REFLECTION_ID:
       eval = bsdf_hair_reflection_eval(sc, sd->wi, wo, pdf);
       break;
     case CLOSURE_BSDF_HAIR_TRANSMISSION_ID:
       eval = bsdf_hair_transmission_eval(sc, sd->wi, wo, pdf);
       break;
+#  endif
+#  ifdef __CLOSURE_SHEEN__
     case CLOSURE_BSDF_SHEEN_ID:
       eval = bsdf_sheen_eval(sc, sd->wi, wo, pdf);
       break;
+#  endif
 #endif
     default:
       break;
@@ -604,18 +700,26 @@ ccl_device void bsdf_blur(KernelGlobals kg, ccl_private ShaderClosure *sc, const
   /* TODO: do we want to blur volume closures? */
 #if defined(__SVM__) || defined(__OSL__)
   switch (sc->type) {
+#  if defined(__CLOSURE_MICROFACET_GGX__) || defined(__CLOSURE_MICROFACET_BECKMANN__)
+#    ifdef __CLOSURE_MICROFACET_GGX__
     case CLOSURE_BSDF_MICROFACET_GGX_ID:
     case CLOSURE_BSDF_MICROFACET_GGX_REFRACTION_ID:
     case CLOSURE_BSDF_MICROFACET_GGX_GLASS_ID:
+#    endif
+#    ifdef __CLOSURE_MICROFACET_BECKMANN__
     case CLOSURE_BSDF_MICROFACET_BECKMANN_ID:
     case CLOSURE_BSDF_MICROFACET_BECKMANN_REFRACTION_ID:
     case CLOSURE_BSDF_MICROFACET_BECKMANN_GLASS_ID:
+#    endif
       /* TODO: Recompute energy preservation after blur? */
       bsdf_microfacet_blur(sc, roughness);
       break;
+#  endif
+#  ifdef __CLOSURE_ASHIKHMIN_SHIRLEY__
     case CLOSURE_BSDF_ASHIKHMIN_SHIRLEY_ID:
       bsdf_ashikhmin_shirley_blur(sc, roughness);
       break;
+#  endif
 #  ifdef __PRINCIPLED_HAIR__
     case CLOSURE_BSDF_HAIR_CHIANG_ID:
       bsdf_hair_chiang_blur(sc, roughness);
@@ -22,10 +22,15 @@ KERNEL_DATA_ARRAY(float2, prim_time)
 KERNEL_DATA_ARRAY(KernelObject, objects)
 KERNEL_DATA_ARRAY(Transform, object_motion_pass)
 KERNEL_DATA_ARRAY(DecomposedTransform, object_motion)
+KERNEL_DATA_ARRAY(Transform, object_motion_lerp)
 KERNEL_DATA_ARRAY(uint, object_flag)
 KERNEL_DATA_ARRAY(float, object_volume_step)
 KERNEL_DATA_ARRAY(uint, object_prim_offset)
 
+/* volumes */
+KERNEL_DATA_ARRAY(KernelVolumeOccupancy, volume_occupancy)
+KERNEL_DATA_ARRAY(uint, volume_occupancy_bits)
+
 /* cameras */
 KERNEL_DATA_ARRAY(DecomposedTransform, camera_motion)
 
@@ -58,6 +58,11 @@ KERNEL_STRUCT_MEMBER(bvh, int, have_volumes)
 KERNEL_STRUCT_MEMBER(bvh, int, bvh_layout)
 KERNEL_STRUCT_MEMBER(bvh, int, use_bvh_steps)
 KERNEL_STRUCT_MEMBER(bvh, int, curve_subdivisions)
+/* Nodes store quantized bounds in two slots instead of four. */
+KERNEL_STRUCT_MEMBER(bvh, int, use_compact)
+KERNEL_STRUCT_MEMBER(bvh, int, pad1)
+KERNEL_STRUCT_MEMBER(bvh, int, pad2)
+KERNEL_STRUCT_MEMBER(bvh, int, pad3)
 KERNEL_STRUCT_END(KernelBVH)
 
 /* Film. */
@@ -205,6 +210,17 @@ KERNEL_STRUCT_MEMBER(integrator, int, volume_max_steps)
 KERNEL_STRUCT_MEMBER(integrator, float, volume_step_rate)
 /* Shadow catcher. */
 KERNEL_STRUCT_MEMBER(integrator, int, has_shadow_catcher)
+/* Conservative raster-space bounds of all shadow catcher objects, as a half-open rectangle
+ * [min_x, max_x) x [min_y, max_y). Consumed on the host by the CPU path tracing work to skip
+ * the shadow catcher path split for pixels that cannot see a catcher; kernels do not read it. */
+KERNEL_STRUCT_MEMBER_DONT_SPECIALIZE
+KERNEL_STRUCT_MEMBER(integrator, int, shadow_catcher_rect_min_x)
+KERNEL_STRUCT_MEMBER_DONT_SPECIALIZE
+KERNEL_STRUCT_MEMBER(integrator, int, shadow_catcher_rect_min_y)
+KERNEL_STRUCT_MEMBER_DONT_SPECIALIZE
+KERNEL_STRUCT_MEMBER(integrator, int, shadow_catcher_rect_max_x)
+KERNEL_STRUCT_MEMBER_DONT_SPECIALIZE
+KERNEL_STRUCT_MEMBER(integrator, int, shadow_catcher_rect_max_y)
 /* Closure filter. */
 KERNEL_STRUCT_MEMBER(integrator, int, filter_closures)
 /* MIS debugging. */
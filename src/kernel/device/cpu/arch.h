@@ -23,6 +23,13 @@
 # define WITH_CYCLES_OPTIMIZED_KERNEL_AVX2
 #endif
 
+// On AVX-512, enable optimized AVX-512 kernels.
+
+#if defined(__AVX512F__)
+# define __KERNEL_AVX512__
+# define WITH_CYCLES_OPTIMIZED_KERNEL_AVX512
+#endif
+
 // On ARM, the minimum architecture is SSE4.2 (via SSE2NEON). Most code is
 // shared with SSE, some specializations for performance and compatibility
 // are made made testing for __KERNEL_NEON__.
@@ -83,6 +83,9 @@ struct CCLShadowContext
   numhit_t max_hits;
   numhit_t num_hits;
   numhit_t num_recorded_hits;
+  /* Cached shadow transparency attribute lookup for curve hits. */
+  int curve_shadow_object;
+  int curve_shadow_offset;
 };
 
 struct CCLLocalContext
@@ -365,8 +368,13 @@ ccl_device_forceinline void kernel_embree_filter_occluded_shadow_all_func_impl(
 
   /* Always use baked shadow transparency for curves. */
   if (current_isect.type & PRIMITIVE_CURVE) {
-    ctx->throughput *= intersection_curve_shadow_transparency(
-        kg, current_isect.object, current_isect.prim, current_isect.type, current_isect.u);
+    ctx->throughput *= intersection_curve_shadow_transparency_cached(kg,
+                                                                     current_isect.object,
+                                                                     current_isect.prim,
+                                                                     current_isect.type,
+                                                                     current_isect.u,
+                                                                     &ctx->curve_shadow_object,
+                                                                     &ctx->curve_shadow_offset);
 
     if (ctx->throughput < CURVE_SHADOW_TRANSPARENCY_CUTOFF) {
       ctx->opaque_hit = true;
@@ -885,6 +893,8 @@ ccl_device_intersect bool kernel_embree_intersect_shadow_all(KernelGlobals kg,
   ctx.num_hits = ctx.num_recorded_hits = numhit_t(0);
   ctx.throughput = 1.0f;
   ctx.opaque_hit = false;
+  ctx.curve_shadow_object = OBJECT_NONE;
+  ctx.curve_shadow_offset = ATTR_STD_NOT_FOUND;
   ctx.isect_s = state;
   ctx.max_hits = numhit_t(max_hits);
   ctx.max_t = ray->tmax;
@@ -909,6 +919,190 @@ ccl_device_intersect bool kernel_embree_intersect_shadow_all(KernelGlobals kg,
 }
 #endif
 
+#if !defined(__KERNEL_ONEAPI__) && EMBREE_MAJOR_VERSION >= 4
+
+/* Boolean occlusion query for a single opaque shadow ray.
+ *
+ * Terminates at the first accepted hit instead of searching for the closest one, which the
+ * closest-hit query behind scene_intersect has to do. Only usable when no transparent shadow
+ * intersections need to be recorded. */
+
+struct CCLShadowOpaqueContext : public RTCRayQueryContext {
+  KernelGlobals kg;
+  /* For self intersection and shadow link tests. */
+  const Ray *ray;
+};
+
+ccl_device_forceinline void kernel_embree_filter_occluded_shadow_opaque_func(
+    const RTCFilterFunctionNArguments *args)
+{
+  /* Current implementation in Cycles assumes only single-ray intersection queries. */
+  assert(args->N == 1);
+
+  const RTCRay *ray = (RTCRay *)args->ray;
+  const RTCHit *hit = (RTCHit *)args->hit;
+  const CCLShadowOpaqueContext *ctx = (const CCLShadowOpaqueContext *)(args->context);
+  const KernelGlobals kg = ctx->kg;
+  const Ray *cray = ctx->ray;
+
+  Intersection current_isect;
+  kernel_embree_convert_hit(
+      kg, ray, hit, &current_isect, reinterpret_cast<intptr_t>(args->geometryUserPtr));
+  if (intersection_skip_self_shadow(cray->self, current_isect.object, current_isect.prim)) {
+    *args->valid = 0;
+    return;
+  }
+
+#  ifdef __SHADOW_LINKING__
+  if (intersection_skip_shadow_link(kg, cray->self, current_isect.object)) {
+    *args->valid = 0;
+    return;
+  }
+#  endif
+
+  /* Accept the hit: the ray is occluded and traversal terminates. */
+}
+
+ccl_device_intersect bool kernel_embree_intersect_shadow(KernelGlobals kg,
+                                                         const ccl_private Ray *ray,
+                                                         const uint visibility)
+{
+  CCLShadowOpaqueContext ctx;
+  rtcInitRayQueryContext(&ctx);
+  ctx.kg = kg;
+  ctx.ray = ray;
+
+  RTCRay rtc_ray;
+  kernel_embree_setup_ray(*ray, rtc_ray, visibility);
+
+  RTCOccludedArguments args;
+  rtcInitOccludedArguments(&args);
+  args.filter = reinterpret_cast<RTCFilterFunctionN>(
+      kernel_embree_filter_occluded_shadow_opaque_func);
+  args.feature_mask = CYCLES_EMBREE_USED_FEATURES;
+  args.context = &ctx;
+
+  rtcOccluded1(kernel_data.device_bvh, &rtc_ray, &args);
+
+  /* rtcOccluded1 sets tfar to -inf if a hit was found. */
+  return (rtc_ray.tfar < 0.0f);
+}
+
+/* Batched occlusion query for opaque shadow rays.
+ *
+ * Traces a packet of shadow rays collected by the CPU wavefront pipeline
+ * through the scene BVH together. Only usable when no transparent shadow
+ * intersections need to be recorded, since the query is a boolean one. */
+
+#  define EMBREE_SHADOW_PACKET_SIZE 16
+
+struct CCLShadowPacketContext : public RTCRayQueryContext {
+  KernelGlobals kg;
+  /* Per-lane rays, for self intersection and shadow link tests. */
+  const Ray *rays[EMBREE_SHADOW_PACKET_SIZE];
+};
+
+ccl_device_forceinline void kernel_embree_filter_occluded_shadow_packet_func(
+    const RTCFilterFunctionNArguments *args)
+{
+  const CCLShadowPacketContext *ctx = (const CCLShadowPacketContext *)(args->context);
+  const KernelGlobals kg = ctx->kg;
+  const uint N = args->N;
+
+  for (uint i = 0; i < N; ++i) {
+    if (args->valid[i] == 0) {
+      continue;
+    }
+
+    /* Traversal may repack lanes, so map back to the original ray by id. */
+    const Ray *cray = ctx->rays[RTCRayN_id(args->ray, N, i)];
+
+    const uint geom_id = RTCHitN_geomID(args->hit, N, i);
+    const uint inst_id = RTCHitN_instID(args->hit, N, i, 0);
+    const int object = (int)((inst_id != RTC_INVALID_GEOMETRY_ID ? inst_id : geom_id) / 2);
+
+    int prim = (int)RTCHitN_primID(args->hit, N, i) +
+               (int)reinterpret_cast<intptr_t>(args->geometryUserPtr);
+    if (EMBREE_IS_HAIR(geom_id)) {
+      prim = kernel_data_fetch(curve_segments, prim).prim;
+    }
+
+    if (intersection_skip_self_shadow(cray->self, object, prim)) {
+      args->valid[i] = 0;
+      continue;
+    }
+
+#  ifdef __SHADOW_LINKING__
+    if (intersection_skip_shadow_link(kg, cray->self, object)) {
+      args->valid[i] = 0;
+      continue;
+    }
+#  endif
+
+    /* Accept the hit: the lane is occluded and its traversal terminates. */
+  }
+}
+
+ccl_device_intersect void kernel_embree_intersect_shadow_packet(KernelGlobals kg,
+                                                                const ccl_private Ray *rays,
+                                                                const uint *visibilities,
+                                                                const int num_rays,
+                                                                bool *opaque_hit)
+{
+  kernel_assert(num_rays <= EMBREE_SHADOW_PACKET_SIZE);
+
+  CCLShadowPacketContext ctx;
+  rtcInitRayQueryContext(&ctx);
+  ctx.kg = kg;
+
+  ccl_align(64) RTCRay16 rtc_rays;
+  ccl_align(64) int valid[EMBREE_SHADOW_PACKET_SIZE];
+  memset(&rtc_rays, 0, sizeof(rtc_rays));
+
+  for (int i = 0; i < EMBREE_SHADOW_PACKET_SIZE; ++i) {
+    /* Disable the unused lanes of a partial packet, and lanes with degenerate
+     * rays which the scalar path would have rejected as well. Keep tfar
+     * positive so such lanes read back as unoccluded. */
+    if (i >= num_rays || !intersection_ray_valid(&rays[i])) {
+      rtc_rays.tnear[i] = 1.0f;
+      rtc_rays.tfar[i] = 0.0f;
+      valid[i] = 0;
+      continue;
+    }
+
+    const Ray &ray = rays[i];
+    rtc_rays.org_x[i] = ray.P.x;
+    rtc_rays.org_y[i] = ray.P.y;
+    rtc_rays.org_z[i] = ray.P.z;
+    rtc_rays.dir_x[i] = ray.D.x;
+    rtc_rays.dir_y[i] = ray.D.y;
+    rtc_rays.dir_z[i] = ray.D.z;
+    rtc_rays.tnear[i] = ray.tmin;
+    rtc_rays.tfar[i] = ray.tmax;
+    rtc_rays.time[i] = ray.time;
+    rtc_rays.mask[i] = visibilities[i];
+    rtc_rays.id[i] = i;
+    ctx.rays[i] = &ray;
+    valid[i] = -1;
+  }
+
+  RTCOccludedArguments args;
+  rtcInitOccludedArguments(&args);
+  args.filter = reinterpret_cast<RTCFilterFunctionN>(
+      kernel_embree_filter_occluded_shadow_packet_func);
+  args.feature_mask = CYCLES_EMBREE_USED_FEATURES;
+  args.context = &ctx;
+
+  rtcOccluded16(valid, kernel_data.device_bvh, &rtc_rays, &args);
+
+  /* rtcOccluded sets tfar to -inf for the lanes which found an opaque hit. */
+  for (int i = 0; i < num_rays; ++i) {
+    opaque_hit[i] = (rtc_rays.tfar[i] < 0.0f);
+  }
+}
+
+#endif
+
 #ifdef __VOLUME__
 ccl_device_intersect uint kernel_embree_intersect_volume(KernelGlobals kg,
                                                          const ccl_private Ray *ray,
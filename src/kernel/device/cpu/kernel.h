@@ -38,4 +38,7 @@ void kernel_global_memory_copy(KernelGlobalsCPU *kg,
 #define KERNEL_ARCH cpu_avx2
 #include "kernel/device/cpu/kernel_arch.h"
 
+#define KERNEL_ARCH cpu_avx512
+#include "kernel/device/cpu/kernel_arch.h"
+
 }
@@ -25,13 +25,41 @@
       KernelWorkTile *tile, \
       ccl_global float *render_buffer)
 
+#define KERNEL_INTEGRATOR_STEP_FUNCTION(name) \
+  uint32_t KERNEL_FUNCTION_FULL_NAME(integrator_##name)( \
+      const ThreadKernelGlobalsCPU *ccl_restrict kg, \
+      IntegratorStateCPU *state, \
+      ccl_global float *render_buffer)
+
+#define KERNEL_INTEGRATOR_BATCH_FUNCTION(name) \
+  void KERNEL_FUNCTION_FULL_NAME(integrator_##name)( \
+      const ThreadKernelGlobalsCPU *ccl_restrict kg, \
+      IntegratorStateCPU *const *states, \
+      uint32_t *queued_kernels, \
+      const int num_states)
+
+#define KERNEL_INTEGRATOR_INIT_BATCH_FUNCTION(name) \
+  void KERNEL_FUNCTION_FULL_NAME(integrator_##name)( \
+      const ThreadKernelGlobalsCPU *ccl_restrict kg, \
+      IntegratorStateCPU *const *states, \
+      const KernelWorkTile *ccl_restrict tiles, \
+      ccl_global float *render_buffer, \
+      uint32_t *queued_kernels, \
+      const int num_states)
+
 KERNEL_INTEGRATOR_INIT_FUNCTION(init_from_camera);
 KERNEL_INTEGRATOR_INIT_FUNCTION(init_from_bake);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel);
+KERNEL_INTEGRATOR_STEP_FUNCTION(megakernel_step);
+KERNEL_INTEGRATOR_BATCH_FUNCTION(intersect_shadow_batch);
+KERNEL_INTEGRATOR_INIT_BATCH_FUNCTION(init_from_camera_batch);
 
 #undef KERNEL_INTEGRATOR_FUNCTION
 #undef KERNEL_INTEGRATOR_INIT_FUNCTION
 #undef KERNEL_INTEGRATOR_SHADE_FUNCTION
+#undef KERNEL_INTEGRATOR_STEP_FUNCTION
+#undef KERNEL_INTEGRATOR_BATCH_FUNCTION
+#undef KERNEL_INTEGRATOR_INIT_BATCH_FUNCTION
 
 #define KERNEL_FILM_CONVERT_FUNCTION(name) \
   void KERNEL_FUNCTION_FULL_NAME(film_convert_##name)(const KernelFilmConvert *kfilm_convert, \
@@ -96,20 +124,16 @@ bool KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_convergence_check)(
     const int offset,
     int stride);
 
-void KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_filter_x)(const ThreadKernelGlobalsCPU *kg,
-                                                           ccl_global float *render_buffer,
-                                                           const int y,
-                                                           const int start_x,
-                                                           const int width,
-                                                           const int offset,
-                                                           int stride);
-void KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_filter_y)(const ThreadKernelGlobalsCPU *kg,
-                                                           ccl_global float *render_buffer,
-                                                           const int x,
-                                                           const int start_y,
-                                                           const int height,
-                                                           const int offset,
-                                                           int stride);
+void KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_filter)(const ThreadKernelGlobalsCPU *kg,
+                                                         ccl_global float *render_buffer,
+                                                         const int x,
+                                                         const int y,
+                                                         const int start_x,
+                                                         const int start_y,
+                                                         const int width,
+                                                         const int height,
+                                                         const int offset,
+                                                         int stride);
 
 /* --------------------------------------------------------------------
  * Cryptomatte.
@@ -92,9 +92,50 @@ namespace ccl {
     KERNEL_INVOKE(name, kg, &state->shadow, render_buffer); \
   }
 
+/* Executes a single queued kernel of the path and returns the kernel queued after it, or 0 once
+ * the path has finished. This is what the wavefront mode of the CPU device schedules, batching
+ * states per kernel in between steps. */
+#define DEFINE_INTEGRATOR_STEP_KERNEL(name) \
+  uint32_t KERNEL_FUNCTION_FULL_NAME(integrator_##name)(const ThreadKernelGlobalsCPU *kg, \
+                                                        IntegratorStateCPU *state, \
+                                                        ccl_global float *render_buffer) \
+  { \
+    return KERNEL_INVOKE(name, kg, state, render_buffer) ? \
+               KERNEL_INVOKE(megakernel_queued_kernel, state) : \
+               0; \
+  }
+
+/* Steps a batch of states all queued for the same kernel at once, writing the kernel queued
+ * after it per state. Used by the wavefront mode of the CPU device for kernels which benefit
+ * from tracing coherent rays together. */
+#define DEFINE_INTEGRATOR_BATCH_KERNEL(name) \
+  void KERNEL_FUNCTION_FULL_NAME(integrator_##name)(const ThreadKernelGlobalsCPU *kg, \
+                                                    IntegratorStateCPU *const *states, \
+                                                    uint32_t *queued_kernels, \
+                                                    const int num_states) \
+  { \
+    KERNEL_INVOKE(name, kg, states, queued_kernels, num_states); \
+  }
+
+/* Initializes a batch of states at once, generating the camera rays with the SIMD batch
+ * samplers. Used by the wavefront mode of the CPU device. */
+#define DEFINE_INTEGRATOR_INIT_BATCH_KERNEL(name) \
+  void KERNEL_FUNCTION_FULL_NAME(integrator_##name)(const ThreadKernelGlobalsCPU *kg, \
+                                                    IntegratorStateCPU *const *states, \
+                                                    const KernelWorkTile *tiles, \
+                                                    ccl_global float *render_buffer, \
+                                                    uint32_t *queued_kernels, \
+                                                    const int num_states) \
+  { \
+    KERNEL_INVOKE(name, kg, states, tiles, render_buffer, queued_kernels, num_states); \
+  }
+
 DEFINE_INTEGRATOR_INIT_KERNEL(init_from_camera)
 DEFINE_INTEGRATOR_INIT_KERNEL(init_from_bake)
 DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel)
+DEFINE_INTEGRATOR_STEP_KERNEL(megakernel_step)
+DEFINE_INTEGRATOR_BATCH_KERNEL(intersect_shadow_batch)
+DEFINE_INTEGRATOR_INIT_BATCH_KERNEL(init_from_camera_batch)
 
 /* --------------------------------------------------------------------
  * Shader evaluation.
@@ -160,33 +201,22 @@ bool KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_convergence_check)(
 #endif
 }
 
-void KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_filter_x)(const ThreadKernelGlobalsCPU *kg,
-                                                           ccl_global float *render_buffer,
-                                                           const int y,
-                                                           const int start_x,
-                                                           const int width,
-                                                           const int offset,
-                                                           const int stride)
-{
-#ifdef KERNEL_STUB
-  STUB_ASSERT(KERNEL_ARCH, adaptive_sampling_filter_x);
-#else
-  film_adaptive_sampling_filter_x(kg, render_buffer, y, start_x, width, offset, stride);
-#endif
-}
-
-void KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_filter_y)(const ThreadKernelGlobalsCPU *kg,
-                                                           ccl_global float *render_buffer,
-                                                           const int x,
-                                                           const int start_y,
-                                                           const int height,
-                                                           const int offset,
-                                                           const int stride)
+void KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_filter)(const ThreadKernelGlobalsCPU *kg,
+                                                         ccl_global float *render_buffer,
+                                                         const int x,
+                                                         const int y,
+                                                         const int start_x,
+                                                         const int start_y,
+                                                         const int width,
+                                                         const int height,
+                                                         const int offset,
+                                                         const int stride)
 {
 #ifdef KERNEL_STUB
-  STUB_ASSERT(KERNEL_ARCH, adaptive_sampling_filter_y);
+  STUB_ASSERT(KERNEL_ARCH, adaptive_sampling_filter);
 #else
-  film_adaptive_sampling_filter_y(kg, render_buffer, x, start_y, height, offset, stride);
+  film_adaptive_sampling_filter_pixel(
+      kg, render_buffer, x, y, start_x, start_y, width, height, offset, stride);
 #endif
 }
 
@@ -243,6 +273,12 @@ void KERNEL_FUNCTION_FULL_NAME(cryptomatte_postprocess)(const ThreadKernelGlobal
     { \
       for (int i = 0; i < width; i++, buffer += buffer_stride, pixel += pixel_stride) { \
         film_get_pass_pixel_##name(kfilm_convert, buffer, pixel); \
+        if (kfilm_convert->clamp_max != 0.0f) { \
+          const int num_clamp_channels = min(kfilm_convert->num_components, 3); \
+          for (int ch = 0; ch < num_clamp_channels; ch++) { \
+            pixel[ch] = clamp(pixel[ch], 0.0f, kfilm_convert->clamp_max); \
+          } \
+        } \
       } \
     } \
     void KERNEL_FUNCTION_FULL_NAME(film_convert_half_rgba_##name)( \
@@ -279,15 +315,140 @@ KERNEL_FILM_CONVERT_FUNCTION(motion, false)
 KERNEL_FILM_CONVERT_FUNCTION(cryptomatte, false)
 KERNEL_FILM_CONVERT_FUNCTION(shadow_catcher, false)
 KERNEL_FILM_CONVERT_FUNCTION(shadow_catcher_matte_with_shadow, false)
-KERNEL_FILM_CONVERT_FUNCTION(combined, false)
 KERNEL_FILM_CONVERT_FUNCTION(float4, false)
 
+/* The combined pass sits directly on the interactive display path, so it gets a hand written
+ * implementation. When there is no per-pixel sample count pass the scale is uniform across the
+ * frame and the conversion reduces to an affine transform, processed two pixels per float8.
+ * Lanes 3 and 7 hold alpha, which takes 1 - transparency with a clamp instead. */
+
+#ifdef KERNEL_STUB
+
+void KERNEL_FUNCTION_FULL_NAME(film_convert_combined)(const KernelFilmConvert *kfilm_convert,
+                                                      const float *buffer,
+                                                      float *pixel,
+                                                      const int width,
+                                                      const int buffer_stride,
+                                                      const int pixel_stride)
+{
+  STUB_ASSERT(KERNEL_ARCH, film_convert_combined);
+}
+
+void KERNEL_FUNCTION_FULL_NAME(film_convert_half_rgba_combined)(
+    const KernelFilmConvert *kfilm_convert,
+    const float *buffer,
+    half4 *pixel,
+    const int width,
+    const int buffer_stride)
+{
+  STUB_ASSERT(KERNEL_ARCH, film_convert_half_rgba_combined);
+}
+
+#else
+
+#  if defined(__KERNEL_AVX2__)
+ccl_device_inline bool film_convert_combined_uniform_scale(
+    const KernelFilmConvert *kfilm_convert, vfloat8 *scale8)
+{
+  if (kfilm_convert->pass_sample_count != PASS_UNUSED) {
+    return false;
+  }
+
+  const float scale = kfilm_convert->scale;
+  const float scale_exposure = kfilm_convert->scale_exposure;
+  *scale8 = make_vfloat8(
+      scale_exposure, scale_exposure, scale_exposure, scale,
+      scale_exposure, scale_exposure, scale_exposure, scale);
+  return true;
+}
+
+ccl_device_inline vfloat8 film_convert_combined_two_pixels(const KernelFilmConvert *kfilm_convert,
+                                                           const float *buffer,
+                                                           const int buffer_stride,
+                                                           const vfloat8 scale8)
+{
+  const float *in = buffer + kfilm_convert->pass_offset;
+  const vfloat8 v = make_vfloat8(load_float4(in), load_float4(in + buffer_stride)) * scale8;
+  /* Keep the scaled color and replace the alpha lanes with 1 - transparency. */
+  const vfloat8 alpha_lanes = make_vfloat8(0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+  return v + (saturate(one_vfloat8() - v) - v) * alpha_lanes;
+}
+#  endif
+
+void KERNEL_FUNCTION_FULL_NAME(film_convert_combined)(const KernelFilmConvert *kfilm_convert,
+                                                      const float *buffer,
+                                                      float *pixel,
+                                                      const int width,
+                                                      const int buffer_stride,
+                                                      const int pixel_stride)
+{
+  int i = 0;
+
+#  if defined(__KERNEL_AVX2__)
+  vfloat8 scale8;
+  if (pixel_stride == 4 && kfilm_convert->clamp_max == 0.0f &&
+      film_convert_combined_uniform_scale(kfilm_convert, &scale8))
+  {
+    for (; i + 2 <= width; i += 2, buffer += 2 * buffer_stride, pixel += 8) {
+      const vfloat8 result = film_convert_combined_two_pixels(
+          kfilm_convert, buffer, buffer_stride, scale8);
+      _mm256_storeu_ps(pixel, result.m256);
+    }
+  }
+#  endif
+
+  for (; i < width; i++, buffer += buffer_stride, pixel += pixel_stride) {
+    film_get_pass_pixel_combined(kfilm_convert, buffer, pixel);
+    if (kfilm_convert->clamp_max != 0.0f) {
+      const int num_clamp_channels = min(kfilm_convert->num_components, 3);
+      for (int ch = 0; ch < num_clamp_channels; ch++) {
+        pixel[ch] = clamp(pixel[ch], 0.0f, kfilm_convert->clamp_max);
+      }
+    }
+  }
+}
+
+void KERNEL_FUNCTION_FULL_NAME(film_convert_half_rgba_combined)(
+    const KernelFilmConvert *kfilm_convert,
+    const float *buffer,
+    half4 *pixel,
+    const int width,
+    const int buffer_stride)
+{
+  int i = 0;
+
+#  if defined(__KERNEL_AVX2__)
+  vfloat8 scale8;
+  const bool use_overlays = kfilm_convert->show_active_pixels &&
+                            kfilm_convert->pass_adaptive_aux_buffer != PASS_UNUSED;
+  if (!use_overlays && film_convert_combined_uniform_scale(kfilm_convert, &scale8)) {
+    for (; i + 2 <= width; i += 2, buffer += 2 * buffer_stride, pixel += 2) {
+      const vfloat8 result = film_convert_combined_two_pixels(
+          kfilm_convert, buffer, buffer_stride, scale8);
+      pixel[0] = float4_to_half4_display(low(result));
+      pixel[1] = float4_to_half4_display(high(result));
+    }
+  }
+#  endif
+
+  for (; i < width; i++, buffer += buffer_stride, pixel++) {
+    float pixel_rgba[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    film_get_pass_pixel_combined(kfilm_convert, buffer, pixel_rgba);
+    film_apply_pass_pixel_overlays_rgba(kfilm_convert, buffer, pixel_rgba);
+    *pixel = float4_to_half4_display(
+        make_float4(pixel_rgba[0], pixel_rgba[1], pixel_rgba[2], pixel_rgba[3]));
+  }
+}
+
+#endif
+
 #undef KERNEL_FILM_CONVERT_FUNCTION
 
 #undef KERNEL_INVOKE
 #undef DEFINE_INTEGRATOR_KERNEL
 #undef DEFINE_INTEGRATOR_SHADE_KERNEL
 #undef DEFINE_INTEGRATOR_INIT_KERNEL
+#undef DEFINE_INTEGRATOR_STEP_KERNEL
 
 #undef KERNEL_STUB
 #undef STUB_ASSERT
@@ -293,6 +293,14 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, const int id, const
   }
 }
 
+/* GPU devices sample hardware texture objects without a CPU-side mip chain, so the footprint
+ * is ignored and the base level is read. */
+ccl_device float4 kernel_tex_image_interp_lod(
+    KernelGlobals kg, const int id, const float x, const float y, const float /*footprint*/)
+{
+  return kernel_tex_image_interp(kg, id, x, y);
+}
+
 ccl_device float4 kernel_tex_image_interp_3d(KernelGlobals kg,
                                              const int id,
                                              float3 P,
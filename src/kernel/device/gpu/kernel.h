@@ -702,7 +702,7 @@ ccl_gpu_kernel(GPU_KERNEL_BLOCK_NUM_THREADS, GPU_KERNEL_MAX_REGISTERS)
 ccl_gpu_kernel_postfix
 
 ccl_gpu_kernel(GPU_KERNEL_BLOCK_NUM_THREADS, GPU_KERNEL_MAX_REGISTERS)
-    ccl_gpu_kernel_signature(adaptive_sampling_filter_x,
+    ccl_gpu_kernel_signature(adaptive_sampling_filter,
                              ccl_global float *render_buffer,
                              const int sx,
                              const int sy,
@@ -711,30 +711,39 @@ ccl_gpu_kernel(GPU_KERNEL_BLOCK_NUM_THREADS, GPU_KERNEL_MAX_REGISTERS)
                              const int offset,
                              const int stride)
 {
-  const int y = ccl_gpu_global_id_x();
+  const int work_index = ccl_gpu_global_id_x();
+  const int y = work_index / sw;
+  const int x = work_index - y * sw;
 
-  if (y < sh) {
-    ccl_gpu_kernel_call(
-        film_adaptive_sampling_filter_x(nullptr, render_buffer, sy + y, sx, sw, offset, stride));
+  if (x < sw && y < sh) {
+    ccl_gpu_kernel_call(film_adaptive_sampling_filter_pixel(
+        nullptr, render_buffer, sx + x, sy + y, sx, sy, sw, sh, offset, stride));
   }
 }
 ccl_gpu_kernel_postfix
 
 ccl_gpu_kernel(GPU_KERNEL_BLOCK_NUM_THREADS, GPU_KERNEL_MAX_REGISTERS)
-    ccl_gpu_kernel_signature(adaptive_sampling_filter_y,
+    ccl_gpu_kernel_signature(adaptive_sampling_count_active_blocks,
                              ccl_global float *render_buffer,
                              const int sx,
                              const int sy,
                              const int sw,
                              const int sh,
                              const int offset,
-                             const int stride)
+                             const int stride,
+                             ccl_global uint *num_active_pixels_per_block)
 {
-  const int x = ccl_gpu_global_id_x();
+  const int block_index = ccl_gpu_global_id_x();
+  const int num_blocks_x = (sw + ADAPTIVE_SAMPLING_BLOCK_SIZE - 1) / ADAPTIVE_SAMPLING_BLOCK_SIZE;
+  const int num_blocks_y = (sh + ADAPTIVE_SAMPLING_BLOCK_SIZE - 1) / ADAPTIVE_SAMPLING_BLOCK_SIZE;
 
-  if (x < sw) {
-    ccl_gpu_kernel_call(
-        film_adaptive_sampling_filter_y(nullptr, render_buffer, sx + x, sy, sh, offset, stride));
+  if (block_index < num_blocks_x * num_blocks_y) {
+    const int block_y = block_index / num_blocks_x;
+    const int block_x = block_index - block_y * num_blocks_x;
+
+    num_active_pixels_per_block[block_index] = ccl_gpu_kernel_call(
+        film_adaptive_sampling_count_active_block_pixels(
+            nullptr, render_buffer, sx, sy, sw, sh, block_x, block_y, offset, stride));
   }
 }
 ccl_gpu_kernel_postfix
@@ -837,6 +846,13 @@ ccl_device_inline void kernel_gpu_film_convert_half_write(ccl_global uchar4 *rgb
                               (render_pixel_index + rgba_offset) * kfilm_convert.pixel_stride; \
 \
     FILM_GET_PASS_PIXEL_F32(variant, input_channel_count); \
+\
+    if (kfilm_convert.clamp_max != 0.0f) { \
+      const int num_clamp_channels = min(kfilm_convert.num_components, 3); \
+      for (int i = 0; i < num_clamp_channels; i++) { \
+        pixel[i] = clamp(pixel[i], 0.0f, kfilm_convert.clamp_max); \
+      } \
+    } \
   } \
   ccl_gpu_kernel_postfix \
 \
@@ -959,36 +975,6 @@ ccl_gpu_kernel_postfix
  * Denoising.
  */
 
-ccl_gpu_kernel(GPU_KERNEL_BLOCK_NUM_THREADS, GPU_KERNEL_MAX_REGISTERS)
-    ccl_gpu_kernel_signature(filter_color_preprocess,
-                             ccl_global float *render_buffer,
-                             const int full_x,
-                             const int full_y,
-                             const int width,
-                             const int height,
-                             const int offset,
-                             const int stride,
-                             const int pass_stride,
-                             const int pass_denoised)
-{
-  const int work_index = ccl_gpu_global_id_x();
-  const int y = work_index / width;
-  const int x = work_index - y * width;
-
-  if (x >= width || y >= height) {
-    return;
-  }
-
-  const uint64_t render_pixel_index = offset + (x + full_x) + (y + full_y) * stride;
-  ccl_global float *buffer = render_buffer + render_pixel_index * pass_stride;
-
-  ccl_global float *color_out = buffer + pass_denoised;
-  color_out[0] = clamp(color_out[0], 0.0f, 10000.0f);
-  color_out[1] = clamp(color_out[1], 0.0f, 10000.0f);
-  color_out[2] = clamp(color_out[2], 0.0f, 10000.0f);
-}
-ccl_gpu_kernel_postfix
-
 ccl_gpu_kernel(GPU_KERNEL_BLOCK_NUM_THREADS, GPU_KERNEL_MAX_REGISTERS)
     ccl_gpu_kernel_signature(filter_guiding_preprocess,
                              ccl_global float *guiding_buffer,
@@ -0,0 +1,11 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+/* HIP kernel entry points for the lite kernel variant, compiled without
+ * volume, hair, point cloud and subsurface scattering support. Selected at
+ * module load time for scenes which use none of those features. */
+
+#define __KERNEL_FEATURES_LITE__
+
+#include "kernel/device/hip/kernel.cpp"
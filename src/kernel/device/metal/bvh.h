@@ -386,10 +386,9 @@ ccl_device_intersect bool scene_intersect_local(KernelGlobals kg,
     local_isect->hits[0].v = intersection.triangle_barycentric_coord.y;
     local_isect->hits[0].t = intersection.distance;
 
-    const packed_uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
-    const float3 tri_a = float3(kernel_data_fetch(tri_verts, tri_vindex.x));
-    const float3 tri_b = float3(kernel_data_fetch(tri_verts, tri_vindex.y));
-    const float3 tri_c = float3(kernel_data_fetch(tri_verts, tri_vindex.z));
+    const float3 tri_a = float3(kernel_data_fetch(tri_verts, prim * 3 + 0));
+    const float3 tri_b = float3(kernel_data_fetch(tri_verts, prim * 3 + 1));
+    const float3 tri_c = float3(kernel_data_fetch(tri_verts, prim * 3 + 2));
     local_isect->Ng[0] = normalize(cross(tri_b - tri_a, tri_c - tri_a));
     return true;
   }
@@ -449,10 +448,9 @@ ccl_device_intersect bool scene_intersect_local(KernelGlobals kg,
         local_isect->hits[hit].object = local_object;
         local_isect->hits[hit].type = prim_type;
 
-        const packed_uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
-        const float3 tri_a = float3(kernel_data_fetch(tri_verts, tri_vindex.x));
-        const float3 tri_b = float3(kernel_data_fetch(tri_verts, tri_vindex.y));
-        const float3 tri_c = float3(kernel_data_fetch(tri_verts, tri_vindex.z));
+        const float3 tri_a = float3(kernel_data_fetch(tri_verts, prim * 3 + 0));
+        const float3 tri_b = float3(kernel_data_fetch(tri_verts, prim * 3 + 1));
+        const float3 tri_c = float3(kernel_data_fetch(tri_verts, prim * 3 + 2));
         local_isect->Ng[hit] = normalize(cross(tri_b - tri_a, tri_c - tri_a));
       }
     }
@@ -564,14 +564,18 @@ bool oneapi_enqueue_kernel(KernelContext *kernel_context,
                       oneapi_kernel_adaptive_sampling_convergence_check);
           break;
         }
-        case DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER_X: {
+        case DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER: {
           oneapi_call(
-              kg, cgh, global_size, local_size, args, oneapi_kernel_adaptive_sampling_filter_x);
+              kg, cgh, global_size, local_size, args, oneapi_kernel_adaptive_sampling_filter);
           break;
         }
-        case DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER_Y: {
-          oneapi_call(
-              kg, cgh, global_size, local_size, args, oneapi_kernel_adaptive_sampling_filter_y);
+        case DEVICE_KERNEL_ADAPTIVE_SAMPLING_COUNT_ACTIVE_BLOCKS: {
+          oneapi_call(kg,
+                      cgh,
+                      global_size,
+                      local_size,
+                      args,
+                      oneapi_kernel_adaptive_sampling_count_active_blocks);
           break;
         }
         case DEVICE_KERNEL_SHADER_EVAL_DISPLACE: {
@@ -644,11 +648,6 @@ bool oneapi_enqueue_kernel(KernelContext *kernel_context,
                       oneapi_kernel_filter_guiding_set_fake_albedo);
           break;
         }
-        case DEVICE_KERNEL_FILTER_COLOR_PREPROCESS: {
-          oneapi_call(
-              kg, cgh, global_size, local_size, args, oneapi_kernel_filter_color_preprocess);
-          break;
-        }
         case DEVICE_KERNEL_FILTER_COLOR_POSTPROCESS: {
           oneapi_call(
               kg, cgh, global_size, local_size, args, oneapi_kernel_filter_color_postprocess);
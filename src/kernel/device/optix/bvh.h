@@ -121,10 +121,9 @@ extern "C" __global__ void __anyhit__kernel_optix_local_hit()
   isect->v = barycentrics.y;
 
   /* Record geometric normal. */
-  const packed_uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
-  const float3 tri_a = kernel_data_fetch(tri_verts, tri_vindex.x);
-  const float3 tri_b = kernel_data_fetch(tri_verts, tri_vindex.y);
-  const float3 tri_c = kernel_data_fetch(tri_verts, tri_vindex.z);
+  const float3 tri_a = kernel_data_fetch(tri_verts, prim * 3 + 0);
+  const float3 tri_b = kernel_data_fetch(tri_verts, prim * 3 + 1);
+  const float3 tri_c = kernel_data_fetch(tri_verts, prim * 3 + 2);
 
   local_isect->Ng[hit] = normalize(cross(tri_b - tri_a, tri_c - tri_a));
 
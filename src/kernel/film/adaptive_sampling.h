@@ -89,71 +89,91 @@ ccl_device bool film_adaptive_sampling_convergence_check(KernelGlobals kg,
   return did_converge;
 }
 
-/* This is a simple box filter in two passes.
- * When a pixel demands more adaptive samples, let its neighboring pixels draw more samples too. */
-
-ccl_device void film_adaptive_sampling_filter_x(KernelGlobals kg,
-                                                ccl_global float *render_buffer,
-                                                const int y,
-                                                const int start_x,
-                                                const int width,
-                                                const int offset,
-                                                const int stride)
+/* Count how many pixels of a block still require samples. The counts are copied to the host
+ * after filtering, so that work scheduling can skip fully converged blocks. */
+
+ccl_device uint film_adaptive_sampling_count_active_block_pixels(KernelGlobals kg,
+                                                                 ccl_global float *render_buffer,
+                                                                 const int sx,
+                                                                 const int sy,
+                                                                 const int sw,
+                                                                 const int sh,
+                                                                 const int block_x,
+                                                                 const int block_y,
+                                                                 const int offset,
+                                                                 const int stride)
 {
   kernel_assert(kernel_data.film.pass_adaptive_aux_buffer != PASS_UNUSED);
 
-  bool prev = false;
-  for (int x = start_x; x < start_x + width; ++x) {
-    int index = offset + x + y * stride;
-    ccl_global float *buffer = render_buffer + (uint64_t)index * kernel_data.film.pass_stride;
-    const uint aux_w_offset = kernel_data.film.pass_adaptive_aux_buffer + 3;
-
-    if (buffer[aux_w_offset] == 0.0f) {
-      if (x > start_x && !prev) {
-        index = index - 1;
-        buffer = render_buffer + (uint64_t)index * kernel_data.film.pass_stride;
-        buffer[aux_w_offset] = 0.0f;
-      }
-      prev = true;
-    }
-    else {
-      if (prev) {
-        buffer[aux_w_offset] = 0.0f;
-      }
-      prev = false;
+  const int start_x = block_x * ADAPTIVE_SAMPLING_BLOCK_SIZE;
+  const int start_y = block_y * ADAPTIVE_SAMPLING_BLOCK_SIZE;
+  const int end_x = min(start_x + ADAPTIVE_SAMPLING_BLOCK_SIZE, sw);
+  const int end_y = min(start_y + ADAPTIVE_SAMPLING_BLOCK_SIZE, sh);
+
+  const uint aux_w_offset = kernel_data.film.pass_adaptive_aux_buffer + 3;
+
+  uint num_active_pixels = 0;
+  for (int y = start_y; y < end_y; ++y) {
+    for (int x = start_x; x < end_x; ++x) {
+      const int index = offset + (sx + x) + (sy + y) * stride;
+      ccl_global const float *buffer = render_buffer +
+                                       (uint64_t)index * kernel_data.film.pass_stride;
+      num_active_pixels += (buffer[aux_w_offset] == 0.0f);
     }
   }
+
+  return num_active_pixels;
 }
 
-ccl_device void film_adaptive_sampling_filter_y(KernelGlobals kg,
-                                                ccl_global float *render_buffer,
-                                                const int x,
-                                                const int start_y,
-                                                const int height,
-                                                const int offset,
-                                                const int stride)
+/* Box filter of the convergence mask.
+ * When a pixel demands more adaptive samples, let its neighboring pixels draw more samples too.
+ *
+ * Dilating the mask along X and then along Y is equivalent to a single 3x3 dilation, which allows
+ * both filter directions to be fused into one pass over the buffer.
+ *
+ * The filter runs in-place and concurrently for all pixels. Pixels activated by the filter are
+ * written as negative zero: the sampling checks compare against 0.0f and thus match both zero
+ * signs, while the filter itself tests for the exact positive zero bit pattern and so keeps
+ * seeing the original mask regardless of concurrent writes to neighboring pixels. */
+
+ccl_device void film_adaptive_sampling_filter_pixel(KernelGlobals kg,
+                                                    ccl_global float *render_buffer,
+                                                    const int x,
+                                                    const int y,
+                                                    const int start_x,
+                                                    const int start_y,
+                                                    const int width,
+                                                    const int height,
+                                                    const int offset,
+                                                    const int stride)
 {
   kernel_assert(kernel_data.film.pass_adaptive_aux_buffer != PASS_UNUSED);
 
-  bool prev = false;
-  for (int y = start_y; y < start_y + height; ++y) {
-    int index = offset + x + y * stride;
-    ccl_global float *buffer = render_buffer + (uint64_t)index * kernel_data.film.pass_stride;
-    const uint aux_w_offset = kernel_data.film.pass_adaptive_aux_buffer + 3;
-
-    if (buffer[aux_w_offset] == 0.0f) {
-      if (y > start_y && !prev) {
-        index = index - stride;
-        buffer = render_buffer + (uint64_t)index * kernel_data.film.pass_stride;
-        buffer[aux_w_offset] = 0.0f;
-      }
-      prev = true;
-    }
-    else {
-      if (prev) {
-        buffer[aux_w_offset] = 0.0f;
+  const uint aux_w_offset = kernel_data.film.pass_adaptive_aux_buffer + 3;
+
+  const int index = offset + x + y * stride;
+  ccl_global float *buffer = render_buffer + (uint64_t)index * kernel_data.film.pass_stride;
+
+  if (__float_as_uint(buffer[aux_w_offset]) == 0) {
+    /* The pixel itself requires more samples, nothing to dilate. */
+    return;
+  }
+
+  const int x0 = max(x - 1, start_x);
+  const int x1 = min(x + 1, start_x + width - 1);
+  const int y0 = max(y - 1, start_y);
+  const int y1 = min(y + 1, start_y + height - 1);
+
+  for (int ny = y0; ny <= y1; ++ny) {
+    for (int nx = x0; nx <= x1; ++nx) {
+      const int neighbor_index = offset + nx + ny * stride;
+      ccl_global const float *neighbor_buffer = render_buffer +
+                                                (uint64_t)neighbor_index *
+                                                    kernel_data.film.pass_stride;
+      if (__float_as_uint(neighbor_buffer[aux_w_offset]) == 0) {
+        buffer[aux_w_offset] = -0.0f;
+        return;
       }
-      prev = false;
     }
   }
 }
@@ -29,4 +29,15 @@ ccl_device_inline void film_write_aov_pass_color(KernelGlobals kg,
                          make_float4(color, 1.0f));
 }
 
+ccl_device_inline void film_write_aov_pass_color_half(KernelGlobals kg,
+                                                      ConstIntegratorState state,
+                                                      ccl_global float *ccl_restrict render_buffer,
+                                                      const int aov_id,
+                                                      const float3 color)
+{
+  ccl_global float *buffer = film_pass_pixel_render_buffer(kg, state, render_buffer);
+  film_write_pass_half4(buffer + kernel_data.film.pass_aov_color + aov_id,
+                        make_float4(color, 1.0f));
+}
+
 }
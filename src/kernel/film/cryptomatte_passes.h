@@ -26,13 +26,23 @@ ccl_device_inline void film_write_cryptomatte_slots(ccl_global float *buffer,
     return;
   }
 
+  /* The slots are an unsorted per-pixel accumulation log: samples only match or
+   * claim a slot here, and the slots are sorted by weight once after rendering
+   * in film_cryptomatte_post. */
   for (int slot = 0; slot < num_slots; slot++) {
     ccl_global CryptoPassBufferElement *id_buffer = (ccl_global CryptoPassBufferElement *)buffer;
 #ifdef __ATOMIC_PASS_WRITE__
+    /* Common case: the ID already has a slot (usually the first one), and all
+     * that is needed is a single atomic add of the weight. A racing claim below
+     * either stores ID_NONE or the full ID, never a partial write. */
+    if (id_buffer[slot].x == id) {
+      atomic_add_and_fetch_float(buffer + slot * 2 + 1, weight);
+      break;
+    }
     /* If the loop reaches an empty slot, the ID isn't in any slot yet - so add it! */
     if (id_buffer[slot].x == ID_NONE) {
       /* Use an atomic to claim this slot.
-       * If a different thread got here first, try again from this slot on. */
+       * If a different thread claimed it for another ID first, move on. */
       float old_id = atomic_compare_and_swap_float(buffer + slot * 2, ID_NONE, id);
       if (old_id != ID_NONE && old_id != id) {
         continue;
@@ -40,9 +50,8 @@ ccl_device_inline void film_write_cryptomatte_slots(ccl_global float *buffer,
       atomic_add_and_fetch_float(buffer + slot * 2 + 1, weight);
       break;
     }
-    /* If there already is a slot for that ID, add the weight.
-     * If no slot was found, add it to the last. */
-    else if (id_buffer[slot].x == id || slot == num_slots - 1) {
+    /* If no slot was found, add the weight to the last. */
+    if (slot == num_slots - 1) {
       atomic_add_and_fetch_float(buffer + slot * 2 + 1, weight);
       break;
     }
@@ -138,8 +138,8 @@ ccl_device_forceinline void film_clamp_light(KernelGlobals kg,
   *L = ensure_finite(*L);
 
 #ifdef __CLAMP_SAMPLE__
-  const float limit = (bounce > 0) ? kernel_data.integrator.sample_clamp_indirect :
-                                     kernel_data.integrator.sample_clamp_direct;
+  const float limit = (bounce > 0) ? kernel_data_sample_clamp_indirect :
+                                     kernel_data_sample_clamp_direct;
   const float sum = reduce_add(fabs(*L));
   if (sum > limit) {
     *L *= limit / sum;
@@ -412,8 +412,10 @@ ccl_device_inline void film_write_emission_or_background_pass(
   else if (kernel_data.kernel_features & KERNEL_FEATURE_LIGHT_PASSES) {
     if (path_flag & PATH_RAY_SURFACE_PASS) {
       /* Indirectly visible through reflection. */
-      const Spectrum diffuse_weight = INTEGRATOR_STATE(state, path, pass_diffuse_weight);
-      const Spectrum glossy_weight = INTEGRATOR_STATE(state, path, pass_glossy_weight);
+      const Spectrum diffuse_weight = spectrum_weight_unpack(
+          INTEGRATOR_STATE(state, path, pass_diffuse_weight));
+      const Spectrum glossy_weight = spectrum_weight_unpack(
+          INTEGRATOR_STATE(state, path, pass_glossy_weight));
 
       /* Glossy */
       const int glossy_pass_offset = ((INTEGRATOR_STATE(state, path, bounce) == 1) ?
@@ -510,8 +512,10 @@ ccl_device_inline void film_write_direct_light(KernelGlobals kg,
 
       if (path_flag & PATH_RAY_SURFACE_PASS) {
         /* Indirectly visible through reflection. */
-        const Spectrum diffuse_weight = INTEGRATOR_STATE(state, shadow_path, pass_diffuse_weight);
-        const Spectrum glossy_weight = INTEGRATOR_STATE(state, shadow_path, pass_glossy_weight);
+        const Spectrum diffuse_weight = spectrum_weight_unpack(
+            INTEGRATOR_STATE(state, shadow_path, pass_diffuse_weight));
+        const Spectrum glossy_weight = spectrum_weight_unpack(
+            INTEGRATOR_STATE(state, shadow_path, pass_glossy_weight));
 
         /* Glossy */
         const int glossy_pass_offset = ((INTEGRATOR_STATE(state, shadow_path, bounce) == 0) ?
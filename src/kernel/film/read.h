@@ -11,6 +11,7 @@
 #include "kernel/types.h"
 
 #include "util/color.h"
+#include "util/half.h"
 
 namespace ccl {
 
@@ -326,8 +327,23 @@ ccl_device_inline void film_get_pass_pixel_float4(const ccl_global KernelFilmCon
 
   const ccl_global float *in = buffer + kfilm_convert->pass_offset;
 
-  const float3 color = make_float3(in[0], in[1], in[2]) * scale_exposure;
-  const float alpha = in[3] * scale;
+  float3 color;
+  float alpha;
+
+  if (kfilm_convert->pass_half) {
+    /* Pass accumulated in packed half precision: two components per buffer float. */
+    const uint bits_xy = __float_as_uint(in[0]);
+    const uint bits_zw = __float_as_uint(in[1]);
+    color = make_float3(half_bits_to_float(bits_xy & 0xffff),
+                        half_bits_to_float(bits_xy >> 16),
+                        half_bits_to_float(bits_zw & 0xffff)) *
+            scale_exposure;
+    alpha = half_bits_to_float(bits_zw >> 16) * scale;
+  }
+  else {
+    color = make_float3(in[0], in[1], in[2]) * scale_exposure;
+    alpha = in[3] * scale;
+  }
 
   pixel[0] = color.x;
   pixel[1] = color.y;
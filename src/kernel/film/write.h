@@ -10,6 +10,8 @@
 
 #include "kernel/util/colorspace.h"
 
+#include "util/half.h"
+
 #ifdef __KERNEL_GPU__
 #  define __ATOMIC_PASS_WRITE__
 #endif
@@ -95,6 +97,44 @@ ccl_device_inline void film_write_pass_float4(ccl_global float *ccl_restrict buf
 #endif
 }
 
+/* Accumulate into a pair of packed half floats stored in a single float of the
+ * render buffer. Used by passes which accumulate in half precision; the values
+ * are widened back to float at read time. */
+
+ccl_device_inline void film_write_pass_half2(ccl_global float *ccl_restrict buffer,
+                                             const float x,
+                                             const float y)
+{
+#ifdef __ATOMIC_PASS_WRITE__
+  /* No atomic half additions, so unpack-add-repack in a compare and swap loop.
+   * Compare bit patterns rather than float values: the packed halves can form
+   * a NaN for which float comparison would never terminate the loop. */
+  ccl_global float *buf = buffer;
+  float old_value;
+  float new_value;
+  do {
+    old_value = *buf;
+    const uint old_bits = __float_as_uint(old_value);
+    const uint new_bits = half_float_to_bits(half_bits_to_float(old_bits & 0xffff) + x) |
+                          (half_float_to_bits(half_bits_to_float(old_bits >> 16) + y) << 16);
+    new_value = __uint_as_float(new_bits);
+  } while (__float_as_uint(atomic_compare_and_swap_float(buf, old_value, new_value)) !=
+           __float_as_uint(old_value));
+#else
+  const uint old_bits = __float_as_uint(*buffer);
+  const uint new_bits = half_float_to_bits(half_bits_to_float(old_bits & 0xffff) + x) |
+                        (half_float_to_bits(half_bits_to_float(old_bits >> 16) + y) << 16);
+  *buffer = __uint_as_float(new_bits);
+#endif
+}
+
+ccl_device_inline void film_write_pass_half4(ccl_global float *ccl_restrict buffer,
+                                             const float4 value)
+{
+  film_write_pass_half2(buffer + 0, value.x, value.y);
+  film_write_pass_half2(buffer + 1, value.z, value.w);
+}
+
 /* Overwrite for passes that only write on sample 0. This assumes only a single thread will write
  * to this pixel and no atomics are needed. */
 
@@ -42,39 +42,56 @@ ccl_device_inline AttributeDescriptor find_attribute(KernelGlobals kg,
     return attribute_not_found();
   }
 
-  /* for SVM, find attribute by unique id */
+  /* For SVM, find attribute by unique id.
+   *
+   * Each table starts with a header entry holding the number of entries that follow and, for
+   * object tables, a link to the geometry table to search next. The entries are sorted by id,
+   * so the lookup is a binary search instead of a scan over the whole table. */
   uint attr_offset = object_attribute_map_offset(kg, object);
-  AttributeMap attr_map = kernel_data_fetch(attributes_map, attr_offset);
 
-  while (attr_map.id != id) {
-    if (UNLIKELY(attr_map.id == ATTR_STD_NONE)) {
-      if (UNLIKELY(attr_map.element == 0)) {
-        return attribute_not_found();
+  for (;;) {
+    const AttributeMap header = kernel_data_fetch(attributes_map, attr_offset);
+
+    uint lo = 0;
+    uint hi = header.element;
+    while (lo < hi) {
+      const uint mid = (lo + hi) >> 1;
+      if (kernel_data_fetch(attributes_map, attr_offset + 1 + mid).id < id) {
+        lo = mid + 1;
+      }
+      else {
+        hi = mid;
       }
-      /* Chain jump to a different part of the table. */
-      attr_offset = attr_map.offset;
-    }
-    else {
-      attr_offset += ATTR_PRIM_TYPES;
     }
-    attr_map = kernel_data_fetch(attributes_map, attr_offset);
-  }
 
-  AttributeDescriptor desc;
-  desc.element = (AttributeElement)attr_map.element;
+    if (lo < header.element) {
+      const AttributeMap attr_map = kernel_data_fetch(attributes_map, attr_offset + 1 + lo);
+      if (attr_map.id == id) {
+        AttributeDescriptor desc;
+        desc.element = (AttributeElement)attr_map.element;
 
-  if (prim == PRIM_NONE && desc.element != ATTR_ELEMENT_MESH &&
-      desc.element != ATTR_ELEMENT_VOXEL && desc.element != ATTR_ELEMENT_OBJECT)
-  {
-    return attribute_not_found();
-  }
+        if (prim == PRIM_NONE && desc.element != ATTR_ELEMENT_MESH &&
+            desc.element != ATTR_ELEMENT_VOXEL && desc.element != ATTR_ELEMENT_OBJECT)
+        {
+          return attribute_not_found();
+        }
 
-  /* return result */
-  desc.offset = (attr_map.element == ATTR_ELEMENT_NONE) ? (int)ATTR_STD_NOT_FOUND :
-                                                          attr_map.offset;
-  desc.type = (NodeAttributeType)attr_map.type;
+        /* return result */
+        desc.offset = (attr_map.element == ATTR_ELEMENT_NONE) ? (int)ATTR_STD_NOT_FOUND :
+                                                                attr_map.offset;
+        desc.type = (NodeAttributeType)attr_map.type;
 
-  return desc;
+        return desc;
+      }
+    }
+
+    if (header.type == 0) {
+      return attribute_not_found();
+    }
+
+    /* Chain jump from the object table to the geometry table. */
+    attr_offset = header.offset;
+  }
 }
 
 ccl_device_inline AttributeDescriptor find_attribute(KernelGlobals kg,
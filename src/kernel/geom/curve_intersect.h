@@ -634,6 +634,41 @@ ccl_device_inline bool ribbon_intersect(const float3 ray_org,
   return false;
 }
 
+/* Conservative bounding sphere test for a whole segment, to reject rays
+ * cheaply before running the sweep intersection. The Catmull-Rom segment lies
+ * inside the convex hull of its Bezier control points, and the radius spline
+ * uses the same basis, so the hull bounds the swept volume as well. */
+ccl_device_forceinline bool curve_segment_culling_test(const float3 ray_P,
+                                                       const float3 ray_D,
+                                                       const float ray_tmin,
+                                                       const float ray_tmax,
+                                                       const float4 curve[4])
+{
+  /* Bezier control points of the segment, with radii in w. */
+  const float4 b0 = curve[1];
+  const float4 b1 = curve[1] + (curve[2] - curve[0]) * (1.0f / 6.0f);
+  const float4 b2 = curve[2] - (curve[3] - curve[1]) * (1.0f / 6.0f);
+  const float4 b3 = curve[2];
+
+  const float3 center = 0.25f * make_float3(b0 + b1 + b2 + b3);
+  const float3 d0 = make_float3(b0) - center;
+  const float3 d1 = make_float3(b1) - center;
+  const float3 d2 = make_float3(b2) - center;
+  const float3 d3 = make_float3(b3) - center;
+
+  const float hull_radius_sq = max(max(dot(d0, d0), dot(d1, d1)), max(dot(d2, d2), dot(d3, d3)));
+  const float max_radius = max(max(b0.w, b1.w), max(b2.w, b3.w));
+  /* Padded to stay conservative under accumulated rounding error. */
+  const float bound = (sqrtf(hull_radius_sq) + max_radius) * (1.0f + 1e-4f);
+
+  /* Closest point on the ray interval to the sphere center. This is exact for
+   * a non-normalized direction as well, as passed by the hardware ray-tracing
+   * backends under instancing. */
+  const float t = clamp(dot(center - ray_P, ray_D) / dot(ray_D, ray_D), ray_tmin, ray_tmax);
+  const float3 delta = center - (ray_P + t * ray_D);
+  return dot(delta, delta) <= bound * bound;
+}
+
 ccl_device_forceinline bool curve_intersect(KernelGlobals kg,
                                             ccl_private Intersection *isect,
                                             const float3 ray_P,
@@ -665,6 +700,10 @@ ccl_device_forceinline bool curve_intersect(KernelGlobals kg,
     motion_curve_keys(kg, object, time, ka, k0, k1, kb, curve);
   }
 
+  if (!curve_segment_culling_test(ray_P, ray_D, tmin, tmax, curve)) {
+    return false;
+  }
+
   if (type & PRIMITIVE_CURVE_RIBBON) {
     /* todo: adaptive number of subdivisions could help performance here. */
     const int subdivisions = kernel_data.bvh.curve_subdivisions;
@@ -24,6 +24,7 @@ namespace ccl {
 /* Time interpolation of vertex positions and normals */
 
 ccl_device_inline void motion_triangle_verts_for_step(KernelGlobals kg,
+                                                      const int prim,
                                                       const uint3 tri_vindex,
                                                       int offset,
                                                       const int numverts,
@@ -33,9 +34,9 @@ ccl_device_inline void motion_triangle_verts_for_step(KernelGlobals kg,
 {
   if (step == numsteps) {
     /* center step: regular vertex location */
-    verts[0] = kernel_data_fetch(tri_verts, tri_vindex.x);
-    verts[1] = kernel_data_fetch(tri_verts, tri_vindex.y);
-    verts[2] = kernel_data_fetch(tri_verts, tri_vindex.z);
+    verts[0] = kernel_data_fetch(tri_verts, prim * 3 + 0);
+    verts[1] = kernel_data_fetch(tri_verts, prim * 3 + 1);
+    verts[2] = kernel_data_fetch(tri_verts, prim * 3 + 2);
   }
   else {
     /* center step not store in this array */
@@ -102,6 +103,7 @@ ccl_device_inline void motion_triangle_compute_info(KernelGlobals kg,
 
 ccl_device_inline void motion_triangle_vertices(KernelGlobals kg,
                                                 const int object,
+                                                const int prim,
                                                 const uint3 tri_vindex,
                                                 const int numsteps,
                                                 const int numverts,
@@ -115,8 +117,9 @@ ccl_device_inline void motion_triangle_vertices(KernelGlobals kg,
 
   /* Fetch vertex coordinates. */
   float3 next_verts[3];
-  motion_triangle_verts_for_step(kg, tri_vindex, offset, numverts, numsteps, step, verts);
-  motion_triangle_verts_for_step(kg, tri_vindex, offset, numverts, numsteps, step + 1, next_verts);
+  motion_triangle_verts_for_step(kg, prim, tri_vindex, offset, numverts, numsteps, step, verts);
+  motion_triangle_verts_for_step(
+      kg, prim, tri_vindex, offset, numverts, numsteps, step + 1, next_verts);
 
   /* Interpolate between steps. */
   verts[0] = (1.0f - t) * verts[0] + t * next_verts[0];
@@ -134,7 +137,7 @@ ccl_device_inline void motion_triangle_vertices(
   motion_triangle_compute_info(kg, object, time, prim, &tri_vindex, &numsteps, &step, &t);
 
   const int numverts = kernel_data_fetch(objects, object).numverts;
-  motion_triangle_vertices(kg, object, tri_vindex, numsteps, numverts, step, t, verts);
+  motion_triangle_vertices(kg, object, prim, tri_vindex, numsteps, numverts, step, t, verts);
 }
 
 ccl_device_inline void motion_triangle_normals(KernelGlobals kg,
@@ -176,7 +179,7 @@ ccl_device_inline void motion_triangle_vertices_and_normals(KernelGlobals kg,
   motion_triangle_compute_info(kg, object, time, prim, &tri_vindex, &numsteps, &step, &t);
 
   const int numverts = kernel_data_fetch(objects, object).numverts;
-  motion_triangle_vertices(kg, object, tri_vindex, numsteps, numverts, step, t, verts);
+  motion_triangle_vertices(kg, object, prim, tri_vindex, numsteps, numverts, step, t, verts);
   motion_triangle_normals(kg, object, tri_vindex, numsteps, numverts, step, t, normals);
 }
 
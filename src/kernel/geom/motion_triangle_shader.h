@@ -43,7 +43,8 @@ ccl_device_noinline void motion_triangle_shader_setup(KernelGlobals kg, ccl_priv
 
   float3 verts[3];
   const int numverts = kernel_data_fetch(objects, sd->object).numverts;
-  motion_triangle_vertices(kg, sd->object, tri_vindex, numsteps, numverts, step, t, verts);
+  motion_triangle_vertices(
+      kg, sd->object, sd->prim, tri_vindex, numsteps, numverts, step, t, verts);
 
   /* Compute refined position. */
   sd->P = motion_triangle_point_from_uv(kg, sd, sd->u, sd->v, verts);
@@ -57,6 +57,26 @@ ccl_device_inline Transform object_fetch_transform_motion(KernelGlobals kg,
                                                           const int object,
                                                           const float time)
 {
+  /* Piecewise-linear table fast path: for the dominant small-rotation case the
+   * object manager precomputed composed transforms at a refinement where a
+   * plain lerp is within the error bound, avoiding the slerp and the matrix
+   * reconstruction per intersection. */
+  const int num_lerp_steps = kernel_data_fetch(objects, object).num_tfm_lerp_steps;
+  if (num_lerp_steps != 0) {
+    const uint lerp_offset = kernel_data_fetch(objects, object).motion_lerp_offset;
+    const int step = min((int)(time * num_lerp_steps), num_lerp_steps - 1);
+    const float t = time * num_lerp_steps - step;
+
+    const ccl_global Transform *a = &kernel_data_fetch(object_motion_lerp, lerp_offset + step);
+    const ccl_global Transform *b = a + 1;
+
+    Transform tfm;
+    tfm.x = (1.0f - t) * a->x + t * b->x;
+    tfm.y = (1.0f - t) * a->y + t * b->y;
+    tfm.z = (1.0f - t) * a->z + t * b->z;
+    return tfm;
+  }
+
   const uint motion_offset = kernel_data_fetch(objects, object).motion_offset;
   const ccl_global DecomposedTransform *motion = &kernel_data_fetch(object_motion, motion_offset);
   const uint num_steps = kernel_data_fetch(objects, object).num_tfm_steps;
@@ -30,10 +30,9 @@ triangle_interpolate(const float u, const float v, const T f0, const T f1, const
 ccl_device_inline float3 triangle_normal(KernelGlobals kg, ccl_private ShaderData *sd)
 {
   /* load triangle vertices */
-  const uint3 tri_vindex = kernel_data_fetch(tri_vindex, sd->prim);
-  const float3 v0 = kernel_data_fetch(tri_verts, tri_vindex.x);
-  const float3 v1 = kernel_data_fetch(tri_verts, tri_vindex.y);
-  const float3 v2 = kernel_data_fetch(tri_verts, tri_vindex.z);
+  const float3 v0 = kernel_data_fetch(tri_verts, sd->prim * 3 + 0);
+  const float3 v1 = kernel_data_fetch(tri_verts, sd->prim * 3 + 1);
+  const float3 v2 = kernel_data_fetch(tri_verts, sd->prim * 3 + 2);
 
   /* return normal */
   if (object_negative_scale_applied(sd->object_flag)) {
@@ -53,10 +52,9 @@ ccl_device_inline void triangle_point_normal(KernelGlobals kg,
                                              ccl_private int *shader)
 {
   /* load triangle vertices */
-  const uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
-  const float3 v0 = kernel_data_fetch(tri_verts, tri_vindex.x);
-  const float3 v1 = kernel_data_fetch(tri_verts, tri_vindex.y);
-  const float3 v2 = kernel_data_fetch(tri_verts, tri_vindex.z);
+  const float3 v0 = kernel_data_fetch(tri_verts, prim * 3 + 0);
+  const float3 v1 = kernel_data_fetch(tri_verts, prim * 3 + 1);
+  const float3 v2 = kernel_data_fetch(tri_verts, prim * 3 + 2);
 
   /* compute point */
   const float w = 1.0f - u - v;
@@ -78,10 +76,9 @@ ccl_device_inline void triangle_point_normal(KernelGlobals kg,
 
 ccl_device_inline void triangle_vertices(KernelGlobals kg, const int prim, float3 P[3])
 {
-  const uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
-  P[0] = kernel_data_fetch(tri_verts, tri_vindex.x);
-  P[1] = kernel_data_fetch(tri_verts, tri_vindex.y);
-  P[2] = kernel_data_fetch(tri_verts, tri_vindex.z);
+  P[0] = kernel_data_fetch(tri_verts, prim * 3 + 0);
+  P[1] = kernel_data_fetch(tri_verts, prim * 3 + 1);
+  P[2] = kernel_data_fetch(tri_verts, prim * 3 + 2);
 }
 
 /* Triangle vertex locations and vertex normals */
@@ -91,11 +88,11 @@ ccl_device_inline void triangle_vertices_and_normals(KernelGlobals kg,
                                                      float3 P[3],
                                                      float3 N[3])
 {
-  const uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
-  P[0] = kernel_data_fetch(tri_verts, tri_vindex.x);
-  P[1] = kernel_data_fetch(tri_verts, tri_vindex.y);
-  P[2] = kernel_data_fetch(tri_verts, tri_vindex.z);
+  P[0] = kernel_data_fetch(tri_verts, prim * 3 + 0);
+  P[1] = kernel_data_fetch(tri_verts, prim * 3 + 1);
+  P[2] = kernel_data_fetch(tri_verts, prim * 3 + 2);
 
+  const uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
   N[0] = kernel_data_fetch(tri_vnormal, tri_vindex.x);
   N[1] = kernel_data_fetch(tri_vnormal, tri_vindex.y);
   N[2] = kernel_data_fetch(tri_vnormal, tri_vindex.z);
@@ -180,10 +177,9 @@ ccl_device_inline void triangle_dPdudv(KernelGlobals kg,
                                        ccl_private float3 *dPdv)
 {
   /* fetch triangle vertex coordinates */
-  const uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
-  const float3 p0 = kernel_data_fetch(tri_verts, tri_vindex.x);
-  const float3 p1 = kernel_data_fetch(tri_verts, tri_vindex.y);
-  const float3 p2 = kernel_data_fetch(tri_verts, tri_vindex.z);
+  const float3 p0 = kernel_data_fetch(tri_verts, prim * 3 + 0);
+  const float3 p1 = kernel_data_fetch(tri_verts, prim * 3 + 1);
+  const float3 p2 = kernel_data_fetch(tri_verts, prim * 3 + 2);
 
   /* compute derivatives of P w.r.t. uv */
   *dPdu = (p1 - p0);
@@ -32,10 +32,9 @@ ccl_device_inline bool triangle_intersect(KernelGlobals kg,
                                           const int prim,
                                           const int prim_addr)
 {
-  const uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
-  const float3 tri_a = kernel_data_fetch(tri_verts, tri_vindex.x);
-  const float3 tri_b = kernel_data_fetch(tri_verts, tri_vindex.y);
-  const float3 tri_c = kernel_data_fetch(tri_verts, tri_vindex.z);
+  const float3 tri_a = kernel_data_fetch(tri_verts, prim * 3 + 0);
+  const float3 tri_b = kernel_data_fetch(tri_verts, prim * 3 + 1);
+  const float3 tri_c = kernel_data_fetch(tri_verts, prim * 3 + 2);
 
   float t;
   float u;
@@ -79,10 +78,9 @@ ccl_device_inline bool triangle_intersect_local(KernelGlobals kg,
                                                 ccl_private uint *lcg_state,
                                                 const int max_hits)
 {
-  const uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
-  const float3 tri_a = kernel_data_fetch(tri_verts, tri_vindex.x);
-  const float3 tri_b = kernel_data_fetch(tri_verts, tri_vindex.y);
-  const float3 tri_c = kernel_data_fetch(tri_verts, tri_vindex.z);
+  const float3 tri_a = kernel_data_fetch(tri_verts, prim * 3 + 0);
+  const float3 tri_b = kernel_data_fetch(tri_verts, prim * 3 + 1);
+  const float3 tri_c = kernel_data_fetch(tri_verts, prim * 3 + 2);
 
   float t;
   float u;
@@ -126,10 +124,9 @@ ccl_device_inline float3 triangle_point_from_uv(KernelGlobals kg,
                                                 const float u,
                                                 const float v)
 {
-  const uint3 tri_vindex = kernel_data_fetch(tri_vindex, isect_prim);
-  const float3 tri_a = kernel_data_fetch(tri_verts, tri_vindex.x);
-  const float3 tri_b = kernel_data_fetch(tri_verts, tri_vindex.y);
-  const float3 tri_c = kernel_data_fetch(tri_verts, tri_vindex.z);
+  const float3 tri_a = kernel_data_fetch(tri_verts, isect_prim * 3 + 0);
+  const float3 tri_b = kernel_data_fetch(tri_verts, isect_prim * 3 + 1);
+  const float3 tri_c = kernel_data_fetch(tri_verts, isect_prim * 3 + 2);
 
   /* This appears to give slightly better precision than interpolating with w = (1 - u - v). */
   float3 P = tri_a + u * (tri_b - tri_a) + v * (tri_c - tri_a);
@@ -134,7 +134,17 @@ ccl_device bool integrator_init_from_bake(KernelGlobals kg,
     return true;
   }
 
-  prim += kernel_data.bake.tri_offset;
+  int object;
+  if (kernel_data.bake.use_object_pass) {
+    /* Multi-object baking: the pass carries the object index per texel, and the primitive index
+     * is made global with the per-object offset. */
+    object = __float_as_uint(primitive[3]);
+    prim += kernel_data_fetch(object_prim_offset, object);
+  }
+  else {
+    object = kernel_data.bake.object_index;
+    prim += kernel_data.bake.tri_offset;
+  }
 
   /* Random number generator. */
   uint rng_pixel = 0;
@@ -184,7 +194,6 @@ ccl_device bool integrator_init_from_bake(KernelGlobals kg,
   dvdy = -tmpdy - dvdy;
 
   /* Position and normal on triangle. */
-  const int object = kernel_data.bake.object_index;
   float3 P;
   float3 Ng;
   int shader;
@@ -308,7 +317,7 @@ ccl_device bool integrator_init_from_bake(KernelGlobals kg,
 
     /* Setup and write intersection. */
     Intersection isect ccl_optional_struct_init;
-    isect.object = kernel_data.bake.object_index;
+    isect.object = object;
     isect.prim = prim;
     isect.u = u;
     isect.v = v;
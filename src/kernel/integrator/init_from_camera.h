@@ -107,4 +107,142 @@ ccl_device bool integrator_init_from_camera(KernelGlobals kg,
   return true;
 }
 
+#ifndef __KERNEL_GPU__
+
+/* Batched variant of the camera ray setup for the CPU wavefront mode. The per-state setup,
+ * film writes and random number sampling stay scalar, but the camera rays themselves are
+ * generated CAMERA_SAMPLE_BATCH_SIZE at a time through the SoA samplers in
+ * kernel/camera/camera.h for the common perspective and orthographic cameras. Writes the
+ * kernel queued for each state, or 0 for pixels which do not need any more samples. */
+ccl_device void integrator_init_from_camera_batch(KernelGlobals kg,
+                                                  IntegratorStateCPU *const *states,
+                                                  const ccl_global KernelWorkTile *ccl_restrict
+                                                      tiles,
+                                                  ccl_global float *render_buffer,
+                                                  uint32_t *queued_kernels,
+                                                  const int num_states)
+{
+  if (!camera_sample_batch_supported(kg)) {
+    for (int i = 0; i < num_states; i++) {
+      const ccl_global KernelWorkTile *tile = &tiles[i];
+      queued_kernels[i] = integrator_init_from_camera(
+                              kg, states[i], tile, render_buffer, tile->x, tile->y, tile->start_sample) ?
+                              INTEGRATOR_STATE(states[i], path, queued_kernel) :
+                              0;
+    }
+    return;
+  }
+
+  const bool use_dof = (kernel_data.cam.aperturesize > 0.0f);
+  const bool sample_time_lens = (kernel_data.cam.shuttertime != -1.0f || use_dof);
+
+  for (int base = 0; base < num_states; base += CAMERA_SAMPLE_BATCH_SIZE) {
+    const int chunk_size = min(num_states - base, CAMERA_SAMPLE_BATCH_SIZE);
+
+    /* SoA inputs of the batched camera sampler, one lane per path which needs a ray. */
+    float raster_x[CAMERA_SAMPLE_BATCH_SIZE];
+    float raster_y[CAMERA_SAMPLE_BATCH_SIZE];
+    float lens_u[CAMERA_SAMPLE_BATCH_SIZE];
+    float lens_v[CAMERA_SAMPLE_BATCH_SIZE];
+    float times[CAMERA_SAMPLE_BATCH_SIZE];
+    int lane_state[CAMERA_SAMPLE_BATCH_SIZE];
+    int lane_sample[CAMERA_SAMPLE_BATCH_SIZE];
+    uint lane_rng_pixel[CAMERA_SAMPLE_BATCH_SIZE];
+    Ray rays[CAMERA_SAMPLE_BATCH_SIZE];
+
+    int num_lanes = 0;
+
+    for (int j = 0; j < chunk_size; j++) {
+      const int i = base + j;
+      IntegratorState state = states[i];
+      const ccl_global KernelWorkTile *tile = &tiles[i];
+      const int x = tile->x;
+      const int y = tile->y;
+
+      path_state_init(state, tile, x, y);
+
+      /* Check whether the pixel has converged and should not be sampled anymore. */
+      if (!film_need_sample_pixel(kg, state, render_buffer)) {
+        queued_kernels[i] = 0;
+        continue;
+      }
+
+      const int sample = film_write_sample(
+          kg, state, render_buffer, tile->start_sample, tile->sample_offset);
+      const uint rng_pixel = path_rng_pixel_init(kg, sample, x, y);
+
+      /* Filter, time and lens sampling, matching integrate_camera_sample. */
+      const float2 rand_filter = (sample == 0) ? make_float2(0.5f, 0.5f) :
+                                                 path_rng_2D(kg, rng_pixel, sample, PRNG_FILTER);
+      const float3 rand_time_lens = sample_time_lens ?
+                                        path_rng_3D(kg, rng_pixel, sample, PRNG_LENS_TIME) :
+                                        zero_float3();
+
+      const float2 raster = camera_sample_raster(kg, x, y, rand_filter);
+      const float2 lens_uv = use_dof ?
+                                 camera_sample_aperture(
+                                     &kernel_data.cam,
+                                     make_float2(rand_time_lens.y, rand_time_lens.z)) *
+                                     kernel_data.cam.aperturesize :
+                                 zero_float2();
+
+      raster_x[num_lanes] = raster.x;
+      raster_y[num_lanes] = raster.y;
+      lens_u[num_lanes] = lens_uv.x;
+      lens_v[num_lanes] = lens_uv.y;
+      times[num_lanes] = camera_sample_time(kg, y, rand_time_lens.x);
+      lane_state[num_lanes] = i;
+      lane_sample[num_lanes] = sample;
+      lane_rng_pixel[num_lanes] = rng_pixel;
+      num_lanes++;
+    }
+
+    if (num_lanes == 0) {
+      continue;
+    }
+
+    /* Pad the remaining lanes so the SoA sampler reads defined values. */
+    for (int l = num_lanes; l < CAMERA_SAMPLE_BATCH_SIZE; l++) {
+      raster_x[l] = raster_x[0];
+      raster_y[l] = raster_y[0];
+      lens_u[l] = lens_u[0];
+      lens_v[l] = lens_v[0];
+    }
+
+    if (kernel_data.cam.type == CAMERA_PERSPECTIVE) {
+      camera_sample_perspective_batch(kg, raster_x, raster_y, lens_u, lens_v, rays);
+    }
+    else {
+      camera_sample_orthographic_batch(kg, raster_x, raster_y, lens_u, lens_v, rays);
+    }
+
+    for (int l = 0; l < num_lanes; l++) {
+      const int i = lane_state[l];
+      IntegratorState state = states[i];
+
+      Ray *ray = &rays[l];
+      ray->time = times[l];
+
+      if (ray->tmax == 0.0f) {
+        queued_kernels[i] = 0;
+        continue;
+      }
+
+      integrator_state_write_ray(state, ray);
+      path_state_init_integrator(kg, state, lane_sample[l], lane_rng_pixel[l]);
+
+      if (kernel_data.cam.is_inside_volume) {
+        integrator_path_init(kg, state, DEVICE_KERNEL_INTEGRATOR_INTERSECT_VOLUME_STACK);
+      }
+      else {
+        integrator_path_init(kg, state, DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST);
+      }
+
+      queued_kernels[i] = INTEGRATOR_STATE(state, path, queued_kernel);
+    }
+  }
+}
+
+#endif /* !__KERNEL_GPU__ */
+
 }
@@ -90,7 +90,7 @@ ccl_device int shadow_linking_pick_mesh_intersection(KernelGlobals kg,
        * consider them as fully blocked and only consider lights prior to this intersection.  */
       if (shader_flags & SD_HAS_TRANSPARENT_SHADOW) {
         ++transparent_bounce;
-        if (transparent_bounce >= kernel_data.integrator.transparent_max_bounce) {
+        if (transparent_bounce >= kernel_data_transparent_max_bounce) {
           ray->tmax = current_isect.t;
           break;
         }
@@ -56,7 +56,7 @@ ccl_device bool integrate_intersect_shadow_opaque(KernelGlobals kg,
 ccl_device_forceinline int integrate_shadow_max_transparent_hits(KernelGlobals kg,
                                                                  ConstIntegratorShadowState state)
 {
-  const int transparent_max_bounce = kernel_data.integrator.transparent_max_bounce;
+  const int transparent_max_bounce = kernel_data_transparent_max_bounce;
   const int transparent_bounce = INTEGRATOR_STATE(state, shadow_path, transparent_bounce);
 
   return max(transparent_max_bounce - transparent_bounce - 1, 0);
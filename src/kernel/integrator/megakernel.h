@@ -18,93 +18,200 @@
 
 namespace ccl {
 
-ccl_device void integrator_megakernel(KernelGlobals kg,
-                                      IntegratorState state,
-                                      ccl_global float *ccl_restrict render_buffer)
+/* Kernel which the next megakernel step will execute for the given state, or 0 when the path has
+ * finished. Used by the CPU wavefront mode to batch and sort states per kernel before stepping
+ * them. */
+ccl_device_forceinline uint32_t integrator_megakernel_queued_kernel(ConstIntegratorState state)
 {
-  /* Each kernel indicates the next kernel to execute, so here we simply
-   * have to check what that kernel is and execute it. */
-  while (true) {
-    /* Handle any shadow paths before we potentially create more shadow paths. */
-    const uint32_t shadow_queued_kernel = INTEGRATOR_STATE(
-        &state->shadow, shadow_path, queued_kernel);
-    if (shadow_queued_kernel) {
-      switch (shadow_queued_kernel) {
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW:
-          integrator_intersect_shadow(kg, &state->shadow);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW:
-          integrator_shade_shadow(kg, &state->shadow, render_buffer);
-          break;
-        default:
-          kernel_assert(0);
-          break;
+  const uint32_t shadow_queued_kernel = INTEGRATOR_STATE(
+      &state->shadow, shadow_path, queued_kernel);
+  if (shadow_queued_kernel) {
+    return shadow_queued_kernel;
+  }
+
+  const uint32_t ao_queued_kernel = INTEGRATOR_STATE(&state->ao, shadow_path, queued_kernel);
+  if (ao_queued_kernel) {
+    return ao_queued_kernel;
+  }
+
+  return INTEGRATOR_STATE(state, path, queued_kernel);
+}
+
+/* Shadow (or AO) sub-state of the path whose shadow intersection is queued. Follows the same
+ * priority as `integrator_megakernel_step`: regular shadow paths before AO paths. */
+ccl_device_forceinline IntegratorShadowState
+integrator_megakernel_queued_shadow_state(IntegratorState state)
+{
+  if (INTEGRATOR_STATE(&state->shadow, shadow_path, queued_kernel) ==
+      DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW)
+  {
+    return &state->shadow;
+  }
+
+  kernel_assert(INTEGRATOR_STATE(&state->ao, shadow_path, queued_kernel) ==
+                DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW);
+  return &state->ao;
+}
+
+/* Batched variant of the shadow intersection step for the CPU wavefront mode. Consecutive
+ * states queued for DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW are handed over together, so
+ * that their coherent NEE rays can be traced as Embree ray packets. Falls back to stepping
+ * the states one by one when intersections need to be recorded for transparent shadows. */
+ccl_device void integrator_intersect_shadow_batch(KernelGlobals kg,
+                                                  IntegratorStateCPU *const *states,
+                                                  uint32_t *queued_kernels,
+                                                  const int num_states)
+{
+  int index = 0;
+
+#if defined(__EMBREE__) && EMBREE_MAJOR_VERSION >= 4
+  if (kernel_data.device_bvh && !kernel_data.integrator.transparent_shadows) {
+    /* Opaque visibility bits, matching `integrate_intersect_shadow_opaque`. */
+    constexpr const uint opaque_mask = SHADOW_CATCHER_VISIBILITY_SHIFT(PATH_RAY_SHADOW_OPAQUE) |
+                                       PATH_RAY_SHADOW_OPAQUE;
+
+    while (index < num_states) {
+      const int num_packet = min(num_states - index, EMBREE_SHADOW_PACKET_SIZE);
+
+      IntegratorShadowState shadow_states[EMBREE_SHADOW_PACKET_SIZE];
+      Ray rays[EMBREE_SHADOW_PACKET_SIZE];
+      uint visibilities[EMBREE_SHADOW_PACKET_SIZE];
+      bool opaque_hit[EMBREE_SHADOW_PACKET_SIZE];
+
+      for (int i = 0; i < num_packet; ++i) {
+        IntegratorShadowState shadow_state = integrator_megakernel_queued_shadow_state(
+            states[index + i]);
+        shadow_states[i] = shadow_state;
+        integrator_state_read_shadow_ray(shadow_state, &rays[i]);
+        integrator_state_read_shadow_ray_self(kg, shadow_state, &rays[i]);
+        visibilities[i] = integrate_intersect_shadow_visibility(kg, shadow_state) & opaque_mask;
       }
-      continue;
-    }
 
-    /* Handle any AO paths before we potentially create more AO paths. */
-    const uint32_t ao_queued_kernel = INTEGRATOR_STATE(&state->ao, shadow_path, queued_kernel);
-    if (ao_queued_kernel) {
-      switch (ao_queued_kernel) {
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW:
-          integrator_intersect_shadow(kg, &state->ao);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW:
-          integrator_shade_shadow(kg, &state->ao, render_buffer);
-          break;
-        default:
-          kernel_assert(0);
-          break;
+      kernel_embree_intersect_shadow_packet(kg, rays, visibilities, num_packet, opaque_hit);
+
+      for (int i = 0; i < num_packet; ++i) {
+        IntegratorShadowState shadow_state = shadow_states[i];
+        if (opaque_hit[i]) {
+          /* Hit an opaque surface, shadow path ends here. */
+          integrator_shadow_path_terminate(
+              kg, shadow_state, DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW);
+        }
+        else {
+          INTEGRATOR_STATE_WRITE(shadow_state, shadow_path, num_hits) = 0;
+          integrator_shadow_path_next(kg,
+                                      shadow_state,
+                                      DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW,
+                                      DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW);
+        }
+        queued_kernels[index + i] = integrator_megakernel_queued_kernel(states[index + i]);
       }
-      continue;
+
+      index += num_packet;
     }
+    return;
+  }
+#endif
 
-    /* Then handle regular path kernels. */
-    const uint32_t queued_kernel = INTEGRATOR_STATE(state, path, queued_kernel);
-    if (queued_kernel) {
-      switch (queued_kernel) {
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST:
-          integrator_intersect_closest(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND:
-          integrator_shade_background(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE:
-          integrator_shade_surface(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME:
-          integrator_shade_volume(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE:
-          integrator_shade_surface_raytrace(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_MNEE:
-          integrator_shade_surface_mnee(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT:
-          integrator_shade_light(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_DEDICATED_LIGHT:
-          integrator_shade_dedicated_light(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SUBSURFACE:
-          integrator_intersect_subsurface(kg, state);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_VOLUME_STACK:
-          integrator_intersect_volume_stack(kg, state);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_DEDICATED_LIGHT:
-          integrator_intersect_dedicated_light(kg, state);
-          break;
-        default:
-          kernel_assert(0);
-          break;
-      }
-      continue;
+  for (; index < num_states; ++index) {
+    integrator_intersect_shadow(kg, integrator_megakernel_queued_shadow_state(states[index]));
+    queued_kernels[index] = integrator_megakernel_queued_kernel(states[index]);
+  }
+}
+
+/* Execute the next queued kernel of the path, if any. Returns false once the path has finished. */
+ccl_device_forceinline bool integrator_megakernel_step(KernelGlobals kg,
+                                                       IntegratorState state,
+                                                       ccl_global float *ccl_restrict render_buffer)
+{
+  /* Handle any shadow paths before we potentially create more shadow paths. */
+  const uint32_t shadow_queued_kernel = INTEGRATOR_STATE(
+      &state->shadow, shadow_path, queued_kernel);
+  if (shadow_queued_kernel) {
+    switch (shadow_queued_kernel) {
+      case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW:
+        integrator_intersect_shadow(kg, &state->shadow);
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW:
+        integrator_shade_shadow(kg, &state->shadow, render_buffer);
+        break;
+      default:
+        kernel_assert(0);
+        break;
+    }
+    return true;
+  }
+
+  /* Handle any AO paths before we potentially create more AO paths. */
+  const uint32_t ao_queued_kernel = INTEGRATOR_STATE(&state->ao, shadow_path, queued_kernel);
+  if (ao_queued_kernel) {
+    switch (ao_queued_kernel) {
+      case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW:
+        integrator_intersect_shadow(kg, &state->ao);
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW:
+        integrator_shade_shadow(kg, &state->ao, render_buffer);
+        break;
+      default:
+        kernel_assert(0);
+        break;
+    }
+    return true;
+  }
+
+  /* Then handle regular path kernels. */
+  const uint32_t queued_kernel = INTEGRATOR_STATE(state, path, queued_kernel);
+  if (queued_kernel) {
+    switch (queued_kernel) {
+      case DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST:
+        integrator_intersect_closest(kg, state, render_buffer);
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND:
+        integrator_shade_background(kg, state, render_buffer);
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE:
+        integrator_shade_surface(kg, state, render_buffer);
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME:
+        integrator_shade_volume(kg, state, render_buffer);
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE:
+        integrator_shade_surface_raytrace(kg, state, render_buffer);
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_MNEE:
+        integrator_shade_surface_mnee(kg, state, render_buffer);
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT:
+        integrator_shade_light(kg, state, render_buffer);
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_SHADE_DEDICATED_LIGHT:
+        integrator_shade_dedicated_light(kg, state, render_buffer);
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SUBSURFACE:
+        integrator_intersect_subsurface(kg, state);
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_INTERSECT_VOLUME_STACK:
+        integrator_intersect_volume_stack(kg, state);
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_INTERSECT_DEDICATED_LIGHT:
+        integrator_intersect_dedicated_light(kg, state);
+        break;
+      default:
+        kernel_assert(0);
+        break;
     }
+    return true;
+  }
 
-    break;
+  return false;
+}
+
+ccl_device void integrator_megakernel(KernelGlobals kg,
+                                      IntegratorState state,
+                                      ccl_global float *ccl_restrict render_buffer)
+{
+  /* Each kernel indicates the next kernel to execute, so here we simply
+   * have to check what that kernel is and execute it. */
+  while (integrator_megakernel_step(kg, state, render_buffer)) {
   }
 }
 
@@ -43,6 +43,8 @@
 
 // NOLINTBEGIN
 #define MNEE_MAX_ITERATIONS 64
+#define MNEE_SOLVER_STALL_ITERATIONS 4
+#define MNEE_SOLVER_STALL_RATE 0.99f
 #define MNEE_MAX_INTERSECTION_COUNT 10
 #define MNEE_SOLVER_THRESHOLD 0.001f
 #define MNEE_MINIMUM_STEP_SIZE 0.0001f
@@ -436,6 +438,8 @@ ccl_device_forceinline bool mnee_newton_solver(KernelGlobals kg,
   float beta = .1f;
   bool reduce_stepsize = false;
   bool resolve_constraint = true;
+  float prev_constraint_norm = FLT_MAX;
+  int stalled_iterations = 0;
   for (int iteration = 0; iteration < MNEE_MAX_ITERATIONS; iteration++) {
     if (resolve_constraint) {
       /* Calculate constraint and its derivatives for vertices. */
@@ -456,6 +460,19 @@ ccl_device_forceinline bool mnee_newton_solver(KernelGlobals kg,
         return true;
       }
 
+      /* Fail early when the walk has stopped converging, instead of spending
+       * the full iteration budget on a configuration that will fail anyway.
+       * Step size reductions are not counted here, only actual solves. */
+      if (constraint_norm > MNEE_SOLVER_STALL_RATE * prev_constraint_norm) {
+        if (++stalled_iterations >= MNEE_SOLVER_STALL_ITERATIONS) {
+          return false;
+        }
+      }
+      else {
+        stalled_iterations = 0;
+      }
+      prev_constraint_norm = constraint_norm;
+
       /* Invert derivative matrix. */
       if (!mnee_solve_matrix_h_to_x(vertex_count, vertices, dx)) {
         return false;
@@ -953,6 +970,8 @@ ccl_device_forceinline int kernel_path_mnee_sample(KernelGlobals kg,
                                                    ccl_private LightSample *ls,
                                                    ccl_private BsdfEval *throughput)
 {
+  PROFILING_INIT(kg, PROFILING_SHADE_SURFACE_MNEE);
+
   /*
    * 1. send seed ray from shading point to light sample position (or along sampled light
    * direction), making sure it intersects a caustic caster at least once, ignoring all other
@@ -1083,7 +1102,7 @@ ccl_device_forceinline int kernel_path_mnee_sample(KernelGlobals kg,
   }
 
   /* Check whether the overall depth limit is reached before continuing. */
-  if ((INTEGRATOR_STATE(state, path, bounce) + vertex_count) >= kernel_data.integrator.max_bounce)
+  if ((INTEGRATOR_STATE(state, path, bounce) + vertex_count) >= kernel_data_max_bounce)
   {
     return 0;
   }
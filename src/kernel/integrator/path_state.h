@@ -114,7 +114,7 @@ ccl_device_inline void path_state_next(KernelGlobals kg,
     const uint32_t transparent_bounce = INTEGRATOR_STATE(state, path, transparent_bounce) + 1;
 
     flag |= PATH_RAY_TRANSPARENT;
-    if (transparent_bounce >= kernel_data.integrator.transparent_max_bounce) {
+    if (transparent_bounce >= kernel_data_transparent_max_bounce) {
       flag |= PATH_RAY_TERMINATE_ON_NEXT_SURFACE;
     }
 
@@ -130,7 +130,7 @@ ccl_device_inline void path_state_next(KernelGlobals kg,
   }
 
   const uint32_t bounce = INTEGRATOR_STATE(state, path, bounce) + 1;
-  if (bounce >= kernel_data.integrator.max_bounce) {
+  if (bounce >= kernel_data_max_bounce) {
     flag |= PATH_RAY_TERMINATE_AFTER_TRANSPARENT;
   }
 
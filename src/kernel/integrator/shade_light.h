@@ -79,7 +79,7 @@ ccl_device void integrator_shade_light(KernelGlobals kg,
   const uint32_t transparent_bounce = INTEGRATOR_STATE(state, path, transparent_bounce) + 1;
   INTEGRATOR_STATE_WRITE(state, path, transparent_bounce) = transparent_bounce;
 
-  if (transparent_bounce >= kernel_data.integrator.transparent_max_bounce) {
+  if (transparent_bounce >= kernel_data_transparent_max_bounce) {
     integrator_path_terminate(kg, state, DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT);
     return;
   }
@@ -412,8 +412,8 @@ ccl_device
   uint32_t shadow_flag = INTEGRATOR_STATE(state, path, flag);
 
   if (kernel_data.kernel_features & KERNEL_FEATURE_LIGHT_PASSES) {
-    PackedSpectrum pass_diffuse_weight;
-    PackedSpectrum pass_glossy_weight;
+    PackedSpectrumWeight pass_diffuse_weight;
+    PackedSpectrumWeight pass_glossy_weight;
 
     if (shadow_flag & PATH_RAY_ANY_PASS) {
       /* Indirect bounce, use weights from earlier surface or volume bounce. */
@@ -423,8 +423,8 @@ ccl_device
     else {
       /* Direct light, use BSDFs at this bounce. */
       shadow_flag |= PATH_RAY_SURFACE_PASS;
-      pass_diffuse_weight = PackedSpectrum(bsdf_eval_pass_diffuse_weight(&bsdf_eval));
-      pass_glossy_weight = PackedSpectrum(bsdf_eval_pass_glossy_weight(&bsdf_eval));
+      pass_diffuse_weight = spectrum_weight_pack(bsdf_eval_pass_diffuse_weight(&bsdf_eval));
+      pass_glossy_weight = spectrum_weight_pack(bsdf_eval_pass_glossy_weight(&bsdf_eval));
     }
 
     INTEGRATOR_STATE_WRITE(shadow_state, shadow_path, pass_diffuse_weight) = pass_diffuse_weight;
@@ -535,10 +535,10 @@ ccl_device_forceinline int integrate_surface_bsdf_bssrdf_bounce(
 
   if (kernel_data.kernel_features & KERNEL_FEATURE_LIGHT_PASSES) {
     if (INTEGRATOR_STATE(state, path, bounce) == 0) {
-      INTEGRATOR_STATE_WRITE(state, path, pass_diffuse_weight) = bsdf_eval_pass_diffuse_weight(
-          &bsdf_eval);
-      INTEGRATOR_STATE_WRITE(state, path, pass_glossy_weight) = bsdf_eval_pass_glossy_weight(
-          &bsdf_eval);
+      INTEGRATOR_STATE_WRITE(state, path, pass_diffuse_weight) = spectrum_weight_pack(
+          bsdf_eval_pass_diffuse_weight(&bsdf_eval));
+      INTEGRATOR_STATE_WRITE(state, path, pass_glossy_weight) = spectrum_weight_pack(
+          bsdf_eval_pass_glossy_weight(&bsdf_eval));
     }
   }
 
@@ -586,6 +586,29 @@ ccl_device_forceinline int integrate_surface_volume_only_bounce(IntegratorState
 }
 #endif
 
+/* Fast path for shaders that are a single transparent closure with a constant
+ * color: continue the ray with the precomputed tint from the shader table,
+ * skipping SVM/OSL evaluation, light sampling and closure sampling. */
+ccl_device_forceinline int integrate_surface_transparent_only_bounce(KernelGlobals kg,
+                                                                     IntegratorState state,
+                                                                     const ccl_private ShaderData
+                                                                         *sd)
+{
+  /* Apply the constant tint. */
+  const int shader_index = sd->shader & SHADER_MASK;
+  const float3 tint = make_float3(kernel_data_fetch(shaders, shader_index).constant_emission[0],
+                                  kernel_data_fetch(shaders, shader_index).constant_emission[1],
+                                  kernel_data_fetch(shaders, shader_index).constant_emission[2]);
+  INTEGRATOR_STATE_WRITE(state, path, throughput) *= rgb_to_spectrum(tint);
+
+  /* Only need to modify start distance for transparent. */
+  INTEGRATOR_STATE_WRITE(state, ray, tmin) = intersection_t_offset(sd->ray_length);
+
+  path_state_next(kg, state, LABEL_TRANSMIT | LABEL_TRANSPARENT, sd->flag);
+
+  return LABEL_TRANSMIT | LABEL_TRANSPARENT;
+}
+
 ccl_device_forceinline bool integrate_surface_terminate(IntegratorState state,
                                                         const uint32_t path_flag)
 {
@@ -707,6 +730,23 @@ ccl_device int integrate_surface(KernelGlobals kg,
 
   const uint32_t path_flag = INTEGRATOR_STATE(state, path, flag);
 
+  /* Skip shader evaluation and light sampling entirely for pure transparent
+   * shaders, the most common shader invocation in scenes with cutout cards.
+   * Render passes, denoising features and path guiding all need evaluated
+   * closures, so those cases keep the regular path. */
+  if ((sd.flag & SD_HAS_ONLY_TRANSPARENT) && !(path_flag & PATH_RAY_SUBSURFACE)) {
+    const bool need_full_eval = ((path_flag & PATH_RAY_CAMERA) &&
+                                 (kernel_data.film.pass_flag & PASS_ANY)) ||
+                                (path_flag & PATH_RAY_DENOISING_FEATURES) ||
+                                kernel_data.integrator.use_guiding;
+    if (!need_full_eval) {
+      if (integrate_surface_terminate(state, path_flag)) {
+        return LABEL_NONE;
+      }
+      return integrate_surface_transparent_only_bounce(kg, state, &sd);
+    }
+  }
+
   /* Skip most work for volume bounding surface. */
 #ifdef __VOLUME__
   if (!(sd.flag & SD_HAS_ONLY_VOLUME)) {
@@ -159,7 +159,7 @@ ccl_device_forceinline void volume_step_init(KernelGlobals kg,
   }
   else {
     /* Heterogeneous volume. */
-    vstep->max_steps = kernel_data.integrator.volume_max_steps;
+    vstep->max_steps = kernel_data_volume_max_steps;
     const float t = tmax - tmin;
     float step_size = min(object_step_size, t);
 
@@ -822,8 +822,8 @@ ccl_device_forceinline void integrate_volume_direct_light(
   const Spectrum throughput_phase = throughput * bsdf_eval_sum(&phase_eval);
 
   if (kernel_data.kernel_features & KERNEL_FEATURE_LIGHT_PASSES) {
-    PackedSpectrum pass_diffuse_weight;
-    PackedSpectrum pass_glossy_weight;
+    PackedSpectrumWeight pass_diffuse_weight;
+    PackedSpectrumWeight pass_glossy_weight;
 
     if (shadow_flag & PATH_RAY_ANY_PASS) {
       /* Indirect bounce, use weights from earlier surface or volume bounce. */
@@ -833,8 +833,8 @@ ccl_device_forceinline void integrate_volume_direct_light(
     else {
       /* Direct light, no diffuse/glossy distinction needed for volumes. */
       shadow_flag |= PATH_RAY_VOLUME_PASS;
-      pass_diffuse_weight = one_spectrum();
-      pass_glossy_weight = zero_spectrum();
+      pass_diffuse_weight = spectrum_weight_pack(one_spectrum());
+      pass_glossy_weight = spectrum_weight_pack(zero_spectrum());
     }
 
     INTEGRATOR_STATE_WRITE(shadow_state, shadow_path, pass_diffuse_weight) = pass_diffuse_weight;
@@ -958,8 +958,10 @@ ccl_device_forceinline bool integrate_volume_phase_scatter(
 
   if (kernel_data.kernel_features & KERNEL_FEATURE_LIGHT_PASSES) {
     if (INTEGRATOR_STATE(state, path, bounce) == 0) {
-      INTEGRATOR_STATE_WRITE(state, path, pass_diffuse_weight) = one_spectrum();
-      INTEGRATOR_STATE_WRITE(state, path, pass_glossy_weight) = zero_spectrum();
+      INTEGRATOR_STATE_WRITE(state, path, pass_diffuse_weight) = spectrum_weight_pack(
+          one_spectrum());
+      INTEGRATOR_STATE_WRITE(state, path, pass_glossy_weight) = spectrum_weight_pack(
+          zero_spectrum());
     }
   }
 
@@ -211,6 +211,19 @@ struct IntegratorStateGPU {
 
   /* Divisor used to partition active indices by locality when sorting by material. */
   uint sort_partition_divisor;
+
+  /* Per-kernel ring buffers with the indices of queued paths, appended to by the scheduling
+   * functions so that the host can launch kernels over a dense index list without scanning
+   * all path states. Null for kernels which are dispatched through shader sorting or which
+   * may requeue paths for themselves from within their own launch. */
+  ccl_global int *queued_path_list[DEVICE_KERNEL_INTEGRATOR_NUM];
+
+  /* Monotonic append cursors of the ring buffers, one per kernel. */
+  ccl_global uint *queued_path_list_cursor;
+
+  /* Ring buffer capacity minus one. The capacity is a power of two, so that cursor values
+   * keep mapping to consecutive ring slots when the cursor wraps around. */
+  uint queued_path_list_mask;
 };
 
 /* Abstraction
@@ -46,12 +46,30 @@ ccl_device_forceinline bool integrator_shadow_path_is_terminated(ConstIntegrator
 
 #ifdef __KERNEL_GPU__
 
+/* Append the path to the ring buffer of indices queued for the given kernel, so that the host
+ * can dispatch the kernel over a dense index list instead of scanning all path states. The host
+ * tracks how many entries it has consumed; entries are never removed on the device. Kernels
+ * without a ring buffer (null list) keep relying on the index scan on the host. */
+ccl_device_forceinline void integrator_path_queue_push(KernelGlobals kg,
+                                                       const int state,
+                                                       const DeviceKernel next_kernel)
+{
+  ccl_global int *list = kernel_integrator_state.queued_path_list[next_kernel];
+  if (list == nullptr) {
+    return;
+  }
+  const uint slot = atomic_fetch_and_add_uint32(
+      &kernel_integrator_state.queued_path_list_cursor[next_kernel], 1);
+  list[slot & kernel_integrator_state.queued_path_list_mask] = state;
+}
+
 ccl_device_forceinline void integrator_path_init(KernelGlobals kg,
                                                  IntegratorState state,
                                                  const DeviceKernel next_kernel)
 {
   atomic_fetch_and_add_uint32(&kernel_integrator_state.queue_counter->num_queued[next_kernel], 1);
   INTEGRATOR_STATE_WRITE(state, path, queued_kernel) = next_kernel;
+  integrator_path_queue_push(kg, state, next_kernel);
 }
 
 ccl_device_forceinline void integrator_path_next(KernelGlobals kg,
@@ -63,6 +81,7 @@ ccl_device_forceinline void integrator_path_next(KernelGlobals kg,
                               1);
   atomic_fetch_and_add_uint32(&kernel_integrator_state.queue_counter->num_queued[next_kernel], 1);
   INTEGRATOR_STATE_WRITE(state, path, queued_kernel) = next_kernel;
+  integrator_path_queue_push(kg, state, next_kernel);
 }
 
 ccl_device_forceinline void integrator_path_terminate(KernelGlobals kg,
@@ -81,6 +100,7 @@ ccl_device_forceinline IntegratorShadowState integrator_shadow_path_init(
       &kernel_integrator_state.next_shadow_path_index[0], 1);
   atomic_fetch_and_add_uint32(&kernel_integrator_state.queue_counter->num_queued[next_kernel], 1);
   INTEGRATOR_STATE_WRITE(shadow_state, shadow_path, queued_kernel) = next_kernel;
+  integrator_path_queue_push(kg, shadow_state, next_kernel);
 #  ifdef __PATH_GUIDING__
   INTEGRATOR_STATE_WRITE(shadow_state, shadow_path, path_segment) = nullptr;
 #  endif
@@ -96,6 +116,7 @@ ccl_device_forceinline void integrator_shadow_path_next(KernelGlobals kg,
                               1);
   atomic_fetch_and_add_uint32(&kernel_integrator_state.queue_counter->num_queued[next_kernel], 1);
   INTEGRATOR_STATE_WRITE(state, shadow_path, queued_kernel) = next_kernel;
+  integrator_path_queue_push(kg, state, next_kernel);
 }
 
 ccl_device_forceinline void integrator_shadow_path_terminate(KernelGlobals kg,
@@ -107,19 +128,23 @@ ccl_device_forceinline void integrator_shadow_path_terminate(KernelGlobals kg,
   INTEGRATOR_STATE_WRITE(state, shadow_path, queued_kernel) = 0;
 }
 
-/* Sort first by truncated state index (for good locality), then by key (for good coherence). */
-#  define INTEGRATOR_SORT_KEY(key, state) \
-    (key + kernel_data.max_shaders * (state / kernel_integrator_state.sort_partition_divisor))
+/* Sort first by truncated state index (for good locality), then by the shader sort key (for good
+ * coherence). The shader manager assigns sort keys in complexity order, so that shading threads
+ * of a warp not only run the same shader but shaders of neighboring keys are of similar cost. */
+#  define INTEGRATOR_SORT_KEY(shader, state) \
+    (kernel_data_fetch(shaders, shader).sort_key + \
+     kernel_data.max_shaders * (state / kernel_integrator_state.sort_partition_divisor))
 
 ccl_device_forceinline void integrator_path_init_sorted(KernelGlobals kg,
                                                         IntegratorState state,
                                                         const DeviceKernel next_kernel,
-                                                        const uint32_t key)
+                                                        const uint32_t shader)
 {
-  const int key_ = INTEGRATOR_SORT_KEY(key, state);
+  const int key_ = INTEGRATOR_SORT_KEY(shader, state);
   atomic_fetch_and_add_uint32(&kernel_integrator_state.queue_counter->num_queued[next_kernel], 1);
   INTEGRATOR_STATE_WRITE(state, path, queued_kernel) = next_kernel;
   INTEGRATOR_STATE_WRITE(state, path, shader_sort_key) = key_;
+  integrator_path_queue_push(kg, state, next_kernel);
 
 #  if defined(__KERNEL_LOCAL_ATOMIC_SORT__)
   if (!kernel_integrator_state.sort_key_counter[next_kernel]) {
@@ -134,14 +159,15 @@ ccl_device_forceinline void integrator_path_next_sorted(KernelGlobals kg,
                                                         IntegratorState state,
                                                         const DeviceKernel current_kernel,
                                                         const DeviceKernel next_kernel,
-                                                        const uint32_t key)
+                                                        const uint32_t shader)
 {
-  const int key_ = INTEGRATOR_SORT_KEY(key, state);
+  const int key_ = INTEGRATOR_SORT_KEY(shader, state);
   atomic_fetch_and_sub_uint32(&kernel_integrator_state.queue_counter->num_queued[current_kernel],
                               1);
   atomic_fetch_and_add_uint32(&kernel_integrator_state.queue_counter->num_queued[next_kernel], 1);
   INTEGRATOR_STATE_WRITE(state, path, queued_kernel) = next_kernel;
   INTEGRATOR_STATE_WRITE(state, path, shader_sort_key) = key_;
+  integrator_path_queue_push(kg, state, next_kernel);
 
 #  if defined(__KERNEL_LOCAL_ATOMIC_SORT__)
   if (!kernel_integrator_state.sort_key_counter[next_kernel]) {
@@ -164,10 +190,11 @@ ccl_device_forceinline void integrator_path_init(KernelGlobals kg,
 ccl_device_forceinline void integrator_path_init_sorted(KernelGlobals kg,
                                                         IntegratorState state,
                                                         const DeviceKernel next_kernel,
-                                                        const uint32_t key)
+                                                        const uint32_t shader)
 {
   INTEGRATOR_STATE_WRITE(state, path, queued_kernel) = next_kernel;
-  (void)key;
+  INTEGRATOR_STATE_WRITE(state, path, shader_sort_key) = kernel_data_fetch(shaders, shader)
+                                                             .sort_key;
 }
 
 ccl_device_forceinline void integrator_path_next(KernelGlobals kg,
@@ -191,10 +218,11 @@ ccl_device_forceinline void integrator_path_next_sorted(KernelGlobals kg,
                                                         IntegratorState state,
                                                         const DeviceKernel current_kernel,
                                                         const DeviceKernel next_kernel,
-                                                        const uint32_t key)
+                                                        const uint32_t shader)
 {
   INTEGRATOR_STATE_WRITE(state, path, queued_kernel) = next_kernel;
-  (void)key;
+  INTEGRATOR_STATE_WRITE(state, path, shader_sort_key) = kernel_data_fetch(shaders, shader)
+                                                             .sort_key;
   (void)current_kernel;
 }
 
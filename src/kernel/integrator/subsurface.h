@@ -128,8 +128,10 @@ ccl_device int subsurface_bounce(KernelGlobals kg,
 
   if (kernel_data.kernel_features & KERNEL_FEATURE_LIGHT_PASSES) {
     if (INTEGRATOR_STATE(state, path, bounce) == 0) {
-      INTEGRATOR_STATE_WRITE(state, path, pass_diffuse_weight) = one_spectrum();
-      INTEGRATOR_STATE_WRITE(state, path, pass_glossy_weight) = zero_spectrum();
+      INTEGRATOR_STATE_WRITE(state, path, pass_diffuse_weight) = spectrum_weight_pack(
+          one_spectrum());
+      INTEGRATOR_STATE_WRITE(state, path, pass_glossy_weight) = spectrum_weight_pack(
+          zero_spectrum());
     }
   }
 
@@ -138,6 +140,9 @@ ccl_device int subsurface_bounce(KernelGlobals kg,
   INTEGRATOR_STATE_WRITE(state, subsurface, radius) = bssrdf->radius;
   INTEGRATOR_STATE_WRITE(state, subsurface, anisotropy) = bssrdf->anisotropy;
 
+  /* Start a fresh random walk, any deferred walk state is stale. */
+  INTEGRATOR_STATE_WRITE(state, subsurface, bounce) = 0;
+
   /* Path guiding. */
   guiding_record_bssrdf_weight(kg, state, weight, bssrdf->albedo);
 
@@ -180,9 +185,22 @@ ccl_device_inline bool subsurface_scatter(KernelGlobals kg, IntegratorState stat
   LocalIntersection ss_isect ccl_optional_struct_init;
 
   if (INTEGRATOR_STATE(state, path, flag) & PATH_RAY_SUBSURFACE_RANDOM_WALK) {
-    if (!subsurface_random_walk(kg, state, rng_state, ray, ss_isect)) {
+    const int result = subsurface_random_walk(kg, state, rng_state, ray, ss_isect);
+    if (result == SUBSURFACE_RANDOM_WALK_MISSED) {
       return false;
     }
+#  ifdef __KERNEL_GPU__
+    if (result == SUBSURFACE_RANDOM_WALK_DEFERRED) {
+      /* Walk ran out of its per-dispatch bounce budget, requeue this kernel to
+       * continue it. The wavefront is compacted in between, so warps are not
+       * left mostly idle by a few long walks. */
+      integrator_path_next(kg,
+                           state,
+                           DEVICE_KERNEL_INTEGRATOR_INTERSECT_SUBSURFACE,
+                           DEVICE_KERNEL_INTEGRATOR_INTERSECT_SUBSURFACE);
+      return true;
+    }
+#  endif
   }
   else {
     if (!subsurface_disk(kg, state, rng_state, ray, ss_isect)) {
@@ -173,11 +173,33 @@ ccl_device_forceinline Spectrum subsurface_random_walk_pdf(Spectrum sigma_t,
  * and the value represents the cutoff level */
 #  define SUBSURFACE_RANDOM_WALK_SIMILARITY_LEVEL 9
 
-ccl_device_inline bool subsurface_random_walk(KernelGlobals kg,
-                                              IntegratorState state,
-                                              RNGState rng_state,
-                                              ccl_private Ray &ray,
-                                              ccl_private LocalIntersection &ss_isect)
+/* On the GPU, walks terminate at very different depths within one dispatch,
+ * leaving threads with short walks idle while the longest walk in the warp
+ * finishes. Bound the number of bounces per dispatch instead and requeue
+ * walks that need more, so the wavefront is compacted in between and warps
+ * stay dense. On the CPU there is no divergence and the whole walk runs in
+ * one call. */
+#  ifdef __KERNEL_GPU__
+#    define BSSRDF_MAX_BOUNCES_PER_DISPATCH 16
+#  else
+#    define BSSRDF_MAX_BOUNCES_PER_DISPATCH BSSRDF_MAX_BOUNCES
+#  endif
+
+enum SubsurfaceRandomWalkResult {
+  /* Walk left the object or terminated, path ends. */
+  SUBSURFACE_RANDOM_WALK_MISSED = 0,
+  /* Walk found an exit point, stored in the intersection result. */
+  SUBSURFACE_RANDOM_WALK_HIT = 1,
+  /* Walk exceeded the dispatch bounce budget and was deferred, requeue the
+   * kernel to continue it. */
+  SUBSURFACE_RANDOM_WALK_DEFERRED = 2,
+};
+
+ccl_device_inline int subsurface_random_walk(KernelGlobals kg,
+                                             IntegratorState state,
+                                             RNGState rng_state,
+                                             ccl_private Ray &ray,
+                                             ccl_private LocalIntersection &ss_isect)
 {
   const float3 P = INTEGRATOR_STATE(state, ray, P);
   const float3 D = INTEGRATOR_STATE(state, ray, D);
@@ -226,7 +248,7 @@ ccl_device_inline bool subsurface_random_walk(KernelGlobals kg,
     /* With specific values of alpha the length might become 1, which in asymptotic makes phase to
      * be infinite. After first bounce it will cause throughput to be 0. Do early output, avoiding
      * numerical issues and extra unneeded work. */
-    return false;
+    return SUBSURFACE_RANDOM_WALK_MISSED;
   }
 
   /* Precompute term for phase sampling. */
@@ -253,7 +275,24 @@ ccl_device_inline bool subsurface_random_walk(KernelGlobals kg,
   const float guided_fraction_org = guided_fraction;
 #  endif
 
-  for (int bounce = 0; bounce < BSSRDF_MAX_BOUNCES; bounce++) {
+  int start_bounce = 0;
+#  ifdef __KERNEL_GPU__
+  start_bounce = INTEGRATOR_STATE(state, subsurface, bounce);
+  if (start_bounce > 0) {
+    /* Resume a walk that a previous dispatch deferred. The current direction
+     * was stored in the ray state, so `ray.D` is set up already, while the
+     * entry point in the ray state is untouched and `P` still refers to it. */
+    ray.P = INTEGRATOR_STATE(state, subsurface, P);
+    throughput = INTEGRATOR_STATE(state, subsurface, throughput);
+    const float stored_opposite_distance = INTEGRATOR_STATE(state, subsurface, opposite_distance);
+    have_opposite_interface = (stored_opposite_distance >= 0.0f);
+    opposite_distance = have_opposite_interface ? stored_opposite_distance : 0.0f;
+    rng_state.rng_offset += start_bounce * PRNG_BOUNCE_NUM;
+  }
+#  endif
+  const int end_bounce = min(start_bounce + BSSRDF_MAX_BOUNCES_PER_DISPATCH, BSSRDF_MAX_BOUNCES);
+
+  for (int bounce = start_bounce; bounce < end_bounce; bounce++) {
     /* Advance random number offset. */
     rng_state.rng_offset += PRNG_BOUNCE_NUM;
 
@@ -452,9 +491,26 @@ ccl_device_inline bool subsurface_random_walk(KernelGlobals kg,
         albedo);
 
     INTEGRATOR_STATE_WRITE(state, path, throughput) = throughput;
+
+    return SUBSURFACE_RANDOM_WALK_HIT;
+  }
+
+#  ifdef __KERNEL_GPU__
+  if (end_bounce < BSSRDF_MAX_BOUNCES && reduce_max(throughput) >= VOLUME_THROUGHPUT_EPSILON) {
+    /* Out of bounce budget for this dispatch but the walk is still alive,
+     * defer the remainder to the next dispatch. */
+    INTEGRATOR_STATE_WRITE(state, subsurface, bounce) = end_bounce;
+    INTEGRATOR_STATE_WRITE(state, subsurface, P) = ray.P;
+    INTEGRATOR_STATE_WRITE(state, subsurface, throughput) = throughput;
+    INTEGRATOR_STATE_WRITE(state, subsurface, opposite_distance) = have_opposite_interface ?
+                                                                       opposite_distance :
+                                                                       -1.0f;
+    INTEGRATOR_STATE_WRITE(state, ray, D) = ray.D;
+    return SUBSURFACE_RANDOM_WALK_DEFERRED;
   }
+#  endif
 
-  return hit;
+  return SUBSURFACE_RANDOM_WALK_MISSED;
 }
 
 #endif /* __SUBSURFACE__ */
@@ -425,6 +425,39 @@ ccl_device_inline void volume_shader_motion_blur(KernelGlobals kg,
 
 /* Volume Evaluation */
 
+/* Check the coarse occupancy grid of the object for whether the shading point
+ * lies in a region without any active voxels. There the volume has zero
+ * density by the same assumption that bounds the volume mesh to the active
+ * grid topology, so shader evaluation can be skipped entirely. */
+ccl_device_inline bool volume_shader_in_empty_space(KernelGlobals kg,
+                                                    const ccl_private ShaderData *sd)
+{
+  const KernelVolumeOccupancy occ = kernel_data_fetch(volume_occupancy, sd->object);
+  if (occ.bits_offset < 0) {
+    /* No grid, assume occupied. */
+    return false;
+  }
+
+  float3 P = sd->P;
+  if (!(sd->object_flag & SD_OBJECT_TRANSFORM_APPLIED)) {
+    const Transform itfm = object_get_inverse_transform(kg, sd);
+    P = transform_point(&itfm, P);
+  }
+  P = transform_point(&occ.tfm, P);
+
+  const int x = float_to_int(floorf(P.x));
+  const int y = float_to_int(floorf(P.y));
+  const int z = float_to_int(floorf(P.z));
+  if (x < 0 || y < 0 || z < 0 || x >= occ.res_x || y >= occ.res_y || z >= occ.res_z) {
+    /* Outside the padded bounds of the active voxels. */
+    return true;
+  }
+
+  const uint cell = ((uint)z * occ.res_y + y) * occ.res_x + x;
+  const uint word = kernel_data_fetch(volume_occupancy_bits, occ.bits_offset + (cell >> 5));
+  return (word & (1u << (cell & 31u))) == 0;
+}
+
 template<const bool shadow, const uint node_feature_mask, typename ConstIntegratorGenericState>
 ccl_device_inline bool volume_shader_eval_entry(KernelGlobals kg,
                                                 ConstIntegratorGenericState state,
@@ -465,6 +498,11 @@ ccl_device_inline bool volume_shader_eval_entry(KernelGlobals kg,
 
     volume_shader_motion_blur(kg, sd);
 #  endif
+
+    if (volume_shader_in_empty_space(kg, sd)) {
+      /* No active voxels here, so the entry contributes nothing. */
+      return true;
+    }
   }
 
   /* Evaluate shader. */
@@ -13,14 +13,27 @@ namespace ccl {
 /* Simple CDF based sampling over all lights in the scene, without taking into
  * account shading position or normal. */
 
-ccl_device int light_distribution_sample(KernelGlobals kg, const float rand)
+#ifdef __LIGHT_LINKING__
+/* Receiver light set of the object, used to select the distribution specialized for it. */
+ccl_device_inline uint light_link_receiver_set(KernelGlobals kg, const int object_receiver)
+{
+  return (object_receiver != OBJECT_NONE) ?
+             kernel_data_fetch(objects, object_receiver).receiver_light_set :
+             0;
+}
+#endif
+
+ccl_device int light_distribution_sample(KernelGlobals kg,
+                                         const float rand,
+                                         const int offset,
+                                         const int num)
 {
   /* This is basically std::upper_bound as used by PBRT, to find a point light or
    * triangle to emit from, proportional to area. a good improvement would be to
    * also sample proportional to power, though it's not so well defined with
    * arbitrary shaders. */
-  int first = 0;
-  int len = kernel_data.integrator.num_distribution + 1;
+  int first = offset;
+  int len = num + 1;
 
   do {
     const int half_len = len >> 1;
@@ -37,24 +50,63 @@ ccl_device int light_distribution_sample(KernelGlobals kg, const float rand)
 
   /* Clamping should not be needed but float rounding errors seem to
    * make this fail on rare occasions. */
-  const int index = clamp(first - 1, 0, kernel_data.integrator.num_distribution - 1);
+  const int index = clamp(first - 1, offset, offset + num - 1);
 
   return index;
 }
 
 ccl_device_noinline bool light_distribution_sample(KernelGlobals kg,
                                                    const float rand,
+                                                   const int object_receiver,
                                                    ccl_private LightSample *ls)
 {
+#ifdef __LIGHT_LINKING__
+  if (kernel_data.kernel_features & KERNEL_FEATURE_LIGHT_LINKING) {
+    /* Sample from the distribution specialized for the receiver light set, so that
+     * emitters which are not linked to the receiver are never picked only to be
+     * rejected afterwards. */
+    const uint receiver_set = light_link_receiver_set(kg, object_receiver);
+    const int num = kernel_data.light_link_sets[receiver_set].num_distribution;
+    if (num == 0) {
+      return false;
+    }
+
+    ls->emitter_id = light_distribution_sample(
+        kg, rand, kernel_data.light_link_sets[receiver_set].distribution_offset, num);
+    ls->pdf_selection = kernel_data.light_link_sets[receiver_set].distribution_pdf_lights;
+    return true;
+  }
+#endif
+
   /* Sample light index from distribution. */
-  ls->emitter_id = light_distribution_sample(kg, rand);
+  ls->emitter_id = light_distribution_sample(kg, rand, 0, kernel_data.integrator.num_distribution);
   ls->pdf_selection = kernel_data.integrator.distribution_pdf_lights;
   return true;
 }
 
-ccl_device_inline float light_distribution_pdf_lamp(KernelGlobals kg)
+ccl_device_inline float light_distribution_pdf_lamp(KernelGlobals kg, const int object_receiver)
 {
+#ifdef __LIGHT_LINKING__
+  if (kernel_data.kernel_features & KERNEL_FEATURE_LIGHT_LINKING) {
+    return kernel_data.light_link_sets[light_link_receiver_set(kg, object_receiver)]
+        .distribution_pdf_lights;
+  }
+#endif
+
   return kernel_data.integrator.distribution_pdf_lights;
 }
 
+ccl_device_inline float light_distribution_pdf_triangles(KernelGlobals kg,
+                                                         const int object_receiver)
+{
+#ifdef __LIGHT_LINKING__
+  if (kernel_data.kernel_features & KERNEL_FEATURE_LIGHT_LINKING) {
+    return kernel_data.light_link_sets[light_link_receiver_set(kg, object_receiver)]
+        .distribution_pdf_triangles;
+  }
+#endif
+
+  return kernel_data.integrator.distribution_pdf_triangles;
+}
+
 }
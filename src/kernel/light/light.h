@@ -230,7 +230,9 @@ ccl_device_noinline bool light_sample(KernelGlobals kg,
       return false;
     }
 
-    if (!triangle_light_sample<in_volume_segment>(kg, prim, object_id, rand, time, ls, P)) {
+    if (!triangle_light_sample<in_volume_segment>(
+            kg, prim, object_id, object_receiver, rand, time, ls, P))
+    {
       return false;
     }
     ls->shader |= shader_flag;
@@ -343,7 +343,7 @@ ccl_device_inline bool light_sample_from_volume_segment(KernelGlobals kg,
   else
 #endif
   {
-    if (!light_distribution_sample(kg, rand.z, ls)) {
+    if (!light_distribution_sample(kg, rand.z, object_receiver, ls)) {
       return false;
     }
   }
@@ -374,7 +374,7 @@ ccl_device bool light_sample_from_position(KernelGlobals kg,
   else
 #endif
   {
-    if (!light_distribution_sample(kg, rand.z, ls)) {
+    if (!light_distribution_sample(kg, rand.z, object_receiver, ls)) {
       return false;
     }
   }
@@ -437,7 +437,7 @@ ccl_device_inline float light_sample_mis_weight_forward_surface(KernelGlobals kg
 
   const float bsdf_pdf = INTEGRATOR_STATE(state, path, mis_ray_pdf);
   const float t = sd->ray_length;
-  float pdf = triangle_light_pdf(kg, sd, t);
+  float pdf = triangle_light_pdf(kg, sd, t, light_link_receiver_forward(kg, state));
 
   /* Light selection pdf. */
 #ifdef __LIGHT_TREE__
@@ -493,7 +493,7 @@ ccl_device_inline float light_sample_mis_weight_forward_lamp(KernelGlobals kg,
   else
 #endif
   {
-    pdf *= light_distribution_pdf_lamp(kg);
+    pdf *= light_distribution_pdf_lamp(kg, light_link_receiver_forward(kg, state));
   }
 
   return light_sample_mis_weight_forward(kg, mis_ray_pdf, pdf);
@@ -535,7 +535,7 @@ ccl_device_inline float light_sample_mis_weight_forward_background(KernelGlobals
   else
 #endif
   {
-    pdf *= light_distribution_pdf_lamp(kg);
+    pdf *= light_distribution_pdf_lamp(kg, light_link_receiver_forward(kg, state));
   }
 
   return light_sample_mis_weight_forward(kg, mis_ray_pdf, pdf);
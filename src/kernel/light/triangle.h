@@ -7,6 +7,7 @@
 #include "kernel/globals.h"
 
 #include "kernel/light/common.h"
+#include "kernel/light/distribution.h"
 
 #include "kernel/geom/motion_triangle.h"
 #include "kernel/geom/object.h"
@@ -62,7 +63,8 @@ ccl_device_inline float triangle_light_pdf_area_sampling(const float3 Ng,
 
 ccl_device_forceinline float triangle_light_pdf(KernelGlobals kg,
                                                 const ccl_private ShaderData *sd,
-                                                const float t)
+                                                const float t,
+                                                const int object_receiver)
 {
   /* A naive heuristic to decide between costly solid angle sampling
    * and simple area sampling, comparing the distance to the triangle plane
@@ -118,7 +120,7 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals kg,
       distribution_area = triangle_area(V[0], V[1], V[2]);
     }
 
-    pdf *= distribution_area * kernel_data.integrator.distribution_pdf_triangles;
+    pdf *= distribution_area * light_distribution_pdf_triangles(kg, object_receiver);
   }
 
   return pdf;
@@ -128,6 +130,7 @@ template<bool in_volume_segment>
 ccl_device_forceinline bool triangle_light_sample(KernelGlobals kg,
                                                   const int prim,
                                                   const int object,
+                                                  const int object_receiver,
                                                   const float2 rand,
                                                   const float time,
                                                   ccl_private LightSample *ls,
@@ -270,7 +273,7 @@ ccl_device_forceinline bool triangle_light_sample(KernelGlobals kg,
       distribution_area = triangle_area(V[0], V[1], V[2]);
     }
 
-    ls->pdf_selection = distribution_area * kernel_data.integrator.distribution_pdf_triangles;
+    ls->pdf_selection = distribution_area * light_distribution_pdf_triangles(kg, object_receiver);
   }
 
   return (ls->pdf > 0.0f);
@@ -73,7 +73,14 @@ void OSLRenderServices::register_closures(OSL::ShadingSystem *ss)
       "layer", OSL_CLOSURE_LAYER_ID, osl_closure_layer_params(), nullptr, nullptr);
 }
 
-/* Surface & Background */
+/* Surface & Background
+ *
+ * Shaders execute one point at a time. Moving to OSL's batched (8/16-wide)
+ * interface would require BatchedRendererServices implementations of all
+ * attribute, texture and matrix callbacks with wide shader globals, while the
+ * render services here depend on per-point state (tracedata, path_state).
+ * Batches of points sharing a shader therefore execute as consecutive scalar
+ * calls against the same shader group. */
 
 template<>
 void osl_eval_nodes<SHADER_TYPE_SURFACE>(const ThreadKernelGlobalsCPU *kg,
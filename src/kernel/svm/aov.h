@@ -30,7 +30,12 @@ ccl_device void svm_node_aov_color(KernelGlobals kg,
   IF_KERNEL_NODES_FEATURE(AOV)
   {
     const float3 val = stack_load_float3(stack, node.y);
-    film_write_aov_pass_color(kg, state, render_buffer, node.z, val);
+    if (node.w) {
+      film_write_aov_pass_color_half(kg, state, render_buffer, node.z, val);
+    }
+    else {
+      film_write_aov_pass_color(kg, state, render_buffer, node.z, val);
+    }
   }
 }
 
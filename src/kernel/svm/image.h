@@ -17,15 +17,19 @@
 
 namespace ccl {
 
-ccl_device float4
-svm_image_texture(KernelGlobals kg, const int id, const float x, float y, const uint flags)
+ccl_device float4 svm_image_texture(KernelGlobals kg,
+                                    const int id,
+                                    const float x,
+                                    float y,
+                                    const uint flags,
+                                    const float footprint)
 {
   if (id == -1) {
     return make_float4(
         TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
   }
 
-  float4 r = kernel_tex_image_interp(kg, id, x, y);
+  float4 r = kernel_tex_image_interp_lod(kg, id, x, y, footprint);
   const float alpha = r.w;
 
   if ((flags & NODE_IMAGE_ALPHA_UNASSOCIATE) && alpha != 1.0f && alpha != 0.0f) {
@@ -40,6 +44,15 @@ svm_image_texture(KernelGlobals kg, const int id, const float x, float y, const
   return r;
 }
 
+/* Estimate the UV-space filter footprint of the shading point from the surface differentials,
+ * like the bump filter width does. This is approximate: for meshes du/dv are differentials of
+ * the primitive parametrization rather than of the UV map, but it captures how quickly the
+ * surface moves under the pixel, which is what mip level selection needs. */
+ccl_device_inline float svm_image_texture_footprint(ccl_private const ShaderData *sd)
+{
+  return max(max(fabsf(sd->du.dx), fabsf(sd->du.dy)), max(fabsf(sd->dv.dx), fabsf(sd->dv.dy)));
+}
+
 /* Remap coordinate from 0..1 box to -1..-1 */
 ccl_device_inline float3 texco_remap_square(const float3 co)
 {
@@ -47,7 +60,7 @@ ccl_device_inline float3 texco_remap_square(const float3 co)
 }
 
 ccl_device_noinline int svm_node_tex_image(KernelGlobals kg,
-                                           ccl_private ShaderData * /*sd*/,
+                                           ccl_private ShaderData *sd,
                                            ccl_private float *stack,
                                            const uint4 node,
                                            int offset)
@@ -116,7 +129,8 @@ ccl_device_noinline int svm_node_tex_image(KernelGlobals kg,
     id = -num_nodes;
   }
 
-  const float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, flags);
+  const float4 f = svm_image_texture(
+      kg, id, tex_co.x, tex_co.y, flags, svm_image_texture_footprint(sd));
 
   if (stack_valid(out_offset)) {
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -209,21 +223,22 @@ ccl_device_noinline void svm_node_tex_image_box(KernelGlobals kg,
 
   const float3 co = stack_load_float3(stack, co_offset);
   const uint id = node.y;
+  const float footprint = svm_image_texture_footprint(sd);
 
   float4 f = zero_float4();
 
   /* Map so that no textures are flipped, rotation is somewhat arbitrary. */
   if (weight.x > 0.0f) {
     const float2 uv = make_float2((signed_N.x < 0.0f) ? 1.0f - co.y : co.y, co.z);
-    f += weight.x * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.x * svm_image_texture(kg, id, uv.x, uv.y, flags, footprint);
   }
   if (weight.y > 0.0f) {
     const float2 uv = make_float2((signed_N.y > 0.0f) ? 1.0f - co.x : co.x, co.z);
-    f += weight.y * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.y * svm_image_texture(kg, id, uv.x, uv.y, flags, footprint);
   }
   if (weight.z > 0.0f) {
     const float2 uv = make_float2((signed_N.z > 0.0f) ? 1.0f - co.y : co.y, co.x);
-    f += weight.z * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.z * svm_image_texture(kg, id, uv.x, uv.y, flags, footprint);
   }
 
   if (stack_valid(out_offset)) {
@@ -260,7 +275,9 @@ ccl_device_noinline void svm_node_tex_environment(KernelGlobals kg,
     uv = direction_to_mirrorball(co);
   }
 
-  const float4 f = svm_image_texture(kg, id, uv.x, uv.y, flags);
+  /* Environment lookups have no meaningful UV differentials on the stack, sample the base
+   * level. */
+  const float4 f = svm_image_texture(kg, id, uv.x, uv.y, flags, 0.0f);
 
   if (stack_valid(out_offset)) {
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
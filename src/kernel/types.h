@@ -137,6 +137,14 @@ enum {
 
 #define KERNEL_FEATURE_AO (KERNEL_FEATURE_AO_PASS | KERNEL_FEATURE_AO_ADDITIVE)
 
+/* Features not compiled into the precompiled lite GPU kernel variants. A scene
+ * using none of these can run the lite kernel. Must stay in sync with the
+ * defines disabled under __KERNEL_FEATURES_LITE__ below. */
+#define KERNEL_FEATURES_LITE_EXCLUDED \
+  (KERNEL_FEATURE_NODE_VOLUME | KERNEL_FEATURE_NODE_PRINCIPLED_HAIR | \
+   KERNEL_FEATURE_POINTCLOUD | KERNEL_FEATURE_HAIR | KERNEL_FEATURE_HAIR_THICK | \
+   KERNEL_FEATURE_SUBSURFACE | KERNEL_FEATURE_VOLUME)
+
 /* Shader node feature mask, to specialize shader evaluation for kernels. */
 
 #define KERNEL_FEATURE_NODE_MASK_SURFACE_LIGHT \
@@ -158,6 +166,24 @@ enum {
   (KERNEL_FEATURE_NODE_VORONOI_EXTRA | KERNEL_FEATURE_NODE_BUMP | KERNEL_FEATURE_NODE_BUMP_STATE)
 #define KERNEL_FEATURE_NODE_MASK_BUMP KERNEL_FEATURE_NODE_MASK_DISPLACEMENT
 
+/* Per-scene closure set mask, to strip BSDF dispatch cases not reachable from any shader in
+ * the scene out of adaptively compiled kernels. Plain defines rather than enum values since
+ * the mask is consumed in preprocessor conditionals below. The diffuse closure is always
+ * compiled, the kernel itself creates it for e.g. the subsurface exit bounce, and the
+ * principled hair closures are already covered by KERNEL_FEATURE_NODE_PRINCIPLED_HAIR. */
+#define KERNEL_CLOSURE_SET_OREN_NAYAR (1U << 0U)
+#define KERNEL_CLOSURE_SET_TRANSLUCENT (1U << 1U)
+#define KERNEL_CLOSURE_SET_TRANSPARENT (1U << 2U)
+#define KERNEL_CLOSURE_SET_RAY_PORTAL (1U << 3U)
+#define KERNEL_CLOSURE_SET_MICROFACET_GGX (1U << 4U)
+#define KERNEL_CLOSURE_SET_MICROFACET_BECKMANN (1U << 5U)
+#define KERNEL_CLOSURE_SET_ASHIKHMIN_SHIRLEY (1U << 6U)
+#define KERNEL_CLOSURE_SET_ASHIKHMIN_VELVET (1U << 7U)
+#define KERNEL_CLOSURE_SET_TOON (1U << 8U)
+#define KERNEL_CLOSURE_SET_HAIR (1U << 9U)
+#define KERNEL_CLOSURE_SET_SHEEN (1U << 10U)
+#define KERNEL_CLOSURE_SET_ALL (~0U)
+
 /* Must be constexpr on the CPU to avoid compile errors because the state types
  * are different depending on the main, shadow or null path. For GPU we don't have
  * C++17 everywhere so need to check it. */
@@ -197,6 +223,19 @@ enum {
 #define __VISIBILITY_FLAG__
 #define __VOLUME__
 
+/* BSDF closures, strippable per scene via __KERNEL_CLOSURE_SET__ below. */
+#define __CLOSURE_ASHIKHMIN_SHIRLEY__
+#define __CLOSURE_ASHIKHMIN_VELVET__
+#define __CLOSURE_HAIR__
+#define __CLOSURE_MICROFACET_BECKMANN__
+#define __CLOSURE_MICROFACET_GGX__
+#define __CLOSURE_OREN_NAYAR__
+#define __CLOSURE_RAY_PORTAL__
+#define __CLOSURE_SHEEN__
+#define __CLOSURE_TOON__
+#define __CLOSURE_TRANSLUCENT__
+#define __CLOSURE_TRANSPARENT__
+
 /* Device specific features */
 #ifdef WITH_OSL
 #  define __OSL__
@@ -218,7 +257,6 @@ enum {
 #  undef __MNEE__
 #endif
 
-/* Scene-based selective features compilation. */
 /* Scene-based selective features compilation. */
 #ifdef __KERNEL_FEATURES__
 #  if !(__KERNEL_FEATURES__ & KERNEL_FEATURE_OBJECT_MOTION)
@@ -266,6 +304,56 @@ enum {
 #  endif
 #endif
 
+/* Scene-based selective closure compilation. Only strips BSDF dispatch cases from
+ * adaptively compiled kernels, precompiled kernels keep the full closure set. OSL
+ * shaders can emit any closure, so the mask is ignored when OSL is enabled. */
+#if defined(__KERNEL_CLOSURE_SET__) && !defined(__OSL__)
+#  if !(__KERNEL_CLOSURE_SET__ & KERNEL_CLOSURE_SET_OREN_NAYAR)
+#    undef __CLOSURE_OREN_NAYAR__
+#  endif
+#  if !(__KERNEL_CLOSURE_SET__ & KERNEL_CLOSURE_SET_TRANSLUCENT)
+#    undef __CLOSURE_TRANSLUCENT__
+#  endif
+#  if !(__KERNEL_CLOSURE_SET__ & KERNEL_CLOSURE_SET_TRANSPARENT)
+#    undef __CLOSURE_TRANSPARENT__
+#  endif
+#  if !(__KERNEL_CLOSURE_SET__ & KERNEL_CLOSURE_SET_RAY_PORTAL)
+#    undef __CLOSURE_RAY_PORTAL__
+#  endif
+#  if !(__KERNEL_CLOSURE_SET__ & KERNEL_CLOSURE_SET_MICROFACET_GGX)
+#    undef __CLOSURE_MICROFACET_GGX__
+#  endif
+#  if !(__KERNEL_CLOSURE_SET__ & KERNEL_CLOSURE_SET_MICROFACET_BECKMANN)
+#    undef __CLOSURE_MICROFACET_BECKMANN__
+#  endif
+#  if !(__KERNEL_CLOSURE_SET__ & KERNEL_CLOSURE_SET_ASHIKHMIN_SHIRLEY)
+#    undef __CLOSURE_ASHIKHMIN_SHIRLEY__
+#  endif
+#  if !(__KERNEL_CLOSURE_SET__ & KERNEL_CLOSURE_SET_ASHIKHMIN_VELVET)
+#    undef __CLOSURE_ASHIKHMIN_VELVET__
+#  endif
+#  if !(__KERNEL_CLOSURE_SET__ & KERNEL_CLOSURE_SET_TOON)
+#    undef __CLOSURE_TOON__
+#  endif
+#  if !(__KERNEL_CLOSURE_SET__ & KERNEL_CLOSURE_SET_HAIR)
+#    undef __CLOSURE_HAIR__
+#  endif
+#  if !(__KERNEL_CLOSURE_SET__ & KERNEL_CLOSURE_SET_SHEEN)
+#    undef __CLOSURE_SHEEN__
+#  endif
+#endif
+
+/* Selective features compilation for the precompiled lite kernel variants.
+ * Unlike __KERNEL_FEATURES__ this does not depend on the feature mask of a
+ * particular scene, so the binaries can be built ahead of time. */
+#ifdef __KERNEL_FEATURES_LITE__
+#  undef __HAIR__
+#  undef __PRINCIPLED_HAIR__
+#  undef __POINTCLOUD__
+#  undef __SUBSURFACE__
+#  undef __VOLUME__
+#endif
+
 #ifdef WITH_CYCLES_DEBUG_NAN
 #  define __KERNEL_DEBUG_NAN__
 #endif
@@ -743,6 +831,62 @@ struct Intersection {
   int type;
 };
 
+/* Shared-exponent compressed pass weights.
+ *
+ * With __INTEGRATOR_COMPRESSED_PASS_WEIGHTS__ defined, the diffuse/glossy pass split weights in
+ * the integrator state are stored as 8-bit mantissas under a shared exponent in 4 bytes instead
+ * of 12. These weights are written once when a bounce classifies the path and only read back when
+ * writing film passes, so the rounding does not compound over bounces. Path throughput itself is
+ * kept at full precision, as it is multiplied at every bounce and drives Russian roulette where
+ * compounding error would bias the render. Off by default; a device can opt in to shrink path
+ * state and raise the number of in-flight paths. */
+#ifdef __INTEGRATOR_COMPRESSED_PASS_WEIGHTS__
+typedef uint PackedSpectrumWeight;
+
+ccl_device_inline PackedSpectrumWeight spectrum_weight_pack(const Spectrum weight)
+{
+  const float max_component = fmaxf(fmaxf(weight.x, weight.y), weight.z);
+  if (!(max_component >= 1e-32f)) {
+    return 0;
+  }
+  /* Biased IEEE exponent of the largest component, rounded up to the next power of two so that
+   * the 8-bit mantissas stay below 256. */
+  const uint max_bits = __float_as_uint(max_component);
+  const uint exponent = ((max_bits >> 23) & 0xFFu) + ((max_bits & 0x7FFFFFu) ? 1 : 0);
+  /* 2^(8 - unbiased exponent), scales the components into [0, 256). */
+  const float scale = __uint_as_float((262u - exponent) << 23);
+  return (uint)fminf(fmaxf(weight.x, 0.0f) * scale, 255.0f) |
+         ((uint)fminf(fmaxf(weight.y, 0.0f) * scale, 255.0f) << 8) |
+         ((uint)fminf(fmaxf(weight.z, 0.0f) * scale, 255.0f) << 16) | (exponent << 24);
+}
+
+ccl_device_inline Spectrum spectrum_weight_unpack(const PackedSpectrumWeight weight)
+{
+  const uint exponent = weight >> 24;
+  if (exponent == 0) {
+    return zero_spectrum();
+  }
+  /* 2^(unbiased exponent - 8), with half a quantization step added for round-to-center. */
+  const float scale = __uint_as_float((exponent - 8u) << 23);
+  return make_float3((float)(weight & 0xFFu) + 0.5f,
+                     (float)((weight >> 8) & 0xFFu) + 0.5f,
+                     (float)((weight >> 16) & 0xFFu) + 0.5f) *
+         scale;
+}
+#else
+typedef PackedSpectrum PackedSpectrumWeight;
+
+ccl_device_inline PackedSpectrumWeight spectrum_weight_pack(const Spectrum weight)
+{
+  return PackedSpectrum(weight);
+}
+
+ccl_device_inline Spectrum spectrum_weight_unpack(const PackedSpectrumWeight weight)
+{
+  return weight;
+}
+#endif
+
 /* On certain GPUs (Apple Silicon), splitting every integrator state field into its own separate
  * array can be detrimental for cache utilization. By enabling __INTEGRATOR_GPU_PACKED_STATE__, we
  * specify that certain fields should be packed together. This improves cache hit ratios in cases
@@ -1033,6 +1177,12 @@ enum ShaderDataFlag {
 
   /* Shader flags. */
 
+  /* Shader is a single transparent closure with a constant color. The tint is
+   * stored in the constant emission slot of __shaders, and the kernel can
+   * continue rays through such surfaces without evaluating the graph.
+   * NOTE: Uses a spare bit from the runtime range, the shader flag range is full. */
+  SD_HAS_ONLY_TRANSPARENT = (1 << 13),
+
   /* Apply a correction term to smooth illumination on grazing angles when using bump mapping. */
   SD_USE_BUMP_MAP_CORRECTION = (1 << 15),
   /* Use front side for direct light sampling. */
@@ -1068,11 +1218,11 @@ enum ShaderDataFlag {
   /* Use back side for direct light sampling. */
   SD_MIS_BACK = (1 << 31),
 
-  SD_SHADER_FLAGS = (SD_MIS_FRONT | SD_HAS_TRANSPARENT_SHADOW | SD_HAS_VOLUME |
-                     SD_HAS_ONLY_VOLUME | SD_HETEROGENEOUS_VOLUME | SD_HAS_BSSRDF_BUMP |
-                     SD_VOLUME_EQUIANGULAR | SD_VOLUME_MIS | SD_VOLUME_CUBIC | SD_HAS_BUMP |
-                     SD_HAS_DISPLACEMENT | SD_HAS_CONSTANT_EMISSION | SD_NEED_VOLUME_ATTRIBUTES |
-                     SD_HAS_EMISSION | SD_HAS_RAYTRACE | SD_MIS_BACK)
+  SD_SHADER_FLAGS = (SD_HAS_ONLY_TRANSPARENT | SD_MIS_FRONT | SD_HAS_TRANSPARENT_SHADOW |
+                     SD_HAS_VOLUME | SD_HAS_ONLY_VOLUME | SD_HETEROGENEOUS_VOLUME |
+                     SD_HAS_BSSRDF_BUMP | SD_VOLUME_EQUIANGULAR | SD_VOLUME_MIS | SD_VOLUME_CUBIC |
+                     SD_HAS_BUMP | SD_HAS_DISPLACEMENT | SD_HAS_CONSTANT_EMISSION |
+                     SD_NEED_VOLUME_ATTRIBUTES | SD_HAS_EMISSION | SD_HAS_RAYTRACE | SD_MIS_BACK)
 };
 
 /* Object flags. */
@@ -1380,8 +1530,15 @@ struct KernelFilmConvert {
 
   int is_denoised;
 
-  /* Padding. */
-  int pad1;
+  /* Pass is accumulated in packed half precision and needs widening on read. */
+  int pass_half;
+
+  /* Clamp color channels of the converted pixel to [0, clamp_max]. Disabled when zero.
+   * Allows consumers which can not deal with arbitrarily large values (like the GPU denoiser
+   * input) to avoid a separate clamping pass over the pixels. */
+  float clamp_max;
+
+  float pad1, pad2, pad3;
 };
 static_assert_align(KernelFilmConvert, 16);
 
@@ -1449,11 +1606,25 @@ struct KernelBake {
   int object_index;
   int tri_offset;
   int use_camera;
+
+  /* Multiple objects are baked in one session. The object index and primitive offset then come
+   * from the fourth component of the bake primitive pass instead of the fixed members above. */
+  int use_object_pass;
+
+  int pad1, pad2, pad3;
 };
 static_assert_align(KernelBake, 16);
 
 struct KernelLightLinkSet {
+  /* Root node of the light tree specialized for this receiver set. */
   uint light_tree_root;
+
+  /* Range in the light distribution array and selection PDFs specialized for this
+   * receiver set, used when sampling without the light tree. */
+  int distribution_offset;
+  int num_distribution;
+  float distribution_pdf_triangles;
+  float distribution_pdf_lights;
 };
 
 struct ccl_align(16) KernelData
@@ -1495,6 +1666,44 @@ struct ccl_align(16) KernelData
 };
 static_assert_align(KernelData, 16);
 
+/* Optional compile-time specialization of frequently read integrator parameters.
+ *
+ * Metal bakes KernelData fields into the pipeline through function constants. Other GPU
+ * backends can get the same loop-bound folding and dead-code elimination for the hottest
+ * parameters by defining these macros when compiling the kernel, e.g. through adaptive
+ * compilation with CYCLES_CUDA_EXTRA_CFLAGS="-D__KERNEL_SPECIALIZED_MAX_BOUNCE__=4". The
+ * compiled kernel caches key on the full flag string, so specialized variants coexist on disk.
+ * Without the defines these compile to the plain uniform load. */
+#ifdef __KERNEL_SPECIALIZED_MAX_BOUNCE__
+#  define kernel_data_max_bounce __KERNEL_SPECIALIZED_MAX_BOUNCE__
+#else
+#  define kernel_data_max_bounce (kernel_data.integrator.max_bounce)
+#endif
+
+#ifdef __KERNEL_SPECIALIZED_TRANSPARENT_MAX_BOUNCE__
+#  define kernel_data_transparent_max_bounce __KERNEL_SPECIALIZED_TRANSPARENT_MAX_BOUNCE__
+#else
+#  define kernel_data_transparent_max_bounce (kernel_data.integrator.transparent_max_bounce)
+#endif
+
+#ifdef __KERNEL_SPECIALIZED_SAMPLE_CLAMP_DIRECT__
+#  define kernel_data_sample_clamp_direct __KERNEL_SPECIALIZED_SAMPLE_CLAMP_DIRECT__
+#else
+#  define kernel_data_sample_clamp_direct (kernel_data.integrator.sample_clamp_direct)
+#endif
+
+#ifdef __KERNEL_SPECIALIZED_SAMPLE_CLAMP_INDIRECT__
+#  define kernel_data_sample_clamp_indirect __KERNEL_SPECIALIZED_SAMPLE_CLAMP_INDIRECT__
+#else
+#  define kernel_data_sample_clamp_indirect (kernel_data.integrator.sample_clamp_indirect)
+#endif
+
+#ifdef __KERNEL_SPECIALIZED_VOLUME_MAX_STEPS__
+#  define kernel_data_volume_max_steps __KERNEL_SPECIALIZED_VOLUME_MAX_STEPS__
+#else
+#  define kernel_data_volume_max_steps (kernel_data.integrator.volume_max_steps)
+#endif
+
 /* Kernel data structures. */
 
 struct KernelObject {
@@ -1519,6 +1728,11 @@ struct KernelObject {
   uint attribute_map_offset;
   uint motion_offset;
 
+  /* Piecewise-linear motion transform table, see object_motion_lerp array.
+   * Zero steps when the per-ray slerp interpolation is used instead. */
+  uint motion_lerp_offset;
+  int num_tfm_lerp_steps;
+
   float cryptomatte_object;
   float cryptomatte_asset;
 
@@ -1551,6 +1765,19 @@ struct KernelCurve {
 };
 static_assert_align(KernelCurve, 16);
 
+/* Coarse occupancy grid over the active voxels of a volume object, used to
+ * skip volume shader evaluation in regions without any voxel data during ray
+ * marching. */
+struct KernelVolumeOccupancy {
+  /* Transform from object space to occupancy cell coordinates. */
+  Transform tfm;
+  /* Offset into the volume_occupancy_bits array, or -1 when there is no grid. */
+  int bits_offset;
+  /* Number of cells along each axis. */
+  int res_x, res_y, res_z;
+};
+static_assert_align(KernelVolumeOccupancy, 16);
+
 struct KernelCurveSegment {
   int prim;
   int type;
@@ -1730,7 +1957,10 @@ struct KernelShader {
   float cryptomatte_id;
   int flags;
   int pass_id;
-  int pad2, pad3;
+  /* Position of the shader in the complexity-ordered shading dispatch, see
+   * ShaderManager::device_update_common. */
+  int sort_key;
+  int pad3;
 };
 static_assert_align(KernelShader, 16);
 
@@ -1787,6 +2017,10 @@ static_assert_align(KernelShaderEvalInput, 16);
 #define NUM_TAB_SOBOL_PATTERNS 256
 // NOLINTEND
 
+/* Pixel block size at which adaptive sampling convergence is tracked, so that work scheduling
+ * can skip regions of the render buffer that have fully converged. */
+#define ADAPTIVE_SAMPLING_BLOCK_SIZE 8
+
 /* Device kernels.
  *
  * Identifier for kernels that can be executed in device queues.
@@ -1852,12 +2086,11 @@ enum DeviceKernel : int {
 #undef DECLARE_FILM_CONVERT_KERNEL
 
   DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_CHECK,
-  DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER_X,
-  DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER_Y,
+  DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER,
+  DEVICE_KERNEL_ADAPTIVE_SAMPLING_COUNT_ACTIVE_BLOCKS,
 
   DEVICE_KERNEL_FILTER_GUIDING_PREPROCESS,
   DEVICE_KERNEL_FILTER_GUIDING_SET_FAKE_ALBEDO,
-  DEVICE_KERNEL_FILTER_COLOR_PREPROCESS,
   DEVICE_KERNEL_FILTER_COLOR_POSTPROCESS,
 
   DEVICE_KERNEL_CRYPTOMATTE_POSTPROCESS,
@@ -24,6 +24,16 @@ void ImageBuf::set_write_format(TypeDesc format)
   output_format_ = format;
 }
 
+const ImageSpec &ImageBuf::spec() const
+{
+  return buffer_spec_;
+}
+
+void *ImageBuf::buffer() const
+{
+  return buffer_;
+}
+
 stride_t ImageBuf::pixel_stride() const
 {
   return xstride_;
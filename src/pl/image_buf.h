@@ -34,6 +34,10 @@ class ImageBuf {
 
   void set_write_format(TypeDesc format);
 
+  const ImageSpec &spec() const;
+
+  void *buffer() const;
+
   stride_t pixel_stride() const;
 
   stride_t scanline_stride() const;
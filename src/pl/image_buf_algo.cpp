@@ -4,13 +4,97 @@
 
 #include "pl/image_buf_algo.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+
 #include "pl/error.h"
 
 namespace ccl {
 
-bool ImageBufAlgo::pow(ImageBuf &dst, const ImageBuf &A, const std::vector<float> &b)
+namespace {
+
+// Run fn(begin, end) for contiguous ranges of [0, count), one thread per range.
+void parallel_ranges(int count, const std::function<void(int, int)> &fn)
+{
+  int num_threads = static_cast<int>(std::thread::hardware_concurrency());
+  num_threads = std::max(std::min(num_threads, count), 1);
+
+  if (num_threads == 1) {
+    fn(0, count);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; t++) {
+    const int begin = count * t / num_threads;
+    const int end = count * (t + 1) / num_threads;
+    threads.emplace_back([&fn, begin, end]() { fn(begin, end); });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+}
+
+stride_t resolved_pixel_stride(const ImageBuf &buf)
+{
+  const stride_t xstride = buf.pixel_stride();
+  return (xstride == AutoStride) ? buf.spec().pixel_bytes() : xstride;
+}
+
+stride_t resolved_scanline_stride(const ImageBuf &buf)
 {
-  PL_NOT_IMPLEMENTED();
+  const stride_t ystride = buf.scanline_stride();
+  return (ystride == AutoStride) ? resolved_pixel_stride(buf) * buf.spec().width : ystride;
+}
+
+}  // namespace
+
+bool ImageBufAlgo::pow(ImageBuf &dst, const ImageBuf &A, const std::vector<float> &B)
+{
+  const ImageSpec &spec = A.spec();
+
+  PL_CHECK(spec.format.basetype == TypeDesc::FLOAT);
+  PL_CHECK(dst.spec().format.basetype == TypeDesc::FLOAT);
+  PL_CHECK(dst.spec().width == spec.width && dst.spec().height == spec.height &&
+           dst.spec().nchannels == spec.nchannels);
+
+  const int nchannels = spec.nchannels;
+
+  /* Channels without an explicit exponent pass through unchanged. */
+  std::vector<float> exponents(nchannels, 1.0f);
+  for (int c = 0; c < nchannels && c < static_cast<int>(B.size()); c++) {
+    exponents[c] = B[c];
+  }
+
+  const stride_t src_xstride = resolved_pixel_stride(A);
+  const stride_t src_ystride = resolved_scanline_stride(A);
+  const stride_t dst_xstride = resolved_pixel_stride(dst);
+  const stride_t dst_ystride = resolved_scanline_stride(dst);
+
+  const char *src_base = static_cast<const char *>(A.buffer());
+  char *dst_base = static_cast<char *>(dst.buffer());
+
+  /* Scanlines are independent, process them in parallel. */
+  parallel_ranges(spec.height, [&](const int begin, const int end) {
+    for (int y = begin; y < end; y++) {
+      const char *src_row = src_base + y * src_ystride;
+      char *dst_row = dst_base + y * dst_ystride;
+
+      for (int x = 0; x < spec.width; x++) {
+        const float *src_pixel = reinterpret_cast<const float *>(src_row + x * src_xstride);
+        float *dst_pixel = reinterpret_cast<float *>(dst_row + x * dst_xstride);
+
+        for (int c = 0; c < nchannels; c++) {
+          const float e = exponents[c];
+          dst_pixel[c] = (e == 1.0f) ? src_pixel[c] : powf(src_pixel[c], e);
+        }
+      }
+    }
+  });
+
   return true;
 }
 
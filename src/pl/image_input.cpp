@@ -4,19 +4,48 @@
 
 #include "pl/image_input.h"
 
+#include <filesystem>
+
 #include "pl/error.h"
+#include "pl/tiled_image_input.h"
 
 namespace ccl {
 
-ImageInput::unique_ptr ImageInput::open(string_view filename, const ImageSpec *config)
+ImageInput::ImageInput() {}
+
+ImageInput::~ImageInput() {}
+
+const ImageSpec &ImageInput::spec(void) const
 {
   PL_NOT_IMPLEMENTED();
-  return nullptr;
+  static const ImageSpec empty_spec;
+  return empty_spec;
+}
+
+ImageInput::unique_ptr ImageInput::open(string_view filename, const ImageSpec *config)
+{
+  unique_ptr in = create(filename);
+  if (!in) {
+    return nullptr;
+  }
+
+  ImageSpec newspec;
+  const bool success = config ? in->open(filename, newspec, *config) : in->open(filename, newspec);
+  if (!success) {
+    return nullptr;
+  }
+
+  return in;
 }
 
 ImageInput::unique_ptr ImageInput::create(string_view filename)
 {
-  PL_NOT_IMPLEMENTED();
+  std::filesystem::path ext = std::filesystem::path(filename).extension();
+
+  if (ext == ".ctf") {
+    return std::make_unique<TiledImageInput>();
+  }
+
   return nullptr;
 }
 
@@ -9,6 +9,7 @@
 
 #include "pl/error.h"
 #include "pl/png_image_output.h"
+#include "pl/tiled_image_output.h"
 
 namespace ccl {
 
@@ -24,6 +25,10 @@ ImageOutput::unique_ptr ImageOutput::create(string_view filename)
     return std::make_unique<PNGImageOutput>();
   }
 
+  if (ext == ".ctf") {
+    return std::make_unique<TiledImageOutput>();
+  }
+
   return nullptr;
 }
 
@@ -4,6 +4,8 @@
 
 #include "pl/image_spec.h"
 
+#include <cctype>
+
 #include "pl/error.h"
 
 namespace ccl {
@@ -67,32 +69,125 @@ imagesize_t ImageSpec::scanline_bytes() const
   return width * pixel_bytes();
 }
 
+static bool attribute_name_equal(string_view a, string_view b, bool casesensitive)
+{
+  if (a.size() != b.size()) {
+    return false;
+  }
+  if (casesensitive) {
+    return a == b;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (tolower(a[i]) != tolower(b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ImageSpec::attribute(string_view name, TypeDesc type, const void *value)
+{
+  ParamValue *existing = find_attribute(name);
+  if (existing) {
+    /* Keep the existing name string, only the value changes. */
+    existing->reset_value(type, 1, value);
+    return;
+  }
+
+  extra_attribs.emplace_back(name, type, 1, value);
+}
+
 void ImageSpec::attribute(string_view name, unsigned int value)
 {
-  PL_NOT_IMPLEMENTED();
+  attribute(name, TypeDesc::UINT, &value);
+}
+
+void ImageSpec::attribute(string_view name, int value)
+{
+  attribute(name, TypeDesc::INT, &value);
+}
+
+void ImageSpec::attribute(string_view name, float value)
+{
+  attribute(name, TypeDesc::FLOAT, &value);
+}
+
+void ImageSpec::attribute(string_view name, string_view value)
+{
+  /* Strings are stored as null-terminated char arrays: the trimmed down ParamValue does not
+   * manage string memory. */
+  attribute(name, TypeDesc(TypeDesc::CHAR, static_cast<int>(value.size()) + 1),
+            string(value).c_str());
 }
 
 void ImageSpec::attribute(string_view name, string value)
 {
-  PL_NOT_IMPLEMENTED();
+  attribute(name, string_view(value));
+}
+
+ParamValue *ImageSpec::find_attribute(string_view name, TypeDesc searchtype, bool casesensitive)
+{
+  for (ParamValue &attrib : extra_attribs) {
+    if (attribute_name_equal(attrib.name(), name, casesensitive) &&
+        (searchtype == TypeDesc::UNKNOWN || searchtype == attrib.type()))
+    {
+      return &attrib;
+    }
+  }
+  return nullptr;
+}
+
+const ParamValue *ImageSpec::find_attribute(string_view name,
+                                            TypeDesc searchtype,
+                                            bool casesensitive) const
+{
+  return const_cast<ImageSpec *>(this)->find_attribute(name, searchtype, casesensitive);
 }
 
 int ImageSpec::get_int_attribute(string_view name, int default_value) const
 {
-  PL_NOT_IMPLEMENTED();
-  return default_value;
+  const ParamValue *attrib = find_attribute(name);
+  if (!attrib || attrib->type().arraylen != 0) {
+    return default_value;
+  }
+
+  switch (attrib->type().basetype) {
+    case TypeDesc::INT:
+      return attrib->get<int>();
+    case TypeDesc::UINT:
+      return static_cast<int>(attrib->get<unsigned int>());
+    default:
+      return default_value;
+  }
 }
 
 float ImageSpec::get_float_attribute(string_view name, float default_value) const
 {
-  PL_NOT_IMPLEMENTED();
-  return default_value;
+  const ParamValue *attrib = find_attribute(name);
+  if (!attrib || attrib->type().arraylen != 0) {
+    return default_value;
+  }
+
+  switch (attrib->type().basetype) {
+    case TypeDesc::FLOAT:
+      return attrib->get<float>();
+    case TypeDesc::INT:
+      return static_cast<float>(attrib->get<int>());
+    case TypeDesc::UINT:
+      return static_cast<float>(attrib->get<unsigned int>());
+    default:
+      return default_value;
+  }
 }
 
 string_view ImageSpec::get_string_attribute(string_view name, string_view default_value) const
 {
-  PL_NOT_IMPLEMENTED();
-  return default_value;
+  const ParamValue *attrib = find_attribute(name);
+  if (!attrib || attrib->type().basetype != TypeDesc::CHAR || attrib->type().arraylen <= 0) {
+    return default_value;
+  }
+
+  return string_view(reinterpret_cast<const char *>(attrib->data()), attrib->type().arraylen - 1);
 }
 
 }
@@ -42,6 +42,13 @@ class ImageSpec {
 
   ImageSpec(int xres, int yres, int nchans, TypeDesc format);
 
+  /* Copies duplicate the attribute list; moves steal it without allocating, so prefer moving
+   * specs through the input/output chain when the source is no longer needed. */
+  ImageSpec(const ImageSpec &) = default;
+  ImageSpec(ImageSpec &&) noexcept = default;
+  ImageSpec &operator=(const ImageSpec &) = default;
+  ImageSpec &operator=(ImageSpec &&) noexcept = default;
+
   size_t channel_bytes() const;
 
   size_t pixel_bytes() const;
@@ -52,6 +59,10 @@ class ImageSpec {
 
   void attribute(string_view name, unsigned int value);
 
+  void attribute(string_view name, int value);
+
+  void attribute(string_view name, float value);
+
   void attribute(string_view name, string_view value);
 
   void attribute(string_view name, string value);
@@ -28,7 +28,7 @@ void ParamValue::init_noclear(string _name,
                               Copy _copy,
                               FromUstring _from_string) noexcept
 {
-  m_name = _name;
+  m_name = std::move(_name);
   m_type = _type;
   m_nvalues = _nvalues;
   m_interp = _interp;
@@ -89,18 +89,28 @@ const ParamValue &ParamValue::operator=(ParamValue &&p) noexcept
 {
   if (this != &p) {
     clear_value();
-    init_noclear(
-        p.name(), p.type(), p.nvalues(), p.interp(), p.data(), Copy(false), FromUstring(true));
+    m_name = std::move(p.m_name);
+    m_type = p.m_type;
+    m_data = p.m_data;
+    m_nvalues = p.m_nvalues;
+    m_interp = p.m_interp;
     m_copy = p.m_copy;
     m_nonlocal = p.m_nonlocal;
     p.m_data.ptr = nullptr;  // make sure the old one won't free
+    p.m_copy = false;
+    p.m_nonlocal = false;
   }
   return *this;
 }
 
 void ParamValue::clear_value() noexcept
 {
-  PL_NOT_IMPLEMENTED();
+  if (m_copy && m_nonlocal && m_data.ptr) {
+    free(const_cast<void *>(m_data.ptr));
+  }
+  m_data.ptr = nullptr;
+  m_copy = false;
+  m_nonlocal = false;
 }
 
 }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <string>
+#include <utility>
 
 #include "pl/error.h"
 #include "pl/strong_param.h"
@@ -147,14 +148,21 @@ class ParamValue {
     init_noclear(p.name(), p.type(), p.nvalues(), p.interp(), p.data(), _copy, FromUstring(true));
   }
 
-  // Rvalue (move) constructor
+  // Rvalue (move) constructor. Steals the name string and the data (pointer
+  // or local bytes) without allocating, which keeps vector<ParamValue>
+  // growth and spec propagation cheap.
   ParamValue(ParamValue &&p) noexcept
+      : m_name(std::move(p.m_name)),
+        m_type(p.m_type),
+        m_data(p.m_data),
+        m_nvalues(p.m_nvalues),
+        m_interp(p.m_interp),
+        m_copy(p.m_copy),
+        m_nonlocal(p.m_nonlocal)
   {
-    init_noclear(
-        p.name(), p.type(), p.nvalues(), p.interp(), p.data(), Copy(false), FromUstring(true));
-    m_copy = p.m_copy;
-    m_nonlocal = p.m_nonlocal;
     p.m_data.ptr = nullptr;  // make sure the old one won't free
+    p.m_copy = false;
+    p.m_nonlocal = false;
   }
 
   ~ParamValue() noexcept
@@ -198,6 +206,15 @@ class ParamValue {
     init(string(_name), _type, _nvalues, _interp, _value, _copy);
   }
 
+  /// Replace the value while keeping the existing name, avoiding the name
+  /// string re-allocation of init() when a metadata entry is overwritten.
+  void reset_value(TypeDesc _type, int _nvalues, const void *_value, Copy _copy = Copy(true)) noexcept
+  {
+    string name = std::move(m_name);
+    clear_value();
+    init_noclear(std::move(name), _type, _nvalues, _value, _copy);
+  }
+
   // Assignment
   const ParamValue &operator=(const ParamValue &p) noexcept;
   const ParamValue &operator=(ParamValue &&p) noexcept;
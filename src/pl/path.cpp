@@ -4,6 +4,15 @@
 
 #include "pl/path.h"
 
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
 #include "pl/error.h"
 
 namespace ccl {
@@ -14,5 +23,106 @@ std::string this_program_path()
   return "";
 }
 
+MappedFile::~MappedFile()
+{
+  close();
 }
 
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &path)
+{
+  close();
+
+  HANDLE file = CreateFileA(
+      path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    CloseHandle(file);
+    return false;
+  }
+
+  const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!data) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+
+  file_handle_ = file;
+  mapping_handle_ = mapping;
+  data_ = data;
+  size_ = static_cast<size_t>(file_size.QuadPart);
+
+  return true;
+}
+
+void MappedFile::close()
+{
+  if (data_) {
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_handle_);
+    CloseHandle(file_handle_);
+  }
+
+  data_ = nullptr;
+  size_ = 0;
+  file_handle_ = nullptr;
+  mapping_handle_ = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string &path)
+{
+  close();
+
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+
+  void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  /* The mapping keeps its own reference to the file. */
+  ::close(fd);
+
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  data_ = data;
+  size_ = st.st_size;
+
+  return true;
+}
+
+void MappedFile::close()
+{
+  if (data_) {
+    munmap(const_cast<void *>(data_), size_);
+  }
+
+  data_ = nullptr;
+  size_ = 0;
+}
+
+#endif
+
+}
@@ -4,11 +4,57 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace ccl {
 
 std::string this_program_path();
 
-}
+/* Read-only memory-mapped file.
+ *
+ * Lets file readers decode directly from mapped pages instead of duplicating the file contents
+ * into a staging buffer first. The mapping is released on destruction, data() is only valid
+ * while the object is alive and open. */
+
+class MappedFile {
+ public:
+  MappedFile() = default;
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /* Map the file read-only. Returns false and leaves the object closed on failure, including
+   * for empty files. */
+  bool open(const std::string &path);
+
+  void close();
 
+  bool is_open() const
+  {
+    return data_ != nullptr;
+  }
+
+  const void *data() const
+  {
+    return data_;
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+ private:
+  const void *data_ = nullptr;
+  size_t size_ = 0;
+
+#ifdef _WIN32
+  void *file_handle_ = nullptr;
+  void *mapping_handle_ = nullptr;
+#endif
+};
+
+}
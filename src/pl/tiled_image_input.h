@@ -0,0 +1,63 @@
+/* SPDX-FileCopyrightText: 2025 Primate Labs Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "pl/image_input.h"
+#include "pl/path.h"
+
+namespace ccl {
+
+/* Input for the internal tiled image format (.ctf) written by TiledImageOutput.
+ *
+ * The file is memory mapped, so tiles inflate directly from the mapped pages without an
+ * intermediate read into a staging buffer. */
+
+class TiledImageInput : public ImageInput {
+ public:
+  TiledImageInput();
+
+  virtual ~TiledImageInput();
+
+  virtual const char *format_name(void) const
+  {
+    return "ctf";
+  }
+
+  virtual bool open(string_view name, ImageSpec &newspec);
+
+  virtual bool close();
+
+  virtual bool read_image(int subimage,
+                          int miplevel,
+                          int chbegin,
+                          int chend,
+                          TypeDesc format,
+                          void *data,
+                          stride_t xstride = AutoStride,
+                          stride_t ystride = AutoStride,
+                          stride_t zstride = AutoStride);
+
+  virtual const ImageSpec &spec(void) const
+  {
+    return spec_;
+  }
+
+ private:
+  ImageSpec spec_;
+
+  MappedFile map_;
+
+  int num_tiles_x_ = 0;
+  int num_tiles_y_ = 0;
+
+  /* Byte offset and compressed size of each tile, zero when a tile is absent. */
+  std::vector<uint64_t> tile_offsets_;
+  std::vector<uint64_t> tile_sizes_;
+};
+
+}
@@ -0,0 +1,34 @@
+/* SPDX-FileCopyrightText: 2025 Primate Labs Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstdint>
+
+namespace ccl {
+
+/* On-disk layout of the internal tiled image format (.ctf), shared between TiledImageOutput and
+ * TiledImageInput.
+ *
+ * The file starts with TiledImageFileHeader, followed by the zlib-compressed tile blobs in the
+ * order they were written. At index_offset the file holds, per tile in row-major order, the byte
+ * offset and compressed size (both zero for absent tiles), then the channel names and the extra
+ * attributes of the image spec. */
+
+constexpr char TILED_IMAGE_MAGIC[4] = {'P', 'L', 'T', 'F'};
+constexpr uint32_t TILED_IMAGE_VERSION = 1;
+
+struct TiledImageFileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t width;
+  uint32_t height;
+  uint32_t nchannels;
+  uint32_t basetype;
+  uint32_t tile_width;
+  uint32_t tile_height;
+  uint64_t index_offset;
+};
+
+}
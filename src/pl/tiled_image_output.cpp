@@ -0,0 +1,255 @@
+/* SPDX-FileCopyrightText: 2025 Primate Labs Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "pl/tiled_image_output.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#include <zlib.h>
+
+#include "pl/error.h"
+#include "pl/tiled_image_io.h"
+
+namespace ccl {
+
+namespace {
+
+// Run fn(begin, end) for contiguous ranges of [0, count), one thread per range.
+void parallel_ranges(int count, const std::function<void(int, int)> &fn)
+{
+  int num_threads = static_cast<int>(std::thread::hardware_concurrency());
+  num_threads = std::max(std::min(num_threads, count), 1);
+
+  if (num_threads == 1) {
+    fn(0, count);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; t++) {
+    const int begin = count * t / num_threads;
+    const int end = count * (t + 1) / num_threads;
+    threads.emplace_back([&fn, begin, end]() { fn(begin, end); });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+}
+
+void write_u32(std::ofstream &ofs, uint32_t value)
+{
+  ofs.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void write_string(std::ofstream &ofs, const std::string &value)
+{
+  write_u32(ofs, static_cast<uint32_t>(value.size()));
+  ofs.write(value.data(), value.size());
+}
+
+}  // namespace
+
+TiledImageOutput::TiledImageOutput() {}
+
+TiledImageOutput::~TiledImageOutput()
+{
+  close();
+}
+
+bool TiledImageOutput::open(string_view filename, const ImageSpec &spec)
+{
+  spec_ = spec;
+
+  PL_CHECK(spec_.format.basetype == TypeDesc::FLOAT);
+  PL_CHECK(spec_.tile_width > 0 && spec_.tile_height > 0);
+
+  num_tiles_x_ = (spec_.width + spec_.tile_width - 1) / spec_.tile_width;
+  num_tiles_y_ = (spec_.height + spec_.tile_height - 1) / spec_.tile_height;
+
+  tile_offsets_.assign(static_cast<size_t>(num_tiles_x_) * num_tiles_y_, 0);
+  tile_sizes_.assign(static_cast<size_t>(num_tiles_x_) * num_tiles_y_, 0);
+
+  ofs_.open(string{filename}, std::ios::out | std::ios::binary);
+  if (ofs_.fail()) {
+    return false;
+  }
+
+  /* Header with a placeholder index offset, patched on close. */
+  TiledImageFileHeader header;
+  memcpy(header.magic, TILED_IMAGE_MAGIC, sizeof(header.magic));
+  header.version = TILED_IMAGE_VERSION;
+  header.width = spec_.width;
+  header.height = spec_.height;
+  header.nchannels = spec_.nchannels;
+  header.basetype = spec_.format.basetype;
+  header.tile_width = spec_.tile_width;
+  header.tile_height = spec_.tile_height;
+  header.index_offset = 0;
+
+  ofs_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file_offset_ = sizeof(header);
+
+  return !ofs_.fail();
+}
+
+bool TiledImageOutput::close()
+{
+  if (!ofs_.is_open()) {
+    return true;
+  }
+
+  const uint64_t index_offset = file_offset_;
+
+  ofs_.write(reinterpret_cast<const char *>(tile_offsets_.data()),
+             tile_offsets_.size() * sizeof(uint64_t));
+  ofs_.write(reinterpret_cast<const char *>(tile_sizes_.data()),
+             tile_sizes_.size() * sizeof(uint64_t));
+
+  write_u32(ofs_, static_cast<uint32_t>(spec_.channelnames.size()));
+  for (const std::string &channel_name : spec_.channelnames) {
+    write_string(ofs_, channel_name);
+  }
+
+  /* Attributes with pointer data cannot be serialized, only raw values. */
+  uint32_t num_attribs = 0;
+  for (const ParamValue &attrib : spec_.extra_attribs) {
+    if (attrib.type().basetype != TypeDesc::STRING) {
+      num_attribs++;
+    }
+  }
+
+  write_u32(ofs_, num_attribs);
+  for (const ParamValue &attrib : spec_.extra_attribs) {
+    const TypeDesc type = attrib.type();
+    if (type.basetype == TypeDesc::STRING) {
+      continue;
+    }
+
+    write_string(ofs_, attrib.name());
+    write_u32(ofs_, type.basetype);
+    write_u32(ofs_, type.aggregate);
+    write_u32(ofs_, type.vecsemantics);
+    write_u32(ofs_, type.arraylen);
+    write_u32(ofs_, attrib.nvalues());
+    ofs_.write(reinterpret_cast<const char *>(attrib.data()), attrib.datasize());
+  }
+
+  /* Patch the index offset in the header. */
+  ofs_.seekp(offsetof(TiledImageFileHeader, index_offset));
+  ofs_.write(reinterpret_cast<const char *>(&index_offset), sizeof(index_offset));
+
+  const bool success = !ofs_.fail();
+  ofs_.close();
+
+  return success;
+}
+
+bool TiledImageOutput::write_image(
+    TypeDesc format, const void *data, stride_t xstride, stride_t ystride, stride_t zstride)
+{
+  return write_tiles(
+      0, spec_.width, 0, spec_.height, 0, 1, format, data, xstride, ystride, zstride);
+}
+
+bool TiledImageOutput::write_tiles(int xbegin,
+                                   int xend,
+                                   int ybegin,
+                                   int yend,
+                                   int zbegin,
+                                   int zend,
+                                   TypeDesc format,
+                                   const void *data,
+                                   stride_t xstride,
+                                   stride_t ystride,
+                                   stride_t zstride)
+{
+  if (!ofs_.is_open()) {
+    return false;
+  }
+
+  PL_CHECK(format.basetype == TypeDesc::FLOAT);
+  PL_CHECK(zbegin == 0 && zend == 1);
+
+  /* The written region must be aligned on the tile grid, only the right and bottom edges may
+   * cover partial tiles. */
+  PL_CHECK(xbegin % spec_.tile_width == 0);
+  PL_CHECK(ybegin % spec_.tile_height == 0);
+
+  const size_t pixel_bytes = spec_.pixel_bytes();
+
+  if (xstride == AutoStride) {
+    xstride = pixel_bytes;
+  }
+  if (ystride == AutoStride) {
+    ystride = xstride * (xend - xbegin);
+  }
+  if (zstride == AutoStride) {
+    zstride = ystride * (yend - ybegin);
+  }
+
+  const int tx_begin = xbegin / spec_.tile_width;
+  const int ty_begin = ybegin / spec_.tile_height;
+  const int num_region_tiles_x = (xend - xbegin + spec_.tile_width - 1) / spec_.tile_width;
+  const int num_region_tiles_y = (yend - ybegin + spec_.tile_height - 1) / spec_.tile_height;
+  const int num_region_tiles = num_region_tiles_x * num_region_tiles_y;
+
+  /* Deflate the tiles of the region in parallel, the file append below is cheap in comparison. */
+  std::vector<std::vector<uint8_t>> compressed(num_region_tiles);
+  bool failed = false;
+
+  parallel_ranges(num_region_tiles, [&](const int begin, const int end) {
+    for (int i = begin; i < end; i++) {
+      const int x0 = (tx_begin + i % num_region_tiles_x) * spec_.tile_width;
+      const int y0 = (ty_begin + i / num_region_tiles_x) * spec_.tile_height;
+      const int tw = std::min(spec_.tile_width, xend - x0);
+      const int th = std::min(spec_.tile_height, yend - y0);
+
+      /* Gather the tile into a contiguous buffer. */
+      const size_t row_bytes = static_cast<size_t>(tw) * pixel_bytes;
+      std::vector<uint8_t> raw(row_bytes * th);
+      for (int y = 0; y < th; y++) {
+        const char *src = static_cast<const char *>(data) + (y0 + y - ybegin) * ystride +
+                          (x0 - xbegin) * xstride;
+        memcpy(&raw[y * row_bytes], src, row_bytes);
+      }
+
+      std::vector<uint8_t> &out = compressed[i];
+      uLongf compressed_size = compressBound(raw.size());
+      out.resize(compressed_size);
+      if (compress2(out.data(), &compressed_size, raw.data(), raw.size(), Z_DEFAULT_COMPRESSION) !=
+          Z_OK)
+      {
+        failed = true;
+        return;
+      }
+      out.resize(compressed_size);
+    }
+  });
+
+  if (failed) {
+    return false;
+  }
+
+  /* Append the tiles and record their location for the index. */
+  for (int i = 0; i < num_region_tiles; i++) {
+    const int tx = tx_begin + i % num_region_tiles_x;
+    const int ty = ty_begin + i / num_region_tiles_x;
+    const size_t tile_index = static_cast<size_t>(ty) * num_tiles_x_ + tx;
+
+    tile_offsets_[tile_index] = file_offset_;
+    tile_sizes_[tile_index] = compressed[i].size();
+
+    ofs_.write(reinterpret_cast<const char *>(compressed[i].data()), compressed[i].size());
+    file_offset_ += compressed[i].size();
+  }
+
+  return !ofs_.fail();
+}
+
+}
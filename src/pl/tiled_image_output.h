@@ -0,0 +1,74 @@
+/* SPDX-FileCopyrightText: 2025 Primate Labs Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#include "pl/image_output.h"
+
+namespace ccl {
+
+/* Streaming output for the internal tiled image format (.ctf).
+ *
+ * Tiles are deflated in parallel and appended to the file as they arrive, so a big frame never
+ * has to be held in host memory in full. A tile index and the image metadata are written when
+ * the file is closed. The format is an intermediate representation for a single session, not an
+ * interchange format: values are stored in native endianness. */
+
+class TiledImageOutput : public ImageOutput {
+ public:
+  TiledImageOutput();
+
+  virtual ~TiledImageOutput();
+
+  virtual const char *format_name(void) const
+  {
+    return "ctf";
+  }
+
+  virtual int supports(string_view feature) const
+  {
+    return (feature == "tiles");
+  }
+
+  virtual bool open(string_view filename, const ImageSpec &newspec);
+
+  virtual bool close();
+
+  virtual bool write_image(TypeDesc format,
+                           const void *data,
+                           stride_t xstride = AutoStride,
+                           stride_t ystride = AutoStride,
+                           stride_t zstride = AutoStride);
+
+  virtual bool write_tiles(int xbegin,
+                           int xend,
+                           int ybegin,
+                           int yend,
+                           int zbegin,
+                           int zend,
+                           TypeDesc format,
+                           const void *data,
+                           stride_t xstride = AutoStride,
+                           stride_t ystride = AutoStride,
+                           stride_t zstride = AutoStride);
+
+ private:
+  std::ofstream ofs_;
+
+  int num_tiles_x_ = 0;
+  int num_tiles_y_ = 0;
+
+  /* Byte offset and compressed size of each written tile, zero when a tile is absent. */
+  std::vector<uint64_t> tile_offsets_;
+  std::vector<uint64_t> tile_sizes_;
+
+  /* Current append position in the file. */
+  uint64_t file_offset_ = 0;
+};
+
+}
@@ -14,9 +14,12 @@
 #include "scene/scene.h"
 #include "scene/shader.h"
 
+#include <atomic>
+
 #include "util/log.h"
 #include "util/progress.h"
 #include "util/set.h"
+#include "util/task.h"
 #include "util/transform.h"
 #include "util/vector.h"
 
@@ -887,7 +890,11 @@ void AlembicProcedural::generate(Scene *scene, Progress &progress)
     /* We need to reverse the order as overriding archives should come first. */
     std::reverse(filenames.begin(), filenames.end());
 
-    archive = factory.getArchive(filenames);
+    Alembic::AbcCoreFactory::IFactory::CoreType core_type;
+    archive = factory.getArchive(filenames, core_type);
+
+    /* Only the Ogawa backend supports reading from multiple threads. */
+    archive_is_ogawa = (core_type == Alembic::AbcCoreFactory::IFactory::kOgawa);
 
     if (!archive.valid()) {
       /* avoid potential infinite update loops in viewport synchronization */
@@ -1124,8 +1131,7 @@ void AlembicProcedural::read_mesh(AlembicObject *abc_object, Abc::chrono_t frame
   update_attributes(mesh->attributes, cached_data, frame_time);
 
   if (mesh->is_modified()) {
-    const bool need_rebuild = mesh->triangles_is_modified();
-    mesh->tag_update(scene_, need_rebuild);
+    mesh->tag_bvh_update(scene_);
   }
 }
 
@@ -1219,15 +1225,7 @@ void AlembicProcedural::read_subd(AlembicObject *abc_object, Abc::chrono_t frame
   update_attributes(mesh->subd_attributes, cached_data, frame_time);
 
   if (mesh->is_modified()) {
-    const bool need_rebuild = (mesh->triangles_is_modified()) ||
-                              (mesh->subd_num_corners_is_modified()) ||
-                              (mesh->subd_shader_is_modified()) ||
-                              (mesh->subd_smooth_is_modified()) ||
-                              (mesh->subd_ptex_offset_is_modified()) ||
-                              (mesh->subd_start_corner_is_modified()) ||
-                              (mesh->subd_face_corners_is_modified());
-
-    mesh->tag_update(scene_, need_rebuild);
+    mesh->tag_bvh_update(scene_);
   }
 }
 
@@ -1268,8 +1266,9 @@ void AlembicProcedural::read_curves(AlembicObject *abc_object, Abc::chrono_t fra
 
   update_attributes(hair->attributes, cached_data, frame_time);
 
-  const bool rebuild = (hair->curve_keys_is_modified() || hair->curve_radius_is_modified());
-  hair->tag_update(scene_, rebuild);
+  /* Deforming keys and radii only need a refit of the existing BVH, which
+   * tag_bvh_update selects automatically based on the modified sockets. */
+  hair->tag_bvh_update(scene_);
 }
 
 void AlembicProcedural::read_points(AlembicObject *abc_object, Abc::chrono_t frame_time)
@@ -1306,9 +1305,7 @@ void AlembicProcedural::read_points(AlembicObject *abc_object, Abc::chrono_t fra
 
   update_attributes(point_cloud->attributes, cached_data, frame_time);
 
-  const bool rebuild = (point_cloud->points_is_modified() || point_cloud->radius_is_modified() ||
-                        point_cloud->shader_is_modified());
-  point_cloud->tag_update(scene_, rebuild);
+  point_cloud->tag_bvh_update(scene_);
 }
 
 void AlembicProcedural::walk_hierarchy(
@@ -1482,15 +1479,16 @@ void AlembicProcedural::walk_hierarchy(
 
 void AlembicProcedural::build_caches(Progress &progress)
 {
-  size_t memory_used = 0;
-
-  for (Node *node : nodes) {
-    AlembicObject *object = static_cast<AlembicObject *>(node);
+  std::atomic<size_t> memory_used = 0;
 
-    if (progress.get_cancel()) {
-      return;
-    }
+  /* Decode the samples of each object on background threads, the data of
+   * different objects is independent. Only the Ogawa backend supports being
+   * read from multiple threads, other backends keep the serial order. Loaders
+   * check for cancellation as they go, and exceeding the memory limit cancels
+   * through the error, so the budget cuts off parallel loads too. */
+  TaskPool pool;
 
+  const auto build_object_cache = [&](AlembicObject *object) {
     if (object->schema_type == AlembicObject::POLY_MESH) {
       if (!object->has_data_loaded()) {
         IPolyMesh polymesh(object->iobject, Alembic::Abc::kWrapExisting);
@@ -1553,9 +1551,29 @@ void AlembicProcedural::build_caches(Progress &progress)
     if (use_prefetch) {
       if (memory_used > get_prefetch_cache_size_in_bytes()) {
         progress.set_error("Error: Alembic Procedural memory limit reached");
-        return;
       }
     }
+  };
+
+  for (Node *node : nodes) {
+    AlembicObject *object = static_cast<AlembicObject *>(node);
+
+    if (progress.get_cancel()) {
+      break;
+    }
+
+    if (archive_is_ogawa) {
+      pool.push([object, &build_object_cache] { build_object_cache(object); });
+    }
+    else {
+      build_object_cache(object);
+    }
+  }
+
+  pool.wait_work();
+
+  if (progress.get_cancel()) {
+    return;
   }
 
   VLOG_WORK << "AlembicProcedural memory usage : " << string_human_readable_size(memory_used);
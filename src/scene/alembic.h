@@ -460,6 +460,7 @@ class AlembicObject : public Node {
  */
 class AlembicProcedural : public Procedural {
   Alembic::AbcGeom::IArchive archive;
+  bool archive_is_ogawa = false;
   bool objects_loaded = false;
   bool objects_modified = false;
   Scene *scene_ = nullptr;
@@ -511,6 +512,13 @@ class AlembicProcedural : public Procedural {
    * invocation, and updates the data on subsequent invocations if the frame changed. */
   void generate(Scene *scene, Progress &progress) override;
 
+  /* Only creates and updates geometry and objects, so other managers do not need to wait for
+   * generation to finish. */
+  uint dirty_managers() const override
+  {
+    return DIRTY_GEOMETRY | DIRTY_OBJECTS;
+  }
+
   /* Tag for an update only if something was modified. */
   void tag_update(Scene *scene);
 
@@ -453,7 +453,7 @@ AttributeSet::AttributeSet(Geometry *geometry, AttributePrimitive prim)
 
 AttributeSet::~AttributeSet() = default;
 
-Attribute *AttributeSet::add(string name, const TypeDesc type, AttributeElement element)
+Attribute *AttributeSet::add(InternedString name, const TypeDesc type, AttributeElement element)
 {
   Attribute *attr = find(name);
 
@@ -473,7 +473,7 @@ Attribute *AttributeSet::add(string name, const TypeDesc type, AttributeElement
   return &attributes.back();
 }
 
-Attribute *AttributeSet::find(string name) const
+Attribute *AttributeSet::find(InternedString name) const
 {
   for (const Attribute &attr : attributes) {
     if (attr.name == name) {
@@ -484,7 +484,7 @@ Attribute *AttributeSet::find(string name) const
   return nullptr;
 }
 
-void AttributeSet::remove(string name)
+void AttributeSet::remove(InternedString name)
 {
   Attribute *attr = find(name);
 
@@ -804,6 +804,21 @@ bool AttributeSet::modified(AttrKernelDataType kernel_type) const
   return (modified_flag & (1u << kernel_type)) != 0;
 }
 
+bool AttributeSet::modified() const
+{
+  if (modified_flag != 0) {
+    return true;
+  }
+
+  for (const Attribute &attr : attributes) {
+    if (attr.modified) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 /* AttributeRequest */
 
 AttributeRequest::AttributeRequest(string name_)
@@ -857,7 +872,7 @@ bool AttributeRequestSet::modified(const AttributeRequestSet &other)
   return false;
 }
 
-void AttributeRequestSet::add(string name)
+void AttributeRequestSet::add(InternedString name)
 {
   for (const AttributeRequest &req : requests) {
     if (req.name == name) {
@@ -907,7 +922,7 @@ void AttributeRequestSet::add_standard(string name)
   }
 }
 
-bool AttributeRequestSet::find(string name)
+bool AttributeRequestSet::find(InternedString name)
 {
   for (const AttributeRequest &req : requests) {
     if (req.name == name) {
@@ -9,6 +9,7 @@
 #include "kernel/types.h"
 
 #include "pl/type_desc.h"
+#include "util/intern.h"
 #include "util/list.h"
 #include "util/param.h"
 #include "util/set.h"
@@ -44,7 +45,9 @@ enum AttrKernelDataType { FLOAT = 0, FLOAT2 = 1, FLOAT3 = 2, FLOAT4 = 3, UCHAR4
 
 class Attribute {
  public:
-  string name;
+  /* Interned, so that lookups in per-geometry sync loops compare pointers instead of string
+   * contents. */
+  InternedString name;
   AttributeStandard std;
 
   TypeDesc type;
@@ -185,9 +188,9 @@ class AttributeSet {
   AttributeSet(AttributeSet &&) = default;
   ~AttributeSet();
 
-  Attribute *add(string name, const TypeDesc type, AttributeElement element);
-  Attribute *find(string name) const;
-  void remove(string name);
+  Attribute *add(InternedString name, const TypeDesc type, AttributeElement element);
+  Attribute *find(InternedString name) const;
+  void remove(InternedString name);
 
   Attribute *add(AttributeStandard std, string name = string());
   Attribute *find(AttributeStandard std) const;
@@ -215,6 +218,10 @@ class AttributeSet {
    * check this, use Attribute.modified. */
   bool modified(AttrKernelDataType kernel_type) const;
 
+  /* Return whether the data of any attribute in this set was modified, which also covers in-place
+   * data updates that do not require a reallocation and so leave modified_flag untouched. */
+  bool modified() const;
+
   void clear_modified();
 
  private:
@@ -231,7 +238,7 @@ class AttributeSet {
 
 class AttributeRequest {
  public:
-  string name;
+  InternedString name;
   AttributeStandard std;
 
   /* temporary variables used by GeometryManager */
@@ -253,12 +260,12 @@ class AttributeRequestSet {
   AttributeRequestSet();
   ~AttributeRequestSet();
 
-  void add(string name);
+  void add(InternedString name);
   void add(AttributeStandard std);
   void add(AttributeRequestSet &reqs);
   void add_standard(string name);
 
-  bool find(string name);
+  bool find(InternedString name);
   bool find(AttributeStandard std);
 
   size_t size();
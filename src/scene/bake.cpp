@@ -74,16 +74,23 @@ void BakeManager::device_update(Device * /*device*/,
     kbake->use = true;
 
     int object_index = 0;
+    int num_targets = 0;
     for (Object *object : scene->objects) {
       const Geometry *geom = object->get_geometry();
       if (object->get_is_bake_target() && geom->is_mesh()) {
-        kbake->object_index = object_index;
-        kbake->tri_offset = geom->prim_offset;
-        break;
+        if (num_targets == 0) {
+          kbake->object_index = object_index;
+          kbake->tri_offset = geom->prim_offset;
+        }
+        num_targets++;
       }
 
       object_index++;
     }
+
+    /* With multiple bake targets in one session the object is read per texel from the bake
+     * primitive pass, so small bakes can share one device and scene setup. */
+    kbake->use_object_pass = (num_targets > 1);
   }
 
   need_update_ = false;
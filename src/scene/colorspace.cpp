@@ -5,11 +5,11 @@
 #include "scene/colorspace.h"
 
 #include "util/color.h"
+#include "util/concurrent_map.h"
 #include "util/image.h"
 #include "util/log.h"
-#include "util/map.h"
 #include "util/math.h"
-#include "util/thread.h"
+#include "util/tbb.h"
 #include "util/vector.h"
 
 #ifdef WITH_OCIO
@@ -24,12 +24,24 @@ string u_colorspace_auto;
 string u_colorspace_raw("__builtin_raw");
 string u_colorspace_srgb("__builtin_srgb");
 
-/* Cached data. */
+/* Cached data. Concurrent maps so that parallel image loading and shader
+ * compilation do not serialize on the lookups. */
 #ifdef WITH_OCIO
-static thread_mutex cache_colorspaces_mutex;
-static thread_mutex cache_processors_mutex;
-static unordered_map<string, string> cached_colorspaces;
-static unordered_map<string, OCIO::ConstProcessorRcPtr> cached_processors;
+static concurrent_unordered_map<string, string> cached_colorspaces;
+static concurrent_unordered_map<string, OCIO::ConstProcessorRcPtr> cached_processors;
+static concurrent_unordered_map<const OCIO::Processor *, OCIO::ConstCPUProcessorRcPtr>
+    cached_cpu_processors;
+
+/* Building the CPU processor finalizes and optimizes the transform, which is too expensive to
+ * redo for every image or pixel the processor is applied to. */
+static OCIO::ConstCPUProcessorRcPtr get_cpu_processor(const OCIO::Processor *processor)
+{
+  auto it = cached_cpu_processors.find(processor);
+  if (it == cached_cpu_processors.end()) {
+    it = cached_cpu_processors.emplace(processor, processor->getDefaultCPUProcessor()).first;
+  }
+  return it->second;
+}
 #endif
 
 ColorSpaceProcessor *ColorSpaceManager::get_processor(string colorspace)
@@ -56,21 +68,22 @@ ColorSpaceProcessor *ColorSpaceManager::get_processor(string colorspace)
   }
 
   /* Cache processor until free_memory(), memory overhead is expected to be
-   * small and the processor is likely to be reused. */
-  const thread_scoped_lock cache_processors_lock(cache_processors_mutex);
-  if (cached_processors.find(colorspace) == cached_processors.end()) {
+   * small and the processor is likely to be reused. Threads racing on the
+   * same colorspace may create the processor twice, the map keeps the first. */
+  auto it = cached_processors.find(colorspace);
+  if (it == cached_processors.end()) {
+    OCIO::ConstProcessorRcPtr processor;
     try {
-      cached_processors[colorspace] = config->getProcessor(colorspace.c_str(), "scene_linear");
+      processor = config->getProcessor(colorspace.c_str(), "scene_linear");
     }
     catch (const OCIO::Exception &exception) {
-      cached_processors[colorspace] = OCIO::ConstProcessorRcPtr();
       VLOG_WARNING << "Colorspace " << colorspace.c_str()
                    << " can't be converted to scene_linear: " << exception.what();
     }
+    it = cached_processors.emplace(colorspace, processor).first;
   }
 
-  const OCIO::Processor *processor = cached_processors[colorspace].get();
-  return (ColorSpaceProcessor *)processor;
+  return (ColorSpaceProcessor *)it->second.get();
 #else
   /* No OpenColorIO. */
   (void)colorspace;
@@ -139,10 +152,10 @@ string ColorSpaceManager::detect_known_colorspace(string colorspace,
   /* Use OpenColorIO. */
 #ifdef WITH_OCIO
   {
-    const thread_scoped_lock cache_lock(cache_colorspaces_mutex);
     /* Cached lookup. */
-    if (cached_colorspaces.find(colorspace) != cached_colorspaces.end()) {
-      return cached_colorspaces[colorspace];
+    const auto it = cached_colorspaces.find(colorspace);
+    if (it != cached_colorspaces.end()) {
+      return it->second;
     }
   }
 
@@ -151,15 +164,14 @@ string ColorSpaceManager::detect_known_colorspace(string colorspace,
   bool is_srgb;
   is_builtin_colorspace(colorspace, is_scene_linear, is_srgb);
 
-  const thread_scoped_lock cache_lock(cache_colorspaces_mutex);
   if (is_scene_linear) {
-    VLOG_INFO << "Colorspace " << colorspace.string() << " is no-op";
-    cached_colorspaces[colorspace] = u_colorspace_raw;
+    VLOG_INFO << "Colorspace " << colorspace << " is no-op";
+    cached_colorspaces.emplace(colorspace, u_colorspace_raw);
     return u_colorspace_raw;
   }
   if (is_srgb) {
-    VLOG_INFO << "Colorspace " << colorspace.string() << " is sRGB";
-    cached_colorspaces[colorspace] = u_colorspace_srgb;
+    VLOG_INFO << "Colorspace " << colorspace << " is sRGB";
+    cached_colorspaces.emplace(colorspace, u_colorspace_srgb);
     return u_colorspace_srgb;
   }
 
@@ -181,13 +193,13 @@ string ColorSpaceManager::detect_known_colorspace(string colorspace,
       VLOG_WARNING << "Colorspace " << colorspace.c_str()
                    << " can't be converted to scene_linear, using raw instead";
     }
-    cached_colorspaces[colorspace] = u_colorspace_raw;
+    cached_colorspaces.emplace(colorspace, u_colorspace_raw);
     return u_colorspace_raw;
   }
 
   /* Convert to/from colorspace with OpenColorIO. */
-  VLOG_INFO << "Colorspace " << colorspace.string() << " handled through OpenColorIO";
-  cached_colorspaces[colorspace] = colorspace;
+  VLOG_INFO << "Colorspace " << colorspace << " handled through OpenColorIO";
+  cached_colorspaces.emplace(colorspace, colorspace);
   return colorspace;
 #else
   VLOG_WARNING << "Colorspace " << colorspace.c_str()
@@ -208,7 +220,7 @@ void ColorSpaceManager::is_builtin_colorspace(string colorspace,
     return;
   }
 
-  const OCIO::ConstCPUProcessorRcPtr device_processor = processor->getDefaultCPUProcessor();
+  const OCIO::ConstCPUProcessorRcPtr device_processor = get_cpu_processor(processor);
   is_scene_linear = true;
   is_srgb = true;
   for (int i = 0; i < 256; i++) {
@@ -288,14 +300,21 @@ inline void processor_apply_pixels_rgba(const OCIO::Processor *processor,
   /* TODO: implement faster version for when we know the conversion
    * is a simple matrix transform between linear spaces. In that case
    * un-premultiply is not needed. */
-  const OCIO::ConstCPUProcessorRcPtr device_processor = processor->getDefaultCPUProcessor();
+  if (num_pixels == 0) {
+    return;
+  }
+
+  const OCIO::ConstCPUProcessorRcPtr device_processor = get_cpu_processor(processor);
 
-  /* Process large images in chunks to keep temporary memory requirement down. */
-  const size_t chunk_size = std::min((size_t)(16 * 1024 * 1024), num_pixels);
-  vector<float4> float_pixels(chunk_size);
+  /* Process chunks in parallel, the CPU processor is thread-safe. Chunks are small enough to
+   * keep the temporary memory requirement down, and large enough to amortize the apply setup. */
+  const size_t chunk_size = std::min((size_t)(64 * 1024), num_pixels);
+  const size_t num_chunks = (num_pixels + chunk_size - 1) / chunk_size;
 
-  for (size_t j = 0; j < num_pixels; j += chunk_size) {
+  parallel_for((size_t)0, num_chunks, [&](const size_t chunk) {
+    const size_t j = chunk * chunk_size;
     const size_t width = std::min(chunk_size, num_pixels - j);
+    vector<float4> float_pixels(width);
 
     for (size_t i = 0; i < width; i++) {
       float4 value = cast_to_float4(pixels + 4 * (j + i));
@@ -328,7 +347,7 @@ inline void processor_apply_pixels_rgba(const OCIO::Processor *processor,
 
       cast_from_float4(pixels + 4 * (j + i), value);
     }
-  }
+  });
 }
 
 template<typename T, bool compress_as_srgb = false>
@@ -336,14 +355,21 @@ inline void processor_apply_pixels_grayscale(const OCIO::Processor *processor,
                                              T *pixels,
                                              const size_t num_pixels)
 {
-  const OCIO::ConstCPUProcessorRcPtr device_processor = processor->getDefaultCPUProcessor();
+  if (num_pixels == 0) {
+    return;
+  }
 
-  /* Process large images in chunks to keep temporary memory requirement down. */
-  const size_t chunk_size = std::min((size_t)(16 * 1024 * 1024), num_pixels);
-  vector<float> float_pixels(chunk_size * 3);
+  const OCIO::ConstCPUProcessorRcPtr device_processor = get_cpu_processor(processor);
 
-  for (size_t j = 0; j < num_pixels; j += chunk_size) {
+  /* Process chunks in parallel, the CPU processor is thread-safe. Chunks are small enough to
+   * keep the temporary memory requirement down, and large enough to amortize the apply setup. */
+  const size_t chunk_size = std::min((size_t)(64 * 1024), num_pixels);
+  const size_t num_chunks = (num_pixels + chunk_size - 1) / chunk_size;
+
+  parallel_for((size_t)0, num_chunks, [&](const size_t chunk) {
+    const size_t j = chunk * chunk_size;
     const size_t width = std::min(chunk_size, num_pixels - j);
+    vector<float> float_pixels(width * 3);
 
     /* Convert to 3 channels, since that's the minimum required by OpenColorIO. */
     {
@@ -371,7 +397,7 @@ inline void processor_apply_pixels_grayscale(const OCIO::Processor *processor,
         *pixel = util_image_cast_from_float<T>(f);
       }
     }
-  }
+  });
 }
 
 #endif
@@ -422,7 +448,7 @@ void ColorSpaceManager::to_scene_linear(ColorSpaceProcessor *processor_,
   const OCIO::Processor *processor = (const OCIO::Processor *)processor_;
 
   if (processor) {
-    const OCIO::ConstCPUProcessorRcPtr device_processor = processor->getDefaultCPUProcessor();
+    const OCIO::ConstCPUProcessorRcPtr device_processor = get_cpu_processor(processor);
     if (channels == 1) {
       float3 rgb = make_float3(pixel[0], pixel[0], pixel[0]);
       device_processor->applyRGB(&rgb.x);
@@ -464,8 +490,10 @@ void ColorSpaceManager::to_scene_linear(ColorSpaceProcessor *processor_,
 void ColorSpaceManager::free_memory()
 {
 #ifdef WITH_OCIO
-  map_free_memory(cached_colorspaces);
-  map_free_memory(cached_processors);
+  /* Not concurrency-safe, only call when no other threads use the caches. */
+  cached_colorspaces.clear();
+  cached_processors.clear();
+  cached_cpu_processors.clear();
 #endif
 }
 
@@ -29,9 +29,12 @@ DeviceScene::DeviceScene(Device *device)
       objects(device, "objects", MEM_GLOBAL),
       object_motion_pass(device, "object_motion_pass", MEM_GLOBAL),
       object_motion(device, "object_motion", MEM_GLOBAL),
+      object_motion_lerp(device, "object_motion_lerp", MEM_GLOBAL),
       object_flag(device, "object_flag", MEM_GLOBAL),
       object_volume_step(device, "object_volume_step", MEM_GLOBAL),
       object_prim_offset(device, "object_prim_offset", MEM_GLOBAL),
+      volume_occupancy(device, "volume_occupancy", MEM_GLOBAL),
+      volume_occupancy_bits(device, "volume_occupancy_bits", MEM_GLOBAL),
       camera_motion(device, "camera_motion", MEM_GLOBAL),
       attributes_map(device, "attributes_map", MEM_GLOBAL),
       attributes_float(device, "attributes_float", MEM_GLOBAL),
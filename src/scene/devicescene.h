@@ -41,10 +41,15 @@ class DeviceScene {
   device_vector<KernelObject> objects;
   device_vector<Transform> object_motion_pass;
   device_vector<DecomposedTransform> object_motion;
+  device_vector<Transform> object_motion_lerp;
   device_vector<uint> object_flag;
   device_vector<float> object_volume_step;
   device_vector<uint> object_prim_offset;
 
+  /* volumes */
+  device_vector<KernelVolumeOccupancy> volume_occupancy;
+  device_vector<uint> volume_occupancy_bits;
+
   /* cameras */
   device_vector<DecomposedTransform> camera_motion;
 
@@ -39,7 +39,7 @@ static float filter_func_blackman_harris(float v, const float width)
   return 0.35875f - 0.48829f * cosf(v) + 0.14128f * cosf(2.0f * v) - 0.01168f * cosf(3.0f * v);
 }
 
-static vector<float> filter_table(FilterType type, float width)
+static vector<float> compute_filter_table(FilterType type, float width)
 {
   vector<float> filter_table(FILTER_TABLE_SIZE);
   float (*filter_func)(float, float) = nullptr;
@@ -82,6 +82,52 @@ static vector<float> filter_table(FilterType type, float width)
   return filter_table;
 }
 
+/* Tables for the standard filter widths, computed once and shared by all films for the lifetime
+ * of the process. Most scenes use a filter at its default width, so repeated film updates (and
+ * scenes with several views) skip the importance table integration entirely. */
+struct PrecomputedFilterTables {
+  struct Entry {
+    FilterType type;
+    float width;
+    vector<float> table;
+  };
+
+  vector<Entry> entries;
+
+  PrecomputedFilterTables()
+  {
+    const float standard_widths[] = {0.5f, 1.0f, 1.5f, 2.0f};
+    for (const FilterType type : {FILTER_BOX, FILTER_GAUSSIAN, FILTER_BLACKMAN_HARRIS}) {
+      for (const float width : standard_widths) {
+        entries.push_back({type, width, compute_filter_table(type, width)});
+      }
+    }
+  }
+
+  const vector<float> *find(FilterType type, const float width) const
+  {
+    for (const Entry &entry : entries) {
+      if (entry.type == type && entry.width == width) {
+        return &entry.table;
+      }
+    }
+    return nullptr;
+  }
+};
+
+static vector<float> filter_table(FilterType type, float width)
+{
+  /* Initialized on first use rather than at load time, so that processes which never render do
+   * not pay for the tables. */
+  static const PrecomputedFilterTables precomputed;
+
+  if (const vector<float> *table = precomputed.find(type, width)) {
+    return *table;
+  }
+
+  return compute_filter_table(type, width);
+}
+
 /* Film */
 
 NODE_DEFINE(Film)
@@ -149,6 +195,12 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
 
   KernelFilm *kfilm = &dscene->data.film;
 
+  /* Number of floats the pass occupies in the render buffer, taking per-pass half
+   * precision accumulation into account. */
+  auto pass_buffer_components = [](const Pass *pass) {
+    return pass_num_buffer_components(pass->get_info(), pass->get_accumulate_half());
+  };
+
   /* update data */
   kfilm->exposure = exposure;
   kfilm->pass_alpha_threshold = pass_alpha_threshold;
@@ -215,14 +267,14 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
     if (pass->get_mode() == PassMode::DENOISED) {
       /* Generally we only storing offsets of the noisy passes. The display pass is an exception
        * since it is a read operation and not a write. */
-      kfilm->pass_stride += pass->get_info().num_components;
+      kfilm->pass_stride += pass_buffer_components(pass);
       continue;
     }
 
     /* Can't do motion pass if no motion vectors are available. */
     if (pass->get_type() == PASS_MOTION || pass->get_type() == PASS_MOTION_WEIGHT) {
       if (scene->need_motion() != Scene::MOTION_PASS) {
-        kfilm->pass_stride += pass->get_info().num_components;
+        kfilm->pass_stride += pass_buffer_components(pass);
         continue;
       }
     }
@@ -243,7 +295,7 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
         kfilm->pass_lightgroup = kfilm->pass_stride;
         have_lightgroup = true;
       }
-      kfilm->pass_stride += pass->get_info().num_components;
+      kfilm->pass_stride += pass_buffer_components(pass);
       continue;
     }
 
@@ -396,13 +448,19 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
         break;
     }
 
-    kfilm->pass_stride += pass->get_info().num_components;
+    kfilm->pass_stride += pass_buffer_components(pass);
   }
 
-  /* update filter table */
-  vector<float> table = filter_table(filter_type, filter_width);
-  scene->lookup_tables->remove_table(&filter_table_offset_);
-  filter_table_offset_ = scene->lookup_tables->add_table(dscene, table);
+  /* Update filter table. Only regenerate it when the filter settings changed; other film
+   * modifications (exposure, passes, ...) keep the existing table and do not need to touch the
+   * lookup-table allocator at all. */
+  if (filter_table_offset_ == TABLE_OFFSET_INVALID || filter_type_is_modified() ||
+      filter_width_is_modified())
+  {
+    vector<float> table = filter_table(filter_type, filter_width);
+    scene->lookup_tables->remove_table(&filter_table_offset_);
+    filter_table_offset_ = scene->lookup_tables->add_table(dscene, table);
+  }
   dscene->data.tables.filter_table_offset = (int)filter_table_offset_;
 
   /* mist pass parameters */
@@ -421,7 +479,7 @@ void Film::device_free(Device * /*device*/, DeviceScene * /*dscene*/, Scene *sce
   scene->lookup_tables->remove_table(&filter_table_offset_);
 }
 
-int Film::get_aov_offset(Scene *scene, string name, bool &is_color)
+int Film::get_aov_offset(Scene *scene, string name, bool &is_color, bool &is_half)
 {
   int offset_color = 0;
   int offset_value = 0;
@@ -429,19 +487,21 @@ int Film::get_aov_offset(Scene *scene, string name, bool &is_color)
     if (pass->get_name() == name) {
       if (pass->get_type() == PASS_AOV_VALUE) {
         is_color = false;
+        is_half = false;
         return offset_value;
       }
       if (pass->get_type() == PASS_AOV_COLOR) {
         is_color = true;
+        is_half = pass->get_accumulate_half() && pass->get_info().support_half_accumulation;
         return offset_color;
       }
     }
 
     if (pass->get_type() == PASS_AOV_VALUE) {
-      offset_value += pass->get_info().num_components;
+      offset_value += pass_num_buffer_components(pass->get_info(), pass->get_accumulate_half());
     }
     else if (pass->get_type() == PASS_AOV_COLOR) {
-      offset_color += pass->get_info().num_components;
+      offset_color += pass_num_buffer_components(pass->get_info(), pass->get_accumulate_half());
     }
   }
 
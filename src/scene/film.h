@@ -66,7 +66,7 @@ class Film : public Node {
   void device_update(Device *device, DeviceScene *dscene, Scene *scene);
   void device_free(Device *device, DeviceScene *dscene, Scene *scene);
 
-  int get_aov_offset(Scene *scene, string name, bool &is_color);
+  int get_aov_offset(Scene *scene, string name, bool &is_color, bool &is_half);
 
   bool update_lightgroups(Scene *scene);
 
@@ -6,6 +6,8 @@
 
 #include "device/device.h"
 
+#include "integrator/shader_eval.h"
+
 #include "scene/attribute.h"
 #include "scene/camera.h"
 #include "scene/geometry.h"
@@ -28,6 +30,8 @@
 #endif
 
 #include "util/log.h"
+#include "util/fasthash.h"
+#include "util/profiling.h"
 #include "util/progress.h"
 #include "util/task.h"
 
@@ -56,6 +60,7 @@ Geometry::Geometry(const NodeType *node_type, const Type type)
   transform_negative_scaled = false;
   transform_normal = transform_identity();
   bounds = BoundBox::empty;
+  bvh_build_bounds = BoundBox::empty;
 
   has_volume = false;
   has_surface_bssrdf = false;
@@ -144,6 +149,16 @@ bool Geometry::has_motion_blur() const
   return (use_motion_blur && attributes.find(ATTR_STD_MOTION_VERTEX_POSITION));
 }
 
+bool Geometry::bvh_topology_modified() const
+{
+  return true;
+}
+
+void Geometry::tag_bvh_update(Scene *scene)
+{
+  tag_update(scene, bvh_topology_modified());
+}
+
 void Geometry::tag_update(Scene *scene, bool rebuild)
 {
   if (rebuild) {
@@ -327,12 +342,108 @@ void GeometryManager::geom_calc_offset(Scene *scene, BVHLayout bvh_layout)
   }
 }
 
+static bool mesh_attributes_equal(const AttributeSet &a, const AttributeSet &b)
+{
+  if (a.attributes.size() != b.attributes.size()) {
+    return false;
+  }
+
+  auto b_it = b.attributes.begin();
+  for (const Attribute &attr_a : a.attributes) {
+    const Attribute &attr_b = *b_it++;
+    if (attr_a.name != attr_b.name || attr_a.std != attr_b.std || attr_a.type != attr_b.type ||
+        attr_a.element != attr_b.element || attr_a.buffer.size() != attr_b.buffer.size() ||
+        memcmp(attr_a.buffer.data(), attr_b.buffer.data(), attr_a.buffer.size()) != 0)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool mesh_content_equal(Mesh *a, Mesh *b)
+{
+  return a->equals(*b) && mesh_attributes_equal(a->attributes, b->attributes) &&
+         mesh_attributes_equal(a->subd_attributes, b->subd_attributes);
+}
+
+void GeometryManager::deduplicate_meshes(Scene *scene)
+{
+  /* Collapse meshes with identical content into a single geometry, so that
+   * importers which create one mesh per object still render instanced. Objects
+   * referencing a duplicate are relinked to the first mesh with the same
+   * content, and the duplicate is removed from the scene. */
+
+  /* Group meshes by a hash over all socket values, and verify matches within a
+   * group since the hash could in principle collide. */
+  map<string, vector<Mesh *>> candidates;
+  map<Geometry *, Geometry *> replaced;
+
+  for (Geometry *geom : scene->geometry) {
+    if (!geom->is_mesh() || geom->is_volume()) {
+      continue;
+    }
+
+    Mesh *mesh = static_cast<Mesh *>(geom);
+
+    /* Voxel attributes reference images rather than plain data, and baked in
+     * transforms are not part of the socket values. */
+    if (mesh->get_verts().empty() || mesh->has_voxel_attributes() || mesh->transform_applied) {
+      continue;
+    }
+
+    FastHash hash;
+    mesh->hash(hash);
+
+    vector<Mesh *> &bucket = candidates[hash.get_hex()];
+
+    Mesh *match = nullptr;
+    for (Mesh *other : bucket) {
+      if (mesh_content_equal(mesh, other)) {
+        match = other;
+        break;
+      }
+    }
+
+    if (match) {
+      replaced[mesh] = match;
+    }
+    else {
+      bucket.push_back(mesh);
+    }
+  }
+
+  if (replaced.empty()) {
+    return;
+  }
+
+  for (Object *object : scene->objects) {
+    const auto it = replaced.find(object->get_geometry());
+    if (it != replaced.end()) {
+      object->set_geometry(it->second);
+    }
+  }
+
+  for (const pair<Geometry *const, Geometry *> &entry : replaced) {
+    scene->delete_node(static_cast<Mesh *>(entry.first));
+  }
+
+  VLOG_INFO << "Merged " << replaced.size() << " duplicate meshes into instances.";
+}
+
 void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Progress &progress)
 {
   if (!need_update() && !need_flags_update) {
     return;
   }
 
+  /* Detect newly synced meshes which duplicate the content of another one, and
+   * turn them into instances before any of them gets packed or a BVH built. */
+  if (update_flags & MESH_ADDED) {
+    deduplicate_meshes(scene);
+  }
+
   uint32_t device_update_flags = 0;
 
   const scoped_callback_timer timer([scene](double time) {
@@ -345,6 +456,7 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
 
   /* Update flags. */
   bool volume_images_updated = false;
+  vector<Volume *> volumes_to_build;
 
   for (Geometry *geom : scene->geometry) {
     geom->has_volume = false;
@@ -422,8 +534,7 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
         volume_images_updated = true;
       }
 
-      Volume *volume = static_cast<Volume *>(geom);
-      create_volume_mesh(scene, volume, progress);
+      volumes_to_build.push_back(static_cast<Volume *>(geom));
 
       /* always reallocate when we have a volume, as we need to rebuild the BVH */
       device_update_flags |= DEVICE_MESH_DATA_NEEDS_REALLOC;
@@ -465,6 +576,17 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
     }
   }
 
+  /* Build volume bounding meshes concurrently. Each build only writes to its
+   * own volume, the grids are only read, and the image manager guards its slots
+   * with a mutex for the merged velocity attribute. */
+  if (!volumes_to_build.empty()) {
+    TaskPool pool;
+    for (Volume *volume : volumes_to_build) {
+      pool.push([this, scene, volume, &progress] { create_volume_mesh(scene, volume, progress); });
+    }
+    pool.wait_work();
+  }
+
   if (update_flags & (MESH_ADDED | MESH_REMOVED)) {
     device_update_flags |= DEVICE_MESH_DATA_NEEDS_REALLOC;
   }
@@ -692,6 +814,8 @@ void GeometryManager::device_update(Device *device,
     return;
   }
 
+  const scoped_trace trace("geometry device_update");
+
   VLOG_INFO << "Total " << scene->geometry.size() << " meshes.";
 
   bool true_displacement_used = false;
@@ -770,6 +894,10 @@ void GeometryManager::device_update(Device *device,
     dicing_camera->update(scene);
   }
 
+  /* Tessellate meshes in parallel. Each mesh only modifies its own data, and
+   * the dicing camera is read-only once updated above. */
+  TaskPool tessellation_pool;
+
   size_t i = 0;
   for (Geometry *geom : scene->geometry) {
     if (!(geom->is_modified() && geom->is_mesh())) {
@@ -788,18 +916,38 @@ void GeometryManager::device_update(Device *device,
             "%s %u/%u", mesh->name.c_str(), (uint)(i + 1), (uint)num_tessellation);
       }
 
-      progress.set_status("Updating Mesh", msg);
+      tessellation_pool.push([mesh, dicing_camera, msg, &progress] {
+        if (progress.get_cancel()) {
+          return;
+        }
 
-      SubdParams subd_params(mesh);
-      subd_params.dicing_rate = mesh->get_subd_dicing_rate();
-      subd_params.max_level = mesh->get_subd_max_level();
-      subd_params.objecttoworld = mesh->get_subd_objecttoworld();
-      subd_params.camera = dicing_camera;
+        progress.set_status("Updating Mesh", msg);
 
-      mesh->tessellate(subd_params);
+        SubdParams subd_params(mesh);
+        subd_params.dicing_rate = mesh->get_subd_dicing_rate();
+        subd_params.max_level = mesh->get_subd_max_level();
+        subd_params.objecttoworld = mesh->get_subd_objecttoworld();
+        subd_params.camera = dicing_camera;
+
+        mesh->tessellate(subd_params);
+      });
 
       i++;
     }
+  }
+
+  tessellation_pool.wait_work();
+
+  if (progress.get_cancel()) {
+    return;
+  }
+
+  for (Geometry *geom : scene->geometry) {
+    if (!(geom->is_modified() && geom->is_mesh())) {
+      continue;
+    }
+
+    Mesh *mesh = static_cast<Mesh *>(geom);
 
     /* Apply generated attribute if needed or remove if not needed */
     mesh->update_generated(scene);
@@ -864,6 +1012,64 @@ void GeometryManager::device_update(Device *device,
     return;
   }
 
+  /* Update the BVH even when there is no geometry so the kernel's BVH data is still valid,
+   * especially when removing all of the objects during interactive renders.
+   * Also update the BVH if the transformations change, we cannot rely on tagging the Geometry
+   * as modified in this case, as we may accumulate displacement if the vertices do not also
+   * change. */
+  bool need_update_scene_bvh = (scene->bvh == nullptr ||
+                                (update_flags & (TRANSFORM_MODIFIED | VISIBILITY_MODIFIED)) != 0);
+
+  /* Work around Embree/oneAPI bug #129596 with BVH updates. */
+  const bool use_multithreaded_build = first_bvh_build ||
+                                       !device->info.contains_device_type(DEVICE_ONEAPI);
+  first_bvh_build = false;
+
+  /* Host side builders (BVH2 packing, Embree scene commits) never touch
+   * device memory, so their work can overlap attribute packing and uploads.
+   * Large rtcCommitScene calls otherwise serialize against the copies and
+   * leave them waiting. Device-side builders keep the previous ordering. */
+  const bool overlap_bvh_build = use_multithreaded_build &&
+                                 (bvh_layout == BVH_LAYOUT_BVH2 ||
+                                  bvh_layout == BVH_LAYOUT_EMBREE);
+
+  TaskPool bvh_pool;
+
+  const auto launch_object_bvh_builds = [&]() {
+    size_t i = 0;
+    size_t num_bvh = 0;
+    for (Geometry *geom : scene->geometry) {
+      if (geom->is_modified() || geom->need_update_bvh_for_offset) {
+        need_update_scene_bvh = true;
+
+        if (geom->need_build_bvh(bvh_layout)) {
+          i++;
+          num_bvh++;
+        }
+
+        if (use_multithreaded_build) {
+          bvh_pool.push([geom, device, dscene, scene, &progress, i, &num_bvh] {
+            geom->compute_bvh(device, dscene, &scene->params, &progress, i, num_bvh);
+          });
+        }
+        else {
+          geom->compute_bvh(device, dscene, &scene->params, &progress, i, num_bvh);
+        }
+      }
+    }
+  };
+
+  /* Without displacement the vertices are already final at this point, so host side object BVH
+   * builds can start right away and overlap the attribute packing and upload below. With
+   * displacement they have to wait for the displaced vertices and instead overlap the attribute
+   * re-upload afterwards. */
+  const bool overlap_attribute_update = overlap_bvh_build && !true_displacement_used &&
+                                        !curve_shadow_transparency_used;
+
+  if (overlap_attribute_update) {
+    launch_object_bvh_builds();
+  }
+
   {
     const scoped_callback_timer timer([scene](double time) {
       if (scene->update_stats) {
@@ -890,19 +1096,20 @@ void GeometryManager::device_update(Device *device,
       }
     });
 
+    /* Queue evaluations for all modified geometry, then execute them batched
+     * per kernel type, to amortize dispatch overhead over many small meshes. */
+    ShaderEval shader_eval(device, progress);
+
     for (Geometry *geom : scene->geometry) {
       if (geom->is_modified()) {
         if (geom->is_mesh()) {
           Mesh *mesh = static_cast<Mesh *>(geom);
-          if (displace(device, scene, mesh, progress)) {
-            displacement_done = true;
-          }
+          displace(shader_eval, scene, mesh, progress, displacement_done);
         }
         else if (geom->is_hair()) {
           Hair *hair = static_cast<Hair *>(geom);
-          if (hair->update_shadow_transparency(device, scene, progress)) {
-            curve_shadow_transparency_done = true;
-          }
+          hair->update_shadow_transparency(
+              shader_eval, scene, progress, curve_shadow_transparency_done);
         }
       }
 
@@ -910,12 +1117,18 @@ void GeometryManager::device_update(Device *device,
         return;
       }
     }
+
+    shader_eval.eval_queued();
   }
 
   if (progress.get_cancel()) {
     return;
   }
 
+  if (overlap_bvh_build && !overlap_attribute_update) {
+    launch_object_bvh_builds();
+  }
+
   /* Device re-update after applying transforms and displacement. */
   if (displacement_done || curve_shadow_transparency_done) {
     const scoped_callback_timer timer([scene](double time) {
@@ -932,50 +1145,19 @@ void GeometryManager::device_update(Device *device,
     }
   }
 
-  /* Update the BVH even when there is no geometry so the kernel's BVH data is still valid,
-   * especially when removing all of the objects during interactive renders.
-   * Also update the BVH if the transformations change, we cannot rely on tagging the Geometry
-   * as modified in this case, as we may accumulate displacement if the vertices do not also
-   * change. */
-  bool need_update_scene_bvh = (scene->bvh == nullptr ||
-                                (update_flags & (TRANSFORM_MODIFIED | VISIBILITY_MODIFIED)) != 0);
   {
     const scoped_callback_timer timer([scene](double time) {
       if (scene->update_stats) {
         scene->update_stats->geometry.times.add_entry({"device_update (build object BVHs)", time});
       }
     });
-    TaskPool pool;
-
-    /* Work around Embree/oneAPI bug #129596 with BVH updates. */
-    const bool use_multithreaded_build = first_bvh_build ||
-                                         !device->info.contains_device_type(DEVICE_ONEAPI);
-    first_bvh_build = false;
 
-    size_t i = 0;
-    size_t num_bvh = 0;
-    for (Geometry *geom : scene->geometry) {
-      if (geom->is_modified() || geom->need_update_bvh_for_offset) {
-        need_update_scene_bvh = true;
-
-        if (geom->need_build_bvh(bvh_layout)) {
-          i++;
-          num_bvh++;
-        }
-
-        if (use_multithreaded_build) {
-          pool.push([geom, device, dscene, scene, &progress, i, &num_bvh] {
-            geom->compute_bvh(device, dscene, &scene->params, &progress, i, num_bvh);
-          });
-        }
-        else {
-          geom->compute_bvh(device, dscene, &scene->params, &progress, i, num_bvh);
-        }
-      }
+    if (!overlap_bvh_build) {
+      launch_object_bvh_builds();
     }
 
     TaskPool::Summary summary;
-    pool.wait_work(&summary);
+    bvh_pool.wait_work(&summary);
     VLOG_WORK << "Objects BVH build pool statistics:\n" << summary.full_report();
   }
 
@@ -27,6 +27,7 @@ class RenderStats;
 class Scene;
 class SceneParams;
 class Shader;
+class ShaderEval;
 class Volume;
 struct PackedBVH;
 
@@ -104,6 +105,10 @@ class Geometry : public Node {
   size_t attr_map_offset;
   size_t prim_offset;
 
+  /* Bounds the BVH was last fully built for, used to decide between refit
+   * and rebuild when only vertex positions deformed. */
+  BoundBox bvh_build_bounds;
+
   /* Shader Properties */
   bool has_volume;         /* Set in the device_update_flags(). */
   bool has_surface_bssrdf; /* Set in the device_update_flags(). */
@@ -166,6 +171,17 @@ class Geometry : public Node {
   virtual bool has_motion_blur() const;
   bool has_voxel_attributes() const;
 
+  /* Check whether modified sockets change the primitive topology, in which
+   * case the BVH needs a full rebuild. Deformation-only changes keep the tree
+   * structure valid and only need bounds to be refit. Conservatively returns
+   * true for geometry types which do not implement the check. */
+  virtual bool bvh_topology_modified() const;
+
+  /* Tag for update after socket changes, choosing automatically between a
+   * refit of the existing BVH and a full rebuild based on whether only
+   * position-style data changed. */
+  void tag_bvh_update(Scene *scene);
+
   bool is_mesh() const
   {
     return geometry_type == MESH;
@@ -251,7 +267,18 @@ class GeometryManager {
   void collect_statistics(const Scene *scene, RenderStats *stats);
 
  protected:
-  bool displace(Device *device, Scene *scene, Mesh *mesh, Progress &progress);
+  /* Collapse newly synced meshes with identical content into instances. */
+  void deduplicate_meshes(Scene *scene);
+
+  /* Queue displacement shader evaluation, batched with other geometry. The read
+   * callback applies the offsets and sets displacement_done. */
+  void displace(ShaderEval &shader_eval,
+                Scene *scene,
+                Mesh *mesh,
+                Progress &progress,
+                bool &displacement_done);
+
+  void displace_update_normals(const Scene *scene, Mesh *mesh);
 
   void create_volume_mesh(const Scene *scene, Volume *volume, Progress &progress);
 
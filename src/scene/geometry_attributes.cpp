@@ -17,6 +17,7 @@
 #include "scene/shader.h"
 #include "scene/shader_nodes.h"
 
+#include "util/algorithm.h"
 #include "util/progress.h"
 
 namespace ccl {
@@ -111,19 +112,27 @@ static void emit_attribute_map_entry(AttributeMap *attr_map,
   }
 }
 
-/* Generate an attribute map end marker, optionally including a link to another map.
- * Links are used to connect object attribute maps to mesh attribute maps. */
-static void emit_attribute_map_terminator(AttributeMap *attr_map,
-                                          const size_t index,
-                                          const bool chain,
-                                          const uint chain_link)
+/* Generate an attribute map table header, holding the number of entries that follow and
+ * optionally a link to another map. Links are used to connect object attribute maps to mesh
+ * attribute maps. */
+static void emit_attribute_map_header(AttributeMap *attr_map,
+                                      const size_t index,
+                                      const size_t count,
+                                      const bool chain,
+                                      const uint chain_link)
 {
-  for (int j = 0; j < ATTR_PRIM_TYPES; j++) {
-    attr_map[index + j].id = ATTR_STD_NONE;
-    attr_map[index + j].element = chain;                     /* link is valid flag */
-    attr_map[index + j].offset = chain ? chain_link + j : 0; /* link to the correct sub-entry */
-    attr_map[index + j].type = 0;
-  }
+  attr_map[index].id = ATTR_STD_NONE;
+  attr_map[index].element = count;
+  attr_map[index].offset = chain ? chain_link : 0;
+  attr_map[index].type = chain; /* link is valid flag */
+}
+
+/* Sort table entries by id, so that the kernel can binary search them. */
+static void sort_attribute_map_entries(AttributeMap *entries, const size_t count)
+{
+  sort(entries, entries + count, [](const AttributeMap &a, const AttributeMap &b) {
+    return a.id < b.id;
+  });
 }
 
 /* Generate all necessary attribute map entries from the attribute request. */
@@ -142,7 +151,9 @@ void GeometryManager::update_svm_attributes(Device * /*unused*/,
                                             vector<AttributeRequestSet> &object_attributes)
 {
   /* for SVM, the attributes_map table is used to lookup the offset of an
-   * attribute, based on a unique shader attribute id. */
+   * attribute, based on a unique shader attribute id. Each table consists of
+   * a header entry with the entry count (and for objects a link to the
+   * geometry table), followed by the entries sorted by id for binary search. */
 
   /* compute array stride */
   size_t attr_map_size = 0;
@@ -167,7 +178,7 @@ void GeometryManager::update_svm_attributes(Device * /*unused*/,
     const size_t attr_count = geom_attributes[i].size();
 #endif
 
-    attr_map_size += (attr_count + 1) * ATTR_PRIM_TYPES;
+    attr_map_size += attr_count + 1;
   }
 
   for (size_t i = 0; i < scene->objects.size(); i++) {
@@ -179,7 +190,7 @@ void GeometryManager::update_svm_attributes(Device * /*unused*/,
     }
     else {
       object->attr_map_offset = attr_map_size;
-      attr_map_size += (object_attributes[i].size() + 1) * ATTR_PRIM_TYPES;
+      attr_map_size += object_attributes[i].size() + 1;
     }
   }
 
@@ -200,7 +211,8 @@ void GeometryManager::update_svm_attributes(Device * /*unused*/,
     AttributeRequestSet &attributes = geom_attributes[i];
 
     /* set geometry attributes */
-    size_t index = geom->attr_map_offset;
+    const size_t index = geom->attr_map_offset;
+    size_t entry_index = index + 1;
 
     for (AttributeRequest &req : attributes.requests) {
       uint64_t id;
@@ -211,20 +223,22 @@ void GeometryManager::update_svm_attributes(Device * /*unused*/,
         id = scene->shader_manager->get_attribute_id(req.std);
       }
 
-      emit_attribute_mapping(attr_map, index, id, req);
-      index += ATTR_PRIM_TYPES;
+      emit_attribute_mapping(attr_map, entry_index, id, req);
+      entry_index++;
 
 #ifdef WITH_OSL
       /* Some standard attributes are explicitly referenced via their standard ID, so add those
        * again in case they were added under a different attribute ID. */
       if (req.std != ATTR_STD_NONE && id != (uint64_t)req.std) {
-        emit_attribute_mapping(attr_map, index, (uint64_t)req.std, req);
-        index += ATTR_PRIM_TYPES;
+        emit_attribute_mapping(attr_map, entry_index, (uint64_t)req.std, req);
+        entry_index++;
       }
 #endif
     }
 
-    emit_attribute_map_terminator(attr_map, index, false, 0);
+    const size_t count = entry_index - index - 1;
+    sort_attribute_map_entries(attr_map + index + 1, count);
+    emit_attribute_map_header(attr_map, index, count, false, 0);
   }
 
   for (size_t i = 0; i < scene->objects.size(); i++) {
@@ -233,7 +247,8 @@ void GeometryManager::update_svm_attributes(Device * /*unused*/,
 
     /* set object attributes */
     if (attributes.size() > 0) {
-      size_t index = object->attr_map_offset;
+      const size_t index = object->attr_map_offset;
+      size_t entry_index = index + 1;
 
       for (AttributeRequest &req : attributes.requests) {
         uint64_t id;
@@ -244,11 +259,13 @@ void GeometryManager::update_svm_attributes(Device * /*unused*/,
           id = scene->shader_manager->get_attribute_id(req.std);
         }
 
-        emit_attribute_mapping(attr_map, index, id, req);
-        index += ATTR_PRIM_TYPES;
+        emit_attribute_mapping(attr_map, entry_index, id, req);
+        entry_index++;
       }
 
-      emit_attribute_map_terminator(attr_map, index, true, object->geometry->attr_map_offset);
+      const size_t count = entry_index - index - 1;
+      sort_attribute_map_entries(attr_map + index + 1, count);
+      emit_attribute_map_header(attr_map, index, count, true, object->geometry->attr_map_offset);
     }
   }
 
@@ -266,15 +283,29 @@ template<typename T> struct AttributeTableEntry {
     size += attr_size;
   }
 
+  /* Attributes of the same type as the device array are stored in the exact device layout, so
+   * the whole attribute is copied with a single memcpy. */
+  static void copy(T *dst, const T *src, const size_t n)
+  {
+    memcpy(dst, src, n * sizeof(T));
+  }
+
+  /* Assigning float3 values to the packed_float3 device array drops the padding component, so a
+   * per-element conversion is needed. The tight loop vectorizes well. */
+  static void copy(packed_float3 *dst, const float3 *src, const size_t n)
+  {
+    for (size_t k = 0; k < n; k++) {
+      dst[k] = src[k];
+    }
+  }
+
   /* Templated on U since we'll want to assign float3 values to a packed_float3 device_vector. */
   template<typename U> size_t add(const U *attr_data, const size_t attr_size, const bool modified)
   {
     assert(data.size() >= offset + attr_size);
     size_t start_offset = offset;
     if (modified) {
-      for (size_t k = 0; k < attr_size; k++) {
-        data[offset + k] = attr_data[k];
-      }
+      copy(data.data() + offset, attr_data, attr_size);
       data.tag_modified();
     }
     offset += attr_size;
@@ -4,6 +4,7 @@
 
 #include "bvh/bvh.h"
 #include "bvh/bvh2.h"
+#include "bvh/cache.h"
 
 #include "device/device.h"
 
@@ -60,7 +61,21 @@ void Geometry::compute_bvh(Device *device,
     vector<Object *> objects;
     objects.push_back(&object);
 
-    if (bvh && !need_update_rebuild) {
+    /* Refit keeps the tree topology, so traversal quality decays when the
+     * geometry deformed far from the shape the tree was built for. Bounds
+     * growth is a cheap proxy for the deformation delta; escalate to a full
+     * rebuild once the tree would cover significantly more space than it was
+     * built for. */
+    bool can_refit = (bvh && !need_update_rebuild);
+    if (can_refit && bvh_build_bounds.valid()) {
+      BoundBox merged = bvh_build_bounds;
+      merged.grow(bounds);
+      if (merged.area() > 2.0f * bvh_build_bounds.area()) {
+        can_refit = false;
+      }
+    }
+
+    if (can_refit) {
       progress->set_status(msg, "Refitting BVH");
 
       bvh->replace_geometry(geometry, objects);
@@ -73,6 +88,8 @@ void Geometry::compute_bvh(Device *device,
       BVHParams bparams;
       bparams.use_spatial_split = params->use_bvh_spatial_split;
       bparams.use_compact_structure = params->use_bvh_compact_structure;
+      /* Dynamic BVHs trade trace quality for scene update latency. */
+      bparams.use_fast_build = (params->bvh_type == BVH_TYPE_DYNAMIC);
       bparams.bvh_layout = bvh_layout;
       bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
                                     params->use_bvh_unaligned_nodes;
@@ -82,8 +99,38 @@ void Geometry::compute_bvh(Device *device,
       bparams.bvh_type = params->bvh_type;
       bparams.curve_subdivisions = params->curve_subdivisions();
 
+      if (is_pointcloud()) {
+        /* Point spheres are much cheaper to test than a node traversal step,
+         * but the cost model treats them like triangles and over-splits dense
+         * scans. Cheaper primitives and fuller leaves let the SAH terminate
+         * earlier, shrinking the tree and speeding up build and traversal. */
+        bparams.sah_primitive_cost = 0.25f;
+        bparams.max_point_leaf_size = 16;
+        bparams.max_motion_point_leaf_size = 16;
+      }
+
       bvh = BVH::create(bparams, geometry, objects, device);
-      MEM_GUARDED_CALL(progress, device->build_bvh, bvh.get(), *progress, false);
+
+      /* When the on-disk cache is enabled, try to load the packed tree from
+       * a previous render of the same geometry before building. */
+      string cache_key;
+      bool from_cache = false;
+      if (bvh_cache_enabled()) {
+        cache_key = bvh_cache_key(bparams, geometry);
+        if (!cache_key.empty()) {
+          from_cache = bvh_cache_load(cache_key, static_cast<BVH2 *>(bvh.get())->pack);
+        }
+      }
+
+      if (!from_cache) {
+        MEM_GUARDED_CALL(progress, device->build_bvh, bvh.get(), *progress, false);
+
+        if (!cache_key.empty() && !progress->get_cancel()) {
+          bvh_cache_save(cache_key, static_cast<BVH2 *>(bvh.get())->pack);
+        }
+      }
+
+      bvh_build_bounds = bounds;
     }
   }
 
@@ -91,6 +138,70 @@ void Geometry::compute_bvh(Device *device,
   need_update_bvh_for_offset = false;
 }
 
+/* In-place refit of the top level part of the packed scene BVH after
+ * transform-only object edits.
+ *
+ * The tree topology and the merged geometry packs are unchanged in that case,
+ * so only object instance leaves have new bounds. Primitive leaves belong to
+ * geometry with the transform applied, which cannot move without the geometry
+ * itself being modified, so their bounds are taken from what is already
+ * stored in the parent node. Leaf nodes and visibility words stay untouched.
+ */
+static BoundBox scene_bvh_refit_node(int4 *nodes,
+                                     const int4 *leaf_nodes,
+                                     const int *prim_index,
+                                     const int *prim_object,
+                                     const vector<Object *> &objects,
+                                     const int idx)
+{
+  int4 *data = nodes + idx;
+  const int c[2] = {data[0].z, data[0].w};
+  BoundBox bounds[2] = {BoundBox::empty, BoundBox::empty};
+
+  for (int i = 0; i < 2; i++) {
+    if (c[i] >= 0) {
+      bounds[i] = scene_bvh_refit_node(nodes, leaf_nodes, prim_index, prim_object, objects, c[i]);
+      continue;
+    }
+    const int4 leaf = leaf_nodes[-c[i] - 1];
+    if (leaf.x < 0) {
+      /* Object instance leaf. */
+      bounds[i] = objects[prim_object[~leaf.x]]->bounds;
+    }
+    else if (leaf.y > leaf.x && prim_index[leaf.x] == -1) {
+      /* Leaf with multiple object references. */
+      for (int prim = leaf.x; prim < leaf.y; prim++) {
+        bounds[i].grow(objects[prim_object[prim]]->bounds);
+      }
+    }
+    else {
+      /* Primitive leaf, bounds are unchanged. */
+      bounds[i] = BoundBox(
+          make_float3(__int_as_float(data[1][i]), __int_as_float(data[2][i]), __int_as_float(data[3][i])),
+          make_float3(__int_as_float(data[1][i + 2]),
+                      __int_as_float(data[2][i + 2]),
+                      __int_as_float(data[3][i + 2])));
+    }
+  }
+
+  data[1] = make_int4(__float_as_int(bounds[0].min.x),
+                      __float_as_int(bounds[1].min.x),
+                      __float_as_int(bounds[0].max.x),
+                      __float_as_int(bounds[1].max.x));
+  data[2] = make_int4(__float_as_int(bounds[0].min.y),
+                      __float_as_int(bounds[1].min.y),
+                      __float_as_int(bounds[0].max.y),
+                      __float_as_int(bounds[1].max.y));
+  data[3] = make_int4(__float_as_int(bounds[0].min.z),
+                      __float_as_int(bounds[1].min.z),
+                      __float_as_int(bounds[0].max.z),
+                      __float_as_int(bounds[1].max.z));
+
+  BoundBox merged = bounds[0];
+  merged.grow(bounds[1]);
+  return merged;
+}
+
 void GeometryManager::device_update_bvh(Device *device,
                                         DeviceScene *dscene,
                                         Scene *scene,
@@ -104,6 +215,7 @@ void GeometryManager::device_update_bvh(Device *device,
   bparams.bvh_layout = BVHParams::best_bvh_layout(
       scene->params.bvh_layout, device->get_bvh_layout_mask(dscene->data.kernel_features));
   bparams.use_spatial_split = scene->params.use_bvh_spatial_split;
+  bparams.use_compact_structure = scene->params.use_bvh_compact_structure;
   bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
                                 scene->params.use_bvh_unaligned_nodes;
   bparams.num_motion_triangle_steps = scene->params.num_bvh_time_steps;
@@ -114,9 +226,48 @@ void GeometryManager::device_update_bvh(Device *device,
 
   VLOG_INFO << "Using " << bvh_layout_name(bparams.bvh_layout) << " layout.";
 
+  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2);
+
+  /* Delta update: when only object transforms changed since the last scene
+   * BVH update, the topology of the packed top level tree and the merged
+   * geometry packs are still valid. Refit the top level nodes in place and
+   * re-upload them instead of rebuilding and re-merging the whole scene. */
+  const bool transform_only_update = (update_flags & TRANSFORM_MODIFIED) != 0 &&
+                                     (update_flags & ~(OBJECT_MANAGER | TRANSFORM_MODIFIED)) == 0;
+  bool tlas_transforms_only = transform_only_update && scene->bvh != nullptr;
+  if (tlas_transforms_only) {
+    for (Geometry *geom : scene->geometry) {
+      if (geom->is_modified() || geom->need_update_bvh_for_offset) {
+        tlas_transforms_only = false;
+        break;
+      }
+    }
+  }
+
+  if (has_bvh2_layout && tlas_transforms_only && !bparams.use_unaligned_nodes &&
+      !scene->params.use_bvh_compact_structure && dscene->data.bvh.root == 0 &&
+      dscene->bvh_nodes.size() != 0 && dscene->object_node.size() == scene->objects.size())
+  {
+    progress.set_status("Updating Scene BVH", "Refitting top level");
+
+    scene_bvh_refit_node(dscene->bvh_nodes.data(),
+                         dscene->bvh_leaf_nodes.data(),
+                         dscene->prim_index.data(),
+                         dscene->prim_object.data(),
+                         scene->objects,
+                         0);
+    dscene->bvh_nodes.copy_to_device();
+    return;
+  }
+
+  /* Embree can refit the committed top level rtcScene in place when only
+   * object transforms changed: child scenes and instance attachments are
+   * still valid, so only the instance transforms need updating. */
   const bool can_refit = scene->bvh != nullptr &&
                          (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX ||
-                          bparams.bvh_layout == BVHLayout::BVH_LAYOUT_METAL);
+                          bparams.bvh_layout == BVHLayout::BVH_LAYOUT_METAL ||
+                          (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_EMBREE &&
+                           tlas_transforms_only));
 
   BVH *bvh = scene->bvh.get();
   if (bvh == nullptr) {
@@ -130,8 +281,6 @@ void GeometryManager::device_update_bvh(Device *device,
     return;
   }
 
-  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2);
-
   PackedBVH pack;
   if (has_bvh2_layout) {
     pack = std::move(static_cast<BVH2 *>(bvh)->pack);
@@ -144,43 +293,50 @@ void GeometryManager::device_update_bvh(Device *device,
   progress.set_status("Updating Scene BVH", "Copying BVH to device");
 
   /* When using BVH2, we always have to copy/update the data as its layout is dependent on the
-   * BVH's leaf nodes which may be different when the objects or vertices move. */
+   * BVH's leaf nodes which may be different when the objects or vertices move.
+   *
+   * Uploads are queued on a batch so earlier arrays transfer while later ones
+   * are still being stolen from the pack; the batch waits on scope exit. */
+
+  DeviceUploadBatch upload_batch;
 
   if (pack.nodes.size()) {
     dscene->bvh_nodes.steal_data(pack.nodes);
-    dscene->bvh_nodes.copy_to_device();
+    upload_batch.copy_to_device(dscene->bvh_nodes);
   }
   if (pack.leaf_nodes.size()) {
     dscene->bvh_leaf_nodes.steal_data(pack.leaf_nodes);
-    dscene->bvh_leaf_nodes.copy_to_device();
+    upload_batch.copy_to_device(dscene->bvh_leaf_nodes);
   }
   if (pack.object_node.size()) {
     dscene->object_node.steal_data(pack.object_node);
-    dscene->object_node.copy_to_device();
+    upload_batch.copy_to_device(dscene->object_node);
   }
   if (pack.prim_type.size()) {
     dscene->prim_type.steal_data(pack.prim_type);
-    dscene->prim_type.copy_to_device();
+    upload_batch.copy_to_device(dscene->prim_type);
   }
   if (pack.prim_visibility.size()) {
     dscene->prim_visibility.steal_data(pack.prim_visibility);
-    dscene->prim_visibility.copy_to_device();
+    upload_batch.copy_to_device(dscene->prim_visibility);
   }
   if (pack.prim_index.size()) {
     dscene->prim_index.steal_data(pack.prim_index);
-    dscene->prim_index.copy_to_device();
+    upload_batch.copy_to_device(dscene->prim_index);
   }
   if (pack.prim_object.size()) {
     dscene->prim_object.steal_data(pack.prim_object);
-    dscene->prim_object.copy_to_device();
+    upload_batch.copy_to_device(dscene->prim_object);
   }
   if (pack.prim_time.size()) {
     dscene->prim_time.steal_data(pack.prim_time);
-    dscene->prim_time.copy_to_device();
+    upload_batch.copy_to_device(dscene->prim_time);
   }
 
   dscene->data.bvh.root = pack.root_index;
   dscene->data.bvh.use_bvh_steps = (scene->params.num_bvh_time_steps != 0);
+  dscene->data.bvh.use_compact = has_bvh2_layout && scene->params.use_bvh_compact_structure &&
+                                 !bparams.use_unaligned_nodes;
   dscene->data.bvh.curve_subdivisions = scene->params.curve_subdivisions();
 
 #ifdef WITH_EMBREE
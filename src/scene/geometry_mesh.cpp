@@ -58,12 +58,16 @@ void GeometryManager::device_update_mesh(Device * /*unused*/,
     }
   }
 
+  /* Uploads overlap with packing the remaining primitive types; the batch
+   * waits for outstanding transfers when this function returns. */
+  DeviceUploadBatch upload_batch;
+
   /* Fill in all the arrays. */
   if (tri_size != 0) {
     /* normals */
     progress.set_status("Updating Mesh", "Computing normals");
 
-    packed_float3 *tri_verts = dscene->tri_verts.alloc(vert_size);
+    packed_float3 *tri_verts = dscene->tri_verts.alloc(tri_size * 3);
     uint *tri_shader = dscene->tri_shader.alloc(tri_size);
     packed_float3 *vnormal = dscene->tri_vnormal.alloc(vert_size);
     packed_uint3 *tri_vindex = dscene->tri_vindex.alloc(tri_size);
@@ -87,7 +91,7 @@ void GeometryManager::device_update_mesh(Device * /*unused*/,
         }
 
         if (mesh->verts_is_modified() || mesh->triangles_is_modified() || copy_all_data) {
-          mesh->pack_verts(&tri_verts[mesh->vert_offset], &tri_vindex[mesh->prim_offset]);
+          mesh->pack_verts(&tri_verts[mesh->prim_offset * 3], &tri_vindex[mesh->prim_offset]);
         }
 
         if (progress.get_cancel()) {
@@ -99,10 +103,10 @@ void GeometryManager::device_update_mesh(Device * /*unused*/,
     /* vertex coordinates */
     progress.set_status("Updating Mesh", "Copying Mesh to device");
 
-    dscene->tri_verts.copy_to_device_if_modified();
-    dscene->tri_shader.copy_to_device_if_modified();
-    dscene->tri_vnormal.copy_to_device_if_modified();
-    dscene->tri_vindex.copy_to_device_if_modified();
+    upload_batch.copy_to_device_if_modified(dscene->tri_verts);
+    upload_batch.copy_to_device_if_modified(dscene->tri_shader);
+    upload_batch.copy_to_device_if_modified(dscene->tri_vnormal);
+    upload_batch.copy_to_device_if_modified(dscene->tri_vindex);
   }
 
   if (curve_segment_size != 0) {
@@ -139,9 +143,9 @@ void GeometryManager::device_update_mesh(Device * /*unused*/,
       }
     }
 
-    dscene->curve_keys.copy_to_device_if_modified();
-    dscene->curves.copy_to_device_if_modified();
-    dscene->curve_segments.copy_to_device_if_modified();
+    upload_batch.copy_to_device_if_modified(dscene->curve_keys);
+    upload_batch.copy_to_device_if_modified(dscene->curves);
+    upload_batch.copy_to_device_if_modified(dscene->curve_segments);
   }
 
   if (point_size != 0) {
@@ -161,8 +165,8 @@ void GeometryManager::device_update_mesh(Device * /*unused*/,
       }
     }
 
-    dscene->points.copy_to_device();
-    dscene->points_shader.copy_to_device();
+    upload_batch.copy_to_device(dscene->points);
+    upload_batch.copy_to_device(dscene->points_shader);
   }
 }
 
@@ -492,38 +492,55 @@ void Hair::pack_curves(Scene *scene,
 
   /* pack curve keys */
   if (curve_keys_size) {
-    float3 *keys_ptr = curve_keys.data();
-    float *radius_ptr = curve_radius.data();
-
-    for (size_t i = 0; i < curve_keys_size; i++) {
-      curve_key_co[i] = make_float4(keys_ptr[i], radius_ptr[i]);
-    }
+    const float3 *keys_ptr = curve_keys.data();
+    const float *radius_ptr = curve_radius.data();
+
+    parallel_for(blocked_range<size_t>(0, curve_keys_size, 256 * 1024),
+                 [&](const blocked_range<size_t> &r) {
+                   for (size_t i = r.begin(); i != r.end(); i++) {
+                     curve_key_co[i] = make_float4(keys_ptr[i], radius_ptr[i]);
+                   }
+                 });
   }
 
   /* pack curve segments */
   const PrimitiveType type = primitive_type();
 
   const size_t curve_num = num_curves();
-  size_t index = 0;
-
-  for (size_t i = 0; i < curve_num; i++) {
-    const Curve curve = get_curve(i);
-    int shader_id = curve_shader[i];
-    Shader *shader = (shader_id < used_shaders.size()) ?
-                         static_cast<Shader *>(used_shaders[shader_id]) :
-                         scene->default_surface;
-    shader_id = scene->shader_manager->get_shader_id(shader, false);
-
-    curves[i].shader_id = shader_id;
-    curves[i].first_key = curve_key_offset + curve.first_key;
-    curves[i].num_keys = curve.num_keys;
-    curves[i].type = type;
-
-    for (int k = 0; k < curve.num_segments(); ++k, ++index) {
-      curve_segments[index].prim = prim_offset + i;
-      curve_segments[index].type = PRIMITIVE_PACK_SEGMENT(type, k);
-    }
+
+  /* Resolve shader ids once per shader instead of once per curve. */
+  const int default_shader_id = scene->shader_manager->get_shader_id(scene->default_surface,
+                                                                     false);
+  vector<int> shader_id_map(used_shaders.size());
+  for (size_t i = 0; i < used_shaders.size(); i++) {
+    shader_id_map[i] = scene->shader_manager->get_shader_id(
+        static_cast<Shader *>(used_shaders[i]), false);
   }
+
+  const int first_key_start = (curve_num != 0) ? curve_first_key[0] : 0;
+
+  parallel_for(
+      blocked_range<size_t>(0, curve_num, 64 * 1024), [&](const blocked_range<size_t> &r) {
+        for (size_t i = r.begin(); i != r.end(); i++) {
+          const Curve curve = get_curve(i);
+          const int shader_id = ((size_t)curve_shader[i] < shader_id_map.size()) ?
+                                    shader_id_map[curve_shader[i]] :
+                                    default_shader_id;
+
+          curves[i].shader_id = shader_id;
+          curves[i].first_key = curve_key_offset + curve.first_key;
+          curves[i].num_keys = curve.num_keys;
+          curves[i].type = type;
+
+          /* Segments are laid out in curve order, so the segment offset of a
+           * curve follows from its key offset. */
+          size_t index = (curve.first_key - first_key_start) - i;
+          for (int k = 0; k < curve.num_segments(); ++k, ++index) {
+            curve_segments[index].prim = prim_offset + i;
+            curve_segments[index].type = PRIMITIVE_PACK_SEGMENT(type, k);
+          }
+        }
+      });
 }
 
 PrimitiveType Hair::primitive_type() const
@@ -534,6 +551,13 @@ PrimitiveType Hair::primitive_type() const
              ((curve_shape == CURVE_RIBBON) ? PRIMITIVE_CURVE_RIBBON : PRIMITIVE_CURVE_THICK);
 }
 
+bool Hair::bvh_topology_modified() const
+{
+  /* Keys and radii may deform freely, changing the number of curves or how
+   * keys map to curves needs a rebuild. */
+  return curve_first_key_is_modified();
+}
+
 /* Fill in coordinates for curve transparency shader evaluation on device. */
 static int fill_shader_input(const Hair *hair,
                              const size_t object_index,
@@ -591,16 +615,19 @@ bool Hair::need_shadow_transparency()
   return false;
 }
 
-bool Hair::update_shadow_transparency(Device *device, Scene *scene, Progress &progress)
+void Hair::update_shadow_transparency(ShaderEval &shader_eval,
+                                      Scene *scene,
+                                      Progress &progress,
+                                      bool &transparency_done)
 {
   if (!need_shadow_transparency()) {
     /* If no shaders with shadow transparency, remove attribute. */
     Attribute *attr = attributes.find(ATTR_STD_SHADOW_TRANSPARENCY);
     if (attr) {
       attributes.remove(attr);
-      return true;
+      transparency_done = true;
     }
-    return false;
+    return;
   }
 
   const string msg = string_printf("Computing Shadow Transparency %s", name.c_str());
@@ -625,26 +652,27 @@ bool Hair::update_shadow_transparency(Device *device, Scene *scene, Progress &pr
     }
   }
 
-  /* Evaluate shader on device. */
-  ShaderEval shader_eval(device, progress);
-  bool is_fully_opaque = false;
-  shader_eval.eval(
+  /* Queue shader evaluation on device, batched with other geometry. */
+  shader_eval.eval_queue(
       SHADER_EVAL_CURVE_SHADOW_TRANSPARENCY,
       num_keys(),
       1,
       [this, object_index](device_vector<KernelShaderEvalInput> &d_input) {
         return fill_shader_input(this, object_index, d_input);
       },
-      [attr_data, &is_fully_opaque](const device_vector<float> &d_output) {
+      [this, attr, attr_data, attribute_exists, &transparency_done](
+          const device_vector<float> &d_output) {
+        bool is_fully_opaque = false;
         read_shader_output(attr_data, is_fully_opaque, d_output);
-      });
 
-  if (is_fully_opaque) {
-    attributes.remove(attr);
-    return attribute_exists;
-  }
-
-  return true;
+        if (is_fully_opaque) {
+          attributes.remove(attr);
+          transparency_done |= attribute_exists;
+        }
+        else {
+          transparency_done = true;
+        }
+      });
 }
 
 }
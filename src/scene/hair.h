@@ -144,9 +144,16 @@ class Hair : public Geometry {
 
   PrimitiveType primitive_type() const override;
 
+  bool bvh_topology_modified() const override;
+
   /* Attributes */
   bool need_shadow_transparency();
-  bool update_shadow_transparency(Device *device, Scene *scene, Progress &progress);
+  /* Queue shadow transparency shader evaluation, batched with other geometry.
+   * The read callback fills the attribute and sets transparency_done. */
+  void update_shadow_transparency(ShaderEval &shader_eval,
+                                  Scene *scene,
+                                  Progress &progress,
+                                  bool &transparency_done);
 };
 
 }
@@ -104,6 +104,13 @@ void ImageHandle::clear()
   manager = nullptr;
 }
 
+void ImageHandle::require_precision(const ImageStoragePrecision precision)
+{
+  for (const size_t slot : slots) {
+    manager->require_precision(slot, precision);
+  }
+}
+
 bool ImageHandle::empty() const
 {
   return slots.empty();
@@ -280,6 +287,11 @@ void ImageMetaData::detect_colorspace()
 
 ImageLoader::ImageLoader() = default;
 
+bool ImageLoader::load_deferred(ImageMetaData & /*metadata*/)
+{
+  return true;
+}
+
 string ImageLoader::osl_filepath() const
 {
   return string();
@@ -310,6 +322,7 @@ ImageManager::ImageManager(const DeviceInfo &info)
   need_update_ = true;
   osl_texture_system = nullptr;
   animation_frame = 0;
+  prefetched_bytes = 0;
 
   /* Set image limits */
   features.has_nanovdb = info.has_nanovdb;
@@ -367,6 +380,25 @@ void ImageManager::load_image_metadata(Image *img)
 
   metadata.detect_colorspace();
 
+  /* Demote the storage type when every user of the image tolerates a lower
+   * precision than the source image provides. */
+  if (img->params.precision <= IMAGE_PRECISION_HALF) {
+    if (metadata.type == IMAGE_DATA_TYPE_FLOAT) {
+      metadata.type = IMAGE_DATA_TYPE_HALF;
+    }
+    else if (metadata.type == IMAGE_DATA_TYPE_FLOAT4) {
+      metadata.type = IMAGE_DATA_TYPE_HALF4;
+    }
+  }
+  if (img->params.precision == IMAGE_PRECISION_BYTE) {
+    if (metadata.type == IMAGE_DATA_TYPE_HALF || metadata.type == IMAGE_DATA_TYPE_USHORT) {
+      metadata.type = IMAGE_DATA_TYPE_BYTE;
+    }
+    else if (metadata.type == IMAGE_DATA_TYPE_HALF4 || metadata.type == IMAGE_DATA_TYPE_USHORT4) {
+      metadata.type = IMAGE_DATA_TYPE_BYTE4;
+    }
+  }
+
   assert(features.has_nanovdb || (metadata.type != IMAGE_DATA_TYPE_NANOVDB_FLOAT ||
                                   metadata.type != IMAGE_DATA_TYPE_NANOVDB_FLOAT3 ||
                                   metadata.type != IMAGE_DATA_TYPE_NANOVDB_FPN ||
@@ -459,6 +491,13 @@ size_t ImageManager::add_image_slot(unique_ptr<ImageLoader> &&loader,
     Image *img = images[slot].get();
     if (img && ImageLoader::equals(img->loader.get(), loader.get()) && img->params == params) {
       img->users++;
+      /* Negotiate storage precision with the existing users. */
+      if (params.precision > img->params.precision) {
+        img->params.precision = params.precision;
+        img->need_metadata = true;
+        img->need_load = !(osl_texture_system && !img->loader->osl_filepath().empty());
+        need_update_ = true;
+      }
       return slot;
     }
   }
@@ -480,6 +519,7 @@ size_t ImageManager::add_image_slot(unique_ptr<ImageLoader> &&loader,
   img->loader = std::move(loader);
   img->need_metadata = true;
   img->need_load = !(osl_texture_system && !img->loader->osl_filepath().empty());
+  img->loading = false;
   img->builtin = builtin;
   img->users = 1;
   img->mem = nullptr;
@@ -500,6 +540,21 @@ void ImageManager::add_image_user(const size_t slot)
   image->users++;
 }
 
+void ImageManager::require_precision(const size_t slot, const ImageStoragePrecision precision)
+{
+  const thread_scoped_lock device_lock(images_mutex);
+  Image *image = images[slot].get();
+  assert(image && image->users >= 1);
+
+  /* Only ever raise the precision, other users may demand more than this one. */
+  if (precision > image->params.precision) {
+    image->params.precision = precision;
+    image->need_metadata = true;
+    image->need_load = !(osl_texture_system && !image->loader->osl_filepath().empty());
+    need_update_ = true;
+  }
+}
+
 void ImageManager::remove_image_user(const size_t slot)
 {
   const thread_scoped_lock device_lock(images_mutex);
@@ -533,8 +588,70 @@ static bool image_associate_alpha(ImageManager::Image *img)
            img->params.alpha_type == IMAGE_ALPHA_CHANNEL_PACKED);
 }
 
+/* Number of mip levels to generate below the base level. Only 2D images large enough for
+ * minification to matter get a chain; it stops once the largest dimension drops to 32
+ * pixels, below which the whole level fits in cache anyway. */
+static uint mip_level_count(const size_t width, const size_t height, const size_t depth)
+{
+  if (depth > 1) {
+    return 0;
+  }
+
+  uint num_levels = 0;
+  for (size_t size = max(width, height); size >= 64; size >>= 1) {
+    num_levels++;
+  }
+
+  return num_levels;
+}
+
+/* Generate the mip chain with a parallel 2x2 box downsample of each previous level, storing
+ * the levels contiguously after the base level. Odd dimensions clamp the last source row and
+ * column, matching the level sizes that device_texture::alloc reserved. */
+template<typename StorageType>
+static void generate_mip_levels(StorageType *const pixels,
+                                const size_t width,
+                                const size_t height,
+                                const uint num_mip_levels,
+                                const int components)
+{
+  const StorageType *src = pixels;
+  StorageType *dst = pixels + width * height * components;
+  size_t src_width = width;
+  size_t src_height = height;
+
+  for (uint level = 1; level <= num_mip_levels; level++) {
+    const size_t dst_width = max(src_width >> 1, (size_t)1);
+    const size_t dst_height = max(src_height >> 1, (size_t)1);
+
+    parallel_for(blocked_range<size_t>(0, dst_height), [&](const blocked_range<size_t> &r) {
+      for (size_t y = r.begin(); y != r.end(); y++) {
+        const size_t sy0 = min(y * 2, src_height - 1);
+        const size_t sy1 = min(y * 2 + 1, src_height - 1);
+        for (size_t x = 0; x < dst_width; x++) {
+          const size_t sx0 = min(x * 2, src_width - 1);
+          const size_t sx1 = min(x * 2 + 1, src_width - 1);
+          for (int c = 0; c < components; c++) {
+            const float sum = util_image_cast_to_float(src[(sy0 * src_width + sx0) * components + c]) +
+                              util_image_cast_to_float(src[(sy0 * src_width + sx1) * components + c]) +
+                              util_image_cast_to_float(src[(sy1 * src_width + sx0) * components + c]) +
+                              util_image_cast_to_float(src[(sy1 * src_width + sx1) * components + c]);
+            dst[(y * dst_width + x) * components + c] = util_image_cast_from_float<StorageType>(
+                sum * 0.25f);
+          }
+        }
+      }
+    });
+
+    src = dst;
+    dst += dst_width * dst_height * components;
+    src_width = dst_width;
+    src_height = dst_height;
+  }
+}
+
 template<TypeDesc::BASETYPE FileFormat, typename StorageType>
-bool ImageManager::file_load_image(Image *img, const int texture_limit)
+bool ImageManager::file_load_image(Image *img, const int texture_limit, const bool build_mip_levels)
 {
   /* Ignore empty images. */
   if (!(img->metadata.channels > 0)) {
@@ -557,13 +674,15 @@ bool ImageManager::file_load_image(Image *img, const int texture_limit)
   }
 
   /* Allocate memory as needed, may be smaller to resize down. */
+  uint num_mip_levels = 0;
   if (texture_limit > 0 && max_size > texture_limit) {
     pixels_storage.resize(((size_t)width) * height * depth * 4);
     pixels = &pixels_storage[0];
   }
   else {
+    num_mip_levels = build_mip_levels ? mip_level_count(width, height, depth) : 0;
     const thread_scoped_lock device_lock(device_mutex);
-    pixels = (StorageType *)img->mem->alloc(width, height, depth);
+    pixels = (StorageType *)img->mem->alloc(width, height, depth, num_mip_levels);
   }
 
   if (pixels == nullptr) {
@@ -615,9 +734,12 @@ bool ImageManager::file_load_image(Image *img, const int texture_limit)
 
     /* Disable alpha if requested by the user. */
     if (img->params.alpha_type == IMAGE_ALPHA_IGNORE) {
-      for (size_t i = num_pixels - 1, pixel = 0; pixel < num_pixels; pixel++, i--) {
-        pixels[i * 4 + 3] = one;
-      }
+      parallel_for(blocked_range<size_t>(0, num_pixels, 1024 * 1024),
+                   [&](const blocked_range<size_t> &r) {
+                     for (size_t i = r.begin(); i != r.end(); i++) {
+                       pixels[i * 4 + 3] = one;
+                     }
+                   });
     }
   }
 
@@ -635,28 +757,38 @@ bool ImageManager::file_load_image(Image *img, const int texture_limit)
      * finite. This way we avoid possible artifacts caused by fully changed
      * hue. */
     if (is_rgba) {
-      for (size_t i = 0; i < num_pixels; i += 4) {
-        StorageType *pixel = &pixels[i * 4];
-        if (!isfinite(pixel[0]) || !isfinite(pixel[1]) || !isfinite(pixel[2]) ||
-            !isfinite(pixel[3]))
-        {
-          pixel[0] = 0;
-          pixel[1] = 0;
-          pixel[2] = 0;
-          pixel[3] = 0;
-        }
-      }
+      parallel_for(blocked_range<size_t>(0, (num_pixels + 3) / 4, 256 * 1024),
+                   [&](const blocked_range<size_t> &r) {
+                     for (size_t k = r.begin(); k != r.end(); k++) {
+                       StorageType *pixel = &pixels[k * 16];
+                       if (!isfinite(pixel[0]) || !isfinite(pixel[1]) || !isfinite(pixel[2]) ||
+                           !isfinite(pixel[3]))
+                       {
+                         pixel[0] = 0;
+                         pixel[1] = 0;
+                         pixel[2] = 0;
+                         pixel[3] = 0;
+                       }
+                     }
+                   });
     }
     else {
-      for (size_t i = 0; i < num_pixels; ++i) {
-        StorageType *pixel = &pixels[i];
-        if (!isfinite(pixel[0])) {
-          pixel[0] = 0;
-        }
-      }
+      parallel_for(blocked_range<size_t>(0, num_pixels, 1024 * 1024),
+                   [&](const blocked_range<size_t> &r) {
+                     for (size_t i = r.begin(); i != r.end(); i++) {
+                       StorageType *pixel = &pixels[i];
+                       if (!isfinite(pixel[0])) {
+                         pixel[0] = 0;
+                       }
+                     }
+                   });
     }
   }
 
+  if (num_mip_levels > 0) {
+    generate_mip_levels(pixels, width, height, num_mip_levels, is_rgba ? 4 : 1);
+  }
+
   /* Scale image down if needed. */
   if (!pixels_storage.empty()) {
     float scale_factor = 1.0f;
@@ -681,13 +813,23 @@ bool ImageManager::file_load_image(Image *img, const int texture_limit)
                              &scaled_depth);
 
     StorageType *texture_pixels;
+    const uint num_scaled_mip_levels = build_mip_levels ?
+                                           mip_level_count(
+                                               scaled_width, scaled_height, scaled_depth) :
+                                           0;
 
     {
       const thread_scoped_lock device_lock(device_mutex);
-      texture_pixels = (StorageType *)img->mem->alloc(scaled_width, scaled_height, scaled_depth);
+      texture_pixels = (StorageType *)img->mem->alloc(
+          scaled_width, scaled_height, scaled_depth, num_scaled_mip_levels);
     }
 
     memcpy(texture_pixels, &scaled_pixels[0], scaled_pixels.size() * sizeof(StorageType));
+
+    if (num_scaled_mip_levels > 0) {
+      generate_mip_levels(
+          texture_pixels, scaled_width, scaled_height, num_scaled_mip_levels, is_rgba ? 4 : 1);
+    }
   }
 
   return true;
@@ -704,11 +846,34 @@ void ImageManager::device_load_image(Device *device,
 
   Image *img = images[slot].get();
 
+  /* Claim the slot, so that a background load started by device_update_async()
+   * and an explicit device_update_slot() for the same slot load it only once.
+   * Whoever comes second waits for the load to finish. */
+  {
+    thread_scoped_lock load_lock(load_mutex);
+    while (img->loading) {
+      load_cond.wait(load_lock);
+    }
+    if (!img->need_load) {
+      return;
+    }
+    img->loading = true;
+  }
+
   progress.set_status("Updating Images", "Loading " + img->loader->name());
 
   const int texture_limit = scene->params.texture_limit;
 
+  /* Only the CPU device samples the host-side mip chain; do not spend memory on it for other
+   * devices, whose hardware texture objects read the base level. */
+  const bool build_mip_levels = (device->info.type == DEVICE_CPU);
+
   load_image_metadata(img);
+
+  /* Let the loader decode data it deferred out of metadata loading. This may
+   * refine the metadata, so it has to happen before the type is read. */
+  img->loader->load_deferred(img->metadata);
+
   const ImageDataType type = img->metadata.type;
 
   /* Name for debugging. */
@@ -727,7 +892,7 @@ void ImageManager::device_load_image(Device *device,
 
   /* Create new texture. */
   if (type == IMAGE_DATA_TYPE_FLOAT4) {
-    if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
+    if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit, build_mip_levels)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       const thread_scoped_lock device_lock(device_mutex);
       float *pixels = (float *)img->mem->alloc(1, 1);
@@ -739,7 +904,7 @@ void ImageManager::device_load_image(Device *device,
     }
   }
   else if (type == IMAGE_DATA_TYPE_FLOAT) {
-    if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
+    if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit, build_mip_levels)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       const thread_scoped_lock device_lock(device_mutex);
       float *pixels = (float *)img->mem->alloc(1, 1);
@@ -748,7 +913,7 @@ void ImageManager::device_load_image(Device *device,
     }
   }
   else if (type == IMAGE_DATA_TYPE_BYTE4) {
-    if (!file_load_image<TypeDesc::UINT8, uchar>(img, texture_limit)) {
+    if (!file_load_image<TypeDesc::UINT8, uchar>(img, texture_limit, build_mip_levels)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       const thread_scoped_lock device_lock(device_mutex);
       uchar *pixels = (uchar *)img->mem->alloc(1, 1);
@@ -760,7 +925,7 @@ void ImageManager::device_load_image(Device *device,
     }
   }
   else if (type == IMAGE_DATA_TYPE_BYTE) {
-    if (!file_load_image<TypeDesc::UINT8, uchar>(img, texture_limit)) {
+    if (!file_load_image<TypeDesc::UINT8, uchar>(img, texture_limit, build_mip_levels)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       const thread_scoped_lock device_lock(device_mutex);
       uchar *pixels = (uchar *)img->mem->alloc(1, 1);
@@ -769,7 +934,7 @@ void ImageManager::device_load_image(Device *device,
     }
   }
   else if (type == IMAGE_DATA_TYPE_HALF4) {
-    if (!file_load_image<TypeDesc::HALF, half>(img, texture_limit)) {
+    if (!file_load_image<TypeDesc::HALF, half>(img, texture_limit, build_mip_levels)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       const thread_scoped_lock device_lock(device_mutex);
       half *pixels = (half *)img->mem->alloc(1, 1);
@@ -781,7 +946,7 @@ void ImageManager::device_load_image(Device *device,
     }
   }
   else if (type == IMAGE_DATA_TYPE_USHORT) {
-    if (!file_load_image<TypeDesc::USHORT, uint16_t>(img, texture_limit)) {
+    if (!file_load_image<TypeDesc::USHORT, uint16_t>(img, texture_limit, build_mip_levels)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       const thread_scoped_lock device_lock(device_mutex);
       uint16_t *pixels = (uint16_t *)img->mem->alloc(1, 1);
@@ -790,7 +955,7 @@ void ImageManager::device_load_image(Device *device,
     }
   }
   else if (type == IMAGE_DATA_TYPE_USHORT4) {
-    if (!file_load_image<TypeDesc::USHORT, uint16_t>(img, texture_limit)) {
+    if (!file_load_image<TypeDesc::USHORT, uint16_t>(img, texture_limit, build_mip_levels)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       const thread_scoped_lock device_lock(device_mutex);
       uint16_t *pixels = (uint16_t *)img->mem->alloc(1, 1);
@@ -802,7 +967,7 @@ void ImageManager::device_load_image(Device *device,
     }
   }
   else if (type == IMAGE_DATA_TYPE_HALF) {
-    if (!file_load_image<TypeDesc::HALF, half>(img, texture_limit)) {
+    if (!file_load_image<TypeDesc::HALF, half>(img, texture_limit, build_mip_levels)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       const thread_scoped_lock device_lock(device_mutex);
       half *pixels = (half *)img->mem->alloc(1, 1);
@@ -830,7 +995,100 @@ void ImageManager::device_load_image(Device *device,
 
   /* Cleanup memory in image loader. */
   img->loader->cleanup();
-  img->need_load = false;
+
+  {
+    const thread_scoped_lock load_lock(load_mutex);
+    img->need_load = false;
+    img->loading = false;
+  }
+  load_cond.notify_all();
+}
+
+/* Estimated decoded size of an image from its metadata, for the prefetch memory budget. */
+static size_t estimate_image_size(const ImageMetaData &metadata)
+{
+  if (metadata.byte_size != 0) {
+    return metadata.byte_size;
+  }
+
+  size_t elem_size = 0;
+  switch (metadata.type) {
+    case IMAGE_DATA_TYPE_FLOAT4:
+      elem_size = 4 * sizeof(float);
+      break;
+    case IMAGE_DATA_TYPE_FLOAT:
+      elem_size = sizeof(float);
+      break;
+    case IMAGE_DATA_TYPE_HALF4:
+    case IMAGE_DATA_TYPE_USHORT4:
+      elem_size = 4 * sizeof(uint16_t);
+      break;
+    case IMAGE_DATA_TYPE_HALF:
+    case IMAGE_DATA_TYPE_USHORT:
+      elem_size = sizeof(uint16_t);
+      break;
+    case IMAGE_DATA_TYPE_BYTE4:
+      elem_size = 4;
+      break;
+    default:
+      elem_size = 1;
+      break;
+  }
+
+  return metadata.width * metadata.height * max(metadata.depth, (size_t)1) * elem_size;
+}
+
+ImageHandle ImageManager::prefetch_image(Device *device,
+                                         Scene *scene,
+                                         const string &filename,
+                                         const ImageParams &params,
+                                         const size_t memory_budget,
+                                         Progress &progress)
+{
+  ImageHandle handle = add_image(filename, params);
+  const size_t slot = handle.slots[0];
+  Image *img = get_image_slot(slot);
+
+  {
+    const thread_scoped_lock load_lock(load_mutex);
+    if (!img->need_load) {
+      /* Already resident or being loaded; keep the reference so it stays that way. */
+      prefetched.push_back(handle);
+      return handle;
+    }
+  }
+
+  /* The decoded size is known from the metadata alone, so the budget can be enforced before
+   * spending any I/O on the pixels. */
+  load_image_metadata(img);
+  const size_t size = estimate_image_size(img->metadata);
+
+  if (prefetched_bytes + size > memory_budget) {
+    VLOG_WORK << "Skipping texture prefetch for " << img->loader->name()
+              << ", memory budget reached.";
+    return ImageHandle();
+  }
+
+  prefetched_bytes += size;
+  prefetched.push_back(handle);
+
+  load_pool.push(
+      [this, device, scene, slot, &progress] { device_load_image(device, scene, slot, progress); });
+
+  return handle;
+}
+
+void ImageManager::release_prefetched_images()
+{
+  if (prefetched.empty()) {
+    return;
+  }
+
+  prefetched.clear();
+  prefetched_bytes = 0;
+
+  /* Slots whose only user was the prefetcher are freed on the next device update. */
+  tag_update();
 }
 
 void ImageManager::device_free_image(Device * /*unused*/, size_t slot)
@@ -858,31 +1116,43 @@ void ImageManager::device_free_image(Device * /*unused*/, size_t slot)
 }
 
 void ImageManager::device_update(Device *device, Scene *scene, Progress &progress)
+{
+  device_update_async(device, scene, progress);
+  device_update_wait(scene);
+}
+
+void ImageManager::device_update_async(Device *device, Scene *scene, Progress &progress)
 {
   if (!need_update()) {
     return;
   }
 
-  const scoped_callback_timer timer([scene](double time) {
-    if (scene->update_stats) {
-      scene->update_stats->image.times.add_entry({"device_update", time});
-    }
-  });
-
-  TaskPool pool;
   for (size_t slot = 0; slot < images.size(); slot++) {
     Image *img = images[slot].get();
     if (img && img->users == 0) {
       device_free_image(device, slot);
     }
     else if (img && img->need_load) {
-      pool.push([this, device, scene, slot, &progress] {
+      load_pool.push([this, device, scene, slot, &progress] {
         device_load_image(device, scene, slot, progress);
       });
     }
   }
+}
 
-  pool.wait_work();
+void ImageManager::device_update_wait(Scene *scene)
+{
+  if (!need_update()) {
+    return;
+  }
+
+  const scoped_callback_timer timer([scene](double time) {
+    if (scene->update_stats) {
+      scene->update_stats->image.times.add_entry({"device_update", time});
+    }
+  });
+
+  load_pool.wait_work();
 
   need_update_ = false;
 }
@@ -936,6 +1206,9 @@ void ImageManager::device_free_builtin(Device *device)
 
 void ImageManager::device_free(Device *device)
 {
+  /* Background loads may still be in flight if an update was canceled. */
+  load_pool.wait_work();
+
   for (size_t slot = 0; slot < images.size(); slot++) {
     device_free_image(device, slot);
   }
@@ -9,6 +9,7 @@
 #include "scene/colorspace.h"
 
 #include "util/string.h"
+#include "util/task.h"
 #include "util/thread.h"
 #include "util/transform.h"
 #include "util/unique_ptr.h"
@@ -28,6 +29,20 @@ class Scene;
 class ColorSpaceProcessor;
 class VDBImageLoader;
 
+/* Storage precision an image user can tolerate on the device, ordered from
+ * least to most demanding. Users of the same image negotiate: the most
+ * demanding user wins. */
+enum ImageStoragePrecision {
+  /* 8 bits per channel is enough, for example when only the alpha channel
+   * is used. */
+  IMAGE_PRECISION_BYTE = 0,
+  /* Half float is enough, for example for color textures. */
+  IMAGE_PRECISION_HALF = 1,
+  /* Keep the precision of the source image, for displacement and other
+   * precision sensitive data. */
+  IMAGE_PRECISION_FULL = 2,
+};
+
 /* Image Parameters */
 class ImageParams {
  public:
@@ -38,6 +53,10 @@ class ImageParams {
   string colorspace;
   float frame = 0.0f;
 
+  /* Not part of the image key: users that tolerate different precisions
+   * still share the image, at the highest demanded precision. */
+  ImageStoragePrecision precision = IMAGE_PRECISION_FULL;
+
   ImageParams() : colorspace(u_colorspace_raw) {}
 
   bool operator==(const ImageParams &other) const
@@ -93,6 +112,11 @@ class ImageLoader {
   /* Load metadata without actual image yet, should be fast. */
   virtual bool load_metadata(const ImageDeviceFeatures &features, ImageMetaData &metadata) = 0;
 
+  /* Load data whose decoding can be deferred until the image is actually
+   * loaded for a device, so that metadata loading stays fast. May refine the
+   * metadata, such as the byte size of the decoded data. */
+  virtual bool load_deferred(ImageMetaData &metadata);
+
   /* Load actual image contents. */
   virtual bool load_pixels(const ImageMetaData &metadata,
                            void *pixels,
@@ -135,6 +159,10 @@ class ImageHandle {
 
   void clear();
 
+  /* Raise the storage precision demanded by this user, for example when the
+   * same image turns out to also be used for displacement. */
+  void require_precision(const ImageStoragePrecision precision);
+
   bool empty() const;
   int num_tiles() const;
   int num_svm_slots() const;
@@ -178,9 +206,30 @@ class ImageManager {
   void device_update_slot(Device *device, Scene *scene, const size_t slot, Progress &progress);
   void device_free(Device *device);
 
+  /* Start loading images in the background, so that texture I/O can overlap
+   * other scene updates like the BVH build. device_update_wait() must be
+   * called before the images are used for rendering. */
+  void device_update_async(Device *device, Scene *scene, Progress &progress);
+  void device_update_wait(Scene *scene);
+
   void device_load_builtin(Device *device, Scene *scene, Progress &progress);
   void device_free_builtin(Device *device);
 
+  /* Prefetch the image for an upcoming frame of an animated sequence on the background pool
+   * while the current frame renders, so that the next sync finds the slot already resident and
+   * frame advance does not block on texture I/O. The prefetcher keeps a user reference to each
+   * image it loaded; call release_prefetched_images() after the next frame has been synced, at
+   * which point the frame's own image users keep the loaded slots alive. Returns an empty
+   * handle without loading once the estimated decoded size of outstanding prefetched images
+   * would exceed memory_budget bytes. Must be called from the thread driving frame advance. */
+  ImageHandle prefetch_image(Device *device,
+                             Scene *scene,
+                             const string &filename,
+                             const ImageParams &params,
+                             const size_t memory_budget,
+                             Progress &progress);
+  void release_prefetched_images();
+
   void set_osl_texture_system(void *texture_system);
   bool set_animation_frame_update(const int frame);
 
@@ -198,6 +247,7 @@ class ImageManager {
     float frame;
     bool need_metadata;
     bool need_load;
+    bool loading;
     bool builtin;
 
     string mem_name;
@@ -216,20 +266,32 @@ class ImageManager {
   thread_mutex images_mutex;
   int animation_frame;
 
+  /* Background loading started by device_update_async(). The mutex and
+   * condition variable coordinate slot ownership between the pool tasks and
+   * concurrent device_update_slot() calls for the same slot. */
+  TaskPool load_pool;
+  thread_mutex load_mutex;
+  thread_condition_variable load_cond;
+
   vector<unique_ptr<Image>> images;
   void *osl_texture_system;
 
+  /* User references and estimated decoded size of images loaded ahead of the current frame. */
+  vector<ImageHandle> prefetched;
+  size_t prefetched_bytes;
+
   size_t add_image_slot(unique_ptr<ImageLoader> &&loader,
                         const ImageParams &params,
                         const bool builtin);
   void add_image_user(const size_t slot);
   void remove_image_user(const size_t slot);
+  void require_precision(const size_t slot, const ImageStoragePrecision precision);
   Image *get_image_slot(const size_t slot);
 
   void load_image_metadata(Image *img);
 
   template<TypeDesc::BASETYPE FileFormat, typename StorageType>
-  bool file_load_image(Image *img, const int texture_limit);
+  bool file_load_image(Image *img, const int texture_limit, const bool build_mip_levels);
 
   void device_load_image(Device *device, Scene *scene, const size_t slot, Progress &progress);
   void device_free_image(Device *device, const size_t slot);
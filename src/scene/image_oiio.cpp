@@ -257,10 +257,37 @@ string OIIOImageLoader::osl_filepath() const
   return filepath;
 }
 
+const string &OIIOImageLoader::content_hash() const
+{
+  if (!content_hash_computed_) {
+    content_hash_computed_ = true;
+
+    /* The process-level cache in path_content_hash() avoids re-reading the file when several
+     * loaders reference the same path across syncs. */
+    content_hash_ = path_content_hash(filepath);
+  }
+
+  return content_hash_;
+}
+
 bool OIIOImageLoader::equals(const ImageLoader &other) const
 {
   const OIIOImageLoader &other_loader = (const OIIOImageLoader &)other;
-  return filepath == other_loader.filepath;
+  if (filepath == other_loader.filepath) {
+    return true;
+  }
+
+  /* Assembled sets often reference one texture through several resolved paths, or ship identical
+   * copies of it. Treat files with equal content as the same image, so that they share a single
+   * slot and a single device texture. The file size filters out almost all pairs before any
+   * bytes are hashed, and the hash is computed at most once per loader. */
+  const size_t size = path_file_size(filepath);
+  if (size == 0 || size == (size_t)-1 || size != path_file_size(other_loader.filepath)) {
+    return false;
+  }
+
+  const string &hash = content_hash();
+  return !hash.empty() && hash == other_loader.content_hash();
 }
 
 }
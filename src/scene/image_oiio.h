@@ -27,7 +27,14 @@ class OIIOImageLoader : public ImageLoader {
   bool equals(const ImageLoader &other) const override;
 
  protected:
+  /* Hex digest of the file content, computed lazily for path-independent deduplication and
+   * cached for the lifetime of the loader. Empty when the file could not be read. */
+  const string &content_hash() const;
+
   string filepath;
+
+  mutable string content_hash_;
+  mutable bool content_hash_computed_ = false;
 };
 
 }
@@ -50,6 +50,25 @@ struct ToDenseOp {
 };
 
 #  ifdef WITH_NANOVDB
+/* Check if the NanoVDB conversion in ToNanoOp supports the grid type, without
+ * doing the expensive conversion itself. */
+struct NanoSupportedOp {
+  bool supported = false;
+
+  template<typename GridType, typename FloatGridType, typename FloatDataType, const int channels>
+  bool operator()(const openvdb::GridBase::ConstPtr & /*unused*/)
+  {
+    if constexpr (!std::is_same_v<GridType, openvdb::MaskGrid>) {
+      supported = std::is_same_v<FloatGridType, openvdb::FloatGrid> ||
+                  std::is_same_v<FloatGridType, openvdb::Vec3fGrid>;
+      return true;
+    }
+    else {
+      return false;
+    }
+  }
+};
+
 struct ToNanoOp {
   nanovdb::GridHandle<> nanogrid;
   int precision;
@@ -128,6 +147,35 @@ struct ToNanoOp {
 };
 #  endif
 
+/* Compute the transform from texture space to object space. NanoVDB grids are
+ * sampled in voxel index space, dense grids in the normalized space of their
+ * bounding box. */
+static Transform vdb_grid_transform(const openvdb::GridBase::ConstPtr &grid,
+                                    const openvdb::CoordBBox &bbox,
+                                    const bool use_index_space)
+{
+  openvdb::math::Mat4f grid_matrix = grid->transform().baseMap()->getAffineMap()->getMat4();
+  Transform index_to_object;
+  for (int col = 0; col < 4; col++) {
+    for (int row = 0; row < 3; row++) {
+      index_to_object[row][col] = (float)grid_matrix[col][row];
+    }
+  }
+
+  Transform texture_to_index;
+  if (use_index_space) {
+    texture_to_index = transform_identity();
+  }
+  else {
+    openvdb::Coord min = bbox.min();
+    openvdb::Coord dim = bbox.dim();
+    texture_to_index = transform_translate(min.x(), min.y(), min.z()) *
+                       transform_scale(dim.x(), dim.y(), dim.z());
+  }
+
+  return transform_inverse(index_to_object * texture_to_index);
+}
+
 VDBImageLoader::VDBImageLoader(openvdb::GridBase::ConstPtr grid_, const string &grid_name)
     : grid_name(grid_name), grid(grid_)
 {
@@ -153,21 +201,15 @@ bool VDBImageLoader::load_metadata(const ImageDeviceFeatures &features, ImageMet
 
   metadata.channels = op.num_channels;
 
-  /* Set data type. */
+  /* Set data type. The expensive NanoVDB conversion is deferred until the
+   * grid is actually loaded for a device, in load_deferred(). */
 #  ifdef WITH_NANOVDB
   if (features.has_nanovdb) {
-    /* NanoVDB expects no inactive leaf nodes. */
-#    if 0
-    openvdb::FloatGrid &pruned_grid = *openvdb::gridPtrCast<openvdb::FloatGrid>(grid);
-    openvdb::tools::pruneInactive(pruned_grid.tree());
-    nanogrid = nanovdb::openToNanoVDB(pruned_grid);
-#    endif
-    ToNanoOp op;
-    op.precision = precision;
+    NanoSupportedOp op;
     if (!openvdb::grid_type_operation(grid, op)) {
       return false;
     }
-    nanogrid = std::move(op.nanogrid);
+    use_nanovdb = op.supported;
   }
 #  endif
 
@@ -183,8 +225,9 @@ bool VDBImageLoader::load_metadata(const ImageDeviceFeatures &features, ImageMet
   metadata.depth = dim.z();
 
 #  ifdef WITH_NANOVDB
-  if (nanogrid) {
-    metadata.byte_size = nanogrid.size();
+  if (use_nanovdb) {
+    /* Byte size is only known after the conversion in load_deferred(). */
+    metadata.byte_size = 0;
     if (metadata.channels == 1) {
       if (precision == 0) {
         metadata.type = IMAGE_DATA_TYPE_NANOVDB_FPN;
@@ -211,29 +254,12 @@ bool VDBImageLoader::load_metadata(const ImageDeviceFeatures &features, ImageMet
     }
   }
 
-  /* Set transform from object space to voxel index. */
-  openvdb::math::Mat4f grid_matrix = grid->transform().baseMap()->getAffineMap()->getMat4();
-  Transform index_to_object;
-  for (int col = 0; col < 4; col++) {
-    for (int row = 0; row < 3; row++) {
-      index_to_object[row][col] = (float)grid_matrix[col][row];
-    }
-  }
-
-  Transform texture_to_index;
+  /* Set transform from object space to texture space. */
 #  ifdef WITH_NANOVDB
-  if (nanogrid) {
-    texture_to_index = transform_identity();
-  }
-  else
+  metadata.transform_3d = vdb_grid_transform(grid, bbox, use_nanovdb);
+#  else
+  metadata.transform_3d = vdb_grid_transform(grid, bbox, false);
 #  endif
-  {
-    openvdb::Coord min = bbox.min();
-    texture_to_index = transform_translate(min.x(), min.y(), min.z()) *
-                       transform_scale(dim.x(), dim.y(), dim.z());
-  }
-
-  metadata.transform_3d = transform_inverse(index_to_object * texture_to_index);
   metadata.use_transform_3d = true;
 
 #  ifndef WITH_NANOVDB
@@ -247,6 +273,42 @@ bool VDBImageLoader::load_metadata(const ImageDeviceFeatures &features, ImageMet
 #endif
 }
 
+bool VDBImageLoader::load_deferred(ImageMetaData &metadata)
+{
+#if defined(WITH_OPENVDB) && defined(WITH_NANOVDB)
+  if (!use_nanovdb || nanogrid) {
+    return true;
+  }
+
+  /* NanoVDB expects no inactive leaf nodes. */
+#  if 0
+  openvdb::FloatGrid &pruned_grid = *openvdb::gridPtrCast<openvdb::FloatGrid>(grid);
+  openvdb::tools::pruneInactive(pruned_grid.tree());
+  nanogrid = nanovdb::openToNanoVDB(pruned_grid);
+#  endif
+  ToNanoOp op;
+  op.precision = precision;
+  openvdb::grid_type_operation(grid, op);
+  nanogrid = std::move(op.nanogrid);
+
+  if (nanogrid) {
+    metadata.byte_size = nanogrid.size();
+  }
+  else {
+    /* Conversion failed, fall back to a dense grid. */
+    use_nanovdb = false;
+    metadata.byte_size = 0;
+    metadata.type = (metadata.channels == 1) ? IMAGE_DATA_TYPE_FLOAT : IMAGE_DATA_TYPE_FLOAT4;
+    metadata.transform_3d = vdb_grid_transform(grid, bbox, false);
+  }
+
+  return true;
+#else
+  (void)metadata;
+  return true;
+#endif
+}
+
 bool VDBImageLoader::load_pixels(const ImageMetaData & /*metadata*/,
                                  void *pixels,
                                  const size_t /*pixels_size*/,
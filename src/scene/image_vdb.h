@@ -31,6 +31,8 @@ class VDBImageLoader : public ImageLoader {
 
   bool load_metadata(const ImageDeviceFeatures &features, ImageMetaData &metadata) override;
 
+  bool load_deferred(ImageMetaData &metadata) override;
+
   bool load_pixels(const ImageMetaData &metadata,
                    void *pixels,
                    const size_t pixels_size,
@@ -55,6 +57,9 @@ class VDBImageLoader : public ImageLoader {
   openvdb::CoordBBox bbox;
 #endif
 #ifdef WITH_NANOVDB
+  /* Whether the grid will be converted to NanoVDB. The conversion itself is
+   * deferred until the grid is loaded for a device. */
+  bool use_nanovdb = false;
   nanovdb::GridHandle<> nanogrid;
   int precision = 0;
 #endif
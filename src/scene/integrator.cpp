@@ -125,6 +125,7 @@ NODE_DEFINE(Integrator)
   sampling_pattern_enum.insert("blue_noise_pure", SAMPLING_PATTERN_BLUE_NOISE_PURE);
   sampling_pattern_enum.insert("blue_noise_round", SAMPLING_PATTERN_BLUE_NOISE_ROUND);
   sampling_pattern_enum.insert("blue_noise_first", SAMPLING_PATTERN_BLUE_NOISE_FIRST);
+  sampling_pattern_enum.insert("automatic", SAMPLING_PATTERN_AUTOMATIC);
   SOCKET_ENUM(sampling_pattern,
               "Sampling Pattern",
               sampling_pattern_enum,
@@ -277,6 +278,14 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
   const int clamped_aa_samples = min(aa_samples, MAX_SAMPLES);
 
   kintegrator->sampling_pattern = sampling_pattern;
+  if (kintegrator->sampling_pattern == SAMPLING_PATTERN_AUTOMATIC) {
+    /* Blue noise gives the most even perceptual distribution at the low sample
+     * counts used for previews. With adaptive sampling the number of samples
+     * per pixel varies, so only dither the first sample; otherwise use a full
+     * sequence rounded up to a power of two. */
+    kintegrator->sampling_pattern = use_adaptive_sampling ? SAMPLING_PATTERN_BLUE_NOISE_FIRST :
+                                                            SAMPLING_PATTERN_BLUE_NOISE_ROUND;
+  }
   kintegrator->scrambling_distance = scrambling_distance;
   kintegrator->sobol_index_mask = reverse_integer_bits(next_power_of_two(clamped_aa_samples - 1) -
                                                        1);
@@ -325,14 +334,7 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
       dscene->sample_pattern_lut.free();
     }
     float4 *directions = (float4 *)dscene->sample_pattern_lut.alloc(table_size);
-    TaskPool pool;
-    for (int j = 0; j < NUM_TAB_SOBOL_PATTERNS; ++j) {
-      float4 *sequence = directions + j * sequence_size;
-      pool.push([sequence, sequence_size, j] {
-        tabulated_sobol_generate_4D(sequence, sequence_size, j);
-      });
-    }
-    pool.wait_work();
+    tabulated_sobol_generate_table(directions, sequence_size, NUM_TAB_SOBOL_PATTERNS);
 
     dscene->sample_pattern_lut.copy_to_device();
   }
@@ -0,0 +1,97 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "scene/layer.h"
+
+#include "graph/node.h"
+#include "graph/node_type.h"
+
+#include "scene/geometry.h"
+#include "scene/light.h"
+#include "scene/scene.h"
+#include "scene/shader.h"
+#include "scene/shader_graph.h"
+
+namespace ccl {
+
+/* Node reference sockets are reference counted through Node::set() and cannot
+ * be blindly copied back, so the layer does not track them. */
+static bool layer_skip_socket(const SocketType &socket)
+{
+  return socket.type == SocketType::NODE || socket.type == SocketType::NODE_ARRAY;
+}
+
+void SceneLayer::capture_node(Node *node, Shader *shader)
+{
+  if (node->type->create == nullptr) {
+    return;
+  }
+
+  unique_ptr<Node> state = node->type->create(node->type);
+
+  for (const SocketType &socket : node->type->inputs) {
+    if (layer_skip_socket(socket)) {
+      continue;
+    }
+    state->copy_value(socket, *node, socket);
+  }
+
+  nodes_.push_back({node, shader, std::move(state)});
+}
+
+void SceneLayer::capture(Scene *scene)
+{
+  nodes_.clear();
+
+  for (Shader *shader : scene->shaders) {
+    for (ShaderNode *node : shader->graph->nodes) {
+      if (node->special_type == SHADER_SPECIAL_TYPE_OSL) {
+        /* OSL nodes have per-instance socket layouts and variable size
+         * allocation, a shadow copy through the node type is not possible. */
+        continue;
+      }
+      capture_node(node, shader);
+    }
+  }
+
+  for (Geometry *geom : scene->geometry) {
+    if (geom->is_light()) {
+      capture_node(static_cast<Light *>(geom), nullptr);
+    }
+  }
+}
+
+void SceneLayer::restore(Scene *scene)
+{
+  for (CapturedNode &captured : nodes_) {
+    Node *node = captured.node;
+
+    bool modified = false;
+    for (const SocketType &socket : node->type->inputs) {
+      if (layer_skip_socket(socket)) {
+        continue;
+      }
+      if (!node->equals_value(*captured.state, socket)) {
+        node->copy_value(socket, *captured.state, socket);
+        modified = true;
+      }
+    }
+
+    if (!modified) {
+      continue;
+    }
+
+    /* copy_value() does not track modified sockets, conservatively tag the
+     * whole node and its manager. */
+    node->tag_modified();
+    if (captured.shader) {
+      captured.shader->tag_update(scene);
+    }
+    else {
+      static_cast<Light *>(node)->tag_update(scene);
+    }
+  }
+}
+
+}
@@ -0,0 +1,57 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "util/unique_ptr.h"
+#include "util/vector.h"
+
+namespace ccl {
+
+struct Node;
+class Scene;
+class Shader;
+
+/* Scene Layer
+ *
+ * Lightweight layering for rendering variants of a shared base scene. Capture
+ * the shader and light state once the base scene is synced, override materials
+ * and lights for a variant, render, then restore before building the next
+ * variant. Restore only tags the shaders and lights whose values were
+ * overridden, so the tag based incremental update re-syncs just those managers
+ * and the geometry sync and BVH build are paid once for all variants.
+ *
+ * Only socket values are covered. Changing graph topology, or adding and
+ * removing nodes, is not tracked and needs the usual full shader re-sync. */
+
+class SceneLayer {
+ public:
+  /* Capture the socket values of all shaders and lights in the scene. */
+  void capture(Scene *scene);
+
+  /* Restore the captured values, tagging the modified shaders and lights so
+   * only their managers re-sync on the next scene update. */
+  void restore(Scene *scene);
+
+  bool empty() const
+  {
+    return nodes_.empty();
+  }
+
+ protected:
+  void capture_node(Node *node, Shader *shader);
+
+  struct CapturedNode {
+    /* Live node in the scene. */
+    Node *node;
+    /* Owning shader to tag on restore, null for lights. */
+    Shader *shader;
+    /* Shadow node of the same type holding the captured socket values. */
+    unique_ptr<Node> state;
+  };
+
+  vector<CapturedNode> nodes_;
+};
+
+}
@@ -19,10 +19,13 @@
 
 #include "integrator/shader_eval.h"
 
+#include "util/algorithm.h"
 #include "util/hash.h"
 #include "util/log.h"
 #include "util/path.h"
 #include "util/progress.h"
+#include "util/string.h"
+#include "util/tbb.h"
 
 namespace ccl {
 
@@ -47,22 +50,25 @@ static void shade_background_pixels(Device *device,
       size,
       num_channels,
       [&](device_vector<KernelShaderEvalInput> &d_input) {
-        /* Fill coordinates for shading. */
+        /* Fill coordinates for shading, in parallel since for 8k environment
+         * maps these host-side loops are not far behind the evaluation itself. */
         KernelShaderEvalInput *d_input_data = d_input.data();
 
-        for (int y = 0; y < height; y++) {
-          for (int x = 0; x < width; x++) {
-            float const u = (x + 0.5f) / width;
-            float const v = (y + 0.5f) / height;
-
-            KernelShaderEvalInput in;
-            in.object = OBJECT_NONE;
-            in.prim = PRIM_NONE;
-            in.u = u;
-            in.v = v;
-            d_input_data[x + y * width] = in;
+        parallel_for(blocked_range<int>(0, height), [&](const blocked_range<int> &r) {
+          for (int y = r.begin(); y != r.end(); y++) {
+            for (int x = 0; x < width; x++) {
+              float const u = (x + 0.5f) / width;
+              float const v = (y + 0.5f) / height;
+
+              KernelShaderEvalInput in;
+              in.object = OBJECT_NONE;
+              in.prim = PRIM_NONE;
+              in.u = u;
+              in.v = v;
+              d_input_data[x + y * width] = in;
+            }
           }
-        }
+        });
 
         return size;
       },
@@ -70,13 +76,15 @@ static void shade_background_pixels(Device *device,
         /* Copy output to pixel buffer. */
         float *d_output_data = d_output.data();
 
-        for (int y = 0; y < height; y++) {
-          for (int x = 0; x < width; x++) {
-            pixels[y * width + x].x = d_output_data[(y * width + x) * num_channels + 0];
-            pixels[y * width + x].y = d_output_data[(y * width + x) * num_channels + 1];
-            pixels[y * width + x].z = d_output_data[(y * width + x) * num_channels + 2];
+        parallel_for(blocked_range<int>(0, height), [&](const blocked_range<int> &r) {
+          for (int y = r.begin(); y != r.end(); y++) {
+            for (int x = 0; x < width; x++) {
+              pixels[y * width + x].x = d_output_data[(y * width + x) * num_channels + 0];
+              pixels[y * width + x].y = d_output_data[(y * width + x) * num_channels + 1];
+              pixels[y * width + x].z = d_output_data[(y * width + x) * num_channels + 2];
+            }
           }
-        }
+        });
       });
 }
 
@@ -187,6 +195,7 @@ LightManager::LightManager()
   need_update_background = true;
   last_background_enabled = false;
   last_background_resolution = 0;
+  last_background_average_radiance = 0.0f;
 }
 
 bool LightManager::has_background_light(Scene *scene)
@@ -287,76 +296,22 @@ static uint light_object_shader_flags(Object *object)
   return shader_flag;
 }
 
-void LightManager::device_update_distribution(Device * /*unused*/,
-                                              DeviceScene *dscene,
-                                              Scene *scene,
-                                              Progress &progress)
+/* Append the CDF over the emitters in the given light link set to the distribution array,
+ * in the layout the kernel binary searches. Writes the emitter count and the triangle and
+ * lamp selection PDFs for the set, and returns the total unnormalized area. */
+static float light_distribution_append(Scene *scene,
+                                       const uint64_t light_link_mask,
+                                       vector<KernelLightDistribution> &distribution,
+                                       int &num_emitters,
+                                       float &pdf_triangles,
+                                       float &pdf_lights)
 {
-  KernelIntegrator *kintegrator = &dscene->data.integrator;
-  if (kintegrator->use_light_tree) {
-    dscene->light_distribution.free();
-    return;
-  }
-
-  /* Update CDF over lights. */
-  progress.set_status("Updating Lights", "Computing distribution");
-
-  /* Counts emissive triangles in the scene. */
-  size_t num_triangles = 0;
-
-  const int num_lights = kintegrator->num_lights;
-  const size_t max_num_triangles = std::numeric_limits<int>::max() - 1 - kintegrator->num_lights;
-  for (Object *object : scene->objects) {
-    if (progress.get_cancel()) {
-      return;
-    }
-
-    if (!object->usable_as_light()) {
-      continue;
-    }
-
-    /* Count emissive triangles. */
-    Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
-    const int mesh_num_triangles = static_cast<int>(mesh->num_triangles());
-
-    for (int i = 0; i < mesh_num_triangles; i++) {
-      const int shader_index = mesh->get_shader()[i];
-      Shader *shader = (shader_index < mesh->get_used_shaders().size()) ?
-                           static_cast<Shader *>(mesh->get_used_shaders()[shader_index]) :
-                           scene->default_surface;
-
-      if (shader->emission_sampling != EMISSION_SAMPLING_NONE) {
-        num_triangles++;
-      }
-    }
-
-    if (num_triangles > max_num_triangles) {
-      progress.set_error(
-          "Number of emissive triangles exceeds the limit, consider using Light Tree or disabling "
-          "Emission Sampling on some emissive materials");
-    }
-  }
-
-  const size_t num_distribution = num_triangles + num_lights;
-
-  /* Distribution size. */
-  kintegrator->num_distribution = num_distribution;
-
-  VLOG_INFO << "Use light distribution with " << num_distribution << " emitters.";
-
-  /* Emission area. */
-  KernelLightDistribution *distribution = dscene->light_distribution.alloc(num_distribution + 1);
+  const size_t start = distribution.size();
   float totarea = 0.0f;
 
   /* Triangles. */
-  size_t offset = 0;
-
   for (Object *object : scene->objects) {
-    if (progress.get_cancel()) {
-      return;
-    }
-
-    if (!object->usable_as_light()) {
+    if (!object->usable_as_light() || !(object->get_light_set_membership() & light_link_mask)) {
       continue;
     }
     /* Sum area. */
@@ -373,11 +328,12 @@ void LightManager::device_update_distribution(Device * /*unused*/,
                            scene->default_surface;
 
       if (shader->emission_sampling != EMISSION_SAMPLING_NONE) {
-        distribution[offset].totarea = totarea;
-        distribution[offset].prim = i + mesh->prim_offset;
-        distribution[offset].shader_flag = shader_flag;
-        distribution[offset].object_id = object->index;
-        offset++;
+        KernelLightDistribution kdistribution;
+        kdistribution.totarea = totarea;
+        kdistribution.prim = i + mesh->prim_offset;
+        kdistribution.shader_flag = shader_flag;
+        kdistribution.object_id = object->index;
+        distribution.push_back(kdistribution);
 
         const Mesh::Triangle t = mesh->get_triangle(i);
         if (!t.valid(mesh->get_verts().data())) {
@@ -401,44 +357,155 @@ void LightManager::device_update_distribution(Device * /*unused*/,
   const float trianglearea = totarea;
 
   /* Lights. */
-  int light_index = 0;
+  int num_set_lights = 0;
+  for (Object *object : scene->objects) {
+    if (!object->get_geometry()->is_light()) {
+      continue;
+    }
+    if (static_cast<Light *>(object->get_geometry())->get_is_enabled() &&
+        (object->get_light_set_membership() & light_link_mask))
+    {
+      num_set_lights++;
+    }
+  }
 
-  if (num_lights > 0) {
-    const float lightarea = (totarea > 0.0f) ? totarea / num_lights : 1.0f;
+  if (num_set_lights > 0) {
+    const float lightarea = (totarea > 0.0f) ? totarea / num_set_lights : 1.0f;
+    /* The lamp index enumerates all enabled lights of the scene, also the ones which are
+     * not members of this set, to keep it consistent with the device lights array. */
+    int light_index = 0;
     for (Object *object : scene->objects) {
       if (!object->get_geometry()->is_light()) {
         continue;
       }
 
       Light *light = static_cast<Light *>(object->get_geometry());
-      if (!light->is_enabled) {
+      if (!light->get_is_enabled()) {
         continue;
       }
 
-      distribution[offset].totarea = totarea;
-      distribution[offset].prim = ~light_index;
-      distribution[offset].object_id = object->index;
-      distribution[offset].shader_flag = 0;
-      totarea += lightarea;
+      if (object->get_light_set_membership() & light_link_mask) {
+        KernelLightDistribution kdistribution;
+        kdistribution.totarea = totarea;
+        kdistribution.prim = ~light_index;
+        kdistribution.object_id = object->index;
+        kdistribution.shader_flag = 0;
+        distribution.push_back(kdistribution);
+        totarea += lightarea;
+      }
 
       light_index++;
-      offset++;
     }
   }
 
-  /* normalize cumulative distribution functions */
-  distribution[num_distribution].totarea = totarea;
-  distribution[num_distribution].prim = 0;
-  distribution[num_distribution].object_id = OBJECT_NONE;
-  distribution[num_distribution].shader_flag = 0;
+  /* Normalize cumulative distribution function, with a closing entry serving as the
+   * upper bound of the binary search. */
+  KernelLightDistribution kdistribution;
+  kdistribution.totarea = totarea;
+  kdistribution.prim = 0;
+  kdistribution.object_id = OBJECT_NONE;
+  kdistribution.shader_flag = 0;
+  distribution.push_back(kdistribution);
 
   if (totarea > 0.0f) {
-    for (size_t i = 0; i < num_distribution; i++) {
+    for (size_t i = start; i + 1 < distribution.size(); i++) {
       distribution[i].totarea /= totarea;
     }
-    distribution[num_distribution].totarea = 1.0f;
+    distribution.back().totarea = 1.0f;
+  }
+
+  num_emitters = distribution.size() - start - 1;
+
+  /* Precompute pdfs for distribution sampling.
+   * Sample one, with 0.5 probability of light or triangle. */
+  pdf_triangles = 0.0f;
+  pdf_lights = 0.0f;
+
+  if (trianglearea > 0.0f) {
+    pdf_triangles = 1.0f / trianglearea;
+    if (num_set_lights) {
+      pdf_triangles *= 0.5f;
+    }
+  }
+
+  if (num_set_lights) {
+    pdf_lights = 1.0f / num_set_lights;
+    if (trianglearea > 0.0f) {
+      pdf_lights *= 0.5f;
+    }
   }
 
+  return totarea;
+}
+
+void LightManager::device_update_distribution(Device * /*unused*/,
+                                              DeviceScene *dscene,
+                                              Scene *scene,
+                                              Progress &progress)
+{
+  KernelIntegrator *kintegrator = &dscene->data.integrator;
+  if (kintegrator->use_light_tree) {
+    dscene->light_distribution.free();
+    return;
+  }
+
+  /* Update CDF over lights. */
+  progress.set_status("Updating Lights", "Computing distribution");
+
+  /* Counts emissive triangles in the scene. */
+  size_t num_triangles = 0;
+
+  const int num_lights = kintegrator->num_lights;
+  const size_t max_num_triangles = std::numeric_limits<int>::max() - 1 - kintegrator->num_lights;
+  for (Object *object : scene->objects) {
+    if (progress.get_cancel()) {
+      return;
+    }
+
+    if (!object->usable_as_light()) {
+      continue;
+    }
+
+    /* Count emissive triangles. */
+    Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
+    const int mesh_num_triangles = static_cast<int>(mesh->num_triangles());
+
+    for (int i = 0; i < mesh_num_triangles; i++) {
+      const int shader_index = mesh->get_shader()[i];
+      Shader *shader = (shader_index < mesh->get_used_shaders().size()) ?
+                           static_cast<Shader *>(mesh->get_used_shaders()[shader_index]) :
+                           scene->default_surface;
+
+      if (shader->emission_sampling != EMISSION_SAMPLING_NONE) {
+        num_triangles++;
+      }
+    }
+
+    if (num_triangles > max_num_triangles) {
+      progress.set_error(
+          "Number of emissive triangles exceeds the limit, consider using Light Tree or disabling "
+          "Emission Sampling on some emissive materials");
+    }
+  }
+
+  const size_t num_distribution = num_triangles + num_lights;
+
+  /* Distribution size. */
+  kintegrator->num_distribution = num_distribution;
+
+  VLOG_INFO << "Use light distribution with " << num_distribution << " emitters.";
+
+  vector<KernelLightDistribution> distribution;
+  distribution.reserve(num_distribution + 1);
+
+  int num_emitters = 0;
+  const float totarea = light_distribution_append(scene,
+                                                  LIGHT_LINK_MASK_ALL,
+                                                  distribution,
+                                                  num_emitters,
+                                                  kintegrator->distribution_pdf_triangles,
+                                                  kintegrator->distribution_pdf_lights);
+
   if (progress.get_cancel()) {
     return;
   }
@@ -446,26 +513,50 @@ void LightManager::device_update_distribution(Device * /*unused*/,
   /* Update integrator state. */
   kintegrator->use_direct_light = (totarea > 0.0f);
 
-  /* Precompute pdfs for distribution sampling.
-   * Sample one, with 0.5 probability of light or triangle. */
-  kintegrator->distribution_pdf_triangles = 0.0f;
-  kintegrator->distribution_pdf_lights = 0.0f;
+  /* Specialized distributions for light linking, so that emitter selection for a receiver
+   * only ever considers the emitters which are linked to it. */
+  KernelLightLinkSet *klight_link_sets = dscene->data.light_link_sets;
+  memset(klight_link_sets, 0, sizeof(dscene->data.light_link_sets));
 
-  if (trianglearea > 0.0f) {
-    kintegrator->distribution_pdf_triangles = 1.0f / trianglearea;
-    if (num_lights) {
-      kintegrator->distribution_pdf_triangles *= 0.5f;
+  bool use_light_linking = false;
+  uint64_t receiver_used = 1;
+  for (Object *object : scene->objects) {
+    if (object->has_light_linking()) {
+      use_light_linking = true;
     }
+    const uint receiver_set = object->get_receiver_light_set() >= LIGHT_LINK_SET_MAX ?
+                                  0 :
+                                  object->get_receiver_light_set();
+    receiver_used |= uint64_t(1) << uint64_t(receiver_set);
   }
 
-  if (num_lights) {
-    kintegrator->distribution_pdf_lights = 1.0f / num_lights;
-    if (trianglearea > 0.0f) {
-      kintegrator->distribution_pdf_lights *= 0.5f;
+  if (use_light_linking) {
+    for (uint64_t set_index = 0; set_index < LIGHT_LINK_SET_MAX; set_index++) {
+      if (!(receiver_used & (uint64_t(1) << set_index))) {
+        continue;
+      }
+
+      KernelLightLinkSet &klight_link_set = klight_link_sets[set_index];
+      klight_link_set.distribution_offset = distribution.size();
+      light_distribution_append(scene,
+                                uint64_t(1) << set_index,
+                                distribution,
+                                klight_link_set.num_distribution,
+                                klight_link_set.distribution_pdf_triangles,
+                                klight_link_set.distribution_pdf_lights);
     }
+
+    VLOG_INFO << "Specialized light distribution for light linking, with "
+              << distribution.size() - (num_distribution + 1) << " additional entries.";
+  }
+
+  if (progress.get_cancel()) {
+    return;
   }
 
   /* Copy distribution to device. */
+  KernelLightDistribution *kdistribution = dscene->light_distribution.alloc(distribution.size());
+  memcpy(kdistribution, distribution.data(), distribution.size() * sizeof(*kdistribution));
   dscene->light_distribution.copy_to_device();
 }
 
@@ -779,6 +870,9 @@ void LightManager::device_update_tree(Device * /*unused*/,
 {
   KernelIntegrator *kintegrator = &dscene->data.integrator;
 
+  /* Any rebuild (or removal) of the tree invalidates the incremental cache. */
+  light_tree_light_measures.clear();
+
   if (!kintegrator->use_light_tree) {
     return;
   }
@@ -867,6 +961,27 @@ void LightManager::device_update_tree(Device * /*unused*/,
               << light_link_nodes.size() - light_tree.num_nodes << " additional nodes.";
   }
 
+  /* Snapshot per-light measures, so that later pure energy edits can be patched
+   * into the flattened tree without a rebuild. Specialized linking trees
+   * duplicate nodes, which the in-place patching does not handle. */
+  if (root && !use_light_linking) {
+    light_tree_light_measures.resize(kintegrator->num_lights);
+    for (size_t i = 0; i < num_emitters; i++) {
+      const LightTreeEmitter &emitter = flatten.emitters[i];
+      if (!emitter.is_light()) {
+        continue;
+      }
+
+      LightMeasureCache &cache = light_tree_light_measures[~emitter.light_id];
+      cache.bbox_min = emitter.measure.bbox.min;
+      cache.bbox_max = emitter.measure.bbox.max;
+      cache.bcone_axis = emitter.measure.bcone.axis;
+      cache.theta_o = emitter.measure.bcone.theta_o;
+      cache.theta_e = emitter.measure.bcone.theta_e;
+      cache.energy = emitter.measure.energy;
+    }
+  }
+
   /* Copy arrays to device. */
   dscene->light_tree_nodes.copy_to_device();
   dscene->light_tree_emitters.copy_to_device();
@@ -876,6 +991,121 @@ void LightManager::device_update_tree(Device * /*unused*/,
   dscene->triangle_to_tree.copy_to_device();
 }
 
+/* Merge dirty indices into contiguous ranges and copy each range to the device. */
+template<typename T>
+static void light_tree_copy_dirty_to_device(device_vector<T> &array, vector<int> &indices)
+{
+  sort(indices.begin(), indices.end());
+
+  size_t i = 0;
+  while (i < indices.size()) {
+    const int range_begin = indices[i];
+    int range_end = range_begin + 1;
+    while (++i < indices.size() && indices[i] <= range_end) {
+      range_end = indices[i] + 1;
+    }
+
+    array.copy_to_device(range_begin, range_end - range_begin);
+  }
+}
+
+bool LightManager::device_update_tree_incremental(DeviceScene *dscene, Scene *scene)
+{
+  const KernelIntegrator *kintegrator = &dscene->data.integrator;
+  if (!kintegrator->use_light_tree || light_tree_light_measures.empty()) {
+    return false;
+  }
+
+  KernelLightTreeNode *knodes = dscene->light_tree_nodes.data();
+  KernelLightTreeEmitter *kemitters = dscene->light_tree_emitters.data();
+  const uint *light_array = dscene->light_to_tree.data();
+  if (!knodes || !kemitters || !light_array) {
+    return false;
+  }
+
+  /* Recompute the measure of every enabled light, in the same order the tree
+   * construction enumerates them. Only a pure energy change keeps the tree
+   * topology and bounds intact; everything else needs the full rebuild. */
+  vector<std::pair<int, float>> new_energies;
+  int device_light_index = 0;
+  for (Object *object : scene->objects) {
+    if (!object->get_geometry()->is_light()) {
+      continue;
+    }
+    Light *light = static_cast<Light *>(object->get_geometry());
+    if (!light->is_enabled) {
+      continue;
+    }
+    if (device_light_index >= (int)light_tree_light_measures.size()) {
+      /* A light got enabled since the last build. */
+      return false;
+    }
+
+    const LightTreeEmitter emitter(scene, ~device_light_index, object->index);
+    const LightTreeMeasure &measure = emitter.measure;
+    const LightMeasureCache &cache = light_tree_light_measures[device_light_index];
+    if (measure.bbox.min != cache.bbox_min || measure.bbox.max != cache.bbox_max ||
+        measure.bcone.axis != cache.bcone_axis || measure.bcone.theta_o != cache.theta_o ||
+        measure.bcone.theta_e != cache.theta_e)
+    {
+      return false;
+    }
+    if (measure.energy != cache.energy) {
+      /* Zero energy emitters are skipped when accumulating node measures, so
+       * switching to or from zero is not a plain energy delta. */
+      if (measure.energy == 0.0f || cache.energy == 0.0f) {
+        return false;
+      }
+      new_energies.emplace_back(device_light_index, measure.energy);
+    }
+
+    device_light_index++;
+  }
+  if (device_light_index != (int)light_tree_light_measures.size()) {
+    /* A light got disabled since the last build. */
+    return false;
+  }
+
+  /* Patch the emitters, and every node on the path from the root down to them.
+   * Node energies are plain sums over the emitters below them, so adding the
+   * delta along the path gives the exact same result as a rebuild. */
+  vector<int> dirty_nodes;
+  vector<int> dirty_emitters;
+  for (const auto &[light_index, new_energy] : new_energies) {
+    const int emitter_index = light_array[light_index];
+    KernelLightTreeEmitter &kemitter = kemitters[emitter_index];
+    const float delta = new_energy - light_tree_light_measures[light_index].energy;
+    kemitter.energy = new_energy;
+    dirty_emitters.push_back(emitter_index);
+
+    /* Descend along the bit trail, the same way the kernel traverses. */
+    uint bit_trail = kemitter.bit_trail;
+    int node_index = 0;
+    for (;;) {
+      KernelLightTreeNode &knode = knodes[node_index];
+      knode.energy += delta;
+      dirty_nodes.push_back(node_index);
+
+      if (knode.num_emitters >= 0) {
+        break;
+      }
+
+      bit_trail >>= knode.bit_skip;
+      node_index = (bit_trail & 1) ? knode.inner.right_child : knode.inner.left_child;
+      bit_trail >>= 1;
+    }
+
+    light_tree_light_measures[light_index].energy = new_energy;
+  }
+
+  VLOG_INFO << "Patched " << new_energies.size() << " emitters in the light tree in place.";
+
+  light_tree_copy_dirty_to_device(dscene->light_tree_nodes, dirty_nodes);
+  light_tree_copy_dirty_to_device(dscene->light_tree_emitters, dirty_emitters);
+
+  return true;
+}
+
 static void background_cdf(int start,
                            const int end,
                            const int res_x,
@@ -953,6 +1183,9 @@ void LightManager::device_update_background(Device *device,
     kbackground->map_res_x = 0;
     kbackground->map_res_y = 0;
     kbackground->use_mis = (kbackground->portal_weight > 0.0f);
+    dscene->light_background_marginal_cdf.free();
+    dscene->light_background_conditional_cdf.free();
+    last_background_map_hash.clear();
     return;
   }
 
@@ -1041,6 +1274,24 @@ void LightManager::device_update_background(Device *device,
   kbackground->map_res_x = res.x;
   kbackground->map_res_y = res.y;
 
+  /* The importance map only depends on the background shader and the map
+   * resolution, while the update flag is set conservatively (IES slot changes,
+   * or the shader being tagged without an actual content change). Key the CDFs
+   * on the shader graph content hash so unrelated light edits skip the rebuild,
+   * which for 8k environments is by far the most expensive part of the sync. */
+  if (shader->graph->content_hash.empty()) {
+    shader->graph->compute_content_hash();
+  }
+  const string map_hash = shader->graph->content_hash +
+                          string_printf("_%dx%d", res.x, res.y);
+  if (map_hash == last_background_map_hash &&
+      dscene->light_background_conditional_cdf.size() == (size_t)(res.x + 1) * res.y)
+  {
+    background_light->set_average_radiance(last_background_average_radiance);
+    VLOG_WORK << "Background shader is unchanged, reusing importance map.";
+    return;
+  }
+
   vector<float3> pixels;
   shade_background_pixels(device, dscene, res.x, res.y, pixels, progress);
 
@@ -1100,6 +1351,9 @@ void LightManager::device_update_background(Device *device,
   /* update device */
   dscene->light_background_marginal_cdf.copy_to_device();
   dscene->light_background_conditional_cdf.copy_to_device();
+
+  last_background_map_hash = map_hash;
+  last_background_average_radiance = background_light->get_average_radiance();
 }
 
 void LightManager::device_update_lights(DeviceScene *dscene, Scene *scene)
@@ -1383,7 +1637,21 @@ void LightManager::device_update(Device *device,
   /* Detect which lights are enabled, also determines if we need to update the background. */
   test_enabled_lights(scene);
 
-  device_free(device, dscene, need_update_background);
+  /* When only light parameters changed, try patching the new energies into the
+   * existing light tree instead of rebuilding all device arrays. */
+  if (update_flags == LIGHT_MODIFIED && !need_update_background &&
+      device_update_tree_incremental(dscene, scene))
+  {
+    device_update_lights(dscene, scene);
+    device_update_ies(dscene);
+
+    update_flags = UPDATE_NONE;
+    return;
+  }
+
+  /* The background importance map is freed (or reused) by
+   * device_update_background itself, based on the shader content hash. */
+  device_free(device, dscene, false);
 
   device_update_lights(dscene, scene);
   if (progress.get_cancel()) {
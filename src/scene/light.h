@@ -11,6 +11,7 @@
 #include "scene/geometry.h"
 
 #include "util/ies.h"
+#include "util/string.h"
 #include "util/thread.h"
 #include "util/types.h"
 #include "util/unique_ptr.h"
@@ -125,6 +126,9 @@ class LightManager {
   void test_enabled_lights(Scene *scene);
 
   void device_update_lights(DeviceScene *dscene, Scene *scene);
+  /* Patch light energies in the existing light tree, instead of a full rebuild.
+   * Returns false when the change can not be expressed as an in-place update. */
+  bool device_update_tree_incremental(DeviceScene *dscene, Scene *scene);
   void device_update_distribution(Device *device,
                                   DeviceScene *dscene,
                                   Scene *scene,
@@ -145,9 +149,25 @@ class LightManager {
   vector<unique_ptr<IESSlot>> ies_slots;
   thread_mutex ies_mutex;
 
+  /* Snapshot of the per-light measures from the last full light tree build,
+   * indexed by device light index. Empty when the last build can not be
+   * updated incrementally (light linking, or no tree at all). */
+  struct LightMeasureCache {
+    float3 bbox_min, bbox_max;
+    float3 bcone_axis;
+    float theta_o, theta_e;
+    float energy;
+  };
+  vector<LightMeasureCache> light_tree_light_measures;
+
   bool last_background_enabled;
   int last_background_resolution;
 
+  /* Background shader content hash and resolution from the last importance map
+   * build, used to reuse the CDFs when only unrelated lights changed. */
+  string last_background_map_hash;
+  float last_background_average_radiance;
+
   uint32_t update_flags;
 };
 
@@ -10,6 +10,7 @@
 #include "scene/object.h"
 #include "util/math_fast.h"
 #include "util/progress.h"
+#include "util/tbb.h"
 
 namespace ccl {
 
@@ -535,9 +536,29 @@ bool LightTree::should_split(LightTreeEmitter *emitters,
 
   middle = (start + end) / 2;
 
+  /* Nodes near the root cover all emitters while only few subtree tasks exist yet, so the
+   * linear passes over large ranges are run in parallel. Growing a bounding box only takes
+   * min/max, so the reduction is exact regardless of the order chunks are joined in. */
   BoundBox centroid_bbox = BoundBox::empty;
-  for (int i = start; i < end; i++) {
-    centroid_bbox.grow((emitters + i)->centroid);
+  if (num_emitters > MIN_EMITTERS_PER_THREAD) {
+    centroid_bbox = parallel_reduce(
+        blocked_range<int>(start, end, MIN_EMITTERS_PER_THREAD),
+        BoundBox(BoundBox::empty),
+        [emitters](const blocked_range<int> &range, BoundBox bbox) {
+          for (int i = range.begin(); i != range.end(); i++) {
+            bbox.grow((emitters + i)->centroid);
+          }
+          return bbox;
+        },
+        [](BoundBox bbox_a, const BoundBox &bbox_b) {
+          bbox_a.grow(bbox_b);
+          return bbox_a;
+        });
+  }
+  else {
+    for (int i = start; i < end; i++) {
+      centroid_bbox.grow((emitters + i)->centroid);
+    }
   }
 
   const float3 extent = centroid_bbox.size();
@@ -566,16 +587,47 @@ bool LightTree::should_split(LightTreeEmitter *emitters,
     else {
       /* Fill in buckets with emitters. */
       inv_extent = 1 / (centroid_bbox.size()[dim]);
-      for (int i = start; i < end; i++) {
-        const LightTreeEmitter *emitter = emitters + i;
-
-        /* Place emitter into the appropriate bucket, where the centroid box is split into equal
-         * partitions. */
-        int bucket_idx = LightTreeBucket::num_buckets *
-                         (emitter->centroid[dim] - centroid_bbox.min[dim]) * inv_extent;
-        bucket_idx = clamp(bucket_idx, 0, LightTreeBucket::num_buckets - 1);
-
-        buckets[bucket_idx].add(*emitter);
+      const auto bin_emitters = [&](std::array<LightTreeBucket, LightTreeBucket::num_buckets>
+                                        &bin_buckets,
+                                    const int bin_start,
+                                    const int bin_end) {
+        for (int i = bin_start; i < bin_end; i++) {
+          const LightTreeEmitter *emitter = emitters + i;
+
+          /* Place emitter into the appropriate bucket, where the centroid box is split into
+           * equal partitions. */
+          int bucket_idx = LightTreeBucket::num_buckets *
+                           (emitter->centroid[dim] - centroid_bbox.min[dim]) * inv_extent;
+          bucket_idx = clamp(bucket_idx, 0, LightTreeBucket::num_buckets - 1);
+
+          bin_buckets[bucket_idx].add(*emitter);
+        }
+      };
+
+      if (num_emitters > MIN_EMITTERS_PER_THREAD) {
+        /* Bin fixed-size chunks in parallel and merge them in order afterwards, so that the
+         * accumulated measures do not depend on the thread scheduling. */
+        const int num_chunks = divide_up(num_emitters, MIN_EMITTERS_PER_THREAD);
+        vector<std::array<LightTreeBucket, LightTreeBucket::num_buckets>> chunk_buckets(
+            num_chunks);
+        parallel_for(blocked_range<int>(0, num_chunks, 1),
+                     [&](const blocked_range<int> &range) {
+                       for (int chunk = range.begin(); chunk != range.end(); chunk++) {
+                         const int chunk_start = start + chunk * MIN_EMITTERS_PER_THREAD;
+                         const int chunk_end = min(chunk_start + (int)MIN_EMITTERS_PER_THREAD,
+                                                   end);
+                         bin_emitters(chunk_buckets[chunk], chunk_start, chunk_end);
+                       }
+                     });
+
+        for (const auto &chunk : chunk_buckets) {
+          for (int i = 0; i < LightTreeBucket::num_buckets; i++) {
+            buckets[i] = buckets[i] + chunk[i];
+          }
+        }
+      }
+      else {
+        bin_emitters(buckets, start, end);
       }
     }
 
@@ -124,8 +124,8 @@ static void mikk_compute_tangents(Attribute *attr_uv, Mesh *mesh, const bool nee
   const float3 *normal = attr_vN->data_float3();
   const float2 *uv = (attr_uv) ? attr_uv->data_float2() : nullptr;
 
-  const string name = string((attr_uv) ? attr_uv->name + ".tangent" :
-                                           Attribute::standard_name(ATTR_STD_UV_TANGENT));
+  const string name = (attr_uv) ? attr_uv->name.str() + ".tangent" :
+                                  string(Attribute::standard_name(ATTR_STD_UV_TANGENT));
   Attribute *attr;
   if (attr_uv == nullptr || attr_uv->std == ATTR_STD_UV) {
     attr = attributes.add(ATTR_STD_UV_TANGENT, name);
@@ -137,9 +137,9 @@ static void mikk_compute_tangents(Attribute *attr_uv, Mesh *mesh, const bool nee
   /* Create bitangent sign attribute. */
   float *tangent_sign = nullptr;
   if (need_sign) {
-    const string name_sign = string((attr_uv) ?
-                                          attr_uv->name + ".tangent_sign" :
-                                          Attribute::standard_name(ATTR_STD_UV_TANGENT_SIGN));
+    const string name_sign = (attr_uv) ?
+                                 attr_uv->name.str() + ".tangent_sign" :
+                                 string(Attribute::standard_name(ATTR_STD_UV_TANGENT_SIGN));
     Attribute *attr_sign;
     if (attr_uv == nullptr || attr_uv->std == ATTR_STD_UV) {
       attr_sign = attributes.add(ATTR_STD_UV_TANGENT_SIGN, name_sign);
@@ -793,7 +793,7 @@ void Mesh::update_tangents(Scene *scene)
       continue;
     }
 
-    const string tangent_name = string(attr.name + ".tangent");
+    const string tangent_name = attr.name.str() + ".tangent";
 
     if (need_attribute(scene, tangent_name) && !attributes.find(tangent_name)) {
       mikk_compute_tangents(&attr, this, true); /* sign */
@@ -856,17 +856,20 @@ void Mesh::pack_normals(packed_float3 *vnormal)
 
 void Mesh::pack_verts(packed_float3 *tri_verts, packed_uint3 *tri_vindex)
 {
-  const size_t verts_size = verts.size();
   const size_t triangles_size = num_triangles();
   const int *p_tris = triangles.data();
   int off = 0;
-  for (size_t i = 0; i < verts_size; i++) {
-    tri_verts[i] = verts[i];
-  }
   for (size_t i = 0; i < triangles_size; i++) {
-    tri_vindex[i] = make_packed_uint3(p_tris[off + 0] + vert_offset,
-                                      p_tris[off + 1] + vert_offset,
-                                      p_tris[off + 2] + vert_offset);
+    const int v0 = p_tris[off + 0];
+    const int v1 = p_tris[off + 1];
+    const int v2 = p_tris[off + 2];
+    /* Vertex positions are stored unpacked per triangle, so that intersection and shading read
+     * the three vertices from consecutive memory instead of gathering through tri_vindex. The
+     * index triplet is kept for vertex attribute and normal lookups. */
+    tri_verts[i * 3 + 0] = verts[v0];
+    tri_verts[i * 3 + 1] = verts[v1];
+    tri_verts[i * 3 + 2] = verts[v2];
+    tri_vindex[i] = make_packed_uint3(v0 + vert_offset, v1 + vert_offset, v2 + vert_offset);
     off += 3;
   }
 }
@@ -883,4 +886,14 @@ PrimitiveType Mesh::primitive_type() const
   return has_motion_blur() ? PRIMITIVE_MOTION_TRIANGLE : PRIMITIVE_TRIANGLE;
 }
 
+bool Mesh::bvh_topology_modified() const
+{
+  /* Vertex positions may deform freely, anything that changes the triangle
+   * or subdivision topology needs a rebuild. */
+  return triangles_is_modified() || subd_start_corner_is_modified() ||
+         subd_num_corners_is_modified() || subd_shader_is_modified() ||
+         subd_smooth_is_modified() || subd_ptex_offset_is_modified() ||
+         subd_face_corners_is_modified();
+}
+
 }
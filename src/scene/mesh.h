@@ -223,6 +223,8 @@ class Mesh : public Geometry {
   bool has_motion_blur() const override;
   PrimitiveType primitive_type() const override;
 
+  bool bvh_topology_modified() const override;
+
   void tessellate(SubdParams &params);
 
   SubdFace get_subd_face(const size_t index) const;
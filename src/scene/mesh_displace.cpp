@@ -12,9 +12,13 @@
 #include "scene/shader.h"
 
 #include "util/progress.h"
+#include "util/tbb.h"
 
 namespace ccl {
 
+static const size_t TRIANGLES_PER_TASK = 4096;
+static const size_t VERTS_PER_TASK = 4096;
+
 /* Fill in coordinates for mesh displacement shader evaluation on device. */
 static int fill_shader_input(const Scene *scene,
                              const Mesh *mesh,
@@ -95,12 +99,12 @@ static void read_shader_output(const Scene *scene,
 
   const int num_verts = mesh_verts.size();
   const int num_motion_steps = mesh->get_motion_steps();
-  vector<bool> done(num_verts, false);
 
-  const float *d_output_data = d_output.data();
+  /* Replay the traversal order of fill_shader_input() to find the output index
+   * of each displaced vertex, so that the offsets can be applied in parallel. */
+  vector<int> vert_output_index(num_verts, -1);
   int d_output_index = 0;
 
-  Attribute *attr_mP = mesh->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION);
   const int num_triangles = mesh->num_triangles();
   for (int i = 0; i < num_triangles; i++) {
     const Mesh::Triangle t = mesh->get_triangle(i);
@@ -114,69 +118,47 @@ static void read_shader_output(const Scene *scene,
     }
 
     for (int j = 0; j < 3; j++) {
-      if (!done[t.v[j]]) {
-        done[t.v[j]] = true;
-        float3 off = make_float3(d_output_data[d_output_index + 0],
-                                 d_output_data[d_output_index + 1],
-                                 d_output_data[d_output_index + 2]);
+      if (vert_output_index[t.v[j]] == -1) {
+        vert_output_index[t.v[j]] = d_output_index;
         d_output_index += 3;
-
-        /* Avoid illegal vertex coordinates. */
-        off = ensure_finite(off);
-        mesh_verts[t.v[j]] += off;
-        if (attr_mP != nullptr) {
-          for (int step = 0; step < num_motion_steps - 1; step++) {
-            float3 *mP = attr_mP->data_float3() + step * num_verts;
-            mP[t.v[j]] += off;
-          }
-        }
       }
     }
   }
-}
-
-bool GeometryManager::displace(Device *device, Scene *scene, Mesh *mesh, Progress &progress)
-{
-  /* verify if we have a displacement shader */
-  if (!mesh->has_true_displacement()) {
-    return false;
-  }
 
-  const size_t num_verts = mesh->verts.size();
-  const size_t num_triangles = mesh->num_triangles();
+  const float *d_output_data = d_output.data();
 
-  if (num_triangles == 0) {
-    return false;
-  }
+  Attribute *attr_mP = mesh->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION);
+  float3 *mP_data = (attr_mP != nullptr) ? attr_mP->data_float3() : nullptr;
 
-  const string msg = string_printf("Computing Displacement %s", mesh->name.c_str());
-  progress.set_status("Updating Mesh", msg);
+  parallel_for(
+      blocked_range<int>(0, num_verts, VERTS_PER_TASK), [&](const blocked_range<int> &r) {
+        for (int vert = r.begin(); vert != r.end(); vert++) {
+          const int output_index = vert_output_index[vert];
+          if (output_index == -1) {
+            continue;
+          }
 
-  /* find object index. todo: is arbitrary */
-  size_t object_index = OBJECT_NONE;
+          float3 off = make_float3(d_output_data[output_index + 0],
+                                   d_output_data[output_index + 1],
+                                   d_output_data[output_index + 2]);
 
-  for (size_t i = 0; i < scene->objects.size(); i++) {
-    if (scene->objects[i]->get_geometry() == mesh) {
-      object_index = i;
-      break;
-    }
-  }
+          /* Avoid illegal vertex coordinates. */
+          off = ensure_finite(off);
+          mesh_verts[vert] += off;
+          if (mP_data != nullptr) {
+            for (int step = 0; step < num_motion_steps - 1; step++) {
+              mP_data[step * num_verts + vert] += off;
+            }
+          }
+        }
+      });
+}
 
-  /* Evaluate shader on device. */
-  ShaderEval shader_eval(device, progress);
-  if (!shader_eval.eval(
-          SHADER_EVAL_DISPLACE,
-          num_verts,
-          3,
-          [scene, mesh, object_index](device_vector<KernelShaderEvalInput> &d_input) {
-            return fill_shader_input(scene, mesh, object_index, d_input);
-          },
-          [scene, mesh](const device_vector<float> &d_output) {
-            read_shader_output(scene, mesh, d_output);
-          }))
-  {
-    return false;
-  }
+/* Rebuild vertex normals from the displaced vertex positions. */
+void GeometryManager::displace_update_normals(const Scene *scene, Mesh *mesh)
+{
+  const size_t num_verts = mesh->verts.size();
+  const size_t num_triangles = mesh->num_triangles();
 
   /* For displacement method both, we don't need to recompute the vertex normals
    * as bump mapping in the shader will already alter the vertex normal, so we start
@@ -205,60 +187,71 @@ bool GeometryManager::displace(Device *device, Scene *scene, Mesh *mesh, Progres
                              shader->get_displacement_method() == DISPLACE_TRUE;
     }
 
-    /* static vertex normals */
-
-    /* get attributes */
-    Attribute *attr_vN = mesh->attributes.find(ATTR_STD_VERTEX_NORMAL);
-    float3 *vN = attr_vN->data_float3();
-
-    /* compute vertex normals */
+    vector<bool> vert_has_true_disp(num_verts, false);
 
-    /* zero vertex normals on triangles with true displacement */
     for (size_t i = 0; i < num_triangles; i++) {
       if (tri_has_true_disp[i]) {
         const Mesh::Triangle triangle = mesh->get_triangle(i);
         for (size_t j = 0; j < 3; j++) {
-          vN[triangle.v[j]] = zero_float3();
+          vert_has_true_disp[triangle.v[j]] = true;
         }
       }
     }
 
-    /* add face normals to vertex normals */
-    const float3 *verts_data = mesh->get_verts().data();
-    for (size_t i = 0; i < num_triangles; i++) {
-      if (tri_has_true_disp[i]) {
-        const Mesh::Triangle triangle = mesh->get_triangle(i);
-        const float3 fN = triangle.compute_normal(verts_data);
-
-        for (size_t j = 0; j < 3; j++) {
-          const int vert = triangle.v[j];
-          vN[vert] += fN;
+    /* Face normals of triangles with true displacement, computed in parallel
+     * as this is the expensive part of rebuilding the normals. */
+    vector<float3> face_normals(num_triangles);
+
+    const auto compute_face_normals = [&](const float3 *verts_data) {
+      parallel_for(blocked_range<size_t>(0, num_triangles, TRIANGLES_PER_TASK),
+                   [&](const blocked_range<size_t> &r) {
+                     for (size_t i = r.begin(); i != r.end(); i++) {
+                       if (tri_has_true_disp[i]) {
+                         face_normals[i] = mesh->get_triangle(i).compute_normal(verts_data);
+                       }
+                     }
+                   });
+    };
+
+    const auto rebuild_vertex_normals = [&](float3 *vN) {
+      /* zero vertex normals on vertices with true displacement */
+      parallel_for(blocked_range<size_t>(0, num_verts, VERTS_PER_TASK),
+                   [&](const blocked_range<size_t> &r) {
+                     for (size_t vert = r.begin(); vert != r.end(); vert++) {
+                       if (vert_has_true_disp[vert]) {
+                         vN[vert] = zero_float3();
+                       }
+                     }
+                   });
+
+      /* add face normals to vertex normals, serial due to the scatter */
+      for (size_t i = 0; i < num_triangles; i++) {
+        if (tri_has_true_disp[i]) {
+          const Mesh::Triangle triangle = mesh->get_triangle(i);
+          for (size_t j = 0; j < 3; j++) {
+            vN[triangle.v[j]] += face_normals[i];
+          }
         }
       }
-    }
-
-    /* normalize vertex normals */
-    vector<bool> done(num_verts, false);
-
-    for (size_t i = 0; i < num_triangles; i++) {
-      if (tri_has_true_disp[i]) {
-        const Mesh::Triangle triangle = mesh->get_triangle(i);
-        for (size_t j = 0; j < 3; j++) {
-          const int vert = triangle.v[j];
-
-          if (done[vert]) {
-            continue;
-          }
 
-          vN[vert] = normalize(vN[vert]);
-          if (flip) {
-            vN[vert] = -vN[vert];
-          }
+      /* normalize vertex normals */
+      parallel_for(blocked_range<size_t>(0, num_verts, VERTS_PER_TASK),
+                   [&](const blocked_range<size_t> &r) {
+                     for (size_t vert = r.begin(); vert != r.end(); vert++) {
+                       if (vert_has_true_disp[vert]) {
+                         vN[vert] = normalize(vN[vert]);
+                         if (flip) {
+                           vN[vert] = -vN[vert];
+                         }
+                       }
+                     }
+                   });
+    };
 
-          done[vert] = true;
-        }
-      }
-    }
+    /* static vertex normals */
+    Attribute *attr_vN = mesh->attributes.find(ATTR_STD_VERTEX_NORMAL);
+    compute_face_normals(mesh->get_verts().data());
+    rebuild_vertex_normals(attr_vN->data_float3());
 
     /* motion vertex normals */
     Attribute *attr_mP = mesh->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION);
@@ -269,58 +262,54 @@ bool GeometryManager::displace(Device *device, Scene *scene, Mesh *mesh, Progres
         float3 *mP = attr_mP->data_float3() + step * mesh->verts.size();
         float3 *mN = attr_mN->data_float3() + step * mesh->verts.size();
 
-        /* compute */
-
-        /* zero vertex normals on triangles with true displacement */
-        for (size_t i = 0; i < num_triangles; i++) {
-          if (tri_has_true_disp[i]) {
-            const Mesh::Triangle triangle = mesh->get_triangle(i);
-            for (size_t j = 0; j < 3; j++) {
-              mN[triangle.v[j]] = zero_float3();
-            }
-          }
-        }
-
-        /* add face normals to vertex normals */
-        for (size_t i = 0; i < num_triangles; i++) {
-          if (tri_has_true_disp[i]) {
-            const Mesh::Triangle triangle = mesh->get_triangle(i);
-            const float3 fN = triangle.compute_normal(mP);
+        compute_face_normals(mP);
+        rebuild_vertex_normals(mN);
+      }
+    }
+  }
+}
 
-            for (size_t j = 0; j < 3; j++) {
-              const int vert = triangle.v[j];
-              mN[vert] += fN;
-            }
-          }
-        }
+void GeometryManager::displace(
+    ShaderEval &shader_eval, Scene *scene, Mesh *mesh, Progress &progress, bool &displacement_done)
+{
+  /* verify if we have a displacement shader */
+  if (!mesh->has_true_displacement()) {
+    return;
+  }
 
-        /* normalize vertex normals */
-        vector<bool> done(num_verts, false);
+  const size_t num_verts = mesh->verts.size();
+  const size_t num_triangles = mesh->num_triangles();
 
-        for (size_t i = 0; i < num_triangles; i++) {
-          if (tri_has_true_disp[i]) {
-            const Mesh::Triangle triangle = mesh->get_triangle(i);
-            for (size_t j = 0; j < 3; j++) {
-              const int vert = triangle.v[j];
+  if (num_triangles == 0) {
+    return;
+  }
 
-              if (done[vert]) {
-                continue;
-              }
+  const string msg = string_printf("Computing Displacement %s", mesh->name.c_str());
+  progress.set_status("Updating Mesh", msg);
 
-              mN[vert] = normalize(mN[vert]);
-              if (flip) {
-                mN[vert] = -mN[vert];
-              }
+  /* find object index. todo: is arbitrary */
+  size_t object_index = OBJECT_NONE;
 
-              done[vert] = true;
-            }
-          }
-        }
-      }
+  for (size_t i = 0; i < scene->objects.size(); i++) {
+    if (scene->objects[i]->get_geometry() == mesh) {
+      object_index = i;
+      break;
     }
   }
 
-  return true;
+  /* Queue shader evaluation on device, batched with other geometry. */
+  shader_eval.eval_queue(
+      SHADER_EVAL_DISPLACE,
+      num_verts,
+      3,
+      [scene, mesh, object_index](device_vector<KernelShaderEvalInput> &d_input) {
+        return fill_shader_input(scene, mesh, object_index, d_input);
+      },
+      [this, scene, mesh, &displacement_done](const device_vector<float> &d_output) {
+        read_shader_output(scene, mesh, d_output);
+        displace_update_normals(scene, mesh);
+        displacement_done = true;
+      });
 }
 
 }
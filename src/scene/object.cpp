@@ -5,6 +5,7 @@
 #include "scene/object.h"
 
 #include "device/device.h"
+#include "scene/bake.h"
 #include "scene/camera.h"
 #include "scene/curves.h"
 #include "scene/hair.h"
@@ -42,9 +43,30 @@ struct UpdateObjectTransformState {
    */
   map<ParticleSystem *, int> particle_offset;
 
+  /* Data shared by all instances of a geometry, precomputed up front so the
+   * per-object update does not repeat attribute and size lookups for every
+   * instance. Only used for read during the parallel update. */
+  struct GeometryData {
+    int primitive_type;
+    int num_geom_steps;
+    int num_motion_verts;
+    /* SD_OBJECT_HAS_VERTEX_MOTION / SD_OBJECT_HAS_VOLUME_MOTION. */
+    uint flag;
+    float velocity_scale;
+    bool use_motion_blur;
+    bool is_volume_object_space;
+    bool is_hair;
+    bool is_pointcloud;
+    bool is_volume;
+  };
+  unordered_map<const Geometry *, GeometryData> geometry_data;
+
   /* Motion offsets for each object. */
   array<uint> motion_offset;
 
+  /* Inverted object transforms, computed in batch before the per-object update. */
+  array<Transform> object_itfm;
+
   /* Packed object arrays. Those will be filled in. */
   uint *object_flag;
   uint *object_visibility;
@@ -450,19 +472,6 @@ ObjectManager::ObjectManager()
 
 ObjectManager::~ObjectManager() = default;
 
-static float object_volume_density(const Transform &tfm, Geometry *geom)
-{
-  if (geom->is_volume()) {
-    /* Volume density automatically adjust to object scale. */
-    if (static_cast<Volume *>(geom)->get_object_space()) {
-      const float3 unit = normalize(one_float3());
-      return 1.0f / len(transform_direction(&tfm, unit));
-    }
-  }
-
-  return 1.0f;
-}
-
 static int object_num_motion_verts(Geometry *geom)
 {
   return (geom->is_mesh() || geom->is_volume()) ? static_cast<Mesh *>(geom)->get_verts().size() :
@@ -480,11 +489,13 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
   Transform *object_motion_pass = state->object_motion_pass;
 
   Geometry *geom = ob->geometry;
+  const UpdateObjectTransformState::GeometryData &gdata =
+      state->geometry_data.find(geom)->second;
   uint flag = 0;
 
   /* Compute transformations. */
   const Transform tfm = ob->tfm;
-  const Transform itfm = transform_inverse(tfm);
+  const Transform itfm = state->object_itfm[ob->index];
 
   const float3 color = ob->color;
   const float pass_id = ob->pass_id;
@@ -495,7 +506,10 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
 
   kobject.tfm = tfm;
   kobject.itfm = itfm;
-  kobject.volume_density = object_volume_density(tfm, geom);
+  /* Volume density automatically adjust to object scale. */
+  kobject.volume_density = gdata.is_volume_object_space ?
+                               1.0f / len(transform_direction(&tfm, normalize(one_float3()))) :
+                               1.0f;
   kobject.color[0] = color.x;
   kobject.color[1] = color.y;
   kobject.color[2] = color.z;
@@ -504,6 +518,8 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
   kobject.random_number = random_number;
   kobject.particle_index = particle_index;
   kobject.motion_offset = 0;
+  kobject.motion_lerp_offset = 0;
+  kobject.num_tfm_lerp_steps = 0;
   kobject.ao_distance = ob->ao_distance;
   kobject.receiver_light_set = ob->receiver_light_set >= LIGHT_LINK_SET_MAX ?
                                    0 :
@@ -514,7 +530,7 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
                                    ob->blocker_shadow_set;
   kobject.shadow_set_membership = ob->shadow_set_membership;
 
-  if (geom->get_use_motion_blur()) {
+  if (gdata.use_motion_blur) {
     state->have_motion = true;
   }
 
@@ -522,28 +538,9 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
     flag |= SD_OBJECT_NEGATIVE_SCALE;
   }
 
-  /* TODO: why not check hair? */
-  if (geom->is_pointcloud()) {
-    if (geom->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION)) {
-      flag |= SD_OBJECT_HAS_VERTEX_MOTION;
-    }
-  }
-  else if (geom->is_mesh()) {
-    Mesh *mesh = static_cast<Mesh *>(geom);
-    if (mesh->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION) ||
-        (mesh->get_subdivision_type() != Mesh::SUBDIVISION_NONE &&
-         mesh->subd_attributes.find(ATTR_STD_MOTION_VERTEX_POSITION)))
-    {
-      flag |= SD_OBJECT_HAS_VERTEX_MOTION;
-    }
-  }
-  else if (geom->is_volume()) {
-    Volume *volume = static_cast<Volume *>(geom);
-    if (volume->attributes.find(ATTR_STD_VOLUME_VELOCITY) && volume->get_velocity_scale() != 0.0f)
-    {
-      flag |= SD_OBJECT_HAS_VOLUME_MOTION;
-      kobject.velocity_scale = volume->get_velocity_scale();
-    }
+  flag |= gdata.flag;
+  if (gdata.flag & SD_OBJECT_HAS_VOLUME_MOTION) {
+    kobject.velocity_scale = gdata.velocity_scale;
   }
 
   if (state->need_motion == Scene::MOTION_PASS) {
@@ -581,7 +578,24 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
       /* Decompose transforms for interpolation. */
       if (ob->tfm_is_modified() || ob->motion_is_modified() || update_all) {
         DecomposedTransform *decomp = state->object_motion + kobject.motion_offset;
-        transform_motion_decompose(decomp, ob->motion.data(), ob->motion.size());
+        const size_t num_steps = ob->motion.size();
+
+        /* Reuse the previous decomposition when the motion transforms did
+         * not change beyond epsilon. */
+        bool unchanged = (ob->decomposed_motion.size() == num_steps);
+        for (size_t i = 0; unchanged && i < num_steps; i++) {
+          unchanged = transform_equal_approx(ob->decomposed_motion[i], ob->motion[i]);
+        }
+
+        if (unchanged) {
+          memcpy(decomp, ob->motion_decomposed.data(), sizeof(DecomposedTransform) * num_steps);
+        }
+        else {
+          transform_motion_decompose(decomp, ob->motion.data(), num_steps);
+          ob->decomposed_motion = ob->motion;
+          ob->motion_decomposed.resize(num_steps);
+          memcpy(ob->motion_decomposed.data(), decomp, sizeof(DecomposedTransform) * num_steps);
+        }
       }
 
       flag |= SD_OBJECT_MOTION;
@@ -595,9 +609,9 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
   kobject.dupli_generated[2] = ob->dupli_generated[2];
   kobject.dupli_uv[0] = ob->dupli_uv[0];
   kobject.dupli_uv[1] = ob->dupli_uv[1];
-  kobject.num_geom_steps = (geom->get_motion_steps() - 1) / 2;
+  kobject.num_geom_steps = gdata.num_geom_steps;
   kobject.num_tfm_steps = ob->motion.size();
-  kobject.numverts = object_num_motion_verts(geom);
+  kobject.numverts = gdata.num_motion_verts;
   kobject.attribute_map_offset = 0;
 
   if (ob->asset_name_is_modified() || update_all) {
@@ -613,7 +627,7 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
   kobject.shadow_terminator_geometry_offset = ob->shadow_terminator_geometry_offset;
 
   kobject.visibility = ob->visibility_for_tracing();
-  kobject.primitive_type = geom->primitive_type();
+  kobject.primitive_type = gdata.primitive_type;
 
   /* Object shadow caustics flag */
   if (ob->is_caustics_caster) {
@@ -631,13 +645,13 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
   state->object_volume_step[ob->index] = FLT_MAX;
 
   /* Have curves. */
-  if (geom->is_hair()) {
+  if (gdata.is_hair) {
     state->have_curves = true;
   }
-  if (geom->is_pointcloud()) {
+  if (gdata.is_pointcloud) {
     state->have_points = true;
   }
-  if (geom->is_volume()) {
+  if (gdata.is_volume) {
     state->have_volumes = true;
   }
 
@@ -653,7 +667,9 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
 
 void ObjectManager::device_update_prim_offsets(Device *device, DeviceScene *dscene, Scene *scene)
 {
-  if (!scene->integrator->get_use_light_tree()) {
+  /* Multi-object baking reads the per-object offsets to globalize the primitive indices of the
+   * bake primitive pass, regardless of the BVH layout. */
+  if (!scene->integrator->get_use_light_tree() && !scene->bake_manager->get_baking()) {
     const BVHLayoutMask layout_mask = device->get_bvh_layout_mask(dscene->data.kernel_features);
     if (layout_mask != BVH_LAYOUT_METAL && layout_mask != BVH_LAYOUT_MULTI_METAL &&
         layout_mask != BVH_LAYOUT_MULTI_METAL_EMBREE && layout_mask != BVH_LAYOUT_HIPRT &&
@@ -684,6 +700,84 @@ void ObjectManager::device_update_prim_offsets(Device *device, DeviceScene *dsce
   dscene->object_prim_offset.clear_modified();
 }
 
+/* Maximum rotation angle covered by one segment of the piecewise-linear motion
+ * transform table. With a segment angle of 0.1 radians the error of linearly
+ * interpolating the composed matrices instead of doing a full slerp stays
+ * below ~0.13% of the rotation, well under a pixel for typical shutters. */
+static const float MOTION_LERP_MAX_SEGMENT_ANGLE = 0.1f;
+
+/* Cap on the table size per object. Objects rotating fast enough to need more
+ * segments keep using the exact per-ray slerp interpolation. */
+static const int MOTION_LERP_MAX_STEPS = 64;
+
+void ObjectManager::device_update_motion_lerp(UpdateObjectTransformState *state,
+                                              DeviceScene *dscene,
+                                              Scene *scene)
+{
+  KernelObject *kobjects = state->objects;
+  const DecomposedTransform *object_motion = state->object_motion;
+
+  /* Size the table, refining each object's motion segments until a linear
+   * interpolation of the composed matrices is within the error bound. */
+  vector<int> num_lerp_steps(scene->objects.size(), 0);
+  size_t num_lerp_transforms = 0;
+
+  for (Object *ob : scene->objects) {
+    if (!ob->use_motion()) {
+      continue;
+    }
+
+    const KernelObject &kobject = kobjects[ob->index];
+    const int num_steps = kobject.num_tfm_steps;
+    if (num_steps < 2) {
+      continue;
+    }
+
+    const DecomposedTransform *decomp = object_motion + kobject.motion_offset;
+
+    float max_angle = 0.0f;
+    for (int step = 0; step < num_steps - 1; step++) {
+      const float costheta = fabsf(dot(decomp[step].x, decomp[step + 1].x));
+      max_angle = max(max_angle, 2.0f * acosf(clamp(costheta, 0.0f, 1.0f)));
+    }
+
+    const int refine = max((int)ceilf(max_angle / MOTION_LERP_MAX_SEGMENT_ANGLE), 1);
+    const int steps = (num_steps - 1) * refine;
+    if (steps >= MOTION_LERP_MAX_STEPS) {
+      /* Rotating too fast for a reasonably sized table, keep the slerp path. */
+      continue;
+    }
+
+    num_lerp_steps[ob->index] = steps;
+    num_lerp_transforms += steps + 1;
+  }
+
+  Transform *lerp = dscene->object_motion_lerp.alloc(num_lerp_transforms);
+
+  /* Fill the table by sampling the exact slerp interpolation. The original
+   * step times land on table samples, so the knots are reproduced exactly. */
+  uint offset = 0;
+  for (Object *ob : scene->objects) {
+    const int steps = num_lerp_steps[ob->index];
+    if (steps == 0) {
+      continue;
+    }
+
+    KernelObject &kobject = kobjects[ob->index];
+    const DecomposedTransform *decomp = object_motion + kobject.motion_offset;
+
+    kobject.motion_lerp_offset = offset;
+    kobject.num_tfm_lerp_steps = steps;
+
+    for (int step = 0; step <= steps; step++) {
+      transform_motion_array_interpolate(
+          &lerp[offset + step], decomp, kobject.num_tfm_steps, (float)step / steps);
+    }
+
+    offset += steps + 1;
+  }
+}
+
 void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene, Progress &progress)
 {
   UpdateObjectTransformState state;
@@ -706,6 +800,15 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
                                                                 scene->objects.size());
   }
   else if (state.need_motion == Scene::MOTION_BLUR) {
+    /* Clear motion arrays if there is no actual motion. Independent per
+     * object, so this runs in parallel ahead of the serial offset sum. */
+    parallel_for(blocked_range<size_t>(0, scene->objects.size(), 64),
+                 [&](const blocked_range<size_t> &r) {
+                   for (size_t i = r.begin(); i != r.end(); i++) {
+                     scene->objects[i]->update_motion();
+                   }
+                 });
+
     /* Set object offsets into global object motion array. */
     uint *motion_offsets = state.motion_offset.resize(scene->objects.size());
     uint motion_offset = 0;
@@ -713,9 +816,6 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
     for (Object *ob : scene->objects) {
       *motion_offsets = motion_offset;
       motion_offsets++;
-
-      /* Clear motion array if there is no actual motion. */
-      ob->update_motion();
       motion_offset += ob->motion.size();
     }
 
@@ -731,12 +831,70 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
     numparticles += psys->particles.size();
   }
 
+  /* Hoist per-geometry lookups out of the per-object update; with heavy
+   * instancing the same geometry is visited many times. */
+  state.geometry_data.reserve(scene->geometry.size());
+  for (Geometry *geom : scene->geometry) {
+    UpdateObjectTransformState::GeometryData data;
+    data.primitive_type = geom->primitive_type();
+    data.num_geom_steps = (geom->get_motion_steps() - 1) / 2;
+    data.num_motion_verts = object_num_motion_verts(geom);
+    data.flag = 0;
+    data.velocity_scale = 0.0f;
+    data.use_motion_blur = geom->get_use_motion_blur();
+    data.is_volume_object_space = false;
+    data.is_hair = geom->is_hair();
+    data.is_pointcloud = geom->is_pointcloud();
+    data.is_volume = geom->is_volume();
+
+    /* TODO: why not check hair? */
+    if (geom->is_pointcloud()) {
+      if (geom->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION)) {
+        data.flag |= SD_OBJECT_HAS_VERTEX_MOTION;
+      }
+    }
+    else if (geom->is_mesh()) {
+      Mesh *mesh = static_cast<Mesh *>(geom);
+      if (mesh->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION) ||
+          (mesh->get_subdivision_type() != Mesh::SUBDIVISION_NONE &&
+           mesh->subd_attributes.find(ATTR_STD_MOTION_VERTEX_POSITION)))
+      {
+        data.flag |= SD_OBJECT_HAS_VERTEX_MOTION;
+      }
+    }
+    else if (geom->is_volume()) {
+      Volume *volume = static_cast<Volume *>(geom);
+      if (volume->attributes.find(ATTR_STD_VOLUME_VELOCITY) &&
+          volume->get_velocity_scale() != 0.0f)
+      {
+        data.flag |= SD_OBJECT_HAS_VOLUME_MOTION;
+        data.velocity_scale = volume->get_velocity_scale();
+      }
+      data.is_volume_object_space = volume->get_object_space();
+    }
+
+    state.geometry_data.emplace(geom, data);
+  }
+
   /* as all the arrays are the same size, checking only dscene.objects is sufficient */
   const bool update_all = dscene->objects.need_realloc();
 
-  /* Parallel object update, with grain size to avoid too much threading overhead
-   * for individual objects. */
+  /* Grain size to avoid too much threading overhead for individual objects. */
   static const int OBJECTS_PER_TASK = 32;
+
+  /* Invert all object transforms in batches up front, so that the SIMD dispatch happens once per
+   * batch rather than once per object and the widest instruction set can work across objects. */
+  state.object_itfm.resize(scene->objects.size());
+  parallel_for(blocked_range<size_t>(0, scene->objects.size(), OBJECTS_PER_TASK),
+               [&](const blocked_range<size_t> &r) {
+                 vector<Transform> tfms(r.size());
+                 for (size_t i = r.begin(); i != r.end(); i++) {
+                   tfms[i - r.begin()] = state.scene->objects[i]->tfm;
+                 }
+                 transform_inverse_batch(tfms.data(), &state.object_itfm[r.begin()], r.size());
+               });
+
+  /* Parallel object update. */
   parallel_for(blocked_range<size_t>(0, scene->objects.size(), OBJECTS_PER_TASK),
                [&](const blocked_range<size_t> &r) {
                  for (size_t i = r.begin(); i != r.end(); i++) {
@@ -749,12 +907,21 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
     return;
   }
 
+  /* Build the motion lerp table before the objects upload, it writes the
+   * table offsets into the kernel objects. */
+  if (state.need_motion == Scene::MOTION_BLUR) {
+    device_update_motion_lerp(&state, dscene, scene);
+  }
+
   dscene->objects.copy_to_device_if_modified();
   if (state.need_motion == Scene::MOTION_PASS) {
-    dscene->object_motion_pass.copy_to_device();
+    dscene->object_motion_pass.copy_to_device_if_modified();
   }
   else if (state.need_motion == Scene::MOTION_BLUR) {
     dscene->object_motion.copy_to_device();
+    if (dscene->object_motion_lerp.size()) {
+      dscene->object_motion_lerp.copy_to_device();
+    }
   }
 
   dscene->data.bvh.have_motion = state.have_motion;
@@ -765,6 +932,7 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
   dscene->objects.clear_modified();
   dscene->object_motion_pass.clear_modified();
   dscene->object_motion.clear_modified();
+  dscene->object_motion_lerp.clear_modified();
 }
 
 void ObjectManager::device_update(Device *device,
@@ -815,8 +983,13 @@ void ObjectManager::device_update(Device *device,
       /* this is a bit too broad, however a bigger refactor might be needed to properly separate
        * update each type of data (transform, flags, etc.) */
       if (object->is_modified()) {
-        dscene->objects.tag_modified();
-        dscene->object_motion_pass.tag_modified();
+        /* Per-object arrays only upload the dirty range, so that tweaking a
+         * single object does not re-upload the whole scene. Motion offsets
+         * vary per object and are not known yet, so that array stays whole. */
+        dscene->objects.tag_modified_range(object->index, object->index + 1);
+        dscene->object_motion_pass.tag_modified_range(
+            object->index * OBJECT_MOTION_PASS_SIZE,
+            (object->index + 1) * OBJECT_MOTION_PASS_SIZE);
         dscene->object_motion.tag_modified();
         dscene->object_flag.tag_modified();
         dscene->object_volume_step.tag_modified();
@@ -941,6 +1114,53 @@ void ObjectManager::device_update_flags(Device * /*unused*/,
     }
   }
 
+  /* Volume occupancy grids for empty space skipping during ray marching.
+   * The bit arrays live on the volume geometry and are shared between
+   * instances; only the per-object descriptors are duplicated. */
+  KernelVolumeOccupancy *volume_occupancy = dscene->volume_occupancy.alloc(scene->objects.size());
+  unordered_map<const Geometry *, int> volume_bits_offset;
+  size_t total_bits_words = 0;
+
+  for (Object *object : scene->objects) {
+    KernelVolumeOccupancy occ;
+    occ.tfm = transform_identity();
+    occ.bits_offset = -1;
+    occ.res_x = occ.res_y = occ.res_z = 0;
+
+    if (object->geometry->is_volume()) {
+      Volume *volume = static_cast<Volume *>(object->geometry);
+      if (!volume->occupancy_bits.empty()) {
+        const auto inserted = volume_bits_offset.emplace(volume, (int)total_bits_words);
+        if (inserted.second) {
+          total_bits_words += volume->occupancy_bits.size();
+        }
+        occ.tfm = volume->occupancy_tfm;
+        occ.bits_offset = inserted.first->second;
+        occ.res_x = volume->occupancy_res.x;
+        occ.res_y = volume->occupancy_res.y;
+        occ.res_z = volume->occupancy_res.z;
+      }
+    }
+
+    volume_occupancy[object->index] = occ;
+  }
+
+  dscene->volume_occupancy.copy_to_device();
+
+  if (total_bits_words != 0) {
+    uint *bits = dscene->volume_occupancy_bits.alloc(total_bits_words);
+    for (const auto &it : volume_bits_offset) {
+      const Volume *volume = static_cast<const Volume *>(it.first);
+      memcpy(bits + it.second,
+             volume->occupancy_bits.data(),
+             volume->occupancy_bits.size() * sizeof(uint));
+    }
+    dscene->volume_occupancy_bits.copy_to_device();
+  }
+  else {
+    dscene->volume_occupancy_bits.free();
+  }
+
   /* Copy object flag. */
   dscene->object_flag.copy_to_device();
   dscene->object_volume_step.copy_to_device();
@@ -995,9 +1215,12 @@ void ObjectManager::device_free(Device * /*unused*/, DeviceScene *dscene, bool f
   dscene->objects.free_if_need_realloc(force_free);
   dscene->object_motion_pass.free_if_need_realloc(force_free);
   dscene->object_motion.free_if_need_realloc(force_free);
+  dscene->object_motion_lerp.free_if_need_realloc(force_free);
   dscene->object_flag.free_if_need_realloc(force_free);
   dscene->object_volume_step.free_if_need_realloc(force_free);
   dscene->object_prim_offset.free_if_need_realloc(force_free);
+  dscene->volume_occupancy.free();
+  dscene->volume_occupancy_bits.free();
 }
 
 void ObjectManager::apply_static_transforms(DeviceScene *dscene, Scene *scene, Progress &progress)
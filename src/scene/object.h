@@ -77,6 +77,13 @@ class Object : public Node {
   /* Set during device update. */
   bool intersects_volume;
 
+  /* Motion decomposition from the last device update, together with the
+   * motion transforms it was computed from. Reused when the motion did not
+   * change beyond epsilon, which is common when animation caches resubmit
+   * near-identical frames. */
+  array<Transform> decomposed_motion;
+  array<DecomposedTransform> motion_decomposed;
+
   /* Specifies the position of the object in scene->objects and
    * in the device vectors. Gets set in device_update. */
   int index;
@@ -183,6 +190,9 @@ class ObjectManager {
   string get_cryptomatte_assets(Scene *scene);
 
  protected:
+  void device_update_motion_lerp(UpdateObjectTransformState *state,
+                                 DeviceScene *dscene,
+                                 Scene *scene);
   void device_update_object_transform(UpdateObjectTransformState *state,
                                       Object *ob,
                                       bool update_all,
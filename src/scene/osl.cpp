@@ -20,6 +20,7 @@
 #  include "kernel/osl/services.h"
 
 #  include "util/aligned_malloc.h"
+#  include "util/fasthash.h"
 #  include "util/log.h"
 #  include "util/md5.h"
 #  include "util/path.h"
@@ -40,6 +41,14 @@ thread_mutex ts_shared_mutex;
 
 map<DeviceType, std::shared_ptr<OSL::ShadingSystem>> ss_shared;
 thread_mutex ss_shared_mutex;
+
+/* Optimized and JITed shader groups, shared between all scenes and sessions within the process.
+ * Keyed by the shading system and a hash of the serialized group commands, so that re-creating a
+ * session (or rendering the same shaders in another scene) reuses the existing group and skips
+ * the LLVM optimization and JIT for it entirely. */
+map<std::pair<OSL::ShadingSystem *, uint64_t>, OSL::ShaderGroupRef> group_cache_shared;
+thread_mutex group_cache_mutex;
+
 OSL::ErrorHandler errhandler;
 
 std::atomic<int> OSLCompiler::texture_shared_unique_id = 0;
@@ -56,6 +65,21 @@ OSLManager::~OSLManager()
 
 void OSLManager::free_memory()
 {
+  /* Release the process-wide shader group cache and the shared shading and texture systems which
+   * are retained across sessions. */
+  {
+    const thread_scoped_lock lock(group_cache_mutex);
+    group_cache_shared.clear();
+  }
+  {
+    const thread_scoped_lock lock(ss_shared_mutex);
+    ss_shared.clear();
+  }
+  {
+    const thread_scoped_lock lock(ts_shared_mutex);
+    ts_shared.reset();
+  }
+
 #  ifdef OSL_HAS_BLENDER_CLEANUP_FIX
   /* There is a problem with LLVM+OSL: The order global destructors across
    * different compilation units run cannot be guaranteed, on windows this means
@@ -254,12 +278,8 @@ void OSLManager::texture_system_free()
 {
   ts.reset();
 
-  /* if ts_shared is the only reference to the underlying texture system,
-   * no users remain, so free it. */
-  const thread_scoped_lock lock(ts_shared_mutex);
-  if (ts_shared.use_count() == 1) {
-    ts_shared.reset();
-  }
+  /* ts_shared is kept alive: the retained shading systems reference it through their render
+   * services. It is freed at process exit from free_memory(). */
 }
 
 void OSLManager::shading_system_init()
@@ -365,14 +385,10 @@ void OSLManager::shading_system_free()
 {
   ss_map.clear();
 
-  /* if ss_shared is the only reference to the underlying shading system,
-   * no users remain, so free it. */
-  const thread_scoped_lock lock(ss_shared_mutex);
-  for (auto &[device_type, ss] : ss_shared) {
-    if (ss.use_count() == 1) {
-      ss.reset();
-    }
-  }
+  /* The underlying shading systems are kept alive together with their optimized and JITed shader
+   * groups (see group_cache_shared), so that the next session within this process reuses the
+   * groups of unchanged shaders and skips the LLVM work for them. Everything is freed at process
+   * exit from free_memory(). */
 
   loaded_shaders.clear();
 }
@@ -423,13 +439,13 @@ static string shader_filepath_hash(const string &filepath, const uint64_t modifi
 
 const char *OSLManager::shader_test_loaded(const string &hash)
 {
-  const map<string, OSLShaderInfo>::iterator it = loaded_shaders.find(hash);
+  const auto it = loaded_shaders.find(hash);
   return (it == loaded_shaders.end()) ? nullptr : it->first.c_str();
 }
 
 OSLShaderInfo *OSLManager::shader_loaded_info(const string &hash)
 {
-  const map<string, OSLShaderInfo>::iterator it = loaded_shaders.find(hash);
+  const auto it = loaded_shaders.find(hash);
   return (it == loaded_shaders.end()) ? nullptr : &it->second;
 }
 
@@ -491,8 +507,7 @@ const char *OSLManager::shader_load_filepath(string filepath)
 
   if (!path_read_text(filepath, bytecode)) {
     fprintf(stderr, "Cycles shader graph: failed to read file %s\n", filepath.c_str());
-    const OSLShaderInfo info;
-    loaded_shaders[bytecode_hash] = info; /* to avoid repeat tries */
+    loaded_shaders.emplace(bytecode_hash, OSLShaderInfo()); /* to avoid repeat tries */
     return nullptr;
   }
 
@@ -518,10 +533,15 @@ const char *OSLManager::shader_load_bytecode(const string &hash, const string &b
   info.has_surface_emission = (bytecode.find("\"emission\"") != string::npos);
   info.has_surface_transparent = (bytecode.find("\"transparent\"") != string::npos);
   info.has_surface_bssrdf = (bytecode.find("\"bssrdf\"") != string::npos);
-
-  loaded_shaders[hash] = info;
-
-  return loaded_shaders.find(hash)->first.c_str();
+  /* The trace op and the matching getmessage("trace", ...) are the only things
+   * that need the raytrace kernel variant, so shaders without them can stay on
+   * the lean surface kernel instead of taxing the whole wavefront. */
+  info.has_surface_raytrace = (bytecode.find("\ttrace\t") != string::npos) ||
+                              (bytecode.find("\ttrace ") != string::npos) ||
+                              (bytecode.find("\"trace\"") != string::npos);
+
+  /* Racing loads of the same bytecode keep the first entry. */
+  return loaded_shaders.emplace(hash, info).first->first.c_str();
 }
 
 uint64_t OSLShaderManager::get_attribute_id(string name)
@@ -816,7 +836,8 @@ OSLNode *OSLShaderManager::osl_node(ShaderGraph *graph,
     node->filepath = filepath;
   }
 
-  /* Generate inputs and outputs */
+  /* Generate inputs and outputs, with socket memory from the graph arena. */
+  const ShaderGraphArenaScope scope(graph->arena);
   node->create_inputs_outputs(node->type);
 
   return node;
@@ -1052,8 +1073,10 @@ void OSLCompiler::add(ShaderNode *node, const char *name, bool isfilepath)
         current_shader->has_surface_bssrdf = true;
         current_shader->has_bssrdf_bump = true; /* can't detect yet */
       }
-      current_shader->has_bump = true;             /* can't detect yet */
-      current_shader->has_surface_raytrace = true; /* can't detect yet */
+      if (info->has_surface_raytrace) {
+        current_shader->has_surface_raytrace = true;
+      }
+      current_shader->has_bump = true; /* can't detect yet */
     }
 
     if (node->has_spatial_varying()) {
@@ -1435,6 +1458,24 @@ OSL::ShaderGroupRef OSLCompiler::compile_type(Shader *shader, ShaderGraph *graph
 
   ss->ShaderGroupEnd(*current_group);
 
+  /* Share identical groups process-wide: when the serialized group commands match a group built
+   * before (in this or a previous session), return the existing group which has already been
+   * optimized and JITed, and let the freshly declared one be discarded. The serialization covers
+   * parameter values, connections and the content-hashed layer names, so equal commands imply
+   * equal code. Shaders referencing per-session SVM texture slots get unique layer parameters and
+   * simply miss the cache. */
+  std::string serialized;
+  if (ss->getattribute(current_group.get(), "pickle", serialized) && !serialized.empty()) {
+    const uint64_t hash = util_fast_hash(serialized.data(), serialized.size());
+
+    const thread_scoped_lock lock(group_cache_mutex);
+    OSL::ShaderGroupRef &cached = group_cache_shared[{ss, hash}];
+    if (cached) {
+      return cached;
+    }
+    cached = current_group;
+  }
+
   return std::move(current_group);
 }
 
@@ -9,6 +9,7 @@
 #include "device/device.h"
 
 #include "util/array.h"
+#include "util/concurrent_map.h"
 #include "util/set.h"
 #include "util/string.h"
 
@@ -48,6 +49,7 @@ struct OSLShaderInfo {
   bool has_surface_emission = false;
   bool has_surface_transparent = false;
   bool has_surface_bssrdf = false;
+  bool has_surface_raytrace = false;
 };
 
 #endif
@@ -98,7 +100,9 @@ class OSLManager {
   OSL::TextureSystem *get_texture_system();
 
   Device *device_;
-  map<string, OSLShaderInfo> loaded_shaders;
+  /* Concurrent so shaders can be looked up and loaded from parallel shader
+   * compilation. Pointers into the map stay valid across insertions. */
+  concurrent_unordered_map<string, OSLShaderInfo> loaded_shaders;
 
   std::shared_ptr<OSL::TextureSystem> ts;
   map<DeviceType, std::shared_ptr<OSL::ShadingSystem>> ss_map;
@@ -9,9 +9,12 @@
 
 #include "util/log.h"
 #include "util/progress.h"
+#include "util/tbb.h"
 
 namespace ccl {
 
+static const size_t PARTICLES_PER_TASK = 4096;
+
 /* Particle System */
 
 NODE_DEFINE(ParticleSystem)
@@ -26,6 +29,7 @@ ParticleSystem::~ParticleSystem() = default;
 
 void ParticleSystem::tag_update(Scene *scene)
 {
+  need_device_update = true;
   scene->particle_system_manager->tag_update(scene);
 }
 
@@ -43,44 +47,62 @@ void ParticleSystemManager::device_update_particles(Device * /*unused*/,
                                                     Scene *scene,
                                                     Progress &progress)
 {
-  /* count particles.
+  /* count particles and compute per-system offsets.
    * adds one dummy particle at the beginning to avoid invalid lookups,
    * in case a shader uses particle info without actual particle data. */
-  int num_particles = 1;
+  size_t num_particles = 1;
+  vector<size_t> offsets(scene->particle_systems.size());
+  vector<size_t> counts(scene->particle_systems.size());
   for (size_t j = 0; j < scene->particle_systems.size(); j++) {
-    num_particles += scene->particle_systems[j]->particles.size();
+    offsets[j] = num_particles;
+    counts[j] = scene->particle_systems[j]->particles.size();
+    num_particles += counts[j];
   }
 
+  /* When any system was added, removed or resized the offsets shift and
+   * everything has to be rewritten. Otherwise the allocation below keeps the
+   * previous contents and only tagged systems need repacking. */
+  const bool layout_changed = (counts != last_particle_counts_);
+
   KernelParticle *kparticles = dscene->particles.alloc(num_particles);
 
   /* dummy particle */
   *kparticles = KernelParticle{};
 
-  int i = 1;
   for (size_t j = 0; j < scene->particle_systems.size(); j++) {
     ParticleSystem *psys = scene->particle_systems[j];
 
-    for (size_t k = 0; k < psys->particles.size(); k++) {
-      /* pack in texture */
-      const Particle &pa = psys->particles[k];
-
-      kparticles[i].index = pa.index;
-      kparticles[i].age = pa.age;
-      kparticles[i].lifetime = pa.lifetime;
-      kparticles[i].size = pa.size;
-      kparticles[i].rotation = pa.rotation;
-      kparticles[i].location = make_float4(pa.location);
-      kparticles[i].velocity = make_float4(pa.velocity);
-      kparticles[i].angular_velocity = make_float4(pa.angular_velocity);
-
-      i++;
+    if (!layout_changed && !psys->need_device_update) {
+      continue;
+    }
 
-      if (progress.get_cancel()) {
-        return;
-      }
+    KernelParticle *kpsys = kparticles + offsets[j];
+    parallel_for(blocked_range<size_t>(0, psys->particles.size(), PARTICLES_PER_TASK),
+                 [psys, kpsys](const blocked_range<size_t> &r) {
+                   for (size_t k = r.begin(); k != r.end(); k++) {
+                     /* pack in texture */
+                     const Particle &pa = psys->particles[k];
+
+                     kpsys[k].index = pa.index;
+                     kpsys[k].age = pa.age;
+                     kpsys[k].lifetime = pa.lifetime;
+                     kpsys[k].size = pa.size;
+                     kpsys[k].rotation = pa.rotation;
+                     kpsys[k].location = make_float4(pa.location);
+                     kpsys[k].velocity = make_float4(pa.velocity);
+                     kpsys[k].angular_velocity = make_float4(pa.angular_velocity);
+                   }
+                 });
+
+    psys->need_device_update = false;
+
+    if (progress.get_cancel()) {
+      return;
     }
   }
 
+  last_particle_counts_ = counts;
+
   dscene->particles.copy_to_device();
 }
 
@@ -101,7 +123,8 @@ void ParticleSystemManager::device_update(Device *device,
 
   VLOG_INFO << "Total " << scene->particle_systems.size() << " particle systems.";
 
-  device_free(device, dscene);
+  /* Note: no device_free here, device_update_particles keeps the previous
+   * packed contents so that unchanged systems are not rewritten. */
 
   progress.set_status("Updating Particle Systems", "Copying Particles to device");
   device_update_particles(device, dscene, scene, progress);
@@ -116,6 +139,7 @@ void ParticleSystemManager::device_update(Device *device,
 void ParticleSystemManager::device_free(Device * /*unused*/, DeviceScene *dscene)
 {
   dscene->particles.free();
+  last_particle_counts_.clear();
 }
 
 void ParticleSystemManager::tag_update(Scene * /*scene*/)
@@ -6,6 +6,7 @@
 
 #include "util/array.h"
 #include "util/types.h"
+#include "util/vector.h"
 
 #include "graph/node.h"
 
@@ -39,6 +40,10 @@ class ParticleSystem : public Node {
   void tag_update(Scene *scene);
 
   array<Particle> particles;
+
+  /* Set by tag_update, cleared once the particles have been packed into the
+   * device array again. Lets unchanged systems skip repacking. */
+  bool need_device_update = true;
 };
 
 /* ParticleSystem Manager */
@@ -46,6 +51,10 @@ class ParticleSystem : public Node {
 class ParticleSystemManager {
   bool need_update_;
 
+  /* Per-system particle counts from the last device update, used to detect
+   * when the packed layout changed and everything has to be rewritten. */
+  vector<size_t> last_particle_counts_;
+
  public:
   ParticleSystemManager();
   ~ParticleSystemManager();
@@ -130,6 +130,7 @@ NODE_DEFINE(Pass)
   SOCKET_ENUM(mode, "Mode", *pass_mode_enum, static_cast<int>(PassMode::DENOISED));
   SOCKET_STRING(name, "Name", string());
   SOCKET_BOOLEAN(include_albedo, "Include Albedo", false);
+  SOCKET_BOOLEAN(accumulate_half, "Accumulate Half", false);
   SOCKET_STRING(lightgroup, "Light Group", string());
 
   return type;
@@ -322,13 +323,15 @@ PassInfo Pass::get_info(const PassType type, const bool include_albedo, const bo
 
     case PASS_AOV_COLOR:
       pass_info.num_components = 4;
+      pass_info.support_half_accumulation = true;
       break;
     case PASS_AOV_VALUE:
       pass_info.num_components = 1;
       break;
 
     case PASS_BAKE_PRIMITIVE:
-      pass_info.num_components = 3;
+      /* Barycentric u, v, primitive index, and the object index for multi-object baking. */
+      pass_info.num_components = 4;
       pass_info.use_exposure = false;
       pass_info.use_filter = false;
       break;
@@ -421,13 +424,22 @@ int Pass::get_offset(const unique_ptr_vector<Pass> &passes, const Pass *pass)
       return PASS_UNUSED;
     }
     if (current_pass->is_written()) {
-      pass_offset += current_pass->get_info().num_components;
+      pass_offset += pass_num_buffer_components(current_pass->get_info(),
+                                                current_pass->get_accumulate_half());
     }
   }
 
   return PASS_UNUSED;
 }
 
+int pass_num_buffer_components(const PassInfo &info, const bool accumulate_half)
+{
+  if (accumulate_half && info.support_half_accumulation) {
+    return (info.num_components + 1) / 2;
+  }
+  return info.num_components;
+}
+
 std::ostream &operator<<(std::ostream &os, const Pass &pass)
 {
   os << "type: " << pass_type_as_string(pass.get_type());
@@ -44,8 +44,16 @@ struct PassInfo {
 
   /* Pass supports denoising. */
   bool support_denoise = false;
+
+  /* Pass may accumulate in half precision, with pairs of components bit-packed into
+   * single floats of the render buffer and widened back to float at read time. */
+  bool support_half_accumulation = false;
 };
 
+/* Number of floats the pass occupies in the render buffer. Differs from the number of
+ * components when the pass accumulates in half precision. */
+int pass_num_buffer_components(const PassInfo &info, const bool accumulate_half);
+
 class Pass : public Node {
  public:
   NODE_DECLARE
@@ -54,6 +62,7 @@ class Pass : public Node {
   NODE_SOCKET_API(PassMode, mode)
   NODE_SOCKET_API(string, name)
   NODE_SOCKET_API(bool, include_albedo)
+  NODE_SOCKET_API(bool, accumulate_half)
   NODE_SOCKET_API(string, lightgroup)
 
   Pass();
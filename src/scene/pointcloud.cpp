@@ -7,6 +7,8 @@
 #include "scene/pointcloud.h"
 #include "scene/scene.h"
 
+#include "util/tbb.h"
+
 namespace ccl {
 
 /* PointCloud Point */
@@ -266,13 +268,16 @@ void PointCloud::apply_transform(const Transform &tfm, const bool apply_to_motio
 void PointCloud::pack(Scene *scene, float4 *packed_points, uint *packed_shader)
 {
   const size_t numpoints = points.size();
-  float3 *points_data = points.data();
-  float *radius_data = radius.data();
-  int *shader_data = shader.data();
+  const float3 *points_data = points.data();
+  const float *radius_data = radius.data();
+  const int *shader_data = shader.data();
 
-  for (size_t i = 0; i < numpoints; i++) {
-    packed_points[i] = make_float4(points_data[i], radius_data[i]);
-  }
+  parallel_for(blocked_range<size_t>(0, numpoints, 256 * 1024),
+               [&](const blocked_range<size_t> &r) {
+                 for (size_t i = r.begin(); i != r.end(); i++) {
+                   packed_points[i] = make_float4(points_data[i], radius_data[i]);
+                 }
+               });
 
   uint shader_id = 0;
   uint last_shader = -1;
@@ -293,4 +298,12 @@ PrimitiveType PointCloud::primitive_type() const
   return has_motion_blur() ? PRIMITIVE_MOTION_POINT : PRIMITIVE_POINT;
 }
 
+bool PointCloud::bvh_topology_modified() const
+{
+  /* There is no separate topology socket for points: a modified points array
+   * may also mean the point count changed, so rebuild. Radius-only changes
+   * can take the refit path. */
+  return points_is_modified();
+}
+
 }
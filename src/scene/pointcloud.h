@@ -82,6 +82,8 @@ class PointCloud : public Geometry {
 
   PrimitiveType primitive_type() const override;
 
+  bool bvh_topology_modified() const override;
+
   /* BVH */
   void pack(Scene *scene, float4 *packed_points, uint *packed_shader);
 
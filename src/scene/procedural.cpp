@@ -28,6 +28,12 @@ ProceduralManager::ProceduralManager()
 ProceduralManager::~ProceduralManager() = default;
 
 void ProceduralManager::update(Scene *scene, Progress &progress)
+{
+  update_async(scene, progress);
+  update_wait(scene, progress);
+}
+
+void ProceduralManager::update_async(Scene *scene, Progress &progress)
 {
   if (!need_update()) {
     return;
@@ -35,19 +41,37 @@ void ProceduralManager::update(Scene *scene, Progress &progress)
 
   progress.set_status("Updating Procedurals");
 
+  generating_dirty_flags_ = 0;
+
+  for (Procedural *procedural : scene->procedurals) {
+    generating_dirty_flags_ |= procedural->dirty_managers();
+
+    generate_pool_.push([procedural, scene, &progress] {
+      if (progress.get_cancel()) {
+        return;
+      }
+
+      procedural->generate(scene, progress);
+    });
+  }
+}
+
+void ProceduralManager::update_wait(Scene *scene, Progress &progress, const uint dirty_flags)
+{
+  if (!need_update() || !(generating_dirty_flags_ & dirty_flags)) {
+    return;
+  }
+
   const scoped_callback_timer timer([scene](double time) {
     if (scene->update_stats) {
       scene->update_stats->procedurals.times.add_entry({"update", time});
     }
   });
 
-  for (Procedural *procedural : scene->procedurals) {
-    if (progress.get_cancel()) {
-      return;
-    }
-
-    procedural->generate(scene, progress);
-  }
+  /* The task pool has no partial wait, so the first manager that needs any
+   * procedural output waits for all of them. */
+  generate_pool_.wait_work();
+  generating_dirty_flags_ = 0;
 
   if (progress.get_cancel()) {
     return;
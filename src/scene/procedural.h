@@ -6,6 +6,7 @@
 
 #include "graph/node.h"
 
+#include "util/task.h"
 #include "util/unique_ptr_vector.h"
 
 namespace ccl {
@@ -26,10 +27,29 @@ class Procedural : public Node, public NodeOwner {
   explicit Procedural(const NodeType *type);
   ~Procedural() override;
 
+  /* Managers whose data a Procedural may dirty when it generates. Scene update uses this to let
+   * managers that no generating procedural affects start their device update without waiting for
+   * the generate tasks to finish. */
+  enum : uint {
+    DIRTY_GEOMETRY = (1 << 0),
+    DIRTY_OBJECTS = (1 << 1),
+    DIRTY_CAMERA = (1 << 2),
+    DIRTY_BACKGROUND = (1 << 3),
+    DIRTY_ALL = ~0u,
+  };
+
   /* Called each time the ProceduralManager is tagged for an update, this function is the entry
-   * point for the data generated by this Procedural. */
+   * point for the data generated by this Procedural. May run concurrently with the generate of
+   * other procedurals, node creation and deletion in the scene is thread-safe. */
   virtual void generate(Scene *scene, Progress &progress) = 0;
 
+  /* Bitmask of DIRTY_* flags declaring which managers generate() may affect. The conservative
+   * default blocks every manager until generation finished. */
+  virtual uint dirty_managers() const
+  {
+    return DIRTY_ALL;
+  }
+
   /* Create a node and set this Procedural as the owner. */
   template<typename T> T *create_node()
   {
@@ -54,12 +74,25 @@ class Procedural : public Node, public NodeOwner {
 class ProceduralManager {
   bool need_update_;
 
+  /* Task pool running the generate() of all procedurals, and the union of
+   * their declared dirty flags while generation is in flight. */
+  TaskPool generate_pool_;
+  uint generating_dirty_flags_ = 0;
+
  public:
   ProceduralManager();
   ~ProceduralManager();
 
+  /* Serial update, equivalent to update_async followed by update_wait. */
   void update(Scene *scene, Progress &progress);
 
+  /* Run the generate() of all procedurals concurrently on the task pool. */
+  void update_async(Scene *scene, Progress &progress);
+
+  /* Completion barrier: blocks until generation finished, but only if any
+   * generating procedural declared one of the given dirty flags. */
+  void update_wait(Scene *scene, Progress &progress, const uint dirty_flags = Procedural::DIRTY_ALL);
+
   void tag_update();
 
   bool need_update() const;
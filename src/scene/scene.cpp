@@ -29,8 +29,11 @@
 #include "scene/volume.h"
 #include "session/session.h"
 
+#include "util/fasthash.h"
 #include "util/guarded_allocator.h"
 #include "util/log.h"
+#include "util/path.h"
+#include "util/profiling.h"
 #include "util/progress.h"
 
 namespace ccl {
@@ -77,7 +80,7 @@ Scene ::Scene(const SceneParams &params_, Device *device)
   ccl::ShaderManager::add_default(this);
 }
 
-Scene::~Scene()
+Scene::~Scene() noexcept
 {
   free_memory(true);
 }
@@ -173,6 +176,8 @@ void Scene::device_update(Device *device_, Progress &progress)
 
   const bool print_stats = need_data_update();
 
+  const scoped_trace trace("scene device_update");
+
   if (update_stats) {
     update_stats->clear();
   }
@@ -216,13 +221,17 @@ void Scene::device_update(Device *device_, Progress &progress)
     return;
   }
 
-  procedural_manager->update(this, progress);
+  /* Start procedural generation on the task pool. Managers below only wait
+   * for it when a generating procedural declared that it may dirty them,
+   * the geometry update is a full barrier. */
+  procedural_manager->update_async(this, progress);
 
   if (progress.get_cancel()) {
     return;
   }
 
   progress.set_status("Updating Background");
+  procedural_manager->update_wait(this, progress, Procedural::DIRTY_BACKGROUND);
   background->device_update(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -230,12 +239,21 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Camera");
+  procedural_manager->update_wait(this, progress, Procedural::DIRTY_CAMERA);
   camera->device_update(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error()) {
     return;
   }
 
+  /* Completion barrier: every generated node must exist before geometry and
+   * object packing. */
+  procedural_manager->update_wait(this, progress);
+
+  if (progress.get_cancel()) {
+    return;
+  }
+
   geometry_manager->device_update_preprocess(device, this, progress);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -249,6 +267,12 @@ void Scene::device_update(Device *device_, Progress &progress)
     return;
   }
 
+  /* Start loading images in the background, overlapping texture I/O with the
+   * geometry update and BVH build below. The geometry update loads the slots
+   * it needs for displacement and volumes itself, the image manager makes
+   * sure each slot is only loaded once. */
+  image_manager->device_update_async(device, this, progress);
+
   progress.set_status("Updating Particle Systems");
   particle_system_manager->device_update(device, &dscene, this, progress);
 
@@ -278,7 +302,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Images");
-  image_manager->device_update(device, this, progress);
+  image_manager->device_update_wait(this);
 
   if (progress.get_cancel() || device->have_error()) {
     return;
@@ -336,6 +360,8 @@ void Scene::device_update(Device *device_, Progress &progress)
   if (device->have_error() == false) {
     dscene.data.volume_stack_size = get_volume_stack_size();
 
+    update_shadow_catcher_rect();
+
     progress.set_status("Updating Device", "Writing constant memory");
     device->const_copy_to("data", &dscene.data, sizeof(dscene.data));
   }
@@ -540,6 +566,7 @@ void Scene::update_kernel_features()
   kernel_features |= integrator->get_kernel_features();
 
   dscene.data.kernel_features = kernel_features;
+  kernel_closure_set_ = shader_manager->get_closure_set_mask(this);
 
   /* Currently viewport render is faster with higher max_closures, needs
    * investigating. */
@@ -591,35 +618,57 @@ static void log_kernel_features(const uint features)
             << "\n";
 }
 
-bool Scene::load_kernels(Progress &progress)
+void Scene::load_kernels_async(Progress &progress)
 {
   update_kernel_features();
 
   const uint kernel_features = dscene.data.kernel_features;
+  const uint kernel_closure_set = kernel_closure_set_;
 
-  if (!kernels_loaded || loaded_kernel_features != kernel_features) {
-    progress.set_status("Loading render kernels (may take a few minutes the first time)");
+  if (kernels_loaded && loaded_kernel_features == kernel_features &&
+      loaded_kernel_closure_set_ == kernel_closure_set)
+  {
+    return;
+  }
 
-    const scoped_timer timer;
+  progress.set_status("Loading render kernels (may take a few minutes the first time)");
 
-    log_kernel_features(kernel_features);
-    if (!device->load_kernels(kernel_features)) {
-      string message = device->error_message();
-      if (message.empty()) {
-        message = "Failed loading render kernel, see console for errors";
-      }
+  log_kernel_features(kernel_features);
+
+  /* Compilation runs concurrently with the scene managers, so that a cold-start kernel
+   * build does not serialize behind the scene device update. The update itself only
+   * consumes the feature flags computed above, and device memory uploads are safe while
+   * the device compiles. */
+  device->set_kernel_closure_set(kernel_closure_set);
+
+  kernel_load_result_ = true;
+  kernel_load_pool_.push(
+      [this, kernel_features] { kernel_load_result_ = device->load_kernels(kernel_features); });
+
+  kernels_loaded = true;
+  loaded_kernel_features = kernel_features;
+  loaded_kernel_closure_set_ = kernel_closure_set;
+}
+
+bool Scene::wait_load_kernels(Progress &progress)
+{
+  kernel_load_pool_.wait_work();
 
-      progress.set_error(message);
-      progress.set_status(message);
-      progress.set_update();
-      return false;
+  if (!kernel_load_result_) {
+    string message = device->error_message();
+    if (message.empty()) {
+      message = "Failed loading render kernel, see console for errors";
     }
 
-    kernels_loaded = true;
-    loaded_kernel_features = kernel_features;
-    return true;
+    progress.set_error(message);
+    progress.set_status(message);
+    progress.set_update();
+
+    /* Retry the load on the next iteration. */
+    kernels_loaded = false;
+    return false;
   }
-  return false;
+  return true;
 }
 
 int Scene::get_max_closure_count()
@@ -726,8 +775,113 @@ void Scene::tag_shadow_catcher_modified()
   shadow_catcher_modified_ = true;
 }
 
+string Scene::guiding_field_cache_path(const GuidingDistributionType guiding_type)
+{
+  const char *cache_dir = getenv("CYCLES_GUIDING_CACHE_DIR");
+  if (cache_dir == nullptr || cache_dir[0] == '\0') {
+    return "";
+  }
+
+  /* Coarse, process-stable content fingerprint: object placement and the identity of geometry
+   * and shaders through names and transforms, rather than the full data. Edits which keep these
+   * fixed reuse the cached field, which only affects how well the first samples are guided and
+   * never correctness. Node::hash is not usable for a cross-process key since it hashes
+   * pointers for node sockets. */
+  FastHash hash;
+  const auto append_string = [&hash](const char *str) {
+    hash.append((const uint8_t *)str, strlen(str) + 1);
+  };
+
+  for (Object *object : objects) {
+    append_string(object->name.c_str());
+    const Transform tfm = object->get_tfm();
+    hash.append((const uint8_t *)&tfm, sizeof(tfm));
+
+    if (Geometry *geom = object->get_geometry()) {
+      append_string(geom->name.c_str());
+      for (Node *shader : geom->get_used_shaders()) {
+        append_string(shader->name.c_str());
+      }
+    }
+  }
+
+  /* Fields of different distribution types are not interchangeable. */
+  const int type = guiding_type;
+  hash.append((const uint8_t *)&type, sizeof(type));
+
+  return path_join(cache_dir, string_printf("guiding_%s.pgl", hash.get_hex().c_str()));
+}
+
+void Scene::update_shadow_catcher_rect()
+{
+  KernelIntegrator *kintegrator = &dscene.data.integrator;
+
+  /* Default to the full frame, which keeps the split enabled for every pixel. */
+  const int width = dscene.data.cam.width;
+  const int height = dscene.data.cam.height;
+  kintegrator->shadow_catcher_rect_min_x = 0;
+  kintegrator->shadow_catcher_rect_min_y = 0;
+  kintegrator->shadow_catcher_rect_max_x = width;
+  kintegrator->shadow_catcher_rect_max_y = height;
+
+  if (!has_shadow_catcher()) {
+    return;
+  }
+
+  /* The split only happens on paths which travel in a straight line from the camera, so the
+   * projected object bounds are only a valid bound when that projection is a simple one. Depth
+   * of field, panoramic projections, stereo and camera motion bend or move the primary rays,
+   * and keep the full frame. */
+  if (camera->get_camera_type() == CAMERA_PANORAMA || camera->get_aperturesize() > 0.0f ||
+      camera->get_interocular_distance() != 0.0f || camera->use_motion() ||
+      camera->get_use_perspective_motion())
+  {
+    return;
+  }
+
+  float2 rect_min = make_float2(FLT_MAX, FLT_MAX);
+  float2 rect_max = make_float2(-FLT_MAX, -FLT_MAX);
+
+  for (Object *object : objects) {
+    if (!object->get_is_shadow_catcher() || object->get_geometry()->is_light()) {
+      continue;
+    }
+
+    const BoundBox bounds = object->bounds;
+    if (!bounds.valid()) {
+      return;
+    }
+
+    for (int corner = 0; corner < 8; ++corner) {
+      const float3 P = make_float3((corner & 1) ? bounds.max.x : bounds.min.x,
+                                   (corner & 2) ? bounds.max.y : bounds.min.y,
+                                   (corner & 4) ? bounds.max.z : bounds.min.z);
+
+      /* Corners behind the camera have no meaningful projection, keep the full frame. */
+      const float4 w_row = camera->worldtoraster.w;
+      const float w = w_row.x * P.x + w_row.y * P.y + w_row.z * P.z + w_row.w;
+      if (w < 1e-8f) {
+        return;
+      }
+
+      const float3 raster = transform_perspective(&camera->worldtoraster, P);
+      rect_min = min(rect_min, make_float2(raster.x, raster.y));
+      rect_max = max(rect_max, make_float2(raster.x, raster.y));
+    }
+  }
+
+  /* Pad by the pixel filter radius the camera samples jitter by, plus a pixel of slack. */
+  const int pad = (int)ceilf(film->get_filter_width()) + 1;
+
+  kintegrator->shadow_catcher_rect_min_x = clamp((int)floorf(rect_min.x) - pad, 0, width);
+  kintegrator->shadow_catcher_rect_min_y = clamp((int)floorf(rect_min.y) - pad, 0, height);
+  kintegrator->shadow_catcher_rect_max_x = clamp((int)ceilf(rect_max.x) + pad, 0, width);
+  kintegrator->shadow_catcher_rect_max_y = clamp((int)ceilf(rect_max.y) + pad, 0, height);
+}
+
 template<> Light *Scene::create_node<Light>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<Light> node = make_unique<Light>();
   Light *node_ptr = node.get();
   node->set_owner(this);
@@ -738,6 +892,7 @@ template<> Light *Scene::create_node<Light>()
 
 template<> Mesh *Scene::create_node<Mesh>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<Mesh> node = make_unique<Mesh>();
   Mesh *node_ptr = node.get();
   node->set_owner(this);
@@ -748,6 +903,7 @@ template<> Mesh *Scene::create_node<Mesh>()
 
 template<> Hair *Scene::create_node<Hair>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<Hair> node = make_unique<Hair>();
   Hair *node_ptr = node.get();
   node->set_owner(this);
@@ -758,6 +914,7 @@ template<> Hair *Scene::create_node<Hair>()
 
 template<> Volume *Scene::create_node<Volume>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<Volume> node = make_unique<Volume>();
   Volume *node_ptr = node.get();
   node->set_owner(this);
@@ -768,6 +925,7 @@ template<> Volume *Scene::create_node<Volume>()
 
 template<> PointCloud *Scene::create_node<PointCloud>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<PointCloud> node = make_unique<PointCloud>();
   PointCloud *node_ptr = node.get();
   node->set_owner(this);
@@ -778,6 +936,7 @@ template<> PointCloud *Scene::create_node<PointCloud>()
 
 template<> Object *Scene::create_node<Object>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<Object> node = make_unique<Object>();
   Object *node_ptr = node.get();
   node->set_owner(this);
@@ -788,6 +947,7 @@ template<> Object *Scene::create_node<Object>()
 
 template<> ParticleSystem *Scene::create_node<ParticleSystem>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<ParticleSystem> node = make_unique<ParticleSystem>();
   ParticleSystem *node_ptr = node.get();
   node->set_owner(this);
@@ -798,6 +958,7 @@ template<> ParticleSystem *Scene::create_node<ParticleSystem>()
 
 template<> Shader *Scene::create_node<Shader>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<Shader> node = make_unique<Shader>();
   Shader *node_ptr = node.get();
   node->set_owner(this);
@@ -808,6 +969,7 @@ template<> Shader *Scene::create_node<Shader>()
 
 template<> AlembicProcedural *Scene::create_node<AlembicProcedural>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
 #ifdef WITH_ALEMBIC
   unique_ptr<AlembicProcedural> node = make_unique<AlembicProcedural>();
   AlembicProcedural *node_ptr = node.get();
@@ -822,6 +984,7 @@ template<> AlembicProcedural *Scene::create_node<AlembicProcedural>()
 
 template<> Pass *Scene::create_node<Pass>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<Pass> node = make_unique<Pass>();
   Pass *node_ptr = node.get();
   node->set_owner(this);
@@ -832,6 +995,7 @@ template<> Pass *Scene::create_node<Pass>()
 
 template<> Camera *Scene::create_node<Camera>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<Camera> node = make_unique<Camera>();
   Camera *node_ptr = node.get();
   node->set_owner(this);
@@ -841,6 +1005,7 @@ template<> Camera *Scene::create_node<Camera>()
 
 template<> Integrator *Scene::create_node<Integrator>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<Integrator> node = make_unique<Integrator>();
   Integrator *node_ptr = node.get();
   node->set_owner(this);
@@ -850,6 +1015,7 @@ template<> Integrator *Scene::create_node<Integrator>()
 
 template<> Background *Scene::create_node<Background>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<Background> node = make_unique<Background>();
   Background *node_ptr = node.get();
   node->set_owner(this);
@@ -859,6 +1025,7 @@ template<> Background *Scene::create_node<Background>()
 
 template<> Film *Scene::create_node<Film>()
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   unique_ptr<Film> node = make_unique<Film>();
   Film *node_ptr = node.get();
   node->set_owner(this);
@@ -868,6 +1035,7 @@ template<> Film *Scene::create_node<Film>()
 
 template<> void Scene::delete_node(Light *node)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert(node->get_owner() == this);
   geometry.erase_by_swap(node);
   light_manager->tag_update(this, LightManager::LIGHT_REMOVED);
@@ -875,6 +1043,7 @@ template<> void Scene::delete_node(Light *node)
 
 template<> void Scene::delete_node(Mesh *node)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert(node->get_owner() == this);
   geometry.erase_by_swap(node);
   geometry_manager->tag_update(this, GeometryManager::MESH_REMOVED);
@@ -882,6 +1051,7 @@ template<> void Scene::delete_node(Mesh *node)
 
 template<> void Scene::delete_node(Hair *node)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert(node->get_owner() == this);
   geometry.erase_by_swap(node);
   geometry_manager->tag_update(this, GeometryManager::HAIR_REMOVED);
@@ -889,6 +1059,7 @@ template<> void Scene::delete_node(Hair *node)
 
 template<> void Scene::delete_node(Volume *node)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert(node->get_owner() == this);
   geometry.erase_by_swap(node);
   geometry_manager->tag_update(this, GeometryManager::MESH_REMOVED);
@@ -896,6 +1067,7 @@ template<> void Scene::delete_node(Volume *node)
 
 template<> void Scene::delete_node(PointCloud *node)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert(node->get_owner() == this);
   geometry.erase_by_swap(node);
   geometry_manager->tag_update(this, GeometryManager::POINT_REMOVED);
@@ -903,6 +1075,7 @@ template<> void Scene::delete_node(PointCloud *node)
 
 template<> void Scene::delete_node(Geometry *node)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert(node->get_owner() == this);
 
   uint flag;
@@ -919,6 +1092,7 @@ template<> void Scene::delete_node(Geometry *node)
 
 template<> void Scene::delete_node(Object *node)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert(node->get_owner() == this);
   objects.erase_by_swap(node);
   object_manager->tag_update(this, ObjectManager::OBJECT_REMOVED);
@@ -926,6 +1100,7 @@ template<> void Scene::delete_node(Object *node)
 
 template<> void Scene::delete_node(ParticleSystem *node)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert(node->get_owner() == this);
   particle_systems.erase_by_swap(node);
   particle_system_manager->tag_update(this);
@@ -933,6 +1108,7 @@ template<> void Scene::delete_node(ParticleSystem *node)
 
 template<> void Scene::delete_node(Shader *node)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert(node->get_owner() == this);
   /* don't delete unused shaders, not supported */
   node->clear_reference_count();
@@ -940,6 +1116,7 @@ template<> void Scene::delete_node(Shader *node)
 
 template<> void Scene::delete_node(Procedural *node)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert(node->get_owner() == this);
   procedurals.erase_by_swap(node);
   procedural_manager->tag_update();
@@ -948,6 +1125,7 @@ template<> void Scene::delete_node(Procedural *node)
 template<> void Scene::delete_node(AlembicProcedural *node)
 {
 #ifdef WITH_ALEMBIC
+  /* Locks through the Procedural overload. */
   delete_node(static_cast<Procedural *>(node));
 #else
   (void)node;
@@ -956,6 +1134,7 @@ template<> void Scene::delete_node(AlembicProcedural *node)
 
 template<> void Scene::delete_node(Pass *node)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert(node->get_owner() == this);
   passes.erase_by_swap(node);
   film->tag_modified();
@@ -975,6 +1154,7 @@ template<typename T> static void assert_same_owner(const set<T *> &nodes, const
 
 template<> void Scene::delete_nodes(const set<Geometry *> &nodes, const NodeOwner *owner)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert_same_owner(nodes, owner);
   geometry.erase_in_set(nodes);
   geometry_manager->tag_update(this, GeometryManager::GEOMETRY_REMOVED);
@@ -983,6 +1163,7 @@ template<> void Scene::delete_nodes(const set<Geometry *> &nodes, const NodeOwne
 
 template<> void Scene::delete_nodes(const set<Object *> &nodes, const NodeOwner *owner)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert_same_owner(nodes, owner);
   objects.erase_in_set(nodes);
   object_manager->tag_update(this, ObjectManager::OBJECT_REMOVED);
@@ -990,6 +1171,7 @@ template<> void Scene::delete_nodes(const set<Object *> &nodes, const NodeOwner
 
 template<> void Scene::delete_nodes(const set<ParticleSystem *> &nodes, const NodeOwner *owner)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert_same_owner(nodes, owner);
   particle_systems.erase_in_set(nodes);
   particle_system_manager->tag_update(this);
@@ -997,6 +1179,7 @@ template<> void Scene::delete_nodes(const set<ParticleSystem *> &nodes, const No
 
 template<> void Scene::delete_nodes(const set<Shader *> &nodes, const NodeOwner * /*owner*/)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   /* don't delete unused shaders, not supported */
   for (Shader *shader : nodes) {
     shader->clear_reference_count();
@@ -1005,6 +1188,7 @@ template<> void Scene::delete_nodes(const set<Shader *> &nodes, const NodeOwner
 
 template<> void Scene::delete_nodes(const set<Procedural *> &nodes, const NodeOwner *owner)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert_same_owner(nodes, owner);
   procedurals.erase_in_set(nodes);
   procedural_manager->tag_update();
@@ -1012,6 +1196,7 @@ template<> void Scene::delete_nodes(const set<Procedural *> &nodes, const NodeOw
 
 template<> void Scene::delete_nodes(const set<Pass *> &nodes, const NodeOwner *owner)
 {
+  const thread_scoped_lock node_lock(nodes_mutex);
   assert_same_owner(nodes, owner);
   passes.erase_in_set(nodes);
   film->tag_modified();
@@ -13,6 +13,7 @@
 
 #include "util/param.h"
 #include "util/string.h"
+#include "util/task.h"
 #include "util/thread.h"
 #include "util/unique_ptr.h"
 #include "util/unique_ptr_vector.h"
@@ -169,11 +170,16 @@ class Scene : public NodeOwner {
   /* mutex must be locked manually by callers */
   thread_mutex mutex;
 
+  /* Guards the node arrays and manager tags, locked internally by create_node,
+   * delete_node and delete_nodes so nodes can be created and deleted from
+   * multiple threads, e.g. during Hydra prim sync. */
+  thread_mutex nodes_mutex;
+
   /* scene update statistics */
   unique_ptr<SceneUpdateStats> update_stats;
 
   Scene(const SceneParams &params, Device *device);
-  ~Scene() override;
+  ~Scene() noexcept override;
 
   void device_update(Device *device, Progress &progress);
 
@@ -194,12 +200,24 @@ class Scene : public NodeOwner {
 
   void enable_update_stats();
 
-  bool load_kernels(Progress &progress);
+  /* Start loading render kernels for the current kernel features in the background,
+   * so that compilation overlaps with the scene device update. The feature flags are
+   * computed synchronously since the device update consumes them, only the actual
+   * compilation runs asynchronously. No-op when matching kernels are already loaded. */
+  void load_kernels_async(Progress &progress);
+  /* Wait for a load started by load_kernels_async() and report any compilation error.
+   * Must be called before rendering uses the kernels. */
+  bool wait_load_kernels(Progress &progress);
+
   bool update(Progress &progress);
 
   bool has_shadow_catcher();
   void tag_shadow_catcher_modified();
 
+  /* Path of the cached guiding field for this scene, keyed by a coarse content fingerprint.
+   * Empty unless the CYCLES_GUIDING_CACHE_DIR environment variable points to a directory. */
+  string guiding_field_cache_path(const GuidingDistributionType guiding_type);
+
   /* This function is used to create a node of a specified type instead of
    * calling 'new', and sets the scene as the owner of the node.
    * The function has overloads that will also add the created node to the right
@@ -239,6 +257,15 @@ class Scene : public NodeOwner {
   bool kernels_loaded;
   uint loaded_kernel_features;
 
+  /* BSDF closure set of the scene shaders, see KERNEL_CLOSURE_SET_*. Passed to the
+   * device so adaptively compiled kernels can strip unused closure dispatch cases. */
+  uint kernel_closure_set_ = ~0U;
+  uint loaded_kernel_closure_set_ = ~0U;
+
+  /* Background kernel compilation, joined by wait_load_kernels(). */
+  TaskPool kernel_load_pool_;
+  bool kernel_load_result_ = true;
+
   void update_kernel_features();
 
   bool has_shadow_catcher_ = false;
@@ -252,6 +279,10 @@ class Scene : public NodeOwner {
 
   /* Get size of a volume stack needed to render this scene. */
   int get_volume_stack_size() const;
+
+  /* Compute conservative raster-space bounds of the shadow catcher objects, which the CPU path
+   * tracing work uses to skip the shadow catcher path split for pixels that cannot see one. */
+  void update_shadow_catcher_rect();
 };
 
 template<> Light *Scene::create_node<Light>();
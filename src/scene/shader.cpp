@@ -504,6 +504,39 @@ void ShaderManager::device_update(Device *device,
   device_update_specific(device, dscene, scene, progress);
 }
 
+/* Detect shaders that reduce to a single transparent closure with a constant
+ * color. Such shaders pass rays straight through with a fixed tint, so the
+ * kernel can skip evaluating the graph for them entirely. */
+static bool shader_is_constant_transparent(Shader *shader, float3 *r_tint)
+{
+  if (!shader->graph || !shader->has_surface_transparent || shader->has_volume ||
+      shader->has_displacement)
+  {
+    return false;
+  }
+
+  /* AOV outputs still need the graph to be evaluated. */
+  for (ShaderNode *node : shader->graph->nodes) {
+    if (node->special_type == SHADER_SPECIAL_TYPE_OUTPUT_AOV) {
+      return false;
+    }
+  }
+
+  ShaderInput *surf = shader->graph->output()->input("Surface");
+  if (!surf->link || surf->link->parent->type != TransparentBsdfNode::get_node_type()) {
+    return false;
+  }
+
+  ShaderNode *transparent = surf->link->parent;
+  ShaderInput *color_in = transparent->input("Color");
+  if (color_in->link) {
+    return false;
+  }
+
+  *r_tint = transparent->get_float3(color_in->socket_type);
+  return true;
+}
+
 void ShaderManager::device_update_common(Device * /*device*/,
                                          DeviceScene *dscene,
                                          Scene *scene,
@@ -589,21 +622,73 @@ void ShaderManager::device_update_common(Device * /*device*/,
       flag |= SD_HAS_CONSTANT_EMISSION;
     }
 
+    /* Pure transparent check. The tint reuses the constant emission slot: a
+     * lone transparent closure cannot emit, so the emission flag is cleared to
+     * keep emission readers away from it. */
+    float3 constant_value = shader->emission_estimate;
+    if (shader_is_constant_transparent(shader, &constant_value)) {
+      flag |= SD_HAS_ONLY_TRANSPARENT;
+      flag &= ~SD_HAS_CONSTANT_EMISSION;
+    }
+
     const uint32_t cryptomatte_id = util_murmur_hash3(
         shader->name.c_str(), shader->name.length(), 0);
 
     /* regular shader */
     kshader->flags = flag;
     kshader->pass_id = shader->get_pass_id();
-    kshader->constant_emission[0] = shader->emission_estimate.x;
-    kshader->constant_emission[1] = shader->emission_estimate.y;
-    kshader->constant_emission[2] = shader->emission_estimate.z;
+    kshader->constant_emission[0] = constant_value.x;
+    kshader->constant_emission[1] = constant_value.y;
+    kshader->constant_emission[2] = constant_value.z;
     kshader->cryptomatte_id = util_hash_to_float(cryptomatte_id);
     kshader++;
 
     has_transparent_shadow |= (flag & SD_HAS_TRANSPARENT_SHADOW) != 0;
   }
 
+  /* Assign shader sort keys for the sorted shading dispatch. Shaders are ordered from simple to
+   * complex, so that when paths are sorted for shading, warps at the boundary between two shaders
+   * mix materials of similar cost, instead of pairing whatever shaders happen to be adjacent in
+   * creation order (e.g. a trivial diffuse material with a many-closure one). */
+  vector<int> shader_order(scene->shaders.size());
+  for (int i = 0; i < shader_order.size(); i++) {
+    shader_order[i] = i;
+  }
+
+  auto shader_complexity = [&](const int index) -> int {
+    const Shader *shader = scene->shaders[index];
+    if (shader->has_volume) {
+      return 3;
+    }
+    if (shader->has_surface_bssrdf || shader->has_surface_transparent) {
+      return 2;
+    }
+    if (shader->has_bump || !is_zero(shader->emission_estimate)) {
+      return 1;
+    }
+    return 0;
+  };
+
+  stable_sort(shader_order.begin(), shader_order.end(), [&](const int a, const int b) {
+    const int complexity_a = shader_complexity(a);
+    const int complexity_b = shader_complexity(b);
+    if (complexity_a != complexity_b) {
+      return complexity_a < complexity_b;
+    }
+    /* Within a complexity class order by graph size, so neighboring keys have similar amounts
+     * of shading work. */
+    const size_t num_nodes_a = (scene->shaders[a]->graph) ? scene->shaders[a]->graph->nodes.size() :
+                                                            0;
+    const size_t num_nodes_b = (scene->shaders[b]->graph) ? scene->shaders[b]->graph->nodes.size() :
+                                                            0;
+    return num_nodes_a < num_nodes_b;
+  });
+
+  kshader = dscene->shaders.data();
+  for (int position = 0; position < shader_order.size(); position++) {
+    kshader[shader_order[position]].sort_key = position;
+  }
+
   dscene->shaders.copy_to_device();
 
   /* lookup tables */
@@ -750,6 +835,105 @@ uint ShaderManager::get_graph_kernel_features(ShaderGraph *graph)
   return kernel_features;
 }
 
+static uint closure_set_from_closure_type(const ClosureType closure_type)
+{
+  switch (closure_type) {
+    case CLOSURE_BSDF_DIFFUSE_ID:
+      /* The diffuse node switches to Oren-Nayar when roughness is non-zero, the plain
+       * diffuse closure itself is always compiled. */
+      return KERNEL_CLOSURE_SET_OREN_NAYAR;
+    case CLOSURE_BSDF_OREN_NAYAR_ID:
+      return KERNEL_CLOSURE_SET_OREN_NAYAR;
+    case CLOSURE_BSDF_TRANSLUCENT_ID:
+      return KERNEL_CLOSURE_SET_TRANSLUCENT;
+    case CLOSURE_BSDF_TRANSPARENT_ID:
+      return KERNEL_CLOSURE_SET_TRANSPARENT;
+    case CLOSURE_BSDF_RAY_PORTAL_ID:
+      return KERNEL_CLOSURE_SET_RAY_PORTAL;
+    case CLOSURE_BSDF_MICROFACET_GGX_ID:
+    case CLOSURE_BSDF_MICROFACET_GGX_REFRACTION_ID:
+    case CLOSURE_BSDF_MICROFACET_GGX_GLASS_ID:
+    case CLOSURE_BSDF_MICROFACET_MULTI_GGX_ID:
+    case CLOSURE_BSDF_MICROFACET_MULTI_GGX_GLASS_ID:
+      return KERNEL_CLOSURE_SET_MICROFACET_GGX;
+    case CLOSURE_BSDF_MICROFACET_BECKMANN_ID:
+    case CLOSURE_BSDF_MICROFACET_BECKMANN_REFRACTION_ID:
+    case CLOSURE_BSDF_MICROFACET_BECKMANN_GLASS_ID:
+      return KERNEL_CLOSURE_SET_MICROFACET_BECKMANN;
+    case CLOSURE_BSDF_PHYSICAL_CONDUCTOR:
+    case CLOSURE_BSDF_F82_CONDUCTOR:
+      /* The metallic node picks GGX or Beckmann through its distribution socket, which
+       * the closure type does not carry, so keep both compiled. */
+      return KERNEL_CLOSURE_SET_MICROFACET_GGX | KERNEL_CLOSURE_SET_MICROFACET_BECKMANN;
+    case CLOSURE_BSDF_ASHIKHMIN_SHIRLEY_ID:
+      return KERNEL_CLOSURE_SET_ASHIKHMIN_SHIRLEY;
+    case CLOSURE_BSDF_ASHIKHMIN_VELVET_ID:
+      return KERNEL_CLOSURE_SET_ASHIKHMIN_VELVET;
+    case CLOSURE_BSDF_DIFFUSE_TOON_ID:
+    case CLOSURE_BSDF_GLOSSY_TOON_ID:
+      return KERNEL_CLOSURE_SET_TOON;
+    case CLOSURE_BSDF_HAIR_REFLECTION_ID:
+    case CLOSURE_BSDF_HAIR_TRANSMISSION_ID:
+      return KERNEL_CLOSURE_SET_HAIR;
+    case CLOSURE_BSDF_SHEEN_ID:
+      return KERNEL_CLOSURE_SET_SHEEN;
+    case CLOSURE_BSDF_PRINCIPLED_ID:
+      /* Compound node, covers its specular, coat, sheen, alpha and rough diffuse
+       * components. */
+      return KERNEL_CLOSURE_SET_MICROFACET_GGX | KERNEL_CLOSURE_SET_SHEEN |
+             KERNEL_CLOSURE_SET_OREN_NAYAR | KERNEL_CLOSURE_SET_TRANSPARENT;
+    case CLOSURE_BSDF_HAIR_CHIANG_ID:
+    case CLOSURE_BSDF_HAIR_HUANG_ID:
+      /* Covered by KERNEL_FEATURE_NODE_PRINCIPLED_HAIR instead. */
+      return 0;
+    default:
+      break;
+  }
+
+  if (CLOSURE_IS_BSDF(closure_type)) {
+    /* Unknown BSDF, conservatively keep the full closure set compiled. */
+    return KERNEL_CLOSURE_SET_ALL;
+  }
+
+  /* Emission, holdout, volume and BSSRDF closures are not dispatched through
+   * bsdf_sample/bsdf_eval. */
+  return 0;
+}
+
+uint ShaderManager::get_graph_closure_set(ShaderGraph *graph)
+{
+  uint closure_set = 0;
+
+  for (ShaderNode *node : graph->nodes) {
+    if (node->special_type == SHADER_SPECIAL_TYPE_CLOSURE) {
+      BsdfBaseNode *bsdf_node = static_cast<BsdfBaseNode *>(node);
+      closure_set |= closure_set_from_closure_type(bsdf_node->get_closure_type());
+    }
+  }
+
+  return closure_set;
+}
+
+uint ShaderManager::get_closure_set_mask(Scene *scene)
+{
+  if (use_osl()) {
+    /* OSL scripts can emit any closure. */
+    return KERNEL_CLOSURE_SET_ALL;
+  }
+
+  uint closure_set = 0;
+  for (int i = 0; i < scene->shaders.size(); i++) {
+    Shader *shader = scene->shaders[i];
+    if (!shader->reference_count()) {
+      continue;
+    }
+
+    closure_set |= get_graph_closure_set(shader->graph.get());
+  }
+
+  return closure_set;
+}
+
 uint ShaderManager::get_kernel_features(Scene *scene)
 {
   uint kernel_features = KERNEL_FEATURE_NODE_BSDF | KERNEL_FEATURE_NODE_EMISSION;
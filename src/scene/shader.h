@@ -209,6 +209,10 @@ class ShaderManager {
   /* Selective nodes compilation. */
   uint get_kernel_features(Scene *scene);
 
+  /* BSDF closures reachable from the scene shaders, a mask of KERNEL_CLOSURE_SET_*
+   * flags used to strip unused dispatch cases from adaptively compiled kernels. */
+  uint get_closure_set_mask(Scene *scene);
+
   float linear_rgb_to_gray(const float3 c);
   float3 rec709_to_scene_linear(const float3 c);
 
@@ -243,6 +247,7 @@ class ShaderManager {
                                 const size_t n);
 
   uint get_graph_kernel_features(ShaderGraph *graph);
+  uint get_graph_closure_set(ShaderGraph *graph);
 
   thread_spin_lock attribute_lock_;
 
@@ -12,7 +12,7 @@
 #include "util/algorithm.h"
 
 #include "util/log.h"
-#include "util/md5.h"
+#include "util/fasthash.h"
 #include "util/queue.h"
 
 namespace ccl {
@@ -43,6 +43,83 @@ bool check_node_inputs_traversed(const ShaderNode *node, const ShaderNodeSet &do
 
 } /* namespace */
 
+/* Arena Allocation
+ *
+ * Nodes and sockets are bump-allocated from the arena of the graph being built
+ * on the current thread. They may also be constructed with no graph in scope,
+ * for example by standalone node factories, in which case the memory comes from
+ * the heap. A header in front of each allocation records which of the two it
+ * was so that deletion can tell them apart; arena memory is only released once
+ * the graph itself is destroyed. */
+
+static thread_local Arena *active_graph_arena = nullptr;
+
+namespace {
+
+/* Padded so the allocation behind the header keeps the minimum alignment. */
+struct ArenaAllocHeader {
+  Arena *arena;
+  size_t pad;
+};
+
+static_assert(sizeof(ArenaAllocHeader) % sizeof(void *) == 0);
+
+}  /* namespace */
+
+static void *shader_graph_alloc(const size_t size)
+{
+  Arena *arena = active_graph_arena;
+  char *mem;
+
+  if (arena) {
+    mem = (char *)arena->alloc(size + sizeof(ArenaAllocHeader));
+  }
+  else {
+    mem = (char *)::operator new(size + sizeof(ArenaAllocHeader));
+  }
+
+  ((ArenaAllocHeader *)mem)->arena = arena;
+  return mem + sizeof(ArenaAllocHeader);
+}
+
+static void shader_graph_free(void *ptr)
+{
+  if (ptr == nullptr) {
+    return;
+  }
+
+  char *mem = (char *)ptr - sizeof(ArenaAllocHeader);
+  if (((ArenaAllocHeader *)mem)->arena == nullptr) {
+    ::operator delete(mem);
+  }
+}
+
+#define SHADER_GRAPH_ARENA_ALLOC_DEFINE(type) \
+  void *type::operator new(const size_t size) \
+  { \
+    return shader_graph_alloc(size); \
+  } \
+  void type::operator delete(void *ptr) \
+  { \
+    shader_graph_free(ptr); \
+  }
+
+SHADER_GRAPH_ARENA_ALLOC_DEFINE(ShaderInput)
+SHADER_GRAPH_ARENA_ALLOC_DEFINE(ShaderOutput)
+SHADER_GRAPH_ARENA_ALLOC_DEFINE(ShaderNode)
+
+#undef SHADER_GRAPH_ARENA_ALLOC_DEFINE
+
+ShaderGraphArenaScope::ShaderGraphArenaScope(Arena &arena) : previous(active_graph_arena)
+{
+  active_graph_arena = &arena;
+}
+
+ShaderGraphArenaScope::~ShaderGraphArenaScope()
+{
+  active_graph_arena = previous;
+}
+
 /* Sockets */
 
 void ShaderInput::disconnect()
@@ -747,24 +824,49 @@ void ShaderGraph::compute_displacement_hash()
   ShaderNodeSet nodes_displace;
   find_dependencies(nodes_displace, displacement_in);
 
-  MD5Hash md5;
+  FastHash hash;
   for (ShaderNode *node : nodes_displace) {
-    node->hash(md5);
+    node->hash(hash);
     for (ShaderInput *input : node->inputs) {
       int link_id = (input->link) ? input->link->parent->id : 0;
-      md5.append((uint8_t *)&link_id, sizeof(link_id));
-      md5.append((input->link) ? input->link->name().c_str() : "");
+      hash.append((uint8_t *)&link_id, sizeof(link_id));
+      hash.append((input->link) ? input->link->name().c_str() : "");
+    }
+
+    if (node->special_type == SHADER_SPECIAL_TYPE_OSL) {
+      /* Hash takes into account socket values, to detect changes
+       * in the code of the node we need an exception. */
+      OSLNode *oslnode = static_cast<OSLNode *>(node);
+      hash.append(oslnode->bytecode_hash);
+    }
+  }
+
+  displacement_hash = hash.get_hex();
+}
+
+void ShaderGraph::compute_content_hash()
+{
+  /* Compute hash of all nodes and links, to detect graphs with identical
+   * content. Uses the same scheme as the displacement hash above, but covers
+   * the whole graph. */
+  FastHash hash;
+  for (ShaderNode *node : nodes) {
+    node->hash(hash);
+    for (ShaderInput *input : node->inputs) {
+      const int link_id = (input->link) ? input->link->parent->id : 0;
+      hash.append((uint8_t *)&link_id, sizeof(link_id));
+      hash.append((input->link) ? input->link->name().c_str() : "");
     }
 
     if (node->special_type == SHADER_SPECIAL_TYPE_OSL) {
       /* Hash takes into account socket values, to detect changes
        * in the code of the node we need an exception. */
       OSLNode *oslnode = static_cast<OSLNode *>(node);
-      md5.append(oslnode->bytecode_hash);
+      hash.append(oslnode->bytecode_hash);
     }
   }
 
-  displacement_hash = md5.get_hex();
+  content_hash = hash.get_hex();
 }
 
 void ShaderGraph::clean(Scene *scene)
@@ -9,6 +9,7 @@
 
 #include "kernel/types.h"
 
+#include "util/arena.h"
 #include "util/map.h"
 #include "util/param.h"
 #include "util/set.h"
@@ -30,7 +31,7 @@ class SVMCompiler;
 class OSLCompiler;
 class OutputNode;
 class ConstantFolder;
-class MD5Hash;
+class FastHash;
 
 /* Bump
  *
@@ -58,6 +59,33 @@ enum ShaderNodeSpecialType {
   SHADER_SPECIAL_TYPE_OUTPUT_AOV,
 };
 
+/* Memory for shader nodes and sockets is bump-allocated from the arena of the
+ * graph being built on the current thread (see ShaderGraphArenaScope), with a
+ * heap fallback when no graph is being built. Arena memory is only released
+ * when the graph is destroyed, so individual deletes are cheap no-ops. */
+#define SHADER_GRAPH_ARENA_ALLOC \
+  static void *operator new(const size_t size); \
+  static void operator delete(void *ptr); \
+  static void *operator new(const size_t /*size*/, void *mem) \
+  { \
+    return mem; \
+  } \
+  static void operator delete(void * /*ptr*/, void * /*mem*/) {}
+
+/* Makes the arena the active allocation source for shader nodes and sockets
+ * constructed on this thread for as long as the scope exists. */
+class ShaderGraphArenaScope {
+ public:
+  explicit ShaderGraphArenaScope(Arena &arena);
+  ~ShaderGraphArenaScope();
+
+  ShaderGraphArenaScope(const ShaderGraphArenaScope &other) = delete;
+  ShaderGraphArenaScope &operator=(const ShaderGraphArenaScope &other) = delete;
+
+ protected:
+  Arena *previous;
+};
+
 /* Input
  *
  * Input socket for a shader node. May be linked to an output or not. If not
@@ -66,6 +94,8 @@ enum ShaderNodeSpecialType {
 
 class ShaderInput {
  public:
+  SHADER_GRAPH_ARENA_ALLOC
+
   ShaderInput(const SocketType &socket_type_, ShaderNode *parent_)
       : socket_type(socket_type_), parent(parent_)
 
@@ -116,6 +146,8 @@ class ShaderInput {
 
 class ShaderOutput {
  public:
+  SHADER_GRAPH_ARENA_ALLOC
+
   ShaderOutput(const SocketType &socket_type_, ShaderNode *parent_)
       : socket_type(socket_type_), parent(parent_)
   {
@@ -145,6 +177,8 @@ class ShaderOutput {
 
 class ShaderNode : public Node {
  public:
+  SHADER_GRAPH_ARENA_ALLOC
+
   explicit ShaderNode(const NodeType *type);
   ShaderNode(const ShaderNode &other);
 
@@ -293,12 +327,21 @@ using ShaderNodeMap = map<ShaderNode *, ShaderNode *, ShaderNodeIDComparator>;
 
 class ShaderGraph : public NodeOwner {
  public:
+  /* Backing storage for the nodes and sockets of this graph. Declared first so
+   * that it outlives the node array below. */
+  Arena arena;
+
   unique_ptr_vector<ShaderNode> nodes;
   size_t num_node_ids;
   bool finalized;
   bool simplified;
   string displacement_hash;
 
+  /* Hash of the full graph content as built, before finalization. Computed
+   * once by compute_content_hash, and used to reuse compiled shaders between
+   * updates and between shaders with identical graphs. */
+  string content_hash;
+
   ShaderGraph();
   ~ShaderGraph() override;
 
@@ -313,6 +356,7 @@ class ShaderGraph : public NodeOwner {
 
   void remove_proxy_nodes();
   void compute_displacement_hash();
+  void compute_content_hash();
   void simplify(Scene *scene);
   void finalize(Scene *scene, bool do_bump = false, bool bump_in_object_space = false);
 
@@ -323,6 +367,7 @@ class ShaderGraph : public NodeOwner {
   /* Create node from class and add it to the shader graph. */
   template<typename T, typename... Args> T *create_node(Args &&...args)
   {
+    const ShaderGraphArenaScope scope(arena);
     unique_ptr<T> node = make_unique<T>(args...);
     T *node_ptr = node.get();
     this->add_node(std::move(node));
@@ -332,6 +377,7 @@ class ShaderGraph : public NodeOwner {
   /* Create OSL node from class and add it to the shader graph. */
   template<typename T, typename... Args> T *create_osl_node(void *node_memory, Args &&...args)
   {
+    const ShaderGraphArenaScope scope(arena);
     T *node_ptr = new (node_memory) T(args...);
     unique_ptr<T> node(node_ptr);
     this->add_node(std::move(node));
@@ -341,6 +387,7 @@ class ShaderGraph : public NodeOwner {
   /* Create node from node type and add it to the shader graph. */
   ShaderNode *create_node(const NodeType *node_type)
   {
+    const ShaderGraphArenaScope scope(arena);
     unique_ptr<Node> node = node_type->create(node_type);
     unique_ptr<ShaderNode> shader_node(static_cast<ShaderNode *>(node.release()));
     ShaderNode *shader_node_ptr = shader_node.get();
@@ -25,8 +25,10 @@
 #include "util/transform.h"
 
 #include "kernel/svm/color_util.h"
+#include "kernel/svm/gabor.h"
 #include "kernel/svm/mapping_util.h"
 #include "kernel/svm/math_util.h"
+#include "kernel/svm/noisetex.h"
 #include "kernel/svm/ramp_util.h"
 
 namespace ccl {
@@ -285,6 +287,24 @@ ImageParams ImageTextureNode::image_params() const
   return params;
 }
 
+ImageStoragePrecision ImageTextureNode::usage_precision(ShaderType shader_type,
+                                                        const bool color_used) const
+{
+  /* Bump and displacement evaluation is sensitive to quantization, keep the
+   * source precision there. */
+  if (shader_type == SHADER_TYPE_BUMP || shader_type == SHADER_TYPE_DISPLACEMENT) {
+    return IMAGE_PRECISION_FULL;
+  }
+
+  /* When only the alpha output is used, 8 bits per channel is enough. */
+  if (!color_used) {
+    return IMAGE_PRECISION_BYTE;
+  }
+
+  /* Color and other surface/volume inputs tolerate half float. */
+  return IMAGE_PRECISION_HALF;
+}
+
 void ImageTextureNode::cull_tiles(Scene *scene, ShaderGraph *graph)
 {
   /* Box projection computes its own UVs that always lie in the
@@ -370,10 +390,20 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
   ShaderOutput *color_out = output("Color");
   ShaderOutput *alpha_out = output("Alpha");
 
+  const ImageStoragePrecision precision = usage_precision(compiler.output_type(),
+                                                          !color_out->links.empty());
+
   if (handle.empty()) {
     cull_tiles(compiler.scene, compiler.current_graph);
     ImageManager *image_manager = compiler.scene->image_manager.get();
-    handle = image_manager->add_image(filename, image_params(), tiles);
+    ImageParams params = image_params();
+    params.precision = precision;
+    handle = image_manager->add_image(filename, params, tiles);
+  }
+  else {
+    /* The image may have been added for a less demanding shader type, for
+     * example for the surface before the displacement. */
+    handle.require_precision(precision);
   }
 
   /* All tiles have the same metadata. */
@@ -447,13 +477,22 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
 
 void ImageTextureNode::compile(OSLCompiler &compiler)
 {
+  ShaderOutput *color_out = output("Color");
   ShaderOutput *alpha_out = output("Alpha");
 
   tex_mapping.compile(compiler);
 
+  const ImageStoragePrecision precision = usage_precision(compiler.output_type(),
+                                                          !color_out->links.empty());
+
   if (handle.empty()) {
     ImageManager *image_manager = compiler.scene->image_manager.get();
-    handle = image_manager->add_image(filename, image_params());
+    ImageParams params = image_params();
+    params.precision = precision;
+    handle = image_manager->add_image(filename, params);
+  }
+  else {
+    handle.require_precision(precision);
   }
 
   const ImageMetaData metadata = handle.metadata();
@@ -1168,6 +1207,90 @@ NODE_DEFINE(NoiseTextureNode)
 
 NoiseTextureNode::NoiseTextureNode() : TextureNode(get_node_type()) {}
 
+void NoiseTextureNode::constant_fold(const ConstantFolder &folder)
+{
+  /* Procedural texture chains driven by constant coordinates evaluate to a
+   * fixed value, fold them instead of re-evaluating the noise per sample. */
+  if (!folder.all_inputs_constant() || !tex_mapping.skip()) {
+    return;
+  }
+
+  const float clamped_detail = clamp(detail, 0.0f, 15.0f);
+  const float clamped_roughness = fmaxf(roughness, 0.0f);
+  const float3 p = vector * scale;
+  const float scaled_w = w * scale;
+
+  float value;
+  float3 color;
+  switch (dimensions) {
+    case 1:
+      noise_texture_1d(scaled_w,
+                       clamped_detail,
+                       clamped_roughness,
+                       lacunarity,
+                       offset,
+                       gain,
+                       distortion,
+                       type,
+                       use_normalize,
+                       true,
+                       &value,
+                       &color);
+      break;
+    case 2:
+      noise_texture_2d(make_float2(p.x, p.y),
+                       clamped_detail,
+                       clamped_roughness,
+                       lacunarity,
+                       offset,
+                       gain,
+                       distortion,
+                       type,
+                       use_normalize,
+                       true,
+                       &value,
+                       &color);
+      break;
+    case 3:
+      noise_texture_3d(p,
+                       clamped_detail,
+                       clamped_roughness,
+                       lacunarity,
+                       offset,
+                       gain,
+                       distortion,
+                       type,
+                       use_normalize,
+                       true,
+                       &value,
+                       &color);
+      break;
+    case 4:
+      noise_texture_4d(make_float4(p, scaled_w),
+                       clamped_detail,
+                       clamped_roughness,
+                       lacunarity,
+                       offset,
+                       gain,
+                       distortion,
+                       type,
+                       use_normalize,
+                       true,
+                       &value,
+                       &color);
+      break;
+    default:
+      return;
+  }
+
+  if (folder.output == output("Fac")) {
+    folder.make_constant(value);
+  }
+  else {
+    folder.make_constant(color);
+  }
+}
+
 void NoiseTextureNode::compile(SVMCompiler &compiler)
 {
   ShaderInput *vector_in = input("Vector");
@@ -1252,6 +1375,49 @@ NODE_DEFINE(GaborTextureNode)
 
 GaborTextureNode::GaborTextureNode() : TextureNode(get_node_type()) {}
 
+void GaborTextureNode::constant_fold(const ConstantFolder &folder)
+{
+  if (!folder.all_inputs_constant() || !tex_mapping.skip()) {
+    return;
+  }
+
+  const float3 scaled_coordinates = vector * scale;
+  const float isotropy = 1.0f - clamp(anisotropy, 0.0f, 1.0f);
+  const float clamped_frequency = max(0.001f, frequency);
+
+  float2 phasor = make_float2(0.0f, 0.0f);
+  float standard_deviation = 1.0f;
+  switch (type) {
+    case NODE_GABOR_TYPE_2D: {
+      phasor = compute_2d_gabor_noise(
+          make_float2(scaled_coordinates.x, scaled_coordinates.y),
+          clamped_frequency,
+          isotropy,
+          orientation_2d);
+      standard_deviation = compute_2d_gabor_standard_deviation();
+      break;
+    }
+    case NODE_GABOR_TYPE_3D: {
+      phasor = compute_3d_gabor_noise(
+          scaled_coordinates, clamped_frequency, isotropy, normalize(orientation_3d));
+      standard_deviation = compute_3d_gabor_standard_deviation();
+      break;
+    }
+  }
+
+  const float normalization_factor = 6.0f * standard_deviation;
+
+  if (folder.output == output("Value")) {
+    folder.make_constant((phasor.y / normalization_factor) * 0.5f + 0.5f);
+  }
+  else if (folder.output == output("Phase")) {
+    folder.make_constant((atan2f(phasor.y, phasor.x) + M_PI_F) / (2.0f * M_PI_F));
+  }
+  else {
+    folder.make_constant(len(phasor) / normalization_factor);
+  }
+}
+
 void GaborTextureNode::compile(SVMCompiler &compiler)
 {
   ShaderInput *vector_in = input("Vector");
@@ -6669,13 +6835,14 @@ OutputAOVNode::OutputAOVNode() : ShaderNode(get_node_type())
 {
   special_type = SHADER_SPECIAL_TYPE_OUTPUT_AOV;
   offset = -1;
+  is_half = false;
 }
 
 void OutputAOVNode::simplify_settings(Scene *scene)
 {
-  offset = scene->film->get_aov_offset(scene, name, is_color);
+  offset = scene->film->get_aov_offset(scene, name, is_color, is_half);
   if (offset == -1) {
-    offset = scene->film->get_aov_offset(scene, name, is_color);
+    offset = scene->film->get_aov_offset(scene, name, is_color, is_half);
   }
 
   if (offset == -1 || is_color) {
@@ -6691,7 +6858,7 @@ void OutputAOVNode::compile(SVMCompiler &compiler)
   assert(offset >= 0);
 
   if (is_color) {
-    compiler.add_node(NODE_AOV_COLOR, compiler.stack_assign(input("Color")), offset);
+    compiler.add_node(NODE_AOV_COLOR, compiler.stack_assign(input("Color")), offset, is_half);
   }
   else {
     compiler.add_node(NODE_AOV_VALUE, compiler.stack_assign(input("Value")), offset);
@@ -7500,6 +7667,7 @@ OSLNode *OSLNode::create(ShaderGraph *graph, const size_t num_inputs, const OSLN
   const size_t node_size = align_up(sizeof(OSLNode), 16);
   const size_t inputs_size = align_up(SocketType::max_size(), 16) * num_inputs;
 
+  const ShaderGraphArenaScope scope(graph->arena);
   char *node_memory = (char *)operator new(node_size + inputs_size);
   memset(node_memory, 0, node_size + inputs_size);
 
@@ -118,6 +118,7 @@ class ImageTextureNode : public ImageSlotTextureNode {
 
  protected:
   void cull_tiles(Scene *scene, ShaderGraph *graph);
+  ImageStoragePrecision usage_precision(ShaderType shader_type, const bool color_used) const;
 };
 
 class EnvironmentTextureNode : public ImageSlotTextureNode {
@@ -213,6 +214,7 @@ class OutputAOVNode : public ShaderNode {
 
   int offset;
   bool is_color;
+  bool is_half;
 };
 
 class GradientTextureNode : public TextureNode {
@@ -227,6 +229,8 @@ class NoiseTextureNode : public TextureNode {
  public:
   SHADER_NODE_CLASS(NoiseTextureNode)
 
+  void constant_fold(const ConstantFolder &folder) override;
+
   NODE_SOCKET_API(int, dimensions)
   NODE_SOCKET_API(NodeNoiseType, type)
   NODE_SOCKET_API(bool, use_normalize)
@@ -245,6 +249,8 @@ class GaborTextureNode : public TextureNode {
  public:
   SHADER_NODE_CLASS(GaborTextureNode)
 
+  void constant_fold(const ConstantFolder &folder) override;
+
   NODE_SOCKET_API(NodeGaborType, type)
   NODE_SOCKET_API(float3, vector)
   NODE_SOCKET_API(float, scale)
@@ -1560,17 +1566,8 @@ class OSLNode final : public ShaderNode {
                          const OSLNode *from = nullptr);
   ~OSLNode() override;
 
-  static void operator delete(void *ptr)
-  {
-    /* Override delete operator to silence new-delete-type-mismatch ASAN warnings
-     * regarding size mismatch in the destructor. This is intentional as we allocate
-     * extra space at the end of the node. */
-    ::operator delete(ptr);
-  }
-  static void operator delete(void * /*unused*/, void * /*unused*/)
-  {
-    /* Deliberately empty placement delete operator, to avoid MSVC warning C4291. */
-  }
+  /* The allocation operators inherited from ShaderNode are unsized, which also
+   * keeps ASAN happy about the extra space allocated at the end of the node. */
 
   ShaderNode *clone(ShaderGraph *graph) const override;
 
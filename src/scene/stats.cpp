@@ -3,6 +3,9 @@
  * SPDX-License-Identifier: Apache-2.0 */
 
 #include "scene/stats.h"
+
+#include "device/kernel.h"
+
 #include "scene/object.h"
 #include "util/algorithm.h"
 
@@ -230,6 +233,17 @@ string ImageStats::full_report(const int indent_level)
 RenderStats::RenderStats()
 {
   has_profiling = false;
+  has_device_kernel_times = false;
+}
+
+void RenderStats::collect_kernel_times(const map<DeviceKernel, double> &times)
+{
+  has_device_kernel_times = true;
+
+  device_kernel_times.clear();
+  for (const auto &[kernel, time] : times) {
+    device_kernel_times.add_entry(NamedTimeEntry(device_kernel_as_string(kernel), time));
+  }
 }
 
 void RenderStats::collect_profiling(Scene *scene, Profiler &prof)
@@ -251,6 +265,7 @@ void RenderStats::collect_profiling(Scene *scene, Profiler &prof)
   surface.add_entry("Direct Light", prof.get_event(PROFILING_SHADE_SURFACE_DIRECT_LIGHT));
   surface.add_entry("Indirect Light", prof.get_event(PROFILING_SHADE_SURFACE_INDIRECT_LIGHT));
   surface.add_entry("Ambient Occlusion", prof.get_event(PROFILING_SHADE_SURFACE_AO));
+  surface.add_entry("Manifold Walk", prof.get_event(PROFILING_SHADE_SURFACE_MNEE));
 
   NamedNestedSampleStats &volume = kernel.add_entry("Shade Volume", 0);
   volume.add_entry("Setup", prof.get_event(PROFILING_SHADE_VOLUME_SETUP));
@@ -292,11 +307,17 @@ string RenderStats::full_report()
   string result;
   result += "Mesh statistics:\n" + mesh.full_report(1);
   result += "Image statistics:\n" + image.full_report(1);
+  if (!device_memory.entries.empty()) {
+    result += "Device memory statistics:\n" + device_memory.full_report(1);
+  }
   if (has_profiling) {
     result += "Kernel statistics:\n" + kernel.full_report(1);
     result += "Shader statistics:\n" + shaders.full_report(1);
     result += "Object statistics:\n" + objects.full_report(1);
   }
+  else if (has_device_kernel_times) {
+    result += "Device kernel times:\n" + device_kernel_times.full_report(1);
+  }
   else {
     result += "Profiling information not available (only works with CPU rendering)";
   }
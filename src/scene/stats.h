@@ -6,6 +6,7 @@
 
 #include "scene/scene.h"
 
+#include "util/map.h"
 #include "util/string.h"
 #include "util/vector.h"
 
@@ -170,13 +171,20 @@ class RenderStats {
   /* Collect kernel sampling information from Stats. */
   void collect_profiling(Scene *scene, Profiler &prof);
 
+  /* Collect per-kernel execution times recorded by the device queues. */
+  void collect_kernel_times(const map<DeviceKernel, double> &times);
+
   bool has_profiling;
+  bool has_device_kernel_times;
 
   MeshStats mesh;
   ImageStats image;
+  /* Device-side allocations by buffer name, snapshotted from the device Stats registry. */
+  NamedSizeStats device_memory;
   NamedNestedSampleStats kernel;
   NamedSampleCountStats shaders;
   NamedSampleCountStats objects;
+  NamedTimeStats device_kernel_times;
 };
 
 class UpdateTimeStats {
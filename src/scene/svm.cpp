@@ -16,9 +16,12 @@
 #include "scene/stats.h"
 #include "scene/svm.h"
 
+#include "util/fasthash.h"
 #include "util/log.h"
+#include "util/map.h"
 #include "util/progress.h"
 #include "util/task.h"
+#include "util/tbb.h"
 
 namespace ccl {
 
@@ -48,6 +51,41 @@ void SVMShaderManager::device_update_shader(Scene *scene,
             << summary.full_report();
 }
 
+void SVMShaderManager::CachedProgram::capture(const Shader *shader)
+{
+  has_surface = shader->has_surface;
+  has_surface_transparent = shader->has_surface_transparent;
+  has_surface_raytrace = shader->has_surface_raytrace;
+  has_surface_bssrdf = shader->has_surface_bssrdf;
+  has_bump = shader->has_bump;
+  has_bssrdf_bump = shader->has_bssrdf_bump;
+  has_volume = shader->has_volume;
+  has_displacement = shader->has_displacement;
+  has_surface_spatial_varying = shader->has_surface_spatial_varying;
+  has_volume_spatial_varying = shader->has_volume_spatial_varying;
+  has_volume_attribute_dependency = shader->has_volume_attribute_dependency;
+}
+
+void SVMShaderManager::CachedProgram::apply(Shader *shader) const
+{
+  shader->has_surface = has_surface;
+  shader->has_surface_transparent = has_surface_transparent;
+  shader->has_surface_raytrace = has_surface_raytrace;
+  shader->has_surface_bssrdf = has_surface_bssrdf;
+  shader->has_bump = has_bump;
+  shader->has_bssrdf_bump = has_bssrdf_bump;
+  shader->has_volume = has_volume;
+  shader->has_displacement = has_displacement;
+  shader->has_surface_spatial_varying = has_surface_spatial_varying;
+  shader->has_volume_spatial_varying = has_volume_spatial_varying;
+  shader->has_volume_attribute_dependency = has_volume_attribute_dependency;
+}
+
+static size_t svm_nodes_hash(const array<int4> &nodes)
+{
+  return util_fast_hash(nodes.data(), nodes.size() * sizeof(int4));
+}
+
 void SVMShaderManager::device_update_specific(Device *device,
                                               DeviceScene *dscene,
                                               Scene *scene,
@@ -72,10 +110,49 @@ void SVMShaderManager::device_update_specific(Device *device,
   /* test if we need to update */
   device_free(device, dscene, scene);
 
-  /* Build all shaders. */
+  /* Group shaders by graph content so identical graphs are compiled once, and
+   * programs from the previous update are reused when the graph is unchanged.
+   * The background shader compiles differently and bump generation depends on
+   * the displacement method, so both are part of the key. */
+  Shader *const background_shader = scene->background->get_shader(scene);
+
+  vector<string> shader_key(num_shaders);
+  parallel_for(blocked_range<int>(0, num_shaders, 1), [&](const blocked_range<int> &r) {
+    for (int i = r.begin(); i != r.end(); i++) {
+      Shader *shader = scene->shaders[i];
+      if (shader->graph->content_hash.empty()) {
+        shader->graph->compute_content_hash();
+      }
+      shader_key[i] = string_printf("%s_%d_%d",
+                                    shader->graph->content_hash.c_str(),
+                                    shader == background_shader,
+                                    (int)shader->get_displacement_method());
+    }
+  });
+
+  /* Build all shaders without a cached or shared program. */
   TaskPool task_pool;
   vector<array<int4>> shader_svm_nodes(num_shaders);
+  vector<int> compile_source(num_shaders, -1);
+  unordered_map<string, int> key_to_shader;
+  int num_cached = 0;
   for (int i = 0; i < num_shaders; i++) {
+    const auto cached = program_cache.find(shader_key[i]);
+    if (cached != program_cache.end()) {
+      shader_svm_nodes[i] = cached->second.svm_nodes;
+      cached->second.apply(scene->shaders[i]);
+      num_cached++;
+      continue;
+    }
+
+    const auto it = key_to_shader.find(shader_key[i]);
+    if (it != key_to_shader.end()) {
+      /* Identical to another shader compiled in this update, copy below. */
+      compile_source[i] = it->second;
+      continue;
+    }
+
+    key_to_shader.emplace(shader_key[i], i);
     task_pool.push([this, scene, &progress, &shader_svm_nodes, i] {
       device_update_shader(scene, scene->shaders[i], progress, &shader_svm_nodes[i]);
     });
@@ -86,17 +163,85 @@ void SVMShaderManager::device_update_specific(Device *device,
     return;
   }
 
+  /* Shaders identical to a compiled one share its program and flags. */
+  int num_shared = 0;
+  for (int i = 0; i < num_shaders; i++) {
+    if (compile_source[i] == -1) {
+      continue;
+    }
+    shader_svm_nodes[i] = shader_svm_nodes[compile_source[i]];
+    CachedProgram program;
+    program.capture(scene->shaders[compile_source[i]]);
+    program.apply(scene->shaders[i]);
+    num_shared++;
+  }
+
+  VLOG_INFO << "Reused " << num_cached << " cached and " << num_shared
+            << " shared of " << num_shaders << " shader programs.";
+
+  /* Refresh the cache, dropping programs whose graphs are no longer used. */
+  {
+    unordered_map<string, CachedProgram> new_cache;
+    for (int i = 0; i < num_shaders; i++) {
+      if (new_cache.find(shader_key[i]) == new_cache.end()) {
+        CachedProgram program;
+        program.svm_nodes = shader_svm_nodes[i];
+        program.capture(scene->shaders[i]);
+        new_cache.emplace(shader_key[i], std::move(program));
+      }
+    }
+    program_cache = std::move(new_cache);
+  }
+
+  /* Deduplicate identical compiled shaders. All jump offsets inside a
+   * compiled shader are local, so byte-identical programs can share a single
+   * copy of their nodes and differ only in their jump table entry. */
+  vector<size_t> shader_hash(num_shaders);
+  parallel_for(blocked_range<int>(0, num_shaders, 1), [&](const blocked_range<int> &r) {
+    for (int i = r.begin(); i != r.end(); i++) {
+      shader_hash[i] = svm_nodes_hash(shader_svm_nodes[i]);
+    }
+  });
+
+  vector<int> unique_shader(num_shaders);
+  unordered_multimap<size_t, int> dedup_map;
+  int num_unique_shaders = 0;
+  for (int i = 0; i < num_shaders; i++) {
+    const array<int4> &nodes = shader_svm_nodes[i];
+    const size_t hash = shader_hash[i];
+
+    unique_shader[i] = i;
+    const auto range = dedup_map.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      const array<int4> &other_nodes = shader_svm_nodes[it->second];
+      if (other_nodes.size() == nodes.size() &&
+          memcmp(other_nodes.data(), nodes.data(), nodes.size() * sizeof(int4)) == 0)
+      {
+        unique_shader[i] = it->second;
+        break;
+      }
+    }
+
+    if (unique_shader[i] == i) {
+      dedup_map.emplace(hash, i);
+      num_unique_shaders++;
+    }
+  }
+
   /* The global node list contains a jump table (one node per shader)
-   * followed by the nodes of all shaders. */
+   * followed by the nodes of all unique shaders. */
   int svm_nodes_size = num_shaders;
+  vector<int> shader_node_offset(num_shaders, 0);
   for (int i = 0; i < num_shaders; i++) {
-    /* Since we're not copying the local jump node, the size ends up being one node lower. */
-    svm_nodes_size += shader_svm_nodes[i].size() - 1;
+    if (unique_shader[i] == i) {
+      shader_node_offset[i] = svm_nodes_size;
+      /* Since we're not copying the local jump node, the size ends up being one node lower. */
+      svm_nodes_size += shader_svm_nodes[i].size() - 1;
+    }
   }
 
   int4 *svm_nodes = dscene->svm_nodes.alloc(svm_nodes_size);
 
-  int node_offset = num_shaders;
   for (int i = 0; i < num_shaders; i++) {
     Shader *shader = scene->shaders[i];
 
@@ -107,7 +252,9 @@ void SVMShaderManager::device_update_specific(Device *device,
 
     /* Update the global jump table.
      * Each compiled shader starts with a jump node that has offsets local
-     * to the shader, so copy those and add the offset into the global node list. */
+     * to the shader, so copy those and add the offset into the global node list.
+     * Shaders that compiled to an identical program share its nodes. */
+    const int node_offset = shader_node_offset[unique_shader[i]];
     int4 &global_jump_node = svm_nodes[shader->id];
     const int4 &local_jump_node = shader_svm_nodes[i][0];
 
@@ -115,18 +262,23 @@ void SVMShaderManager::device_update_specific(Device *device,
     global_jump_node.y = local_jump_node.y - 1 + node_offset;
     global_jump_node.z = local_jump_node.z - 1 + node_offset;
     global_jump_node.w = local_jump_node.w - 1 + node_offset;
-
-    node_offset += shader_svm_nodes[i].size() - 1;
   }
 
-  /* Copy the nodes of each shader into the correct location. */
-  svm_nodes += num_shaders;
-  for (int i = 0; i < num_shaders; i++) {
-    const int shader_size = shader_svm_nodes[i].size() - 1;
+  /* Copy the nodes of each unique shader into the correct location. The
+   * offsets are disjoint, so the copies can run concurrently. */
+  parallel_for(blocked_range<int>(0, num_shaders, 1), [&](const blocked_range<int> &r) {
+    for (int i = r.begin(); i != r.end(); i++) {
+      if (unique_shader[i] != i) {
+        continue;
+      }
+      const int shader_size = shader_svm_nodes[i].size() - 1;
 
-    std::copy_n(&shader_svm_nodes[i][1], shader_size, svm_nodes);
-    svm_nodes += shader_size;
-  }
+      std::copy_n(&shader_svm_nodes[i][1], shader_size, svm_nodes + shader_node_offset[i]);
+    }
+  });
+
+  VLOG_INFO << "Deduplicated " << num_shaders - num_unique_shaders << " of " << num_shaders
+            << " compiled shaders.";
 
   if (progress.get_cancel()) {
     return;
@@ -10,6 +10,7 @@
 #include "scene/shader_graph.h"
 
 #include "util/array.h"
+#include "util/map.h"
 #include "util/string.h"
 
 namespace ccl {
@@ -41,6 +42,32 @@ class SVMShaderManager : public ShaderManager {
                             Shader *shader,
                             Progress &progress,
                             array<int4> *svm_nodes);
+
+  /* Compiled program for one graph content hash, kept between updates so
+   * shaders whose graph is unchanged, or identical to an already compiled
+   * one, skip graph finalization and compilation entirely. */
+  struct CachedProgram {
+    array<int4> svm_nodes;
+
+    /* Shader flags that compilation derives from the graph, replayed on
+     * shaders that reuse this program. */
+    bool has_surface;
+    bool has_surface_transparent;
+    bool has_surface_raytrace;
+    bool has_surface_bssrdf;
+    bool has_bump;
+    bool has_bssrdf_bump;
+    bool has_volume;
+    bool has_displacement;
+    bool has_surface_spatial_varying;
+    bool has_volume_spatial_varying;
+    bool has_volume_attribute_dependency;
+
+    void capture(const Shader *shader);
+    void apply(Shader *shader) const;
+  };
+
+  unordered_map<string, CachedProgram> program_cache;
 };
 
 /* Graph Compiler */
@@ -7,6 +7,7 @@
 #include "scene/scene.h"
 #include "scene/stats.h"
 
+#include "util/fasthash.h"
 #include "util/log.h"
 #include "util/time.h"
 
@@ -64,11 +65,30 @@ size_t LookupTables::add_table(DeviceScene *dscene, vector<float> &data)
 {
   assert(!data.empty());
 
+  const uint64_t hash = util_fast_hash(data.data(), sizeof(float) * data.size());
+
+  /* Share an already allocated table with identical contents. Shader updates
+   * tend to resubmit the same data, which would otherwise keep appending
+   * duplicate slices. The hash is verified with an exact comparison. */
+  for (Table &table : lookup_tables) {
+    if (table.hash == hash && table.data_size == data.size() &&
+        memcmp(dscene->lookup_table.data() + table.offset,
+               data.data(),
+               sizeof(float) * data.size()) == 0)
+    {
+      table.users++;
+      return table.offset;
+    }
+  }
+
   need_update_ = true;
 
   Table new_table;
   new_table.offset = 0;
   new_table.size = round_up_to_multiple(data.size(), TABLE_CHUNK_SIZE);
+  new_table.hash = hash;
+  new_table.data_size = data.size();
+  new_table.users = 1;
 
   /* find space to put lookup table */
   list<Table>::iterator table;
@@ -101,13 +121,15 @@ void LookupTables::remove_table(size_t *offset)
     return;
   }
 
-  need_update_ = true;
-
   list<Table>::iterator table;
 
   for (table = lookup_tables.begin(); table != lookup_tables.end(); table++) {
     if (table->offset == *offset) {
-      lookup_tables.erase(table);
+      /* Only release the allocation once the last user is gone. */
+      if (--table->users == 0) {
+        lookup_tables.erase(table);
+        need_update_ = true;
+      }
       *offset = TABLE_OFFSET_INVALID;
       return;
     }
@@ -23,6 +23,10 @@ class LookupTables {
   struct Table {
     size_t offset;
     size_t size;
+    /* Content hash and un-rounded size, to share identical tables. */
+    uint64_t hash;
+    size_t data_size;
+    int users;
   };
 
   list<Table> lookup_tables;
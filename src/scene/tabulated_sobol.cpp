@@ -8,6 +8,13 @@
 
 #include "scene/tabulated_sobol.h"
 #include "util/hash.h"
+#include "util/log.h"
+#include "util/path.h"
+#include "util/string.h"
+#include "util/task.h"
+#include "util/vector.h"
+
+#include <cstring>
 
 namespace ccl {
 
@@ -66,4 +73,49 @@ void tabulated_sobol_generate_4D(float4 points[], const int size, const int rng_
   }
 }
 
+/* Version of the on-disk table cache. Bump whenever the generation code above changes,
+ * so that stale tables are not picked up. */
+#define TAB_SOBOL_CACHE_VERSION 1
+
+static string tabulated_sobol_cache_path(const int sequence_size, const int num_patterns)
+{
+  const string filename = string_printf(
+      "tabulated_sobol_v%d_%dx%d.bin", TAB_SOBOL_CACHE_VERSION, num_patterns, sequence_size);
+  return path_cache_get(path_join("tables", filename));
+}
+
+void tabulated_sobol_generate_table(float4 table[], const int sequence_size, const int num_patterns)
+{
+  const size_t table_bytes = (size_t)sequence_size * num_patterns * sizeof(float4);
+  const string cache_path = tabulated_sobol_cache_path(sequence_size, num_patterns);
+
+  /* The tables only depend on their size, so re-use them from the cache when possible. */
+  if (path_exists(cache_path)) {
+    vector<uint8_t> binary;
+    if (path_read_binary(cache_path, binary) && binary.size() == table_bytes) {
+      memcpy(table, binary.data(), table_bytes);
+      return;
+    }
+    VLOG_WORK << "Ignoring invalid tabulated Sobol cache file " << cache_path;
+  }
+
+  TaskPool pool;
+  for (int j = 0; j < num_patterns; ++j) {
+    float4 *sequence = table + (size_t)j * sequence_size;
+    pool.push([sequence, sequence_size, j] {
+      tabulated_sobol_generate_4D(sequence, sequence_size, j);
+    });
+  }
+  pool.wait_work();
+
+  /* Persist for the next render start. Failure to write is not an error, the
+   * tables will simply be generated again. */
+  path_create_directories(cache_path);
+  vector<uint8_t> binary(table_bytes);
+  memcpy(binary.data(), table, table_bytes);
+  if (!path_write_binary(cache_path, binary)) {
+    VLOG_WORK << "Failed to write tabulated Sobol cache file " << cache_path;
+  }
+}
+
 }
@@ -10,4 +10,10 @@ namespace ccl {
 
 void tabulated_sobol_generate_4D(float4 points[], const int size, const int rng_seed);
 
+/* Fill the table with `num_patterns` sequences of `sequence_size` points each,
+ * re-using a previously generated table from the on-disk cache when available. */
+void tabulated_sobol_generate_table(float4 table[],
+                                    const int sequence_size,
+                                    const int num_patterns);
+
 }
@@ -18,6 +18,7 @@
 #include "util/log.h"
 #include "util/openvdb.h"
 #include "util/progress.h"
+#include "util/tbb.h"
 #include "util/types.h"
 
 namespace ccl {
@@ -44,6 +45,10 @@ Volume::Volume() : Mesh(get_node_type(), Geometry::VOLUME)
 void Volume::clear(bool preserve_shaders)
 {
   Mesh::clear(preserve_shaders, true);
+
+  occupancy_bits.clear();
+  occupancy_res = make_int3(0);
+  occupancy_tfm = transform_identity();
 }
 
 struct QuadData {
@@ -168,6 +173,8 @@ class VolumeMeshBuilder {
 
   void convert_quads_to_tris(const vector<QuadData> &quads, vector<int> &tris);
 
+  void create_occupancy(Volume *volume) const;
+
   bool empty_grid() const;
 
 #ifdef WITH_OPENVDB
@@ -308,14 +315,72 @@ void VolumeMeshBuilder::generate_vertices_and_quads(vector<ccl::int3> &vertices_
 
   const int3 resolution = make_int3(bbox.dim().x(), bbox.dim().y(), bbox.dim().z());
 
-  unordered_map<size_t, int> used_verts;
+  /* Collect non-empty leaf nodes first, so that the neighbor queries below can
+   * run over batches of leaves in parallel. */
+  vector<openvdb::CoordBBox> leaf_bboxes;
 
   for (auto iter = tree.cbeginLeaf(); iter; ++iter) {
-    if (iter->isEmpty()) {
+    if (!iter->isEmpty()) {
+      leaf_bboxes.push_back(iter->getNodeBoundingBox());
+    }
+  }
+
+  /* Determine which faces sit on the border between an active and an inactive
+   * leaf, and so need a quad. The probes are pure reads into the const tree.
+   *
+   * We verify that a leaf exists by probing a coordinate that is at its center,
+   * to do so we compute the center of the current leaf and offset this coordinate
+   * by the size of a leaf in each direction. */
+  static const int LEAF_DIM = openvdb::MaskGrid::TreeType::LeafNodeType::DIM;
+  static const size_t LEAVES_PER_TASK = 64;
+
+  vector<int> face_masks(leaf_bboxes.size());
+
+  parallel_for(blocked_range<size_t>(0, leaf_bboxes.size(), LEAVES_PER_TASK),
+               [&](const blocked_range<size_t> &r) {
+                 for (size_t i = r.begin(); i != r.end(); i++) {
+                   const auto center = leaf_bboxes[i].min() + openvdb::Coord(LEAF_DIM / 2);
+                   int mask = 0;
+
+                   if (!is_non_empty_leaf(
+                           tree, openvdb::Coord(center.x() - LEAF_DIM, center.y(), center.z()))) {
+                     mask |= 1 << QUAD_X_MIN;
+                   }
+                   if (!is_non_empty_leaf(
+                           tree, openvdb::Coord(center.x() + LEAF_DIM, center.y(), center.z()))) {
+                     mask |= 1 << QUAD_X_MAX;
+                   }
+                   if (!is_non_empty_leaf(
+                           tree, openvdb::Coord(center.x(), center.y() - LEAF_DIM, center.z()))) {
+                     mask |= 1 << QUAD_Y_MIN;
+                   }
+                   if (!is_non_empty_leaf(
+                           tree, openvdb::Coord(center.x(), center.y() + LEAF_DIM, center.z()))) {
+                     mask |= 1 << QUAD_Y_MAX;
+                   }
+                   if (!is_non_empty_leaf(
+                           tree, openvdb::Coord(center.x(), center.y(), center.z() - LEAF_DIM))) {
+                     mask |= 1 << QUAD_Z_MIN;
+                   }
+                   if (!is_non_empty_leaf(
+                           tree, openvdb::Coord(center.x(), center.y(), center.z() + LEAF_DIM))) {
+                     mask |= 1 << QUAD_Z_MAX;
+                   }
+
+                   face_masks[i] = mask;
+                 }
+               });
+
+  /* Emit vertices and quads, serial as vertices are deduplicated through a
+   * shared map. This is cheap next to the topology queries above. */
+  unordered_map<size_t, int> used_verts;
+
+  for (size_t i = 0; i < leaf_bboxes.size(); i++) {
+    if (face_masks[i] == 0) {
       continue;
     }
 
-    openvdb::CoordBBox leaf_bbox = iter->getNodeBoundingBox();
+    openvdb::CoordBBox leaf_bbox = leaf_bboxes[i];
     /* +1 to convert from exclusive to include bounds. */
     leaf_bbox.max() = leaf_bbox.max().offsetBy(1);
 
@@ -333,37 +398,10 @@ void VolumeMeshBuilder::generate_vertices_and_quads(vector<ccl::int3> &vertices_
         make_int3(min[0], max[1], max[2]),
     };
 
-    /* Only create a quad if on the border between an active and an inactive leaf.
-     *
-     * We verify that a leaf exists by probing a coordinate that is at its center,
-     * to do so we compute the center of the current leaf and offset this coordinate
-     * by the size of a leaf in each direction.
-     */
-    static const int LEAF_DIM = openvdb::MaskGrid::TreeType::LeafNodeType::DIM;
-    auto center = leaf_bbox.min() + openvdb::Coord(LEAF_DIM / 2);
-
-    if (!is_non_empty_leaf(tree, openvdb::Coord(center.x() - LEAF_DIM, center.y(), center.z()))) {
-      create_quad(corners, vertices_is, quads, resolution, used_verts, QUAD_X_MIN);
-    }
-
-    if (!is_non_empty_leaf(tree, openvdb::Coord(center.x() + LEAF_DIM, center.y(), center.z()))) {
-      create_quad(corners, vertices_is, quads, resolution, used_verts, QUAD_X_MAX);
-    }
-
-    if (!is_non_empty_leaf(tree, openvdb::Coord(center.x(), center.y() - LEAF_DIM, center.z()))) {
-      create_quad(corners, vertices_is, quads, resolution, used_verts, QUAD_Y_MIN);
-    }
-
-    if (!is_non_empty_leaf(tree, openvdb::Coord(center.x(), center.y() + LEAF_DIM, center.z()))) {
-      create_quad(corners, vertices_is, quads, resolution, used_verts, QUAD_Y_MAX);
-    }
-
-    if (!is_non_empty_leaf(tree, openvdb::Coord(center.x(), center.y(), center.z() - LEAF_DIM))) {
-      create_quad(corners, vertices_is, quads, resolution, used_verts, QUAD_Z_MIN);
-    }
-
-    if (!is_non_empty_leaf(tree, openvdb::Coord(center.x(), center.y(), center.z() + LEAF_DIM))) {
-      create_quad(corners, vertices_is, quads, resolution, used_verts, QUAD_Z_MAX);
+    for (int face_index = 0; face_index < 6; face_index++) {
+      if (face_masks[i] & (1 << face_index)) {
+        create_quad(corners, vertices_is, quads, resolution, used_verts, face_index);
+      }
     }
   }
 #else
@@ -384,14 +422,17 @@ void VolumeMeshBuilder::convert_object_space(const vector<int3> &vertices,
   const float3 cell_size = make_float3(1.0f / dim.x(), 1.0f / dim.y(), 1.0f / dim.z());
   const float3 point_offset = cell_size * face_overlap_avoidance;
 
-  out_vertices.reserve(vertices.size());
-
-  for (size_t i = 0; i < vertices.size(); ++i) {
-    openvdb::math::Vec3d p = topology_grid->indexToWorld(
-        openvdb::math::Vec3d(vertices[i].x, vertices[i].y, vertices[i].z));
-    const float3 vertex = make_float3((float)p.x(), (float)p.y(), (float)p.z());
-    out_vertices.push_back(vertex + point_offset);
-  }
+  out_vertices.resize(vertices.size());
+
+  parallel_for(blocked_range<size_t>(0, vertices.size(), 4096),
+               [&](const blocked_range<size_t> &r) {
+                 for (size_t i = r.begin(); i != r.end(); i++) {
+                   openvdb::math::Vec3d p = topology_grid->indexToWorld(
+                       openvdb::math::Vec3d(vertices[i].x, vertices[i].y, vertices[i].z));
+                   const float3 vertex = make_float3((float)p.x(), (float)p.y(), (float)p.z());
+                   out_vertices[i] = vertex + point_offset;
+                 }
+               });
 #else
   (void)vertices;
   (void)out_vertices;
@@ -415,6 +456,97 @@ void VolumeMeshBuilder::convert_quads_to_tris(const vector<QuadData> &quads, vec
   }
 }
 
+void VolumeMeshBuilder::create_occupancy(Volume *volume) const
+{
+#ifdef WITH_OPENVDB
+  /* Only linear grid transforms can be expressed as a kernel side transform. */
+  if (!topology_grid->transform().isLinear()) {
+    return;
+  }
+
+  /* Expand by one voxel so that boundary voxels always have an occupied cell
+   * around them, which absorbs the differences in rounding conventions
+   * between this mapping and the texture samplers. */
+  openvdb::CoordBBox voxel_bbox = topology_grid->evalActiveVoxelBoundingBox();
+  if (voxel_bbox.empty()) {
+    return;
+  }
+  voxel_bbox.expand(1);
+
+  /* Group voxels into cells to keep the grid at a bounded resolution. */
+  const openvdb::Coord dim = voxel_bbox.dim();
+  int cell_shift = 0;
+  while ((max(dim.x(), max(dim.y(), dim.z())) >> cell_shift) > 128) {
+    cell_shift++;
+  }
+
+  const int3 res = make_int3(((dim.x() - 1) >> cell_shift) + 1,
+                             ((dim.y() - 1) >> cell_shift) + 1,
+                             ((dim.z() - 1) >> cell_shift) + 1);
+  const size_t num_cells = (size_t)res.x * (size_t)res.y * (size_t)res.z;
+  vector<uint> bits((num_cells + 31) / 32, 0);
+
+  /* Mark cells overlapping active voxels and tiles, dilated by one voxel to
+   * match the expanded bounds. */
+  const openvdb::MaskGrid::TreeType &tree = topology_grid->tree();
+  for (auto iter = tree.cbeginValueOn(); iter; ++iter) {
+    openvdb::CoordBBox value_bbox;
+    iter.getBoundingBox(value_bbox);
+    value_bbox.expand(1);
+    value_bbox.intersect(voxel_bbox);
+    if (value_bbox.empty()) {
+      continue;
+    }
+
+    const openvdb::Coord cell_min = (value_bbox.min() - voxel_bbox.min()) >> cell_shift;
+    const openvdb::Coord cell_max = (value_bbox.max() - voxel_bbox.min()) >> cell_shift;
+
+    for (int z = cell_min.z(); z <= cell_max.z(); z++) {
+      for (int y = cell_min.y(); y <= cell_max.y(); y++) {
+        for (int x = cell_min.x(); x <= cell_max.x(); x++) {
+          const size_t cell = ((size_t)z * res.y + y) * res.x + x;
+          bits[cell >> 5] |= 1u << (cell & 31);
+        }
+      }
+    }
+  }
+
+  /* Object space to cell coordinates. Voxel centers sit at integer index
+   * coordinates, so offset by half a voxel before quantizing to cells. */
+  const openvdb::Mat4R world_to_index =
+      topology_grid->transform().baseMap()->getAffineMap()->getMat4().inverse();
+
+  /* OpenVDB transforms are applied to row vectors, so take the transpose. */
+  Transform w2i;
+  w2i.x = make_float4((float)world_to_index(0, 0),
+                      (float)world_to_index(1, 0),
+                      (float)world_to_index(2, 0),
+                      (float)world_to_index(3, 0));
+  w2i.y = make_float4((float)world_to_index(0, 1),
+                      (float)world_to_index(1, 1),
+                      (float)world_to_index(2, 1),
+                      (float)world_to_index(3, 1));
+  w2i.z = make_float4((float)world_to_index(0, 2),
+                      (float)world_to_index(1, 2),
+                      (float)world_to_index(2, 2),
+                      (float)world_to_index(3, 2));
+
+  const float inv_cell_dim = 1.0f / (float)(1 << cell_shift);
+  const float3 index_offset = make_float3(0.5f - (float)voxel_bbox.min().x(),
+                                          0.5f - (float)voxel_bbox.min().y(),
+                                          0.5f - (float)voxel_bbox.min().z());
+
+  volume->occupancy_tfm = transform_scale(inv_cell_dim, inv_cell_dim, inv_cell_dim) *
+                          transform_translate(index_offset) * w2i;
+  volume->occupancy_res = res;
+  volume->occupancy_bits = std::move(bits);
+
+  VLOG_WORK << "Volume occupancy grid: " << res.x << "x" << res.y << "x" << res.z;
+#else
+  (void)volume;
+#endif
+}
+
 bool VolumeMeshBuilder::empty_grid() const
 {
 #ifdef WITH_OPENVDB
@@ -750,6 +882,10 @@ void GeometryManager::create_volume_mesh(const Scene *scene, Volume *volume, Pro
     volume->add_triangle(indices[i], indices[i + 1], indices[i + 2], 0, false);
   }
 
+  /* Build the occupancy grid for empty space skipping from the same topology
+   * that bounds the mesh. */
+  builder.create_occupancy(volume);
+
   /* Print stats. */
   VLOG_WORK << "Memory usage volume mesh: "
             << (vertices.size() * sizeof(float3) + indices.size() * sizeof(int)) /
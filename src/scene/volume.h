@@ -22,6 +22,14 @@ class Volume : public Mesh {
   NODE_SOCKET_API(float, velocity_scale)
 
   void clear(bool preserve_shaders = false) override;
+
+  /* Coarse occupancy grid over the active voxels, built along with the mesh
+   * in create_volume_mesh and used by the kernel to skip volume shader
+   * evaluation in empty regions. Empty when no grid could be built. */
+  vector<uint> occupancy_bits;
+  int3 occupancy_res = make_int3(0);
+  /* Transform from object space to occupancy cell coordinates. */
+  Transform occupancy_tfm = transform_identity();
 };
 
 }
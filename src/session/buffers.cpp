@@ -7,6 +7,11 @@
 #include "device/device.h"
 #include "session/buffers.h"
 
+#include "util/algorithm.h"
+#include "util/half.h"
+#include "util/log.h"
+#include "util/tbb.h"
+
 namespace ccl {
 
 /* --------------------------------------------------------------------
@@ -44,6 +49,7 @@ NODE_DEFINE(BufferPass)
   SOCKET_ENUM(mode, "Mode", *pass_mode_enum, static_cast<int>(PassMode::DENOISED));
   SOCKET_STRING(name, "Name", string());
   SOCKET_BOOLEAN(include_albedo, "Include Albedo", false);
+  SOCKET_BOOLEAN(accumulate_half, "Accumulate Half", false);
   SOCKET_STRING(lightgroup, "Light Group", string());
 
   SOCKET_INT(offset, "Offset", -1);
@@ -59,6 +65,7 @@ BufferPass::BufferPass(const Pass *scene_pass)
       mode(scene_pass->get_mode()),
       name(scene_pass->get_name()),
       include_albedo(scene_pass->get_include_albedo()),
+      accumulate_half(scene_pass->get_accumulate_half()),
       lightgroup(scene_pass->get_lightgroup())
 {
 }
@@ -124,7 +131,7 @@ void BufferParams::update_passes()
         pass_offset_[index] = pass_stride;
       }
 
-      pass_stride += pass.get_info().num_components;
+      pass_stride += pass_num_buffer_components(pass.get_info(), pass.accumulate_half);
     }
   }
 }
@@ -139,7 +146,8 @@ void BufferParams::update_passes(const unique_ptr_vector<Pass> &scene_passes)
 
     if (scene_pass->is_written()) {
       buffer_pass.offset = pass_stride;
-      pass_stride += scene_pass->get_info().num_components;
+      pass_stride += pass_num_buffer_components(scene_pass->get_info(),
+                                                scene_pass->get_accumulate_half());
     }
     else {
       buffer_pass.offset = PASS_UNUSED;
@@ -271,13 +279,33 @@ void RenderBuffers::reset(const BufferParams &params_)
 
   params = params_;
 
-  /* re-allocate buffer */
+  /* Re-allocate the buffer. When the size is unchanged (for example, a re-render at the same
+   * resolution and passes but a different number of samples) both the host and the device
+   * allocations are re-used as-is: `device_vector::alloc()` only frees memory when the size
+   * actually changes. */
+  const size_t new_size = static_cast<size_t>(params.width) * params.pass_stride * params.height;
+  if (buffer.size() != new_size) {
+    VLOG_WORK << "Re-allocating render buffer for " << params.width << "x" << params.height
+              << " pixels with pass stride " << params.pass_stride << ".";
+
+    /* Freshly allocated device memory has undefined content. */
+    is_zeroed_ = false;
+  }
+
   buffer.alloc(params.width * params.pass_stride, params.height);
 }
 
 void RenderBuffers::zero()
 {
+  /* Nothing was written into the buffer since the last clear: this happens when resets follow
+   * each other faster than a single sample gets rendered (interactive navigation, for example),
+   * and the clear of the full buffer can be skipped entirely. */
+  if (is_zeroed_) {
+    return;
+  }
+
   buffer.zero_to_device();
+  is_zeroed_ = true;
 }
 
 bool RenderBuffers::copy_from_device()
@@ -296,6 +324,174 @@ bool RenderBuffers::copy_from_device()
 void RenderBuffers::copy_to_device()
 {
   buffer.copy_to_device();
+  is_zeroed_ = false;
+}
+
+void RenderBuffers::tag_device_modified()
+{
+  is_zeroed_ = false;
+}
+
+bool RenderBuffers::is_device_zeroed() const
+{
+  return is_zeroed_;
+}
+
+void RenderBuffers::tag_device_zeroed()
+{
+  is_zeroed_ = true;
+}
+
+struct CryptomatteSlot {
+  float id;
+  float weight;
+};
+
+bool render_buffers_host_merge(RenderBuffers *dst, const RenderBuffers *src)
+{
+  const BufferParams &params = dst->params;
+
+  if (params.modified(src->params)) {
+    LOG(ERROR) << "Render buffer merge requires matching buffer parameters.";
+    return false;
+  }
+
+  /* Build the list of merge operations per pass. */
+  enum MergeOp { MERGE_ADD, MERGE_ADD_HALF, MERGE_CRYPTOMATTE };
+
+  struct PassMerge {
+    MergeOp op;
+    int offset;
+    /* Buffer components for add operations, id/weight slots for cryptomatte. */
+    int num;
+  };
+
+  vector<PassMerge> merges;
+  int num_crypto_slots = 0;
+
+  for (const BufferPass &pass : params.passes) {
+    if (pass.offset == PASS_UNUSED) {
+      continue;
+    }
+    /* Denoised passes can not be summed, denoising runs on the merged result. */
+    if (pass.mode == PassMode::DENOISED) {
+      continue;
+    }
+    /* Written on the first sample only, identical on every worker. */
+    if (pass.type == PASS_DEPTH || pass.type == PASS_OBJECT_ID || pass.type == PASS_MATERIAL_ID ||
+        pass.type == PASS_POSITION)
+    {
+      continue;
+    }
+
+    const PassInfo info = pass.get_info();
+
+    if (pass.type == PASS_CRYPTOMATTE) {
+      /* Each cryptomatte pass holds two id/weight slots of the combined per-pixel slot list. */
+      merges.push_back({MERGE_CRYPTOMATTE, pass.offset, 2});
+      num_crypto_slots += 2;
+    }
+    else if (pass.accumulate_half && info.support_half_accumulation) {
+      merges.push_back({MERGE_ADD_HALF, pass.offset, (info.num_components + 1) / 2});
+    }
+    else {
+      merges.push_back({MERGE_ADD, pass.offset, info.num_components});
+    }
+  }
+
+  const int64_t num_pixels = static_cast<int64_t>(params.width) * params.height;
+  const int64_t pass_stride = params.pass_stride;
+
+  const float *src_buffer = src->buffer.data();
+  float *dst_buffer = dst->buffer.data();
+
+  parallel_for(
+      blocked_range<int64_t>(0, num_pixels, 1024), [&](const blocked_range<int64_t> &range) {
+        /* Combined cryptomatte slots of both buffers, reused across pixels. */
+        vector<CryptomatteSlot> crypto(num_crypto_slots * 2);
+
+        for (int64_t i = range.begin(); i != range.end(); i++) {
+          float *dst_pixel = dst_buffer + i * pass_stride;
+          const float *src_pixel = src_buffer + i * pass_stride;
+
+          int num_crypto = 0;
+
+          for (const PassMerge &merge : merges) {
+            switch (merge.op) {
+              case MERGE_ADD:
+                for (int c = 0; c < merge.num; c++) {
+                  dst_pixel[merge.offset + c] += src_pixel[merge.offset + c];
+                }
+                break;
+              case MERGE_ADD_HALF:
+                for (int c = 0; c < merge.num; c++) {
+                  const uint dst_bits = __float_as_uint(dst_pixel[merge.offset + c]);
+                  const uint src_bits = __float_as_uint(src_pixel[merge.offset + c]);
+                  const uint new_bits = half_float_to_bits(half_bits_to_float(dst_bits & 0xffff) +
+                                                           half_bits_to_float(src_bits & 0xffff)) |
+                                        (half_float_to_bits(half_bits_to_float(dst_bits >> 16) +
+                                                            half_bits_to_float(src_bits >> 16))
+                                         << 16);
+                  dst_pixel[merge.offset + c] = __uint_as_float(new_bits);
+                }
+                break;
+              case MERGE_CRYPTOMATTE:
+                /* Gather the slots of both buffers, combining weights of matching ids. */
+                for (int slot = 0; slot < merge.num; slot++) {
+                  for (const float *pixel : {(const float *)dst_pixel, src_pixel}) {
+                    const float id = pixel[merge.offset + slot * 2];
+                    const float weight = pixel[merge.offset + slot * 2 + 1];
+                    if (id == ID_NONE || weight == 0.0f) {
+                      continue;
+                    }
+                    int c = 0;
+                    for (; c < num_crypto; c++) {
+                      if (crypto[c].id == id) {
+                        crypto[c].weight += weight;
+                        break;
+                      }
+                    }
+                    if (c == num_crypto) {
+                      crypto[num_crypto++] = {id, weight};
+                    }
+                  }
+                }
+                break;
+            }
+          }
+
+          if (num_crypto_slots == 0) {
+            continue;
+          }
+
+          /* Sort combined slots by weight and write the heaviest back into the
+           * cryptomatte passes, matching the order of film_cryptomatte_post. */
+          sort(crypto.begin(),
+               crypto.begin() + num_crypto,
+               [](const CryptomatteSlot &a, const CryptomatteSlot &b) {
+                 return a.weight > b.weight;
+               });
+
+          int slot = 0;
+          for (const PassMerge &merge : merges) {
+            if (merge.op != MERGE_CRYPTOMATTE) {
+              continue;
+            }
+            for (int c = 0; c < merge.num; c++, slot++) {
+              if (slot < num_crypto) {
+                dst_pixel[merge.offset + c * 2] = crypto[slot].id;
+                dst_pixel[merge.offset + c * 2 + 1] = crypto[slot].weight;
+              }
+              else {
+                dst_pixel[merge.offset + c * 2] = ID_NONE;
+                dst_pixel[merge.offset + c * 2 + 1] = 0.0f;
+              }
+            }
+          }
+        }
+      });
+
+  return true;
 }
 
 void render_buffers_host_copy_denoised(RenderBuffers *dst,
@@ -29,6 +29,7 @@ class BufferPass : public Node {
   PassMode mode = PassMode::NOISY;
   string name;
   bool include_albedo = false;
+  bool accumulate_half = false;
   string lightgroup;
 
   int offset = -1;
@@ -49,8 +50,8 @@ class BufferPass : public Node {
   bool operator==(const BufferPass &other) const
   {
     return type == other.type && mode == other.mode && name == other.name &&
-           include_albedo == other.include_albedo && lightgroup == other.lightgroup &&
-           offset == other.offset;
+           include_albedo == other.include_albedo && accumulate_half == other.accumulate_half &&
+           lightgroup == other.lightgroup && offset == other.offset;
   }
   bool operator!=(const BufferPass &other) const
   {
@@ -165,6 +166,21 @@ class RenderBuffers {
 
   bool copy_from_device();
   void copy_to_device();
+
+  /* Tag the device-side buffer content as modified, so that the next zero() actually clears it.
+   * Called by the path trace works when samples are accumulated into the buffer. */
+  void tag_device_modified();
+
+  /* Whether the device-side buffer is known to contain only zeros already. Allows works which
+   * clear the buffer through their own device queue to skip the clear, see zero(). */
+  bool is_device_zeroed() const;
+  void tag_device_zeroed();
+
+ protected:
+  /* Whether the device-side buffer is known to contain only zeros, allowing zero() to skip the
+   * device memset. Interactive resets can arrive faster than samples are rendered, and clearing
+   * a buffer with many passes at full resolution on every such reset is measurable. */
+  bool is_zeroed_ = false;
 };
 
 /* Copy denoised passes form source to destination.
@@ -176,6 +192,21 @@ class RenderBuffers {
  * buffer is to be copied.
  *
  * Copy happens of the number of pixels in the destination. */
+/* Merge the host-side accumulation of a partial render into the destination buffer.
+ *
+ * Both buffers must have identical parameters and have been rendered with disjoint sample ranges
+ * of the same scene (see the sample subset options of the render scheduler). This is the merge
+ * step for distributing a single frame across multiple machines: each worker renders its sample
+ * range and the unnormalized buffers are summed afterwards.
+ *
+ * Accumulating passes are summed, sample-0 overwrite passes (depth, object and material id,
+ * position) are identical on every worker and kept from the destination, cryptomatte id/weight
+ * slot lists are combined and re-sorted, and half-packed passes are widened, summed and repacked.
+ * Denoised passes are skipped, denoising is expected to run on the merged result.
+ *
+ * Returns false when the buffer parameters do not match. */
+bool render_buffers_host_merge(RenderBuffers *dst, const RenderBuffers *src);
+
 void render_buffers_host_copy_denoised(RenderBuffers *dst,
                                        const BufferParams &dst_params,
                                        const RenderBuffers *src,
@@ -10,6 +10,7 @@
 #include "pl/type_desc.h"
 #include "util/array.h"
 #include "util/map.h"
+#include "util/tbb.h"
 #include "util/time.h"
 #include "util/unique_ptr.h"
 
@@ -399,7 +400,9 @@ static bool merge_pixels(const vector<MergeImage> &images,
 
   for (const MergeImage &image : images) {
     /* Read all channels into buffer. Reading all channels at once is
-     * faster than individually due to interleaved EXR channel storage. */
+     * faster than individually due to interleaved EXR channel storage.
+     * Images are read one after the other, to keep reads sequential in
+     * file order. */
     array<float> pixels;
     alloc_pixels(image.in->spec(), pixels);
     const int num_channels = image.in->spec().nchannels;
@@ -408,63 +411,72 @@ static bool merge_pixels(const vector<MergeImage> &images,
       return false;
     }
 
-    for (const MergeImageLayer &layer : image.layers) {
-      const size_t stride = image.in->spec().nchannels;
-      const size_t out_stride = out_spec.nchannels;
-      const size_t num_pixels = pixels.size();
-
-      for (const MergeImagePass &pass : layer.passes) {
-        size_t offset = pass.offset;
-        size_t out_offset = pass.merge_offset;
-
-        switch (pass.op) {
-          case MERGE_CHANNEL_NOP:
-            break;
-          case MERGE_CHANNEL_COPY:
-            for (; offset < num_pixels; offset += stride, out_offset += out_stride) {
-              out_pixels[out_offset] = pixels[offset];
-            }
-            break;
-          case MERGE_CHANNEL_SUM:
-            for (; offset < num_pixels; offset += stride, out_offset += out_stride) {
-              out_pixels[out_offset] += pixels[offset];
-            }
-            break;
-          case MERGE_CHANNEL_AVERAGE: {
-            /* Weights based on sample count passes and sample metadata. Per channel since not
-             * all files are guaranteed to have the same channels. */
-            size_t sample_pass_offset = layer.sample_pass_offset;
-            const auto &samples = layer_samples.at(layer.name);
-
-            for (size_t i = 0; offset < num_pixels;
-                 offset += stride, sample_pass_offset += stride, out_offset += out_stride, i++)
-            {
-              const float total_samples = samples.per_pixel[i];
-
-              float layer_samples;
-              if (layer.has_sample_pass) {
-                layer_samples = pixels[sample_pass_offset] * layer.samples;
-              }
-              else {
-                layer_samples = layer.samples;
+    const size_t stride = image.in->spec().nchannels;
+    const size_t out_stride = out_spec.nchannels;
+    const size_t num_pixels = pixels.size() / stride;
+
+    /* Merge all passes in parallel over pixel ranges: every range only
+     * touches its own slice of the preallocated output planes, so the
+     * merge loops do not race with each other. */
+    parallel_for(
+        blocked_range<size_t>(0, num_pixels, 64 * 1024), [&](const blocked_range<size_t> &range) {
+          for (const MergeImageLayer &layer : image.layers) {
+            for (const MergeImagePass &pass : layer.passes) {
+              size_t offset = pass.offset + range.begin() * stride;
+              size_t out_offset = pass.merge_offset + range.begin() * out_stride;
+              const size_t offset_end = pass.offset + range.end() * stride;
+
+              switch (pass.op) {
+                case MERGE_CHANNEL_NOP:
+                  break;
+                case MERGE_CHANNEL_COPY:
+                  for (; offset < offset_end; offset += stride, out_offset += out_stride) {
+                    out_pixels[out_offset] = pixels[offset];
+                  }
+                  break;
+                case MERGE_CHANNEL_SUM:
+                  for (; offset < offset_end; offset += stride, out_offset += out_stride) {
+                    out_pixels[out_offset] += pixels[offset];
+                  }
+                  break;
+                case MERGE_CHANNEL_AVERAGE: {
+                  /* Weights based on sample count passes and sample metadata. Per channel since
+                   * not all files are guaranteed to have the same channels. */
+                  size_t sample_pass_offset = layer.sample_pass_offset + range.begin() * stride;
+                  const auto &samples = layer_samples.at(layer.name);
+
+                  for (size_t i = range.begin(); offset < offset_end;
+                       offset += stride, sample_pass_offset += stride, out_offset += out_stride,
+                              i++)
+                  {
+                    const float total_samples = samples.per_pixel[i];
+
+                    float layer_samples;
+                    if (layer.has_sample_pass) {
+                      layer_samples = pixels[sample_pass_offset] * layer.samples;
+                    }
+                    else {
+                      layer_samples = layer.samples;
+                    }
+
+                    out_pixels[out_offset] += pixels[offset] *
+                                              (1.0f * layer_samples / total_samples);
+                  }
+                  break;
+                }
+                case MERGE_CHANNEL_SAMPLES: {
+                  const auto &samples = layer_samples.at(layer.name);
+                  for (size_t i = range.begin(); offset < offset_end;
+                       offset += stride, out_offset += out_stride, i++)
+                  {
+                    out_pixels[out_offset] = 1.0f * samples.per_pixel[i] / samples.total;
+                  }
+                  break;
+                }
               }
-
-              out_pixels[out_offset] += pixels[offset] * (1.0f * layer_samples / total_samples);
-            }
-            break;
-          }
-          case MERGE_CHANNEL_SAMPLES: {
-            const auto &samples = layer_samples.at(layer.name);
-            for (size_t i = 0; offset < num_pixels;
-                 offset += stride, out_offset += out_stride, i++)
-            {
-              out_pixels[out_offset] = 1.0f * samples.per_pixel[i] / samples.total;
             }
-            break;
           }
-        }
-      }
-    }
+        });
   }
 
   return true;
@@ -553,15 +565,22 @@ static void read_layer_samples(vector<MergeImage> &images,
                              TypeDesc::FLOAT,
                              (void *)sample_count_buffer.data());
 
-        for (size_t i = 0; i < current_layer_samples.per_pixel.size(); i++) {
-          current_layer_samples.per_pixel[i] += sample_count_buffer[i] * layer.samples;
-        }
+        parallel_for(blocked_range<size_t>(0, current_layer_samples.per_pixel.size(), 256 * 1024),
+                     [&](const blocked_range<size_t> &range) {
+                       for (size_t i = range.begin(); i != range.end(); i++) {
+                         current_layer_samples.per_pixel[i] += sample_count_buffer[i] *
+                                                               layer.samples;
+                       }
+                     });
       }
       else {
         /* Use sample count from metadata if there's no "Debug Sample Count" pass. */
-        for (size_t i = 0; i < current_layer_samples.per_pixel.size(); i++) {
-          current_layer_samples.per_pixel[i] += layer.samples;
-        }
+        parallel_for(blocked_range<size_t>(0, current_layer_samples.per_pixel.size(), 256 * 1024),
+                     [&](const blocked_range<size_t> &range) {
+                       for (size_t i = range.begin(); i != range.end(); i++) {
+                         current_layer_samples.per_pixel[i] += layer.samples;
+                       }
+                     });
       }
 
       current_layer_samples.total += layer.samples;
@@ -22,6 +22,8 @@
 
 #include "util/log.h"
 #include "util/math.h"
+#include "util/path.h"
+#include "util/profiling.h"
 #include "util/task.h"
 #include "util/time.h"
 
@@ -218,6 +220,8 @@ void Session::run_main_render_loop()
         progress.set_error(device->error_message());
         break;
       }
+
+      maybe_write_checkpoint(render_work);
     }
 
     progress.set_update();
@@ -267,8 +271,18 @@ void Session::thread_run()
 
 void Session::thread_render()
 {
-  if (params.use_profiling && (params.device.type == DEVICE_CPU)) {
-    profiler.start();
+  if (params.use_profiling) {
+    if (params.device.type == DEVICE_CPU) {
+      profiler.start();
+    }
+    else {
+      /* GPU devices record per-kernel execution times with timestamp events on their queues. */
+      path_trace_->set_kernel_timing_enabled(true);
+    }
+  }
+  else if (Trace::enabled() && params.device.type != DEVICE_CPU) {
+    /* Trace recording places the per-kernel timings on the queue tracks. */
+    path_trace_->set_kernel_timing_enabled(true);
   }
 
   /* session thread loop */
@@ -303,6 +317,8 @@ RenderWork Session::run_update_for_next_iteration()
 {
   RenderWork render_work;
 
+  const scoped_trace trace("run_update_for_next_iteration");
+
   thread_scoped_lock scene_lock(scene->mutex);
 
   bool have_tiles = true;
@@ -353,7 +369,10 @@ RenderWork Session::run_update_for_next_iteration()
 
   /* Update path guiding. */
   {
-    const GuidingParams guiding_params = scene->integrator->get_guiding_params(device.get());
+    GuidingParams guiding_params = scene->integrator->get_guiding_params(device.get());
+    if (guiding_params.use) {
+      guiding_params.field_cache_path = scene->guiding_field_cache_path(guiding_params.type);
+    }
     const bool guiding_reset = (guiding_params.use) ? scene->need_reset(false) : false;
     path_trace_->set_guiding_params(guiding_params, guiding_reset);
   }
@@ -410,14 +429,17 @@ RenderWork Session::run_update_for_next_iteration()
     const int height = max(1, buffer_params_.full_height / resolution);
 
     {
-      /* Load render kernels, before device update where we upload data to the GPU.
-       * Do it outside of the scene mutex since the heavy part of the loading (i.e. kernel
-       * compilation) does not depend on the scene and some other functionality (like display
+      /* Start loading render kernels before the device update, so that on a cold start the
+       * kernel compilation overlaps with the scene managers instead of serializing in front
+       * of them. The device update only needs the kernel feature flags, which are computed
+       * synchronously before the compilation is kicked off.
+       *
+       * Do it outside of the scene mutex since some other functionality (like display
        * driver) might be waiting on the scene mutex to synchronize display pass.
        *
        * The scene will lock itself for the short period if it needs to update kernel features. */
       scene_lock.unlock();
-      scene->load_kernels(progress);
+      scene->load_kernels_async(progress);
       scene_lock.lock();
     }
 
@@ -429,6 +451,9 @@ RenderWork Session::run_update_for_next_iteration()
      * graphics interop, which can deadlock when the scene mutex is still being held. */
     scene_lock.unlock();
 
+    /* Join the background kernel compilation before anything renders with the kernels. */
+    scene->wait_load_kernels(progress);
+
     path_trace_->load_kernels();
     path_trace_->alloc_work_memory();
 
@@ -539,7 +564,9 @@ void Session::do_delayed_reset()
   buffer_params_.use_transparent_background = scene->background->get_transparent();
 
   /* Tile and work scheduling. */
+  tile_manager_.set_tile_order(params.tile_order);
   tile_manager_.reset_scheduling(buffer_params_, get_effective_tile_size());
+  path_trace_->set_tile_order(params.tile_order);
   render_scheduler_.set_sample_params(params.samples,
                                       params.use_sample_subset,
                                       params.sample_subset_offset,
@@ -574,6 +601,100 @@ void Session::do_delayed_reset()
   const double time_limit = params.time_limit * ((double)tile_manager_.get_num_tiles());
   progress.set_render_start_time();
   progress.set_time_limit(time_limit);
+
+  /* Checkpointing. */
+  last_checkpoint_time_ = time_dt();
+  load_checkpoint();
+}
+
+void Session::load_checkpoint()
+{
+  if (params.checkpoint_path.empty() || !params.resume_from_checkpoint) {
+    return;
+  }
+
+  /* Only attempt the resume once, an explicit reset later in the session renders from scratch. */
+  if (checkpoint_resume_attempted_) {
+    return;
+  }
+  checkpoint_resume_attempted_ = true;
+
+  if (tile_manager_.has_multiple_tiles()) {
+    LOG(WARNING) << "Resume from checkpoint is not supported with tiled rendering.";
+    return;
+  }
+
+  if (!path_exists(params.checkpoint_path)) {
+    VLOG_INFO << "No checkpoint file at " << params.checkpoint_path
+              << ", rendering from the first sample.";
+    return;
+  }
+
+  unique_ptr<RenderBuffers> buffers = make_unique<RenderBuffers>(device.get());
+  int num_samples = 0;
+  if (!tile_manager_.read_checkpoint(params.checkpoint_path, buffers.get(), &num_samples)) {
+    LOG(ERROR) << "Failed to read checkpoint " << params.checkpoint_path
+               << ", rendering from the first sample.";
+    return;
+  }
+
+  if (num_samples <= 0) {
+    return;
+  }
+
+  /* The checkpoint is only valid for the same render configuration. */
+  if (buffers->params.width != buffer_params_.width ||
+      buffers->params.height != buffer_params_.height ||
+      buffers->params.pass_stride != buffer_params_.pass_stride)
+  {
+    LOG(WARNING) << "Checkpoint " << params.checkpoint_path
+                 << " does not match the render configuration, rendering from the first sample.";
+    return;
+  }
+
+  render_scheduler_.set_num_rendered_samples(min(num_samples, params.samples));
+  path_trace_->set_restore_buffers(std::move(buffers));
+
+  progress.set_status("Resuming render from checkpoint at sample " + to_string(num_samples));
+  VLOG_INFO << "Resuming render from " << params.checkpoint_path << " at sample " << num_samples
+            << ".";
+}
+
+void Session::maybe_write_checkpoint(const RenderWork &render_work)
+{
+  if (params.checkpoint_path.empty()) {
+    return;
+  }
+
+  /* Only checkpoint final-resolution sampling work of a single big tile: tiled renders already
+   * stream their results to disk via the tile manager. */
+  if (!render_work.path_trace.num_samples || render_work.resolution_divider != 1) {
+    return;
+  }
+  if (tile_manager_.has_multiple_tiles()) {
+    return;
+  }
+
+  if (time_dt() - last_checkpoint_time_ < params.checkpoint_interval) {
+    return;
+  }
+
+  const double time_start = time_dt();
+
+  RenderBuffers buffers(device.get());
+  buffers.reset(path_trace_->get_render_tile_params());
+  path_trace_->copy_to_render_buffers(&buffers);
+
+  const int num_samples = render_scheduler_.get_num_rendered_samples();
+  if (!tile_manager_.write_checkpoint(params.checkpoint_path, buffers, num_samples)) {
+    LOG(ERROR) << "Failed to write checkpoint " << params.checkpoint_path;
+    return;
+  }
+
+  last_checkpoint_time_ = time_dt();
+
+  VLOG_WORK << "Checkpoint at sample " << num_samples << " written in "
+            << last_checkpoint_time_ - time_start << " seconds.";
 }
 
 void Session::reset(const SessionParams &session_params, const BufferParams &buffer_params)
@@ -698,7 +819,15 @@ bool Session::update_scene(const int width, const int height)
   Camera *cam = scene->camera;
   cam->set_screen_size(width, height);
 
-  return scene->update(progress);
+  if (scene->update(progress)) {
+    return true;
+  }
+
+  /* Nothing in the scene was modified: the device-side data from the previous render is re-used
+   * as-is. This is the expected path when a reset only changed the number of samples. */
+  VLOG_WORK << "Scene is unchanged, re-using device data.";
+
+  return false;
 }
 
 static string status_append(const string &status, const string &suffix)
@@ -712,6 +841,17 @@ static string status_append(const string &status, const string &suffix)
 
 void Session::update_status_time(bool show_pause, bool show_done)
 {
+  if (show_done) {
+    /* Save end time so that further calls to get_time are accurate. */
+    progress.set_end_time();
+  }
+
+  /* The status strings are only ever consumed through the progress update callback, so skip
+   * formatting them entirely when no consumer is attached (benchmark harnesses, for example). */
+  if (!progress.has_update_callback()) {
+    return;
+  }
+
   string status;
   string substatus;
 
@@ -721,6 +861,32 @@ void Session::update_status_time(bool show_pause, bool show_done)
   const int current_sample = progress.get_current_sample();
   const int num_samples = render_scheduler_.get_num_samples();
 
+  /* Any device-specific status (such as background kernel optimization). */
+  string device_status;
+  if (!device->is_ready(device_status)) {
+    device_status.clear();
+  }
+
+  /* Only re-format the status strings when the values they are built from have changed since the
+   * previous call (or when someone else updated the status in between), rather than rebuilding an
+   * identical string for every batch of samples. */
+  if (current_tile == last_status_.current_tile && num_tiles == last_status_.num_tiles &&
+      current_sample == last_status_.current_sample && num_samples == last_status_.num_samples &&
+      show_pause == last_status_.show_pause && show_done == last_status_.show_done &&
+      device_status == last_status_.device_status &&
+      progress.get_status_generation() == last_status_.status_generation)
+  {
+    return;
+  }
+
+  last_status_.current_tile = current_tile;
+  last_status_.num_tiles = num_tiles;
+  last_status_.current_sample = current_sample;
+  last_status_.num_samples = num_samples;
+  last_status_.show_pause = show_pause;
+  last_status_.show_done = show_done;
+  last_status_.device_status = device_status;
+
   /* TIle. */
   if (tile_manager_.has_multiple_tiles()) {
     substatus = status_append(substatus,
@@ -736,9 +902,7 @@ void Session::update_status_time(bool show_pause, bool show_done)
                               string_printf("Sample %d/%d", current_sample, num_samples));
   }
 
-  /* Append any device-specific status (such as background kernel optimization) */
-  string device_status;
-  if (device->is_ready(device_status) && !device_status.empty()) {
+  if (!device_status.empty()) {
     substatus += string_printf(" (%s)", device_status.c_str());
   }
 
@@ -749,7 +913,6 @@ void Session::update_status_time(bool show_pause, bool show_done)
   }
   else if (show_done) {
     status = "Rendering Done";
-    progress.set_end_time(); /* Save end time so that further calls to get_time are accurate. */
   }
   else {
     status = substatus;
@@ -757,6 +920,7 @@ void Session::update_status_time(bool show_pause, bool show_done)
   }
 
   progress.set_status(status, substatus);
+  last_status_.status_generation = progress.get_status_generation();
 }
 
 void Session::device_free()
@@ -765,12 +929,101 @@ void Session::device_free()
   path_trace_->device_free();
 }
 
+void Session::set_memory_watermark(const size_t threshold_bytes,
+                                   std::function<void(size_t)> callback)
+{
+  stats.set_mem_watermark(threshold_bytes, std::move(callback));
+}
+
 void Session::collect_statistics(RenderStats *render_stats)
 {
   scene->collect_statistics(render_stats);
+  for (const pair<string, size_t> &entry : stats.mem_snapshot()) {
+    render_stats->device_memory.add_entry(NamedSizeEntry(entry.first, entry.second));
+  }
   if (params.use_profiling && (params.device.type == DEVICE_CPU)) {
     render_stats->collect_profiling(scene.get(), profiler);
   }
+  else if (params.use_profiling) {
+    map<DeviceKernel, double> kernel_times;
+    path_trace_->collect_kernel_times(kernel_times);
+    if (!kernel_times.empty()) {
+      render_stats->collect_kernel_times(kernel_times);
+    }
+  }
+}
+
+static string stats_json_escape(const string &str)
+{
+  string escaped;
+  escaped.reserve(str.size());
+  for (const char ch : str) {
+    if (ch == '"' || ch == '\\') {
+      escaped += '\\';
+    }
+    escaped += ch;
+  }
+  return escaped;
+}
+
+string Session::get_stats_json()
+{
+  double total_time;
+  double render_time;
+  progress.get_time(total_time, render_time);
+
+  const uint64_t pixel_samples = progress.get_pixel_samples();
+  const double samples_per_sec = (render_time > 0.0) ? (double)pixel_samples / render_time : 0.0;
+
+  string json = "{";
+
+  json += string_printf("\"progress\":%.4f,", progress.get_progress());
+  json += string_printf("\"sample\":%d,", progress.get_current_sample());
+  json += string_printf("\"num_samples\":%d,", render_scheduler_.get_num_samples());
+  json += string_printf("\"pixel_samples\":%llu,", (unsigned long long)pixel_samples);
+  json += string_printf("\"samples_per_sec\":%.1f,", samples_per_sec);
+  json += string_printf("\"total_time\":%.3f,", total_time);
+  json += string_printf("\"render_time\":%.3f,", render_time);
+
+  /* Per-device occupancy of the most recent work. */
+  vector<pair<string, float>> occupancy;
+  path_trace_->collect_work_occupancy(occupancy);
+  json += "\"devices\":[";
+  for (size_t i = 0; i < occupancy.size(); i++) {
+    json += string_printf("%s{\"name\":\"%s\",\"occupancy\":%.3f}",
+                          (i == 0) ? "" : ",",
+                          stats_json_escape(occupancy[i].first).c_str(),
+                          (double)occupancy[i].second);
+  }
+  json += "],";
+
+  /* Memory counters are atomics and the named snapshot is guarded internally. */
+  json += string_printf("\"memory\":{\"used\":%llu,\"peak\":%llu",
+                        (unsigned long long)stats.mem_used,
+                        (unsigned long long)stats.mem_peak);
+  for (const pair<string, size_t> &entry : stats.mem_snapshot()) {
+    json += string_printf(",\"%s\":%llu",
+                          stats_json_escape(entry.first).c_str(),
+                          (unsigned long long)entry.second);
+  }
+  json += "},";
+
+  double path_trace_time;
+  double denoise_time;
+  double display_update_time;
+  double rebalance_time;
+  render_scheduler_.get_phase_times(
+      path_trace_time, denoise_time, display_update_time, rebalance_time);
+  json += string_printf("\"phases\":{\"path_trace\":%.3f,\"denoise\":%.3f,"
+                        "\"display_update\":%.3f,\"rebalance\":%.3f}",
+                        path_trace_time,
+                        denoise_time,
+                        display_update_time,
+                        rebalance_time);
+
+  json += "}";
+
+  return json;
 }
 
 /* --------------------------------------------------------------------
@@ -61,6 +61,9 @@ class SessionParams {
   bool use_auto_tile;
   int tile_size;
 
+  /* Traversal order of big tiles and of GPU work tiles within them. */
+  TileOrder tile_order;
+
   bool use_resolution_divider;
 
   ShadingSystem shadingsystem;
@@ -68,6 +71,17 @@ class SessionParams {
   /* Session-specific temporary directory to store in-progress EXR files in. */
   string temp_dir;
 
+  /* When non-empty, periodically write a checkpoint of the render state to
+   * this path, so that an interrupted background render can be resumed. */
+  string checkpoint_path;
+
+  /* Minimum time between two checkpoint writes, in seconds. */
+  double checkpoint_interval;
+
+  /* Resume from an existing checkpoint file instead of starting from sample
+   * zero. */
+  bool resume_from_checkpoint;
+
   SessionParams()
   {
     headless = false;
@@ -86,10 +100,14 @@ class SessionParams {
 
     use_auto_tile = true;
     tile_size = 2048;
+    tile_order = TileOrder::SCANLINE;
 
     use_resolution_divider = true;
 
     shadingsystem = SHADINGSYSTEM_SVM;
+
+    checkpoint_interval = 60.0;
+    resume_from_checkpoint = false;
   }
 
   bool modified(const SessionParams &params) const
@@ -100,7 +118,8 @@ class SessionParams {
              background == params.background && experimental == params.experimental &&
              pixel_size == params.pixel_size && threads == params.threads &&
              use_profiling == params.use_profiling && shadingsystem == params.shadingsystem &&
-             use_auto_tile == params.use_auto_tile && tile_size == params.tile_size);
+             use_auto_tile == params.use_auto_tile && tile_size == params.tile_size &&
+             tile_order == params.tile_order);
   }
 };
 
@@ -138,6 +157,23 @@ class Session {
   void wait();
 
   bool ready_to_reset();
+
+  /* Restart rendering with the given parameters, re-using the session as much as possible.
+   *
+   * This is the intended way to render the same scene repeatedly at different sample counts or
+   * resolutions (for example, from a benchmark harness): re-creating the session pays the full
+   * device initialization, kernel load and scene sync again, while a reset guarantees:
+   *
+   *  - The device, loaded kernels, and device-side scene data are all kept. Geometry and shader
+   *    sync only runs for scene nodes which were actually modified; a reset which only changes
+   *    the number of samples performs no scene sync at all, and a resolution change only
+   *    re-syncs the camera (unless adaptive subdivision ties geometry to the camera).
+   *  - Render buffers keep their host and device allocations whenever the buffer size is
+   *    unchanged, and are merely zeroed for the new render. They are only re-allocated when the
+   *    resolution or pass layout changes.
+   *
+   * Parameter changes covered by `SessionParams::modified()` can not be applied to an existing
+   * session and require re-creating it. */
   void reset(const SessionParams &session_params, const BufferParams &buffer_params);
 
   void set_pause(bool pause);
@@ -158,6 +194,19 @@ class Session {
 
   void collect_statistics(RenderStats *stats);
 
+  /* Machine-readable snapshot of the live render state: samples, throughput, per-device
+   * occupancy, memory use and per-phase timings as a JSON object. Cheap enough to poll at
+   * 1Hz from a monitoring thread without perturbing the render. */
+  string get_stats_json();
+
+  /* Install a callback invoked the first time device memory usage crosses the given threshold
+   * in bytes, so an application can react (lower resolution, flush caches, abort cleanly)
+   * before an allocation failure kills a long render. The callback runs on the allocating
+   * thread and must not call back into the session. Before the GPU path state is allocated,
+   * the path tracer also clamps its state count to the remaining budget. A threshold of zero
+   * removes the watermark. */
+  void set_memory_watermark(const size_t threshold_bytes, std::function<void(size_t)> callback);
+
   /* --------------------------------------------------------------------
    * Full-frame on-disk storage.
    */
@@ -210,6 +259,14 @@ class Session {
 
   void do_delayed_reset();
 
+  /* Try to resume the render from the checkpoint file, restoring render buffers and the number of
+   * rendered samples. Called from do_delayed_reset(), attempted only once per session. */
+  void load_checkpoint();
+
+  /* Write a checkpoint of the render state when enabled and enough time has passed since the
+   * previous one. Called from the main render loop after each render work. */
+  void maybe_write_checkpoint(const RenderWork &render_work);
+
   int2 get_effective_tile_size() const;
 
   /* Get device used for denoising, may be the same as render device. */
@@ -241,6 +298,26 @@ class Session {
   TileManager tile_manager_;
   BufferParams buffer_params_;
 
+  /* Inputs from which the status strings were last built by update_status_time(), used to avoid
+   * re-formatting identical status strings on every batch of samples. */
+  struct {
+    int current_tile = -1;
+    int num_tiles = -1;
+    int current_sample = -1;
+    int num_samples = -1;
+    bool show_pause = false;
+    bool show_done = false;
+    string device_status;
+    uint64_t status_generation = 0;
+  } last_status_;
+
+  /* Time at which the latest checkpoint was written, or the render started. */
+  double last_checkpoint_time_ = 0.0;
+
+  /* Whether resuming from a checkpoint has been attempted already, so that interactive resets
+   * during the session do not re-apply a stale checkpoint. */
+  bool checkpoint_resume_attempted_ = false;
+
   /* Render scheduler is used to get work to be rendered with the current big tile. */
   RenderScheduler render_scheduler_;
 
@@ -31,6 +31,7 @@ static const char *ATTR_PASSES_COUNT = "cycles.passes.count";
 static const char *ATTR_PASS_SOCKET_PREFIX_FORMAT = "cycles.passes.%d.";
 static const char *ATTR_BUFFER_SOCKET_PREFIX = "cycles.buffer.";
 static const char *ATTR_DENOISE_SOCKET_PREFIX = "cycles.denoise.";
+static const char *ATTR_CHECKPOINT_SAMPLES = "cycles.checkpoint.num_samples";
 
 /* Global counter of ToleManager object instances. */
 static std::atomic<uint64_t> g_instance_index = 0;
@@ -344,11 +345,24 @@ void TileManager::reset_scheduling(const BufferParams &params, const int2 tile_s
   tile_state_.num_tiles_y = tile_size_.y ? divide_up(params.height, tile_size_.y) : 0;
   tile_state_.num_tiles = tile_state_.num_tiles_x * tile_state_.num_tiles_y;
 
+  if (tile_order_ != TileOrder::SCANLINE) {
+    tile_order_compute(
+        tile_order_map_, tile_order_, tile_state_.num_tiles_x, tile_state_.num_tiles_y);
+  }
+  else {
+    tile_order_map_.clear();
+  }
+
   tile_state_.next_tile_index = 0;
 
   tile_state_.current_tile = Tile();
 }
 
+void TileManager::set_tile_order(const TileOrder tile_order)
+{
+  tile_order_ = tile_order;
+}
+
 void TileManager::update(const BufferParams &params, const Scene *scene)
 {
   DCHECK_NE(params.pass_stride, -1);
@@ -406,11 +420,10 @@ bool TileManager::next()
 
 Tile TileManager::get_tile_for_index(const int index) const
 {
-  /* TODO(sergey): Consider using hilbert spiral, or. maybe, even configurable. Not sure this
-   * brings a lot of value since this is only applicable to BIG tiles. */
+  const int tile_index = tile_order_map_.empty() ? index : tile_order_map_[index];
 
-  const int tile_index_y = index / tile_state_.num_tiles_x;
-  const int tile_index_x = index - tile_index_y * tile_state_.num_tiles_x;
+  const int tile_index_y = tile_index / tile_state_.num_tiles_x;
+  const int tile_index_x = tile_index - tile_index_y * tile_state_.num_tiles_x;
 
   const int tile_window_x = tile_index_x * tile_size_.x;
   const int tile_window_y = tile_index_y * tile_size_.y;
@@ -446,7 +459,7 @@ bool TileManager::open_tile_output()
 {
   write_state_.filename = path_join(temp_dir_,
                                     "cycles-tile-buffer-" + tile_file_unique_part_ + "-" +
-                                        to_string(write_state_.tile_file_index) + ".exr");
+                                        to_string(write_state_.tile_file_index) + ".ctf");
 
   write_state_.tile_out = ImageOutput::create(write_state_.filename);
   if (!write_state_.tile_out) {
@@ -661,4 +674,86 @@ bool TileManager::read_full_buffer_from_disk(const string_view filename,
   return true;
 }
 
+bool TileManager::write_checkpoint(const string_view filename,
+                                   const RenderBuffers &buffers,
+                                   const int num_samples)
+{
+  const BufferParams &buffer_params = buffers.params;
+
+  ImageSpec image_spec;
+  if (!configure_image_spec_from_buffer(
+          &image_spec, buffer_params, make_int2(buffer_params.width, buffer_params.height)))
+  {
+    return false;
+  }
+  image_spec.attribute(ATTR_CHECKPOINT_SAMPLES, num_samples);
+
+  /* Write to a temporary file first, so that an interrupt during the write
+   * does not destroy the previous checkpoint. */
+  const string checkpoint_filename(filename);
+  const string temp_filename = checkpoint_filename + ".part";
+
+  unique_ptr<ImageOutput> out = ImageOutput::create(temp_filename);
+  if (!out) {
+    LOG(ERROR) << "Error creating image output for " << temp_filename;
+    return false;
+  }
+
+  if (!out->open(temp_filename, image_spec)) {
+    LOG(ERROR) << "Error opening checkpoint file: " << out->geterror();
+    return false;
+  }
+
+  if (!out->write_image(TypeDesc::FLOAT, buffers.buffer.data())) {
+    LOG(ERROR) << "Error writing checkpoint " << out->geterror();
+    return false;
+  }
+
+  if (!out->close()) {
+    LOG(ERROR) << "Error closing checkpoint file.";
+    return false;
+  }
+
+  if (!path_rename(temp_filename, checkpoint_filename)) {
+    LOG(ERROR) << "Error replacing checkpoint file " << checkpoint_filename;
+    return false;
+  }
+
+  return true;
+}
+
+bool TileManager::read_checkpoint(const string_view filename,
+                                  RenderBuffers *buffers,
+                                  int *num_samples)
+{
+  unique_ptr<ImageInput> in(ImageInput::open(filename));
+  if (!in) {
+    LOG(ERROR) << "Error opening checkpoint file " << filename;
+    return false;
+  }
+
+  const ImageSpec &image_spec = in->spec();
+
+  BufferParams buffer_params;
+  if (!buffer_params_from_image_spec_atttributes(&buffer_params, image_spec)) {
+    return false;
+  }
+  buffers->reset(buffer_params);
+
+  *num_samples = image_spec.get_int_attribute(ATTR_CHECKPOINT_SAMPLES, 0);
+
+  const int num_channels = image_spec.nchannels;
+  if (!in->read_image(0, 0, 0, num_channels, TypeDesc::FLOAT, buffers->buffer.data())) {
+    LOG(ERROR) << "Error reading pixels from the checkpoint file " << in->geterror();
+    return false;
+  }
+
+  if (!in->close()) {
+    LOG(ERROR) << "Error closing checkpoint file " << in->geterror();
+    return false;
+  }
+
+  return true;
+}
+
 }
@@ -6,6 +6,7 @@
 
 #include <functional>
 
+#include "integrator/tile.h"
 #include "session/buffers.h"
 
 #include "util/image.h"
@@ -56,6 +57,9 @@ class TileManager {
    * cases of stretched renders. */
   void reset_scheduling(const BufferParams &params, const int2 tile_size);
 
+  /* Traversal order of the big tiles, takes effect on the next scheduling reset. */
+  void set_tile_order(const TileOrder tile_order);
+
   /* Update for the known buffer passes and scene parameters.
    * Will store all parameters needed for buffers access outside of the scene graph. */
   void update(const BufferParams &params, const Scene *scene);
@@ -107,6 +111,18 @@ class TileManager {
                                   RenderBuffers *buffers,
                                   DenoiseParams *denoise_params);
 
+  /* Write a checkpoint of the given render buffers and the number of rendered
+   * samples to a file on disk, replacing any previous checkpoint atomically.
+   *
+   * Returns true on success. */
+  bool write_checkpoint(string_view filename, const RenderBuffers &buffers, const int num_samples);
+
+  /* Read a checkpoint written by write_checkpoint() back from disk. The render
+   * buffers are reset to the parameters stored in the file.
+   *
+   * Returns true on success. */
+  bool read_checkpoint(string_view filename, RenderBuffers *buffers, int *num_samples);
+
   /* Compute valid tile size compatible with image saving. */
   int compute_render_tile_size(const int suggested_tile_size) const;
 
@@ -135,6 +151,11 @@ class TileManager {
 
   int2 tile_size_ = make_int2(0, 0);
 
+  /* Tile traversal order, with the permutation from schedule position to
+   * scanline tile index. Empty for the default scanline order. */
+  TileOrder tile_order_ = TileOrder::SCANLINE;
+  vector<int> tile_order_map_;
+
   /* Number of extra pixels around the actual tile to render. */
   int overscan_ = 0;
 
@@ -0,0 +1,230 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "device/cpu/kernel.h"
+
+#include "kernel/device/cpu/globals.h"
+
+#include "kernel/svm/types.h"
+#include "kernel/types.h"
+
+#include "util/debug.h"
+#include "util/half.h"
+#include "util/math.h"
+#include "util/profiling.h"
+#include "util/time.h"
+#include "util/vector.h"
+
+namespace ccl {
+
+/* Microbenchmarks of isolated CPU kernel stages, run once per instruction set
+ * variant of CPUKernelFunction. They report ns/op to stdout rather than assert
+ * on timings, so the numbers can be compared across variants and machines
+ * without making the test flaky; the assertions only sanity check the kernel
+ * output.
+ *
+ * The instruction set is forced through the CPU debug flags, the same way the
+ * --debug command line options do, and a variant is skipped when the CPU or
+ * build does not support it. */
+
+struct CPUVariant {
+  /* Expected CPUKernelFunction::get_uarch_name() for this variant. */
+  const char *uarch_name;
+  bool avx2;
+  bool avx512;
+};
+
+static const CPUVariant cpu_variants[] = {
+    {"default", false, false},
+    {"AVX2", true, false},
+    {"AVX512", true, true},
+};
+
+template<typename BenchFunc>
+static void bench_cpu_variants(const char *bench_name, const BenchFunc &bench)
+{
+  for (const CPUVariant &variant : cpu_variants) {
+    DebugFlags().cpu.avx2 = variant.avx2;
+    DebugFlags().cpu.avx512 = variant.avx512;
+
+    /* The variant is picked when the kernel function pointers are wired up. */
+    const CPUKernels kernels;
+
+    if (strcmp(kernels.integrator_init_from_camera.get_uarch_name(), variant.uarch_name) != 0) {
+      /* CPU or build does not support this instruction set. */
+      continue;
+    }
+
+    const int num_ops = bench(kernels);
+    ASSERT_GT(num_ops, 0);
+
+    /* Measure over a fixed wall clock budget, with the warm-up run above
+     * having paged in the working set. */
+    const double min_time = 0.1;
+    const double time_start = time_dt();
+    double time_elapsed;
+    int64_t total_ops = 0;
+    do {
+      total_ops += bench(kernels);
+      time_elapsed = time_dt() - time_start;
+    } while (time_elapsed < min_time);
+
+    printf("  %-28s %-8s %10.2f ns/op\n",
+           bench_name,
+           variant.uarch_name,
+           time_elapsed / (double)total_ops * 1e9);
+  }
+
+  DebugFlags().cpu.reset();
+}
+
+/* Film conversion from render buffer passes to display pixels. */
+
+static void film_convert_init(KernelFilmConvert *kfilm_convert, const int pass_stride)
+{
+  memset(kfilm_convert, 0, sizeof(*kfilm_convert));
+
+  kfilm_convert->pass_offset = 0;
+  kfilm_convert->pass_stride = pass_stride;
+  kfilm_convert->pass_combined = 0;
+
+  kfilm_convert->pass_divide = PASS_UNUSED;
+  kfilm_convert->pass_indirect = PASS_UNUSED;
+  kfilm_convert->pass_sample_count = PASS_UNUSED;
+  kfilm_convert->pass_adaptive_aux_buffer = PASS_UNUSED;
+  kfilm_convert->pass_motion_weight = PASS_UNUSED;
+  kfilm_convert->pass_shadow_catcher = PASS_UNUSED;
+  kfilm_convert->pass_shadow_catcher_sample_count = PASS_UNUSED;
+  kfilm_convert->pass_shadow_catcher_matte = PASS_UNUSED;
+  kfilm_convert->pass_background = PASS_UNUSED;
+
+  kfilm_convert->scale = 1.0f;
+  kfilm_convert->exposure = 1.0f;
+  kfilm_convert->scale_exposure = 1.0f;
+
+  kfilm_convert->num_components = 4;
+}
+
+TEST(KernelCPUBench, film_convert_half_rgba_combined)
+{
+  const int width = 960;
+  const int height = 270;
+  const int pass_stride = 4;
+
+  KernelFilmConvert kfilm_convert;
+  film_convert_init(&kfilm_convert, pass_stride);
+
+  vector<float> buffer(width * height * pass_stride);
+  for (size_t i = 0; i < buffer.size(); i++) {
+    buffer[i] = 0.25f + 0.5f * (float)(i & 255) / 255.0f;
+  }
+  vector<half4> pixels(width * height);
+
+  bench_cpu_variants("film_convert_half_rgba", [&](const CPUKernels &kernels) {
+    for (int y = 0; y < height; y++) {
+      kernels.film_convert_half_rgba_combined(&kfilm_convert,
+                                              buffer.data() + (size_t)y * width * pass_stride,
+                                              pixels.data() + (size_t)y * width,
+                                              width,
+                                              pass_stride);
+    }
+    return width * height;
+  });
+
+  EXPECT_NEAR(half_to_float_image(pixels[0].x), buffer[0], 0.002f);
+}
+
+TEST(KernelCPUBench, film_convert_float4_combined)
+{
+  const int width = 960;
+  const int height = 270;
+  const int pass_stride = 4;
+
+  KernelFilmConvert kfilm_convert;
+  film_convert_init(&kfilm_convert, pass_stride);
+
+  vector<float> buffer(width * height * pass_stride, 0.25f);
+  vector<float> pixels(width * height * 4);
+
+  bench_cpu_variants("film_convert_float4", [&](const CPUKernels &kernels) {
+    for (int y = 0; y < height; y++) {
+      kernels.film_convert_combined(&kfilm_convert,
+                                    buffer.data() + (size_t)y * width * pass_stride,
+                                    pixels.data() + (size_t)y * width * 4,
+                                    width,
+                                    pass_stride,
+                                    4);
+    }
+    return width * height;
+  });
+
+  EXPECT_NEAR(pixels[0], 0.25f, 1e-6f);
+}
+
+/* SVM evaluation over a hand-assembled shader program, through the background
+ * shader evaluation kernel which needs no scene data beyond the program and
+ * shader arrays. The program is a serial chain of math nodes, so the benchmark
+ * measures the node dispatch and stack traffic of svm_eval_nodes rather than
+ * any one operation. */
+
+TEST(KernelCPUBench, svm_eval_background)
+{
+  const int num_math_nodes = 64;
+
+  vector<uint4> program;
+  /* Program 0 holds the jump entries, the surface program follows directly. */
+  program.push_back(make_uint4(NODE_SHADER_JUMP, 1, 1, 1));
+  program.push_back(make_uint4(NODE_VALUE_F, __float_as_uint(0.5f), 0, 0));
+  program.push_back(make_uint4(NODE_VALUE_F, __float_as_uint(1.25f), 1, 0));
+  /* First node reads the two seed values, the rest chain on the previous
+   * result so evaluation can not be dead code eliminated or reordered. */
+  program.push_back(
+      make_uint4(NODE_MATH, NODE_MATH_MULTIPLY_ADD, (0) | (1 << 8) | (1 << 16), 2));
+  for (int i = 1; i < num_math_nodes; i++) {
+    const uint type = (i & 1) ? NODE_MATH_SINE : NODE_MATH_MULTIPLY_ADD;
+    program.push_back(make_uint4(NODE_MATH, type, (2) | (1 << 8) | (0 << 16), 2));
+  }
+  program.push_back(make_uint4(NODE_END, 0, 0, 0));
+
+  KernelShader shader;
+  memset(&shader, 0, sizeof(shader));
+
+  KernelGlobalsCPU kglobals;
+  kglobals.svm_nodes.data = program.data();
+  kglobals.svm_nodes.width = (int)program.size();
+  kglobals.shaders.data = &shader;
+  kglobals.shaders.width = 1;
+  kglobals.data.background.surface_shader = 0;
+
+  Profiler profiler;
+  ThreadKernelGlobalsCPU kg(kglobals, nullptr, profiler, 0);
+
+  const int num_inputs = 256;
+  vector<KernelShaderEvalInput> inputs(num_inputs);
+  for (int i = 0; i < num_inputs; i++) {
+    inputs[i].object = OBJECT_NONE;
+    inputs[i].prim = PRIM_NONE;
+    inputs[i].u = (float)i / (float)num_inputs;
+    inputs[i].v = 0.5f;
+  }
+  vector<float> output(num_inputs * 3, 0.0f);
+
+  bench_cpu_variants("svm_eval_background", [&](const CPUKernels &kernels) {
+    for (int i = 0; i < num_inputs; i++) {
+      kernels.shader_eval_background(&kg, inputs.data(), output.data(), i);
+    }
+    return num_inputs;
+  });
+
+  /* The shader has no emission closure, so the background evaluates to black.
+   * This checks the program ran to NODE_END without touching the output. */
+  EXPECT_EQ(output[0], 0.0f);
+}
+
+}
@@ -1538,4 +1538,36 @@ TEST_F(RenderGraph, constant_fold_convert_color_float_color)
   graph.finalize(scene.get());
 }
 
+/*
+ * Tests:
+ *  - Content hash matches for identically built graphs and differs when a
+ *    socket value changes, so identical shaders can share compiled programs.
+ */
+TEST_F(RenderGraph, content_hash)
+{
+  EXPECT_ANY_MESSAGE(log);
+
+  auto build = [](ShaderGraph &graph, const float value) {
+    ShaderGraphBuilder builder(&graph);
+    builder
+        .add_node(ShaderNodeBuilder<MathNode>(graph, "MathAdd")
+                      .set_param("math_type", NODE_MATH_ADD)
+                      .set("Value1", value)
+                      .set("Value2", 0.5f))
+        .output_value("MathAdd::Value");
+    graph.compute_content_hash();
+  };
+
+  ShaderGraph graph_a;
+  ShaderGraph graph_b;
+  ShaderGraph graph_c;
+  build(graph_a, 0.25f);
+  build(graph_b, 0.25f);
+  build(graph_c, 0.75f);
+
+  EXPECT_FALSE(graph_a.content_hash.empty());
+  EXPECT_EQ(graph_a.content_hash, graph_b.content_hash);
+  EXPECT_NE(graph_a.content_hash, graph_c.content_hash);
+}
+
 }
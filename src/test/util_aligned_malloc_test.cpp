@@ -2,6 +2,8 @@
  *
  * SPDX-License-Identifier: Apache-2.0 */
 
+#include <cstring>
+
 #include "testing/testing.h"
 
 #include "util/aligned_malloc.h"
@@ -27,4 +29,15 @@ TEST(util_aligned_malloc, aligned_malloc_32)
 }
 #endif /* __APPLE__ */
 
+/* Allocations of a hugepage or more take the mmap-backed path on Linux. */
+TEST(util_aligned_malloc, aligned_malloc_large)
+{
+  const size_t size = 4 * 1024 * 1024;
+  char *mem = (char *)util_aligned_malloc(size, 16);
+  CHECK_ALIGNMENT(mem, 16);
+  memset(mem, 0xab, size);
+  EXPECT_EQ(mem[size - 1], (char)0xab);
+  util_aligned_free(mem, size);
+}
+
 }
@@ -0,0 +1,118 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "util/arena.h"
+#include "util/array.h"
+
+namespace ccl {
+
+static bool is_inside_object(const array<int> &a)
+{
+  const char *mem = (const char *)a.data();
+  return mem >= (const char *)&a && mem < (const char *)(&a + 1);
+}
+
+TEST(util_array, small_is_inline)
+{
+  array<int> a;
+  a.push_back_slow(1);
+  a.push_back_slow(2);
+
+  EXPECT_TRUE(is_inside_object(a));
+  EXPECT_EQ(a[0], 1);
+  EXPECT_EQ(a[1], 2);
+}
+
+TEST(util_array, grow_past_inline)
+{
+  array<int> a;
+  for (int i = 0; i < 100; i++) {
+    a.push_back_slow(i);
+  }
+
+  EXPECT_FALSE(is_inside_object(a));
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(a[i], i);
+  }
+}
+
+TEST(util_array, move_inline)
+{
+  array<int> a;
+  a.push_back_slow(7);
+
+  array<int> b(std::move(a));
+
+  EXPECT_EQ(b.size(), 1);
+  EXPECT_EQ(b[0], 7);
+  EXPECT_EQ(a.size(), 0);
+  EXPECT_EQ(a.data(), nullptr);
+}
+
+TEST(util_array, steal_data_inline)
+{
+  array<int> a;
+  a.push_back_slow(42);
+
+  array<int> b;
+  b.steal_data(a);
+
+  EXPECT_EQ(b.size(), 1);
+  EXPECT_EQ(b[0], 42);
+  EXPECT_EQ(a.size(), 0);
+}
+
+/* Stolen pointers get freed by the caller, so inline storage must be copied to the heap. */
+TEST(util_array, steal_pointer_inline)
+{
+  array<int> a;
+  a.push_back_slow(5);
+  a.push_back_slow(6);
+
+  const size_t size = a.size();
+  int *mem = a.steal_pointer();
+
+  EXPECT_EQ(mem[0], 5);
+  EXPECT_EQ(mem[1], 6);
+  EXPECT_EQ(a.size(), 0);
+
+  util_aligned_free(mem, size * sizeof(int));
+}
+
+TEST(util_array, arena_backed)
+{
+  Arena arena;
+
+  array<float> a(arena, 64);
+  for (int i = 0; i < 64; i++) {
+    a[i] = float(i);
+  }
+
+  /* Growing past the arena allocation falls back to the heap. */
+  a.push_back_slow(64.0f);
+  for (int i = 0; i <= 64; i++) {
+    EXPECT_EQ(a[i], float(i));
+  }
+}
+
+TEST(util_array, resize_across_inline_boundary)
+{
+  array<int> a(2);
+  a[0] = 1;
+  a[1] = 2;
+
+  a.resize(200);
+  EXPECT_EQ(a[0], 1);
+  EXPECT_EQ(a[1], 2);
+
+  a.resize(1);
+  EXPECT_EQ(a[0], 1);
+
+  a.resize(0);
+  EXPECT_EQ(a.data(), nullptr);
+}
+
+}
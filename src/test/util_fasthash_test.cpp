@@ -0,0 +1,69 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "util/fasthash.h"
+#include "util/vector.h"
+
+namespace ccl {
+
+static vector<uint8_t> test_data(const size_t size)
+{
+  vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; i++) {
+    data[i] = (uint8_t)(i * 2654435761u >> 13);
+  }
+  return data;
+}
+
+/* Appending in chunks must give the same digest as one large append. */
+TEST(util_fasthash, streaming)
+{
+  const vector<uint8_t> data = test_data(1000);
+
+  FastHash one_shot;
+  one_shot.append(data.data(), data.size());
+
+  FastHash streamed;
+  size_t offset = 0;
+  for (const size_t chunk : {1, 63, 64, 65, 7, 800}) {
+    streamed.append(data.data() + offset, chunk);
+    offset += chunk;
+  }
+  ASSERT_EQ(offset, data.size());
+
+  EXPECT_EQ(one_shot.get_hex(), streamed.get_hex());
+}
+
+TEST(util_fasthash, distinct)
+{
+  vector<uint8_t> data = test_data(1024);
+  const uint64_t before = util_fast_hash(data.data(), data.size());
+
+  data[512] ^= 1;
+  const uint64_t after = util_fast_hash(data.data(), data.size());
+
+  EXPECT_NE(before, after);
+}
+
+/* The zero padding of the final stripe must not collide with real zeros. */
+TEST(util_fasthash, trailing_zeros)
+{
+  const uint8_t zeros[128] = {0};
+
+  EXPECT_NE(util_fast_hash(zeros, 64), util_fast_hash(zeros, 65));
+  EXPECT_NE(util_fast_hash(zeros, 1), util_fast_hash(zeros, 2));
+  EXPECT_NE(util_fast_hash(zeros, 0), util_fast_hash(zeros, 1));
+}
+
+TEST(util_fasthash, hex_digest)
+{
+  FastHash hash;
+  hash.append(string("Hello, World!"));
+
+  EXPECT_EQ(hash.get_hex().size(), 32);
+}
+
+}
@@ -27,6 +27,24 @@ TEST(util_task, basic)
   EXPECT_EQ(summary.num_tasks_handled, 100);
 }
 
+TEST(util_task, priority)
+{
+  TaskScheduler::init(0);
+  TaskPool high_pool(TaskPriority::HIGH);
+  TaskPool low_pool(TaskPriority::LOW);
+  for (int i = 0; i < 100; ++i) {
+    high_pool.push([] { task_run(); });
+    low_pool.push([] { task_run(); });
+  }
+  TaskPool::Summary high_summary;
+  TaskPool::Summary low_summary;
+  high_pool.wait_work(&high_summary);
+  low_pool.wait_work(&low_summary);
+  TaskScheduler::exit();
+  EXPECT_EQ(high_summary.num_tasks_handled, 100);
+  EXPECT_EQ(low_summary.num_tasks_handled, 100);
+}
+
 TEST(util_task, multiple_times)
 {
   for (int N = 0; N < 1000; ++N) {
@@ -30,8 +30,51 @@
 #  include <cstdlib>
 #endif
 
+#if defined(__linux__) && !defined(WITH_BLENDER_GUARDEDALLOC)
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  define WITH_ALIGNED_MALLOC_MMAP
+#endif
+
 namespace ccl {
 
+#ifdef WITH_ALIGNED_MALLOC_MMAP
+
+/* Back allocations of a hugepage or more with fresh anonymous mappings instead of the heap.
+ *
+ * This allows the kernel to use 2MB transparent hugepages for them, which measurably lowers the
+ * TLB miss rate of scene update and rendering of large scenes, and it gives first-touch NUMA
+ * placement: the heap would hand out pages which were already faulted in by whichever thread
+ * freed them, while fresh mappings are placed on the node of the thread which first writes to
+ * them. Allocations this large bypass the heap on free as well, so heap fragmentation is not
+ * made any worse.
+ *
+ * The decision must only depend on the size, since the free path has to make the same one. */
+static bool use_mmap_alloc(const size_t size)
+{
+  return size >= 2 * 1024 * 1024;
+}
+
+static void *util_mmap_malloc(const size_t size, const int alignment)
+{
+  /* Mappings are page aligned, which covers all alignments the renderer uses. */
+  assert(alignment <= sysconf(_SC_PAGESIZE));
+  (void)alignment;
+
+  void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED) {
+    return nullptr;
+  }
+
+  /* Advisory only: when hugepages are not available the mapping transparently stays backed by
+   * regular pages. */
+  madvise(mem, size, MADV_HUGEPAGE);
+
+  return mem;
+}
+
+#endif /* WITH_ALIGNED_MALLOC_MMAP */
+
 void *util_aligned_malloc(const size_t size, const int alignment)
 {
   void *mem = nullptr;
@@ -46,7 +89,17 @@ void *util_aligned_malloc(const size_t size, const int alignment)
     mem = nullptr;
   }
 #else /* This is for Linux. */
-  mem = memalign(alignment, size);
+#  ifdef WITH_ALIGNED_MALLOC_MMAP
+  if (use_mmap_alloc(size)) {
+    /* No fallback to the heap here: the free path could then not tell how the pointer was
+     * allocated, and a failing anonymous mapping means the heap is out of memory as well. */
+    mem = util_mmap_malloc(size, alignment);
+  }
+  else
+#  endif
+  {
+    mem = memalign(alignment, size);
+  }
 #endif
   if (mem) {
     util_guarded_mem_alloc(size);
@@ -66,6 +119,12 @@ void util_aligned_free(void *ptr, const size_t size)
 #elif defined(_WIN32)
   _aligned_free(ptr);
 #else
+#  ifdef WITH_ALIGNED_MALLOC_MMAP
+  if (ptr != nullptr && use_mmap_alloc(size)) {
+    munmap(ptr, size);
+    return;
+  }
+#  endif
   free(ptr);
 #endif
 }
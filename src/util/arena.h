@@ -0,0 +1,92 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstddef>
+
+#include "util/aligned_malloc.h"
+#include "util/vector.h"
+
+namespace ccl {
+
+/* Bump allocator which hands out memory from larger blocks.
+ *
+ * Allocation is a pointer increment, and individual allocations can not be
+ * freed: all memory is released at once when the arena is destroyed or reset.
+ * Useful for many small allocations with the same lifetime, like the nodes of
+ * a shader graph, where it avoids the cost of freeing them one by one and
+ * keeps them close together in memory. */
+
+class Arena {
+ public:
+  explicit Arena(const size_t block_size = 64 * 1024) : block_size(block_size) {}
+
+  ~Arena()
+  {
+    release_all();
+  }
+
+  Arena(const Arena &other) = delete;
+  Arena &operator=(const Arena &other) = delete;
+
+  /* Allocate memory, aligned to the minimum alignment for CPU data types. */
+  void *alloc(const size_t size)
+  {
+    const size_t aligned_size = align_up(size);
+
+    /* Allocations bigger than a block get their own dedicated block, keeping
+     * the remaining capacity of the current block available. */
+    if (aligned_size > block_size) {
+      return push_block(aligned_size);
+    }
+
+    if (aligned_size > capacity) {
+      current = push_block(block_size);
+      capacity = block_size;
+    }
+
+    void *mem = current;
+    current += aligned_size;
+    capacity -= aligned_size;
+    return mem;
+  }
+
+  /* Free all blocks, invalidating every allocation made from this arena. */
+  void release_all()
+  {
+    for (const Block &block : blocks) {
+      util_aligned_free(block.mem, block.size);
+    }
+    blocks.clear();
+    current = nullptr;
+    capacity = 0;
+  }
+
+ protected:
+  static size_t align_up(const size_t size)
+  {
+    constexpr size_t alignment = MIN_ALIGNMENT_CPU_DATA_TYPES;
+    return (size + alignment - 1) & ~(alignment - 1);
+  }
+
+  char *push_block(const size_t size)
+  {
+    char *mem = (char *)util_aligned_malloc(size, MIN_ALIGNMENT_CPU_DATA_TYPES);
+    blocks.push_back({mem, size});
+    return mem;
+  }
+
+  struct Block {
+    char *mem;
+    size_t size;
+  };
+
+  vector<Block> blocks;
+  char *current = nullptr;
+  size_t capacity = 0;
+  size_t block_size;
+};
+
+}
@@ -8,6 +8,7 @@
 #include <cstring>
 
 #include "util/aligned_malloc.h"
+#include "util/arena.h"
 #include "util/vector.h"
 
 namespace ccl {
@@ -17,7 +18,12 @@ namespace ccl {
  *   this was actually showing up in profiles quite significantly. it
  *   also does not run any constructors/destructors
  * - if this is used, we are not tempted to use inefficient operations
- * - aligned allocation for CPU native data types */
+ * - aligned allocation for CPU native data types
+ * - a few elements are stored in the array object itself, so that the many
+ *   small arrays used for node sockets and patch data avoid the heap
+ *   entirely
+ * - storage can optionally come from an Arena, sharing the lifetime of for
+ *   example a shader graph */
 
 template<typename T, const size_t alignment = MIN_ALIGNMENT_CPU_DATA_TYPES> class array {
  public:
@@ -33,7 +39,28 @@ template<typename T, const size_t alignment = MIN_ALIGNMENT_CPU_DATA_TYPES> clas
     else {
       data_ = mem_allocate(newsize);
       datasize_ = newsize;
-      capacity_ = datasize_;
+      capacity_ = mem_capacity(data_, newsize);
+    }
+  }
+
+  /* Construct with storage allocated from an arena, which then owns the memory: freeing is a
+   * no-op and the memory lives until the arena is released. Growing past the initial size falls
+   * back to the heap. */
+  array(Arena &arena, const size_t newsize)
+  {
+    static_assert(alignment <= MIN_ALIGNMENT_CPU_DATA_TYPES,
+                  "Arena allocations only satisfy the minimum CPU data type alignment");
+
+    if (newsize == 0 || newsize <= mem_inline_elements()) {
+      data_ = (newsize == 0) ? nullptr : inline_data();
+      datasize_ = newsize;
+      capacity_ = (newsize == 0) ? 0 : mem_inline_elements();
+    }
+    else {
+      data_ = (T *)arena.alloc(sizeof(T) * newsize);
+      datasize_ = newsize;
+      capacity_ = newsize;
+      owned_ = false;
     }
   }
 
@@ -50,19 +77,29 @@ template<typename T, const size_t alignment = MIN_ALIGNMENT_CPU_DATA_TYPES> clas
         mem_copy(data_, from.data_, from.datasize_);
       }
       datasize_ = from.datasize_;
-      capacity_ = datasize_;
+      capacity_ = mem_capacity(data_, datasize_);
     }
   }
 
-  array(array &&from)
+  array(array &&from) noexcept
   {
-    data_ = from.data_;
-    datasize_ = from.datasize_;
-    capacity_ = from.capacity_;
+    if (from.is_inline(from.data_)) {
+      mem_copy(inline_data(), from.data_, from.datasize_);
+      data_ = inline_data();
+      datasize_ = from.datasize_;
+      capacity_ = mem_inline_elements();
+    }
+    else {
+      data_ = from.data_;
+      datasize_ = from.datasize_;
+      capacity_ = from.capacity_;
+      owned_ = from.owned_;
+    }
 
     from.data_ = nullptr;
     from.datasize_ = 0;
     from.capacity_ = 0;
+    from.owned_ = true;
   }
 
   array &operator=(const array &from)
@@ -115,13 +152,23 @@ template<typename T, const size_t alignment = MIN_ALIGNMENT_CPU_DATA_TYPES> clas
     if (this != &from) {
       clear();
 
-      data_ = from.data_;
-      datasize_ = from.datasize_;
-      capacity_ = from.capacity_;
+      if (from.is_inline(from.data_)) {
+        mem_copy(inline_data(), from.data_, from.datasize_);
+        data_ = inline_data();
+        datasize_ = from.datasize_;
+        capacity_ = mem_inline_elements();
+      }
+      else {
+        data_ = from.data_;
+        datasize_ = from.datasize_;
+        capacity_ = from.capacity_;
+        owned_ = from.owned_;
+      }
 
       from.data_ = nullptr;
       from.datasize_ = 0;
       from.capacity_ = 0;
+      from.owned_ = true;
     }
   }
 
@@ -136,6 +183,12 @@ template<typename T, const size_t alignment = MIN_ALIGNMENT_CPU_DATA_TYPES> clas
   T *steal_pointer()
   {
     T *ptr = data_;
+    if (ptr != nullptr && (is_inline(ptr) || !owned_)) {
+      /* Inline and arena storage can not outlive the array, so hand out a heap copy which the
+       * caller can free as usual. */
+      ptr = (T *)util_aligned_malloc(sizeof(T) * datasize_, alignment);
+      mem_copy(ptr, data_, datasize_);
+    }
     data_ = nullptr;
     clear();
     return ptr;
@@ -159,7 +212,8 @@ template<typename T, const size_t alignment = MIN_ALIGNMENT_CPU_DATA_TYPES> clas
           mem_free(data_, capacity_);
         }
         data_ = newdata;
-        capacity_ = newsize;
+        capacity_ = mem_capacity(newdata, newsize);
+        owned_ = true;
       }
       datasize_ = newsize;
     }
@@ -186,6 +240,7 @@ template<typename T, const size_t alignment = MIN_ALIGNMENT_CPU_DATA_TYPES> clas
     }
     datasize_ = 0;
     capacity_ = 0;
+    owned_ = true;
   }
 
   size_t empty() const
@@ -243,7 +298,8 @@ template<typename T, const size_t alignment = MIN_ALIGNMENT_CPU_DATA_TYPES> clas
         mem_free(data_, capacity_);
       }
       data_ = newdata;
-      capacity_ = newcapacity;
+      capacity_ = mem_capacity(newdata, newcapacity);
+      owned_ = true;
     }
   }
 
@@ -278,11 +334,37 @@ template<typename T, const size_t alignment = MIN_ALIGNMENT_CPU_DATA_TYPES> clas
   }
 
  protected:
+  /* Number of bytes of storage inside the array object itself. */
+  static constexpr size_t INLINE_BYTES = 16;
+
+  static constexpr size_t mem_inline_elements()
+  {
+    return INLINE_BYTES / sizeof(T);
+  }
+
+  T *inline_data()
+  {
+    return (T *)inline_storage_;
+  }
+
+  bool is_inline(const T *mem) const
+  {
+    return mem != nullptr && mem == (const T *)inline_storage_;
+  }
+
+  size_t mem_capacity(const T *mem, const size_t N) const
+  {
+    return is_inline(mem) ? mem_inline_elements() : N;
+  }
+
   T *mem_allocate(const size_t N)
   {
     if (N == 0) {
       return nullptr;
     }
+    if (N <= mem_inline_elements()) {
+      return inline_data();
+    }
     T *mem = (T *)util_aligned_malloc(sizeof(T) * N, alignment);
     if (mem == nullptr) {
       throw std::bad_alloc();
@@ -292,7 +374,7 @@ template<typename T, const size_t alignment = MIN_ALIGNMENT_CPU_DATA_TYPES> clas
 
   void mem_free(T *mem, const size_t N)
   {
-    if (mem != nullptr) {
+    if (mem != nullptr && owned_ && !is_inline(mem)) {
       util_aligned_free(mem, sizeof(T) * N);
     }
   }
@@ -305,6 +387,9 @@ template<typename T, const size_t alignment = MIN_ALIGNMENT_CPU_DATA_TYPES> clas
   T *data_;
   size_t datasize_;
   size_t capacity_;
+  /* False when the storage belongs to an arena and must not be freed here. */
+  bool owned_ = true;
+  alignas(alignment) char inline_storage_[INLINE_BYTES];
 };
 
 }
@@ -0,0 +1,25 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+/* TBB includes <windows.h>, do it ourselves first so we are sure
+ * WIN32_LEAN_AND_MEAN and similar are defined beforehand. */
+#ifdef _WIN32
+#  include "util/windows.h"
+#endif
+
+#include <tbb/concurrent_unordered_map.h>
+
+namespace ccl {
+
+/* Hash map supporting concurrent insertion and lookup without locking.
+ *
+ * Insertion never invalidates iterators or references, so pointers into the
+ * map stay valid while other threads insert. Racing insertions of the same
+ * key keep the first value. Erasing is not concurrency-safe; use clear() only
+ * when no other threads access the map. */
+using tbb::concurrent_unordered_map;
+
+}
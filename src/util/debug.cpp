@@ -27,6 +27,7 @@ void DebugFlags::CPU::reset()
   } while (0)
 
   CHECK_CPU_FLAGS(avx2, "CYCLES_CPU_NO_AVX2");
+  CHECK_CPU_FLAGS(avx512, "CYCLES_CPU_NO_AVX512");
 
 #undef STRINGIFY
 #undef CHECK_CPU_FLAGS
@@ -0,0 +1,223 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "util/fasthash.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "util/path.h"
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+namespace ccl {
+
+/* Multiplicative constants from xxhash (public domain). */
+static constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ull;
+static constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+static constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ull;
+static constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+static constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ull;
+static constexpr uint64_t PRIME32_1 = 0x9E3779B1ull;
+
+/* Secret lane keys, one 64 byte row per stripe position within a block. The
+ * row rotates with the stripe index so repeated input patterns do not cancel
+ * out across stripes. Values are arbitrary odd constants. */
+static constexpr int NUM_SECRET_ROWS = 4;
+static const uint64_t secret[NUM_SECRET_ROWS][8] = {
+    {0xbe4ba423396cfeb8ull,
+     0x1cad21f72c81017cull,
+     0xdb979083e96dd4deull,
+     0x1f67b3b7a4a44072ull,
+     0x78e5c0cc4ee679cbull,
+     0x2172ffcc7dd05a82ull,
+     0x8e2443f7744608b8ull,
+     0x4c263a81e69035e0ull},
+    {0xcb00c391bb52283cull,
+     0xa32e531b8b65d088ull,
+     0x4ef90da297486471ull,
+     0xd8acdea946ef1938ull,
+     0x3f349ce33f76faa8ull,
+     0x1d4f0bc7c7bbdcf9ull,
+     0x3159b4cd4be0518aull,
+     0x647378d9c97e9fc8ull},
+    {0xc3ebd33483acc5eaull,
+     0xeb6313faffa081c5ull,
+     0x49daf0b751dd0d17ull,
+     0x9e68d429265516d3ull,
+     0xfca1477d58be162bull,
+     0xce31d07ad1b8f88full,
+     0x280416958f3acb45ull,
+     0x7e404bbbcafbd7afull},
+    {0x53a1ca09b5d09a4cull,
+     0x80a94e7ae0b7b05dull,
+     0x1ddeebb54b0bcd1dull,
+     0x93ac4ba4b1f0785full,
+     0x4223976f59b19c6eull,
+     0xa51eac0c1c7c3ea9ull,
+     0x0fa527ae3b4a67c7ull,
+     0x8d5b320ab49e9dd5ull}};
+
+static inline uint64_t read64(const uint8_t *data)
+{
+  uint64_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+/* Final avalanche, from xxh3. */
+static inline uint64_t avalanche(uint64_t h)
+{
+  h ^= h >> 37;
+  h *= PRIME64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+FastHash::FastHash()
+{
+  acc[0] = PRIME64_1;
+  acc[1] = PRIME64_2;
+  acc[2] = PRIME64_3;
+  acc[3] = PRIME64_4;
+  acc[4] = PRIME64_5;
+  acc[5] = PRIME32_1;
+  acc[6] = PRIME64_1 ^ PRIME64_5;
+  acc[7] = PRIME64_2 ^ PRIME64_4;
+  buf_used = 0;
+  total_len = 0;
+  num_stripes = 0;
+}
+
+void FastHash::process(const uint8_t *stripe)
+{
+  const uint64_t *key = secret[num_stripes++ & (NUM_SECRET_ROWS - 1)];
+
+#ifdef __SSE2__
+  /* Two lanes per vector: acc[i] += swap(data) + low32(data^key) * high32(data^key). */
+  __m128i *xacc = (__m128i *)acc;
+  for (int i = 0; i < 4; i++) {
+    const __m128i data = _mm_loadu_si128((const __m128i *)(stripe + i * 16));
+    const __m128i data_key = _mm_xor_si128(data, _mm_loadu_si128((const __m128i *)(key + i * 2)));
+    const __m128i product = _mm_mul_epu32(data_key, _mm_srli_epi64(data_key, 32));
+    const __m128i data_swap = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+    xacc[i] = _mm_add_epi64(xacc[i], _mm_add_epi64(product, data_swap));
+  }
+#else
+  for (int i = 0; i < 8; i++) {
+    const uint64_t data = read64(stripe + i * 8);
+    const uint64_t data_key = data ^ key[i];
+    acc[i ^ 1] += data;
+    acc[i] += (data_key & 0xFFFFFFFFull) * (data_key >> 32);
+  }
+#endif
+}
+
+void FastHash::append(const uint8_t *data, size_t nbytes)
+{
+  total_len += nbytes;
+
+  if (buf_used != 0) {
+    const size_t fill = std::min(nbytes, sizeof(buf) - buf_used);
+    memcpy(buf + buf_used, data, fill);
+    buf_used += fill;
+    data += fill;
+    nbytes -= fill;
+
+    if (buf_used < sizeof(buf)) {
+      return;
+    }
+    process(buf);
+    buf_used = 0;
+  }
+
+  while (nbytes >= sizeof(buf)) {
+    process(data);
+    data += sizeof(buf);
+    nbytes -= sizeof(buf);
+  }
+
+  if (nbytes != 0) {
+    memcpy(buf, data, nbytes);
+    buf_used = nbytes;
+  }
+}
+
+void FastHash::append(const string &str)
+{
+  append((const uint8_t *)str.c_str(), str.size());
+}
+
+bool FastHash::append_file(const string &filepath)
+{
+  FILE *f = path_fopen(filepath, "rb");
+
+  if (!f) {
+    fprintf(stderr, "FastHash: failed to open file %s\n", filepath.c_str());
+    return false;
+  }
+
+  uint8_t buffer[65536];
+  size_t n;
+
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) != 0) {
+    append(buffer, n);
+  }
+
+  const bool success = (ferror(f) == 0);
+
+  fclose(f);
+
+  return success;
+}
+
+void FastHash::finish(uint64_t digest[2])
+{
+  /* Zero-pad and process the final partial stripe. The padding is
+   * disambiguated from real zero bytes by mixing in the total length. */
+  if (buf_used != 0 || total_len == 0) {
+    memset(buf + buf_used, 0, sizeof(buf) - buf_used);
+    process(buf);
+  }
+
+  uint64_t lo = total_len * PRIME64_1;
+  uint64_t hi = ~total_len * PRIME64_2;
+  for (int i = 0; i < 8; i++) {
+    lo = (lo ^ avalanche(acc[i])) * PRIME64_1 + PRIME64_4;
+    hi = (hi ^ avalanche(acc[7 - i])) * PRIME64_2 + PRIME64_3;
+  }
+
+  digest[0] = avalanche(lo);
+  digest[1] = avalanche(hi);
+}
+
+string FastHash::get_hex()
+{
+  uint64_t digest[2];
+  finish(digest);
+
+  return string_printf(
+      "%016llx%016llx", (unsigned long long)digest[1], (unsigned long long)digest[0]);
+}
+
+uint64_t util_fast_hash(const void *data, const size_t size)
+{
+  FastHash hash;
+  hash.append((const uint8_t *)data, size);
+
+  uint64_t digest[2];
+  hash.finish(digest);
+  return digest[0];
+}
+
+string util_fast_hash_string(const string &str)
+{
+  FastHash hash;
+  hash.append(str);
+  return hash.get_hex();
+}
+
+}
@@ -0,0 +1,55 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "util/string.h"
+
+namespace ccl {
+
+/* Fast content hashing
+ *
+ * Non-cryptographic 128 bit hash in the xxh3 family, for content keys over
+ * large buffers like vertex arrays where MD5 is too slow. Data is consumed in
+ * 64 byte stripes of multiply-xor lanes which map directly onto SSE2, so
+ * hashing runs at close to memory bandwidth.
+ *
+ * The streaming interface mirrors MD5Hash so callers can switch between the
+ * two. Use MD5 when a well-known digest of a file is needed, this hash when
+ * only collision resistance for cache and deduplication keys matters. */
+
+class FastHash {
+ public:
+  FastHash();
+
+  void append(const uint8_t *data, size_t nbytes);
+  void append(const string &str);
+
+  /* Stream a whole file into the hash. Returns false when the file can not be read. */
+  bool append_file(const string &filepath);
+
+  /* Hex string of the 128 bit digest. Can be called only once. */
+  string get_hex();
+
+ protected:
+  void process(const uint8_t *stripe);
+  void finish(uint64_t digest[2]);
+
+  friend uint64_t util_fast_hash(const void *data, const size_t size);
+
+  uint64_t acc[8];     /* lane accumulators */
+  uint8_t buf[64];     /* accumulate stripe */
+  size_t buf_used;     /* bytes pending in buf */
+  uint64_t total_len;  /* message length in bytes */
+  uint64_t num_stripes; /* stripes processed, for secret rotation */
+};
+
+/* Convenience one-shot 64 bit hash. */
+uint64_t util_fast_hash(const void *data, const size_t size);
+
+/* Convenience one-shot 128 bit hex digest of a string, the counterpart of util_md5_string()
+ * for content keys that do not need a well-known digest. */
+string util_fast_hash_string(const string &str);
+
+}
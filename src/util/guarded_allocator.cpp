@@ -3,34 +3,133 @@
  * SPDX-License-Identifier: Apache-2.0 */
 
 #include "util/guarded_allocator.h"
-#include "util/stats.h"
+
+#include <atomic>
 
 namespace ccl {
 
-static Stats global_stats(Stats::static_init);
+/* Memory statistics of the guarded allocator.
+ *
+ * Allocation sizes are accumulated in per-thread counters, so that the hot path only touches the
+ * calling thread's own cache line instead of making all threads contend on shared counters. A
+ * thread only pushes its outstanding delta to the shared counter once it exceeds a threshold.
+ *
+ * Reads aggregate the shared counter and all thread deltas, so the reported usage is exact at
+ * the point of the read. The peak is maintained from the flushes and reads, so it can lag behind
+ * the true peak by at most the unflushed deltas (number of threads times the threshold). */
+
+namespace {
+
+/* Batches the frequent small allocations of STL container churn; larger allocations are flushed
+ * to the shared counters immediately. */
+constexpr int64_t MEM_STATS_FLUSH_THRESHOLD = 256 * 1024;
+
+struct ThreadMemStats {
+  /* Bytes allocated minus bytes freed by this thread since its last flush. Atomic so that
+   * readers aggregating the exact total can see it; the owning thread updates it relaxed. */
+  std::atomic<int64_t> delta{0};
+
+  ThreadMemStats *next = nullptr;
+};
+
+/* Signed, since with per-thread batching frees can reach the shared counter before the
+ * corresponding allocations, for example when memory is freed by a different thread than the one
+ * which allocated it. */
+std::atomic<int64_t> mem_flushed{0};
+std::atomic<int64_t> mem_peak{0};
+
+/* Head of a linked list over the counters of all threads. Threads push themselves lock-free on
+ * their first allocation, and nodes are intentionally never freed: readers may traverse the list
+ * at any time, and the few bytes per thread do not justify locking on the allocation path. */
+std::atomic<ThreadMemStats *> thread_stats_list{nullptr};
+
+ThreadMemStats *thread_mem_stats()
+{
+  static thread_local ThreadMemStats *stats = nullptr;
+
+  if (stats == nullptr) {
+    /* Allocated with plain new: going through the guarded allocator here would recurse. */
+    stats = new ThreadMemStats();
+
+    ThreadMemStats *head = thread_stats_list.load(std::memory_order_relaxed);
+    do {
+      stats->next = head;
+    } while (!thread_stats_list.compare_exchange_weak(head, stats, std::memory_order_release));
+  }
+
+  return stats;
+}
+
+void update_peak(const int64_t mem_used)
+{
+  int64_t peak = mem_peak.load(std::memory_order_relaxed);
+  while (mem_used > peak &&
+         !mem_peak.compare_exchange_weak(peak, mem_used, std::memory_order_relaxed))
+  {
+  }
+}
+
+void flush_delta(ThreadMemStats *stats, const int64_t delta)
+{
+  stats->delta.store(0, std::memory_order_relaxed);
+
+  const int64_t mem_used = mem_flushed.fetch_add(delta, std::memory_order_relaxed) + delta;
+  if (delta > 0) {
+    update_peak(mem_used);
+  }
+}
+
+}  // namespace
 
 /* Internal API. */
 
 void util_guarded_mem_alloc(const size_t n)
 {
-  global_stats.mem_alloc(n);
+  ThreadMemStats *stats = thread_mem_stats();
+
+  const int64_t delta = stats->delta.load(std::memory_order_relaxed) + int64_t(n);
+  if (delta >= MEM_STATS_FLUSH_THRESHOLD) {
+    flush_delta(stats, delta);
+  }
+  else {
+    stats->delta.store(delta, std::memory_order_relaxed);
+  }
 }
 
 void util_guarded_mem_free(const size_t n)
 {
-  global_stats.mem_free(n);
+  ThreadMemStats *stats = thread_mem_stats();
+
+  const int64_t delta = stats->delta.load(std::memory_order_relaxed) - int64_t(n);
+  if (delta <= -MEM_STATS_FLUSH_THRESHOLD) {
+    flush_delta(stats, delta);
+  }
+  else {
+    stats->delta.store(delta, std::memory_order_relaxed);
+  }
 }
 
 /* Public API. */
 
 size_t util_guarded_get_mem_used()
 {
-  return global_stats.mem_used;
+  int64_t mem_used = mem_flushed.load(std::memory_order_relaxed);
+  for (ThreadMemStats *stats = thread_stats_list.load(std::memory_order_acquire);
+       stats != nullptr;
+       stats = stats->next)
+  {
+    mem_used += stats->delta.load(std::memory_order_relaxed);
+  }
+
+  /* The aggregation over the thread counters is exact, so fold it into the peak as well. */
+  update_peak(mem_used);
+
+  return (mem_used > 0) ? size_t(mem_used) : 0;
 }
 
 size_t util_guarded_get_mem_peak()
 {
-  return global_stats.mem_peak;
+  return size_t(mem_peak.load(std::memory_order_relaxed));
 }
 
 }
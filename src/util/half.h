@@ -62,6 +62,51 @@ struct half4 {
 };
 #endif
 
+/* Bit-level half to float conversion for quantized BVH node bounds.
+ *
+ * Must behave identically on every device, so this avoids native half types
+ * and handles subnormals explicitly. Infinities decode to the largest finite
+ * float so the result stays usable in slab test arithmetic. */
+
+ccl_device_inline float half_bits_to_float(const uint h)
+{
+  const uint em = h & 0x7fff;
+  float value;
+  if (em >= 0x7c00) {
+    value = FLT_MAX;
+  }
+  else if (em < 0x0400) {
+    /* Subnormal: mantissa scaled by 2^-24. */
+    value = (float)em * (1.0f / 16777216.0f);
+  }
+  else {
+    value = __uint_as_float((em + 0x1c000) << 13);
+  }
+  return (h & 0x8000) ? -value : value;
+}
+
+/* Inverse of the above: float to half bits with identical behavior on every
+ * device. NaN, infinity and overflow clamp to the largest finite half, so the
+ * round trip through `half_bits_to_float` stays finite. */
+
+ccl_device_inline uint half_float_to_bits(const float f)
+{
+  const uint bits = __float_as_uint(f);
+  const uint sign = (bits >> 16) & 0x8000;
+  const uint em = bits & 0x7fffffff;
+  if (em >= 0x477ff000) {
+    /* NaN, infinity or larger than the largest finite half. */
+    return sign | 0x7bff;
+  }
+  if (em < 0x38800000) {
+    /* Subnormal or zero: round mantissa scaled by 2^24, overflowing naturally
+     * into the smallest normal half when rounding up. */
+    return sign | (uint)(__uint_as_float(em) * 16777216.0f + 0.5f);
+  }
+  /* Adjust bias and round to nearest. */
+  return sign | ((em - 0x37fff000) >> 13);
+}
+
 /* Conversion to/from half float for image textures
  *
  * Simplified float to half for fast sampling on processor without a native
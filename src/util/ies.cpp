@@ -5,8 +5,10 @@
 #include <algorithm>
 
 #include "util/ies.h"
+#include "util/map.h"
 #include "util/math.h"
 #include "util/string.h"
+#include "util/thread.h"
 
 namespace ccl {
 
@@ -17,13 +19,42 @@ namespace ccl {
 // issue.
 template class GuardedAllocator<char>;
 
+/* Process level cache of parsed files, so that scene reloads with the same
+ * lighting rig do not parse the same profiles over and over. Keyed on the file
+ * content itself, the parsed representation is small compared to the text. */
+struct IESCacheEntry {
+  vector<float> v_angles, h_angles;
+  vector<vector<float>> intensity;
+};
+
+static thread_mutex ies_cache_mutex;
+static unordered_map<string, IESCacheEntry> ies_cache;
+
 bool IESFile::load(const string &ies)
 {
   clear();
+
+  {
+    const thread_scoped_lock cache_lock(ies_cache_mutex);
+    const unordered_map<string, IESCacheEntry>::const_iterator it = ies_cache.find(ies);
+    if (it != ies_cache.end()) {
+      v_angles = it->second.v_angles;
+      h_angles = it->second.h_angles;
+      intensity = it->second.intensity;
+      return true;
+    }
+  }
+
   if (!parse(ies) || !process()) {
     clear();
     return false;
   }
+
+  {
+    const thread_scoped_lock cache_lock(ies_cache_mutex);
+    ies_cache.emplace(ies, IESCacheEntry{v_angles, h_angles, intensity});
+  }
+
   return true;
 }
 
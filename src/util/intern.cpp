@@ -0,0 +1,29 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "util/intern.h"
+
+#include "util/concurrent_map.h"
+
+namespace ccl {
+
+const string *InternedString::intern(const string &str)
+{
+  if (str.empty()) {
+    return nullptr;
+  }
+
+  /* Insertion never invalidates references into the map, so pointers to the keys stay valid
+   * while other threads intern, and lookups are lock-free. The mapped value is unused. */
+  static concurrent_unordered_map<string, char> table;
+  return &table.emplace(str, 0).first->first;
+}
+
+const string &InternedString::empty_string()
+{
+  static const string empty;
+  return empty;
+}
+
+}
@@ -0,0 +1,93 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "util/string.h"
+
+namespace ccl {
+
+/* Immutable reference to a string in a process-wide interning table.
+ *
+ * Constructing an interned string hashes the contents once to find (or insert) the canonical
+ * copy; afterwards copies are trivial and equality between interned strings is a pointer
+ * comparison. The table only grows and entries are never freed, so the referenced string stays
+ * valid for the lifetime of the process. Lookups in the table are lock-free, making it safe to
+ * intern from concurrent scene update threads.
+ *
+ * The empty string is canonically represented by a null pointer, so default constructed and
+ * explicitly empty interned strings compare equal. */
+class InternedString {
+ public:
+  InternedString() = default;
+  InternedString(const string &str) : str_(intern(str)) {}
+  InternedString(const char *str) : str_(intern(string(str))) {}
+
+  const string &str() const
+  {
+    return str_ ? *str_ : empty_string();
+  }
+
+  operator const string &() const
+  {
+    return str();
+  }
+
+  const char *c_str() const
+  {
+    return str().c_str();
+  }
+
+  bool empty() const
+  {
+    return str_ == nullptr;
+  }
+
+  size_t size() const
+  {
+    return str_ ? str_->size() : 0;
+  }
+
+  /* Interned strings are equal if and only if their contents are equal. */
+  bool operator==(const InternedString &other) const
+  {
+    return str_ == other.str_;
+  }
+  bool operator!=(const InternedString &other) const
+  {
+    return str_ != other.str_;
+  }
+
+  /* Comparisons against non-interned strings fall back to content comparison. */
+  bool operator==(const string &other) const
+  {
+    return str() == other;
+  }
+  bool operator!=(const string &other) const
+  {
+    return str() != other;
+  }
+  bool operator==(const char *other) const
+  {
+    return str() == other;
+  }
+  bool operator!=(const char *other) const
+  {
+    return str() != other;
+  }
+
+  /* Content order, for use in ordered containers. */
+  bool operator<(const InternedString &other) const
+  {
+    return str() < other.str();
+  }
+
+ private:
+  const string *str_ = nullptr;
+
+  static const string *intern(const string &str);
+  static const string &empty_string();
+};
+
+}
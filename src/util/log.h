@@ -65,20 +65,31 @@ class LogMessageVoidify {
 
 /* Verbose logging categories. */
 
+/* Compile-time cap on the verbose logging categories below. Messages of a category above this
+ * level are compiled out entirely, so their stream arguments are never evaluated or formatted.
+ * Lower it (for example, -DCYCLES_LOG_LEVEL_MAX=1) for benchmark builds where even run-time
+ * disabled logging shows up on profiles. */
+#ifndef CYCLES_LOG_LEVEL_MAX
+#  define CYCLES_LOG_LEVEL_MAX 5
+#endif
+
+#define VLOG_LEVEL(severity) VLOG_IF(severity, (severity) <= CYCLES_LOG_LEVEL_MAX)
+#define VLOG_LEVEL_IS_ON(severity) (((severity) <= CYCLES_LOG_LEVEL_MAX) && VLOG_IS_ON(severity))
+
 /* Warnings. */
-#define VLOG_WARNING VLOG(1)
+#define VLOG_WARNING VLOG_LEVEL(1)
 /* Info about devices, scene contents and features used. */
-#define VLOG_INFO VLOG(2)
-#define VLOG_INFO_IS_ON VLOG_IS_ON(2)
+#define VLOG_INFO VLOG_LEVEL(2)
+#define VLOG_INFO_IS_ON VLOG_LEVEL_IS_ON(2)
 /* Work being performed and timing/memory stats about that work. */
-#define VLOG_WORK VLOG(3)
-#define VLOG_WORK_IS_ON VLOG_IS_ON(3)
+#define VLOG_WORK VLOG_LEVEL(3)
+#define VLOG_WORK_IS_ON VLOG_LEVEL_IS_ON(3)
 /* Detailed device timing stats. */
-#define VLOG_DEVICE_STATS VLOG(4)
-#define VLOG_DEVICE_STATS_IS_ON VLOG_IS_ON(4)
+#define VLOG_DEVICE_STATS VLOG_LEVEL(4)
+#define VLOG_DEVICE_STATS_IS_ON VLOG_LEVEL_IS_ON(4)
 /* Verbose debug messages. */
-#define VLOG_DEBUG VLOG(5)
-#define VLOG_DEBUG_IS_ON VLOG_IS_ON(5)
+#define VLOG_DEBUG VLOG_LEVEL(5)
+#define VLOG_DEBUG_IS_ON VLOG_LEVEL_IS_ON(5)
 
 struct int2;
 struct float3;
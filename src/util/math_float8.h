@@ -25,6 +25,17 @@ ccl_device_inline vfloat8 one_vfloat8()
   return make_vfloat8(1.0f);
 }
 
+#ifndef __KERNEL_GPU__
+ccl_device_inline vfloat8 load_vfloat8(const float *v)
+{
+#  ifdef __KERNEL_AVX__
+  return vfloat8(_mm256_loadu_ps(v));
+#  else
+  return make_vfloat8(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]);
+#  endif
+}
+#endif /* !__KERNEL_GPU__ */
+
 ccl_device_inline vfloat8 operator+(const vfloat8 a, const vfloat8 b)
 {
 #ifdef __KERNEL_AVX__
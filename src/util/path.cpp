@@ -8,10 +8,11 @@
 
 #include "pl/path.h"
 #include "util/algorithm.h"
+#include "util/fasthash.h"
 #include "util/map.h"
-#include "util/md5.h"
 #include "util/set.h"
 #include "util/string.h"
+#include "util/thread.h"
 #include "util/vector.h"
 
 #include <cstdio>
@@ -581,7 +582,53 @@ bool path_is_directory(const string &path)
   return S_ISDIR(st.st_mode);
 }
 
-static void path_files_md5_hash_recursive(MD5Hash &hash, const string &dir)
+/* Process-level cache of file content hashes, invalidated when a file's modification time or
+ * size changes. Every GPU backend hashes the kernel source tree on startup (once per device in
+ * a multi-device setup) and image deduplication hashes texture files; without the cache both
+ * re-read gigabytes of unchanged files. */
+struct ContentHashEntry {
+  uint64_t mtime;
+  uint64_t size;
+  string hex;
+};
+
+string path_content_hash(const string &path)
+{
+  static thread_mutex hash_mutex;
+  static map<string, ContentHashEntry> hash_cache;
+
+  path_stat_t st;
+  if (path_stat(path, &st) != 0) {
+    return "";
+  }
+  const uint64_t mtime = (uint64_t)st.st_mtime;
+  const uint64_t size = (uint64_t)st.st_size;
+
+  {
+    const thread_scoped_lock lock(hash_mutex);
+    const map<string, ContentHashEntry>::iterator it = hash_cache.find(path);
+    if (it != hash_cache.end() && it->second.mtime == mtime && it->second.size == size) {
+      return it->second.hex;
+    }
+  }
+
+  /* Hash outside the lock, so a large file does not stall other lookups. Racing threads may
+   * hash the same file twice, but arrive at the same entry. */
+  FastHash hash;
+  if (!hash.append_file(path)) {
+    return "";
+  }
+  const string hex = hash.get_hex();
+
+  {
+    const thread_scoped_lock lock(hash_mutex);
+    hash_cache[path] = {mtime, size, hex};
+  }
+
+  return hex;
+}
+
+static void path_files_content_hash_recursive(FastHash &hash, const string &dir)
 {
   if (path_exists(dir)) {
     directory_iterator it(dir);
@@ -589,24 +636,24 @@ static void path_files_md5_hash_recursive(MD5Hash &hash, const string &dir)
 
     for (; it != it_end; ++it) {
       if (path_is_directory(it->path())) {
-        path_files_md5_hash_recursive(hash, it->path());
+        path_files_content_hash_recursive(hash, it->path());
       }
       else {
         const string filepath = it->path();
 
         hash.append((const uint8_t *)filepath.c_str(), filepath.size());
-        hash.append_file(filepath);
+        hash.append(path_content_hash(filepath));
       }
     }
   }
 }
 
-string path_files_md5_hash(const string &dir)
+string path_files_content_hash(const string &dir)
 {
-  /* computes md5 hash of all files in the directory */
-  MD5Hash hash;
+  /* Files go through the per-file cache above, so repeated calls only stat the tree. */
+  FastHash hash;
 
-  path_files_md5_hash_recursive(hash, dir);
+  path_files_content_hash_recursive(hash, dir);
 
   return hash.get_hex();
 }
@@ -773,6 +820,11 @@ bool path_remove(const string &path)
   return remove(path.c_str()) == 0;
 }
 
+bool path_rename(const string &from, const string &to)
+{
+  return rename(from.c_str(), to.c_str()) == 0;
+}
+
 struct SourceReplaceState {
   using ProcessedMapping = map<string, string>;
   /* Base director for all relative include headers. */
@@ -33,7 +33,11 @@ bool path_is_relative(const string &path);
 size_t path_file_size(const string &path);
 bool path_exists(const string &path);
 bool path_is_directory(const string &path);
-string path_files_md5_hash(const string &dir);
+/* Content hash of a file or of all files in a directory tree, for cache and deduplication
+ * keys. Hashes are cached for the lifetime of the process and recomputed when a file's
+ * modification time or size changes, so repeated queries only stat. */
+string path_content_hash(const string &path);
+string path_files_content_hash(const string &dir);
 uint64_t path_modified_time(const string &path);
 
 /* directory utility */
@@ -52,6 +56,7 @@ bool path_read_compressed_text(const string &path, string &text);
 
 /* File manipulation. */
 bool path_remove(const string &path);
+bool path_rename(const string &from, const string &to);
 
 /* source code utility */
 string path_source_replace_includes(const string &source, const string &path);
@@ -5,12 +5,214 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <thread>
 
 #include "util/profiling.h"
 
+#include "util/log.h"
+#include "util/map.h"
+
 namespace ccl {
 
+/* Trace */
+
+namespace {
+
+struct TraceEvent {
+  const char *name;
+  double start_time;
+  double duration;
+};
+
+/* Fixed capacity so that a long render can not grow memory without bound; when a buffer wraps
+ * around the oldest events are overwritten. */
+constexpr size_t TRACE_RING_CAPACITY = 1 << 16;
+
+struct TraceRingBuffer {
+  string track_name;
+
+  vector<TraceEvent> events;
+  size_t pos = 0;
+  bool wrapped = false;
+
+  void add(const char *name, const double start_time, const double end_time)
+  {
+    const TraceEvent event = {name, start_time, end_time - start_time};
+
+    if (events.size() < TRACE_RING_CAPACITY) {
+      events.push_back(event);
+      return;
+    }
+
+    events[pos] = event;
+    pos = (pos + 1) % TRACE_RING_CAPACITY;
+    wrapped = true;
+  }
+};
+
+struct TraceState {
+  thread_mutex mutex;
+
+  string filepath;
+  double start_time = 0.0;
+  bool written = false;
+
+  /* Buffers of all threads and custom tracks which recorded events. Owned here so that the trace
+   * of a thread which already exited is still written out. */
+  vector<unique_ptr<TraceRingBuffer>> buffers;
+  map<string, TraceRingBuffer *> tracks;
+};
+
+TraceState &trace_state()
+{
+  static TraceState state;
+  return state;
+}
+
+TraceRingBuffer *trace_thread_buffer()
+{
+  static thread_local TraceRingBuffer *buffer = nullptr;
+
+  if (buffer == nullptr) {
+    TraceState &state = trace_state();
+    const thread_scoped_lock lock(state.mutex);
+
+    auto new_buffer = make_unique<TraceRingBuffer>();
+    new_buffer->track_name = string_printf("Thread %d", int(state.buffers.size()));
+
+    buffer = new_buffer.get();
+    state.buffers.push_back(std::move(new_buffer));
+  }
+
+  return buffer;
+}
+
+void trace_write_buffer(FILE *file, const TraceRingBuffer &buffer, const int tid, bool &first)
+{
+  const double trace_start_time = trace_state().start_time;
+
+  fprintf(file,
+          "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,"
+          "\"args\":{\"name\":\"%s\"}}",
+          first ? "" : ",\n",
+          tid,
+          buffer.track_name.c_str());
+  first = false;
+
+  /* When the ring buffer wrapped around, the oldest remaining event lives at `pos`. */
+  const size_t num_events = buffer.events.size();
+  const size_t begin = buffer.wrapped ? buffer.pos : 0;
+
+  for (size_t i = 0; i < num_events; i++) {
+    const TraceEvent &event = buffer.events[(begin + i) % num_events];
+
+    fprintf(file,
+            ",\n{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+            event.name,
+            tid,
+            (event.start_time - trace_start_time) * 1e6,
+            event.duration * 1e6);
+  }
+}
+
+/* Pick up CYCLES_TRACE_FILE on startup, so that tracing does not require integration changes in
+ * the host application. */
+const struct TraceEnvironmentInit {
+  TraceEnvironmentInit()
+  {
+    const char *filepath = getenv("CYCLES_TRACE_FILE");
+    if (filepath && filepath[0]) {
+      Trace::enable(filepath);
+    }
+  }
+} trace_environment_init;
+
+}  // namespace
+
+bool Trace::enabled_ = false;
+
+void Trace::enable(const string &filepath)
+{
+  TraceState &state = trace_state();
+  const thread_scoped_lock lock(state.mutex);
+
+  state.filepath = filepath;
+
+  if (!enabled_) {
+    state.start_time = time_dt();
+    atexit([] { Trace::write(); });
+    enabled_ = true;
+  }
+}
+
+void Trace::add_event(const char *name, const double start_time, const double end_time)
+{
+  if (!enabled_) {
+    return;
+  }
+
+  trace_thread_buffer()->add(name, start_time, end_time);
+}
+
+void Trace::add_track_event(const string &track,
+                            const char *name,
+                            const double start_time,
+                            const double end_time)
+{
+  if (!enabled_) {
+    return;
+  }
+
+  TraceState &state = trace_state();
+  const thread_scoped_lock lock(state.mutex);
+
+  TraceRingBuffer *buffer = state.tracks[track];
+  if (buffer == nullptr) {
+    auto new_buffer = make_unique<TraceRingBuffer>();
+    new_buffer->track_name = track;
+
+    buffer = new_buffer.get();
+    state.tracks[track] = buffer;
+    state.buffers.push_back(std::move(new_buffer));
+  }
+
+  buffer->add(name, start_time, end_time);
+}
+
+void Trace::write()
+{
+  TraceState &state = trace_state();
+  const thread_scoped_lock lock(state.mutex);
+
+  if (!enabled_ || state.written || state.filepath.empty()) {
+    return;
+  }
+  state.written = true;
+
+  FILE *file = fopen(state.filepath.c_str(), "w");
+  if (file == nullptr) {
+    LOG(ERROR) << "Failed to open trace file " << state.filepath << " for writing.";
+    return;
+  }
+
+  fprintf(file, "{\"traceEvents\":[\n");
+
+  bool first = true;
+  int tid = 0;
+  for (const unique_ptr<TraceRingBuffer> &buffer : state.buffers) {
+    trace_write_buffer(file, *buffer, ++tid, first);
+  }
+
+  fprintf(file, "\n]}\n");
+  fclose(file);
+
+  LOG(INFO) << "Wrote trace to " << state.filepath << ".";
+}
+
+/* Profiler */
+
 Profiler::Profiler() : do_stop_worker(true) {}
 
 Profiler::~Profiler()
@@ -6,7 +6,9 @@
 
 #include <cassert>
 
+#include "util/string.h"
 #include "util/thread.h"
+#include "util/time.h"
 #include "util/unique_ptr.h"
 #include "util/vector.h"
 
@@ -27,6 +29,7 @@ enum ProfilingEvent : uint32_t {
   PROFILING_SHADE_SURFACE_DIRECT_LIGHT,
   PROFILING_SHADE_SURFACE_INDIRECT_LIGHT,
   PROFILING_SHADE_SURFACE_AO,
+  PROFILING_SHADE_SURFACE_MNEE,
   PROFILING_SHADE_SURFACE_PASSES,
   PROFILING_SHADE_DEDICATED_LIGHT,
 
@@ -111,6 +114,73 @@ class Profiler {
   vector<ProfilingState *> states;
 };
 
+/* Chrome trace event recording.
+ *
+ * Records named time ranges into fixed-size per-thread ring buffers, and writes them out as a
+ * JSON file loadable in chrome://tracing and Perfetto, so that pipeline bubbles across threads
+ * and devices can be inspected on a single timeline.
+ *
+ * Recording is enabled by pointing the CYCLES_TRACE_FILE environment variable at the output
+ * path, or by calling enable() before rendering starts; the file is written at process exit.
+ * Recording a scope is two time_dt() calls and a store into a thread-local ring buffer, and a
+ * single branch when tracing is disabled, so the scopes can stay in release builds.
+ *
+ * GPU queues record per-kernel events onto their own tracks, which requires per-kernel timing to
+ * be enabled (SessionParams::use_profiling). */
+class Trace {
+ public:
+  /* Enable recording, writing the trace to the given path when the process exits. */
+  static void enable(const string &filepath);
+
+  static bool enabled()
+  {
+    return enabled_;
+  }
+
+  /* Record a completed event on the calling thread's track.
+   * The name must be a literal (the recorder stores the pointer, not a copy), and the times come
+   * from time_dt(). */
+  static void add_event(const char *name, const double start_time, const double end_time);
+
+  /* Record a completed event on a named track which is not tied to a thread, such as a GPU
+   * queue. The track is created on first use. Takes a lock, so is only meant for low-frequency
+   * producers. */
+  static void add_track_event(const string &track,
+                              const char *name,
+                              const double start_time,
+                              const double end_time);
+
+  /* Write the recorded events to the file given to enable(). Called automatically at process
+   * exit; only the first call writes. */
+  static void write();
+
+ protected:
+  static bool enabled_;
+};
+
+/* Record the enclosing scope as a trace event on the current thread's track. */
+class scoped_trace {
+ public:
+  explicit scoped_trace(const char *name)
+  {
+    if (Trace::enabled()) {
+      name_ = name;
+      start_time_ = time_dt();
+    }
+  }
+
+  ~scoped_trace()
+  {
+    if (name_) {
+      Trace::add_event(name_, start_time_, time_dt());
+    }
+  }
+
+ protected:
+  const char *name_ = nullptr;
+  double start_time_ = 0.0;
+};
+
 class ProfilingHelper {
  public:
   ProfilingHelper(ProfilingState *state, ProfilingEvent event) : state(state)
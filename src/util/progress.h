@@ -60,6 +60,7 @@ class Progress {
     substatus = "";
     sync_status = "";
     sync_substatus = "";
+    status_generation++;
     cancel = false;
     cancel_message = "";
     error = false;
@@ -182,6 +183,12 @@ class Progress {
     total_pixel_samples = total_pixel_samples_;
   }
 
+  uint64_t get_pixel_samples() const
+  {
+    const thread_scoped_lock lock(progress_mutex);
+    return pixel_samples;
+  }
+
   double get_progress() const
   {
     const thread_scoped_lock lock(progress_mutex);
@@ -249,8 +256,12 @@ class Progress {
   {
     {
       const thread_scoped_lock lock(progress_mutex);
+      if (status == status_ && substatus == substatus_) {
+        return;
+      }
       status = status_;
       substatus = substatus_;
+      status_generation++;
     }
 
     set_update();
@@ -260,7 +271,11 @@ class Progress {
   {
     {
       const thread_scoped_lock lock(progress_mutex);
+      if (substatus == substatus_) {
+        return;
+      }
       substatus = substatus_;
+      status_generation++;
     }
 
     set_update();
@@ -270,8 +285,12 @@ class Progress {
   {
     {
       const thread_scoped_lock lock(progress_mutex);
+      if (sync_status == status_ && sync_substatus == substatus_) {
+        return;
+      }
       sync_status = status_;
       sync_substatus = substatus_;
+      status_generation++;
     }
 
     set_update();
@@ -281,7 +300,11 @@ class Progress {
   {
     {
       const thread_scoped_lock lock(progress_mutex);
+      if (sync_substatus == substatus_) {
+        return;
+      }
       sync_substatus = substatus_;
+      status_generation++;
     }
 
     set_update();
@@ -301,8 +324,24 @@ class Progress {
     }
   }
 
+  /* Generation counter which is incremented every time the status strings change. Allows code
+   * which periodically rebuilds the status to cheaply detect whether anyone else updated it in
+   * the meantime, and skip re-formatting identical strings otherwise. */
+  uint64_t get_status_generation() const
+  {
+    const thread_scoped_lock lock(progress_mutex);
+    return status_generation;
+  }
+
   /* callback */
 
+  /* Whether any update callback is attached. Status strings are only ever consumed through the
+   * callback, so producers can skip formatting them entirely when there is no consumer. */
+  bool has_update_callback() const
+  {
+    return static_cast<bool>(update_cb);
+  }
+
   void set_update()
   {
     if (update_cb) {
@@ -345,6 +384,8 @@ class Progress {
   string sync_status;
   string sync_substatus;
 
+  uint64_t status_generation = 0;
+
   volatile bool cancel = false;
   string cancel_message;
 
@@ -0,0 +1,105 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstring>
+
+#include "util/algorithm.h"
+#include "util/math_base.h"
+#include "util/tbb.h"
+#include "util/types.h"
+#include "util/vector.h"
+
+namespace ccl {
+
+/* Parallel stable LSD radix sort over 32-bit keys with a 32-bit payload,
+ * typically an index used to permute a heavier element array afterwards.
+ *
+ * Keys are processed one byte at a time: per-chunk histograms are built in
+ * parallel, a small serial scan turns them into per-chunk starting offsets,
+ * and each chunk then scatters its elements in parallel. Stability makes the
+ * result deterministic for equal keys, they keep their input order. */
+
+static const int RADIX_SORT_CHUNK_SIZE = 32768;
+static const int RADIX_SORT_NUM_DIGITS = 256;
+
+/* Map a float to an unsigned key with the same ordering, for sorting float
+ * keys (such as quantized centroids) through the radix sort. */
+ccl_device_inline uint32_t radix_sort_float_key(const float f)
+{
+  const uint32_t u = __float_as_uint(f);
+  return u ^ (uint32_t)(((int32_t)u >> 31) | 0x80000000);
+}
+
+inline void radix_sort_pairs(
+    uint32_t *keys, int *values, uint32_t *temp_keys, int *temp_values, const int num)
+{
+  if (num < 2) {
+    return;
+  }
+
+  const int num_chunks = (num + RADIX_SORT_CHUNK_SIZE - 1) / RADIX_SORT_CHUNK_SIZE;
+  vector<int> histograms((size_t)num_chunks * RADIX_SORT_NUM_DIGITS);
+
+  uint32_t *src_keys = keys, *dst_keys = temp_keys;
+  int *src_values = values, *dst_values = temp_values;
+
+  for (int shift = 0; shift < 32; shift += 8) {
+    std::fill(histograms.begin(), histograms.end(), 0);
+
+    parallel_for(0, num_chunks, [&](const int chunk) {
+      int *hist = histograms.data() + (size_t)chunk * RADIX_SORT_NUM_DIGITS;
+      const int chunk_start = chunk * RADIX_SORT_CHUNK_SIZE;
+      const int chunk_end = min(chunk_start + RADIX_SORT_CHUNK_SIZE, num);
+      for (int i = chunk_start; i < chunk_end; i++) {
+        hist[(src_keys[i] >> shift) & 0xFF]++;
+      }
+    });
+
+    /* Exclusive scan into per-chunk starting offsets. The global order is
+     * digit-major, chunk-minor, which is what keeps the scatter stable. */
+    int offset = 0;
+    bool single_digit = false;
+    for (int digit = 0; digit < RADIX_SORT_NUM_DIGITS; digit++) {
+      int digit_total = 0;
+      for (int chunk = 0; chunk < num_chunks; chunk++) {
+        int &entry = histograms[(size_t)chunk * RADIX_SORT_NUM_DIGITS + digit];
+        const int count = entry;
+        entry = offset;
+        offset += count;
+        digit_total += count;
+      }
+      single_digit |= (digit_total == num);
+    }
+
+    /* All keys share this digit, the pass is an identity permutation. */
+    if (single_digit) {
+      continue;
+    }
+
+    parallel_for(0, num_chunks, [&](const int chunk) {
+      int *hist = histograms.data() + (size_t)chunk * RADIX_SORT_NUM_DIGITS;
+      const int chunk_start = chunk * RADIX_SORT_CHUNK_SIZE;
+      const int chunk_end = min(chunk_start + RADIX_SORT_CHUNK_SIZE, num);
+      for (int i = chunk_start; i < chunk_end; i++) {
+        const int dst = hist[(src_keys[i] >> shift) & 0xFF]++;
+        dst_keys[dst] = src_keys[i];
+        dst_values[dst] = src_values[i];
+      }
+    });
+
+    swap(src_keys, dst_keys);
+    swap(src_values, dst_values);
+  }
+
+  /* An odd number of executed passes leaves the result in the temporary
+   * buffers, copy it back. */
+  if (src_keys != keys) {
+    memcpy(keys, src_keys, sizeof(uint32_t) * num);
+    memcpy(values, src_values, sizeof(int) * num);
+  }
+}
+
+}
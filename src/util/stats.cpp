@@ -0,0 +1,73 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "util/stats.h"
+
+#include "util/algorithm.h"
+
+namespace ccl {
+
+void Stats::mem_track(const void *owner, const char *name, const size_t size)
+{
+  const thread_scoped_lock lock(mem_tracked_mutex_);
+  mem_tracked_[owner] = pair<string, size_t>(name, size);
+}
+
+void Stats::mem_untrack(const void *owner)
+{
+  const thread_scoped_lock lock(mem_tracked_mutex_);
+  mem_tracked_.erase(owner);
+}
+
+vector<pair<string, size_t>> Stats::mem_snapshot() const
+{
+  map<string, size_t> by_name;
+  {
+    const thread_scoped_lock lock(mem_tracked_mutex_);
+    for (const auto &tracked : mem_tracked_) {
+      by_name[tracked.second.first] += tracked.second.second;
+    }
+  }
+
+  vector<pair<string, size_t>> entries(by_name.begin(), by_name.end());
+  sort(entries.begin(),
+       entries.end(),
+       [](const pair<string, size_t> &a, const pair<string, size_t> &b) {
+         return a.second > b.second;
+       });
+  return entries;
+}
+
+void Stats::set_mem_watermark(const size_t threshold, std::function<void(size_t)> callback)
+{
+  const thread_scoped_lock lock(mem_tracked_mutex_);
+  mem_watermark_ = threshold;
+  mem_watermark_triggered_ = false;
+  mem_watermark_cb_ = std::move(callback);
+}
+
+void Stats::trigger_mem_watermark(const size_t used)
+{
+  std::function<void(size_t)> callback;
+  {
+    const thread_scoped_lock lock(mem_tracked_mutex_);
+    if (mem_watermark_ == 0 || mem_watermark_triggered_) {
+      return;
+    }
+    mem_watermark_triggered_ = true;
+    callback = mem_watermark_cb_;
+  }
+
+  if (callback) {
+    callback(used);
+  }
+}
+
+void Stats::rearm_mem_watermark()
+{
+  const thread_scoped_lock lock(mem_tracked_mutex_);
+  mem_watermark_triggered_ = false;
+}
+
+}
@@ -4,7 +4,13 @@
 
 #pragma once
 
+#include <functional>
+
 #include "util/atomic.h"
+#include "util/map.h"
+#include "util/string.h"
+#include "util/thread.h"
+#include "util/vector.h"
 
 namespace ccl {
 
@@ -17,18 +23,62 @@ class Stats {
 
   void mem_alloc(const size_t size)
   {
-    atomic_add_and_fetch_z(&mem_used, size);
+    const size_t used = atomic_add_and_fetch_z(&mem_used, size);
     atomic_fetch_and_update_max_z(&mem_peak, mem_used);
+    /* Unlocked reads of the watermark state are benign: a racing crossing is caught by the
+     * locked re-check inside trigger_mem_watermark(). */
+    if (mem_watermark_ != 0 && used >= mem_watermark_ && !mem_watermark_triggered_) {
+      trigger_mem_watermark(used);
+    }
   }
 
   void mem_free(const size_t size)
   {
     assert(mem_used >= size);
-    atomic_sub_and_fetch_z(&mem_used, size);
+    const size_t used = atomic_sub_and_fetch_z(&mem_used, size);
+    if (mem_watermark_ != 0 && used < mem_watermark_ && mem_watermark_triggered_) {
+      rearm_mem_watermark();
+    }
+  }
+
+  /* Named allocation tracking.
+   *
+   * Device backends account sizes anonymously through mem_alloc()/mem_free() above. The
+   * device_memory layer additionally registers every device allocation here under its buffer
+   * name, keyed by the owning device_memory, so the per-buffer breakdown can be inspected
+   * while a render is in flight. Re-registering an owner updates its size in place. */
+  void mem_track(const void *owner, const char *name, const size_t size);
+  void mem_untrack(const void *owner);
+
+  /* Snapshot of currently tracked allocations, aggregated by name and sorted by decreasing
+   * size. */
+  vector<pair<string, size_t>> mem_snapshot() const;
+
+  /* Install a callback invoked (on the allocating thread) the first time mem_used crosses the
+   * given threshold, so callers can react before an allocation failure aborts the render. The
+   * watermark re-arms once usage drops back below the threshold. A threshold of zero removes
+   * the watermark. */
+  void set_mem_watermark(const size_t threshold, std::function<void(size_t)> callback);
+
+  /* Configured watermark threshold in bytes, zero when none is set. */
+  size_t mem_watermark() const
+  {
+    return mem_watermark_;
   }
 
   size_t mem_used;
   size_t mem_peak;
+
+ private:
+  void trigger_mem_watermark(const size_t used);
+  void rearm_mem_watermark();
+
+  mutable thread_mutex mem_tracked_mutex_;
+  map<const void *, pair<string, size_t>> mem_tracked_;
+
+  size_t mem_watermark_ = 0;
+  bool mem_watermark_triggered_ = false;
+  std::function<void(size_t)> mem_watermark_cb_;
 };
 
 }
@@ -18,6 +18,7 @@ std::string system_cpu_brand_string();
 int system_cpu_bits();
 bool system_cpu_support_sse42();
 bool system_cpu_support_avx2();
+bool system_cpu_support_avx512();
 
 size_t system_physical_ram();
 
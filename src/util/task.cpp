@@ -13,7 +13,10 @@ namespace ccl {
 
 /* Task Pool */
 
-TaskPool::TaskPool() : start_time(time_dt()), num_tasks_pushed(0) {}
+TaskPool::TaskPool(const TaskPriority priority)
+    : arena_(TaskScheduler::acquire_arena(priority)), start_time(time_dt()), num_tasks_pushed(0)
+{
+}
 
 TaskPool::~TaskPool()
 {
@@ -22,13 +25,18 @@ TaskPool::~TaskPool()
 
 void TaskPool::push(TaskRunFunction &&task)
 {
-  tbb_group.run(std::move(task));
+  if (arena_) {
+    arena_->execute([&] { tbb_group.run(std::move(task)); });
+  }
+  else {
+    tbb_group.run(std::move(task));
+  }
   num_tasks_pushed++;
 }
 
 void TaskPool::wait_work(Summary *stats)
 {
-  tbb_group.wait();
+  group_wait();
 
   if (stats != nullptr) {
     stats->time_total = time_dt() - start_time;
@@ -42,11 +50,21 @@ void TaskPool::cancel()
 {
   if (num_tasks_pushed > 0) {
     tbb_group.cancel();
-    tbb_group.wait();
+    group_wait();
     num_tasks_pushed = 0;
   }
 }
 
+void TaskPool::group_wait()
+{
+  if (arena_) {
+    arena_->execute([&] { tbb_group.wait(); });
+  }
+  else {
+    tbb_group.wait();
+  }
+}
+
 bool TaskPool::canceled()
 {
   return tbb::is_current_task_group_canceling();
@@ -101,6 +119,32 @@ int TaskScheduler::max_concurrency()
   return (users > 0) ? active_num_threads : tbb::this_task_arena::max_concurrency();
 }
 
+tbb::task_arena *TaskScheduler::acquire_arena(const TaskPriority priority)
+{
+#if TBB_INTERFACE_VERSION_MAJOR >= 12
+  /* The arenas share the global worker threads, they only affect the order in which queued tasks
+   * are picked up. Initialized on first use and kept for the lifetime of the process, so that a
+   * pool never outlives its arena. */
+  switch (priority) {
+    case TaskPriority::LOW: {
+      static tbb::task_arena arena(tbb::task_arena::automatic, 1, tbb::task_arena::priority::low);
+      return &arena;
+    }
+    case TaskPriority::HIGH: {
+      static tbb::task_arena arena(tbb::task_arena::automatic, 1, tbb::task_arena::priority::high);
+      return &arena;
+    }
+    case TaskPriority::NORMAL:
+      break;
+  }
+#else
+  /* Arena priorities require oneTBB, fall back to the default arena. */
+  (void)priority;
+#endif
+
+  return nullptr;
+}
+
 /* Dedicated Task Pool */
 
 DedicatedTaskPool::DedicatedTaskPool()
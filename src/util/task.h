@@ -17,6 +17,19 @@ class TaskScheduler;
 
 using TaskRunFunction = std::function<void()>;
 
+/* Priority class of a task pool.
+ *
+ * Tasks from a high priority pool are picked up by worker threads before queued tasks of normal
+ * and low priority pools, so that latency-critical work (such as handing a finished render result
+ * to a driver callback, or dispatching a denoise task) does not wait behind bulk work like scene
+ * sync. Thread affinity is left to TBB: its depth-first work stealing already keeps child tasks
+ * on the thread which spawned them, close to their data. */
+enum class TaskPriority {
+  LOW = 0,
+  NORMAL,
+  HIGH,
+};
+
 /* Task Pool
  *
  * Pool of tasks that will be executed by the central TaskScheduler. For each
@@ -40,7 +53,7 @@ class TaskPool {
     string full_report() const;
   };
 
-  TaskPool();
+  explicit TaskPool(const TaskPriority priority = TaskPriority::NORMAL);
   ~TaskPool();
 
   void push(TaskRunFunction &&task);
@@ -51,8 +64,16 @@ class TaskPool {
   static bool canceled(); /* For worker threads, test if current task pool canceled. */
 
  protected:
+  /* Wait for the group, joining the priority arena when there is one so that the waiting thread
+   * helps out at the pool's priority. */
+  void group_wait();
+
   tbb::task_group tbb_group;
 
+  /* Arena through which tasks are funneled for non-default priorities, null for a normal
+   * priority pool. Owned by the TaskScheduler. */
+  tbb::task_arena *arena_;
+
   /* ** Statistics ** */
 
   /* Time stamp of first task pushed. */
@@ -78,6 +99,11 @@ class TaskScheduler {
    * possible and leave scheduling and splitting up tasks to the scheduler. */
   static int max_concurrency();
 
+  /* Get the shared arena which runs tasks at the given priority, or null when the default arena
+   * is to be used (normal priority, or a TBB without arena priority support). The arenas are
+   * created on demand and shared by all pools of the same priority. */
+  static tbb::task_arena *acquire_arena(const TaskPriority priority);
+
  protected:
   static thread_mutex mutex;
   static int users;
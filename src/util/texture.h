@@ -85,6 +85,10 @@ struct TextureInfo {
   uint width = 0;
   uint height = 0;
   uint depth = 0;
+  /* Number of mip levels stored after the base level, each half the resolution of the
+   * previous one. Only non-zero on the CPU device, where the levels follow the base level
+   * contiguously in the host memory that data points to. */
+  uint num_mip_levels = 0;
   /* Transform for 3D textures. */
   uint use_transform_3d = false;
   Transform transform_3d = transform_zero();
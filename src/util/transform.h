@@ -597,10 +597,186 @@ ccl_device_inline bool operator==(const DecomposedTransform &A, const Decomposed
   return A.x == B.x && A.y == B.y && A.z == B.z && A.w == B.w;
 }
 
-float4 transform_to_quat(const Transform &tfm);
+/* Compare transforms component-wise within an absolute epsilon. */
+ccl_device_inline bool transform_equal_approx(const Transform &A,
+                                              const Transform &B,
+                                              const float eps = 1e-7f)
+{
+  return reduce_max(fabs(A.x - B.x)) <= eps && reduce_max(fabs(A.y - B.y)) <= eps &&
+         reduce_max(fabs(A.z - B.z)) <= eps;
+}
+
+ccl_device_inline float4 transform_to_quat(const Transform &tfm)
+{
+  const double trace = (double)(tfm[0][0] + tfm[1][1] + tfm[2][2]);
+  float4 qt;
+
+  if (trace > 0.0) {
+    double s = sqrt(trace + 1.0);
+
+    qt.w = (float)(s / 2.0);
+    s = 0.5 / s;
+
+    qt.x = (float)((double)(tfm[2][1] - tfm[1][2]) * s);
+    qt.y = (float)((double)(tfm[0][2] - tfm[2][0]) * s);
+    qt.z = (float)((double)(tfm[1][0] - tfm[0][1]) * s);
+  }
+  else {
+    int i = 0;
+
+    if (tfm[1][1] > tfm[i][i]) {
+      i = 1;
+    }
+    if (tfm[2][2] > tfm[i][i]) {
+      i = 2;
+    }
+
+    const int j = (i + 1) % 3;
+    const int k = (j + 1) % 3;
+
+    double s = sqrt((double)(tfm[i][i] - (tfm[j][j] + tfm[k][k])) + 1.0);
+
+    double q[3];
+    q[i] = s * 0.5;
+    if (s != 0.0) {
+      s = 0.5 / s;
+    }
+
+    const double w = (double)(tfm[k][j] - tfm[j][k]) * s;
+    q[j] = (double)(tfm[j][i] + tfm[i][j]) * s;
+    q[k] = (double)(tfm[k][i] + tfm[i][k]) * s;
+
+    qt.x = (float)q[0];
+    qt.y = (float)q[1];
+    qt.z = (float)q[2];
+    qt.w = (float)w;
+  }
+
+  return qt;
+}
+
+ccl_device_inline void transform_decompose(DecomposedTransform *decomp, const Transform *tfm)
+{
+  /* extract translation */
+  decomp->y = make_float4(tfm->x.w, tfm->y.w, tfm->z.w, 0.0f);
+
+  /* extract rotation */
+  Transform M = *tfm;
+  M.x.w = 0.0f;
+  M.y.w = 0.0f;
+  M.z.w = 0.0f;
+
+  float3 colx = transform_get_column(&M, 0);
+  float3 coly = transform_get_column(&M, 1);
+  float3 colz = transform_get_column(&M, 2);
+
+  /* Rigid transforms (pure rotation and translation) are the common case for
+   * motion blur steps, skip the scale and shear extraction for them. */
+  const float rigid_eps = 1e-6f;
+  if (fabsf(len_squared(colx) - 1.0f) < rigid_eps &&
+      fabsf(len_squared(coly) - 1.0f) < rigid_eps &&
+      fabsf(len_squared(colz) - 1.0f) < rigid_eps && fabsf(dot(colx, coly)) < rigid_eps &&
+      fabsf(dot(colx, colz)) < rigid_eps && fabsf(dot(coly, colz)) < rigid_eps &&
+      dot(cross(colx, coly), colz) > 0.0f)
+  {
+    decomp->x = transform_to_quat(M);
+    decomp->y.w = 1.0f;
+    decomp->z = make_float4(0.0f, 0.0f, 0.0f, 1.0f);
+    decomp->w = make_float4(0.0f, 0.0f, 0.0f, 1.0f);
+    return;
+  }
+
+  /* extract scale and shear first */
+  float3 scale;
+  float3 shear;
+  scale.x = len(colx);
+  colx = safe_divide(colx, scale.x);
+  shear.z = dot(colx, coly);
+  coly -= shear.z * colx;
+  scale.y = len(coly);
+  coly = safe_divide(coly, scale.y);
+  shear.y = dot(colx, colz);
+  colz -= shear.y * colx;
+  shear.x = dot(coly, colz);
+  colz -= shear.x * coly;
+  scale.z = len(colz);
+  colz = safe_divide(colz, scale.z);
+
+  transform_set_column(&M, 0, colx);
+  transform_set_column(&M, 1, coly);
+  transform_set_column(&M, 2, colz);
+
+  if (transform_negative_scale(M)) {
+    scale *= -1.0f;
+    M = M * transform_scale(-1.0f, -1.0f, -1.0f);
+  }
+
+  decomp->x = transform_to_quat(M);
+
+  decomp->y.w = scale.x;
+  decomp->z = make_float4(shear.z, shear.y, 0.0f, scale.y);
+  decomp->w = make_float4(shear.x, 0.0f, 0.0f, scale.z);
+}
+
+ccl_device_inline void transform_motion_decompose_impl(DecomposedTransform *decomp,
+                                                       const Transform *motion,
+                                                       const size_t size)
+{
+  /* Decompose and correct rotation. */
+  for (size_t i = 0; i < size; i++) {
+    transform_decompose(decomp + i, motion + i);
+
+    if (i > 0) {
+      /* Ensure rotation around shortest angle, negated quaternions are the same
+       * but this means we don't have to do the check in quat_interpolate */
+      if (dot(decomp[i - 1].x, decomp[i].x) < 0.0f) {
+        decomp[i].x = -decomp[i].x;
+      }
+    }
+  }
+
+  /* Copy rotation to decomposed transform where scale is degenerate. This avoids weird object
+   * rotation interpolation when the scale goes to 0 for a time step.
+   *
+   * Note that this is very simple and naive implementation, which only deals with degenerated
+   * scale happening only on one frame. It is possible to improve it further by interpolating
+   * rotation into s degenerated range using rotation from time-steps from adjacent non-degenerated
+   * time steps. */
+  for (size_t i = 0; i < size; i++) {
+    const float3 scale = make_float3(decomp[i].y.w, decomp[i].z.w, decomp[i].w.w);
+    if (!is_zero(scale)) {
+      continue;
+    }
+
+    if (i > 0) {
+      decomp[i].x = decomp[i - 1].x;
+    }
+    else if (i < size - 1) {
+      decomp[i].x = decomp[i + 1].x;
+    }
+  }
+}
+
+/* Batched transform operations.
+ *
+ * Invert or decompose an array of transforms with a single runtime CPU dispatch, so the widest
+ * available instruction set processes the whole batch: the implementations above are inline and
+ * get compiled a second time in translation units built with AVX2 and AVX-512 flags (on ARM the
+ * SSE intrinsics map to NEON through sse2neon in the regular build). */
+void transform_inverse_batch(const Transform *tfm, Transform *itfm, const size_t size);
 void transform_motion_decompose(DecomposedTransform *decomp,
                                 const Transform *motion,
                                 const size_t size);
+
+void transform_inverse_batch_cpu_avx2(const Transform *tfm, Transform *itfm, const size_t size);
+void transform_inverse_batch_cpu_avx512(const Transform *tfm, Transform *itfm, const size_t size);
+void transform_motion_decompose_cpu_avx2(DecomposedTransform *decomp,
+                                         const Transform *motion,
+                                         const size_t size);
+void transform_motion_decompose_cpu_avx512(DecomposedTransform *decomp,
+                                           const Transform *motion,
+                                           const size_t size);
+
 Transform transform_from_viewplane(BoundBox2D &viewplane);
 
 #endif
@@ -11,4 +11,18 @@ void transform_inverse_cpu_avx2(const Transform &tfm, Transform &itfm)
   itfm = transform_inverse_impl(tfm);
 }
 
+void transform_inverse_batch_cpu_avx2(const Transform *tfm, Transform *itfm, const size_t size)
+{
+  for (size_t i = 0; i < size; i++) {
+    itfm[i] = transform_inverse_impl(tfm[i]);
+  }
+}
+
+void transform_motion_decompose_cpu_avx2(DecomposedTransform *decomp,
+                                         const Transform *motion,
+                                         const size_t size)
+{
+  transform_motion_decompose_impl(decomp, motion, size);
+}
+
 }
@@ -0,0 +1,26 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+/* This file is compiled with AVX-512 optimization flags, so that the batched
+ * transform operations can use the wider registers on CPUs which support them. */
+
+#include "util/transform.h"
+
+namespace ccl {
+
+void transform_inverse_batch_cpu_avx512(const Transform *tfm, Transform *itfm, const size_t size)
+{
+  for (size_t i = 0; i < size; i++) {
+    itfm[i] = transform_inverse_impl(tfm[i]);
+  }
+}
+
+void transform_motion_decompose_cpu_avx512(DecomposedTransform *decomp,
+                                           const Transform *motion,
+                                           const size_t size)
+{
+  transform_motion_decompose_impl(decomp, motion, size);
+}
+
+}
@@ -236,6 +236,15 @@ typedef enum HIPmemAttach_flags_enum {
   HIP_MEM_ATTACH_SINGLE = 0x4,
 } HIPmemAttach_flags;
 
+typedef enum hipMemoryAdvise {
+  hipMemAdviseSetReadMostly = 1,
+  hipMemAdviseUnsetReadMostly = 2,
+  hipMemAdviseSetPreferredLocation = 3,
+  hipMemAdviseUnsetPreferredLocation = 4,
+  hipMemAdviseSetAccessedBy = 5,
+  hipMemAdviseUnsetAccessedBy = 6,
+} hipMemoryAdvise;
+
 typedef enum HIPctx_flags_enum {
   hipDeviceScheduleAuto = 0x00,
   hipDeviceScheduleSpin = 0x01,
@@ -1223,6 +1232,8 @@ typedef hipError_t HIPAPI thipHostRegister(void* p, size_t bytesize, unsigned in
 typedef hipError_t HIPAPI thipHostGetDevicePointer(hipDeviceptr_t* pdptr, void* p, unsigned int Flags);
 typedef hipError_t HIPAPI thipHostGetFlags(unsigned int* pFlags, void* p);
 typedef hipError_t HIPAPI thipMallocManaged(hipDeviceptr_t* dptr, size_t bytesize, unsigned int flags);
+typedef hipError_t HIPAPI thipMemAdvise(hipDeviceptr_t dptr, size_t count, hipMemoryAdvise advice, hipDevice_t device);
+typedef hipError_t HIPAPI thipMemPrefetchAsync(hipDeviceptr_t dptr, size_t count, hipDevice_t dstDevice, hipStream_t stream);
 typedef hipError_t HIPAPI thipDeviceGetByPCIBusId(hipDevice_t* dev, const char* pciBusId);
 typedef hipError_t HIPAPI thipDeviceGetPCIBusId(char* pciBusId, int len, hipDevice_t dev);
 typedef hipError_t HIPAPI thipHostUnregister(void* p);
@@ -1374,6 +1385,8 @@ extern thipHostGetDevicePointer *hipHostGetDevicePointer;
 extern thipHostGetFlags *hipHostGetFlags;
 extern thipHostUnregister *hipHostUnregister;
 extern thipMallocManaged *hipMallocManaged;
+extern thipMemAdvise *hipMemAdvise;
+extern thipMemPrefetchAsync *hipMemPrefetchAsync;
 extern thipDeviceGetByPCIBusId *hipDeviceGetByPCIBusId;
 extern thipDeviceGetPCIBusId *hipDeviceGetPCIBusId;
 extern thipMemcpy *hipMemcpy;
@@ -84,6 +84,8 @@ thipHostGetDevicePointer *hipHostGetDevicePointer;
 thipHostGetFlags *hipHostGetFlags;
 thipHostUnregister *hipHostUnregister;
 thipMallocManaged *hipMallocManaged;
+thipMemAdvise *hipMemAdvise;
+thipMemPrefetchAsync *hipMemPrefetchAsync;
 thipDeviceGetByPCIBusId *hipDeviceGetByPCIBusId;
 thipDeviceGetPCIBusId *hipDeviceGetPCIBusId;
 thipMemcpy *hipMemcpy;
@@ -335,6 +337,9 @@ static int hipewHipInit(void) {
   HIP_LIBRARY_FIND_CHECKED(hipHostGetFlags);
   HIP_LIBRARY_FIND_CHECKED(hipHostUnregister);
   HIP_LIBRARY_FIND_CHECKED(hipMallocManaged);
+  /* Memory hints are optional, older runtimes may not provide them. */
+  HIP_LIBRARY_FIND(hipMemAdvise);
+  HIP_LIBRARY_FIND(hipMemPrefetchAsync);
   HIP_LIBRARY_FIND_CHECKED(hipDeviceGetByPCIBusId);
   HIP_LIBRARY_FIND_CHECKED(hipDeviceGetPCIBusId);
   HIP_LIBRARY_FIND_CHECKED(hipMemcpy);